@@ -31,6 +31,7 @@
 #include "WindowSystemInfo.h"
 #include "profile/ProfileCommandParser.h"
 #include "profile/ProfileManager.h"
+#include "session/ScrollbackBudget.h"
 #include "session/Session.h"
 #include "session/SessionManager.h"
 #include "widgets/ViewContainer.h"
@@ -45,6 +46,9 @@ Application::Application(QSharedPointer<QCommandLineParser> parser, const QStrin
     , m_customCommand(customCommand)
 {
     m_pluginManager.loadAllPlugins();
+
+    // keep the scrollback of all tabs inside the configured memory budget
+    ScrollbackBudget::instance()->start();
 }
 
 void Application::populateCommandLineParser(QCommandLineParser *parser)
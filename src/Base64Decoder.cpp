@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "Base64Decoder.h"
+
+// std
+#include <array>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace Konsole;
+
+namespace
+{
+// Value of each ASCII character in the base64 alphabet, -1 for the rest
+constexpr std::array<qint8, 128> makeDecodeTable()
+{
+    std::array<qint8, 128> table{};
+    for (int c = 0; c < 128; ++c) {
+        table[c] = -1;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        table[c] = qint8(c - 'A');
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table[c] = qint8(c - 'a' + 26);
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = qint8(c - '0' + 52);
+    }
+    table['+'] = 62;
+    table['/'] = 63;
+    return table;
+}
+
+constexpr std::array<qint8, 128> DecodeTable = makeDecodeTable();
+
+#ifdef __SSE2__
+// Decodes 16 characters into 12 bytes.  Returns false, writing nothing,
+// if any of them is not in the base64 alphabet.
+bool decodeBlock(const char32_t *input, char *out)
+{
+    const __m128i *source = reinterpret_cast<const __m128i *>(input);
+    const __m128i a = _mm_loadu_si128(source);
+    const __m128i b = _mm_loadu_si128(source + 1);
+    const __m128i c = _mm_loadu_si128(source + 2);
+    const __m128i d = _mm_loadu_si128(source + 3);
+
+    // everything must be ASCII before it can be narrowed to bytes
+    const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, _mm_set1_epi32(~0x7f)), _mm_setzero_si128())) != 0xffff) {
+        return false;
+    }
+    const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+
+    const auto inRange = [bytes](char low, char high) {
+        return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(char(low - 1))), _mm_cmplt_epi8(bytes, _mm_set1_epi8(char(high + 1))));
+    };
+    const __m128i upper = inRange('A', 'Z');
+    const __m128i lower = inRange('a', 'z');
+    const __m128i digit = inRange('0', '9');
+    const __m128i plus = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('/'));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+
+    // add the offset of each character's range to get its 6-bit value
+    __m128i offset = _mm_and_si128(upper, _mm_set1_epi8(char(-'A')));
+    offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(char(26 - 'a'))));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(char(52 - '0'))));
+    offset = _mm_or_si128(offset, _mm_and_si128(plus, _mm_set1_epi8(char(62 - '+'))));
+    offset = _mm_or_si128(offset, _mm_and_si128(slash, _mm_set1_epi8(char(63 - '/'))));
+    const __m128i values = _mm_add_epi8(bytes, offset);
+
+    // join pairs into 12 bits, then pairs of those into the 24 bits of a group
+    const __m128i even = _mm_and_si128(values, _mm_set1_epi16(0x00ff));
+    const __m128i odd = _mm_srli_epi16(values, 8);
+    const __m128i pairs = _mm_or_si128(_mm_slli_epi16(even, 6), odd);
+    const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+    alignas(16) quint32 words[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(words), groups);
+    for (const quint32 word : words) {
+        *out++ = char(word >> 16);
+        *out++ = char(word >> 8);
+        *out++ = char(word);
+    }
+    return true;
+}
+#endif
+}
+
+void Base64Decoder::decode(const char32_t *input, qsizetype length, QByteArray &output)
+{
+    if (length <= 0) {
+        return;
+    }
+
+    const qsizetype start = output.size();
+    output.resize(start + (length * 3) / 4 + 3);
+    char *out = output.data() + start;
+
+    qsizetype i = 0;
+#ifdef __SSE2__
+    while (length - i >= 16) {
+        // blocks must start on a group boundary
+        if (_bitCount == 0 && decodeBlock(input + i, out)) {
+            out += 12;
+            i += 16;
+        } else {
+            out = decodeScalar(input + i, 16, out);
+            i += 16;
+        }
+    }
+#endif
+    out = decodeScalar(input + i, length - i, out);
+
+    output.resize(out - output.constData());
+}
+
+char *Base64Decoder::decodeScalar(const char32_t *input, qsizetype length, char *out)
+{
+    for (qsizetype i = 0; i < length; ++i) {
+        const char32_t c = input[i];
+        const int value = c < 128 ? DecodeTable[c] : -1;
+        if (value < 0) {
+            continue;
+        }
+        _bits = (_bits << 6) | quint32(value);
+        _bitCount += 6;
+        if (_bitCount >= 8) {
+            _bitCount -= 8;
+            *out++ = char(_bits >> _bitCount);
+            _bits &= (1u << _bitCount) - 1;
+        }
+    }
+    return out;
+}
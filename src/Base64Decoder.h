@@ -0,0 +1,50 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BASE64DECODER_H
+#define BASE64DECODER_H
+
+// Qt
+#include <QByteArray>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Decodes base64 which arrives in pieces, such as the payload of an image
+ * escape sequence collected in the tokenizer's buffer.
+ *
+ * Bits left over from one call carry into the next, so the input may be
+ * split anywhere.  Characters outside the base64 alphabet, including the
+ * '=' padding, are skipped, the same way QByteArray::fromBase64() does by
+ * default.
+ *
+ * Runs of 16 valid characters are decoded with SSE2 where available.
+ */
+class KONSOLEPRIVATE_EXPORT Base64Decoder
+{
+public:
+    /** Decodes @p length characters of @p input and appends the bytes to @p output. */
+    void decode(const char32_t *input, qsizetype length, QByteArray &output);
+
+    /** Drops the bits of an incomplete group. */
+    void reset()
+    {
+        _bits = 0;
+        _bitCount = 0;
+    }
+
+private:
+    char *decodeScalar(const char32_t *input, qsizetype length, char *out);
+
+    quint32 _bits = 0;
+    int _bitCount = 0;
+};
+
+}
+
+#endif // BASE64DECODER_H
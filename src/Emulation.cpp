@@ -18,6 +18,7 @@
 #include "ScreenWindow.h"
 #include "keyboardtranslator/KeyboardTranslator.h"
 #include "keyboardtranslator/KeyboardTranslatorManager.h"
+#include "session/EmulationScheduler.h"
 
 using namespace Konsole;
 
@@ -149,6 +150,11 @@ const HistoryType &Emulation::history() const
     return _screen[0]->getScroll();
 }
 
+size_t Emulation::historyMemoryUsage() const
+{
+    return _screen[0]->historyMemoryUsage() + _screen[1]->historyMemoryUsage();
+}
+
 bool Emulation::setCodec(const QByteArray &name)
 {
     // if we requested a specific codec, only try that one
@@ -295,11 +301,47 @@ void Emulation::showBulk()
     _currentScreen->resetDroppedLines();
 }
 
+void Emulation::setBackgroundMode(bool background)
+{
+    if (_backgroundMode == background) {
+        return;
+    }
+    _backgroundMode = background;
+
+    // Leaving background mode: deliver whatever was parsed since the last
+    // (throttled) update right away instead of waiting for the timer
+    if (!background && _bulkTimer2.isActive()) {
+        showBulk();
+    }
+}
+
 void Emulation::bufferedUpdate()
 {
     static const int BULK_TIMEOUT1 = 10;
     static const int BULK_TIMEOUT2 = 40;
 
+    if (EmulationScheduler::isParsing()) {
+        // Timers belong to the GUI thread; one update per turn will do
+        if (!_deferredUpdate) {
+            _deferredUpdate = true;
+            EmulationScheduler::runOnGuiThread([this]() {
+                _deferredUpdate = false;
+                bufferedUpdate();
+            });
+        }
+        return;
+    }
+
+    if (_backgroundMode) {
+        // Nobody is looking; only keep activity monitoring and the like
+        // informed.  The timer is not restarted by further output.
+        if (!_bulkTimer2.isActive()) {
+            _bulkTimer2.setSingleShot(true);
+            _bulkTimer2.start(BackgroundUpdateInterval);
+        }
+        return;
+    }
+
     _bulkTimer1.setSingleShot(true);
     _bulkTimer1.start(BULK_TIMEOUT1);
     if (!_bulkTimer2.isActive()) {
@@ -120,6 +120,8 @@ public:
     void setHistory(const HistoryType &);
     /** Returns the history store used by this emulation.  See setHistory() */
     const HistoryType &history() const;
+    /** Returns the approximate number of bytes of RAM used by the history stores. */
+    size_t historyMemoryUsage() const;
     /** Clears the history scroll. */
     virtual void clearHistory();
 
@@ -259,6 +261,23 @@ public Q_SLOTS:
 
     void setPeekPrimary(const bool doPeek);
 
+    /**
+     * Puts the emulation into background mode while none of its views are
+     * visible.  Incoming data is still parsed into the screens at full speed,
+     * but outputChanged() is coalesced to at most once per
+     * BackgroundUpdateInterval so activity monitoring keeps working.
+     * The hidden views themselves are not redrawn, see
+     * ScreenWindow::setUpdatesSuspended().
+     */
+    void setBackgroundMode(bool background);
+    bool isInBackgroundMode() const
+    {
+        return _backgroundMode;
+    }
+
+    /** Interval of outputChanged() emissions in background mode, in milliseconds. */
+    static constexpr int BackgroundUpdateInterval = 250;
+
 Q_SIGNALS:
 
     /**
@@ -506,6 +525,9 @@ private:
     QTimer _bulkTimer2{this};
     bool _imageSizeInitialized = false;
     bool _peekingPrimary = false;
+    bool _backgroundMode = false;
+    // An update waits for the EmulationScheduler's turn to end
+    bool _deferredUpdate = false;
     int _activeScreenIndex = 0;
 };
 }
@@ -0,0 +1,108 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef GRAPHICSIMAGE_H
+#define GRAPHICSIMAGE_H
+
+// Qt
+#include <QImage>
+#include <QPointer>
+#include <QSize>
+
+// std
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class GraphicsImageCache;
+
+/**
+ * An image shown by graphics placements (Sixel, iTerm and kitty).
+ *
+ * Its size is known as soon as it is created, so the screen can lay it
+ * out and move the cursor past it right away, while its pixels may still
+ * be decoded on a worker thread.  Until then image() is null and the
+ * placement is not drawn.
+ *
+ * Copies share the pixels.  Images are created by GraphicsImageCache,
+ * which hands out the same image for the same content.
+ */
+class KONSOLEPRIVATE_EXPORT GraphicsImage
+{
+public:
+    GraphicsImage() = default;
+
+    bool isNull() const
+    {
+        return !_d || _d->size.isEmpty();
+    }
+
+    QSize size() const
+    {
+        return _d ? _d->size : QSize();
+    }
+
+    int width() const
+    {
+        return size().width();
+    }
+
+    int height() const
+    {
+        return size().height();
+    }
+
+    /** True once decoding has finished, successfully or not. */
+    bool isReady() const
+    {
+        return _d && _d->ready;
+    }
+
+    /** The pixels, or a null image while decoding or if decoding failed. */
+    QImage image() const
+    {
+        return _d ? _d->image : QImage();
+    }
+
+    /**
+     * Calls @p callback once the image is ready, immediately if it is.
+     * The call is skipped if @p context has been deleted by then.
+     * Must be called from the GUI thread.
+     */
+    void whenReady(QObject *context, std::function<void()> callback) const;
+
+    bool operator==(const GraphicsImage &other) const
+    {
+        return _d == other._d;
+    }
+
+private:
+    friend class GraphicsImageCache;
+
+    struct Data {
+        QSize size;
+        QImage image;
+        bool ready = false;
+        std::pair<size_t, size_t> key; // content hash, see GraphicsImageCache
+        std::vector<std::pair<QPointer<QObject>, std::function<void()>>> waiters;
+    };
+
+    explicit GraphicsImage(std::shared_ptr<Data> d)
+        : _d(std::move(d))
+    {
+    }
+
+    std::shared_ptr<Data> _d;
+};
+
+}
+
+#endif // GRAPHICSIMAGE_H
@@ -0,0 +1,349 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "GraphicsImageCache.h"
+
+// Qt
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtEndian>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+namespace
+{
+// Two independently seeded hashes make a collision between different
+// images practically impossible
+constexpr size_t FirstSeed = 0x4b6f6e73;
+constexpr size_t SecondSeed = 0x6f6c6169;
+
+// Images are shared between terminals, which may be parsed on different threads
+QMutex waitersMutex;
+}
+
+void GraphicsImage::whenReady(QObject *context, std::function<void()> callback) const
+{
+    if (!_d) {
+        return;
+    }
+    {
+        QMutexLocker locker(&waitersMutex);
+        if (!_d->ready) {
+            _d->waiters.emplace_back(QPointer<QObject>(context), std::move(callback));
+            return;
+        }
+    }
+    callback();
+}
+
+GraphicsImageCache::GraphicsImageCache()
+{
+    _images.setMaxCost(DefaultMaximumCost);
+    // leave cores for the GUI and the terminals' output
+    _pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+
+    // The first to use the cache may be a terminal parsed on a worker
+    // without an event loop; results are delivered on the GUI thread
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        moveToThread(app->thread());
+        _pool.moveToThread(app->thread());
+    }
+}
+
+GraphicsImageCache::~GraphicsImageCache()
+{
+    _pool.waitForDone();
+}
+
+GraphicsImageCache *GraphicsImageCache::instance()
+{
+    static GraphicsImageCache cache;
+    return &cache;
+}
+
+template<typename... Parameters>
+GraphicsImageCache::Key GraphicsImageCache::makeKey(const char *data, qsizetype length, const Parameters &...parameters)
+{
+    Key key;
+    key.first = qHashMulti(qHashBits(data, length, FirstSeed), length, parameters...);
+    key.second = qHashMulti(qHashBits(data, length, SecondSeed), parameters...);
+    return key;
+}
+
+GraphicsImage GraphicsImageCache::lookup(const Key &key)
+{
+    QMutexLocker locker(&_mutex);
+    const GraphicsImage *image = _images.object(key);
+    return image ? *image : GraphicsImage();
+}
+
+GraphicsImage GraphicsImageCache::insert(const Key &key, const QSize &size)
+{
+    auto d = std::make_shared<GraphicsImage::Data>();
+    d->size = size;
+    d->key = {key.first, key.second};
+    GraphicsImage image(d);
+
+    QMutexLocker locker(&_mutex);
+    // an image too large for the cache still works, it is just not shared
+    _images.insert(key, new GraphicsImage(image), qMax<qsizetype>(1, qsizetype(size.width()) * size.height() * 4));
+    return image;
+}
+
+void GraphicsImageCache::run(const GraphicsImage &image, std::function<QImage()> job)
+{
+    std::shared_ptr<GraphicsImage::Data> d = image._d;
+    {
+        QMutexLocker locker(&_mutex);
+        ++_pending;
+    }
+    _pool.start([this, d, job = std::move(job)]() {
+        QImage result = job();
+        QMetaObject::invokeMethod(
+            this,
+            [this, d, result]() {
+                {
+                    QMutexLocker locker(&_mutex);
+                    --_pending;
+                }
+                finish(d, result);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void GraphicsImageCache::finish(const std::shared_ptr<GraphicsImage::Data> &d, QImage image)
+{
+    decltype(d->waiters) waiters;
+    {
+        QMutexLocker locker(&waitersMutex);
+        d->image = std::move(image);
+        d->ready = true;
+        waiters = std::exchange(d->waiters, {});
+    }
+    for (const auto &[context, callback] : waiters) {
+        if (context) {
+            callback();
+        }
+    }
+}
+
+QImage GraphicsImageCache::prepareForPainting(QImage image, const QSize &size)
+{
+    if (image.isNull()) {
+        return image;
+    }
+    if (size.isValid() && size != image.size()) {
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    }
+    // the formats the raster paint engine draws without converting
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+}
+
+QSize GraphicsImageCache::encodedImageSize(const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer);
+    QSize size = reader.size();
+    if (size.isValid() && reader.autoTransform() && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+        size.transpose();
+    }
+    return size;
+}
+
+GraphicsImage GraphicsImageCache::decode(const QByteArray &data, const std::function<QSize(const QSize &)> &targetSize)
+{
+    QSize size = encodedImageSize(data);
+    QImage decoded;
+    if (!size.isValid()) {
+        // the header does not tell, decode right away to find out
+        decoded.loadFromData(data);
+        if (decoded.isNull()) {
+            return GraphicsImage();
+        }
+        size = decoded.size();
+    }
+
+    const QSize target = targetSize ? targetSize(size) : size;
+    if (target.isEmpty()) {
+        return GraphicsImage();
+    }
+
+    const Key key = makeKey(data.constData(), data.size(), 'e', target.width(), target.height());
+    GraphicsImage image = lookup(key);
+    if (!image.isNull()) {
+        return image;
+    }
+
+    image = insert(key, target);
+    if (!decoded.isNull()) {
+        run(image, [decoded, target]() {
+            return prepareForPainting(decoded, target);
+        });
+    } else {
+        run(image, [data, target]() {
+            QImage decoded;
+            decoded.loadFromData(data);
+            return prepareForPainting(decoded, target);
+        });
+    }
+    return image;
+}
+
+GraphicsImage GraphicsImageCache::decodeRaw(const QByteArray &pixels, bool compressed, const QSize &size, QImage::Format format)
+{
+    if (size.isEmpty()) {
+        return GraphicsImage();
+    }
+
+    const Key key = makeKey(pixels.constData(), pixels.size(), 'r', compressed, size.width(), size.height(), int(format));
+    GraphicsImage image = lookup(key);
+    if (!image.isNull()) {
+        return image;
+    }
+
+    image = insert(key, size);
+    run(image, [pixels, compressed, size, format]() {
+        const int bytesPerPixel = format == QImage::Format_RGB888 ? 3 : 4;
+        const qint64 byteCount = qint64(bytesPerPixel) * size.width() * size.height();
+
+        QByteArray data = pixels;
+        if (compressed) {
+            // qUncompress() expects the size of the result in front
+            char header[sizeof(quint32)];
+            qToBigEndian(quint32(byteCount), header);
+            data = qUncompress(QByteArray(header, sizeof header) + pixels);
+        }
+        if (data.size() < byteCount) {
+            qCWarning(KonsoleDebug) << "Not enough image data" << data.size() << "require" << byteCount;
+            return QImage();
+        }
+
+        // converting copies the pixels out of data
+        const QImage wrapped(reinterpret_cast<const uchar *>(data.constData()), size.width(), size.height(), size.width() * bytesPerPixel, format);
+        return prepareForPainting(wrapped, QSize());
+    });
+    return image;
+}
+
+GraphicsImage GraphicsImageCache::convert(const QImage &image, const QSize &size)
+{
+    const QSize target = size.isValid() ? size : image.size();
+    if (image.isNull() || target.isEmpty()) {
+        return GraphicsImage();
+    }
+
+    const QList<QRgb> colors = image.colorTable();
+    const Key key = makeKey(reinterpret_cast<const char *>(image.constBits()),
+                            image.sizeInBytes(),
+                            'c',
+                            image.width(),
+                            image.height(),
+                            int(image.format()),
+                            target.width(),
+                            target.height(),
+                            qHashRange(colors.cbegin(), colors.cend()));
+    GraphicsImage result = lookup(key);
+    if (!result.isNull()) {
+        return result;
+    }
+
+    result = insert(key, target);
+    run(result, [image, target]() {
+        return prepareForPainting(image, target);
+    });
+    return result;
+}
+
+GraphicsImage GraphicsImageCache::transformed(const GraphicsImage &source, const QRect &crop, const QSize &size)
+{
+    if (source.isNull()) {
+        return GraphicsImage();
+    }
+
+    // like QPixmap::copy(), an empty rectangle stands for the whole image
+    const QRect bounds(QPoint(0, 0), source.size());
+    const QRect area = crop.isEmpty() ? bounds : bounds.intersected(crop);
+    const QSize target = size.isValid() ? size : area.size();
+    if (area.isEmpty() || target.isEmpty()) {
+        return GraphicsImage();
+    }
+    if (area == bounds && target == source.size()) {
+        return source;
+    }
+
+    Key key;
+    key.first = qHashMulti(FirstSeed, 't', source._d->key.first, area.x(), area.y(), area.width(), area.height(), target.width(), target.height());
+    key.second = qHashMulti(SecondSeed, 't', source._d->key.second, area.x(), area.y(), area.width(), area.height(), target.width(), target.height());
+    GraphicsImage image = lookup(key);
+    if (!image.isNull()) {
+        return image;
+    }
+
+    image = insert(key, target);
+    const std::shared_ptr<GraphicsImage::Data> sourceData = source._d;
+    source.whenReady(this, [this, image, sourceData, area, target]() {
+        const QImage pixels = sourceData->image;
+        run(image, [pixels, area, target]() {
+            return pixels.isNull() ? QImage() : prepareForPainting(pixels.copy(area), target);
+        });
+    });
+    return image;
+}
+
+qint64 GraphicsImageCache::maximumCost() const
+{
+    QMutexLocker locker(&_mutex);
+    return _images.maxCost();
+}
+
+void GraphicsImageCache::setMaximumCost(qint64 bytes)
+{
+    QMutexLocker locker(&_mutex);
+    _images.setMaxCost(bytes);
+}
+
+qint64 GraphicsImageCache::totalCost() const
+{
+    QMutexLocker locker(&_mutex);
+    return _images.totalCost();
+}
+
+int GraphicsImageCache::count() const
+{
+    QMutexLocker locker(&_mutex);
+    return _images.count();
+}
+
+void GraphicsImageCache::clear()
+{
+    QMutexLocker locker(&_mutex);
+    _images.clear();
+}
+
+void GraphicsImageCache::waitForDone()
+{
+    const auto pending = [this]() {
+        QMutexLocker locker(&_mutex);
+        return _pending;
+    };
+    // a delivered result may start more work, e.g. for a transformed image
+    while (pending() > 0) {
+        _pool.waitForDone();
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    }
+}
+
+#include "moc_GraphicsImageCache.cpp"
@@ -0,0 +1,124 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef GRAPHICSIMAGECACHE_H
+#define GRAPHICSIMAGECACHE_H
+
+// Qt
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QRect>
+#include <QThreadPool>
+
+// std
+#include <functional>
+
+// Konsole
+#include "GraphicsImage.h"
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Decodes the images of the terminal graphics protocols and shares them.
+ *
+ * Decoding, decompression, scaling and conversion to a format which paints
+ * without further conversion all run on a small worker pool.  The size of
+ * the result is worked out up front (from the image header for encoded
+ * images), so the emulation can place the image and continue parsing
+ * while the worker fills in the pixels.
+ *
+ * Every request is keyed by a hash of its content and parameters.  An
+ * image which is sent again, as plotting tools and prompts tend to do,
+ * is neither decoded nor stored a second time.  The most recently used
+ * images are kept up to maximumCost() bytes; images still shown on some
+ * screen stay alive regardless through their placements.
+ *
+ * Safe to use from the threads which parse terminal output, see
+ * EmulationScheduler; results are delivered on the GUI thread.
+ */
+class KONSOLEPRIVATE_EXPORT GraphicsImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~GraphicsImageCache() override;
+
+    static GraphicsImageCache *instance();
+
+    /**
+     * Decodes an encoded image (PNG, JPEG, GIF...).  @p targetSize maps the
+     * image's own size to the size it should be scaled to; by default it is
+     * not scaled.  Returns a null image if @p data is not an image.
+     */
+    GraphicsImage decode(const QByteArray &data, const std::function<QSize(const QSize &)> &targetSize = nullptr);
+
+    /**
+     * Decodes raw pixels of @p size in @p format (RGB888 or RGBA8888),
+     * optionally zlib compressed.
+     */
+    GraphicsImage decodeRaw(const QByteArray &pixels, bool compressed, const QSize &size, QImage::Format format);
+
+    /** Converts @p image for painting, scaled to @p size unless that is invalid. */
+    GraphicsImage convert(const QImage &image, const QSize &size = QSize());
+
+    /**
+     * The part @p crop of @p source, scaled to @p size unless that is
+     * invalid.  An empty @p crop stands for the whole image.
+     */
+    GraphicsImage transformed(const GraphicsImage &source, const QRect &crop, const QSize &size);
+
+    /** Size of the encoded image in @p data as stated by its header, invalid if unknown. */
+    static QSize encodedImageSize(const QByteArray &data);
+
+    qint64 maximumCost() const;
+    void setMaximumCost(qint64 bytes);
+    qint64 totalCost() const;
+    int count() const;
+    void clear();
+
+    /** Blocks until all queued work has finished and its results are delivered. */
+    void waitForDone();
+
+    static constexpr qint64 DefaultMaximumCost = 256 * 1024 * 1024;
+
+private:
+    GraphicsImageCache();
+
+    struct Key {
+        size_t first = 0;
+        size_t second = 0;
+
+        bool operator==(const Key &other) const
+        {
+            return first == other.first && second == other.second;
+        }
+    };
+    friend size_t qHash(const Key &key, size_t seed)
+    {
+        return qHashMulti(seed, key.first, key.second);
+    }
+
+    template<typename... Parameters>
+    static Key makeKey(const char *data, qsizetype length, const Parameters &...parameters);
+
+    GraphicsImage lookup(const Key &key);
+    GraphicsImage insert(const Key &key, const QSize &size);
+    void run(const GraphicsImage &image, std::function<QImage()> job);
+    static void finish(const std::shared_ptr<GraphicsImage::Data> &d, QImage image);
+    static QImage prepareForPainting(QImage image, const QSize &size);
+
+    mutable QMutex _mutex; // guards _images and _pending
+    QCache<Key, GraphicsImage> _images; // cost in bytes
+    QThreadPool _pool;
+    int _pending = 0; // jobs whose result has not been delivered yet
+};
+
+}
+
+#endif // GRAPHICSIMAGECACHE_H
@@ -14,10 +14,10 @@
 #include <QDockWidget>
 #include <QLineEdit>
 #include <QListWidget>
+#include <QMap>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMouseEvent>
-#include <QProcess>
 #include <QScreen>
 #include <QStatusBar>
 #include <QTimer>
@@ -51,7 +51,9 @@
 
 // Konsole
 #include "BookmarkHandler.h"
+#include "Emulation.h"
 #include "KonsoleSettings.h"
+#include "StartupTrace.h"
 #include "ViewManager.h"
 #include "WindowSystemInfo.h"
 
@@ -60,6 +62,7 @@
 #include "claude/AgentManagerPanel.h"
 #include "claude/AgentSessionLinker.h"
 #include "claude/ClaudeConversationPicker.h"
+#include "claude/ClaudeFleetService.h"
 #include "claude/ClaudeMenu.h"
 #include "claude/ClaudeNotificationWidget.h"
 #include "claude/ClaudeProcess.h"
@@ -67,9 +70,11 @@
 #include "claude/ClaudeSessionRegistry.h"
 #include "claude/ClaudeSessionWizard.h"
 #include "claude/ClaudeStatusWidget.h"
+#include "claude/IdleTaskScheduler.h"
 #include "claude/KonsolaiSettings.h"
 #include "claude/NotificationManager.h"
 #include "claude/SessionManagerPanel.h"
+#include "claude/SessionRestoreScheduler.h"
 #include "claude/TmuxManager.h"
 
 #include <QTabWidget>
@@ -109,11 +114,25 @@ MainWindow::MainWindow()
     // See https://phabricator.kde.org/D23108
     setAttribute(Qt::WA_NativeWindow);
 
+    StartupTrace::Span span("MainWindow");
+
+    // Initialize idle-time scheduler (singleton) before any Claude component
+    // queues its startup scans on it
+    if (!Konsolai::IdleTaskScheduler::instance()) {
+        new Konsolai::IdleTaskScheduler(this);
+    }
+
     // Initialize Claude session registry (singleton)
     if (!Konsolai::ClaudeSessionRegistry::instance()) {
+        StartupTrace::Span registrySpan("ClaudeSessionRegistry");
         new Konsolai::ClaudeSessionRegistry(this);
     }
 
+    // Initialize the fleet D-Bus interface (singleton)
+    if (!Konsolai::ClaudeFleetService::instance()) {
+        new Konsolai::ClaudeFleetService(Konsolai::ClaudeSessionRegistry::instance(), this);
+    }
+
     // Initialize Konsolai settings (singleton)
     if (!Konsolai::KonsolaiSettings::instance()) {
         new Konsolai::KonsolaiSettings(this);
@@ -127,7 +146,10 @@ MainWindow::MainWindow()
     updateUseTransparency();
 
     // create actions for menus
-    setupActions();
+    {
+        StartupTrace::Span actionsSpan("MainWindow::setupActions");
+        setupActions();
+    }
 
     // create view manager
     _viewManager = new ViewManager(this, actionCollection());
@@ -199,7 +221,10 @@ MainWindow::MainWindow()
     constexpr KXmlGuiWindow::StandardWindowOptions guiOpts = ToolBar | Keys | Save | Create;
     const QString xmlFile = componentName() + QLatin1String("ui.rc"); // Typically "konsoleui.rc"
     // The "Create" flag will make it call createGUI()
-    setupGUI(guiOpts, xmlFile);
+    {
+        StartupTrace::Span guiSpan("MainWindow::setupGUI");
+        setupGUI(guiOpts, xmlFile);
+    }
 
     // Hamburger menu for when the menubar is hidden
     _hamburgerMenu = KStandardAction::hamburgerMenu(nullptr, nullptr, actionCollection());
@@ -727,12 +752,17 @@ void MainWindow::setupActions()
     // Set up agent-fleet provider
     auto *settings = Konsolai::KonsolaiSettings::instance();
     QString fleetPath = settings ? settings->agentFleetPath() : QString();
-    auto *fleetProvider = new Konsolai::AgentFleetProvider(fleetPath);
-    if (fleetProvider->isAvailable()) {
-        _agentPanel->addProvider(fleetProvider);
-    } else {
-        delete fleetProvider;
-    }
+    // Scanning the fleet reads every goal and session file; keep it off the
+    // path to the first interactive terminal
+    QPointer<Konsolai::AgentManagerPanel> agentPanel(_agentPanel);
+    Konsolai::IdleTaskScheduler::post(_agentPanel, "AgentFleetProvider", Konsolai::IdleTaskScheduler::Normal, [agentPanel, fleetPath]() {
+        auto *fleetProvider = new Konsolai::AgentFleetProvider(fleetPath);
+        if (agentPanel && fleetProvider->isAvailable()) {
+            agentPanel->addProvider(fleetProvider);
+        } else {
+            delete fleetProvider;
+        }
+    });
 
     // Agent↔Session linker
     _agentSessionLinker = new Konsolai::AgentSessionLinker(_sessionPanel, _agentPanel, this);
@@ -984,32 +1014,7 @@ void MainWindow::setupActions()
             return;
         }
 
-        // Handle git worktree creation
-        if (!wizard.worktreeBranch().isEmpty()) {
-            QString branchName = wizard.worktreeBranch();
-            QString repoRoot = wizard.repoRoot();
-
-            QProcess checkBranch;
-            checkBranch.start(
-                QStringLiteral("git"),
-                {QStringLiteral("-C"), repoRoot, QStringLiteral("rev-parse"), QStringLiteral("--verify"), QStringLiteral("refs/heads/") + branchName});
-            checkBranch.waitForFinished(5000);
-            bool branchExists = (checkBranch.exitCode() == 0);
-
-            QStringList args = {QStringLiteral("-C"), repoRoot, QStringLiteral("worktree"), QStringLiteral("add")};
-            if (!branchExists) {
-                args << QStringLiteral("-b") << branchName << workDir;
-            } else {
-                args << workDir << branchName;
-            }
-
-            int exitCode = QProcess::execute(QStringLiteral("git"), args);
-            if (exitCode != 0) {
-                qWarning() << "Failed to create git worktree:" << args;
-                return;
-            }
-            qDebug() << "Created git worktree:" << workDir << "branch:" << branchName;
-        }
+        // The wizard has created the git worktree, if one was requested
 
         // Create the session
         auto *claudeSession = new Konsolai::ClaudeSession(claudeProfile->name(), workDir, this);
@@ -1904,49 +1909,7 @@ void MainWindow::newFromProfile(const Profile::Ptr &profile)
                 QString workDir = wizard.selectedDirectory();
                 qDebug() << "Creating Claude session in:" << workDir;
 
-                // Git init is handled by the wizard dialog itself.
-                // Worktree creation is handled here since it needs error feedback.
-                if (!wizard.worktreeBranch().isEmpty()) {
-                    QString branchName = wizard.worktreeBranch();
-                    QString repoRoot = wizard.repoRoot();
-
-                    // Worktree path is the selected directory (e.g., ~/projects/fix-login-auth)
-                    QString worktreePath = workDir;
-
-                    qDebug() << "Creating worktree:" << worktreePath << "for branch:" << branchName << "from repo:" << repoRoot;
-
-                    // Check if branch exists
-                    QProcess checkBranch;
-                    checkBranch.start(
-                        QStringLiteral("git"),
-                        {QStringLiteral("-C"), repoRoot, QStringLiteral("rev-parse"), QStringLiteral("--verify"), QStringLiteral("refs/heads/") + branchName});
-                    checkBranch.waitForFinished(5000);
-                    bool branchExists = (checkBranch.exitCode() == 0);
-
-                    qDebug() << "Branch exists:" << branchExists;
-
-                    QStringList args = {QStringLiteral("-C"), repoRoot, QStringLiteral("worktree"), QStringLiteral("add")};
-                    if (!branchExists) {
-                        // Create new branch with -b flag
-                        args << QStringLiteral("-b") << branchName << worktreePath;
-                    } else {
-                        // Use existing branch
-                        args << worktreePath << branchName;
-                    }
-
-                    qDebug() << "Git worktree command:" << args;
-                    int exitCode = QProcess::execute(QStringLiteral("git"), args);
-                    qDebug() << "Git worktree exit code:" << exitCode;
-
-                    if (exitCode == 0) {
-                        qDebug() << "Worktree created, session will use:" << workDir;
-                    } else {
-                        QMessageBox::warning(this,
-                                             i18n("Worktree Error"),
-                                             i18n("Failed to create git worktree. Check if the branch name is valid and the path doesn't already exist."));
-                        return;
-                    }
-                }
+                // Git init and worktree creation are handled by the wizard dialog itself.
 
                 // Construct ClaudeSession manually so we can set all properties
                 // (task, resume ID, SSH fields) BEFORE run(). Using createSession()
@@ -2099,7 +2062,13 @@ void MainWindow::applyKonsoleSettings()
 
     updateWindowCaption();
 
-    // Auto-reattach orphaned Claude sessions on startup (delayed to ensure UI is ready)
+    // Auto-reattach orphaned Claude sessions on startup (delayed to ensure UI is ready).
+    // The startup trace goes on until they are back, see autoReattachClaudeSessions()
+    static bool traceHeld = false;
+    if (!traceHeld) {
+        traceHeld = true;
+        StartupTrace::instance()->holdEnd();
+    }
     QTimer::singleShot(500, this, &MainWindow::autoReattachClaudeSessions);
 }
 
@@ -2111,6 +2080,12 @@ void MainWindow::autoReattachClaudeSessions()
     }
     alreadyRan = true;
 
+    // Lets the startup trace end once the last copy is gone: when there is
+    // nothing to restore, or the restore scheduler is done
+    std::shared_ptr<void> traceHold(nullptr, [](void *) {
+        StartupTrace::instance()->releaseEnd();
+    });
+
     auto *registry = Konsolai::ClaudeSessionRegistry::instance();
     if (!registry) {
         return;
@@ -2123,7 +2098,7 @@ void MainWindow::autoReattachClaudeSessions()
     // cascading through cleanup and crashing the app at startup.
     auto *tmux = new Konsolai::TmuxManager(this);
     QPointer<MainWindow> guard(this);
-    tmux->listKonsolaiSessionsAsync([this, guard, registry, tmux](const QList<Konsolai::TmuxManager::SessionInfo> &liveSessions) {
+    tmux->listKonsolaiSessionsAsync([this, guard, registry, tmux, traceHold](const QList<Konsolai::TmuxManager::SessionInfo> &liveSessions) {
         tmux->deleteLater();
         if (!guard) {
             return;
@@ -2155,55 +2130,136 @@ void MainWindow::autoReattachClaudeSessions()
             return;
         }
 
-        // Phase 1: Create all session objects, views, and register them (fast, no I/O).
-        // Phase 2: Stagger run() calls with 50ms spacing so the UI stays responsive.
-        QList<Konsolai::ClaudeSession *> sessionsToRun;
-        int reattached = 0;
-        int skipped = 0;
+        QList<Konsolai::ClaudeSessionState> live;
         for (const Konsolai::ClaudeSessionState &state : orphans) {
-            if (!liveNames.contains(state.sessionName)) {
-                ++skipped;
-                continue;
+            if (liveNames.contains(state.sessionName)) {
+                live.append(state);
             }
-
-            qDebug() << "Reattaching session (deferred run):" << state.sessionName;
-
-            // Create a ClaudeSession for reattach
-            auto *claudeSession = Konsolai::ClaudeSession::createForReattach(state.sessionName, this);
-
-            // Set initial working directory
-            if (!state.workingDirectory.isEmpty()) {
-                claudeSession->setInitialWorkingDirectory(state.workingDirectory);
+        }
+        const int skipped = orphans.size() - live.size();
+
+        // Tabs come up in order of priority but keep the order they were
+        // saved in: each goes before the next tab of the fleet already there
+        QHash<QString, int> savedIndex;
+        for (int i = 0; i < live.size(); ++i) {
+            savedIndex.insert(live.at(i).sessionName, i);
+        }
+        auto restoredViews = std::make_shared<QMap<int, QPointer<TerminalDisplay>>>();
+        const auto tabIndexFor = [restoredViews](TabbedViewContainer *container, int saved) {
+            const auto tabOf = [container](TerminalDisplay *view) {
+                auto *splitter = view ? qobject_cast<ViewSplitter *>(view->parentWidget()) : nullptr;
+                return splitter ? container->indexOf(splitter->getToplevelSplitter()) : -1;
+            };
+            for (auto it = restoredViews->upperBound(saved); it != restoredViews->end(); ++it) {
+                const int index = tabOf(it.value());
+                if (index != -1) {
+                    return index;
+                }
+            }
+            for (auto it = restoredViews->lowerBound(saved); it != restoredViews->begin();) {
+                const int index = tabOf((--it).value());
+                if (index != -1) {
+                    return index + 1;
+                }
             }
+            return -1;
+        };
 
-            // Apply profile settings
-            SessionManager::instance()->setSessionProfile(claudeSession, claudeProfile);
+        // The tab accessed last comes up first and on its own; the rest are
+        // attached in parallel batches as background tabs, whose tab
+        // indicators and yolo pollers wait until the tab is first shown
+        auto *scheduler = new Konsolai::SessionRestoreScheduler(
+            [this, registry, claudeProfile, savedIndex, restoredViews, tabIndexFor](const Konsolai::ClaudeSessionState &state,
+                                                                                    bool foreground,
+                                                                                    Konsolai::SessionRestoreScheduler::Done done) {
+                qDebug() << "Reattaching session:" << state.sessionName << (foreground ? "(foreground)" : "(background)");
+
+                auto *claudeSession = Konsolai::ClaudeSession::createForReattach(state.sessionName, this);
+                if (!state.workingDirectory.isEmpty()) {
+                    claudeSession->setInitialWorkingDirectory(state.workingDirectory);
+                }
+                SessionManager::instance()->setSessionProfile(claudeSession, claudeProfile);
+                if (!foreground) {
+                    claudeSession->setPollingDeferred(true);
+                }
 
-            // Create view and add to container
-            auto *view = _viewManager->createView(claudeSession);
-            _viewManager->activeContainer()->addView(view);
+                auto *view = _viewManager->createView(claudeSession);
+                auto *container = _viewManager->activeContainer();
+                const int saved = savedIndex.value(state.sessionName);
+                container->addView(view, foreground, tabIndexFor(container, saved));
+                restoredViews->insert(saved, view);
 
-            // Register with registry and connect to status UI (before run)
-            registry->registerSession(claudeSession);
-            _sessionPanel->registerSession(claudeSession);
-            _claudeMenu->setActiveSession(claudeSession);
-            _claudeStatusWidget->setSession(claudeSession);
+                // Register with registry and connect to status UI (before run)
+                registry->registerSession(claudeSession);
+                _sessionPanel->registerSession(claudeSession);
+                if (foreground) {
+                    _claudeMenu->setActiveSession(claudeSession);
+                    _claudeStatusWidget->setSession(claudeSession);
+                } else {
+                    QPointer<Konsolai::ClaudeSession> session(claudeSession);
+                    connect(container, &TabbedViewContainer::activeViewChanged, claudeSession, [session, view](TerminalDisplay *active) {
+                        if (session && active == view) {
+                            session->setPollingDeferred(false);
+                        }
+                    });
+                }
 
-            sessionsToRun.append(claudeSession);
-            ++reattached;
-        }
+                // Done once the tmux client drew something, or gave up
+                auto once = std::make_shared<Konsolai::SessionRestoreScheduler::Done>(std::move(done));
+                auto finish = [once](bool ok) {
+                    if (*once) {
+                        auto callback = std::move(*once);
+                        *once = nullptr;
+                        callback(ok);
+                    }
+                };
+                connect(
+                    claudeSession->emulation(),
+                    &Emulation::outputChanged,
+                    claudeSession,
+                    [finish]() {
+                        finish(true);
+                    },
+                    Qt::SingleShotConnection);
+                connect(
+                    claudeSession,
+                    &Session::finished,
+                    this,
+                    [finish]() {
+                        finish(false);
+                    },
+                    Qt::SingleShotConnection);
+                connect(claudeSession, &QObject::destroyed, this, [finish]() {
+                    finish(false);
+                });
+                QTimer::singleShot(ReattachTimeoutMs, this, [finish]() {
+                    finish(true);
+                });
 
-        // Stagger run() calls: 50ms between each so tmux attaches don't block the UI
-        for (int i = 0; i < sessionsToRun.size(); ++i) {
-            QPointer<Konsolai::ClaudeSession> session = sessionsToRun[i];
-            QTimer::singleShot(i * 50, this, [session]() {
-                if (session && !session->isRunning()) {
-                    session->run();
+                claudeSession->run();
+            },
+            this);
+
+        // Background tabs nobody has looked at yet get their pollers once
+        // the whole fleet is back, so yolo keeps working for them
+        connect(scheduler, &Konsolai::SessionRestoreScheduler::finished, this, [this, scheduler, skipped, traceHold](int restored, int failed) {
+            qDebug() << "Auto-reattached" << restored << "sessions (" << failed << "failed), skipped" << skipped << "stale entries; first tab after"
+                     << scheduler->timeToFirstTab() << "ms, all after" << scheduler->timeToAllRestored() << "ms";
+            const auto sessions = findChildren<Konsolai::ClaudeSession *>(Qt::FindDirectChildrenOnly);
+            for (Konsolai::ClaudeSession *session : sessions) {
+                if (!session->isPollingDeferred()) {
+                    continue;
                 }
-            });
-        }
-
-        qDebug() << "Auto-reattached" << reattached << "sessions (staggered), skipped" << skipped << "stale entries";
+                QPointer<Konsolai::ClaudeSession> guard(session);
+                Konsolai::IdleTaskScheduler::post(session, "restore-yolo-pollers", Konsolai::IdleTaskScheduler::Low, [guard]() {
+                    if (guard) {
+                        guard->setPollingDeferred(false);
+                    }
+                });
+            }
+            scheduler->deleteLater();
+        });
+        scheduler->start(live);
     });
 }
 
@@ -245,6 +245,9 @@ private:
     void associateControllerShortcuts(SessionController *controller, bool associate);
     void updateHamburgerMenu();
 
+    // A reattached session counts as restored after this long without output
+    static constexpr int ReattachTimeoutMs = 3000;
+
 private:
     ViewManager *_viewManager;
     BookmarkHandler *_bookmarkHandler;
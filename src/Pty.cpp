@@ -15,6 +15,9 @@
 
 #ifndef Q_OS_WIN
 
+// Qt
+#include <QElapsedTimer>
+
 // System
 #include <csignal>
 #include <errno.h>
@@ -25,7 +28,20 @@
 #include <KPtyDevice>
 #include <KSandbox>
 
+// Konsole
+#include "PtyReader.h"
+
 using Konsole::Pty;
+using Konsole::PtyReader;
+
+namespace
+{
+// Output passed on in one go; the emulation parses it right away
+constexpr qsizetype MaxDeliveryLength = 64 * 1024;
+// Time spent passing on the output of one terminal before the event loop,
+// and with it the other terminals, gets a turn
+constexpr qint64 DeliverySliceMs = 4;
+}
 
 static int getShellProcessId(QLatin1String tty)
 {
@@ -96,10 +112,21 @@ Pty::Pty(int masterFd, QObject *aParent)
     setUseUtmp(true);
     setPtyChannels(KPtyProcess::AllChannels);
 
-    connect(pty(), &KPtyDevice::readyRead, this, &Konsole::Pty::dataReceived);
+    // Output is read by _reader instead of the device
+    pty()->setSuspended(true);
+    _reader = std::make_unique<PtyReader>(pty()->masterFd());
+    connect(_reader.get(), &PtyReader::readyRead, this, &Konsole::Pty::dataReceived);
+    _reader->start();
+
+    // Connected before anyone else can, so the output comes first
+    connect(this, &Konsole::Pty::finished, this, &Konsole::Pty::deliverRemainingData);
 }
 
-Pty::~Pty() = default;
+Pty::~Pty()
+{
+    // The descriptor is closed by the base class
+    _reader->stop();
+}
 
 void Pty::sendData(const QByteArray &data)
 {
@@ -113,14 +140,85 @@ void Pty::sendData(const QByteArray &data)
     }
 }
 
+void Pty::setPullMode(bool pull)
+{
+    if (_pullMode == pull) {
+        return;
+    }
+    _pullMode = pull;
+
+    // The reader doesn't notify again before all was consumed
+    if (_reader->bytesAvailable() > 0) {
+        QMetaObject::invokeMethod(this, &Pty::dataReceived, Qt::QueuedConnection);
+    }
+}
+
+bool Pty::hasReceivedData() const
+{
+    return _reader->bytesAvailable() > 0;
+}
+
 void Pty::dataReceived()
 {
-    QByteArray data = pty()->readAll();
-    if (data.isEmpty()) {
+    _deliveryScheduled = false;
+    if (_pullMode) {
+        if (_reader->bytesAvailable() > 0) {
+            Q_EMIT outputAvailable();
+        }
         return;
     }
+    if (_delivering) {
+        return;
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+    while (deliverReceivedData(MaxDeliveryLength) > 0 && slice.elapsed() < DeliverySliceMs) { }
+
+    // The reader doesn't notify again before all was consumed
+    if (_reader->bytesAvailable() > 0 && !_deliveryScheduled) {
+        _deliveryScheduled = true;
+        QMetaObject::invokeMethod(this, &Pty::dataReceived, Qt::QueuedConnection);
+    }
+}
 
-    Q_EMIT receivedData(data.constData(), data.length());
+qsizetype Pty::readReceivedData(const std::function<void(const char *, int)> &consumer, qsizetype maxLength)
+{
+    qsizetype delivered = 0;
+    while (delivered < maxLength) {
+        // The data stays in the buffer, and valid, until consumed
+        const QByteArrayView data = _reader->peek(maxLength - delivered);
+        if (data.isEmpty()) {
+            break;
+        }
+        consumer(data.data(), static_cast<int>(data.size()));
+        _reader->consume(data.size());
+        delivered += data.size();
+    }
+    return delivered;
+}
+
+qsizetype Pty::deliverReceivedData(qsizetype maxLength)
+{
+    _delivering = true;
+    const qsizetype delivered = readReceivedData(
+        [this](const char *buffer, int length) {
+            Q_EMIT receivedData(buffer, length);
+        },
+        maxLength);
+    _delivering = false;
+    return delivered;
+}
+
+void Pty::deliverRemainingData()
+{
+    if (_delivering) {
+        return;
+    }
+    // Output may be left in the pty, and more than fits into the buffer
+    do {
+        while (deliverReceivedData(MaxDeliveryLength) > 0) { }
+    } while (_reader->readPending() > 0);
 }
 
 void Pty::setWindowSize(int columns, int lines, int width, int height)
@@ -326,6 +424,7 @@ void Pty::setWriteable(bool writeable)
 
 void Pty::closePty()
 {
+    _reader->stop();
     pty()->close();
 }
 
@@ -16,6 +16,10 @@
 #include "konsoleprivate_export.h"
 
 #ifndef Q_OS_WIN
+// std
+#include <functional>
+#include <memory>
+
 // KDE
 #include <KPtyProcess>
 #else
@@ -26,6 +30,8 @@
 
 namespace Konsole
 {
+class PtyReader;
+
 /**
  * The Pty class is used to start the terminal process,
  * send data to it, receive data from it and manipulate
@@ -38,6 +44,11 @@ namespace Konsole
  *
  * To start the terminal process, call the start() method
  * with the program name and appropriate arguments.
+ *
+ * Output is read on a thread of its own, see PtyReader, and passed on
+ * from the GUI thread a limited amount at a time, so a terminal which is
+ * flooded with output leaves time for the others and for input.  In pull
+ * mode it is taken with readReceivedData() instead, see setPullMode().
  */
 #ifdef Q_OS_WIN
 #define ParentClass QObject
@@ -161,6 +172,31 @@ public:
 
     int flatpakSpawnProcessId() const;
 
+#ifndef Q_OS_WIN
+    /**
+     * In pull mode output is no longer passed on through receivedData() as
+     * it arrives.  outputAvailable() is emitted instead, and the output is
+     * taken with readReceivedData(), from whichever thread the owner likes.
+     * What the process writes before it exits is still passed on through
+     * receivedData().  Turning pull mode off passes on what was left.
+     */
+    void setPullMode(bool pull);
+    bool pullMode() const
+    {
+        return _pullMode;
+    }
+
+    /** True if output was read from the pty and not passed on yet. */
+    bool hasReceivedData() const;
+
+    /**
+     * Hands at most @p maxLength bytes of the output read so far to
+     * @p consumer, in one or more pieces.  Safe to call from any thread,
+     * but from only one at a time.  Returns the number of bytes passed on.
+     */
+    qsizetype readReceivedData(const std::function<void(const char *, int)> &consumer, qsizetype maxLength);
+#endif
+
 #ifdef Q_OS_WIN
 
     bool isRunning() const
@@ -212,13 +248,19 @@ public Q_SLOTS:
 Q_SIGNALS:
     /**
      * Emitted when a new block of data is received from
-     * the teletype.
+     * the teletype.  @p buffer is only valid until the slot returns.
      *
      * @param buffer Pointer to the data received.
      * @param length Length of @p buffer
      */
     void receivedData(const char *buffer, int length);
 
+    /**
+     * Emitted in pull mode when output arrives while none was waiting.
+     * It is not emitted again before all of it was taken.
+     */
+    void outputAvailable();
+
 private Q_SLOTS:
     // called when data is received from the terminal process
     void dataReceived();
@@ -226,6 +268,13 @@ private Q_SLOTS:
 private:
     void init();
 
+#ifndef Q_OS_WIN
+    // Passes on at most @p maxLength bytes of the output read so far
+    qsizetype deliverReceivedData(qsizetype maxLength);
+    // Passes on what the process wrote before it exited
+    void deliverRemainingData();
+#endif
+
     // takes a list of key=value pairs and adds them
     // to the environment for the process
     void addEnvironmentVariables(const QStringList &environment);
@@ -241,6 +290,11 @@ private:
 #ifdef Q_OS_WIN
     std::unique_ptr<IPtyProcess> m_proc;
 #else
+    std::unique_ptr<PtyReader> _reader;
+    bool _delivering = false;
+    bool _deliveryScheduled = false;
+    bool _pullMode = false;
+
     // Use shellProcessId() instead
     using ParentClass::processId;
 #endif
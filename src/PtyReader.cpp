@@ -0,0 +1,237 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "PtyReader.h"
+
+#ifndef Q_OS_WIN
+
+// Qt
+#include <QMutexLocker>
+#include <QThread>
+
+// std
+#include <algorithm>
+
+// System
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+namespace
+{
+qsizetype roundUpToPowerOfTwo(qsizetype value)
+{
+    qsizetype result = 4096;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+}
+
+PtyReader::PtyReader(int fd, qsizetype capacity, QObject *parent)
+    : QObject(parent)
+    , _fd(fd)
+    , _capacity(roundUpToPowerOfTwo(capacity))
+{
+    _buffer = std::make_unique<char[]>(_capacity);
+
+    if (_fd >= 0) {
+        ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) | O_NONBLOCK);
+    }
+    if (::pipe(_wakePipe) == 0) {
+        for (int end : _wakePipe) {
+            ::fcntl(end, F_SETFL, ::fcntl(end, F_GETFL) | O_NONBLOCK);
+            ::fcntl(end, F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        qCWarning(KonsoleDebug) << "Could not create the wake pipe of the pty reader:" << strerror(errno);
+        _wakePipe[0] = _wakePipe[1] = -1;
+    }
+}
+
+PtyReader::~PtyReader()
+{
+    stop();
+    for (int end : _wakePipe) {
+        if (end >= 0) {
+            ::close(end);
+        }
+    }
+}
+
+void PtyReader::start()
+{
+    if (_thread != nullptr || _fd < 0 || _wakePipe[0] < 0) {
+        return;
+    }
+    _stopping = false;
+    _thread = QThread::create([this]() {
+        run();
+    });
+    _thread->setObjectName(QStringLiteral("PtyReader"));
+    _thread->start();
+}
+
+void PtyReader::stop()
+{
+    if (_thread != nullptr) {
+        _stopping = true;
+        wake();
+        _thread->wait();
+        delete _thread;
+        _thread = nullptr;
+    }
+
+    // The descriptor is closed next, and its number may soon be reused
+    QMutexLocker locker(&_readMutex);
+    _fd = -1;
+}
+
+void PtyReader::wake()
+{
+    if (_wakePipe[1] >= 0) {
+        const char byte = 0;
+        // A full pipe already wakes the thread
+        [[maybe_unused]] const auto written = ::write(_wakePipe[1], &byte, 1);
+    }
+}
+
+void PtyReader::run()
+{
+    while (!_stopping) {
+        // The pty is left out of the poll while there is no room, or
+        // hang ups would be reported over and over
+        const bool readPty = !_paused && !_atEnd;
+        pollfd fds[2] = {{readPty ? _fd : -1, POLLIN, 0}, {_wakePipe[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(KonsoleDebug) << "Polling the pty failed:" << strerror(errno);
+            return;
+        }
+
+        if (fds[1].revents != 0) {
+            char drain[64];
+            while (::read(_wakePipe[0], drain, sizeof(drain)) > 0) { }
+        }
+        if (_stopping) {
+            return;
+        }
+        if (fds[0].revents & POLLNVAL) {
+            qCWarning(KonsoleDebug) << "The pty was closed under its reader";
+            return;
+        }
+        if (fds[0].revents != 0) {
+            QMutexLocker locker(&_readMutex);
+            readAvailable();
+        }
+    }
+}
+
+qsizetype PtyReader::readPending()
+{
+    QMutexLocker locker(&_readMutex);
+    if (_fd < 0) {
+        return 0;
+    }
+    return readAvailable();
+}
+
+qsizetype PtyReader::readAvailable()
+{
+    qsizetype total = 0;
+    while (!_atEnd) {
+        qsizetype offset;
+        qsizetype room;
+        {
+            QMutexLocker locker(&_bufferMutex);
+            const qsizetype used = _tail - _head;
+            offset = _tail & (_capacity - 1);
+            room = std::min(_capacity - used, _capacity - offset);
+            // Checked with the lock held, or consume() could miss it
+            _paused = room == 0;
+        }
+        if (room == 0) {
+            break;
+        }
+
+        const ssize_t length = ::read(_fd, _buffer.get() + offset, room);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length <= 0) {
+            // EIO once the last slave descriptor is gone
+            _atEnd = true;
+            Q_EMIT closed();
+            break;
+        }
+
+        total += length;
+        bool notify = false;
+        {
+            QMutexLocker locker(&_bufferMutex);
+            _tail += length;
+            if (!_notified) {
+                _notified = true;
+                notify = true;
+            }
+        }
+        if (notify) {
+            Q_EMIT readyRead();
+        }
+    }
+    return total;
+}
+
+qsizetype PtyReader::bytesAvailable() const
+{
+    QMutexLocker locker(&_bufferMutex);
+    return _tail - _head;
+}
+
+QByteArrayView PtyReader::peek(qsizetype maxLength) const
+{
+    QMutexLocker locker(&_bufferMutex);
+    const qsizetype offset = _head & (_capacity - 1);
+    const qsizetype length = std::min({maxLength, static_cast<qsizetype>(_tail - _head), _capacity - offset});
+    return QByteArrayView(_buffer.get() + offset, length);
+}
+
+void PtyReader::consume(qsizetype length)
+{
+    bool resume = false;
+    {
+        QMutexLocker locker(&_bufferMutex);
+        _head += std::min(length, static_cast<qsizetype>(_tail - _head));
+        if (_head == _tail) {
+            _notified = false;
+        }
+        resume = _paused && _capacity - (_tail - _head) >= _capacity / ResumeFraction;
+        if (resume) {
+            _paused = false;
+        }
+    }
+    if (resume) {
+        wake();
+    }
+}
+
+#include "moc_PtyReader.cpp"
+
+#endif // Q_OS_WIN
@@ -0,0 +1,140 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PTYREADER_H
+#define PTYREADER_H
+
+// Qt
+#include <QByteArrayView>
+#include <QMutex>
+#include <QObject>
+
+// std
+#include <atomic>
+#include <memory>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QThread;
+
+namespace Konsole
+{
+/**
+ * Reads the output of a terminal on a thread of its own, into a ring
+ * buffer of fixed size.
+ *
+ * Reading the pty from the GUI thread, a chunk per readyRead(), lets a
+ * terminal flooded with output keep the event loop busy with one read after
+ * another, and a new array is allocated for every chunk.  The reader drains
+ * the pty in large reads as soon as output arrives, whatever the GUI thread
+ * is doing, and keeps it in one buffer which is reused for the whole life of
+ * the terminal.  The GUI thread takes the output from there in pieces of its
+ * choosing, with peek() and consume().
+ *
+ * Once the buffer is full the reader stops reading until enough was
+ * consumed, so the program writing to the terminal blocks instead of
+ * memory growing.
+ *
+ * The descriptor is not owned; stop() must be called before it is closed,
+ * and the reader leaves it alone from then on.
+ */
+class KONSOLEPRIVATE_EXPORT PtyReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @p capacity is rounded up to a power of two. */
+    explicit PtyReader(int fd, qsizetype capacity = DefaultCapacity, QObject *parent = nullptr);
+    ~PtyReader() override;
+
+    /** Starts reading on the reader thread. */
+    void start();
+    /**
+     * Stops reading for good and waits for the reader thread to end.  What
+     * was read already can still be consumed.
+     */
+    void stop();
+
+    /**
+     * Reads what the descriptor holds right away, on the calling thread, as
+     * far as there is room.  Used to get the last output of a program which
+     * has just exited.  Returns the number of bytes read, 0 once stopped.
+     */
+    qsizetype readPending();
+
+    /** The number of bytes read and not consumed yet. */
+    qsizetype bytesAvailable() const;
+
+    /**
+     * Returns the next unconsumed bytes, at most @p maxLength of them.  The
+     * data is contiguous, so less may be returned than is available.  It
+     * stays valid until consumed.
+     */
+    QByteArrayView peek(qsizetype maxLength) const;
+    /** Marks the first @p length bytes returned by peek() as done with. */
+    void consume(qsizetype length);
+
+    qsizetype capacity() const
+    {
+        return _capacity;
+    }
+
+    /** True while reading waits for room in the buffer. */
+    bool isPaused() const
+    {
+        return _paused.load();
+    }
+
+    /** True once the other side of the descriptor was closed. */
+    bool atEnd() const
+    {
+        return _atEnd.load();
+    }
+
+    static constexpr qsizetype DefaultCapacity = 1024 * 1024;
+    // Reading resumes once this much of the buffer is free again
+    static constexpr int ResumeFraction = 2;
+
+Q_SIGNALS:
+    /**
+     * Emitted from the reader thread when data arrives in an empty buffer.
+     * It is not emitted again before everything was consumed.
+     */
+    void readyRead();
+
+    /** Emitted from the reader thread when the other side was closed. */
+    void closed();
+
+private:
+    void run();
+    // Reads until the descriptor or the buffer runs dry; call with _readMutex held
+    qsizetype readAvailable();
+    void wake();
+
+    // -1 once stopped, guarded by _readMutex
+    int _fd;
+    int _wakePipe[2] = {-1, -1};
+    QThread *_thread = nullptr;
+
+    std::unique_ptr<char[]> _buffer;
+    qsizetype _capacity;
+    // Bytes read and consumed since the start, only ever growing
+    qint64 _head = 0;
+    qint64 _tail = 0;
+    mutable QMutex _bufferMutex;
+    // Held around reads, which may come from either thread
+    QMutex _readMutex;
+    bool _notified = false;
+
+    std::atomic<bool> _paused = false;
+    std::atomic<bool> _atEnd = false;
+    std::atomic<bool> _stopping = false;
+};
+
+}
+
+#endif // PTYREADER_H
@@ -10,6 +10,11 @@
 
 #include "config-konsole.h"
 
+// std
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 // Qt
 #include <QFile>
 #include <QTextStream>
@@ -18,12 +23,14 @@
 #include <HTMLDecoder.h>
 #include <PlainTextDecoder.h>
 
+#include "session/EmulationScheduler.h"
 #include "session/Session.h"
 #include "session/SessionController.h"
 #include "terminalDisplay/TerminalDisplay.h"
 #include "terminalDisplay/TerminalFonts.h"
 
 #include "EscapeSequenceUrlExtractor.h"
+#include "SelectionExport.h"
 #include "characters/ExtendedCharTable.h"
 #include "history/HistoryScrollNone.h"
 #include "history/HistoryType.h"
@@ -37,6 +44,26 @@ extern "C" {
 
 using namespace Konsole;
 
+namespace
+{
+// Interns a grapheme cluster; once the table is full, the keys no screen
+// uses any more are reclaimed and the cluster gets one of those
+char32_t internExtendedChar(const char32_t *chars, ushort length)
+{
+    char32_t key = ExtendedCharTable::instance.createExtendedChar(chars, length);
+    if (key == 0) {
+        // The screens can't be read while workers write to them
+        EmulationScheduler::runOnGuiThread([]() {
+            ExtendedCharTable::instance.reclaimUnused();
+        });
+        if (!EmulationScheduler::isParsing()) {
+            key = ExtendedCharTable::instance.createExtendedChar(chars, length);
+        }
+    }
+    return key;
+}
+}
+
 // Macro to convert x,y position on screen to position within an image.
 //
 // Originally the image was stored as one large contiguous block of
@@ -86,7 +113,6 @@ Screen::Screen(int lines, int columns)
     , _replMode(REPL_None)
     , _hasRepl(false)
     , _replHadOutput(false)
-    , _replLastOutputStart(std::pair(-1, -1))
     , _tabStops(QBitArray())
     , _selBegin(0)
     , _selTopLeft(0)
@@ -108,9 +134,34 @@ Screen::Screen(int lines, int columns)
     initTabStops();
     clearSelection();
     reset();
+
+    ExtendedCharTable::instance.addKeySource(this, [this](QSet<uint> &keys) {
+        collectExtendedChars(keys);
+    });
 }
 
-Screen::~Screen() = default;
+Screen::~Screen()
+{
+    // Whatever is left to copy is copied while it is still there
+    for (SelectionExport *selection : std::vector(_exports)) {
+        selection->screenDestroyed();
+    }
+    ExtendedCharTable::instance.removeKeySource(this);
+}
+
+void Screen::collectExtendedChars(QSet<uint> &keys) const
+{
+    for (int i = 0; i < _lines; ++i) {
+        Character::collectExtendedChars(_screenLines[i].constData(), _screenLines[i].length(), keys);
+    }
+    QVector<Character> line;
+    for (int i = 0; i < _history->getLines(); ++i) {
+        const int length = _history->getLineLen(i);
+        line.resize(length);
+        _history->getCells(i, 0, length, line.data());
+        Character::collectExtendedChars(line.constData(), length, keys);
+    }
+}
 
 void Screen::cursorUp(int n)
 //=CUU
@@ -339,6 +390,7 @@ void Screen::reverseIndex()
 //=RI
 {
     if (_cuY == _topMargin) {
+        semanticLinesMoving(_topMargin);
         scrollDown(_topMargin, 1);
     } else if (_cuY > 0) {
         _cuY -= 1;
@@ -460,6 +512,7 @@ void Screen::deleteLines(int n)
     if (n < 1) {
         n = 1; // Default
     }
+    semanticLinesMoving(_cuY);
     scrollUp(_cuY, n);
 }
 
@@ -471,6 +524,7 @@ void Screen::insertLines(int n)
     if (n < 1) {
         n = 1; // Default
     }
+    semanticLinesMoving(_cuY);
     scrollDown(_cuY, n);
 }
 
@@ -608,8 +662,10 @@ void Screen::resizeImage(int new_lines, int new_columns)
     if ((new_lines == _lines) && (new_columns == _columns)) {
         return;
     }
+    saveLinesForExports(-1);
     // Adjust scroll position, and fix glitches
     _oldTotalLines = getLines() + getHistLines();
+    _layoutGeneration++;
     _isResize = true;
 
     int cursorLine = getCursorLine();
@@ -623,6 +679,7 @@ void Screen::resizeImage(int new_lines, int new_columns)
             --cursorLine;
             scrollPlacements(1);
         }
+        const int reflowedLines = _history->getLines();
         std::map<int, int> deltas = {};
         auto removedLines = _history->reflowLines(new_columns, &deltas);
 
@@ -635,8 +692,30 @@ void Screen::resizeImage(int new_lines, int new_columns)
         for (const auto &[pos, delta] : deltas) {
             scrollPlacements(delta, INT64_MIN, pos);
         }
+
+        // The prompts move with their lines rather than being searched for
+        // again in the whole history: each delta applies to the lines from
+        // its position, counted from the end, on
+        std::vector<std::pair<int, int>> moves;
+        int moved = 0;
+        for (const auto &[pos, delta] : deltas) {
+            moved += delta;
+            moves.emplace_back(reflowedLines + pos, moved);
+        }
+        _semanticBlocks.remap([&moves](int line) {
+            auto move = std::upper_bound(moves.cbegin(), moves.cend(), line, [](int value, const std::pair<int, int> &m) {
+                return value < m.first;
+            });
+            return move == moves.cbegin() ? line : line + std::prev(move)->second;
+        });
+        _semanticBlocks.linesDropped(removedLines);
     }
 
+    // Lines from here on may be joined, split or cut off on the screen;
+    // the prompts among them are searched for again
+    const int screenStart = _history->getLines();
+    const qint64 droppedBefore = _totalDroppedLines;
+
     if (_enableReflowLines && new_columns != _columns) {
         int cursorLineCorrection = 0;
         if (currentTerminalDisplay()) {
@@ -727,6 +806,8 @@ void Screen::resizeImage(int new_lines, int new_columns)
     }
     _screenLines.resize(new_lines + 1);
 
+    _semanticBlocks.invalidateFrom(screenStart - static_cast<int>(_totalDroppedLines - droppedBefore));
+
     _screenLinesSize = new_lines;
     _lines = new_lines;
     _columns = new_columns;
@@ -963,11 +1044,14 @@ void Screen::reset(bool softReset, bool preservePrompt)
     if (!softReset) {
         if (preservePrompt) {
             // Clear screen, but preserve the current line and X position
+            semanticLinesMoving(0);
             scrollUp(0, _cuY);
             _cuY = 0;
             if (_hasGraphics) {
                 delPlacements();
-                currentTerminalDisplay()->update();
+                EmulationScheduler::runOnGuiThread([this]() {
+                    currentTerminalDisplay()->update();
+                });
             }
         } else {
             clearEntireScreen();
@@ -1222,11 +1306,11 @@ void Screen::displayCharacter(uint c)
 
         if (currentChar.rendition.f.extended == 0) {
             const char32_t chars[2] = {currentChar.character, c};
-            currentChar.rendition.f.extended = 1;
-            auto extChars = [this]() {
-                return usedExtendedChars();
-            };
-            currentChar.character = ExtendedCharTable::instance.createExtendedChar(chars, 2, extChars);
+            // without a key the combining character is lost
+            if (const char32_t key = internExtendedChar(chars, 2)) {
+                currentChar.rendition.f.extended = 1;
+                currentChar.character = key;
+            }
             if (category == QChar::Mark_SpacingCombining) {
                 // ensure current line vector has enough elements
                 if (_screenLines[_cuY].size() < _cuX + w) {
@@ -1250,10 +1334,9 @@ void Screen::displayCharacter(uint c)
                 auto chars = std::make_unique<char32_t[]>(extendedCharLength + 1);
                 std::copy_n(oldChars, extendedCharLength, chars.get());
                 chars[extendedCharLength] = c;
-                auto extChars = [this]() {
-                    return usedExtendedChars();
-                };
-                currentChar.character = ExtendedCharTable::instance.createExtendedChar(chars.get(), extendedCharLength + 1, extChars);
+                if (const char32_t key = internExtendedChar(chars.get(), extendedCharLength + 1)) {
+                    currentChar.character = key;
+                }
             }
         }
         return;
@@ -1363,6 +1446,9 @@ void Screen::scrollUp(int n)
     if (n < 1) {
         n = 1; // Default
     }
+    if (_topMargin != 0 || _bottomMargin != _lines - 1) {
+        semanticLinesMoving(_topMargin);
+    }
     for (int i = 0; i < n; i++) {
         if (_topMargin == 0) {
             addHistLine(); // history.history
@@ -1393,6 +1479,11 @@ void Screen::scrollUp(int from, int n)
 
     // FIXME: make sure `topMargin', `bottomMargin', `from', `n' is in bounds.
     moveImage(loc(0, from), loc(0, from + n), loc(_columns, _bottomMargin));
+    // The lines scrolled out were rotated to the bottom, they are gone
+    // rather than cleared
+    for (int y = _bottomMargin - n + 1; y <= _bottomMargin; ++y) {
+        _lineProperties[y].resetStarts();
+    }
     clearImage(loc(0, _bottomMargin - n + 1), loc(_columns - 1, _bottomMargin), ' ');
     if (_hasGraphics) {
         scrollPlacements(n);
@@ -1403,10 +1494,6 @@ void Screen::scrollUp(int from, int n)
             _replModeStart = std::make_pair(_replModeStart.first - 1, _replModeStart.second);
             _replModeEnd = std::make_pair(_replModeEnd.first - 1, _replModeEnd.second);
         }
-        if (_replLastOutputStart.first > -1) {
-            _replLastOutputStart = std::make_pair(_replLastOutputStart.first - 1, _replLastOutputStart.second);
-            _replLastOutputEnd = std::make_pair(_replLastOutputEnd.first - 1, _replLastOutputEnd.second);
-        }
     }
 }
 
@@ -1415,6 +1502,7 @@ void Screen::scrollDown(int n)
     if (n < 1) {
         n = 1; // Default
     }
+    semanticLinesMoving(_topMargin);
     scrollDown(_topMargin, n);
 }
 
@@ -1437,6 +1525,16 @@ void Screen::scrollDown(int from, int n)
     clearImage(loc(0, from), loc(_columns - 1, from + n - 1), ' ');
 }
 
+void Screen::semanticLinesMoving(int from)
+{
+    for (int y = std::max(from, 0); y < _lines; ++y) {
+        if (_lineProperties[y].getStarts() != 0) {
+            _semanticBlocks.invalidateFrom(_history->getLines() + std::max(from, 0));
+            return;
+        }
+    }
+}
+
 void Screen::setCursorYX(int y, int x)
 {
     setCursorY(y);
@@ -1512,6 +1610,9 @@ void Screen::clearImage(int loca, int loce, char c, bool resetLineRendition)
                 _lineProperties[y].length = startCol;
             }
         } else {
+            if (_lineProperties[y].getStarts() != 0) {
+                _semanticBlocks.invalidateFrom(_history->getLines() + y);
+            }
             if (resetLineRendition) {
                 _lineProperties[y] = LineProperty();
             }
@@ -1644,7 +1745,9 @@ void Screen::clearEntireScreen()
     clearImage(loc(0, 0), loc(_columns - 1, _lines - 1), ' ');
     if (_hasGraphics) {
         delPlacements();
-        currentTerminalDisplay()->update();
+        EmulationScheduler::runOnGuiThread([this]() {
+            currentTerminalDisplay()->update();
+        });
     }
 }
 
@@ -1983,30 +2086,54 @@ void Screen::selectReplContigious(const int x, const int y)
 }
 
 QString Screen::selectedText(const DecodingOptions options) const
+{
+    return regionText(selectedRegion(), options);
+}
+
+Screen::TextRegion Screen::selectedRegion() const
 {
     if (!isSelectionValid()) {
         if (!_hasRepl) {
-            return QString();
+            return TextRegion();
         }
         int currentStart = (_history->getLines() + _replModeStart.first) * _columns + _replModeStart.second;
         int currentEnd = (_history->getLines() + _replModeEnd.first) * _columns + _replModeEnd.second - 1;
 
-        if (_replMode == REPL_INPUT && currentStart > currentEnd && _replLastOutputStart.first > -1) {
+        if (_replMode == REPL_INPUT && currentStart > currentEnd) {
             // If no input yet, copy last output
-            currentStart = (_history->getLines() + _replLastOutputStart.first) * _columns + _replLastOutputStart.second;
-            currentEnd = (_history->getLines() + _replLastOutputEnd.first) * _columns + _replLastOutputEnd.second - 1;
+            return lastCommandOutputRegion();
         }
         if (currentEnd >= currentStart) {
-            return text(currentStart, currentEnd, options);
+            return regionBetween(currentStart, currentEnd);
         }
-        return QString();
+        return TextRegion();
     }
 
-    return text(_selTopLeft, _selBottomRight, options);
+    return regionBetween(_selTopLeft, _selBottomRight);
+}
+
+Screen::TextRegion Screen::regionBetween(int startIndex, int endIndex) const
+{
+    TextRegion region;
+    region.top = startIndex / _columns;
+    region.left = startIndex % _columns;
+    region.bottom = endIndex / _columns;
+    region.right = endIndex % _columns;
+    region.blockMode = _blockSelectionMode;
+    return region;
 }
 
 QString Screen::text(int startIndex, int endIndex, const DecodingOptions options) const
 {
+    return regionText(regionBetween(startIndex, endIndex), options);
+}
+
+QString Screen::regionText(const TextRegion &region, const DecodingOptions options) const
+{
+    if (!region.isValid()) {
+        return QString();
+    }
+
     QString result;
     QTextStream stream(&result, QIODevice::ReadWrite);
 
@@ -2021,7 +2148,7 @@ QString Screen::text(int startIndex, int endIndex, const DecodingOptions options
     }
 
     decoder->begin(&stream);
-    writeToStream(decoder, startIndex, endIndex, options);
+    writeRegionToStream(decoder, region, region.top, region.bottom, options);
     decoder->end();
 
     return result;
@@ -2034,27 +2161,44 @@ bool Screen::isSelectionValid() const
 
 void Screen::writeToStream(TerminalCharacterDecoder *decoder, int startIndex, int endIndex, const DecodingOptions options) const
 {
-    const int top = startIndex / _columns;
-    const int left = startIndex % _columns;
+    const TextRegion whole = regionBetween(startIndex, endIndex);
+    writeRegionToStream(decoder, whole, whole.top, whole.bottom, options);
+}
+
+void Screen::writeRegionToStream(TerminalCharacterDecoder *decoder,
+                                 const TextRegion &region,
+                                 int fromLine,
+                                 int toLine,
+                                 const DecodingOptions options,
+                                 const LinesSnapshot *snapshot) const
+{
+    const int top = region.top;
+    const int left = region.left;
+
+    const int bottom = region.bottom;
+    const int right = region.right;
 
-    const int bottom = endIndex / _columns;
-    const int right = endIndex % _columns;
+    // top is negative when the first lines of a region taken earlier have
+    // dropped off the history since
+    Q_ASSERT(left >= 0 && bottom >= 0 && right >= 0);
 
-    Q_ASSERT(top >= 0 && left >= 0 && bottom >= 0 && right >= 0);
+    const int lastLine = snapshot != nullptr ? snapshot->lastLine() : _history->getLines() + _lines - 1;
+    fromLine = std::max({fromLine, top, 0});
+    toLine = std::min({toLine, bottom, lastLine});
 
-    for (int y = top; y <= bottom; ++y) {
+    for (int y = fromLine; y <= toLine; ++y) {
         int start = 0;
-        if (y == top || _blockSelectionMode) {
+        if (y == top || region.blockMode) {
             start = left;
         }
 
         int count = -1;
-        if (y == bottom || _blockSelectionMode) {
+        if (y == bottom || region.blockMode) {
             count = right - start + 1;
         }
 
         const bool appendNewLine = (y != bottom);
-        int copied = copyLineToStream(y, start, count, decoder, appendNewLine, _blockSelectionMode, options);
+        int copied = copyLineToStream(y, start, count, decoder, appendNewLine, region.blockMode, options, snapshot);
 
         // if the selection goes beyond the end of the last line then
         // append a new line character.
@@ -2068,6 +2212,51 @@ void Screen::writeToStream(TerminalCharacterDecoder *decoder, int startIndex, in
     }
 }
 
+Screen::LinesSnapshot Screen::snapshotLines(int fromLine, int toLine) const
+{
+    LinesSnapshot snapshot;
+    snapshot.firstLine = std::clamp(_history->getLines(), fromLine, toLine + 1);
+    appendToSnapshot(snapshot, snapshot.firstLine, toLine);
+    return snapshot;
+}
+
+void Screen::appendToSnapshot(LinesSnapshot &snapshot, int fromLine, int toLine) const
+{
+    const int histLines = _history->getLines();
+    const int last = std::min(toLine, histLines + _lines - 1);
+    for (int line = std::max(fromLine, 0); line <= last; ++line) {
+        if (line < histLines) {
+            QVector<Character> cells(_history->getLineLen(line));
+            _history->getCells(line, 0, cells.size(), cells.data());
+            snapshot.lines.push_back(std::move(cells));
+            snapshot.properties.push_back(_history->getLineProperty(line));
+        } else {
+            snapshot.lines.push_back(_screenLines.at(line - histLines));
+            snapshot.properties.push_back(_lineProperties.at(line - histLines));
+        }
+    }
+}
+
+void Screen::addExport(SelectionExport *selection)
+{
+    _exports.push_back(selection);
+}
+
+void Screen::removeExport(SelectionExport *selection)
+{
+    _exports.erase(std::remove(_exports.begin(), _exports.end(), selection), _exports.end());
+}
+
+void Screen::saveLinesForExports(int droppedLines)
+{
+    if (_exports.empty()) {
+        return;
+    }
+    for (SelectionExport *selection : _exports) {
+        selection->screenChanging(droppedLines);
+    }
+}
+
 int Screen::getLineLength(const int line) const
 {
     // determine if the line is in the history buffer or the screen image
@@ -2086,8 +2275,9 @@ Character *Screen::getCharacterBuffer(const int size)
     // the buffer is static to avoid initializing every
     // element on each call to copyLineToStream
     // (which is unnecessary since all elements will be overwritten anyway)
+    // and per thread, as screens may be parsed on worker threads
     static const int MAX_CHARS = 1024;
-    static QVector<Character> characterBuffer(MAX_CHARS);
+    thread_local QVector<Character> characterBuffer(MAX_CHARS);
 
     if (characterBuffer.count() < size) {
         characterBuffer.resize(size);
@@ -2174,16 +2364,21 @@ int Screen::copyLineToStream(int line,
                              TerminalCharacterDecoder *decoder,
                              bool appendNewLine,
                              bool isBlockSelectionMode,
-                             const DecodingOptions options) const
+                             const DecodingOptions options,
+                             const LinesSnapshot *snapshot) const
 {
-    const int lineLength = getLineLength(line);
+    // lines in the snapshot are read from it, as they were on the screen image
+    const int snapshotLine = snapshot != nullptr ? line - snapshot->firstLine : -1;
+    Q_ASSERT(snapshot == nullptr || (snapshotLine >= 0 && snapshotLine < static_cast<int>(snapshot->lines.size())));
+
+    const int lineLength = snapshot != nullptr ? snapshot->lines[snapshotLine].count() : getLineLength(line);
     // ensure that this method, can append space or 'eol' character to
     // the selection
     Character *characterBuffer = getCharacterBuffer((count > -1 ? count : lineLength - start) + 1);
     LineProperty currentLineProperties = LineProperty();
 
     // determine if the line is in the history buffer or the screen image
-    if (line < _history->getLines()) {
+    if (snapshot == nullptr && line < _history->getLines()) {
         // ensure that start position is before end of line
         // lineLength can be 0 as well
         start = lineLength <= 0 ? 0 : qBound(0, start, lineLength - 1);
@@ -2225,14 +2420,25 @@ int Screen::copyLineToStream(int line,
 
         Q_ASSERT(count >= 0);
 
-        int screenLine = line - _history->getLines();
+        const Character *data;
+        int length;
+        if (snapshot != nullptr) {
+            data = snapshot->lines[snapshotLine].constData();
+            length = lineLength;
+            currentLineProperties = snapshot->properties[snapshotLine];
+        } else {
+            int screenLine = line - _history->getLines();
 
-        Q_ASSERT(screenLine <= _screenLinesSize);
+            Q_ASSERT(screenLine <= _screenLinesSize);
 
-        screenLine = qMin(screenLine, _screenLinesSize);
+            screenLine = qMin(screenLine, _screenLinesSize);
 
-        auto *data = _screenLines[screenLine].data();
-        int length = _screenLines.at(screenLine).count();
+            data = _screenLines[screenLine].constData();
+            length = _screenLines.at(screenLine).count();
+
+            Q_ASSERT((size_t)screenLine < _lineProperties.size());
+            currentLineProperties = _lineProperties[screenLine];
+        }
 
         // Exclude trailing empty cells from count and don't bother processing them further.
         // This is necessary because a newline gets added to the last line when
@@ -2245,7 +2451,7 @@ int Screen::copyLineToStream(int line,
         }
 
         // Don't remove end spaces in lines that wrap
-        if (options.testFlag(TrimTrailingWhitespace) && ((_lineProperties.at(screenLine).flags.f.wrapped) == 0)) {
+        if (options.testFlag(TrimTrailingWhitespace) && ((currentLineProperties.flags.f.wrapped) == 0)) {
             // ignore trailing white space at the end of the line
             while (length > 0 && QChar::isSpace(data[length - 1].character)) {
                 length--;
@@ -2261,9 +2467,6 @@ int Screen::copyLineToStream(int line,
         // count cannot be any greater than length
         // and if start is after length we have nothing to copy
         count = start >= length ? 0 : qBound(0, count, length - start);
-
-        Q_ASSERT((size_t)screenLine < _lineProperties.size());
-        currentLineProperties = _lineProperties[screenLine];
     }
 
     // If the last character is wide, account for it
@@ -2336,6 +2539,9 @@ void Screen::writeLinesToStream(TerminalCharacterDecoder *decoder, int fromLine,
 void Screen::fastAddHistLine()
 {
     const bool removeLine = _history->getLines() == _history->getMaxLines();
+    if (removeLine) {
+        saveLinesForExports(1);
+    }
     _history->addCellsVector(_screenLines.at(0));
     _history->addLine(linePropertiesAt(0));
 
@@ -2345,6 +2551,8 @@ void Screen::fastAddHistLine()
         if (_escapeSequenceUrlExtractor) {
             _escapeSequenceUrlExtractor->historyLinesRemoved(1);
         }
+        _semanticBlocks.linesDropped(1);
+        _totalDroppedLines++;
 
         _fastDroppedLines++;
     }
@@ -2365,6 +2573,9 @@ void Screen::addHistLine()
     int newHistLines = _history->getLines();
 
     if (hasScroll()) {
+        if (!_history->getType().isUnlimited() && oldHistLines >= _history->getMaxLines()) {
+            saveLinesForExports(1);
+        }
         _history->addCellsVector(_screenLines.at(0));
         _history->addLine(_lineProperties.at(0));
 
@@ -2375,12 +2586,18 @@ void Screen::addHistLine()
         if (newHistLines <= oldHistLines) {
             _droppedLines += oldHistLines - newHistLines + 1;
 
-            currentTerminalDisplay()->removeLines(oldHistLines - newHistLines + 1);
+            removeDisplayLines(oldHistLines - newHistLines + 1);
             // We removed some lines, we need to verify if we need to remove a URL.
             if (_escapeSequenceUrlExtractor) {
                 _escapeSequenceUrlExtractor->historyLinesRemoved(oldHistLines - newHistLines + 1);
             }
+            _semanticBlocks.linesDropped(oldHistLines - newHistLines + 1);
+            _totalDroppedLines += oldHistLines - newHistLines + 1;
         }
+    } else {
+        // The top line scrolls away for good
+        _semanticBlocks.linesDropped(1);
+        _totalDroppedLines++;
     }
 
     bool beginIsTL = (_selBegin == _selTopLeft);
@@ -2426,20 +2643,43 @@ int Screen::getHistLines() const
     return _history->getLines();
 }
 
+void Screen::removeDisplayLines(int count)
+{
+    if (!EmulationScheduler::isParsing()) {
+        currentTerminalDisplay()->removeLines(count);
+        return;
+    }
+    // The view belongs to the GUI thread; it is told once the turn is over,
+    // about all lines removed meanwhile
+    if (_deferredRemovedLines == 0) {
+        EmulationScheduler::runOnGuiThread([this]() {
+            currentTerminalDisplay()->removeLines(std::exchange(_deferredRemovedLines, 0));
+        });
+    }
+    _deferredRemovedLines += count;
+}
+
 void Screen::setScroll(const HistoryType &t, bool copyPreviousScroll)
 {
+    saveLinesForExports(-1);
     clearSelection();
 
     if (copyPreviousScroll) {
+        // The newest lines are kept
+        const int oldHistLines = _history->getLines();
         t.scroll(_history);
+        _semanticBlocks.linesDropped(std::max(0, oldHistLines - _history->getLines()));
     } else {
         // As 't' can be '_history' pointer, move it to a temporary smart pointer
         // making _history = nullptr
         auto oldHistory = std::move(_history);
         currentTerminalDisplay()->removeLines(oldHistory->getLines());
         t.scroll(_history);
+        _semanticBlocks.invalidate();
     }
     _graphicsPlacements.clear();
+    _placementIndexDirty = true;
+    _layoutGeneration++;
 #if HAVE_MALLOC_TRIM
 
 #ifdef Q_OS_LINUX
@@ -2459,6 +2699,11 @@ const HistoryType &Screen::getScroll() const
     return _history->getType();
 }
 
+size_t Screen::historyMemoryUsage() const
+{
+    return _history->memoryUsage();
+}
+
 void Screen::setLineProperty(quint16 property, bool enable)
 {
     if (enable) {
@@ -2479,15 +2724,14 @@ LineProperty Screen::linePropertiesAt(unsigned int line)
 void Screen::setReplMode(int mode)
 {
     if (_replMode != mode) {
-        if (_replMode == REPL_OUTPUT) {
-            _replLastOutputStart = _replModeStart;
-            _replLastOutputEnd = _replModeEnd;
-        } else if (_replMode == REPL_PROMPT) {
+        if (_replMode == REPL_PROMPT) {
             _lineProperties[_cuY].counter = ++commandCounter;
         }
         if (mode == REPL_PROMPT) {
             if (_replHadOutput) {
-                currentTerminalDisplay()->sessionController()->notifyPrompt();
+                EmulationScheduler::runOnGuiThread([this]() {
+                    currentTerminalDisplay()->sessionController()->notifyPrompt();
+                });
                 _replHadOutput = false;
             }
         }
@@ -2497,11 +2741,29 @@ void Screen::setReplMode(int mode)
         _replMode = mode;
         _replModeStart = std::make_pair(_cuY, _cuX);
         _replModeEnd = std::make_pair(_cuY, _cuX);
+
+        const int line = _history->getLines() + _cuY;
+        switch (mode) {
+        case REPL_PROMPT:
+            _semanticBlocks.markPrompt(line);
+            break;
+        case REPL_INPUT:
+            _semanticBlocks.markInput(line, commandCounter);
+            break;
+        case REPL_OUTPUT:
+            _semanticBlocks.markOutput(line);
+            break;
+        default:
+            _semanticBlocks.markFinished(_cuX > 0 ? line + 1 : line);
+            break;
+        }
     }
     if (mode != REPL_None) {
         if (!_hasRepl) {
             _hasRepl = true;
-            currentTerminalDisplay()->sessionController()->setVisible(QStringLiteral("monitor-prompt"), true);
+            EmulationScheduler::runOnGuiThread([this]() {
+                currentTerminalDisplay()->sessionController()->setVisible(QStringLiteral("monitor-prompt"), true);
+            });
         }
         Q_EMIT currentTerminalDisplay()->screenWindow()->selectionChanged(); // Enable copy action
         setLineProperty(LINE_PROMPT_START << (mode - REPL_PROMPT), true);
@@ -2510,6 +2772,11 @@ void Screen::setReplMode(int mode)
 
 void Screen::setExitCode(int exitCode)
 {
+    _semanticBlocks.setExitCode(exitCode);
+    if (exitCode == 0) {
+        return;
+    }
+
     int y = _cuY - 1;
     while (y >= 0) {
         _lineProperties[y].flags.f.error = (exitCode != 0);
@@ -2528,6 +2795,43 @@ void Screen::setExitCode(int exitCode)
         y--;
     }
 }
+
+const SemanticBlockIndex &Screen::semanticBlocks() const
+{
+    if (!_semanticBlocks.isValid()) {
+        const int histLines = _history->getLines();
+        const int endLine = _replMode == REPL_None ? histLines + _cuY + (_cuX > 0 ? 1 : 0) : -1;
+        _semanticBlocks.rebuild(
+            histLines + _lines,
+            [this, histLines](int line) {
+                return line < histLines ? _history->getLineProperty(line) : _lineProperties.at(line - histLines);
+            },
+            endLine,
+            _semanticBlocks.dirtyLine());
+    }
+    return _semanticBlocks;
+}
+
+QString Screen::lastCommandOutput(const DecodingOptions options) const
+{
+    return regionText(lastCommandOutputRegion(), options);
+}
+
+Screen::TextRegion Screen::lastCommandOutputRegion() const
+{
+    const SemanticBlockIndex &blocks = semanticBlocks();
+    const int index = blocks.lastOutputBlock();
+    if (index < 0) {
+        return TextRegion();
+    }
+    const SemanticBlockIndex::Block block = blocks.block(index);
+    const int endLine = block.endLine < 0 ? _history->getLines() + _cuY + 1 : block.endLine;
+    if (endLine <= block.outputLine) {
+        return TextRegion();
+    }
+    return regionBetween(loc(0, block.outputLine), loc(_columns - 1, endLine - 1));
+}
+
 void Screen::fillWithDefaultChar(Character *dest, int count)
 {
     std::fill_n(dest, count, Screen::DefaultChar);
@@ -2554,7 +2858,7 @@ Konsole::EscapeSequenceUrlExtractor *Konsole::Screen::urlExtractor() const
     return _escapeSequenceUrlExtractor.get();
 }
 
-void Screen::addPlacement(QPixmap pixmap,
+void Screen::addPlacement(const GraphicsImage &image,
                           int &rows,
                           int &cols,
                           int row,
@@ -2570,7 +2874,7 @@ void Screen::addPlacement(QPixmap pixmap,
                           int X,
                           int Y)
 {
-    if (pixmap.isNull()) {
+    if (image.isNull()) {
         return;
     }
 
@@ -2583,13 +2887,13 @@ void Screen::addPlacement(QPixmap pixmap,
         col = _cuX;
     }
     if (rows == -1) {
-        rows = (pixmap.height() - 1) / currentTerminalDisplay()->terminalFont()->fontHeight() + 1;
+        rows = (image.height() - 1) / currentTerminalDisplay()->terminalFont()->fontHeight() + 1;
     }
     if (cols == -1) {
-        cols = (pixmap.width() - 1) / currentTerminalDisplay()->terminalFont()->fontWidth() + 1;
+        cols = (image.width() - 1) / currentTerminalDisplay()->terminalFont()->fontWidth() + 1;
     }
 
-    p->pixmap = pixmap;
+    p->image = image;
     p->z = z;
     p->row = row;
     p->col = col;
@@ -2650,6 +2954,7 @@ void Screen::addPlacement(std::unique_ptr<TerminalGraphicsPlacement_t> &placemen
         ;
     _graphicsPlacements.insert(i, std::move(placement));
     _hasGraphics = true;
+    _placementIndexDirty = true;
     // Placements with pid<0 cannot be deleted by the application, so remove those fully covered
     // by others.
     QRegion covered = QRegion();
@@ -2680,6 +2985,58 @@ TerminalGraphicsPlacement_t *Screen::getGraphicsPlacement(unsigned int i)
     return _graphicsPlacements[i].get();
 }
 
+static int placementBand(int row, int bandRows)
+{
+    // rows in the history are negative, round towards minus infinity
+    return row >= 0 ? row / bandRows : -((-row + bandRows - 1) / bandRows);
+}
+
+void Screen::rebuildPlacementIndex() const
+{
+    _placementBands.clear();
+    for (int i = 0; i < int(_graphicsPlacements.size()); ++i) {
+        const TerminalGraphicsPlacement_t *placement = _graphicsPlacements[i].get();
+        const int firstBand = placementBand(placement->row, PlacementBandRows);
+        const int lastBand = placementBand(placement->row + qMax(1, placement->rows) - 1, PlacementBandRows);
+        for (int band = firstBand; band <= lastBand; ++band) {
+            _placementBands[band].append(i);
+        }
+    }
+    _placementIndexDirty = false;
+}
+
+void Screen::graphicsPlacementsInRows(int firstRow, int lastRow, QVector<TerminalGraphicsPlacement_t *> &placements) const
+{
+    placements.clear();
+    if (_graphicsPlacements.empty()) {
+        return;
+    }
+    if (_placementIndexDirty) {
+        rebuildPlacementIndex();
+    }
+
+    QVector<int> indices;
+    const int lastBand = placementBand(lastRow, PlacementBandRows);
+    for (int band = placementBand(firstRow, PlacementBandRows); band <= lastBand; ++band) {
+        const auto it = _placementBands.constFind(band);
+        if (it != _placementBands.cend()) {
+            indices += it.value();
+        }
+    }
+
+    // placements spanning several bands were found more than once; the
+    // index into _graphicsPlacements is the painting order
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    placements.reserve(indices.size());
+    for (const int i : std::as_const(indices)) {
+        TerminalGraphicsPlacement_t *placement = _graphicsPlacements[i].get();
+        if (placement->row <= lastRow && placement->row + qMax(1, placement->rows) > firstRow) {
+            placements.append(placement);
+        }
+    }
+}
+
 void Screen::scrollPlacements(int n, qint64 below, qint64 above)
 {
     std::vector<std::unique_ptr<TerminalGraphicsPlacement_t>>::iterator i;
@@ -2689,6 +3046,7 @@ void Screen::scrollPlacements(int n, qint64 below, qint64 above)
         TerminalGraphicsPlacement_t *placement = i->get();
         if ((placement->scrolling && below == INT64_MAX) || (placement->row > below && placement->row < above)) {
             placement->row -= n;
+            _placementIndexDirty = true;
             if (placement->row + placement->rows < -histMaxLines) {
                 i = _graphicsPlacements.erase(i);
             } else {
@@ -2749,6 +3107,7 @@ void Screen::delPlacements(int del, qint64 id, qint64 pid, int x, int y, int z)
         }
         if (remove) {
             i = _graphicsPlacements.erase(i);
+            _placementIndexDirty = true;
         } else {
             i++;
         }
@@ -13,6 +13,7 @@
 
 // Qt
 #include <QBitArray>
+#include <QHash>
 #include <QPointer>
 #include <QRect>
 #include <QSet>
@@ -21,6 +22,8 @@
 
 // Konsole
 #include "../characters/Character.h"
+#include "GraphicsImage.h"
+#include "SemanticBlockIndex.h"
 #include "konsoleprivate_export.h"
 
 #define MODE_Origin 0
@@ -39,7 +42,7 @@
 #define REPL_OUTPUT 3
 
 struct TerminalGraphicsPlacement_t {
-    QPixmap pixmap;
+    Konsole::GraphicsImage image;
     qint64 id;
     qint64 pid;
     int z, X, Y, col, row, cols, rows;
@@ -55,6 +58,7 @@ class TerminalDisplay;
 class HistoryType;
 class HistoryScroll;
 class EscapeSequenceUrlExtractor;
+class SelectionExport;
 
 /**
     \brief An image of characters with associated attributes.
@@ -103,6 +107,24 @@ public:
     };
     Q_DECLARE_FLAGS(DecodingOptions, DecodingOption)
 
+    /**
+     * A range of text as first and last line and column, in the numbering
+     * of the lines at the time it was taken.  In block mode the columns
+     * apply to every line, otherwise only to the first and the last.
+     */
+    struct TextRegion {
+        int top = -1;
+        int left = 0;
+        int bottom = -1;
+        int right = 0;
+        bool blockMode = false;
+
+        bool isValid() const
+        {
+            return top >= 0 && bottom >= top;
+        }
+    };
+
     /** Construct a new screen image of size @p lines by @p columns. */
     Screen(int lines, int columns);
     ~Screen();
@@ -461,6 +483,8 @@ public:
     void setScroll(const HistoryType &, bool copyPreviousScroll = true);
     /** Returns the type of storage used to keep lines in the history. */
     const HistoryType &getScroll() const;
+    /** Returns the approximate number of bytes of RAM used by the history buffer. */
+    size_t historyMemoryUsage() const;
     /**
      * Returns true if this screen keeps lines that are scrolled off the screen
      * in a history buffer.
@@ -520,6 +544,81 @@ public:
      */
     QString selectedText(const DecodingOptions options) const;
 
+    /**
+     * Returns the region selectedText() copies: the selection, or in REPL
+     * mode the current input or the last command output.  The region is
+     * invalid if there is nothing to copy.
+     */
+    TextRegion selectedRegion() const;
+
+    /**
+     * Copies of lines as snapshotLines() or appendToSnapshot() found them,
+     * numbered as the owner of the snapshot sees fit.  Passed to
+     * writeRegionToStream(), they are copied instead of the lines now at
+     * their place.
+     */
+    struct LinesSnapshot {
+        int firstLine = 0;
+        std::vector<QVector<Character>> lines;
+        std::vector<LineProperty> properties;
+
+        int lastLine() const
+        {
+            return firstLine + static_cast<int>(lines.size()) - 1;
+        }
+    };
+
+    /**
+     * Copies lines @p fromLine to @p toLine of @p region to a stream, so
+     * large regions can be copied a few lines at a time.  The lines are
+     * numbered as in the region, which must be in the current numbering,
+     * except that lines in @p snapshot are numbered as when it was taken.
+     */
+    void writeRegionToStream(TerminalCharacterDecoder *decoder,
+                             const TextRegion &region,
+                             int fromLine,
+                             int toLine,
+                             const DecodingOptions options,
+                             const LinesSnapshot *snapshot = nullptr) const;
+
+    /**
+     * The number of lines dropped off the top of the history or the screen
+     * since the screen was created.  Subtracting the count at the time a
+     * region was taken renumbers its lines to the current ones.
+     */
+    qint64 totalDroppedLines() const
+    {
+        return _totalDroppedLines;
+    }
+
+    /**
+     * Incremented whenever the lines are reflowed or the history replaced,
+     * after which earlier line numbers mean nothing.
+     */
+    quint32 layoutGeneration() const
+    {
+        return _layoutGeneration;
+    }
+
+    /**
+     * Copies those of the lines @p fromLine to @p toLine which are on the
+     * screen image rather than in the history, as these are redrawn in
+     * place.  firstLine of the snapshot is the first of the lines which
+     * isn't in the history.
+     */
+    LinesSnapshot snapshotLines(int fromLine, int toLine) const;
+
+    /** Appends copies of lines @p fromLine to @p toLine, of the history or the screen image, to @p snapshot. */
+    void appendToSnapshot(LinesSnapshot &snapshot, int fromLine, int toLine) const;
+
+    /**
+     * Registers an export reading from the screen.  It is given the chance
+     * to copy lines it still has to read before they are dropped or
+     * renumbered, and is finished when the screen is destroyed.
+     */
+    void addExport(SelectionExport *selection);
+    void removeExport(SelectionExport *selection);
+
     /**
      * Convenience method.  Returns the text between two indices.
      * @param startIndex Specifies the starting text index
@@ -602,6 +701,21 @@ public:
         return _replModeEnd;
     }
 
+    /**
+     * Returns the prompts and commands marked by the shell, in the lines of
+     * the history and the screen.
+     */
+    const SemanticBlockIndex &semanticBlocks() const;
+
+    /**
+     * Returns the output of the most recent command which had one, or an
+     * empty string.
+     * @param options See Screen::DecodingOptions
+     */
+    QString lastCommandOutput(const DecodingOptions options) const;
+    /** The region lastCommandOutput() copies. */
+    TextRegion lastCommandOutputRegion() const;
+
     /**
      * Returns the number of lines that the image has been scrolled up or down by,
      * since the last call to resetScrolledLines().
@@ -654,19 +768,8 @@ public:
 
     TerminalDisplay *currentTerminalDisplay();
 
-    QSet<uint> usedExtendedChars() const
-    {
-        QSet<uint> result;
-        for (int i = 0; i < _lines; ++i) {
-            const ImageLine &il = _screenLines[i];
-            for (int j = 0; j < il.length(); ++j) {
-                if (il[j].rendition.f.extended) {
-                    result << il[j].character;
-                }
-            }
-        }
-        return result;
-    }
+    /** Adds the extended char keys used on the screen and in the history to @p keys. */
+    void collectExtendedChars(QSet<uint> &keys) const;
 
     void setEnableUrlExtractor(const bool enable);
 
@@ -681,7 +784,7 @@ public:
     void setReflowLines(bool enable);
 
     /* Graphics display functions */
-    void addPlacement(QPixmap pixmap,
+    void addPlacement(const GraphicsImage &image,
                       int &rows,
                       int &cols,
                       int row = -1,
@@ -697,6 +800,12 @@ public:
                       int X = 0,
                       int Y = 0);
     TerminalGraphicsPlacement_t *getGraphicsPlacement(unsigned int i);
+    /**
+     * Collects the placements which may cover any of the rows @p firstRow
+     * to @p lastRow (negative rows are in the history) into @p placements,
+     * in painting order.
+     */
+    void graphicsPlacementsInRows(int firstRow, int lastRow, QVector<TerminalGraphicsPlacement_t *> &placements) const;
     void delPlacements(int = 'a', qint64 = 0, qint64 = -1, int = 0, int = 0, int = 0);
 
     bool hasGraphics() const
@@ -726,7 +835,12 @@ private:
                          TerminalCharacterDecoder *decoder,
                          bool appendNewLine,
                          bool isBlockSelectionMode,
-                         const DecodingOptions options) const;
+                         const DecodingOptions options,
+                         const LinesSnapshot *snapshot = nullptr) const;
+
+    // lets the registered exports copy the lines they still need before
+    // @p droppedLines lines drop off the top, or any line if it is -1
+    void saveLinesForExports(int droppedLines);
 
     // fills a section of the screen image with the character 'c'
     // the parameters are specified as offsets from the start of the screen image.
@@ -747,6 +861,9 @@ private:
     void scrollUp(int from, int n);
     // scroll down 'n' lines in current region, clearing the top 'n' lines
     void scrollDown(int from, int n);
+    // lines from 'from' down are about to move within the screen; unlike
+    // lines scrolled into the history, this renumbers marked prompts
+    void semanticLinesMoving(int from);
 
     // when we handle scroll commands, we need to know which screenwindow will scroll
     // use QPointer to track life time of this object, see crashes in bug 508721
@@ -754,6 +871,8 @@ private:
     QPointer<QWidget> _currentTerminalDisplay;
 
     void addHistLine();
+    // tells the view that lines left the history
+    void removeDisplayLines(int count);
     // add lines from _screen to _history and remove from _screen the added lines (used to resize lines and columns)
     void fastAddHistLine();
 
@@ -766,6 +885,9 @@ private:
     // copies text from 'startIndex' to 'endIndex' to a stream
     // startIndex and endIndex are positions generated using the loc(x,y) macro
     void writeToStream(TerminalCharacterDecoder *decoder, int startIndex, int endIndex, const DecodingOptions options) const;
+    // the region from 'startIndex' to 'endIndex' in the current selection mode
+    TextRegion regionBetween(int startIndex, int endIndex) const;
+    QString regionText(const TextRegion &region, const DecodingOptions options) const;
     // copies 'count' lines from the screen buffer into 'dest',
     // starting from 'startLine', where 0 is the first line in the screen buffer
     void copyFromScreen(Character *dest, int startLine, int count) const;
@@ -809,6 +931,8 @@ private:
 
     int _droppedLines;
     int _fastDroppedLines;
+    // lines removed from the history while parsing on a worker thread
+    int _deferredRemovedLines = 0;
 
     int _oldTotalLines;
     bool _isResize;
@@ -850,9 +974,15 @@ private:
     bool _replHadOutput;
     std::pair<int, int> _replModeStart;
     std::pair<int, int> _replModeEnd;
-    std::pair<int, int> _replLastOutputStart;
-    std::pair<int, int> _replLastOutputEnd;
     int commandCounter = 0;
+    // Kept up to date as the shell marks prompts and lines drop off the
+    // history or are reflowed; the lines moved around on the screen are
+    // searched again on the next query.
+    mutable SemanticBlockIndex _semanticBlocks;
+    // See totalDroppedLines() and layoutGeneration()
+    qint64 _totalDroppedLines = 0;
+    quint32 _layoutGeneration = 0;
+    std::vector<SelectionExport *> _exports;
 
     // ----------------------------
 
@@ -906,6 +1036,13 @@ private:
     void addPlacement(std::unique_ptr<TerminalGraphicsPlacement_t> &u);
     std::vector<std::unique_ptr<TerminalGraphicsPlacement_t>> _graphicsPlacements;
     void scrollPlacements(int n, qint64 below = INT64_MAX, qint64 above = INT64_MAX);
+    // Placements by bands of PlacementBandRows rows, so painting looks at
+    // those near the visible rows only.  Rebuilt on the next query after
+    // placements were added, removed or moved.
+    void rebuildPlacementIndex() const;
+    static constexpr int PlacementBandRows = 32;
+    mutable QHash<int, QVector<int>> _placementBands;
+    mutable bool _placementIndexDirty = true;
     bool _hasGraphics;
 
     //
@@ -24,10 +24,15 @@ ScreenWindow::ScreenWindow(Screen *screen, QObject *parent)
     , _scrollCount(0)
 {
     setScreen(screen);
+
+    ExtendedCharTable::instance.addKeySource(this, [this](QSet<uint> &keys) {
+        Character::collectExtendedChars(_windowBuffer, _windowBufferSize, keys);
+    });
 }
 
 ScreenWindow::~ScreenWindow()
 {
+    ExtendedCharTable::instance.removeKeySource(this);
     delete[] _windowBuffer;
 }
 
@@ -238,27 +243,23 @@ void ScreenWindow::scrollBy(RelativeScrollMode mode, int amount, bool fullPage)
             scrollTo(currentLine() + amount * (windowLines() / 2));
         }
     } else if (mode == ScrollPrompts) {
+        const SemanticBlockIndex &blocks = _screen->semanticBlocks();
         int i = currentLine();
-        if (amount < 0) {
-            QVector<LineProperty> properties = _screen->getLineProperties(0, currentLine());
-            while (i > 0 && amount < 0) {
-                i--;
-                if ((properties[i].flags.f.prompt_start) != 0) {
-                    if (++amount == 0) {
-                        break;
-                    }
-                }
+        for (; amount < 0; ++amount) {
+            const int prompt = blocks.previousPrompt(i);
+            if (prompt < 0) {
+                i = 0;
+                break;
             }
-        } else if (amount > 0) {
-            QVector<LineProperty> properties = _screen->getLineProperties(currentLine(), _screen->getHistLines());
-            while (i < _screen->getHistLines() && amount > 0) {
-                i++;
-                if ((properties[i - currentLine()].flags.f.prompt_start) != 0) {
-                    if (--amount == 0) {
-                        break;
-                    }
-                }
+            i = prompt;
+        }
+        for (; amount > 0; --amount) {
+            const int prompt = blocks.nextPrompt(i);
+            if (prompt < 0 || prompt > _screen->getHistLines()) {
+                i = _screen->getHistLines();
+                break;
             }
+            i = prompt;
         }
         scrollTo(i);
     }
@@ -349,7 +350,28 @@ void ScreenWindow::notifyOutputChanged()
 
     _bufferNeedsUpdate = true;
 
+    if (_updatesSuspended) {
+        _outputChangedPending = true;
+        return;
+    }
+
     Q_EMIT outputChanged();
 }
 
+void ScreenWindow::setUpdatesSuspended(bool suspended)
+{
+    if (_updatesSuspended == suspended) {
+        return;
+    }
+    _updatesSuspended = suspended;
+
+    if (!suspended && _outputChangedPending) {
+        _outputChangedPending = false;
+        // the view was not updated while hidden, so the accumulated scroll
+        // count is meaningless; let it redraw from the current image instead
+        _scrollCount = 0;
+        Q_EMIT outputChanged();
+    }
+}
+
 #include "moc_ScreenWindow.cpp"
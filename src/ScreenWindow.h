@@ -225,6 +225,18 @@ public:
 
     void updateCurrentLine();
 
+    /**
+     * Suspends the outputChanged() signal while the view showing this window
+     * is hidden.  The window keeps following the output, and if the screen
+     * changed while suspended a single outputChanged() is emitted when
+     * updates are resumed, so the view catches up with one render.
+     */
+    void setUpdatesSuspended(bool suspended);
+    bool updatesSuspended() const
+    {
+        return _updatesSuspended;
+    }
+
 public Q_SLOTS:
     /**
      * Notifies the window that the contents of the associated terminal screen have changed.
@@ -273,6 +285,8 @@ private:
     bool _trackOutput; // see setTrackOutput() , trackOutput()
     int _scrollCount; // count of lines which the window has been scrolled by since
     // the last call to resetScrollCount()
+    bool _updatesSuspended = false; // see setUpdatesSuspended()
+    bool _outputChangedPending = false;
 };
 }
 #endif // SCREENWINDOW_H
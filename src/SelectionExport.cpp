@@ -0,0 +1,416 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SelectionExport.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QTextStream>
+
+// std
+#include <algorithm>
+
+// Konsole
+#include "ScreenWindow.h"
+#include "colorscheme/ColorScheme.h"
+#include "konsoledebug.h"
+#include "session/EmulationScheduler.h"
+
+#include <HTMLDecoder.h>
+#include <PlainTextDecoder.h>
+
+using namespace Konsole;
+
+namespace
+{
+// Lines copied between looks at the clock
+constexpr int LinesPerCheck = 64;
+// Bytes a buffering device may hold before the export waits for it
+constexpr qint64 MaxPendingBytes = 4 * 1024 * 1024;
+}
+
+SelectionExport::SelectionExport(ScreenWindow *window, Screen::DecodingOptions options, QObject *parent)
+    : QObject(parent)
+    , _options(options & ~Screen::ConvertToHtml)
+{
+    _sliceTimer.setSingleShot(true);
+    connect(&_sliceTimer, &QTimer::timeout, this, &SelectionExport::copySlice);
+
+    if (window != nullptr && window->screen() != nullptr) {
+        _screen = window->screen();
+        _region = _screen->selectedRegion();
+        _droppedAtStart = _screen->totalDroppedLines();
+        _generation = _screen->layoutGeneration();
+        _nextLine = _region.top;
+        if (_region.isValid()) {
+            _snapshot = _screen->snapshotLines(_region.top, _region.bottom);
+            _screen->addExport(this);
+        }
+    }
+
+    ExtendedCharTable::instance.addKeySource(this, [this](QSet<uint> &keys) {
+        for (const Screen::LinesSnapshot *snapshot : {&_snapshot, &_saved}) {
+            for (const QVector<Character> &line : snapshot->lines) {
+                Character::collectExtendedChars(line.constData(), line.size(), keys);
+            }
+        }
+    });
+}
+
+SelectionExport::~SelectionExport()
+{
+    ExtendedCharTable::instance.removeKeySource(this);
+    if (_screen != nullptr) {
+        _screen->removeExport(this);
+    }
+    // Leave the outputs with well formed documents
+    if (!_finished) {
+        closeOutputs();
+    }
+}
+
+int SelectionExport::lineCount() const
+{
+    return _region.isValid() ? _region.bottom - _region.top + 1 : 0;
+}
+
+void SelectionExport::addOutput(QIODevice *device, Format format)
+{
+    Output output;
+    output.device = device;
+    output.stream = std::make_unique<QTextStream>(device);
+    if (format == Html) {
+        output.decoder = std::make_unique<HTMLDecoder>(ColorScheme::defaultTable);
+    } else {
+        output.decoder = std::make_unique<PlainTextDecoder>();
+    }
+    output.decoder->begin(output.stream.get());
+    _outputs.push_back(std::move(output));
+}
+
+void SelectionExport::start()
+{
+    if (_finished || _sliceTimer.isActive()) {
+        return;
+    }
+    _sliceTimer.start(0);
+}
+
+void SelectionExport::finish()
+{
+    while (copyLines(LinesPerCheck)) { }
+}
+
+void SelectionExport::cancel()
+{
+    if (_finished) {
+        return;
+    }
+    _sliceTimer.stop();
+    _interrupted = true;
+    end(false);
+}
+
+void SelectionExport::screenChanging(int droppedLines)
+{
+    // The lines on the screen image were copied when the export was taken
+    if (_finished || _screen == nullptr || _nextLine >= _snapshot.firstLine) {
+        return;
+    }
+    // Lines the history had no room for are copied here, the screen may be
+    // parsing on a worker thread; the outputs are written to by the slices
+    if (!_saved.lines.empty() && _nextLine > _saved.lastLine()) {
+        _saved = Screen::LinesSnapshot();
+    }
+    const int dropped = shift();
+    const int from = _saved.lines.empty() ? std::max(_nextLine, dropped) : _saved.lastLine() + 1;
+    const int to = droppedLines < 0 ? _snapshot.firstLine - 1 : std::min(dropped + droppedLines, _snapshot.firstLine) - 1;
+    if (from > to || _screen->layoutGeneration() != _generation) {
+        return;
+    }
+    if (_saved.lines.empty()) {
+        _saved.firstLine = from;
+    }
+    _screen->appendToSnapshot(_saved, from - dropped, to - dropped);
+}
+
+void SelectionExport::screenDestroyed()
+{
+    // Decoding needs the screen; it is destroyed with its tab, on the GUI thread
+    finish();
+    _screen = nullptr;
+}
+
+void SelectionExport::copySlice()
+{
+    // The screen may have finished the export meanwhile
+    if (_finished) {
+        return;
+    }
+    if (outputsBusy()) {
+        _sliceTimer.start(10);
+        return;
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+    while (copyLines(LinesPerCheck)) {
+        if (slice.elapsed() >= SliceMs || outputsBusy()) {
+            Q_EMIT progress(_linesWritten, lineCount());
+            _sliceTimer.start(0);
+            return;
+        }
+    }
+}
+
+bool SelectionExport::copyLines(int lines)
+{
+    if (_finished) {
+        return false;
+    }
+    if (_screen == nullptr || !_region.isValid()) {
+        end(true);
+        return false;
+    }
+
+    int last;
+    if (sourceOf(_nextLine, &last) == nullptr) {
+        // Lines of the history move up as those above drop off, and mean
+        // nothing once the screen was resized or its history replaced
+        if (_screen->layoutGeneration() != _generation) {
+            _interrupted = true;
+            end(false);
+            return false;
+        }
+        const int dropped = shift();
+        if (_nextLine < dropped) {
+            const int lost = std::min(dropped, last + 1) - _nextLine;
+            _linesLost += lost;
+            _nextLine += lost;
+        }
+    }
+    if (_nextLine > _region.bottom) {
+        end(_linesLost == 0);
+        return false;
+    }
+
+    // The history and the copies are read from one at a time
+    sourceOf(_nextLine, &last);
+    const int to = std::min(_nextLine + lines - 1, last);
+
+    bool anyOutput = false;
+    for (Output &output : _outputs) {
+        if (output.device.isNull()) {
+            continue;
+        }
+        anyOutput = true;
+        writeLines(output.decoder.get(), _nextLine, to);
+        output.stream->flush();
+    }
+    if (!anyOutput) {
+        _interrupted = true;
+        end(false);
+        return false;
+    }
+
+    _linesWritten += to - _nextLine + 1;
+    _nextLine = to + 1;
+    if (_nextLine > _region.bottom) {
+        end(_linesLost == 0);
+        return false;
+    }
+    return true;
+}
+
+int SelectionExport::shift() const
+{
+    return static_cast<int>(_screen->totalDroppedLines() - _droppedAtStart);
+}
+
+const Screen::LinesSnapshot *SelectionExport::sourceOf(int line, int *last) const
+{
+    if (line >= _snapshot.firstLine) {
+        *last = _region.bottom;
+        return &_snapshot;
+    }
+    if (!_saved.lines.empty() && line >= _saved.firstLine && line <= _saved.lastLine()) {
+        *last = _saved.lastLine();
+        return &_saved;
+    }
+    *last = !_saved.lines.empty() && line < _saved.firstLine ? _saved.firstLine - 1 : _snapshot.firstLine - 1;
+    return nullptr;
+}
+
+void SelectionExport::writeLines(TerminalCharacterDecoder *decoder, int from, int to) const
+{
+    while (from <= to) {
+        int last;
+        const Screen::LinesSnapshot *source = sourceOf(from, &last);
+        last = std::min(last, to);
+        if (source != nullptr) {
+            _screen->writeRegionToStream(decoder, _region, from, last, _options, source);
+        } else {
+            const int dropped = shift();
+            Screen::TextRegion region = _region;
+            region.top -= dropped;
+            region.bottom -= dropped;
+            _screen->writeRegionToStream(decoder, region, from - dropped, last - dropped, _options);
+        }
+        from = last + 1;
+    }
+}
+
+QString SelectionExport::text(Format format) const
+{
+    if (_screen == nullptr || !_region.isValid()) {
+        return QString();
+    }
+    // Lines of the history which weren't copied are gone once moved
+    for (int line = _region.top; line <= _region.bottom;) {
+        int last;
+        if (sourceOf(line, &last) == nullptr && (_screen->layoutGeneration() != _generation || line < shift())) {
+            return QString();
+        }
+        line = last + 1;
+    }
+
+    QString result;
+    QTextStream stream(&result, QIODevice::ReadWrite);
+
+    HTMLDecoder htmlDecoder(ColorScheme::defaultTable);
+    PlainTextDecoder plainTextDecoder;
+    TerminalCharacterDecoder *decoder = &plainTextDecoder;
+    if (format == Html) {
+        decoder = &htmlDecoder;
+    }
+
+    decoder->begin(&stream);
+    writeLines(decoder, _region.top, _region.bottom);
+    decoder->end();
+
+    return result;
+}
+
+bool SelectionExport::outputsBusy() const
+{
+    for (const Output &output : _outputs) {
+        if (!output.device.isNull() && output.device->bytesToWrite() > MaxPendingBytes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SelectionExport::end(bool complete)
+{
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+    // The screen finishes exports while it is parsed, maybe on a worker;
+    // the timer sees _finished should it fire
+    if (!EmulationScheduler::isParsing()) {
+        _sliceTimer.stop();
+    }
+    closeOutputs();
+
+    if (!complete) {
+        qCDebug(KonsoleDebug) << "Selection export ended after" << _linesWritten << "of" << lineCount() << "lines," << _linesLost << "lost";
+    }
+    EmulationScheduler::runOnGuiThread([self = QPointer<SelectionExport>(this), complete = complete && !_interrupted]() {
+        if (!self.isNull()) {
+            Q_EMIT self->progress(self->_linesWritten, self->lineCount());
+            Q_EMIT self->finished(complete);
+        }
+    });
+}
+
+void SelectionExport::closeOutputs()
+{
+    for (Output &output : _outputs) {
+        if (!output.device.isNull()) {
+            output.decoder->end();
+            output.stream->flush();
+        }
+    }
+}
+
+SelectionMimeData::SelectionMimeData(SelectionExport *selection, bool withHtml)
+    : _selection(selection)
+    , _textBuffer(&_text)
+    , _htmlBuffer(&_html)
+    , _withHtml(withHtml)
+{
+    selection->setParent(this);
+    connect(selection, &SelectionExport::finished, this, &SelectionMimeData::exportFinished);
+
+    _textBuffer.open(QIODevice::WriteOnly);
+    selection->addOutput(&_textBuffer, SelectionExport::PlainText);
+    if (_withHtml) {
+        _htmlBuffer.open(QIODevice::WriteOnly);
+        selection->addOutput(&_htmlBuffer, SelectionExport::Html);
+    }
+    selection->start();
+}
+
+SelectionMimeData::~SelectionMimeData()
+{
+    // The export writes to the buffers until it is gone
+    delete _selection;
+}
+
+QStringList SelectionMimeData::formats() const
+{
+    QStringList formats{QStringLiteral("text/plain"), QStringLiteral("text/plain;charset=utf-8")};
+    if (_withHtml) {
+        formats.append(QStringLiteral("text/html"));
+    }
+    return formats;
+}
+
+bool SelectionMimeData::hasFormat(const QString &mimeType) const
+{
+    return formats().contains(mimeType);
+}
+
+QVariant SelectionMimeData::retrieveData(const QString &mimeType, QMetaType type) const
+{
+    if (!hasFormat(mimeType)) {
+        return QVariant();
+    }
+
+    // Somebody pastes: whatever is still missing is wanted now
+    if (!_selection.isNull()) {
+        _selection->finish();
+    }
+
+    const QByteArray &data = mimeType == QLatin1String("text/html") ? _html : _text;
+    if (type.id() == QMetaType::QString) {
+        return QString::fromUtf8(data);
+    }
+    return data;
+}
+
+void SelectionMimeData::exportFinished(bool complete)
+{
+    if (complete || _selection.isNull()) {
+        return;
+    }
+
+    const QString text = _selection->text(SelectionExport::PlainText);
+    if (text.isNull()) {
+        qCWarning(KonsoleDebug) << "Lines of the copied selection were gone before they could be copied";
+        return;
+    }
+    _text = text.toUtf8();
+    if (_withHtml) {
+        _html = _selection->text(SelectionExport::Html).toUtf8();
+    }
+}
+
+#include "moc_SelectionExport.cpp"
@@ -0,0 +1,213 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SELECTIONEXPORT_H
+#define SELECTIONEXPORT_H
+
+// Qt
+#include <QBuffer>
+#include <QByteArray>
+#include <QMimeData>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+// std
+#include <memory>
+#include <vector>
+
+// Konsole
+#include "Screen.h"
+#include "konsoleprivate_export.h"
+
+class QIODevice;
+class QTextStream;
+
+namespace Konsole
+{
+class ScreenWindow;
+class TerminalCharacterDecoder;
+
+/**
+ * Copies the selection of a screen to one or more devices, a slice of
+ * lines at a time.
+ *
+ * Screen::selectedText() decodes the whole selection into one string in
+ * one go, which freezes the window for a selection of hundreds of
+ * thousands of lines and holds the text twice while it is handed on.  An
+ * export takes the selected region when it is created and, once started,
+ * decodes it in slices of a few milliseconds from the event loop, writing
+ * each slice to its outputs as UTF-8.  The screen is only safe to read from
+ * the GUI thread, so the slices run there in between other events.
+ *
+ * The lines on the screen image, which are redrawn in place, are copied
+ * when the export is created.  Output arriving meanwhile may push lines
+ * off the top of the history; the export follows the renumbering, and the
+ * screen has it copy the lines it still needs before they are dropped, or
+ * before the screen is resized or its history is replaced.  The copying
+ * to the outputs is left to the event loop all the same, so a screen
+ * parsing output, maybe on a worker thread, never writes to them.  Should
+ * lines be missing, they are counted in linesLost().
+ */
+class KONSOLEPRIVATE_EXPORT SelectionExport : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        PlainText,
+        Html,
+    };
+
+    /**
+     * Takes the selected region of the screen shown by @p window.
+     * @param options See Screen::DecodingOptions; ConvertToHtml is ignored
+     *        in favour of the format of each output
+     */
+    SelectionExport(ScreenWindow *window, Screen::DecodingOptions options, QObject *parent = nullptr);
+    ~SelectionExport() override;
+
+    /** True if there was nothing to copy. */
+    bool isEmpty() const
+    {
+        return !_region.isValid();
+    }
+
+    /** The number of lines in the selected region. */
+    int lineCount() const;
+
+    int linesWritten() const
+    {
+        return _linesWritten;
+    }
+
+    int linesLost() const
+    {
+        return _linesLost;
+    }
+
+    /**
+     * Adds an output.  @p device must be open for writing and outlive the
+     * export; devices which buffer writes, like QProcess, are given time to
+     * drain before more is written.
+     */
+    void addOutput(QIODevice *device, Format format);
+
+    /** Starts copying from the event loop. */
+    void start();
+    /** Copies whatever is left right away. */
+    void finish();
+    /** Stops copying; finished() reports the export as incomplete. */
+    void cancel();
+
+    bool isFinished() const
+    {
+        return _finished;
+    }
+
+    /**
+     * The whole selection copied in one go, or a null string if lines of it
+     * are gone by now.  For when the export ended early.
+     */
+    QString text(Format format) const;
+
+    /**
+     * Called by the screen before @p droppedLines lines drop off the top of
+     * its history, or before all lines are renumbered if it is -1.  Those
+     * of them the export still needs are copied.
+     */
+    void screenChanging(int droppedLines);
+    /** Called by the screen when it is destroyed, after finishing the export. */
+    void screenDestroyed();
+
+    /** Milliseconds spent copying before the event loop gets a turn. */
+    static constexpr int SliceMs = 8;
+    /** Selections of more lines are worth copying in the background. */
+    static constexpr int BackgroundLines = 5000;
+
+Q_SIGNALS:
+    void progress(int linesWritten, int lineCount);
+    /** All outputs were written; @p complete is false if lines are missing. */
+    void finished(bool complete);
+
+private:
+    struct Output {
+        QPointer<QIODevice> device;
+        std::unique_ptr<QTextStream> stream;
+        std::unique_ptr<TerminalCharacterDecoder> decoder;
+    };
+
+    void copySlice();
+    // Copies up to @p lines lines, false once there are none left
+    bool copyLines(int lines);
+    // Lines dropped off the top of the screen since the export was taken
+    int shift() const;
+    // The copy holding @p line, or nullptr if it is read from the history;
+    // @p last is set to the last line read from the same place
+    const Screen::LinesSnapshot *sourceOf(int line, int *last) const;
+    // Writes lines @p from to @p to, numbered as when the export was taken
+    void writeLines(TerminalCharacterDecoder *decoder, int from, int to) const;
+    bool outputsBusy() const;
+    void end(bool complete);
+    void closeOutputs();
+
+    Screen *_screen = nullptr;
+    Screen::TextRegion _region;
+    // The lines of the region on the screen image, not in the history
+    Screen::LinesSnapshot _snapshot;
+    // Lines of the history not written yet which were about to go away
+    Screen::LinesSnapshot _saved;
+    Screen::DecodingOptions _options;
+    qint64 _droppedAtStart = 0;
+    quint32 _generation = 0;
+
+    std::vector<Output> _outputs;
+    int _nextLine = 0;
+    int _linesWritten = 0;
+    int _linesLost = 0;
+    bool _interrupted = false;
+    bool _finished = false;
+    QTimer _sliceTimer;
+};
+
+/**
+ * Clipboard contents served from a SelectionExport.
+ *
+ * Only the encoded text is kept; it is converted for the application
+ * pasting it when it asks, and handed over as is to those asking for
+ * UTF-8.  A paste arriving before the export is done finishes it first.
+ * Should the export end early, the selection is copied again in one go
+ * rather than leaving part of it on the clipboard.
+ */
+class KONSOLEPRIVATE_EXPORT SelectionMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    /** Starts @p selection, which must be empty of outputs, and takes ownership of it. */
+    SelectionMimeData(SelectionExport *selection, bool withHtml);
+    ~SelectionMimeData() override;
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QMetaType type) const override;
+
+private:
+    void exportFinished(bool complete);
+
+    QPointer<SelectionExport> _selection;
+    QByteArray _text;
+    QByteArray _html;
+    QBuffer _textBuffer;
+    QBuffer _htmlBuffer;
+    bool _withHtml;
+};
+
+}
+
+#endif // SELECTIONEXPORT_H
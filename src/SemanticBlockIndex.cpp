@@ -0,0 +1,326 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SemanticBlockIndex.h"
+
+// Qt
+#include <QDateTime>
+
+// std
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+using namespace Konsole;
+
+namespace
+{
+qint64 now()
+{
+    return QDateTime::currentMSecSinceEpoch();
+}
+}
+
+SemanticBlockIndex::Entry *SemanticBlockIndex::openEntry()
+{
+    if (_blocks.empty() || _blocks.back().endLine >= 0) {
+        return nullptr;
+    }
+    return &_blocks.back();
+}
+
+qint64 SemanticBlockIndex::endOf(size_t index) const
+{
+    const Entry &entry = _blocks[index];
+    if (entry.endLine >= 0) {
+        return entry.endLine;
+    }
+    if (index + 1 < _blocks.size()) {
+        return _blocks[index + 1].promptLine;
+    }
+    return std::numeric_limits<qint64>::max();
+}
+
+int SemanticBlockIndex::toLine(qint64 absolute) const
+{
+    if (absolute < 0) {
+        return -1;
+    }
+    // Lines which dropped off the history are clamped to the oldest one left
+    return int(std::max<qint64>(0, absolute - _base));
+}
+
+void SemanticBlockIndex::markPrompt(int line)
+{
+    const qint64 absolute = _base + line;
+    if (!_blocks.empty()) {
+        Entry &last = _blocks.back();
+        if (absolute == last.promptLine) {
+            // The shell redrew its prompt
+            return;
+        }
+        if (absolute < last.promptLine) {
+            // The prompt went back above the last one, e.g. after clearing
+            // the screen: let the line properties tell what is left
+            invalidateFrom(line);
+            return;
+        }
+        if (last.endLine < 0 || last.endLine > absolute) {
+            last.endLine = absolute;
+        }
+    }
+    Entry entry;
+    entry.promptLine = absolute;
+    entry.promptTime = now();
+    _blocks.push_back(entry);
+}
+
+void SemanticBlockIndex::markInput(int line, quint16 counter)
+{
+    Entry *entry = openEntry();
+    if (entry == nullptr || entry->inputLine >= 0) {
+        // A command line without prompt
+        markPrompt(line);
+        entry = openEntry();
+        if (entry == nullptr) {
+            return;
+        }
+    }
+    entry->inputLine = _base + line;
+    entry->counter = counter;
+}
+
+void SemanticBlockIndex::markOutput(int line)
+{
+    Entry *entry = openEntry();
+    if (entry == nullptr || entry->outputLine >= 0) {
+        markPrompt(line);
+        entry = openEntry();
+        if (entry == nullptr) {
+            return;
+        }
+    }
+    entry->outputLine = _base + line;
+    entry->commandTime = now();
+}
+
+void SemanticBlockIndex::markFinished(int endLine)
+{
+    Entry *entry = openEntry();
+    if (entry == nullptr) {
+        return;
+    }
+    entry->endLine = std::max(_base + endLine, std::max({entry->promptLine, entry->inputLine, entry->outputLine}) + 1);
+    entry->finishTime = now();
+}
+
+void SemanticBlockIndex::setExitCode(int exitCode)
+{
+    if (!_blocks.empty()) {
+        _blocks.back().exitCode = exitCode;
+    }
+}
+
+void SemanticBlockIndex::linesDropped(int count)
+{
+    _base += count;
+    while (!_blocks.empty() && endOf(0) <= _base) {
+        _blocks.pop_front();
+    }
+}
+
+void SemanticBlockIndex::remap(const std::function<int(int line)> &newLine)
+{
+    // Lines which dropped off already, and unmarked ones, stay as they are
+    auto move = [this, &newLine](qint64 &absolute) {
+        if (absolute >= _base) {
+            absolute = _base + newLine(int(absolute - _base));
+        }
+    };
+    for (Entry &entry : _blocks) {
+        move(entry.promptLine);
+        move(entry.inputLine);
+        move(entry.outputLine);
+        move(entry.endLine);
+    }
+    if (!isValid()) {
+        move(_dirtyFrom);
+    }
+}
+
+void SemanticBlockIndex::invalidateFrom(int line)
+{
+    _dirtyFrom = std::min(_dirtyFrom, _base + std::max(line, 0));
+}
+
+int SemanticBlockIndex::dirtyLine() const
+{
+    return int(std::clamp<qint64>(_dirtyFrom - _base, 0, std::numeric_limits<int>::max()));
+}
+
+void SemanticBlockIndex::rebuild(int lineCount, const LinePropertyFunction &lineProperty, int endLine, int fromLine)
+{
+    // The blocks before the lines searched are kept, the last of them
+    // continues into them unless it ended before
+    const qint64 from = fromLine > 0 ? _base + fromLine : std::numeric_limits<qint64>::min();
+    auto firstFound = std::lower_bound(_blocks.begin(), _blocks.end(), from, [](const Entry &entry, qint64 value) {
+        return entry.promptLine < value;
+    });
+    std::deque<Entry> old(std::make_move_iterator(firstFound), std::make_move_iterator(_blocks.end()));
+    _blocks.erase(firstFound, _blocks.end());
+    const size_t kept = _blocks.size();
+
+    auto startBlock = [this](qint64 line) {
+        if (!_blocks.empty() && _blocks.back().endLine < 0) {
+            _blocks.back().endLine = line;
+        }
+        Entry entry;
+        entry.promptLine = line;
+        _blocks.push_back(entry);
+        return &_blocks.back();
+    };
+
+    Entry *entry = nullptr;
+    if (!_blocks.empty()) {
+        entry = &_blocks.back();
+        for (qint64 *mark : {&entry->inputLine, &entry->outputLine, &entry->endLine}) {
+            if (*mark >= from) {
+                *mark = -1;
+            }
+        }
+        if (entry->endLine >= 0) {
+            entry = nullptr;
+        }
+    }
+    for (int line = std::max(fromLine, 0); line < lineCount; ++line) {
+        const LineProperty property = lineProperty(line);
+        if (property.getStarts() == 0) {
+            continue;
+        }
+        const qint64 absolute = _base + line;
+        if (property.flags.f.prompt_start) {
+            entry = startBlock(absolute);
+        }
+        if (property.flags.f.input_start) {
+            if (entry == nullptr || entry->inputLine >= 0) {
+                entry = startBlock(absolute);
+            }
+            entry->inputLine = absolute;
+            entry->counter = property.counter;
+        }
+        if (property.flags.f.output_start) {
+            if (entry == nullptr || entry->outputLine >= 0) {
+                entry = startBlock(absolute);
+            }
+            entry->outputLine = absolute;
+        }
+    }
+    if (entry != nullptr && endLine >= 0) {
+        entry->endLine = std::max<qint64>(_base + endLine, std::max({entry->promptLine, entry->inputLine, entry->outputLine}) + 1);
+    }
+
+    // Blocks keep their order, so a single pass over the old ones finds
+    // those which are still there by their command counter
+    auto match = old.cbegin();
+    for (auto rebuilt = _blocks.begin() + kept; rebuilt != _blocks.end(); ++rebuilt) {
+        if (rebuilt->inputLine < 0) {
+            continue;
+        }
+        auto found = std::find_if(match, old.cend(), [&rebuilt](const Entry &e) {
+            return e.inputLine >= 0 && e.counter == rebuilt->counter;
+        });
+        if (found == old.cend()) {
+            continue;
+        }
+        rebuilt->exitCode = found->exitCode;
+        rebuilt->promptTime = found->promptTime;
+        rebuilt->commandTime = found->commandTime;
+        rebuilt->finishTime = found->finishTime;
+        match = found + 1;
+    }
+    // The prompt waiting for a command has no counter yet
+    if (_blocks.size() > kept && !old.empty() && _blocks.back().inputLine < 0 && old.back().inputLine < 0) {
+        _blocks.back().promptTime = old.back().promptTime;
+    }
+
+    _dirtyFrom = std::numeric_limits<qint64>::max();
+}
+
+void SemanticBlockIndex::clear()
+{
+    _blocks.clear();
+    _base = 0;
+    _dirtyFrom = std::numeric_limits<qint64>::max();
+}
+
+SemanticBlockIndex::Block SemanticBlockIndex::block(int index) const
+{
+    const Entry &entry = _blocks[index];
+    Block block;
+    block.promptLine = toLine(entry.promptLine);
+    block.inputLine = toLine(entry.inputLine);
+    block.outputLine = toLine(entry.outputLine);
+    block.endLine = toLine(entry.endLine);
+    block.counter = entry.counter;
+    block.exitCode = entry.exitCode;
+    block.promptTime = entry.promptTime;
+    block.commandTime = entry.commandTime;
+    block.finishTime = entry.finishTime;
+    return block;
+}
+
+int SemanticBlockIndex::previousPrompt(int line) const
+{
+    const qint64 absolute = _base + line;
+    auto it = std::lower_bound(_blocks.cbegin(), _blocks.cend(), absolute, [](const Entry &entry, qint64 value) {
+        return entry.promptLine < value;
+    });
+    if (it == _blocks.cbegin()) {
+        return -1;
+    }
+    --it;
+    // Its prompt dropped off the history
+    if (it->promptLine < _base) {
+        return -1;
+    }
+    return int(it->promptLine - _base);
+}
+
+int SemanticBlockIndex::nextPrompt(int line) const
+{
+    const qint64 absolute = _base + line;
+    auto it = std::upper_bound(_blocks.cbegin(), _blocks.cend(), absolute, [](qint64 value, const Entry &entry) {
+        return value < entry.promptLine;
+    });
+    if (it == _blocks.cend()) {
+        return -1;
+    }
+    return int(it->promptLine - _base);
+}
+
+int SemanticBlockIndex::blockAt(int line) const
+{
+    const qint64 absolute = _base + line;
+    auto it = std::upper_bound(_blocks.cbegin(), _blocks.cend(), absolute, [](qint64 value, const Entry &entry) {
+        return value < entry.promptLine;
+    });
+    if (it == _blocks.cbegin()) {
+        return -1;
+    }
+    const size_t index = std::distance(_blocks.cbegin(), it) - 1;
+    return absolute < endOf(index) ? int(index) : -1;
+}
+
+int SemanticBlockIndex::lastOutputBlock() const
+{
+    for (int index = count() - 1; index >= 0; --index) {
+        if (_blocks[index].outputLine >= 0) {
+            return index;
+        }
+    }
+    return -1;
+}
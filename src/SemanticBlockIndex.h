@@ -0,0 +1,159 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SEMANTICBLOCKINDEX_H
+#define SEMANTICBLOCKINDEX_H
+
+// Konsole
+#include "../characters/Character.h"
+#include "konsoleprivate_export.h"
+
+// Qt
+#include <QtGlobal>
+
+// std
+#include <deque>
+#include <functional>
+#include <limits>
+
+namespace Konsole
+{
+/**
+ * Where the prompts, commands and outputs are in a screen with its history.
+ *
+ * Shells with semantic shell integration (OSC 133) mark the start of each
+ * prompt, command line and command output.  The index records these marks
+ * as they arrive, as one block per command, so finding the previous or next
+ * prompt or the output of a command is a binary search instead of a scan of
+ * the line properties of the whole history.
+ *
+ * Lines are numbered like Screen does: 0 is the oldest line of the history.
+ * When lines drop off the top of the history, linesDropped() shifts the
+ * index without touching the blocks, and when the history is reflowed,
+ * remap() moves them to their new lines.  Changes which move lines around
+ * on the screen, like clearing it, invalidateFrom() the first line moved,
+ * and the blocks from there on are found again in the line properties the
+ * next time the index is queried.  Only replacing the history invalidate()s
+ * the whole index.
+ */
+class KONSOLEPRIVATE_EXPORT SemanticBlockIndex
+{
+public:
+    /**
+     * One prompt with its command.  Line numbers are -1 where the shell didn't
+     * mark the part (yet); times are milliseconds since the epoch, 0 if
+     * unknown.
+     */
+    struct Block {
+        int promptLine = -1;
+        int inputLine = -1;
+        int outputLine = -1;
+        /** One past the last line of the block; -1 while it is the last one and not finished. */
+        int endLine = -1;
+        /** LineProperty::counter of the command line */
+        quint16 counter = 0;
+        /** As reported by the shell; -1 if unknown */
+        int exitCode = -1;
+        qint64 promptTime = 0;
+        qint64 commandTime = 0;
+        qint64 finishTime = 0;
+    };
+
+    /** Returns the properties of @p line, for rebuild(). */
+    using LinePropertyFunction = std::function<LineProperty(int line)>;
+
+    SemanticBlockIndex() = default;
+
+    /** Starts a block at @p line, which ends the previous one. */
+    void markPrompt(int line);
+    /** Marks the start of the command line of the last block. */
+    void markInput(int line, quint16 counter);
+    /** Marks the start of the output of the last block. */
+    void markOutput(int line);
+    /** Ends the last block just before @p endLine. */
+    void markFinished(int endLine);
+    /** Sets the exit code of the last block. */
+    void setExitCode(int exitCode);
+
+    /** Shifts the index after the oldest @p count lines were removed. */
+    void linesDropped(int count);
+
+    /** Moves every line of the index to @p newLine(line), which must keep their order. */
+    void remap(const std::function<int(int line)> &newLine);
+
+    /** The blocks from @p line on have to be found again. */
+    void invalidateFrom(int line);
+
+    void invalidate()
+    {
+        _dirtyFrom = std::numeric_limits<qint64>::min();
+    }
+
+    bool isValid() const
+    {
+        return _dirtyFrom == std::numeric_limits<qint64>::max();
+    }
+
+    /** The first line rebuild() has to look at. */
+    int dirtyLine() const;
+
+    /**
+     * Recreates the index from the line properties of @p lineCount lines,
+     * or only those from @p fromLine on.  Times and exit codes of blocks
+     * found again are kept.  The last block ends at @p endLine, or is open
+     * if that is -1.
+     */
+    void rebuild(int lineCount, const LinePropertyFunction &lineProperty, int endLine, int fromLine = 0);
+
+    void clear();
+
+    int count() const
+    {
+        return int(_blocks.size());
+    }
+
+    /** The @p index-th block, the oldest first, in Screen line numbers. */
+    Block block(int index) const;
+
+    /** Line of the last prompt before @p line, or -1. */
+    int previousPrompt(int line) const;
+    /** Line of the first prompt after @p line, or -1. */
+    int nextPrompt(int line) const;
+
+    /** Index of the block containing @p line, or -1. */
+    int blockAt(int line) const;
+
+    /** Index of the most recent block with output, or -1. */
+    int lastOutputBlock() const;
+
+private:
+    // As Block, but in absolute lines which don't change when lines drop
+    struct Entry {
+        qint64 promptLine;
+        qint64 inputLine = -1;
+        qint64 outputLine = -1;
+        qint64 endLine = -1;
+        quint16 counter = 0;
+        int exitCode = -1;
+        qint64 promptTime = 0;
+        qint64 commandTime = 0;
+        qint64 finishTime = 0;
+    };
+
+    Entry *openEntry();
+    qint64 endOf(size_t index) const;
+    int toLine(qint64 absolute) const;
+
+    std::deque<Entry> _blocks;
+    // Absolute number of Screen line 0
+    qint64 _base = 0;
+    // Absolute number of the first line to search again, max if none
+    qint64 _dirtyFrom = std::numeric_limits<qint64>::max();
+};
+
+}
+
+#endif // SEMANTICBLOCKINDEX_H
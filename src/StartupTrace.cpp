@@ -0,0 +1,197 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "StartupTrace.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+std::atomic<bool> StartupTrace::s_enabled{false};
+
+StartupTrace::StartupTrace()
+{
+    _clock.start();
+    _outputPath = qEnvironmentVariable("KONSOLAI_STARTUP_TRACE");
+    if (!_outputPath.isEmpty()) {
+        _events.reserve(512);
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+}
+
+StartupTrace *StartupTrace::instance()
+{
+    // constructed on first use, which is the first Span in main()
+    static StartupTrace trace;
+    return &trace;
+}
+
+void StartupTrace::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+StartupTrace::Span::Span(const char *name, const char *category)
+    : _name(name)
+    , _category(category)
+    , _startNs(isEnabled() ? instance()->now() : -1)
+{
+}
+
+StartupTrace::Span::~Span()
+{
+    if (_startNs >= 0) {
+        StartupTrace *trace = instance();
+        trace->addSpan(_name, _category, _startNs, trace->now());
+    }
+}
+
+void StartupTrace::mark(const char *name, const char *category)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(Event{name, category, now(), -1, reinterpret_cast<quintptr>(QThread::currentThreadId())});
+}
+
+void StartupTrace::addSpan(const char *name, const char *category, qint64 startNs, qint64 endNs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    append(Event{name, category, startNs, endNs - startNs, reinterpret_cast<quintptr>(QThread::currentThreadId())});
+}
+
+void StartupTrace::append(const Event &event)
+{
+    QMutexLocker locker(&_mutex);
+    if (_events.size() >= MaxEvents) {
+        ++_droppedEvents;
+        return;
+    }
+    _events.append(event);
+}
+
+QByteArray StartupTrace::toChromeTraceJson() const
+{
+    QMutexLocker locker(&_mutex);
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    // Chrome trace wants small thread ids; number them in order of appearance
+    QVector<quintptr> threads;
+    for (const Event &event : _events) {
+        int tid = threads.indexOf(event.threadId);
+        if (tid < 0) {
+            tid = threads.size();
+            threads.append(event.threadId);
+        }
+
+        QJsonObject entry;
+        entry[QStringLiteral("name")] = QString::fromUtf8(event.name);
+        entry[QStringLiteral("cat")] = QString::fromUtf8(event.category);
+        entry[QStringLiteral("pid")] = pid;
+        entry[QStringLiteral("tid")] = tid;
+        // Chrome trace timestamps are in microseconds
+        entry[QStringLiteral("ts")] = static_cast<double>(event.startNs) / 1000.0;
+        if (event.durationNs < 0) {
+            entry[QStringLiteral("ph")] = QStringLiteral("i");
+            entry[QStringLiteral("s")] = QStringLiteral("g");
+        } else {
+            entry[QStringLiteral("ph")] = QStringLiteral("X");
+            entry[QStringLiteral("dur")] = static_cast<double>(event.durationNs) / 1000.0;
+        }
+        traceEvents.append(entry);
+    }
+
+    for (int tid = 0; tid < threads.size(); ++tid) {
+        QJsonObject meta;
+        meta[QStringLiteral("name")] = QStringLiteral("thread_name");
+        meta[QStringLiteral("ph")] = QStringLiteral("M");
+        meta[QStringLiteral("pid")] = pid;
+        meta[QStringLiteral("tid")] = tid;
+        meta[QStringLiteral("args")] = QJsonObject{{QStringLiteral("name"), tid == 0 ? QStringLiteral("main") : QStringLiteral("worker %1").arg(tid)}};
+        traceEvents.append(meta);
+    }
+
+    QJsonObject root;
+    root[QStringLiteral("traceEvents")] = traceEvents;
+    root[QStringLiteral("displayTimeUnit")] = QStringLiteral("ms");
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+void StartupTrace::finish()
+{
+    if (!isEnabled() || _outputPath.isEmpty()) {
+        return;
+    }
+
+    QFile file(_outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KonsoleDebug) << "Unable to write startup trace to" << _outputPath << file.errorString();
+        return;
+    }
+    file.write(toChromeTraceJson());
+    qCDebug(KonsoleDebug) << "Startup trace with" << eventCount() << "events written to" << _outputPath;
+    QMutexLocker locker(&_mutex);
+    if (_droppedEvents > 0) {
+        qCWarning(KonsoleDebug) << "Startup trace is full," << _droppedEvents << "events were dropped";
+    }
+}
+
+void StartupTrace::end()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _endRequested = _endHolds > 0;
+        if (_endRequested) {
+            return;
+        }
+    }
+    finish();
+    setEnabled(false);
+}
+
+void StartupTrace::holdEnd()
+{
+    QMutexLocker locker(&_mutex);
+    ++_endHolds;
+}
+
+void StartupTrace::releaseEnd()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_endHolds == 0 || --_endHolds > 0 || !_endRequested) {
+            return;
+        }
+    }
+    end();
+}
+
+int StartupTrace::eventCount() const
+{
+    QMutexLocker locker(&_mutex);
+    return _events.size();
+}
+
+void StartupTrace::clear()
+{
+    QMutexLocker locker(&_mutex);
+    _events.clear();
+    _droppedEvents = 0;
+}
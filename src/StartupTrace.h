@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+// Qt
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// std
+#include <atomic>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Records named, nested spans of work during startup and writes them as a
+ * Chrome trace (load the file in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Tracing is off unless the KONSOLAI_STARTUP_TRACE environment variable names
+ * the file to write.  When off, a Span costs a single relaxed atomic load.
+ *
+ * The trace is written by finish(), which is called once the first terminal
+ * is interactive, and by end() when the deferred work queued on the
+ * IdleTaskScheduler has drained, so both phases end up in the file.  Startup
+ * work going on beyond that, like restoring sessions, holds off end() with
+ * holdEnd() until it is done.  Spans
+ * in code which runs for the whole session, like looking up color schemes,
+ * record nothing after end(), and at most MaxEvents events are kept.
+ *
+ * Span and marker names are not copied and must be string literals.
+ *
+ * Usage:
+ * @code
+ * StartupTrace::Span span("ProfileManager::loadAllProfiles");
+ * @endcode
+ */
+class KONSOLEPRIVATE_EXPORT StartupTrace
+{
+public:
+    /** Returns the process-wide trace. */
+    static StartupTrace *instance();
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /** Enables recording without an output file; used by tests. */
+    void setEnabled(bool enabled);
+
+    /** RAII helper recording one complete span from construction to destruction. */
+    class Span
+    {
+    public:
+        explicit Span(const char *name, const char *category = "startup");
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *_name;
+        const char *_category;
+        qint64 _startNs;
+    };
+
+    /** Records a zero-length marker, e.g. "first-paint". */
+    void mark(const char *name, const char *category = "startup");
+
+    /** Records a complete span measured by the caller. */
+    void addSpan(const char *name, const char *category, qint64 startNs, qint64 endNs);
+
+    /** Nanoseconds since the trace was created (roughly process start). */
+    qint64 now() const
+    {
+        return _clock.nsecsElapsed();
+    }
+
+    /** Serializes everything recorded so far as Chrome trace JSON. */
+    QByteArray toChromeTraceJson() const;
+
+    /** Writes the trace to the file named by KONSOLAI_STARTUP_TRACE, if set. */
+    void finish();
+    /** Writes the trace a last time and stops recording, once nothing holds it off. */
+    void end();
+
+    /** Keeps end() from taking effect until the matching releaseEnd(). */
+    void holdEnd();
+    /** Ends the trace if end() was called while held and this was the last hold. */
+    void releaseEnd();
+
+    int eventCount() const;
+    void clear();
+
+    static constexpr int MaxEvents = 10000;
+
+private:
+    StartupTrace();
+
+    struct Event {
+        const char *name;
+        const char *category;
+        qint64 startNs;
+        qint64 durationNs; // -1 for instant events
+        quintptr threadId;
+    };
+
+    void append(const Event &event);
+
+    static std::atomic<bool> s_enabled;
+
+    QElapsedTimer _clock;
+    mutable QMutex _mutex;
+    QVector<Event> _events;
+    int _droppedEvents = 0;
+    QString _outputPath;
+    int _endHolds = 0;
+    bool _endRequested = false;
+};
+
+}
+
+#endif // STARTUPTRACE_H
@@ -7,6 +7,7 @@
 // Own
 #include "ViewManager.h"
 
+#include "StartupTrace.h"
 #include "claude/ClaudeSession.h"
 #include "config-konsole.h"
 
@@ -1199,6 +1200,9 @@ TerminalDisplay *ViewManager::createTerminalDisplay()
 
 std::shared_ptr<const ColorScheme> ViewManager::colorSchemeForProfile(const Profile::Ptr &profile)
 {
+    // ColorSchemeManager lives in a static library without access to the
+    // trace, so its first (loading) lookup is timed here
+    StartupTrace::Span colorSchemeSpan("ColorSchemeManager::findColorScheme");
     std::shared_ptr<const ColorScheme> colorScheme = ColorSchemeManager::instance()->findColorScheme(profile->colorScheme());
     if (colorScheme == nullptr) {
         colorScheme = ColorSchemeManager::instance()->defaultColorScheme();
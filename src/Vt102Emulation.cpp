@@ -27,6 +27,8 @@
 
 // Konsole
 #include "EscapeSequenceUrlExtractor.h"
+#include "GraphicsImageCache.h"
+#include "session/EmulationScheduler.h"
 #include "session/SessionController.h"
 #include "session/SessionManager.h"
 #include "terminalDisplay/TerminalColor.h"
@@ -593,18 +595,24 @@ void Vt102Emulation::osc_put(const uint cc)
             if ((uint)tokenState == strlen(tokenStateChange)) {
                 tokenState = -2;
                 tokenData.clear();
+                tokenDecoder.reset();
             }
             return;
         }
     } else if (tokenState == -2) {
-        if (tokenBufferPos - tokenPos == 4) {
-            tokenData.append(QByteArray::fromBase64(QString::fromUcs4(&tokenBuffer[tokenPos], 4).toLocal8Bit()));
-            tokenBufferPos -= 4;
+        if (tokenBufferPos - tokenPos == Base64ChunkSize) {
+            decodeTokenData();
             return;
         }
     }
 }
 
+void Vt102Emulation::decodeTokenData()
+{
+    tokenDecoder.decode(tokenBuffer.constData() + tokenPos, tokenBufferPos - tokenPos, tokenData);
+    tokenBufferPos = tokenPos;
+}
+
 void Vt102Emulation::osc_end(const uint cc)
 {
     // This runs two times per link, the first prepares the link to be read,
@@ -618,6 +626,10 @@ void Vt102Emulation::osc_end(const uint cc)
         Q_EMIT toggleUrlExtractionRequest();
     }
 
+    if (tokenState == -2) {
+        // the rest of an iTerm image
+        decodeTokenData();
+    }
     processSessionAttributeRequest(tokenBufferPos, cc);
 }
 
@@ -677,12 +689,12 @@ void Vt102Emulation::apc_put(const uint cc)
                 if ((uint)tokenState == strlen(tokenStateChange)) {
                     tokenState = -2;
                     tokenData.clear();
+                    tokenDecoder.reset();
                 }
             }
         } else if (tokenState == -2) {
-            if (tokenBufferPos - tokenPos == 4) {
-                tokenData.append(QByteArray::fromBase64(QString::fromUcs4(&tokenBuffer[tokenPos], 4).toLocal8Bit()));
-                tokenBufferPos -= 4;
+            if (tokenBufferPos - tokenPos == Base64ChunkSize) {
+                decodeTokenData();
             }
         }
     }
@@ -691,6 +703,10 @@ void Vt102Emulation::apc_put(const uint cc)
 void Vt102Emulation::apc_end()
 {
     if (_sosPmApc == Apc && tokenBuffer[0] == 'G') {
+        if (tokenState == -2) {
+            // the rest of the payload
+            decodeTokenData();
+        }
         // Graphics command
         processGraphicsToken(tokenBufferPos);
         resetTokenizer();
@@ -1092,11 +1108,15 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             }
             break;
         case ResetCursorColor: // 112 clears the cursor color and has no arguments.
-            _currentScreen->currentTerminalDisplay()->terminalColor()->setCursorColor(QColor());
+            EmulationScheduler::runOnGuiThread([this]() {
+                _currentScreen->currentTerminalDisplay()->terminalColor()->setCursorColor(QColor());
+            });
             break;
         default:
             _pendingSessionAttributesUpdates[attribute] = QString();
-            _sessionAttributesUpdateTimer->start(20);
+            EmulationScheduler::runOnGuiThread([this]() {
+                _sessionAttributesUpdateTimer->start(20);
+            });
             break;
         }
 
@@ -1123,7 +1143,9 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
         }
         QColor color = QColor::fromString(QString::fromUcs4(&tokenBuffer[i], j - i));
         if (color.isValid()) {
-            _currentScreen->currentTerminalDisplay()->terminalColor()->setCursorColor(color);
+            EmulationScheduler::runOnGuiThread([this, color]() {
+                _currentScreen->currentTerminalDisplay()->terminalColor()->setCursorColor(color);
+            });
         }
         return;
     }
@@ -1150,8 +1172,9 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             if (i == 1 && value[0] == QLatin1Char('D')) {
                 // Special case - exit code without '='
                 params[QLatin1String("exit_code")] = list.at(1);
-                int exitCode = list.at(1).toInt();
-                if (exitCode) {
+                bool ok = false;
+                int exitCode = list.at(1).toInt(&ok);
+                if (ok) {
                     _currentScreen->setExitCode(exitCode);
                 }
             } else if (eq > 0) {
@@ -1201,19 +1224,21 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             return;
         }
 
-        const auto hasFocus = _currentScreen->currentTerminalDisplay()->hasFocus();
-        KNotification *notification = nullptr;
-        if (params.length() >= 3) {
-            notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"),
-                                                params[1],
-                                                params[2].toHtmlEscaped());
-        } else {
-            notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"), params[1]);
-        }
+        EmulationScheduler::runOnGuiThread([this, params]() {
+            const auto hasFocus = _currentScreen->currentTerminalDisplay()->hasFocus();
+            KNotification *notification = nullptr;
+            if (params.length() >= 3) {
+                notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"),
+                                                    params[1],
+                                                    params[2].toHtmlEscaped());
+            } else {
+                notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"), params[1]);
+            }
 
-        auto action = notification->addDefaultAction(i18n("Show session"));
-        connect(action, &KNotificationAction::activated, this, [this, notification]() {
-            _currentScreen->currentTerminalDisplay()->notificationClicked(notification->xdgActivationToken());
+            auto action = notification->addDefaultAction(i18n("Show session"));
+            connect(action, &KNotificationAction::activated, this, [this, notification]() {
+                _currentScreen->currentTerminalDisplay()->notificationClicked(notification->xdgActivationToken());
+            });
         });
     }
     if (attribute == Clipboard) {
@@ -1232,23 +1257,25 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             selection = true;
         }
 
-        if (params.length() == 2) {
-            // Copy to clipboard
-            if (clipboard) {
-                QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Clipboard);
-            }
-            if (selection) {
-                QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Selection);
-            }
-        } else {
-            // Clear clipboard
-            if (clipboard) {
-                QApplication::clipboard()->clear(QClipboard::Clipboard);
-            }
-            if (selection) {
-                QApplication::clipboard()->clear(QClipboard::Selection);
+        EmulationScheduler::runOnGuiThread([params, clipboard, selection]() {
+            if (params.length() == 2) {
+                // Copy to clipboard
+                if (clipboard) {
+                    QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Clipboard);
+                }
+                if (selection) {
+                    QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Selection);
+                }
+            } else {
+                // Clear clipboard
+                if (clipboard) {
+                    QApplication::clipboard()->clear(QClipboard::Clipboard);
+                }
+                if (selection) {
+                    QApplication::clipboard()->clear(QClipboard::Selection);
+                }
             }
-        }
+        });
 
         return;
     }
@@ -1418,82 +1445,85 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
         }
 
         if (complete) {
-            const auto hasFocus = _currentScreen->currentTerminalDisplay()->hasFocus();
-
-            bool enabled;
-            switch (notificationState->option) {
-            default:
-            case KittyNotificationOption::None:
-            case KittyNotificationOption::Always:
-                    enabled = true;
-                    break;
-            case KittyNotificationOption::Unfocused:
-                    enabled = !hasFocus;
-                    break;
-            case KittyNotificationOption::Invisible:
-                    // We might want to check if the tab is active, the window visible, etc.
-                    enabled = !hasFocus;
-                    break;
-            }
+            // Shown from the GUI thread; the state is gone by then
+            EmulationScheduler::runOnGuiThread([this, state = *notificationState, notificationId]() {
+                const auto hasFocus = _currentScreen->currentTerminalDisplay()->hasFocus();
 
-            if (enabled) {
-                    KNotification *notification;
-                    QString iconName = resolveIcon(notificationState->iconNames);
-
-                    // KNotification does not support application name, add it to the title instead:
-                    QString fullTitle = notificationState->applicationName;
-                    if (!notificationState->title.isEmpty()) {
-                    if (!fullTitle.isEmpty())
-                        fullTitle += QStringLiteral(": ");
-                    fullTitle += notificationState->title;
-                    }
+                bool enabled;
+                switch (state.option) {
+                default:
+                case KittyNotificationOption::None:
+                case KittyNotificationOption::Always:
+                        enabled = true;
+                        break;
+                case KittyNotificationOption::Unfocused:
+                        enabled = !hasFocus;
+                        break;
+                case KittyNotificationOption::Invisible:
+                        // We might want to check if the tab is active, the window visible, etc.
+                        enabled = !hasFocus;
+                        break;
+                }
 
-                    notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"),
-                                                        fullTitle,
-                                                        notificationState->body.toHtmlEscaped(),
-                                                        iconName);
+                if (enabled) {
+                        KNotification *notification;
+                        QString iconName = resolveIcon(state.iconNames);
 
-                    KNotification::Urgency resultUrgency = KNotification::Urgency::NormalUrgency;
-                    switch (notificationState->urgency) {
-                    case 0:
-                    resultUrgency = KNotification::Urgency::LowUrgency;
-                    break;
-                    case 1:
-                    resultUrgency = KNotification::Urgency::NormalUrgency;
-                    break;
-                    case 2:
-                    resultUrgency = KNotification::Urgency::CriticalUrgency;
-                    break;
-                    }
-                    notification->setUrgency(resultUrgency);
-                    auto action = notification->addDefaultAction(i18n("Show session"));
+                        // KNotification does not support application name, add it to the title instead:
+                        QString fullTitle = state.applicationName;
+                        if (!state.title.isEmpty()) {
+                        if (!fullTitle.isEmpty())
+                            fullTitle += QStringLiteral(": ");
+                        fullTitle += state.title;
+                        }
 
-                    if (notificationState->closeSignal) {
-                    connect(notification, &KNotification::closed, this, [this, notificationId]() {
-                        sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(":p=close;\033\\")).toLatin1());
-                    });
-                    }
+                        notification = KNotification::event(hasFocus ? QStringLiteral("ProcessNotification") : QStringLiteral("ProcessNotificationHidden"),
+                                                            fullTitle,
+                                                            state.body.toHtmlEscaped(),
+                                                            iconName);
+
+                        KNotification::Urgency resultUrgency = KNotification::Urgency::NormalUrgency;
+                        switch (state.urgency) {
+                        case 0:
+                        resultUrgency = KNotification::Urgency::LowUrgency;
+                        break;
+                        case 1:
+                        resultUrgency = KNotification::Urgency::NormalUrgency;
+                        break;
+                        case 2:
+                        resultUrgency = KNotification::Urgency::CriticalUrgency;
+                        break;
+                        }
+                        notification->setUrgency(resultUrgency);
+                        auto action = notification->addDefaultAction(i18n("Show session"));
 
-                    int notificationAction = notificationState->action;
-                    if (notificationAction != 0) {
-                    connect(action, &KNotificationAction::activated, this, [this, notification, notificationAction, notificationId]() {
-                        if (notificationAction & NotificationActionReport) {
-                            sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(";\033\\")).toLatin1());
+                        if (state.closeSignal) {
+                        connect(notification, &KNotification::closed, this, [this, notificationId]() {
+                            sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(":p=close;\033\\")).toLatin1());
+                        });
                         }
-                        if (notificationAction & NotificationActionFocus) {
-                            _currentScreen->currentTerminalDisplay()->notificationClicked(notification->xdgActivationToken());
+
+                        int notificationAction = state.action;
+                        if (notificationAction != 0) {
+                        connect(action, &KNotificationAction::activated, this, [this, notification, notificationAction, notificationId]() {
+                            if (notificationAction & NotificationActionReport) {
+                                sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(";\033\\")).toLatin1());
+                            }
+                            if (notificationAction & NotificationActionFocus) {
+                                _currentScreen->currentTerminalDisplay()->notificationClicked(notification->xdgActivationToken());
+                            }
+                        });
                         }
-                    });
-                    }
 
-                    for (int i = 0; i < notificationState->buttons.size(); ++i) {
-                    KNotificationAction *action = notification->addAction(notificationState->buttons[i]);
-                    connect(action, &KNotificationAction::activated, this, [this, notificationId, i]() {
-                        sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(";") + QString::number(i + 1) + QStringLiteral("\033\\"))
-                                       .toLatin1());
-                    });
-                    }
-            }
+                        for (int i = 0; i < state.buttons.size(); ++i) {
+                        KNotificationAction *action = notification->addAction(state.buttons[i]);
+                        connect(action, &KNotificationAction::activated, this, [this, notificationId, i]() {
+                            sendString((QStringLiteral("\033]99;i=") + notificationId + QStringLiteral(";") + QString::number(i + 1) + QStringLiteral("\033\\"))
+                                           .toLatin1());
+                        });
+                        }
+                }
+            });
 
             _kittyNotifications.remove(notificationId);
         }
@@ -1644,39 +1674,44 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             }
         }
         if (inlineMedia) {
-            if (player == nullptr) {
-                player = new QMediaPlayer(this);
-                player->setAudioOutput(new QAudioOutput(player));
-                connect(player, &QMediaPlayer::mediaStatusChanged, this, &Vt102Emulation::deletePlayer);
-            }
-            QBuffer *buffer = new QBuffer(player);
-            buffer->setData(tokenData);
-            buffer->open(QIODevice::ReadOnly);
-            delete (QIODevice *)(player->sourceDevice());
-            player->setSourceDevice(buffer);
-            player->play();
+            EmulationScheduler::runOnGuiThread([this, tokenData]() {
+                if (player == nullptr) {
+                    player = new QMediaPlayer(this);
+                    player->setAudioOutput(new QAudioOutput(player));
+                    connect(player, &QMediaPlayer::mediaStatusChanged, this, &Vt102Emulation::deletePlayer);
+                }
+                QBuffer *buffer = new QBuffer(player);
+                buffer->setData(tokenData);
+                buffer->open(QIODevice::ReadOnly);
+                delete (QIODevice *)(player->sourceDevice());
+                player->setSourceDevice(buffer);
+                player->play();
+            });
             return;
         }
         if (!inlineImage) {
             return;
         }
-        QPixmap pixmap;
-        pixmap.loadFromData(tokenData);
-        tokenData.clear();
-        if (pixmap.isNull()) {
-            return;
-        }
-        if (scaledWidth && scaledHeight) {
-            pixmap = pixmap.scaled(scaledWidth, scaledHeight, (Qt::AspectRatioMode)keepAspect);
-        } else {
+        // decoded in the background; the size is known from the header
+        const GraphicsImage image = GraphicsImageCache::instance()->decode(tokenData, [=](const QSize &size) {
+            if (scaledWidth && scaledHeight) {
+                return size.scaled(scaledWidth, scaledHeight, (Qt::AspectRatioMode)keepAspect);
+            }
             if (keepAspect && scaledWidth) {
-                pixmap = pixmap.scaledToWidth(scaledWidth);
-            } else if (keepAspect && scaledHeight) {
-                pixmap = pixmap.scaledToHeight(scaledHeight);
+                return QSize(scaledWidth, qMax(1, qRound(qreal(size.height()) * scaledWidth / size.width())));
+            }
+            if (keepAspect && scaledHeight) {
+                return QSize(qMax(1, qRound(qreal(size.width()) * scaledHeight / size.height())), scaledHeight);
             }
+            return size;
+        });
+        tokenData.clear();
+        if (image.isNull()) {
+            return;
         }
         int rows = -1, cols = -1;
-        _currentScreen->addPlacement(pixmap, rows, cols, -1, -1, TerminalGraphicsPlacement_t::iTerm, true, moveCursor);
+        _currentScreen->addPlacement(image, rows, cols, -1, -1, TerminalGraphicsPlacement_t::iTerm, true, moveCursor);
+        updateWhenDecoded(image);
     }
 
     if (attribute == PointerShape) {
@@ -1751,17 +1786,24 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
             {QLatin1String("copy"), Qt::DragCopyCursor},
         };
 
-        if (!cursorShapes.contains(value)) {
-            _currentScreen->currentTerminalDisplay()->resetCursor();
-        } else {
-            _currentScreen->currentTerminalDisplay()->setPointerShape(cursorShapes[value]);
-        }
+        const auto shape = cursorShapes.constFind(value);
+        const bool known = shape != cursorShapes.cend();
+        const Qt::CursorShape cursorShape = known ? *shape : Qt::ArrowCursor;
+        EmulationScheduler::runOnGuiThread([this, known, cursorShape]() {
+            if (!known) {
+                _currentScreen->currentTerminalDisplay()->resetCursor();
+            } else {
+                _currentScreen->currentTerminalDisplay()->setPointerShape(cursorShape);
+            }
+        });
 
         return;
     }
 
     _pendingSessionAttributesUpdates[attribute] = value;
-    _sessionAttributesUpdateTimer->start(20);
+    EmulationScheduler::runOnGuiThread([this]() {
+        _sessionAttributesUpdateTimer->start(20);
+    });
 }
 
 void Vt102Emulation::deletePlayer(QMediaPlayer::MediaStatus mediaStatus)
@@ -2252,7 +2294,7 @@ void Vt102Emulation::processGraphicsToken(int tokenSize)
 {
     QString value = QString::fromUcs4(&tokenBuffer[1], tokenSize - 1);
     QStringList list;
-    QPixmap pixmap;
+    GraphicsImage image;
 
     int dataPos = value.indexOf(QLatin1Char(';'));
     if (dataPos == -1) {
@@ -2318,53 +2360,43 @@ void Vt102Emulation::processGraphicsToken(int tokenSize)
         }
         imageData.append(tokenData);
         tokenData.clear();
-        imageData.append(QByteArray::fromBase64(value.mid(dataPos + 1).toLocal8Bit()));
         if (keys['m'] == 0) {
             imageId = 0;
             savedKeys = QMap<char, qint64>();
-            QByteArray out;
-
-            uint32_t byteCount = 0;
-            if (keys['f'] == 24 || keys['f'] == 32) {
-                int bpp = keys['f'] / 8;
-                byteCount = bpp * keys['s'] * keys['v'];
-            } else {
-                byteCount = 8 * 1024 * 1024;
-            }
-
-            if (keys['o'] == 'z') {
-                char header[sizeof byteCount];
-                qToBigEndian(byteCount, header);
-                imageData.prepend(header, sizeof header);
-                out = qUncompress(imageData);
 
-                if (keys['f'] != 24 && keys['f'] != 32) {
-                    imageData = out;
-                }
-            }
-            if (out.isEmpty()) {
-                out = imageData;
-            }
-
-            if (keys['f'] == 24 || keys['f'] == 32) {
-                if (unsigned(out.size()) < byteCount) {
-                    qCWarning(KonsoleDebug) << "Not enough image data" << out.size() << "require" << byteCount;
+            const bool compressed = keys['o'] == 'z';
+            const bool raw = keys['f'] == 24 || keys['f'] == 32;
+            if (raw && !compressed) {
+                const qint64 byteCount = qint64(keys['f'] / 8) * keys['s'] * keys['v'];
+                if (imageData.size() < byteCount) {
+                    qCWarning(KonsoleDebug) << "Not enough image data" << imageData.size() << "require" << byteCount;
                     imageData.clear();
                     return;
                 }
-                QImage::Format format = keys['f'] == 24 ? QImage::Format_RGB888 : QImage::Format_RGBA8888;
-                pixmap = QPixmap::fromImage(QImage((const uchar *)out.constData(), 0 + keys['s'], 0 + keys['v'], 0 + keys['s'] * keys['f'] / 8, format));
-                pixmap.detach();
-            } else {
-                pixmap.loadFromData(out);
             }
 
             if (keys['a'] == 'q') {
                 QString params = QStringLiteral("i=") + QString::number(keys['i']);
                 sendGraphicsReply(params, QString());
             } else {
+                // decoded in the background
+                GraphicsImageCache *cache = GraphicsImageCache::instance();
+                if (raw) {
+                    const QImage::Format format = keys['f'] == 24 ? QImage::Format_RGB888 : QImage::Format_RGBA8888;
+                    image = cache->decodeRaw(imageData, compressed, QSize(keys['s'], keys['v']), format);
+                } else {
+                    if (compressed) {
+                        // the header is needed right away for the size
+                        const quint32 byteCount = 8 * 1024 * 1024;
+                        char header[sizeof byteCount];
+                        qToBigEndian(byteCount, header);
+                        imageData.prepend(header, sizeof header);
+                        imageData = qUncompress(imageData);
+                    }
+                    image = cache->decode(imageData);
+                }
                 if (keys['i']) {
-                    _graphicsImages[keys['i']] = pixmap;
+                    _graphicsImages[keys['i']] = image;
                 }
                 if (keys['q'] == 0 && keys['a'] == 't') {
                     QString params = QStringLiteral("i=") + QString::number(keys['i']);
@@ -2384,20 +2416,25 @@ void Vt102Emulation::processGraphicsToken(int tokenSize)
     }
     if (keys['a'] == 'p' || (keys['a'] == 'T' && keys['m'] == 0)) {
         if (keys['a'] == 'p') {
-            pixmap = _graphicsImages[keys['i']];
+            image = _graphicsImages[keys['i']];
         }
-        if (!pixmap.isNull()) {
+        if (!image.isNull()) {
+            QRect crop;
+            QSize size;
             if (keys['x'] || keys['y'] || keys['w'] || keys['h']) {
-                int w = keys['w'] ? keys['w'] : pixmap.width() - keys['x'];
-                int h = keys['h'] ? keys['h'] : pixmap.height() - keys['y'];
-                pixmap = pixmap.copy(keys['x'], keys['y'], w, h);
+                int w = keys['w'] ? keys['w'] : image.width() - keys['x'];
+                int h = keys['h'] ? keys['h'] : image.height() - keys['y'];
+                crop = QRect(keys['x'], keys['y'], w, h);
             }
             if (keys['c'] && keys['r']) {
-                pixmap = pixmap.scaled(keys['c'] * _currentScreen->currentTerminalDisplay()->terminalFont()->fontWidth(),
-                                       keys['r'] * _currentScreen->currentTerminalDisplay()->terminalFont()->fontHeight());
+                size = QSize(keys['c'] * _currentScreen->currentTerminalDisplay()->terminalFont()->fontWidth(),
+                             keys['r'] * _currentScreen->currentTerminalDisplay()->terminalFont()->fontHeight());
+            }
+            if (crop.isValid() || size.isValid()) {
+                image = GraphicsImageCache::instance()->transformed(image, crop, size);
             }
             int rows = -1, cols = -1;
-            _currentScreen->addPlacement(pixmap,
+            _currentScreen->addPlacement(image,
                                          rows,
                                          cols,
                                          -1,
@@ -2412,6 +2449,7 @@ void Vt102Emulation::processGraphicsToken(int tokenSize)
                                          keys['A'] / 255.0,
                                          keys['X'],
                                          keys['Y']);
+            updateWhenDecoded(image);
             if (keys['q'] == 0 && keys['i']) {
                 QString params = QStringLiteral("i=") + QString::number(keys['i']);
                 if (keys['I']) {
@@ -3126,7 +3164,9 @@ void Vt102Emulation::setMode(int m)
         setScreen(1);
         if (_currentScreen && _currentScreen->currentTerminalDisplay()) {
             _currentScreen->delPlacements(1);
-            _currentScreen->currentTerminalDisplay()->update();
+            EmulationScheduler::runOnGuiThread([this]() {
+                _currentScreen->currentTerminalDisplay()->update();
+            });
         }
         break;
     }
@@ -3171,7 +3211,9 @@ void Vt102Emulation::resetMode(int m)
         _screen[0]->clearSelection();
         setScreen(0);
         if (_currentScreen && _currentScreen->currentTerminalDisplay()) {
-            _currentScreen->currentTerminalDisplay()->update();
+            EmulationScheduler::runOnGuiThread([this]() {
+                _currentScreen->currentTerminalDisplay()->update();
+            });
         }
         break;
     }
@@ -3369,12 +3411,25 @@ void Vt102Emulation::SixelModeDisable()
         col = 0;
         row = 0;
     }
-    QPixmap pixmap = QPixmap::fromImage(m_currentImage.copy(QRect(0, 0, m_actualSize.width(), m_actualSize.height())));
+    // converted and scaled in the background
+    const QImage sixels = m_currentImage.copy(QRect(0, 0, m_actualSize.width(), m_actualSize.height()));
+    QSize size = sixels.size();
     if (m_aspect.first != m_aspect.second) {
-        pixmap = pixmap.scaled(pixmap.width(), m_aspect.first * pixmap.height() / m_aspect.second);
+        size.setHeight(m_aspect.first * size.height() / m_aspect.second);
     }
+    const GraphicsImage image = GraphicsImageCache::instance()->convert(sixels, size);
     int rows = -1, cols = -1;
-    _currentScreen->addPlacement(pixmap, rows, cols, row, col, TerminalGraphicsPlacement_t::Sixel, m_SixelScrolling, m_SixelScrolling * 2, false);
+    _currentScreen->addPlacement(image, rows, cols, row, col, TerminalGraphicsPlacement_t::Sixel, m_SixelScrolling, m_SixelScrolling * 2, false);
+    updateWhenDecoded(image);
+}
+
+void Vt102Emulation::updateWhenDecoded(const GraphicsImage &image)
+{
+    if (!image.isReady()) {
+        image.whenReady(this, [this]() {
+            bufferedUpdate();
+        });
+    }
 }
 
 void Vt102Emulation::SixelColorChangeRGB(const int index, int red, int green, int blue)
@@ -18,6 +18,7 @@
 
 
 // Konsole
+#include "Base64Decoder.h"
 #include "Emulation.h"
 #include "Screen.h"
 #include "keyboardtranslator/KeyboardTranslator.h"
@@ -221,6 +222,11 @@ private:
     const char *tokenStateChange;
     int tokenPos;
     QByteArray tokenData;
+    // Base64 payloads are collected in the token buffer and decoded into
+    // tokenData in chunks of this many characters
+    Base64Decoder tokenDecoder;
+    static constexpr int Base64ChunkSize = 4096;
+    void decodeTokenData();
 
     // Set of flags for each of the ASCII characters which indicates
     // what category they fall into (printable character, control, digit etc.)
@@ -340,11 +346,14 @@ private:
     QSize m_actualSize; // For efficiency reasons, we keep the image in memory larger than what the end result is
 
     // Kitty
-    QHash<int, QPixmap> _graphicsImages;
+    QHash<int, GraphicsImage> _graphicsImages;
     // For kitty graphics protocol - image cache
     int getFreeGraphicsImageId();
 
     QMediaPlayer *player;
+
+    // Schedules a redraw for when an image decoded in the background is ready
+    void updateWhenDecoded(const GraphicsImage &image);
 };
 
 }
@@ -101,7 +101,7 @@ void AgentFleetProviderTest::testName()
 void AgentFleetProviderTest::testInterfaceVersion()
 {
     AgentFleetProvider provider(m_fleetPath);
-    QCOMPARE(provider.interfaceVersion(), 1);
+    QCOMPARE(provider.interfaceVersion(), 2);
 }
 
 // ── Availability ──
@@ -628,6 +628,164 @@ void AgentFleetProviderTest::testAgentsReloaded_OnDirectoryChange()
     QCOMPARE(spy.count(), 1);
 }
 
+void AgentFleetProviderTest::testAgentsReloaded_OnNewBudgetDay()
+{
+    // No spend yet today
+    const QString today = m_configDir + QStringLiteral("/budgets/") + QDate::currentDate().toString(QStringLiteral("yyyy-MM-dd"));
+    QVERIFY(QDir(today).removeRecursively());
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    QSignalSpy spy(&provider, &AgentProvider::agentsReloaded);
+
+    // The first spend of the day creates the directory, then writes to it
+    QVERIFY(QDir().mkpath(today));
+    QTRY_VERIFY(spy.count() >= 1);
+    spy.clear();
+    writeBudget(QStringLiteral("alpha"), R"({"total_cost_usd": 1.0})");
+    QTRY_VERIFY(spy.count() >= 1);
+}
+
+// ── Snapshots ──
+
+AgentFleetDelta AgentFleetProviderTest::refreshAndWait(AgentFleetProvider &provider)
+{
+    AgentFleetDelta delta;
+    bool updated = false;
+    auto connection = connect(&provider, &AgentProvider::snapshotUpdated, this, [&](const AgentFleetDelta &d) {
+        delta = d;
+        updated = true;
+    });
+    provider.refreshSnapshot();
+    [&]() {
+        QTRY_VERIFY(updated);
+    }();
+    disconnect(connection);
+    return delta;
+}
+
+void AgentFleetProviderTest::testSnapshot_BuiltInBackground()
+{
+    writeGoalYaml(QStringLiteral("alpha"), QStringLiteral("name: Alpha\n"));
+    writeGoalYaml(QStringLiteral("beta"), QStringLiteral("name: Beta\n"));
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    QVERIFY(!provider.snapshot());
+
+    const AgentFleetDelta delta = refreshAndWait(provider);
+    QCOMPARE(delta.added, QStringList({QStringLiteral("alpha"), QStringLiteral("beta")}));
+
+    const AgentFleetSnapshotPtr snap = provider.snapshot();
+    QVERIFY(snap);
+    QCOMPARE(snap->entries.size(), 2);
+    QVERIFY(snap->find(QStringLiteral("beta")));
+    QCOMPARE(snap->find(QStringLiteral("beta"))->info.name, QStringLiteral("Beta"));
+    QVERIFY(!snap->find(QStringLiteral("gamma")));
+}
+
+void AgentFleetProviderTest::testSnapshot_DeltaOnlyChangedAgents()
+{
+    writeGoalYaml(QStringLiteral("alpha"), QStringLiteral("name: Alpha\n"));
+    writeGoalYaml(QStringLiteral("beta"), QStringLiteral("name: Beta\n"));
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    refreshAndWait(provider);
+    const AgentFleetSnapshotPtr first = provider.snapshot();
+
+    writeSessionState(QStringLiteral("alpha"), R"({"state": "running", "run_count": 3})");
+    const AgentFleetDelta delta = refreshAndWait(provider);
+    QCOMPARE(delta.changed, QStringList{QStringLiteral("alpha")});
+    QVERIFY(!delta.isStructural());
+
+    const AgentFleetSnapshotPtr second = provider.snapshot();
+    QVERIFY(second != first);
+    QCOMPARE(second->generation, first->generation + 1);
+    QCOMPARE(second->find(QStringLiteral("alpha"))->status.state, AgentStatus::Running);
+    QCOMPARE(second->find(QStringLiteral("alpha"))->status.runCount, 3);
+
+    // published snapshots are never modified
+    QCOMPARE(first->find(QStringLiteral("alpha"))->status.state, AgentStatus::Idle);
+}
+
+void AgentFleetProviderTest::testSnapshot_UnchangedFleetKeepsSnapshot()
+{
+    writeGoalYaml(QStringLiteral("alpha"), QStringLiteral("name: Alpha\n"));
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    refreshAndWait(provider);
+    const AgentFleetSnapshotPtr first = provider.snapshot();
+
+    QSignalSpy spy(&provider, &AgentProvider::snapshotUpdated);
+    provider.refreshSnapshot();
+    QVERIFY(!spy.wait(300));
+    QCOMPARE(provider.snapshot(), first);
+}
+
+void AgentFleetProviderTest::testSnapshot_RemovedAgent()
+{
+    writeGoalYaml(QStringLiteral("alpha"), QStringLiteral("name: Alpha\n"));
+    writeGoalYaml(QStringLiteral("beta"), QStringLiteral("name: Beta\n"));
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    refreshAndWait(provider);
+
+    QVERIFY(QFile::remove(m_fleetPath + QStringLiteral("/goals/alpha.yaml")));
+    const AgentFleetDelta delta = refreshAndWait(provider);
+    QCOMPARE(delta.removed, QStringList{QStringLiteral("alpha")});
+    QVERIFY(delta.isStructural());
+    QCOMPARE(provider.snapshot()->entries.size(), 1);
+}
+
+void AgentFleetProviderTest::testSnapshot_Totals()
+{
+    writeGoalYaml(QStringLiteral("b1"), QStringLiteral("name: B1\ndaily_budget: 10.0\n"));
+    writeGoalYaml(QStringLiteral("b2"), QStringLiteral("name: B2\ndaily_budget: 20.0\n"));
+    writeBudget(QStringLiteral("b1"), R"({"total_cost_usd": 2.5})");
+
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    refreshAndWait(provider);
+
+    QCOMPARE(provider.snapshot()->totalDailyBudgetUSD, 30.0);
+    QCOMPARE(provider.snapshot()->totalDailySpendUSD, 2.5);
+    QCOMPARE(provider.totalDailySpendUSD(), 2.5);
+}
+
+// ── Asynchronous writes ──
+
+void AgentFleetProviderTest::testCreateAgentAsync_WritesYaml()
+{
+    AgentFleetProvider provider(m_fleetPath);
+    provider.setConfigDir(m_configDir);
+    QSignalSpy spy(&provider, &AgentProvider::agentsReloaded);
+
+    AgentConfig config;
+    config.name = QStringLiteral("async-agent");
+    config.goal = QStringLiteral("Work in the background");
+    QFuture<bool> future = provider.createAgentAsync(config);
+
+    QTRY_VERIFY(future.isFinished());
+    QVERIFY(future.result());
+    QVERIFY(QFile::exists(m_fleetPath + QStringLiteral("/goals/async-agent.yaml")));
+    QCOMPARE(spy.count(), 1);
+}
+
+void AgentFleetProviderTest::testTriggerRunAsync_NoBinary()
+{
+    if (!QStandardPaths::findExecutable(QStringLiteral("agent-fleet")).isEmpty()) {
+        QSKIP("agent-fleet is installed");
+    }
+
+    AgentFleetProvider provider(m_fleetPath);
+    QFuture<bool> future = provider.triggerRunAsync(QStringLiteral("nobody"));
+    QTRY_VERIFY(future.isFinished());
+    QVERIFY(!future.result());
+}
+
 QTEST_GUILESS_MAIN(AgentFleetProviderTest)
 
 #include "moc_AgentFleetProviderTest.cpp"
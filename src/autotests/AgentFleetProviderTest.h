@@ -9,9 +9,13 @@
 #include <QObject>
 #include <QTemporaryDir>
 
+#include "../claude/AgentProvider.h"
+
 namespace Konsolai
 {
 
+class AgentFleetProvider;
+
 class AgentFleetProviderTest : public QObject
 {
     Q_OBJECT
@@ -102,8 +106,21 @@ private Q_SLOTS:
 
     // File watcher signals
     void testAgentsReloaded_OnDirectoryChange();
+    void testAgentsReloaded_OnNewBudgetDay();
+
+    // Snapshots (interface version 2)
+    void testSnapshot_BuiltInBackground();
+    void testSnapshot_DeltaOnlyChangedAgents();
+    void testSnapshot_UnchangedFleetKeepsSnapshot();
+    void testSnapshot_RemovedAgent();
+    void testSnapshot_Totals();
+
+    // Asynchronous writes
+    void testCreateAgentAsync_WritesYaml();
+    void testTriggerRunAsync_NoBinary();
 
 private:
+    AgentFleetDelta refreshAndWait(AgentFleetProvider &provider);
     void writeGoalYaml(const QString &name, const QString &content);
     void writeSessionState(const QString &name, const QByteArray &json);
     void writeBrief(const QString &name, const QByteArray &json);
@@ -132,7 +132,8 @@ void AgentManagerPanelTest::testTreeWithAgents()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
-    QCOMPARE(tree->topLevelItemCount(), 2);
+    // the provider builds its snapshot in the background
+    QTRY_COMPARE(tree->topLevelItemCount(), 2);
 }
 
 void AgentManagerPanelTest::testTreeAgentColumns()
@@ -143,7 +144,7 @@ void AgentManagerPanelTest::testTreeAgentColumns()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
-    QCOMPARE(tree->topLevelItemCount(), 1);
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
 
     auto *item = tree->topLevelItem(0);
     QCOMPARE(item->text(0), QStringLiteral("Test Agent"));
@@ -163,6 +164,7 @@ void AgentManagerPanelTest::testTreeChildItems()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
     // Should have schedule and budget child items
     QVERIFY(item->childCount() >= 2);
@@ -176,6 +178,7 @@ void AgentManagerPanelTest::testTreeStatusBadge_Idle()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
     // Status should contain idle circle ○
     QVERIFY(item->text(1).contains(QStringLiteral("\u25CB")));
@@ -190,6 +193,7 @@ void AgentManagerPanelTest::testTreeStatusBadge_Running()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
     // Default state is idle since no session file exists
     QVERIFY(item->text(1).contains(QStringLiteral("\u25CB")));
@@ -203,6 +207,7 @@ void AgentManagerPanelTest::testTreeStatusBadge_Error()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
     QVERIFY(item->text(1).contains(QStringLiteral("\u25CB"))); // idle (no state file)
 }
@@ -215,6 +220,7 @@ void AgentManagerPanelTest::testTreeStatusBadge_Budget()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
     QVERIFY(item->text(1).contains(QStringLiteral("\u25CB"))); // idle (no state file)
 }
@@ -240,7 +246,7 @@ void AgentManagerPanelTest::testFooterWithBudget()
 
     auto *footer = panel.findChild<QLabel *>(QStringLiteral("agentFooter"));
     // Should show fleet total with budget
-    QVERIFY(footer->text().contains(QStringLiteral("$")));
+    QTRY_VERIFY(footer->text().contains(QStringLiteral("$")));
 }
 
 // ── Context menu ──
@@ -253,6 +259,7 @@ void AgentManagerPanelTest::testContextMenuItemData()
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
 
     auto *tree = panel.findChild<QTreeWidget *>(QStringLiteral("agentTree"));
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
     auto *item = tree->topLevelItem(0);
 
     // Verify item data roles
@@ -279,7 +286,7 @@ void AgentManagerPanelTest::testRefresh()
     // call refresh() directly for immediate rebuild
     panel.refresh();
 
-    QCOMPARE(tree->topLevelItemCount(), 1);
+    QTRY_COMPARE(tree->topLevelItemCount(), 1);
 }
 
 // ── Signals ──
@@ -311,7 +318,7 @@ void AgentManagerPanelTest::testTotalDailyBudget()
 
     AgentManagerPanel panel;
     panel.addProvider(new AgentFleetProvider(m_fleetPath));
-    QCOMPARE(panel.totalDailyBudgetUSD(), 40.0);
+    QTRY_COMPARE(panel.totalDailyBudgetUSD(), 40.0);
 }
 
 QTEST_MAIN(AgentManagerPanelTest)
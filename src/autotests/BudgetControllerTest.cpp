@@ -175,47 +175,43 @@ void BudgetControllerTest::testTokenVelocity()
     // Initially zero
     QCOMPARE(v.tokensPerMinute(), 0.0);
     QCOMPARE(v.costPerMinute(), 0.0);
-
-    // Add samples simulating 1000 tokens/minute
-    QDateTime now = QDateTime::currentDateTime();
-
-    // We need to directly set timestamps for reproducible tests
-    TokenVelocity::VelocitySample s1;
-    s1.timestamp = now.addSecs(-300); // 5 minutes ago
-    s1.totalTokens = 0;
-    s1.costUSD = 0.0;
-
-    TokenVelocity::VelocitySample s2;
-    s2.timestamp = now.addSecs(-240); // 4 minutes ago
-    s2.totalTokens = 1000;
-    s2.costUSD = 0.05;
-
-    TokenVelocity::VelocitySample s3;
-    s3.timestamp = now.addSecs(-180); // 3 minutes ago
-    s3.totalTokens = 2000;
-    s3.costUSD = 0.10;
-
-    TokenVelocity::VelocitySample s4;
-    s4.timestamp = now; // now
-    s4.totalTokens = 5000;
-    s4.costUSD = 0.25;
-
-    // Manually fill ring buffer
-    v.samples[0] = s1;
-    v.samples[1] = s2;
-    v.samples[2] = s3;
-    v.samples[3] = s4;
-    v.head = 4;
-    v.count = 4;
-
-    // tokensPerMinute: over 4 samples, lookback = min(4,5) = 4
-    // oldest = (4-4+120)%120 = 0, newest = (4-1+120)%120 = 3
-    // delta = 5000-0 = 5000 tokens over 300s = 5.0 min → 1000 tokens/min
-    QVERIFY(qAbs(v.tokensPerMinute() - 1000.0) < 1.0);
-    QVERIFY(qAbs(v.costPerMinute() - 0.05) < 0.001);
-
-    // estimatedMinutesRemaining: 10000 ceiling, 5000 current, 1000/min → 5 minutes
-    QVERIFY(qAbs(v.estimatedMinutesRemaining(10000, 5000) - 5.0) < 0.1);
+    QVERIFY(!v.isActive());
+
+    // A steady 1000 tokens/minute: 50 tokens every 3 seconds for half an hour, up to now
+    const qint64 start = TokenVelocity::now() - 30 * 60000;
+    qint64 last = start;
+    for (qint64 t = start; t <= start + 30 * 60000; t += 3000) {
+        v.addDelta(50, 0.0025, t);
+        last = t;
+    }
+    // Right after an event the rate is a little above the average, most in the short window
+    QVERIFY(qAbs(v.tokensPerMinute(TokenVelocity::ShortWindow, last) - 1000.0) < 150.0);
+    QVERIFY(qAbs(v.tokensPerMinute(TokenVelocity::MinuteWindow, last) - 1000.0) < 50.0);
+    QVERIFY(qAbs(v.tokensPerMinute(TokenVelocity::LongWindow, last) - 1000.0) < 10.0);
+    QVERIFY(qAbs(v.costPerMinute(TokenVelocity::LongWindow, last) - 0.05) < 0.001);
+    QVERIFY(v.isActive(last));
+
+    // estimatedMinutesRemaining: 10000 ceiling, 5000 current, ~1000/min → ~5 minutes
+    QVERIFY(qAbs(v.estimatedMinutesRemaining(10000, 5000) - 5.0) < 0.5);
+
+    // A burst shows in the short window right away, barely in the long one
+    v.addDelta(20000, 1.0, last + 1000);
+    QVERIFY(v.tokensPerMinute(TokenVelocity::ShortWindow, last + 1000) > 60000.0);
+    QVERIFY(v.tokensPerMinute(TokenVelocity::LongWindow, last + 1000) < 6000.0);
+
+    // ... and fades again without any sampling
+    QVERIFY(v.tokensPerMinute(TokenVelocity::ShortWindow, last + 61000) < 2000.0);
+    QVERIFY(!v.isActive(last + 60 * 60000));
+
+    // Records stamped out of order count as simultaneous
+    const double before = v.tokensPerMinute(TokenVelocity::LongWindow, last + 1000);
+    v.addDelta(300, 0.0, last);
+    QVERIFY(qAbs(v.tokensPerMinute(TokenVelocity::LongWindow, last + 1000) - before - 60.0) < 0.01);
+
+    QCOMPARE(TokenVelocity::windowFor(10), TokenVelocity::ShortWindow);
+    QCOMPARE(TokenVelocity::windowFor(60), TokenVelocity::MinuteWindow);
+    QCOMPARE(TokenVelocity::windowFor(300), TokenVelocity::LongWindow);
+    QCOMPARE(TokenVelocity::windowFor(3600), TokenVelocity::LongWindow);
 
     // Format check
     QString fmt = v.formatVelocity();
@@ -223,6 +219,62 @@ void BudgetControllerTest::testTokenVelocity()
     QVERIFY(fmt.contains(QStringLiteral("$")));
 }
 
+// ============================================================
+// testUsageRecordChecksCeilings
+// ============================================================
+
+void BudgetControllerTest::testUsageRecordChecksCeilings()
+{
+    BudgetController ctrl;
+    QSignalSpy exceededSpy(&ctrl, &BudgetController::budgetExceeded);
+    QSignalSpy velocitySpy(&ctrl, &BudgetController::velocityUpdated);
+
+    SessionBudget b;
+    b.tokenCeiling = 10000;
+    ctrl.setBudget(b);
+
+    TokenUsage record;
+    record.outputTokens = 4000;
+    TokenUsage total;
+
+    total.add(record);
+    ctrl.onUsageRecord(record, total);
+    total.add(record);
+    ctrl.onUsageRecord(record, total);
+    QCOMPARE(exceededSpy.count(), 0);
+    QCOMPARE(velocitySpy.count(), 2);
+    QVERIFY(ctrl.velocity().tokensPerMinute(TokenVelocity::ShortWindow) > 0.0);
+
+    // The record crossing the ceiling trips it
+    total.add(record);
+    ctrl.onUsageRecord(record, total);
+    QCOMPARE(exceededSpy.count(), 1);
+    QCOMPARE(exceededSpy.at(0).at(0).toString(), QStringLiteral("token"));
+    QVERIFY(ctrl.shouldBlockYolo());
+}
+
+// ============================================================
+// testTimeBudgetTimer
+// ============================================================
+
+void BudgetControllerTest::testTimeBudgetTimer()
+{
+    BudgetController ctrl;
+    QSignalSpy warningSpy(&ctrl, &BudgetController::budgetWarning);
+    QSignalSpy exceededSpy(&ctrl, &BudgetController::budgetExceeded);
+
+    // Half a second short of a one minute limit: no polling interval to wait for
+    SessionBudget b;
+    b.timeLimitMinutes = 1;
+    b.startedAt = QDateTime::currentDateTime().addMSecs(-59500);
+    ctrl.setBudget(b);
+
+    QTRY_COMPARE(warningSpy.count(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(exceededSpy.count(), 1, 2000);
+    QCOMPARE(exceededSpy.at(0).at(0).toString(), QStringLiteral("time"));
+    QVERIFY(ctrl.budget().timeExceeded);
+}
+
 // ============================================================
 // testBudgetSerialization
 // ============================================================
@@ -25,6 +25,8 @@ private Q_SLOTS:
     void testTokenBudgetExceeded();
     void testResourceGateDebounce();
     void testTokenVelocity();
+    void testUsageRecordChecksCeilings();
+    void testTimeBudgetTimer();
     void testBudgetSerialization();
     void testShouldBlockYolo();
 };
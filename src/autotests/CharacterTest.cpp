@@ -6,9 +6,272 @@
 
 #include "CharacterTest.h"
 #include "Character.h"
+#include "CharacterStyleTable.h"
 
 #include <QTest>
+#include <atomic>
 #include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Konsole;
+
+namespace
+{
+constexpr int ScreenColumns = 300;
+constexpr int ScreenLines = 100;
+
+// a screen of colored text: a dozen styles, like a shell with syntax highlighting
+std::vector<Character> makeScreen()
+{
+    std::vector<Character> screen(ScreenColumns * ScreenLines);
+    for (int i = 0; i < int(screen.size()); ++i) {
+        const int style = (i / 7) % 12;
+        screen[i] = Character(U'a' + (i % 26),
+                              CharacterColor(COLOR_SPACE_SYSTEM, style % 8),
+                              CharacterColor(COLOR_SPACE_DEFAULT, DEFAULT_BACK_COLOR),
+                              style >= 8 ? RE_BOLD : DEFAULT_RENDITION);
+    }
+    return screen;
+}
+}
+
+void CharacterTest::testExtendedCharRoundTrip()
+{
+    // woman + ZWJ + laptop
+    const char32_t chars[] = {0x1F469, 0x200D, 0x1F4BB};
+    const char32_t key = ExtendedCharTable::instance.createExtendedChar(chars, 3);
+    QVERIFY(key != 0);
+
+    ushort length = 0;
+    const char32_t *stored = ExtendedCharTable::instance.lookupExtendedChar(key, length);
+    QVERIFY(stored != nullptr);
+    QCOMPARE(length, ushort(3));
+    QVERIFY(std::equal(chars, chars + 3, stored));
+}
+
+void CharacterTest::testExtendedCharDeduplication()
+{
+    const char32_t a[] = {U'e', 0x0301};
+    const char32_t b[] = {U'e', 0x0300};
+
+    const uint sizeBefore = ExtendedCharTable::instance.size();
+    const char32_t keyA = ExtendedCharTable::instance.createExtendedChar(a, 2);
+    const char32_t keyB = ExtendedCharTable::instance.createExtendedChar(b, 2);
+    QVERIFY(keyA != keyB);
+
+    // interning the same sequence again neither allocates nor changes the key
+    QCOMPARE(ExtendedCharTable::instance.createExtendedChar(a, 2), keyA);
+    QCOMPARE(ExtendedCharTable::instance.createExtendedChar(b, 2), keyB);
+    QCOMPARE(ExtendedCharTable::instance.size(), sizeBefore + 2);
+
+    // a prefix is a different sequence
+    const char32_t prefix[] = {U'e'};
+    QVERIFY(ExtendedCharTable::instance.createExtendedChar(prefix, 1) != keyA);
+}
+
+void CharacterTest::testExtendedCharInvalidKey()
+{
+    ushort length = 42;
+    QVERIFY(ExtendedCharTable::instance.lookupExtendedChar(0, length) == nullptr);
+    QCOMPARE(length, ushort(0));
+
+    length = 42;
+    QVERIFY(ExtendedCharTable::instance.lookupExtendedChar(ExtendedCharTable::MaxEntries + 1, length) == nullptr);
+    QCOMPARE(length, ushort(0));
+}
+
+void CharacterTest::testExtendedCharStableStorage()
+{
+    const char32_t first[] = {0x1F44D, 0x1F3FD};
+    const char32_t firstKey = ExtendedCharTable::instance.createExtendedChar(first, 2);
+    ushort length = 0;
+    const char32_t *firstStored = ExtendedCharTable::instance.lookupExtendedChar(firstKey, length);
+
+    // enough sequences to spill over several entry pages, arena blocks and index growths
+    for (char32_t i = 0; i < 20000; ++i) {
+        const char32_t chars[] = {U'a' + (i % 26), 0x0300 + (i % 0x70), 0x10000 + i};
+        QVERIFY(ExtendedCharTable::instance.createExtendedChar(chars, 3) != 0);
+    }
+
+    // earlier keys and pointers are still valid
+    QCOMPARE(ExtendedCharTable::instance.lookupExtendedChar(firstKey, length), firstStored);
+    QCOMPARE(length, ushort(2));
+    QCOMPARE(ExtendedCharTable::instance.createExtendedChar(first, 2), firstKey);
+}
+
+void CharacterTest::testExtendedCharConcurrentLookup()
+{
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+
+    // readers look up every published key while the writer keeps adding
+    std::thread reader([&done, &mismatches]() {
+        while (!done.load()) {
+            const uint count = ExtendedCharTable::instance.size();
+            for (uint key = 1; key <= count; ++key) {
+                ushort length = 0;
+                if (ExtendedCharTable::instance.lookupExtendedChar(key, length) == nullptr || length == 0) {
+                    mismatches.fetch_add(1);
+                }
+            }
+        }
+    });
+
+    for (char32_t i = 0; i < 5000; ++i) {
+        const char32_t chars[] = {0x1F600 + (i % 80), 0x200D, 0x20000 + i};
+        ExtendedCharTable::instance.createExtendedChar(chars, 3);
+    }
+    done.store(true);
+    reader.join();
+
+    QCOMPARE(mismatches.load(), 0);
+}
+
+void CharacterTest::testExtendedCharReclaim()
+{
+    // room for 7 keys
+    ExtendedCharTable table(8);
+    char32_t keys[7];
+    for (char32_t i = 0; i < 7; ++i) {
+        const char32_t chars[] = {U'a' + i, 0x0301};
+        keys[i] = table.createExtendedChar(chars, 2);
+        QVERIFY(keys[i] != 0);
+    }
+    const char32_t extra[] = {U'z', 0x0301, 0x0302};
+    QCOMPARE(table.createExtendedChar(extra, 3), char32_t(0));
+
+    // the cells still use the first and the last sequence
+    int sourceCalls = 0;
+    const int owner = 0;
+    table.addKeySource(&owner, [&](QSet<uint> &usedKeys) {
+        ++sourceCalls;
+        usedKeys << keys[0] << keys[6];
+    });
+    ushort length = 0;
+    const char32_t *freedRecord = table.lookupExtendedChar(keys[2], length);
+    QCOMPARE(table.reclaimUnused(), 5u);
+    QCOMPARE(table.size(), 2u);
+
+    const char32_t *stored = table.lookupExtendedChar(keys[6], length);
+    QCOMPARE(length, ushort(2));
+    QCOMPARE(stored[0], U'g');
+    QVERIFY(table.lookupExtendedChar(keys[1], length) == nullptr);
+    QCOMPARE(length, ushort(0));
+
+    // freed keys are handed out again, lowest first
+    QCOMPARE(table.createExtendedChar(extra, 3), keys[1]);
+    stored = table.lookupExtendedChar(keys[1], length);
+    QCOMPARE(length, ushort(3));
+    QCOMPARE(stored[0], U'z');
+    // the index forgot the freed sequences and still finds the others
+    const char32_t freed[] = {U'b', 0x0301};
+    QCOMPARE(table.createExtendedChar(freed, 2), keys[2]);
+    // a reader still holding the freed record reads what it held
+    QCOMPARE(freedRecord[0], U'c');
+    const char32_t kept[] = {U'a', 0x0301};
+    QCOMPARE(table.createExtendedChar(kept, 2), keys[0]);
+
+    // with keys to spare the sources are not asked
+    QCOMPARE(table.reclaimUnused(), 0u);
+    QCOMPARE(sourceCalls, 1);
+
+    table.removeKeySource(&owner);
+}
+
+void CharacterTest::testStyleTableRoundTrip()
+{
+    CharacterStyleTable table;
+    const Character chars[] = {
+        Character(),
+        Character(U'x', CharacterColor(COLOR_SPACE_RGB, 0x102030), CharacterColor(COLOR_SPACE_256, 200), RE_BOLD | RE_ITALIC, EF_REAL | EF_ASCII_WORD),
+        Character(0x1F600, CharacterColor(COLOR_SPACE_SYSTEM, 3), CharacterColor(COLOR_SPACE_DEFAULT, 1), RE_UNDERLINE_DOUBLE * RE_UNDERLINE_BIT, EF_UNREAL),
+    };
+
+    for (const Character &c : chars) {
+        const Character unpacked = table.character(table.pack(c));
+        QCOMPARE(unpacked, c);
+        QCOMPARE(unpacked.flags, c.flags);
+    }
+}
+
+void CharacterTest::testStyleTableDeduplication()
+{
+    CharacterStyleTable table;
+    const auto screen = makeScreen();
+    std::vector<PackedCharacter> packed(screen.size());
+    table.pack(screen.data(), int(screen.size()), packed.data());
+
+    QCOMPARE(table.size(), 12);
+    for (size_t i = 0; i < screen.size(); ++i) {
+        QCOMPARE(packed[i] == packed[0], screen[i] == screen[0] && screen[i].flags == screen[0].flags);
+    }
+
+    // the extra flags are part of the style
+    Character unreal = screen[0];
+    unreal.flags = EF_UNREAL;
+    QVERIFY(table.pack(unreal) != packed[0]);
+    QCOMPARE(table.size(), 13);
+}
+
+void CharacterTest::testStyleTableCompact()
+{
+    CharacterStyleTable table;
+    std::vector<Character> chars;
+    for (int i = 0; i < 1000; ++i) {
+        chars.push_back(Character(U'a', CharacterColor(COLOR_SPACE_RGB, i)));
+    }
+    std::vector<PackedCharacter> packed(chars.size());
+    table.pack(chars.data(), int(chars.size()), packed.data());
+    QCOMPARE(table.size(), 1000);
+
+    // only the last ten cells are still around
+    std::vector<PackedCharacter> live(packed.end() - 10, packed.end());
+    table.compact(live.begin(), live.end());
+    QCOMPARE(table.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(table.character(live[i]), chars[990 + i]);
+    }
+    QCOMPARE(table.pack(chars[995]), live[5]);
+}
+
+void CharacterTest::benchmarkScreenCopyCompareCharacter()
+{
+    const auto screen = makeScreen();
+    std::vector<Character> image(screen.size());
+    int changed = 0;
+
+    QBENCHMARK {
+        // what TerminalDisplay::updateImage() does per frame
+        changed = 0;
+        for (size_t i = 0; i < screen.size(); ++i) {
+            changed += image[i] != screen[i];
+        }
+        std::copy(screen.begin(), screen.end(), image.begin());
+    }
+    QCOMPARE(changed, 0);
+    qDebug() << "300x100 screen of Character:" << screen.size() * sizeof(Character) << "bytes";
+}
+
+void CharacterTest::benchmarkScreenCopyCompareStyleTable()
+{
+    const auto screen = makeScreen();
+    CharacterStyleTable table;
+    std::vector<PackedCharacter> packedScreen(screen.size());
+    table.pack(screen.data(), int(screen.size()), packedScreen.data());
+    std::vector<PackedCharacter> image(screen.size());
+    int changed = 0;
+
+    QBENCHMARK {
+        changed = 0;
+        for (size_t i = 0; i < packedScreen.size(); ++i) {
+            changed += image[i] != packedScreen[i];
+        }
+        std::copy(packedScreen.begin(), packedScreen.end(), image.begin());
+    }
+    QCOMPARE(changed, 0);
+    qDebug() << "300x100 screen of PackedCharacter:" << packedScreen.size() * sizeof(PackedCharacter) + table.memoryUsage() << "bytes";
+}
 
 QTEST_GUILESS_MAIN(Konsole::CharacterTest)
 
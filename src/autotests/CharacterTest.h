@@ -15,6 +15,17 @@ class CharacterTest : public QObject
     Q_OBJECT
 
 private Q_SLOTS:
+    void testExtendedCharRoundTrip();
+    void testExtendedCharDeduplication();
+    void testExtendedCharInvalidKey();
+    void testExtendedCharStableStorage();
+    void testExtendedCharConcurrentLookup();
+    void testExtendedCharReclaim();
+    void testStyleTableRoundTrip();
+    void testStyleTableDeduplication();
+    void testStyleTableCompact();
+    void benchmarkScreenCopyCompareCharacter();
+    void benchmarkScreenCopyCompareStyleTable();
 };
 
 }
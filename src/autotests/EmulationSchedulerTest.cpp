@@ -0,0 +1,252 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "EmulationSchedulerTest.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QTest>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Konsole
+#include "../Emulation.h"
+#include "../decoders/PlainTextDecoder.h"
+#include "../session/EmulationScheduler.h"
+#include "../session/Session.h"
+
+using namespace Konsole;
+
+namespace
+{
+// A session whose output comes from memory instead of a pty
+class StreamingSession : public Session
+{
+public:
+    explicit StreamingSession(bool onWorker = true)
+        : _onWorker(onWorker)
+    {
+    }
+
+    void feed(const QByteArray &output)
+    {
+        _output += output;
+        EmulationScheduler::instance()->schedule(this);
+    }
+
+    qsizetype parsedLength() const
+    {
+        return _offset;
+    }
+
+    bool hasPendingOutput() const override
+    {
+        return _offset < _output.size();
+    }
+
+    qsizetype parsePendingOutput(qsizetype maxLength) override
+    {
+        parsing = true;
+        if (EmulationScheduler::isParsing()) {
+            parsedOnWorker = true;
+        } else {
+            parsedOnGuiThread = true;
+        }
+        const qsizetype length = std::min(maxLength, _output.size() - _offset);
+        emulation()->receiveData(_output.constData() + _offset, static_cast<int>(length));
+        _offset += length;
+        if (onParse) {
+            onParse();
+        }
+        parsing = false;
+        return length;
+    }
+
+    bool canParseOnWorkerThread() const override
+    {
+        return _onWorker;
+    }
+
+    std::function<void()> onParse;
+    std::atomic<bool> parsing = false;
+    std::atomic<bool> parsedOnWorker = false;
+    std::atomic<bool> parsedOnGuiThread = false;
+
+private:
+    bool _onWorker;
+    QByteArray _output;
+    qsizetype _offset = 0;
+};
+
+QByteArray makeOutput(qsizetype size, int seed)
+{
+    QByteArray output;
+    output.reserve(size + 128);
+    for (int line = 0; output.size() < size; line++) {
+        output += "\033[3" + QByteArray::number(line % 8) + "mtab " + QByteArray::number(seed) + " line " + QByteArray::number(line)
+            + "\033[0m and some more text to fill it\r\n";
+    }
+    return output;
+}
+
+QString screenText(Session *session)
+{
+    QString text;
+    QTextStream stream(&text);
+    PlainTextDecoder decoder;
+    decoder.begin(&stream);
+    Emulation *emulation = session->emulation();
+    emulation->writeToStream(&decoder, 0, emulation->lineCount() - 1);
+    decoder.end();
+    return text;
+}
+}
+
+void EmulationSchedulerTest::testRunOnGuiThread()
+{
+    QVERIFY(!EmulationScheduler::isParsing());
+
+    bool ran = false;
+    EmulationScheduler::runOnGuiThread([&ran]() {
+        ran = true;
+    });
+    QVERIFY(ran);
+}
+
+void EmulationSchedulerTest::testParsesScheduledSessions()
+{
+    std::vector<std::unique_ptr<StreamingSession>> sessions;
+    for (int i = 0; i < 4; i++) {
+        auto session = std::make_unique<StreamingSession>();
+        session->feed(makeOutput(64 * 1024, i) + "done " + QByteArray::number(i) + "\r\n");
+        sessions.push_back(std::move(session));
+    }
+
+    for (const auto &session : sessions) {
+        QTRY_VERIFY(!session->hasPendingOutput());
+    }
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(sessions[i]->parsedOnWorker);
+        QVERIFY(!sessions[i]->parsedOnGuiThread);
+        QVERIFY(screenText(sessions[i].get()).contains(QStringLiteral("done %1").arg(i)));
+    }
+}
+
+void EmulationSchedulerTest::testDeferredCallsAfterTurn()
+{
+    StreamingSession session;
+    QThread *ranOn = nullptr;
+    bool ranWhileParsing = true;
+    session.onParse = [&]() {
+        EmulationScheduler::runOnGuiThread([&]() {
+            ranOn = QThread::currentThread();
+            ranWhileParsing = session.parsing;
+        });
+    };
+    session.feed(QByteArrayLiteral("hello\r\n"));
+
+    EmulationScheduler::instance()->runTurn();
+    QCOMPARE(ranOn, QCoreApplication::instance()->thread());
+    QVERIFY(!ranWhileParsing);
+}
+
+void EmulationSchedulerTest::testGuiThreadSessions()
+{
+    StreamingSession session(false);
+    session.feed(QByteArrayLiteral("on the GUI thread\r\n"));
+
+    QTRY_VERIFY(!session.hasPendingOutput());
+    QVERIFY(session.parsedOnGuiThread);
+    QVERIFY(!session.parsedOnWorker);
+    QVERIFY(screenText(&session).contains(QStringLiteral("on the GUI thread")));
+}
+
+void EmulationSchedulerTest::testTurnBudget()
+{
+    StreamingSession session;
+    session.feed(makeOutput(32 * 1024 * 1024, 0));
+
+    // One turn parses a part and leaves the rest for the next ones
+    EmulationScheduler::instance()->runTurn();
+    QVERIFY(session.parsedLength() >= EmulationScheduler::MaxParseLength);
+    QVERIFY(session.hasPendingOutput());
+
+    QTRY_VERIFY_WITH_TIMEOUT(!session.hasPendingOutput(), 60000);
+}
+
+void EmulationSchedulerTest::testDestroyedSessionSkipped()
+{
+    auto session = std::make_unique<StreamingSession>();
+    session->feed(QByteArrayLiteral("gone\r\n"));
+    session.reset();
+
+    EmulationScheduler::instance()->runTurn();
+}
+
+void EmulationSchedulerTest::benchmarkManyStreamingTabs()
+{
+    constexpr int Tabs = 30;
+    constexpr qsizetype OutputPerTab = 1024 * 1024;
+    const QByteArray output = makeOutput(OutputPerTab, 0);
+
+    for (const bool threaded : {false, true}) {
+        std::vector<std::unique_ptr<StreamingSession>> sessions;
+        for (int i = 0; i < Tabs; i++) {
+            sessions.push_back(std::make_unique<StreamingSession>(threaded));
+        }
+
+        // Stands in for input: how long a posted event waits behind the parsing
+        QElapsedTimer clock;
+        clock.start();
+        std::vector<qint64> latencies;
+        QTimer probe;
+        probe.setInterval(5);
+        connect(&probe, &QTimer::timeout, this, [&]() {
+            const qint64 posted = clock.nsecsElapsed();
+            QMetaObject::invokeMethod(
+                this,
+                [&latencies, &clock, posted]() {
+                    latencies.push_back((clock.nsecsElapsed() - posted) / 1000);
+                },
+                Qt::QueuedConnection);
+        });
+        probe.start();
+
+        for (const auto &session : sessions) {
+            session->feed(output);
+        }
+        const auto drained = [&sessions]() {
+            return std::none_of(sessions.cbegin(), sessions.cend(), [](const auto &session) {
+                return session->hasPendingOutput();
+            });
+        };
+        QTRY_VERIFY_WITH_TIMEOUT(drained(), 120000);
+        const qint64 elapsed = std::max<qint64>(1, clock.elapsed());
+        probe.stop();
+        QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+
+        const char *mode = threaded ? "Worker threads:" : "GUI thread:";
+        qDebug() << mode << Tabs << "streaming tabs," << Tabs * OutputPerTab / 1048576.0 / (elapsed / 1000.0) << "MiB/s parsed";
+        if (!latencies.empty()) {
+            std::sort(latencies.begin(), latencies.end());
+            qDebug() << mode << "event loop latency in us, median:" << latencies[latencies.size() / 2] << "95%:" << latencies[latencies.size() * 95 / 100]
+                     << "max:" << latencies.back();
+        }
+    }
+}
+
+QTEST_MAIN(EmulationSchedulerTest)
+
+#include "EmulationSchedulerTest.moc"
@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef EMULATIONSCHEDULERTEST_H
+#define EMULATIONSCHEDULERTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class EmulationSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRunOnGuiThread();
+    void testParsesScheduledSessions();
+    void testDeferredCallsAfterTurn();
+    void testGuiThreadSessions();
+    void testTurnBudget();
+    void testDestroyedSessionSkipped();
+    void benchmarkManyStreamingTabs();
+};
+
+}
+
+#endif // EMULATIONSCHEDULERTEST_H
@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ForegroundProcessMonitorTest.h"
+
+// Qt
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+// std
+#include <memory>
+
+// Konsole
+#include "../Pty.h"
+#include "../session/ForegroundProcessMonitor.h"
+
+using namespace Konsole;
+
+namespace
+{
+// Runs @p script in a shell on a new pty, in @p dir
+std::unique_ptr<Pty> startShell(const QString &script, const QString &dir)
+{
+    auto pty = std::make_unique<Pty>();
+    pty->setInitialWorkingDirectory(dir);
+    const QString program = QStringLiteral("sh");
+    if (pty->start(program, {program, QStringLiteral("-c"), script}, QStringList()) != 0) {
+        return nullptr;
+    }
+    return pty;
+}
+}
+
+void ForegroundProcessMonitorTest::testUnwatched()
+{
+    ForegroundProcessMonitor monitor;
+    Pty pty;
+
+    QVERIFY(!monitor.isWatching(&pty));
+    QCOMPARE(monitor.generation(&pty), quint64(0));
+    QCOMPARE(monitor.foregroundProcessGroup(&pty), -1);
+    QVERIFY(monitor.currentDir(&pty).isEmpty());
+
+    // Nothing to check
+    QSignalSpy changed(&monitor, &ForegroundProcessMonitor::changed);
+    monitor.poke(&pty);
+    monitor.check(&pty);
+    QCOMPARE(changed.count(), 0);
+}
+
+void ForegroundProcessMonitorTest::testFirstCheck()
+{
+    QTemporaryDir dir;
+    auto pty = startShell(QStringLiteral("sleep 30"), dir.path());
+    QVERIFY(pty);
+
+    ForegroundProcessMonitor monitor;
+    QSignalSpy changed(&monitor, &ForegroundProcessMonitor::changed);
+    monitor.watch(pty.get());
+    QCOMPARE(monitor.generation(pty.get()), quint64(1));
+
+    QVERIFY(changed.wait());
+    QCOMPARE(changed.first().first().value<Pty *>(), pty.get());
+    QVERIFY(monitor.generation(pty.get()) > 1);
+    if (monitor.foregroundProcessGroup(pty.get()) <= 0) {
+        // See PtyTest::testRunProgram
+        QSKIP("No foreground process group for the pty here");
+    }
+#ifdef Q_OS_LINUX
+    QCOMPARE(monitor.currentDir(pty.get()), QFileInfo(dir.path()).canonicalFilePath());
+#endif
+}
+
+void ForegroundProcessMonitorTest::testPokesAreCoalesced()
+{
+    QTemporaryDir dir;
+    auto pty = startShell(QStringLiteral("sleep 30"), dir.path());
+    QVERIFY(pty);
+
+    ForegroundProcessMonitor monitor;
+    monitor.watch(pty.get());
+    // The first check and the one after it, once the process has settled
+    QTest::qWait(ForegroundProcessMonitor::CheckDelayMs + ForegroundProcessMonitor::SettleDelayMs + 200);
+
+#ifndef Q_OS_LINUX
+    QSKIP("Every check counts as a change without /proc");
+#endif
+    const quint64 generation = monitor.generation(pty.get());
+    QSignalSpy changed(&monitor, &ForegroundProcessMonitor::changed);
+    for (int i = 0; i < 100; i++) {
+        monitor.poke(pty.get());
+    }
+    QTest::qWait(ForegroundProcessMonitor::MinCheckIntervalMs + 200);
+
+    // Nothing happened in the terminal, so nothing is reported
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(monitor.generation(pty.get()), generation);
+}
+
+void ForegroundProcessMonitorTest::testDirectoryChange()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("The working directory is only followed through /proc");
+#endif
+    QTemporaryDir dir;
+    QTemporaryDir other;
+    const QString script = QStringLiteral("sleep 1; cd '%1' && exec sleep 30").arg(other.path());
+    auto pty = startShell(script, dir.path());
+    QVERIFY(pty);
+
+    ForegroundProcessMonitor monitor;
+    monitor.watch(pty.get());
+    QTRY_COMPARE(monitor.currentDir(pty.get()), QFileInfo(dir.path()).canonicalFilePath());
+    if (monitor.foregroundProcessGroup(pty.get()) <= 0) {
+        QSKIP("No foreground process group for the pty here");
+    }
+
+    // Activity in the terminal after the shell changed directory
+    QTest::qWait(1500);
+    const quint64 generation = monitor.generation(pty.get());
+    monitor.poke(pty.get());
+    QTRY_COMPARE(monitor.currentDir(pty.get()), QFileInfo(other.path()).canonicalFilePath());
+    QVERIFY(monitor.generation(pty.get()) > generation);
+}
+
+void ForegroundProcessMonitorTest::testUnwatchOnDestroy()
+{
+    ForegroundProcessMonitor monitor;
+    auto pty = std::make_unique<Pty>();
+    Pty *raw = pty.get();
+
+    monitor.watch(raw);
+    QVERIFY(monitor.isWatching(raw));
+    pty.reset();
+    QVERIFY(!monitor.isWatching(raw));
+    QCOMPARE(monitor.generation(raw), quint64(0));
+}
+
+QTEST_GUILESS_MAIN(ForegroundProcessMonitorTest)
+
+#include "ForegroundProcessMonitorTest.moc"
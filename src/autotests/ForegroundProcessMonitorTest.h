@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef FOREGROUNDPROCESSMONITORTEST_H
+#define FOREGROUNDPROCESSMONITORTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class ForegroundProcessMonitorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testUnwatched();
+    void testFirstCheck();
+    void testPokesAreCoalesced();
+    void testDirectoryChange();
+    void testUnwatchOnDestroy();
+};
+
+}
+
+#endif // FOREGROUNDPROCESSMONITORTEST_H
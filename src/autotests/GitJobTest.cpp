@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "GitJobTest.h"
+
+// Qt
+#include <QDir>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsolai
+#include "../claude/GitJob.h"
+#include "../claude/ProjectIndex.h"
+
+using namespace Konsolai;
+
+namespace
+{
+bool hasGit()
+{
+    return !QStandardPaths::findExecutable(QStringLiteral("git")).isEmpty();
+}
+}
+
+void GitJobTest::testInitRepository()
+{
+    if (!hasGit()) {
+        QSKIP("git not available");
+    }
+    QTemporaryDir dir;
+    GitJob *job = GitJob::initRepository(dir.path(), QStringLiteral("git@example.com:me/project.git"));
+    QSignalSpy progress(job, &GitJob::progress);
+    QSignalSpy finished(job, &GitJob::finished);
+    job->start();
+
+    QVERIFY(finished.wait(10000));
+    QCOMPARE(finished.first().at(0).toBool(), true);
+    QCOMPARE(progress.count(), 2);
+    QCOMPARE(progress.at(1).at(0).toInt(), 1);
+    QCOMPARE(progress.at(1).at(1).toInt(), 2);
+    QVERIFY(QFileInfo(dir.filePath(QStringLiteral(".git"))).isDir());
+    delete job;
+}
+
+void GitJobTest::testAddWorktree()
+{
+    if (!hasGit()) {
+        QSKIP("git not available");
+    }
+    QTemporaryDir dir;
+    const QString repo = dir.filePath(QStringLiteral("repo"));
+    QDir().mkpath(repo);
+
+    // A repository with one commit, so there is something to branch from
+    GitJob setup(repo);
+    setup.addStep(QStringLiteral("init"), {QStringLiteral("init"), QStringLiteral("-q")});
+    setup.addStep(QStringLiteral("commit"),
+                  {QStringLiteral("-c"),
+                   QStringLiteral("user.name=Test"),
+                   QStringLiteral("-c"),
+                   QStringLiteral("user.email=test@example.com"),
+                   QStringLiteral("commit"),
+                   QStringLiteral("-q"),
+                   QStringLiteral("--allow-empty"),
+                   QStringLiteral("-m"),
+                   QStringLiteral("initial")});
+    QSignalSpy setupDone(&setup, &GitJob::finished);
+    setup.start();
+    QVERIFY(setupDone.wait(10000));
+    QVERIFY(setupDone.first().at(0).toBool());
+
+    const QString worktree = dir.filePath(QStringLiteral("repo-feature"));
+    GitJob *job = GitJob::addWorktree(repo, worktree, QStringLiteral("feature/x"));
+    QSignalSpy finished(job, &GitJob::finished);
+    job->start();
+    QVERIFY(finished.wait(10000));
+    QVERIFY2(finished.first().at(0).toBool(), qPrintable(finished.first().at(1).toString()));
+    // The branch didn't exist, so the check failed and -b was used
+    QVERIFY(job->exitCodeOf(0) != 0);
+    QCOMPARE(job->exitCodeOf(1), 0);
+    delete job;
+
+    const QList<IndexedProject> found = ProjectIndex::scan({dir.path()}, 1);
+    QCOMPARE(found.size(), 2);
+    for (const IndexedProject &project : found) {
+        QCOMPARE(QFileInfo(project.repoRoot).canonicalFilePath(), QFileInfo(repo).canonicalFilePath());
+    }
+}
+
+void GitJobTest::testFailure()
+{
+    if (!hasGit()) {
+        QSKIP("git not available");
+    }
+    QTemporaryDir dir;
+    GitJob job(dir.path());
+    job.addStep(QStringLiteral("status"), {QStringLiteral("-C"), dir.filePath(QStringLiteral("missing")), QStringLiteral("status")});
+    job.addStep(QStringLiteral("never"), {QStringLiteral("init")});
+    QSignalSpy progress(&job, &GitJob::progress);
+    QSignalSpy finished(&job, &GitJob::finished);
+    job.start();
+
+    QVERIFY(finished.wait(10000));
+    QCOMPARE(finished.first().at(0).toBool(), false);
+    QVERIFY(!finished.first().at(1).toString().isEmpty());
+    QCOMPARE(progress.count(), 1);
+    QVERIFY(!QFileInfo(dir.filePath(QStringLiteral(".git"))).exists());
+}
+
+QTEST_GUILESS_MAIN(Konsolai::GitJobTest)
+
+#include "GitJobTest.moc"
@@ -0,0 +1,26 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef GITJOBTEST_H
+#define GITJOBTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class GitJobTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testInitRepository();
+    void testAddWorktree();
+    void testFailure();
+};
+
+}
+
+#endif // GITJOBTEST_H
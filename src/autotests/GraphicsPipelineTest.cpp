@@ -0,0 +1,307 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "GraphicsPipelineTest.h"
+
+// Qt
+#include <QBuffer>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QtMath>
+#include <QTest>
+
+// Konsole
+#include "../Base64Decoder.h"
+#include "../GraphicsImageCache.h"
+#include "../Screen.h"
+#include "../ScreenWindow.h"
+#include "../Vt102Emulation.h"
+#include "../history/compact/CompactHistoryType.h"
+#include "../terminalDisplay/TerminalDisplay.h"
+#include "../terminalDisplay/TerminalFonts.h"
+
+using namespace Konsole;
+
+namespace
+{
+QByteArray toPng(const QImage &image)
+{
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return png;
+}
+
+// A frame of a line plot, as plotting tools stream them
+QImage plotFrame(int width, int height, int frame)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setPen(QPen(Qt::blue, 2));
+    QPointF previous(0, height / 2);
+    for (int x = 1; x < width; x += 4) {
+        const QPointF point(x, height / 2 + (height / 3) * qSin((x + frame * 8) / 40.0));
+        painter.drawLine(previous, point);
+        previous = point;
+    }
+    return image;
+}
+
+QByteArray kittyImage(const QByteArray &png, const QByteArray &keys = QByteArray())
+{
+    return QByteArrayLiteral("\033_Gf=100,a=T,q=2") + keys + ';' + png.toBase64() + QByteArrayLiteral("\033\\");
+}
+
+struct Terminal {
+    Terminal()
+    {
+        emulation.reset();
+        emulation.setCodec(Vt102Emulation::Utf8Codec);
+        emulation.setCurrentTerminalDisplay(&display);
+        emulation.setHistory(CompactHistoryType(1000));
+        window = emulation.createWindow();
+        emulation.setImageSize(40, 120);
+    }
+
+    void receive(const QByteArray &data)
+    {
+        emulation.receiveData(data.constData(), data.size());
+    }
+
+    Screen *screen() const
+    {
+        return window->screen();
+    }
+
+    QVector<TerminalGraphicsPlacement_t *> placements() const
+    {
+        QVector<TerminalGraphicsPlacement_t *> result;
+        for (unsigned int i = 0; TerminalGraphicsPlacement_t *placement = screen()->getGraphicsPlacement(i); ++i) {
+            result.append(placement);
+        }
+        return result;
+    }
+
+    TerminalDisplay display{nullptr};
+    Vt102Emulation emulation;
+    ScreenWindow *window = nullptr;
+};
+}
+
+void GraphicsPipelineTest::initTestCase()
+{
+    // The cache is created by whoever needs it first, which may be a
+    // terminal parsed on a worker thread
+    QImage source(16, 16, QImage::Format_RGB32);
+    source.fill(Qt::green);
+    GraphicsImage image;
+    std::unique_ptr<QThread> worker(QThread::create([&image, png = toPng(source)]() {
+        image = GraphicsImageCache::instance()->decode(png);
+    }));
+    worker->start();
+    QVERIFY(worker->wait(5000));
+
+    QCOMPARE(GraphicsImageCache::instance()->thread(), QCoreApplication::instance()->thread());
+    QVERIFY(!image.isNull());
+    QTRY_VERIFY(image.isReady());
+    QCOMPARE(QColor(image.image().pixel(8, 8)), QColor(Qt::green));
+}
+
+void GraphicsPipelineTest::init()
+{
+    GraphicsImageCache::instance()->waitForDone();
+    GraphicsImageCache::instance()->clear();
+}
+
+void GraphicsPipelineTest::testBase64Decoder_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("chunk");
+    QTest::addColumn<bool>("noise");
+
+    QTest::newRow("empty") << 0 << 1 << false;
+    QTest::newRow("padding") << 7 << 3 << false;
+    QTest::newRow("one character at a time") << 301 << 1 << false;
+    QTest::newRow("uneven chunks") << 4099 << 13 << false;
+    QTest::newRow("large chunks") << 100000 << 4096 << false;
+    QTest::newRow("line breaks and stray characters") << 5000 << 57 << true;
+}
+
+void GraphicsPipelineTest::testBase64Decoder()
+{
+    QFETCH(int, size);
+    QFETCH(int, chunk);
+    QFETCH(bool, noise);
+
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator random(size);
+    for (char &byte : data) {
+        byte = char(random.bounded(256));
+    }
+
+    QList<char32_t> encoded;
+    const QByteArray base64 = data.toBase64();
+    for (int i = 0; i < base64.size(); ++i) {
+        encoded.append(char32_t(base64.at(i)));
+        if (noise && i % 76 == 75) {
+            encoded.append(U'\n');
+            encoded.append(U'é');
+        }
+    }
+
+    Base64Decoder decoder;
+    QByteArray decoded;
+    for (int i = 0; i < encoded.size(); i += chunk) {
+        decoder.decode(encoded.constData() + i, qMin(chunk, int(encoded.size()) - i), decoded);
+    }
+    QCOMPARE(decoded, data);
+}
+
+void GraphicsPipelineTest::testKittyImageIsPlacedBeforeDecoding()
+{
+    Terminal terminal;
+    const int fontHeight = terminal.display.terminalFont()->fontHeight();
+
+    QImage source(64, 3 * fontHeight, QImage::Format_ARGB32);
+    source.fill(Qt::red);
+    terminal.receive(kittyImage(toPng(source)));
+
+    // laid out and the cursor moved from the header alone
+    const auto placements = terminal.placements();
+    QCOMPARE(placements.size(), 1);
+    QVERIFY(!placements.at(0)->image.isReady());
+    QCOMPARE(placements.at(0)->image.size(), source.size());
+    QCOMPARE(placements.at(0)->rows, 3);
+    QCOMPARE(terminal.screen()->getCursorY(), 2);
+
+    GraphicsImageCache::instance()->waitForDone();
+    const QImage pixels = placements.at(0)->image.image();
+    QVERIFY(placements.at(0)->image.isReady());
+    QCOMPARE(pixels.size(), source.size());
+    QCOMPARE(pixels.format(), QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE(QColor(pixels.pixel(10, 10)), QColor(Qt::red));
+}
+
+void GraphicsPipelineTest::testRepeatedImagesShareMemory()
+{
+    Terminal terminal;
+
+    const QByteArray png = toPng(plotFrame(200, 100, 0));
+    terminal.receive(kittyImage(png, QByteArrayLiteral(",i=1")));
+    terminal.receive(kittyImage(png, QByteArrayLiteral(",i=2")));
+    terminal.receive(kittyImage(toPng(plotFrame(200, 100, 1)), QByteArrayLiteral(",i=3")));
+    GraphicsImageCache::instance()->waitForDone();
+
+    const auto placements = terminal.placements();
+    QCOMPARE(placements.size(), 3);
+    QVERIFY(placements.at(0)->image == placements.at(1)->image);
+    QVERIFY(!(placements.at(0)->image == placements.at(2)->image));
+    QCOMPARE(placements.at(0)->image.image().constBits(), placements.at(1)->image.image().constBits());
+    QCOMPARE(GraphicsImageCache::instance()->count(), 2);
+
+    // placing a stored image by its id reuses it as well
+    terminal.receive(QByteArrayLiteral("\033_Ga=p,i=1,p=7,q=2\033\\"));
+    QVERIFY(terminal.placements().last()->image == placements.at(0)->image);
+}
+
+void GraphicsPipelineTest::testITermImageIsScaled()
+{
+    Terminal terminal;
+    const int fontWidth = terminal.display.terminalFont()->fontWidth();
+
+    // four cells wide, keeping the aspect ratio
+    const QByteArray png = toPng(plotFrame(400, 200, 0));
+    terminal.receive(QByteArrayLiteral("\033]1337;File=inline=1;width=4:") + png.toBase64() + QByteArrayLiteral("\a"));
+
+    const auto placements = terminal.placements();
+    QCOMPARE(placements.size(), 1);
+    QCOMPARE(placements.at(0)->source, TerminalGraphicsPlacement_t::iTerm);
+    QCOMPARE(placements.at(0)->image.size(), QSize(4 * fontWidth, 2 * fontWidth));
+
+    GraphicsImageCache::instance()->waitForDone();
+    QCOMPARE(placements.at(0)->image.image().size(), QSize(4 * fontWidth, 2 * fontWidth));
+}
+
+void GraphicsPipelineTest::testPlacementIndex()
+{
+    Terminal terminal;
+    const int fontHeight = terminal.display.terminalFont()->fontHeight();
+    const QByteArray image = kittyImage(toPng(plotFrame(32, fontHeight, 0)), QByteArrayLiteral(",C=1"));
+
+    // one image per row, the older ones scrolled into the history
+    for (int i = 0; i < 200; ++i) {
+        terminal.receive(image + QByteArrayLiteral("\r\n"));
+    }
+    QCOMPARE(terminal.placements().size(), 200);
+
+    QVector<TerminalGraphicsPlacement_t *> visible;
+    terminal.screen()->graphicsPlacementsInRows(0, terminal.screen()->getLines() - 1, visible);
+    QCOMPARE(visible.size(), terminal.screen()->getLines() - 1);
+    for (const TerminalGraphicsPlacement_t *placement : std::as_const(visible)) {
+        QVERIFY(placement->row >= 0);
+    }
+
+    terminal.screen()->graphicsPlacementsInRows(-100, -91, visible);
+    QCOMPARE(visible.size(), 10);
+    QCOMPARE(visible.first()->row, -100);
+
+    // scrolling moves them into other bands
+    terminal.receive(QByteArrayLiteral("\r\n\r\n\r\n"));
+    terminal.screen()->graphicsPlacementsInRows(-100, -91, visible);
+    QCOMPARE(visible.size(), 10);
+    QCOMPARE(visible.first()->row, -100);
+}
+
+void GraphicsPipelineTest::benchmarkLargeImages()
+{
+    Terminal terminal;
+
+    // photos pasted by an agent: 2048x1536, shown as kitty and iTerm images
+    QImage photo(2048, 1536, QImage::Format_RGB32);
+    QRandomGenerator random(1);
+    for (int y = 0; y < photo.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(photo.scanLine(y));
+        for (int x = 0; x < photo.width(); ++x) {
+            line[x] = qRgb(x / 8, y / 6, random.bounded(64));
+        }
+    }
+    const QByteArray png = toPng(photo);
+    const QByteArray kitty = kittyImage(png);
+    const QByteArray iterm = QByteArrayLiteral("\033]1337;File=inline=1;width=60:") + png.toBase64() + QByteArrayLiteral("\a");
+
+    QBENCHMARK {
+        GraphicsImageCache::instance()->clear();
+        terminal.receive(kitty);
+        terminal.receive(iterm);
+        GraphicsImageCache::instance()->waitForDone();
+    }
+}
+
+void GraphicsPipelineTest::benchmarkPlotAnimation()
+{
+    Terminal terminal;
+
+    // an animated plot redrawn in place, cycling through 30 frames
+    QList<QByteArray> frames;
+    for (int i = 0; i < 30; ++i) {
+        frames.append(kittyImage(toPng(plotFrame(800, 400, i)), QByteArrayLiteral(",i=1,p=1,C=1")));
+    }
+
+    QBENCHMARK {
+        for (const QByteArray &frame : std::as_const(frames)) {
+            terminal.receive(frame);
+        }
+        GraphicsImageCache::instance()->waitForDone();
+    }
+    QCOMPARE(terminal.placements().size(), 1);
+}
+
+QTEST_MAIN(GraphicsPipelineTest)
+
+#include "moc_GraphicsPipelineTest.cpp"
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef GRAPHICSPIPELINETEST_H
+#define GRAPHICSPIPELINETEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class GraphicsPipelineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testBase64Decoder_data();
+    void testBase64Decoder();
+    void testKittyImageIsPlacedBeforeDecoding();
+    void testRepeatedImagesShareMemory();
+    void testITermImageIsScaled();
+    void testPlacementIndex();
+
+    void benchmarkLargeImages();
+    void benchmarkPlotAnimation();
+};
+
+}
+
+#endif // GRAPHICSPIPELINETEST_H
@@ -11,6 +11,8 @@
 
 // Konsole
 #include "../Emulation.h"
+#include "../characters/CharacterStyleTable.h"
+#include "../session/ScrollbackBudget.h"
 #include "../session/Session.h"
 
 using namespace Konsole;
@@ -218,6 +220,128 @@ void HistoryTest::testHistoryTypeChange()
     QCOMPARE(historyScroll->getLines(), 0);
 }
 
+void HistoryTest::testHistoryMemoryUsage()
+{
+    std::unique_ptr<HistoryScroll> historyScroll(nullptr);
+
+    const char testString[] = "abcdefghijklmnopqrstuvwxyz1234567890";
+    const int testStringSize = sizeof(testString) / sizeof(char) - 1;
+    auto testImage = std::make_unique<Character[]>(testStringSize);
+    for (int i = 0; i < testStringSize; i++) {
+        testImage[i] = Character((uint)testString[i]);
+    }
+
+    // Compact keeps its cells in RAM
+    auto compactHistoryType = std::make_unique<CompactHistoryType>(100);
+    compactHistoryType->scroll(historyScroll);
+    QCOMPARE(historyScroll->memoryUsage(), size_t(0));
+
+    for (int i = 0; i < 10; i++) {
+        historyScroll->addCells(testImage.get(), testStringSize);
+        historyScroll->addLine();
+    }
+    // Cells share their style, so they take half the size of a Character
+    QVERIFY(historyScroll->memoryUsage() >= size_t(10 * testStringSize) * sizeof(PackedCharacter));
+    QVERIFY(historyScroll->memoryUsage() < size_t(10 * testStringSize) * sizeof(Character));
+
+    // File keeps them on disk
+    auto historyTypeFile = std::make_unique<HistoryTypeFile>();
+    historyTypeFile->scroll(historyScroll);
+    QCOMPARE(historyScroll->getLines(), 10);
+    QCOMPARE(historyScroll->memoryUsage(), size_t(0));
+}
+
+void HistoryTest::testCompactHistoryStyles()
+{
+    CompactHistoryScroll history(50);
+    Character line[80];
+
+    // a new color on every line, as a 24-bit color gradient would give
+    for (int l = 0; l < 20000; l++) {
+        for (int x = 0; x < 80; x++) {
+            line[x] = Character(U'a' + (x % 26), CharacterColor(COLOR_SPACE_RGB, l), CharacterColor(COLOR_SPACE_256, x), x % 2 ? RE_BOLD : RE_ITALIC);
+        }
+        history.addCells(line, 80);
+        history.addLine();
+    }
+
+    // the lines still held read back unchanged
+    QCOMPARE(history.getLines(), 50);
+    Character read[80];
+    history.getCells(49, 0, 80, read);
+    for (int x = 0; x < 80; x++) {
+        QCOMPARE(read[x], line[x]);
+    }
+    history.getCells(0, 0, 80, read);
+    QCOMPARE(read[3].foregroundColor, CharacterColor(COLOR_SPACE_RGB, 20000 - 50));
+
+    // and the styles of the lines gone were dropped
+    QVERIFY(history.memoryUsage() < size_t(2 * 1024 * 1024));
+}
+
+void HistoryTest::benchmarkCompactHistory()
+{
+    constexpr int lines = 100000;
+    constexpr int columns = 80;
+    Character line[columns];
+    for (int x = 0; x < columns; x++) {
+        line[x] = Character(U'a' + (x % 26), CharacterColor(COLOR_SPACE_SYSTEM, (x / 10) % 8));
+    }
+
+    CompactHistoryScroll history(lines);
+    QBENCHMARK_ONCE {
+        for (int l = 0; l < lines; l++) {
+            history.addCells(line, columns);
+            history.addLine();
+        }
+    }
+    qDebug() << "100k lines of history:" << history.memoryUsage() << "bytes, as Character:" << size_t(lines) * columns * sizeof(Character);
+    QVERIFY(history.memoryUsage() < size_t(lines) * columns * sizeof(Character) * 6 / 10);
+
+    Character read[columns];
+    QBENCHMARK {
+        for (int l = 0; l < lines; l += 100) {
+            history.getCells(l, 0, columns, read);
+        }
+    }
+    QCOMPARE(read[15], line[15]);
+}
+
+void HistoryTest::testScrollbackBudgetPlan()
+{
+    using Entry = ScrollbackBudget::Entry;
+
+    QVector<Entry> entries;
+    entries.append(Entry{400, ScrollbackBudget::Visible, 100}); // 0
+    entries.append(Entry{300, ScrollbackBudget::Background, 50}); // 1
+    entries.append(Entry{200, ScrollbackBudget::Background, 10}); // 2
+    entries.append(Entry{100, ScrollbackBudget::Detached, 90}); // 3
+    entries.append(Entry{0, ScrollbackBudget::Detached, 0}); // 4, nothing to reclaim
+
+    // within budget: nothing to do
+    QVERIFY(ScrollbackBudget::planReclaim(entries, 1000, 1000).isEmpty());
+
+    // detached first, then background least recently viewed first
+    QCOMPARE(ScrollbackBudget::planReclaim(entries, 1000, 850), QVector<int>({3, 2}));
+    QCOMPARE(ScrollbackBudget::planReclaim(entries, 1000, 500), QVector<int>({3, 2, 1}));
+
+    // visible sessions are never reclaimed, even when still over budget
+    QCOMPARE(ScrollbackBudget::planReclaim(entries, 1000, 0), QVector<int>({3, 2, 1}));
+}
+
+void HistoryTest::testScrollbackBudgetTrim()
+{
+    // half of the lines, but not below the minimum
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(10000, 20000), 5000);
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(1500, 20000), ScrollbackBudget::MinimumTrimLines);
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(10000, -1), 5000);
+
+    // limits are never raised or left as they are
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(500, 500), -1);
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(800, 1000), -1);
+    QCOMPARE(ScrollbackBudget::trimmedLineCount(4000, 3000), 2000);
+}
+
 QTEST_MAIN(HistoryTest)
 
 #include "moc_HistoryTest.cpp"
@@ -33,6 +33,11 @@ private Q_SLOTS:
     void testHistoryScroll();
     void testHistoryReflow();
     void testHistoryTypeChange();
+    void testHistoryMemoryUsage();
+    void testCompactHistoryStyles();
+    void benchmarkCompactHistory();
+    void testScrollbackBudgetPlan();
+    void testScrollbackBudgetTrim();
 
 private:
     static constexpr const char testString[] = "abcdefghijklmnopqrstuvwxyz1234567890";
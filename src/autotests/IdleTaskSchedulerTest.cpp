@@ -0,0 +1,206 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "IdleTaskSchedulerTest.h"
+
+// Qt
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+// Konsolai
+#include "../StartupTrace.h"
+#include "../claude/IdleTaskScheduler.h"
+
+using namespace Konsolai;
+
+void IdleTaskSchedulerTest::testHeldUntilReleased()
+{
+    IdleTaskScheduler scheduler;
+    QObject context;
+    int runs = 0;
+
+    IdleTaskScheduler::post(&context, "task", IdleTaskScheduler::Normal, [&runs]() {
+        ++runs;
+    });
+    QCOMPARE(scheduler.pendingCount(), 1);
+
+    // Nothing runs while the first terminal is still coming up
+    QTest::qWait(50);
+    QCOMPARE(runs, 0);
+
+    QSignalSpy drained(&scheduler, &IdleTaskScheduler::drained);
+    scheduler.release();
+    QVERIFY(drained.wait(1000));
+    QCOMPARE(runs, 1);
+    QCOMPARE(scheduler.pendingCount(), 0);
+}
+
+void IdleTaskSchedulerTest::testPriorityOrder()
+{
+    IdleTaskScheduler scheduler;
+    QObject context;
+    QStringList order;
+
+    IdleTaskScheduler::post(&context, "low", IdleTaskScheduler::Low, [&order]() {
+        order << QStringLiteral("low");
+    });
+    IdleTaskScheduler::post(&context, "normal1", IdleTaskScheduler::Normal, [&order]() {
+        order << QStringLiteral("normal1");
+    });
+    IdleTaskScheduler::post(&context, "high", IdleTaskScheduler::High, [&order]() {
+        order << QStringLiteral("high");
+    });
+    IdleTaskScheduler::post(&context, "normal2", IdleTaskScheduler::Normal, [&order]() {
+        order << QStringLiteral("normal2");
+    });
+
+    QSignalSpy drained(&scheduler, &IdleTaskScheduler::drained);
+    scheduler.release();
+    QVERIFY(drained.wait(1000));
+
+    const QStringList expected{QStringLiteral("high"), QStringLiteral("normal1"), QStringLiteral("normal2"), QStringLiteral("low")};
+    QCOMPARE(order, expected);
+}
+
+void IdleTaskSchedulerTest::testDestroyedContextSkipped()
+{
+    IdleTaskScheduler scheduler;
+    auto *context = new QObject;
+    QObject survivor;
+    int runs = 0;
+
+    IdleTaskScheduler::post(context, "dropped", IdleTaskScheduler::High, [&runs]() {
+        runs += 10;
+    });
+    IdleTaskScheduler::post(&survivor, "kept", IdleTaskScheduler::Low, [&runs]() {
+        runs += 1;
+    });
+    delete context;
+
+    QSignalSpy drained(&scheduler, &IdleTaskScheduler::drained);
+    scheduler.release();
+    QVERIFY(drained.wait(1000));
+    QCOMPARE(runs, 1);
+}
+
+void IdleTaskSchedulerTest::testWithoutContext()
+{
+    IdleTaskScheduler scheduler;
+    bool ran = false;
+    IdleTaskScheduler::post(nullptr, "no-context", IdleTaskScheduler::Normal, [&ran]() {
+        ran = true;
+    });
+
+    QSignalSpy drained(&scheduler, &IdleTaskScheduler::drained);
+    scheduler.release();
+    QVERIFY(drained.wait(1000));
+    QVERIFY(ran);
+}
+
+void IdleTaskSchedulerTest::testFallbackWithoutInstance()
+{
+    QVERIFY(IdleTaskScheduler::instance() == nullptr);
+
+    QObject context;
+    bool ran = false;
+    IdleTaskScheduler::post(&context, "fallback", IdleTaskScheduler::Normal, [&ran]() {
+        ran = true;
+    });
+    QVERIFY(!ran);
+    QTRY_VERIFY(ran);
+}
+
+void IdleTaskSchedulerTest::testStartupTraceJson()
+{
+    Konsole::StartupTrace *trace = Konsole::StartupTrace::instance();
+    trace->setEnabled(true);
+    trace->clear();
+
+    {
+        Konsole::StartupTrace::Span span("outer");
+        trace->mark("marker");
+    }
+    QCOMPARE(trace->eventCount(), 2);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(trace->toChromeTraceJson());
+    QVERIFY(doc.isObject());
+    const QJsonArray events = doc.object().value(QStringLiteral("traceEvents")).toArray();
+
+    bool foundSpan = false;
+    bool foundMarker = false;
+    for (const QJsonValue &value : events) {
+        const QJsonObject event = value.toObject();
+        const QString name = event.value(QStringLiteral("name")).toString();
+        if (name == QLatin1String("outer")) {
+            foundSpan = true;
+            QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+            QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 0.0);
+        } else if (name == QLatin1String("marker")) {
+            foundMarker = true;
+            QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("i"));
+        }
+    }
+    QVERIFY(foundSpan);
+    QVERIFY(foundMarker);
+
+    trace->clear();
+    trace->setEnabled(false);
+}
+
+void IdleTaskSchedulerTest::testStartupTraceBounded()
+{
+    Konsole::StartupTrace *trace = Konsole::StartupTrace::instance();
+    trace->setEnabled(true);
+    trace->clear();
+
+    for (int i = 0; i < Konsole::StartupTrace::MaxEvents + 10; ++i) {
+        Konsole::StartupTrace::Span span("lookup");
+    }
+    QCOMPARE(trace->eventCount(), Konsole::StartupTrace::MaxEvents);
+
+    // Nothing is recorded once startup is over
+    trace->clear();
+    trace->end();
+    QVERIFY(!Konsole::StartupTrace::isEnabled());
+    {
+        Konsole::StartupTrace::Span span("lookup");
+        trace->mark("marker");
+    }
+    QCOMPARE(trace->eventCount(), 0);
+}
+
+void IdleTaskSchedulerTest::testStartupTraceEndHeld()
+{
+    Konsole::StartupTrace *trace = Konsole::StartupTrace::instance();
+    trace->setEnabled(true);
+    trace->clear();
+
+    // Sessions still being restored when the idle tasks drained are traced
+    trace->holdEnd();
+    trace->end();
+    QVERIFY(Konsole::StartupTrace::isEnabled());
+    trace->mark("restore-all-sessions");
+    QCOMPARE(trace->eventCount(), 1);
+
+    trace->releaseEnd();
+    QVERIFY(!Konsole::StartupTrace::isEnabled());
+
+    // Released before the idle tasks drained, the trace ends with them
+    trace->setEnabled(true);
+    trace->holdEnd();
+    trace->releaseEnd();
+    QVERIFY(Konsole::StartupTrace::isEnabled());
+    trace->end();
+    QVERIFY(!Konsole::StartupTrace::isEnabled());
+    trace->clear();
+}
+
+QTEST_GUILESS_MAIN(Konsolai::IdleTaskSchedulerTest)
+
+#include "IdleTaskSchedulerTest.moc"
@@ -0,0 +1,31 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef IDLETASKSCHEDULERTEST_H
+#define IDLETASKSCHEDULERTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class IdleTaskSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testHeldUntilReleased();
+    void testPriorityOrder();
+    void testDestroyedContextSkipped();
+    void testWithoutContext();
+    void testFallbackWithoutInstance();
+    void testStartupTraceJson();
+    void testStartupTraceBounded();
+    void testStartupTraceEndHeld();
+};
+
+}
+
+#endif // IDLETASKSCHEDULERTEST_H
@@ -0,0 +1,305 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "OneShotQueueTest.h"
+
+// Qt
+#include <QPointer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+// std
+#include <memory>
+
+// Konsolai
+#include "../claude/BudgetController.h"
+#include "../claude/GitJob.h"
+#include "../claude/OneShotQueue.h"
+
+using namespace Konsolai;
+
+namespace
+{
+// Records the launches instead of starting sessions; tasks finish when the
+// test completes their controller
+struct Harness {
+    QTemporaryDir worktrees;
+    QStringList launched;
+    QHash<QString, QPointer<OneShotController>> controllers;
+    bool launchOk = true;
+    std::unique_ptr<OneShotQueue> queue;
+
+    Harness()
+    {
+        queue = std::make_unique<OneShotQueue>([this](const OneShotTask &task, OneShotController *controller) {
+            if (!launchOk) {
+                return false;
+            }
+            launched.append(task.id);
+            controllers.insert(task.id, controller);
+            return true;
+        });
+        queue->setStateFilePath(worktrees.filePath(QStringLiteral("queue.json")));
+        queue->setPrepareWorktree([this](OneShotTask &task, QString *) {
+            task.worktreePath = worktrees.path();
+            task.branch = QStringLiteral("oneshot/") + task.id;
+            return nullptr;
+        });
+    }
+
+    void complete(const QString &id, double costUSD, bool success = true)
+    {
+        OneShotResult result;
+        result.success = success;
+        result.costUSD = costUSD;
+        result.totalTokens = 6000;
+        result.durationSeconds = 120;
+        Q_EMIT controllers.value(id)->completed(result);
+    }
+};
+
+OneShotConfig makeConfig(int qualityScore, double costCeilingUSD = 0.0)
+{
+    OneShotConfig config;
+    config.prompt = QStringLiteral("Fix the parser");
+    config.workingDir = QStringLiteral("/tmp/repo");
+    config.qualityScore = qualityScore;
+    config.costCeilingUSD = costCeilingUSD;
+    return config;
+}
+
+SessionBudget costBudget(double ceilingUSD)
+{
+    SessionBudget budget;
+    budget.costCeilingUSD = ceilingUSD;
+    return budget;
+}
+}
+
+void OneShotQueueTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void OneShotQueueTest::testPriorityOrder()
+{
+    Harness h;
+    h.queue->setMaxConcurrent(1);
+    const QString low = h.queue->enqueue(makeConfig(40));
+    const QString high = h.queue->enqueue(makeConfig(90));
+    const QString highCheap = h.queue->enqueue(makeConfig(90, 0.10));
+    const QString mid = h.queue->enqueue(makeConfig(70));
+    h.queue->start();
+
+    QTRY_COMPARE(h.launched.size(), 1);
+    const QStringList expected = {highCheap, high, mid, low};
+    for (int i = 0; i < expected.size(); ++i) {
+        QTRY_COMPARE(h.launched.size(), i + 1);
+        QCOMPARE(h.launched.last(), expected[i]);
+        QCOMPARE(h.queue->runningCount(), 1);
+        h.complete(expected[i], 0.1);
+    }
+
+    QCOMPARE(h.queue->finishedCount(), 4);
+    QCOMPARE(h.queue->task(low).state, OneShotTask::Succeeded);
+    QCOMPARE(h.queue->task(low).tokensPerMinute(), 3000.0);
+}
+
+void OneShotQueueTest::testConcurrencyCap()
+{
+    Harness h;
+    h.queue->setMaxConcurrent(2);
+    for (int i = 0; i < 5; ++i) {
+        h.queue->enqueue(makeConfig(50));
+    }
+    h.queue->start();
+
+    QTRY_COMPARE(h.launched.size(), 2);
+    QTest::qWait(20);
+    QCOMPARE(h.launched.size(), 2);
+    QCOMPARE(h.queue->pendingCount(), 3);
+
+    h.complete(h.launched.first(), 0.1);
+    QTRY_COMPARE(h.launched.size(), 3);
+    QCOMPARE(h.queue->runningCount(), 2);
+    QCOMPARE(h.queue->pendingCount(), 2);
+}
+
+void OneShotQueueTest::testBudgetAdmission()
+{
+    Harness h;
+    BudgetController budget;
+    budget.setBudget(costBudget(0.40));
+    h.queue->setBudgetController(&budget);
+    h.queue->setMaxConcurrent(5);
+
+    // Each task is capped below its estimate, so each reserves $0.15
+    const QString first = h.queue->enqueue(makeConfig(50, 0.15));
+    const QString second = h.queue->enqueue(makeConfig(50, 0.15));
+    const QString third = h.queue->enqueue(makeConfig(50, 0.15));
+    QCOMPARE(h.queue->task(first).estimatedCostUSD, 0.15);
+    h.queue->start();
+
+    QTRY_COMPARE(h.launched.size(), 2);
+    QTest::qWait(20);
+    QCOMPARE(h.launched.size(), 2);
+    QCOMPARE(h.queue->task(third).state, OneShotTask::Pending);
+
+    // Finishing under its estimate frees the rest of its reservation
+    h.complete(first, 0.05);
+    QTRY_COMPARE(h.launched.size(), 3);
+    QCOMPARE(h.launched.last(), third);
+
+    QSignalSpy drained(h.queue.get(), &OneShotQueue::drained);
+    h.complete(second, 0.15);
+    h.complete(third, 0.15);
+    QCOMPARE(drained.count(), 1);
+    QCOMPARE(h.queue->spentCostUSD(), 0.35);
+}
+
+void OneShotQueueTest::testBudgetExhausted()
+{
+    Harness h;
+    BudgetController budget;
+    budget.setBudget(costBudget(0.10));
+    h.queue->setBudgetController(&budget);
+
+    QSignalSpy exhausted(h.queue.get(), &OneShotQueue::budgetExhausted);
+    h.queue->enqueue(makeConfig(50, 0.15));
+    h.queue->enqueue(makeConfig(50, 0.15));
+    h.queue->start();
+
+    QTRY_COMPARE(exhausted.count(), 1);
+    QCOMPARE(exhausted.first().at(0).toInt(), 2);
+    QVERIFY(h.launched.isEmpty());
+
+    // Raising the ceiling lets them through
+    budget.setBudget(costBudget(1.0));
+    h.queue->setBudgetController(&budget);
+    QTRY_COMPARE(h.launched.size(), 2);
+}
+
+void OneShotQueueTest::testLaunchFailure()
+{
+    Harness h;
+    h.launchOk = false;
+    QSignalSpy finished(h.queue.get(), &OneShotQueue::taskFinished);
+    const QString id = h.queue->enqueue(makeConfig(50));
+    h.queue->start();
+
+    QTRY_COMPARE(finished.count(), 1);
+    const OneShotTask task = h.queue->task(id);
+    QCOMPARE(task.state, OneShotTask::Failed);
+    QCOMPARE(task.attempts, 1);
+    QVERIFY(!task.result.errors.isEmpty());
+    QCOMPARE(h.queue->runningCount(), 0);
+}
+
+void OneShotQueueTest::testWorktreeFailure()
+{
+    Harness h;
+    h.queue->setPrepareWorktree([](OneShotTask &, QString *error) {
+        *error = QStringLiteral("git worktree add failed");
+        return nullptr;
+    });
+    const QString id = h.queue->enqueue(makeConfig(50));
+    h.queue->start();
+
+    QTRY_COMPARE(h.queue->task(id).state, OneShotTask::Failed);
+    QCOMPARE(h.queue->task(id).result.errors, QStringList{QStringLiteral("git worktree add failed")});
+    QVERIFY(h.launched.isEmpty());
+}
+
+void OneShotQueueTest::testWorktreeJob()
+{
+    Harness h;
+    h.queue->setMaxConcurrent(1);
+    const QString path = h.worktrees.path();
+    h.queue->setPrepareWorktree([path](OneShotTask &task, QString *) {
+        task.worktreePath = path + QStringLiteral("/") + task.id;
+        auto *job = new GitJob(path);
+        // Stands in for `git worktree add`, failing for the second task
+        if (task.config.qualityScore == 90) {
+            job->addStep(QStringLiteral("Creating worktree"), {QStringLiteral("--version")});
+        } else {
+            job->addStep(QStringLiteral("Creating worktree"), {QStringLiteral("no-such-command")});
+        }
+        return job;
+    });
+    const QString first = h.queue->enqueue(makeConfig(90));
+    const QString second = h.queue->enqueue(makeConfig(50));
+    h.queue->start();
+
+    // Admitted while git runs, the session comes after
+    QTRY_COMPARE(h.queue->task(first).state, OneShotTask::Running);
+    QCOMPARE(h.queue->runningCount(), 1);
+    QTRY_COMPARE(h.launched, QStringList{first});
+    QCOMPARE(h.queue->task(second).state, OneShotTask::Pending);
+
+    h.complete(first, 0.1);
+    QTRY_COMPARE(h.queue->task(second).state, OneShotTask::Failed);
+    QVERIFY(h.queue->task(second).result.errors.constFirst().startsWith(QStringLiteral("git worktree add failed")));
+    QCOMPARE(h.launched, QStringList{first});
+    QCOMPARE(h.queue->runningCount(), 0);
+}
+
+void OneShotQueueTest::testCancel()
+{
+    Harness h;
+    h.queue->setMaxConcurrent(1);
+    const QString running = h.queue->enqueue(makeConfig(90));
+    const QString pending = h.queue->enqueue(makeConfig(50));
+    h.queue->start();
+
+    QTRY_COMPARE(h.launched.size(), 1);
+    QVERIFY(!h.queue->cancel(running));
+    QVERIFY(h.queue->cancel(pending));
+    QCOMPARE(h.queue->task(pending).state, OneShotTask::Cancelled);
+
+    h.complete(running, 0.1);
+    QTest::qWait(20);
+    QCOMPARE(h.launched.size(), 1);
+}
+
+void OneShotQueueTest::testResumeAfterRestart()
+{
+    Harness h;
+    h.queue->setMaxConcurrent(1);
+    const QString done = h.queue->enqueue(makeConfig(90));
+    const QString interrupted = h.queue->enqueue(makeConfig(70));
+    const QString waiting = h.queue->enqueue(makeConfig(50));
+    h.queue->start();
+
+    QTRY_COMPARE(h.launched.size(), 1);
+    h.complete(done, 0.2);
+    QTRY_COMPARE(h.launched.size(), 2);
+    h.queue->saveState();
+
+    // A new queue reading the same state, as after a restart
+    std::unique_ptr<OneShotQueue> restarted = std::make_unique<OneShotQueue>([](const OneShotTask &, OneShotController *) {
+        return true;
+    });
+    restarted->setStateFilePath(h.queue->stateFilePath());
+    restarted->loadState();
+
+    QCOMPARE(restarted->tasks().size(), 3);
+    QCOMPARE(restarted->task(done).state, OneShotTask::Succeeded);
+    QCOMPARE(restarted->task(done).result.costUSD, 0.2);
+    QCOMPARE(restarted->task(interrupted).state, OneShotTask::Pending);
+    QCOMPARE(restarted->task(interrupted).worktreePath, h.worktrees.path());
+    QCOMPARE(restarted->task(interrupted).attempts, 1);
+    QCOMPARE(restarted->task(waiting).state, OneShotTask::Pending);
+
+    // The interrupted task keeps its place ahead of the waiting one
+    QCOMPARE(restarted->tasks().first().id, interrupted);
+    QCOMPARE(restarted->spentCostUSD(), 0.2);
+}
+
+QTEST_GUILESS_MAIN(Konsolai::OneShotQueueTest)
+
+#include "OneShotQueueTest.moc"
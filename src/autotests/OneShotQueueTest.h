@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef ONESHOTQUEUETEST_H
+#define ONESHOTQUEUETEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class OneShotQueueTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testPriorityOrder();
+    void testConcurrencyCap();
+    void testBudgetAdmission();
+    void testBudgetExhausted();
+    void testLaunchFailure();
+    void testWorktreeFailure();
+    void testWorktreeJob();
+    void testCancel();
+    void testResumeAfterRestart();
+};
+
+}
+
+#endif // ONESHOTQUEUETEST_H
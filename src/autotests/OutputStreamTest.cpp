@@ -0,0 +1,143 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "OutputStreamTest.h"
+
+// Qt
+#include <QTest>
+
+// Konsolai
+#include "../claude/OutputStream.h"
+
+using namespace Konsolai;
+
+namespace
+{
+void append(OutputStream &stream, const QByteArray &bytes)
+{
+    stream.append(bytes.constData(), bytes.size());
+}
+}
+
+void OutputStreamTest::testReadSinceCursor()
+{
+    OutputStream stream(64);
+    QCOMPARE(stream.cursor(), quint64(0));
+
+    append(stream, "hello ");
+    append(stream, "world");
+    QCOMPARE(stream.cursor(), quint64(11));
+
+    quint64 next = 0;
+    bool truncated = true;
+    QCOMPARE(stream.readSince(0, 1024, &next, &truncated), QByteArray("hello world"));
+    QCOMPARE(next, quint64(11));
+    QVERIFY(!truncated);
+
+    QCOMPARE(stream.readSince(6, 1024, &next), QByteArray("world"));
+
+    // nothing new
+    QVERIFY(stream.readSince(next, 1024, &next).isEmpty());
+    QCOMPARE(next, quint64(11));
+}
+
+void OutputStreamTest::testReadLimit()
+{
+    OutputStream stream(64);
+    append(stream, "abcdefgh");
+
+    quint64 next = 0;
+    QCOMPARE(stream.readSince(0, 3, &next), QByteArray("abc"));
+    QCOMPARE(next, quint64(3));
+    QCOMPARE(stream.readSince(next, 3, &next), QByteArray("def"));
+    QCOMPARE(stream.readSince(next, 3, &next), QByteArray("gh"));
+    QCOMPARE(next, quint64(8));
+
+    QVERIFY(stream.readSince(2, 0, &next).isEmpty());
+    QCOMPARE(next, quint64(2));
+}
+
+void OutputStreamTest::testWrapAround()
+{
+    OutputStream stream(8);
+    append(stream, "abcdef");
+    append(stream, "ghij");
+
+    QCOMPARE(stream.cursor(), quint64(10));
+    QCOMPARE(stream.firstCursor(), quint64(2));
+
+    quint64 next = 0;
+    QCOMPARE(stream.readSince(2, 1024, &next), QByteArray("cdefghij"));
+    QCOMPARE(stream.readSince(5, 1024, &next), QByteArray("fghij"));
+    QCOMPARE(next, quint64(10));
+}
+
+void OutputStreamTest::testReaderFallsBehind()
+{
+    OutputStream stream(4);
+    append(stream, "0123456789");
+
+    quint64 next = 0;
+    bool truncated = false;
+    QCOMPARE(stream.readSince(3, 1024, &next, &truncated), QByteArray("6789"));
+    QVERIFY(truncated);
+    QCOMPARE(next, quint64(10));
+}
+
+void OutputStreamTest::testOversizedAppend()
+{
+    OutputStream stream(4);
+    append(stream, "ab");
+    append(stream, "cdefgh");
+
+    QCOMPARE(stream.cursor(), quint64(8));
+    QCOMPARE(stream.firstCursor(), quint64(4));
+
+    quint64 next = 0;
+    QCOMPARE(stream.readSince(0, 1024, &next), QByteArray("efgh"));
+
+    append(stream, "ij");
+    QCOMPARE(stream.readSince(next, 1024, &next), QByteArray("ij"));
+}
+
+void OutputStreamTest::testClearKeepsCursor()
+{
+    OutputStream stream(16);
+    append(stream, "abc");
+    stream.clear();
+
+    QCOMPARE(stream.cursor(), quint64(3));
+    QCOMPARE(stream.firstCursor(), quint64(3));
+
+    append(stream, "d");
+    quint64 next = 0;
+    bool truncated = false;
+    QCOMPARE(stream.readSince(0, 1024, &next, &truncated), QByteArray("d"));
+    QVERIFY(truncated);
+}
+
+void OutputStreamTest::testStartCursor()
+{
+    // Taking over from a stream which got to 10
+    OutputStream stream(16, 10);
+    QCOMPARE(stream.cursor(), quint64(10));
+    QCOMPARE(stream.firstCursor(), quint64(10));
+
+    append(stream, "ab");
+    quint64 next = 0;
+    bool truncated = false;
+    QCOMPARE(stream.readSince(10, 1024, &next, &truncated), QByteArray("ab"));
+    QVERIFY(!truncated);
+    QCOMPARE(next, quint64(12));
+
+    // Readers from before missed what came in meanwhile
+    QCOMPARE(stream.readSince(4, 1024, &next, &truncated), QByteArray("ab"));
+    QVERIFY(truncated);
+}
+
+QTEST_GUILESS_MAIN(Konsolai::OutputStreamTest)
+
+#include "OutputStreamTest.moc"
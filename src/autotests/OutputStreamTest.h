@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef OUTPUTSTREAMTEST_H
+#define OUTPUTSTREAMTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class OutputStreamTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testReadSinceCursor();
+    void testReadLimit();
+    void testWrapAround();
+    void testReaderFallsBehind();
+    void testOversizedAppend();
+    void testClearKeepsCursor();
+    void testStartCursor();
+};
+
+}
+
+#endif // OUTPUTSTREAMTEST_H
@@ -0,0 +1,186 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ProjectIndexTest.h"
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+// std
+#include <algorithm>
+
+// Konsolai
+#include "../claude/ProjectIndex.h"
+
+using namespace Konsolai;
+
+namespace
+{
+void writeFile(const QString &path, const QByteArray &content)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+}
+
+// A repository as far as the index can tell, without running git
+void makeRepo(const QString &dir, const QByteArray &branch = QByteArrayLiteral("main"))
+{
+    writeFile(dir + QStringLiteral("/.git/HEAD"), "ref: refs/heads/" + branch + "\n");
+}
+
+void makeWorktree(const QString &dir, const QString &repo, const QByteArray &branch)
+{
+    const QString gitDir = repo + QStringLiteral("/.git/worktrees/") + QFileInfo(dir).fileName();
+    writeFile(gitDir + QStringLiteral("/HEAD"), "ref: refs/heads/" + branch + "\n");
+    writeFile(dir + QStringLiteral("/.git"), "gitdir: " + gitDir.toUtf8() + "\n");
+}
+
+// alpha with a worktree, beta detached one level down, gamma too deep,
+// and repositories in directories which aren't walked
+QString makeTree(const QTemporaryDir &dir)
+{
+    const QString root = dir.path();
+    makeRepo(root + QStringLiteral("/alpha"));
+    makeWorktree(root + QStringLiteral("/alpha-fix"), root + QStringLiteral("/alpha"), "fix/parser");
+    writeFile(root + QStringLiteral("/group/beta/.git/HEAD"), "0123456789abcdef0123456789abcdef01234567\n");
+    makeRepo(root + QStringLiteral("/deep/a/b/c/gamma"));
+    QDir().mkpath(root + QStringLiteral("/plain/src"));
+    makeRepo(root + QStringLiteral("/.hidden/repo"));
+    makeRepo(root + QStringLiteral("/web/node_modules/pkg"));
+    return root;
+}
+}
+
+void ProjectIndexTest::testScanFindsRepositoriesAndWorktrees()
+{
+    QTemporaryDir dir;
+    const QString root = makeTree(dir);
+
+    QList<IndexedProject> found = ProjectIndex::scan({root}, ProjectIndex::DefaultMaxDepth);
+    std::sort(found.begin(), found.end(), [](const IndexedProject &a, const IndexedProject &b) {
+        return a.path < b.path;
+    });
+
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found[0].path, root + QStringLiteral("/alpha"));
+    QCOMPARE(found[0].repoRoot, root + QStringLiteral("/alpha"));
+    QCOMPARE(found[0].branch, QStringLiteral("main"));
+    QVERIFY(!found[0].isWorktree);
+
+    QCOMPARE(found[1].path, root + QStringLiteral("/alpha-fix"));
+    QCOMPARE(found[1].repoRoot, root + QStringLiteral("/alpha"));
+    QCOMPARE(found[1].branch, QStringLiteral("fix/parser"));
+    QVERIFY(found[1].isWorktree);
+
+    QCOMPARE(found[2].path, root + QStringLiteral("/group/beta"));
+    QVERIFY(found[2].branch.isEmpty());
+}
+
+void ProjectIndexTest::testScanDepthLimit()
+{
+    QTemporaryDir dir;
+    const QString root = makeTree(dir);
+
+    QCOMPARE(ProjectIndex::scan({root}, 0).size(), 0);
+    QCOMPARE(ProjectIndex::scan({root}, 1).size(), 2);
+    QCOMPARE(ProjectIndex::scan({root}, 5).size(), 4);
+    // A root which is a repository itself
+    QCOMPARE(ProjectIndex::scan({root + QStringLiteral("/alpha")}, 0).size(), 1);
+}
+
+void ProjectIndexTest::testProjectAt()
+{
+    QTemporaryDir dir;
+    const QString root = makeTree(dir);
+
+    ProjectIndex index;
+    QSignalSpy updated(&index, &ProjectIndex::updated);
+    index.setRoots({root});
+    QVERIFY(!index.isReady());
+    QVERIFY(updated.wait());
+    QVERIFY(index.isReady());
+
+    QCOMPARE(index.projectAt(root + QStringLiteral("/alpha/src/parser")).path, root + QStringLiteral("/alpha"));
+    QCOMPARE(index.repoRootOf(root + QStringLiteral("/alpha-fix/")), root + QStringLiteral("/alpha"));
+    QVERIFY(index.projectAt(root + QStringLiteral("/plain/src")).path.isEmpty());
+    QVERIFY(index.repoRootOf(QStringLiteral("/")).isEmpty());
+
+    const QList<IndexedProject> worktrees = index.worktreesOf(root + QStringLiteral("/alpha"));
+    QCOMPARE(worktrees.size(), 2);
+    QVERIFY(!worktrees[0].isWorktree);
+    QCOMPARE(worktrees[1].branch, QStringLiteral("fix/parser"));
+}
+
+void ProjectIndexTest::testFrecencyRanking()
+{
+    QTemporaryDir dir;
+    const QString root = makeTree(dir);
+
+    ProjectIndex index;
+    QSignalSpy updated(&index, &ProjectIndex::updated);
+    index.setRoots({root});
+    QVERIFY(updated.wait());
+
+    // Alphabetical without history, then the other folders of the root
+    const QStringList folders = {QStringLiteral("deep"), QStringLiteral("group"), QStringLiteral("plain"), QStringLiteral("web")};
+    QCOMPARE(index.completions(root), (QStringList{QStringLiteral("alpha"), QStringLiteral("alpha-fix"), QStringLiteral("group/beta")} + folders));
+    QCOMPARE(index.completions(root + QStringLiteral("/group")), QStringList{QStringLiteral("beta")});
+
+    // beta used recently, alpha often but long ago; sessions in
+    // subdirectories count for their project
+    const QDateTime now = QDateTime::currentDateTime();
+    QList<ProjectIndex::Visit> visits;
+    visits.append({root + QStringLiteral("/group/beta"), now.addDays(-1)});
+    visits.append({root + QStringLiteral("/group/beta/docs"), now.addDays(-2)});
+    visits.append({root + QStringLiteral("/alpha"), now.addDays(-200)});
+    visits.append({root + QStringLiteral("/alpha"), now.addDays(-150)});
+    visits.append({root + QStringLiteral("/alpha-fix"), now.addDays(-10)});
+    visits.append({root + QStringLiteral("/elsewhere"), now});
+    index.setVisits(visits);
+
+    QCOMPARE(index.completions(root), (QStringList{QStringLiteral("group/beta"), QStringLiteral("alpha-fix"), QStringLiteral("alpha")} + folders));
+    QCOMPARE(index.projects().first().frecency, 200.0);
+    QCOMPARE(index.projectsUnder(root + QStringLiteral("/group")).size(), 1);
+}
+
+void ProjectIndexTest::testVisitWeight()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    QCOMPARE(ProjectIndex::visitWeight(now, now), 100.0);
+    QCOMPARE(ProjectIndex::visitWeight(now.addDays(-10), now), 70.0);
+    QCOMPARE(ProjectIndex::visitWeight(now.addDays(-20), now), 50.0);
+    QCOMPARE(ProjectIndex::visitWeight(now.addDays(-60), now), 30.0);
+    QCOMPARE(ProjectIndex::visitWeight(now.addDays(-365), now), 10.0);
+    QCOMPARE(ProjectIndex::visitWeight(QDateTime(), now), 0.0);
+}
+
+void ProjectIndexTest::testRescanOnChange()
+{
+    QTemporaryDir dir;
+    const QString root = makeTree(dir);
+
+    ProjectIndex index;
+    QSignalSpy updated(&index, &ProjectIndex::updated);
+    index.setRoots({root});
+    QVERIFY(updated.wait());
+    QCOMPARE(index.projects().size(), 3);
+
+    // A new checkout in a watched directory shows up without asking
+    makeRepo(root + QStringLiteral("/delta"));
+    QTRY_COMPARE_WITH_TIMEOUT(index.projects().size(), 4, 5000);
+    QCOMPARE(index.projectAt(root + QStringLiteral("/delta")).branch, QStringLiteral("main"));
+}
+
+QTEST_GUILESS_MAIN(Konsolai::ProjectIndexTest)
+
+#include "ProjectIndexTest.moc"
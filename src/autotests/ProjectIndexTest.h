@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PROJECTINDEXTEST_H
+#define PROJECTINDEXTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class ProjectIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testScanFindsRepositoriesAndWorktrees();
+    void testScanDepthLimit();
+    void testProjectAt();
+    void testFrecencyRanking();
+    void testVisitWeight();
+    void testRescanOnChange();
+};
+
+}
+
+#endif // PROJECTINDEXTEST_H
@@ -0,0 +1,266 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "PtyReaderTest.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTest>
+
+// std
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// System
+#include <fcntl.h>
+#include <unistd.h>
+
+// Konsole
+#include "../Pty.h"
+#include "../PtyReader.h"
+
+using namespace Konsole;
+
+namespace
+{
+constexpr qsizetype SmallCapacity = 4096;
+
+struct Pipe {
+    Pipe()
+    {
+        if (::pipe(fds) == 0) {
+            ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+        }
+    }
+    ~Pipe()
+    {
+        closeWriteEnd();
+        if (fds[0] >= 0) {
+            ::close(fds[0]);
+        }
+    }
+    qsizetype write(const QByteArray &data)
+    {
+        return ::write(fds[1], data.constData(), data.size());
+    }
+    void closeWriteEnd()
+    {
+        if (fds[1] >= 0) {
+            ::close(fds[1]);
+            fds[1] = -1;
+        }
+    }
+
+    int fds[2] = {-1, -1};
+};
+
+QByteArray pattern(qsizetype length, char first)
+{
+    QByteArray data(length, Qt::Uninitialized);
+    for (qsizetype i = 0; i < length; i++) {
+        data[i] = static_cast<char>(first + i % 23);
+    }
+    return data;
+}
+
+// Consumes up to @p length bytes, in as many pieces as it takes
+QByteArray take(PtyReader &reader, qsizetype length)
+{
+    QByteArray taken;
+    while (taken.size() < length) {
+        const QByteArrayView data = reader.peek(length - taken.size());
+        if (data.isEmpty()) {
+            break;
+        }
+        taken.append(data);
+        reader.consume(data.size());
+    }
+    return taken;
+}
+}
+
+void PtyReaderTest::testRingBufferWraps()
+{
+    Pipe pipe;
+    PtyReader reader(pipe.fds[0], SmallCapacity);
+    QCOMPARE(reader.capacity(), SmallCapacity);
+    reader.start();
+
+    const QByteArray first = pattern(3000, 'a');
+    QCOMPARE(pipe.write(first), first.size());
+    QTRY_COMPARE(reader.bytesAvailable(), first.size());
+    QCOMPARE(take(reader, first.size()), first);
+
+    // Runs over the end of the buffer, so it comes in two pieces
+    const QByteArray second = pattern(3000, 'A');
+    QCOMPARE(pipe.write(second), second.size());
+    QTRY_COMPARE(reader.bytesAvailable(), second.size());
+    QCOMPARE(reader.peek(second.size()).size(), SmallCapacity - first.size());
+    QCOMPARE(take(reader, second.size()), second);
+    QCOMPARE(reader.bytesAvailable(), 0);
+}
+
+void PtyReaderTest::testReadyReadOnce()
+{
+    Pipe pipe;
+    PtyReader reader(pipe.fds[0], SmallCapacity);
+    QSignalSpy readyRead(&reader, &PtyReader::readyRead);
+    reader.start();
+
+    for (int i = 0; i < 5; i++) {
+        pipe.write(pattern(100, 'a'));
+        QTRY_COMPARE(reader.bytesAvailable(), (i + 1) * 100);
+    }
+    QTRY_COMPARE(readyRead.count(), 1);
+
+    // Notified again once everything was consumed
+    take(reader, 500);
+    pipe.write(pattern(100, 'a'));
+    QTRY_COMPARE(readyRead.count(), 2);
+}
+
+void PtyReaderTest::testBackpressure()
+{
+    Pipe pipe;
+    PtyReader reader(pipe.fds[0], SmallCapacity);
+    reader.start();
+
+    // Much more than fits, the rest waits in the pipe
+    const QByteArray data = pattern(8 * SmallCapacity, 'a');
+    QCOMPARE(pipe.write(data), data.size());
+    QTRY_VERIFY(reader.isPaused());
+    QCOMPARE(reader.bytesAvailable(), SmallCapacity);
+
+    // Not enough room yet to go on
+    QByteArray received = take(reader, SmallCapacity / 4);
+    QTest::qWait(50);
+    QVERIFY(reader.isPaused());
+    QCOMPARE(reader.bytesAvailable(), SmallCapacity - SmallCapacity / 4);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (received.size() < data.size() && timer.elapsed() < 5000) {
+        received.append(take(reader, SmallCapacity));
+        QTest::qWait(1);
+    }
+    QCOMPARE(received, data);
+    QVERIFY(reader.bytesAvailable() <= reader.capacity());
+}
+
+void PtyReaderTest::testEndOfInput()
+{
+    Pipe pipe;
+    PtyReader reader(pipe.fds[0], SmallCapacity);
+    QSignalSpy closed(&reader, &PtyReader::closed);
+    reader.start();
+
+    pipe.write(pattern(10, 'a'));
+    pipe.closeWriteEnd();
+    QTRY_VERIFY(reader.atEnd());
+    QCOMPARE(closed.count(), 1);
+    // What came before is kept
+    QCOMPARE(take(reader, 100), pattern(10, 'a'));
+
+    reader.stop();
+    reader.stop();
+}
+
+void PtyReaderTest::testNothingReadAfterStop()
+{
+    Pipe pipe;
+    PtyReader reader(pipe.fds[0], SmallCapacity);
+    reader.start();
+
+    pipe.write(pattern(10, 'a'));
+    QTRY_COMPARE(reader.bytesAvailable(), 10);
+    reader.stop();
+
+    // As if the descriptor were closed and its number taken by another
+    pipe.write(pattern(10, 'b'));
+    QCOMPARE(reader.readPending(), 0);
+    QCOMPARE(take(reader, 100), pattern(10, 'a'));
+}
+
+void PtyReaderTest::testLastOutputAfterExit()
+{
+    Pty pty;
+    qsizetype received = 0;
+    qsizetype receivedAtExit = -1;
+    connect(&pty, &Pty::receivedData, this, [&received](const char *, int length) {
+        received += length;
+    });
+    connect(&pty, &Pty::finished, this, [&]() {
+        receivedAtExit = received;
+    });
+
+    // More than the buffer holds, written just before exiting
+    const qsizetype length = 3 * PtyReader::DefaultCapacity;
+    const QString program = QStringLiteral("sh");
+    const QString script = QStringLiteral("head -c %1 /dev/zero | tr '\\0' x").arg(length);
+    QCOMPARE(pty.start(program, {program, QStringLiteral("-c"), script}, QStringList()), 0);
+
+    QTRY_VERIFY_WITH_TIMEOUT(receivedAtExit >= 0, 10000);
+    QCOMPARE(receivedAtExit, length);
+}
+
+void PtyReaderTest::benchmarkFloodFairness()
+{
+    constexpr int Floods = 4;
+    constexpr int Keystrokes = 50;
+    const QString program = QStringLiteral("sh");
+
+    std::vector<std::unique_ptr<Pty>> floods;
+    qint64 flooded = 0;
+    qint64 floodedLines = 0;
+    for (int i = 0; i < Floods; i++) {
+        auto pty = std::make_unique<Pty>();
+        connect(pty.get(), &Pty::receivedData, this, [&flooded, &floodedLines](const char *data, int length) {
+            // Stands in for the emulation, which looks at every byte
+            floodedLines += std::count(data, data + length, '\n');
+            flooded += length;
+        });
+        QCOMPARE(pty->start(program, {program, QStringLiteral("-c"), QStringLiteral("exec yes")}, QStringList()), 0);
+        floods.push_back(std::move(pty));
+    }
+
+    Pty interactive;
+    QElapsedTimer sent;
+    bool waiting = false;
+    std::vector<qint64> latencies;
+    connect(&interactive, &Pty::receivedData, this, [&](const char *, int) {
+        if (waiting) {
+            latencies.push_back(sent.nsecsElapsed() / 1000);
+            waiting = false;
+        }
+    });
+    QCOMPARE(interactive.start(program, {program, QStringLiteral("-c"), QStringLiteral("exec cat")}, QStringList()), 0);
+    QTest::qWait(200);
+
+    QElapsedTimer total;
+    total.start();
+    flooded = 0;
+    floodedLines = 0;
+    for (int i = 0; i < Keystrokes; i++) {
+        waiting = true;
+        sent.start();
+        interactive.sendData(QByteArrayLiteral("x"));
+        QTRY_VERIFY_WITH_TIMEOUT(!waiting, 5000);
+        QTest::qWait(10);
+    }
+    const qint64 elapsed = std::max<qint64>(1, total.elapsed());
+
+    std::sort(latencies.begin(), latencies.end());
+    QCOMPARE(latencies.size(), size_t(Keystrokes));
+    qDebug() << Floods << "flooding terminals:" << flooded / 1048576.0 / (elapsed / 1000.0) << "MiB/s," << floodedLines * 1000 / elapsed << "lines/s";
+    qDebug() << "Echo latency in us, median:" << latencies[Keystrokes / 2] << "95%:" << latencies[Keystrokes * 95 / 100] << "max:" << latencies.back();
+}
+
+QTEST_GUILESS_MAIN(PtyReaderTest)
+
+#include "PtyReaderTest.moc"
@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PTYREADERTEST_H
+#define PTYREADERTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class PtyReaderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRingBufferWraps();
+    void testReadyReadOnce();
+    void testBackpressure();
+    void testEndOfInput();
+    void testNothingReadAfterStop();
+    void testLastOutputAfterExit();
+    void benchmarkFloodFairness();
+};
+
+}
+
+#endif // PTYREADERTEST_H
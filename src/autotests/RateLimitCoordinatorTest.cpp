@@ -0,0 +1,264 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "RateLimitCoordinatorTest.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTest>
+
+// std
+#include <memory>
+
+// Konsolai
+#include "../claude/RateLimitCoordinator.h"
+
+using namespace Konsolai;
+
+namespace
+{
+const QString Key = RateLimitCoordinator::keyFor(QStringLiteral("local"), QStringLiteral("claude-opus"));
+
+// Short times, without jitter, so the tests run quickly and deterministically
+void configure(RateLimitCoordinator &coordinator, int backoffMs = 50, int refillMs = 40)
+{
+    coordinator.setBaseBackoff(backoffMs);
+    coordinator.setRefillInterval(refillMs);
+    coordinator.setJitter(0);
+}
+}
+
+void RateLimitCoordinatorTest::testKeyFor()
+{
+    QCOMPARE(RateLimitCoordinator::keyFor(QStringLiteral("dev@build"), QStringLiteral("claude-sonnet")), QStringLiteral("dev@build/claude-sonnet"));
+    QCOMPARE(RateLimitCoordinator::keyFor(QStringLiteral("local"), QString()), QStringLiteral("local/default"));
+}
+
+void RateLimitCoordinatorTest::testUnlimitedRunsImmediately()
+{
+    RateLimitCoordinator coordinator;
+    QObject context;
+    int ran = 0;
+
+    QCOMPARE(coordinator.admit(Key, &context, [&ran]() {
+        ++ran;
+    }),
+             quint64(0));
+    QCOMPARE(ran, 1);
+    QVERIFY(!coordinator.isLimited(Key));
+}
+
+void RateLimitCoordinatorTest::testReportsInOneEpisodeShareBackoff()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 10000);
+    QSignalSpy started(&coordinator, &RateLimitCoordinator::backoffStarted);
+
+    // A whole fleet running into the same overload
+    for (int i = 0; i < 30; ++i) {
+        coordinator.reportRateLimit(Key, QStringLiteral("session-%1").arg(i));
+    }
+
+    QCOMPARE(started.count(), 1);
+    QCOMPARE(coordinator.level(Key), 1);
+    QCOMPARE(coordinator.reportCount(Key), 30);
+    QVERIFY(coordinator.backoffRemaining(Key) > 9000);
+    QVERIFY(coordinator.backoffRemaining(Key) <= 10000);
+}
+
+void RateLimitCoordinatorTest::testBackoffDoublesAfterEpisode()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 30);
+    QSignalSpy started(&coordinator, &RateLimitCoordinator::backoffStarted);
+
+    coordinator.reportRateLimit(Key);
+    QTRY_COMPARE(coordinator.backoffRemaining(Key), qint64(0));
+
+    // The retry after the backoff failed as well
+    coordinator.reportRateLimit(Key);
+    QCOMPARE(coordinator.level(Key), 2);
+    QCOMPARE(started.count(), 2);
+    QCOMPARE(started.at(1).at(2).toLongLong(), qint64(60));
+}
+
+void RateLimitCoordinatorTest::testHeldUntilBackoffEnds()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 100, 1);
+    QObject context;
+    QList<int> order;
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    coordinator.reportRateLimit(Key);
+    qint64 firstRun = -1;
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(coordinator.admit(Key, &context, [&order, &firstRun, &elapsed, i]() {
+            if (firstRun < 0) {
+                firstRun = elapsed.elapsed();
+            }
+            order.append(i);
+        }) != 0);
+    }
+    QVERIFY(order.isEmpty());
+    QCOMPARE(coordinator.waitingCount(Key), 3);
+
+    QTRY_COMPARE(order.size(), 3);
+    QVERIFY(firstRun >= 90);
+    QCOMPARE(order, QList<int>({0, 1, 2}));
+    QCOMPARE(coordinator.waitingCount(Key), 0);
+}
+
+void RateLimitCoordinatorTest::testRetriesArePaced()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 20, 300);
+    QObject context;
+    int ran = 0;
+
+    coordinator.reportRateLimit(Key);
+    for (int i = 0; i < 30; ++i) {
+        coordinator.admit(Key, &context, [&ran]() {
+            ++ran;
+        });
+    }
+
+    // One request right after the backoff, not the whole fleet
+    QTRY_COMPARE(ran, 1);
+    QTest::qWait(100);
+    QCOMPARE(ran, 1);
+    QCOMPARE(coordinator.waitingCount(Key), 29);
+
+    // The next once the bucket has refilled
+    QTRY_COMPARE_WITH_TIMEOUT(ran, 2, 1000);
+}
+
+void RateLimitCoordinatorTest::testCancel()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 30, 1);
+    QObject context;
+    int ran = 0;
+
+    coordinator.reportRateLimit(Key);
+    const quint64 ticket = coordinator.admit(Key, &context, [&ran]() {
+        ran += 1;
+    });
+    coordinator.admit(Key, &context, [&ran]() {
+        ran += 10;
+    });
+    coordinator.cancel(ticket);
+    coordinator.cancel(0);
+    QCOMPARE(coordinator.waitingCount(Key), 1);
+
+    QTRY_COMPARE(ran, 10);
+}
+
+void RateLimitCoordinatorTest::testContextDeleted()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 30, 1);
+    auto context = std::make_unique<QObject>();
+    QObject other;
+    bool ranDeleted = false;
+    bool ranOther = false;
+
+    coordinator.reportRateLimit(Key);
+    coordinator.admit(Key, context.get(), [&ranDeleted]() {
+        ranDeleted = true;
+    });
+    coordinator.admit(Key, &other, [&ranOther]() {
+        ranOther = true;
+    });
+    context.reset();
+
+    QTRY_VERIFY(ranOther);
+    QVERIFY(!ranDeleted);
+}
+
+void RateLimitCoordinatorTest::testSuccessRecovers()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 20);
+    QSignalSpy recovered(&coordinator, &RateLimitCoordinator::recovered);
+
+    coordinator.reportRateLimit(Key);
+    QTRY_COMPARE(coordinator.backoffRemaining(Key), qint64(0));
+    coordinator.reportRateLimit(Key);
+    QCOMPARE(coordinator.level(Key), 2);
+    QTRY_COMPARE(coordinator.backoffRemaining(Key), qint64(0));
+
+    coordinator.reportSuccess(Key);
+    QCOMPARE(coordinator.level(Key), 1);
+    QCOMPARE(recovered.count(), 0);
+    coordinator.reportSuccess(Key);
+    QCOMPARE(coordinator.level(Key), 0);
+    QCOMPARE(recovered.count(), 1);
+
+    QObject context;
+    bool ran = false;
+    QCOMPARE(coordinator.admit(Key, &context, [&ran]() {
+        ran = true;
+    }),
+             quint64(0));
+    QVERIFY(ran);
+}
+
+void RateLimitCoordinatorTest::testSuccessDuringBackoffIgnored()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 10000);
+
+    coordinator.reportRateLimit(Key);
+    // A request sent before the limit hit finishing late says nothing
+    coordinator.reportSuccess(Key);
+    QCOMPARE(coordinator.level(Key), 1);
+    QVERIFY(coordinator.isLimited(Key));
+}
+
+void RateLimitCoordinatorTest::testLevelDecaysWhenQuiet()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 200);
+    // As long as the backoff of each level
+    coordinator.setQuietPeriod(0);
+    QSignalSpy recovered(&coordinator, &RateLimitCoordinator::recovered);
+
+    coordinator.reportRateLimit(Key);
+    QTRY_COMPARE(coordinator.backoffRemaining(Key), qint64(0));
+    coordinator.reportRateLimit(Key);
+    QCOMPARE(coordinator.level(Key), 2);
+
+    // Nothing reported, nothing sent: the level halves after each period
+    QTRY_COMPARE(coordinator.level(Key), 1);
+    QCOMPARE(recovered.count(), 0);
+    QTRY_COMPARE(coordinator.level(Key), 0);
+    QCOMPARE(recovered.count(), 1);
+    QVERIFY(!coordinator.isLimited(Key));
+}
+
+void RateLimitCoordinatorTest::testKeysIndependent()
+{
+    RateLimitCoordinator coordinator;
+    configure(coordinator, 10000);
+    const QString otherModel = RateLimitCoordinator::keyFor(QStringLiteral("local"), QStringLiteral("claude-haiku"));
+    QObject context;
+    bool ran = false;
+
+    coordinator.reportRateLimit(Key);
+    QCOMPARE(coordinator.admit(otherModel, &context, [&ran]() {
+        ran = true;
+    }),
+             quint64(0));
+    QVERIFY(ran);
+    QVERIFY(!coordinator.isLimited(otherModel));
+}
+
+QTEST_GUILESS_MAIN(Konsolai::RateLimitCoordinatorTest)
+
+#include "RateLimitCoordinatorTest.moc"
@@ -0,0 +1,35 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef RATELIMITCOORDINATORTEST_H
+#define RATELIMITCOORDINATORTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class RateLimitCoordinatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testKeyFor();
+    void testUnlimitedRunsImmediately();
+    void testReportsInOneEpisodeShareBackoff();
+    void testBackoffDoublesAfterEpisode();
+    void testHeldUntilBackoffEnds();
+    void testRetriesArePaced();
+    void testCancel();
+    void testContextDeleted();
+    void testSuccessRecovers();
+    void testSuccessDuringBackoffIgnored();
+    void testLevelDecaysWhenQuiet();
+    void testKeysIndependent();
+};
+
+}
+
+#endif // RATELIMITCOORDINATORTEST_H
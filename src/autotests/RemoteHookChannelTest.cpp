@@ -0,0 +1,268 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "RemoteHookChannelTest.h"
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsolai
+#include "../claude/ClaudeHookHandler.h"
+#include "../claude/RemoteHookChannel.h"
+
+using namespace Konsolai;
+
+namespace
+{
+// Runs the hook script like Claude does, with the spool in @p dir
+void runHook(const QString &dir, const QString &session, const QString &event, const QByteArray &data, int maxSpoolEvents = RemoteHookChannel::MaxSpoolEvents)
+{
+    const QString script = QFileInfo(dir).absolutePath() + QStringLiteral("/hook.sh");
+    QFile file(script);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(RemoteHookChannel::hookScript(maxSpoolEvents).toUtf8());
+    file.close();
+
+    QProcess process;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("KONSOLAI_HOOK_DIR"), dir);
+    process.setProcessEnvironment(env);
+    process.start(QStringLiteral("bash"), {script, QStringLiteral("--session"), session, QStringLiteral("--event"), event});
+    QVERIFY(process.waitForStarted());
+    process.write(data);
+    process.closeWriteChannel();
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitCode(), 0);
+}
+
+QList<QJsonObject> readSpool(const QString &dir)
+{
+    QList<QJsonObject> events;
+    QFile file(dir + QStringLiteral("/spool"));
+    if (file.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            if (!line.isEmpty()) {
+                events.append(QJsonDocument::fromJson(line).object());
+            }
+        }
+    }
+    return events;
+}
+
+// The relay runs locally instead of over ssh
+void useLocalTransport(RemoteHookChannel &channel, const QString &dir)
+{
+    channel.setTransport(QStringLiteral("env"), {QStringLiteral("KONSOLAI_HOOK_DIR=") + dir, QStringLiteral("bash"), QStringLiteral("-c")});
+}
+}
+
+void RemoteHookChannelTest::initTestCase()
+{
+    if (QStandardPaths::findExecutable(QStringLiteral("bash")).isEmpty()) {
+        QSKIP("bash is not available");
+    }
+}
+
+void RemoteHookChannelTest::testHookScriptSpools()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PreToolUse"), R"({"tool_name":"Bash"})");
+    // Pretty-printed hook data still takes one line
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Stop"), "{\n  \"reason\": \"done\"\n}\n");
+    runHook(dir, QStringLiteral("e5f6a7b8"), QStringLiteral("Notification"), QByteArray());
+
+    const QList<QJsonObject> events = readSpool(dir);
+    QCOMPARE(events.size(), 3);
+    for (int i = 0; i < events.size(); ++i) {
+        QCOMPARE(events[i].value(QStringLiteral("seq")).toInteger(), i + 1);
+    }
+    QCOMPARE(events[0].value(QStringLiteral("session")).toString(), QStringLiteral("a1b2c3d4"));
+    QCOMPARE(events[0].value(QStringLiteral("event_type")).toString(), QStringLiteral("PreToolUse"));
+    QCOMPARE(events[0].value(QStringLiteral("data")).toObject().value(QStringLiteral("tool_name")).toString(), QStringLiteral("Bash"));
+    QCOMPARE(events[1].value(QStringLiteral("data")).toObject().value(QStringLiteral("reason")).toString(), QStringLiteral("done"));
+    QCOMPARE(events[2].value(QStringLiteral("session")).toString(), QStringLiteral("e5f6a7b8"));
+    QVERIFY(events[2].value(QStringLiteral("data")).isObject());
+}
+
+void RemoteHookChannelTest::testSpoolBounded()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+
+    for (int i = 0; i < 8; ++i) {
+        runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PostToolUse"), "{}", 5);
+    }
+
+    // The newest events are kept
+    const QList<QJsonObject> events = readSpool(dir);
+    QCOMPARE(events.size(), 5);
+    QCOMPARE(events.first().value(QStringLiteral("seq")).toInteger(), 4);
+    QCOMPARE(events.last().value(QStringLiteral("seq")).toInteger(), 8);
+}
+
+void RemoteHookChannelTest::testRelayHooksConfig()
+{
+    ClaudeHookHandler handler(QStringLiteral("a1b2c3d4"));
+    const QJsonObject hooks = QJsonDocument::fromJson(handler.generateRelayHooksConfig().toUtf8()).object().value(QStringLiteral("hooks")).toObject();
+
+    QVERIFY(hooks.contains(QStringLiteral("Stop")));
+    const QString command =
+        hooks.value(QStringLiteral("Stop")).toArray().first().toObject().value(QStringLiteral("hooks")).toArray().first().toObject().value(QStringLiteral("command")).toString();
+    QVERIFY(command.startsWith(QStringLiteral("\"$HOME/.konsolai/hooks/hook.sh\"")));
+    QVERIFY(command.contains(QStringLiteral("--session 'a1b2c3d4'")));
+    QVERIFY(command.contains(QStringLiteral("--event 'Stop'")));
+}
+
+void RemoteHookChannelTest::testRoutesEventsPerSession()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PreToolUse"), R"({"tool_name":"Read"})");
+    runHook(dir, QStringLiteral("e5f6a7b8"), QStringLiteral("Stop"), "{}");
+
+    RemoteHookChannel channel(QStringLiteral("dev@build"));
+    useLocalTransport(channel, dir);
+    QSignalSpy received(&channel, &RemoteHookChannel::hookEventReceived);
+    QSignalSpy connected(&channel, &RemoteHookChannel::connected);
+    channel.addSession(QStringLiteral("a1b2c3d4"));
+    QTRY_COMPARE(connected.count(), 1);
+
+    // Spooled before and after connecting alike
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Stop"), R"({"reason":"done"})");
+    QTRY_COMPARE(received.count(), 2);
+    QCOMPARE(received[0][0].toString(), QStringLiteral("a1b2c3d4"));
+    QCOMPARE(received[0][1].toString(), QStringLiteral("PreToolUse"));
+    QCOMPARE(QJsonDocument::fromJson(received[0][2].toString().toUtf8()).object().value(QStringLiteral("tool_name")).toString(), QStringLiteral("Read"));
+    QCOMPARE(received[1][1].toString(), QStringLiteral("Stop"));
+    QCOMPARE(channel.lastSequence(), quint64(3));
+
+    // The other session's event is held back and stays in the spool
+    QTRY_COMPARE(readSpool(dir).size(), 2);
+    QCOMPARE(readSpool(dir).first().value(QStringLiteral("seq")).toInteger(), 2);
+
+    // Until that session turns up, as when sessions are restored one after the other
+    channel.addSession(QStringLiteral("e5f6a7b8"));
+    QCOMPARE(received.count(), 3);
+    QCOMPARE(received[2][0].toString(), QStringLiteral("e5f6a7b8"));
+    QCOMPARE(received[2][1].toString(), QStringLiteral("Stop"));
+    QTRY_VERIFY(readSpool(dir).isEmpty());
+
+    // Events of removed sessions aren't held back
+    channel.removeSession(QStringLiteral("a1b2c3d4"));
+    QVERIFY(channel.isConnected());
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Stop"), "{}");
+    QTRY_COMPARE(channel.lastSequence(), quint64(4));
+    QTRY_VERIFY(readSpool(dir).isEmpty());
+    QCOMPARE(received.count(), 3);
+
+    channel.removeSession(QStringLiteral("e5f6a7b8"));
+    QVERIFY(!channel.isConnected());
+}
+
+void RemoteHookChannelTest::testReplayAfterReconnect()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+
+    RemoteHookChannel channel(QStringLiteral("dev@build"));
+    useLocalTransport(channel, dir);
+    QSignalSpy received(&channel, &RemoteHookChannel::hookEventReceived);
+    QSignalSpy lost(&channel, &RemoteHookChannel::eventsLost);
+    channel.addSession(QStringLiteral("a1b2c3d4"));
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PreToolUse"), "{}");
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PostToolUse"), "{}");
+    QTRY_COMPARE(received.count(), 2);
+    const QString epoch = channel.epoch();
+    QVERIFY(!epoch.isEmpty());
+
+    // Events keep being spooled while the connection is down
+    channel.stop();
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Stop"), "{}");
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Notification"), "{}");
+
+    channel.start();
+    QTRY_COMPARE(received.count(), 4);
+    QTest::qWait(600);
+    QCOMPARE(received.count(), 4);
+    QCOMPARE(received[2][1].toString(), QStringLiteral("Stop"));
+    QCOMPARE(received[3][1].toString(), QStringLiteral("Notification"));
+    QCOMPARE(channel.epoch(), epoch);
+    QCOMPARE(channel.lastSequence(), quint64(4));
+    QCOMPARE(lost.count(), 0);
+    channel.stop();
+}
+
+void RemoteHookChannelTest::testEpochChangeResetsSequence()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+
+    RemoteHookChannel channel(QStringLiteral("dev@build"));
+    useLocalTransport(channel, dir);
+    QSignalSpy received(&channel, &RemoteHookChannel::hookEventReceived);
+    channel.addSession(QStringLiteral("a1b2c3d4"));
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PreToolUse"), "{}");
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PostToolUse"), "{}");
+    QTRY_COMPARE(received.count(), 2);
+    const QString epoch = channel.epoch();
+    channel.stop();
+
+    // The remote spool is recreated, e.g. after the host was reinstalled
+    QVERIFY(QDir(dir).removeRecursively());
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("Stop"), "{}");
+
+    channel.start();
+    QTRY_COMPARE(received.count(), 3);
+    QCOMPARE(received[2][1].toString(), QStringLiteral("Stop"));
+    QVERIFY(channel.epoch() != epoch);
+    QCOMPARE(channel.lastSequence(), quint64(1));
+    channel.stop();
+}
+
+void RemoteHookChannelTest::testGapReported()
+{
+    QTemporaryDir tempDir;
+    const QString dir = tempDir.filePath(QStringLiteral("spool"));
+
+    RemoteHookChannel channel(QStringLiteral("dev@build"));
+    useLocalTransport(channel, dir);
+    QSignalSpy received(&channel, &RemoteHookChannel::hookEventReceived);
+    QSignalSpy lost(&channel, &RemoteHookChannel::eventsLost);
+    channel.addSession(QStringLiteral("a1b2c3d4"));
+    runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PreToolUse"), "{}");
+    QTRY_COMPARE(received.count(), 1);
+    QTRY_VERIFY(readSpool(dir).isEmpty());
+    channel.stop();
+
+    // Six events into a spool of three while disconnected
+    for (int i = 0; i < 6; ++i) {
+        runHook(dir, QStringLiteral("a1b2c3d4"), QStringLiteral("PostToolUse"), "{}", 3);
+    }
+
+    channel.start();
+    QTRY_COMPARE(received.count(), 4);
+    QCOMPARE(lost.count(), 1);
+    QCOMPARE(lost[0][0].toULongLong(), quint64(3));
+    QCOMPARE(channel.lastSequence(), quint64(7));
+    channel.stop();
+}
+
+QTEST_GUILESS_MAIN(Konsolai::RemoteHookChannelTest)
+
+#include "RemoteHookChannelTest.moc"
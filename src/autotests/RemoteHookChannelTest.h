@@ -0,0 +1,31 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef REMOTEHOOKCHANNELTEST_H
+#define REMOTEHOOKCHANNELTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class RemoteHookChannelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testHookScriptSpools();
+    void testSpoolBounded();
+    void testRelayHooksConfig();
+    void testRoutesEventsPerSession();
+    void testReplayAfterReconnect();
+    void testEpochChangeResetsSequence();
+    void testGapReported();
+};
+
+}
+
+#endif // REMOTEHOOKCHANNELTEST_H
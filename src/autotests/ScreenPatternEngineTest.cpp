@@ -0,0 +1,374 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ScreenPatternEngineTest.h"
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsolai
+#include "../claude/ClaudeSession.h"
+#include "../claude/ScreenPatternEngine.h"
+
+using namespace Konsolai;
+
+namespace
+{
+QString readScreen(const QString &name)
+{
+    QFile file(QFINDTESTDATA(QStringLiteral("data/screens/") + name));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(content) == content.size();
+}
+
+// Rules with one signal, for testing a single construct
+QByteArray singleRule(const QByteArray &signal)
+{
+    return R"({ "lineClasses": { "rule": { "char": "─", "minLength": 20, "minRatio": 0.9 } },
+                "signals": { "permissionPrompt": )"
+        + signal + " } }";
+}
+
+// The hand-coded scans the rules replaced, applied the way the pollers
+// applied them; the baseline of the benchmark
+QString bottomLines(const QString &output, int count)
+{
+    int pos = output.size();
+    for (int i = 0; i < count && pos > 0; ++i) {
+        pos = output.lastIndexOf(QLatin1Char('\n'), pos - 1);
+        if (pos < 0) {
+            pos = 0;
+            break;
+        }
+    }
+    return (pos > 0) ? output.mid(pos + 1) : output;
+}
+
+bool handCodedPermission(const QString &output)
+{
+    auto isInputBoxBorder = [](const QString &line) {
+        const QString trimmed = line.trimmed();
+        return trimmed.size() >= 20 && trimmed.count(QChar(0x2500)) > trimmed.size() * 9 / 10;
+    };
+    const auto lines = bottomLines(output, 5).split(QLatin1Char('\n'));
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString &line = lines[i];
+        if (!line.contains(QStringLiteral("❯"))) {
+            continue;
+        }
+        if (!line.contains(QStringLiteral("Yes"), Qt::CaseInsensitive) && !line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive)) {
+            continue;
+        }
+        if ((i > 0 && isInputBoxBorder(lines[i - 1])) || (i + 1 < lines.size() && isInputBoxBorder(lines[i + 1]))) {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool handCodedIdle(const QString &output)
+{
+    const QString bottom = bottomLines(output, 3);
+    QStringView lastNonEmpty;
+    for (const auto &line : QStringView(bottom).split(QLatin1Char('\n'))) {
+        if (line.contains(QStringLiteral("❯"))
+            && (line.contains(QStringLiteral("Yes"), Qt::CaseInsensitive) || line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive))) {
+            return false;
+        }
+        if (line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive) || line.contains(QStringLiteral("Deny"), Qt::CaseInsensitive)) {
+            return false;
+        }
+        if (!line.trimmed().isEmpty()) {
+            lastNonEmpty = line.trimmed();
+        }
+    }
+    return lastNonEmpty == QStringLiteral(">") || lastNonEmpty.endsWith(QStringLiteral(" >"));
+}
+
+bool handCodedRateLimit(const QString &output)
+{
+    const auto lines = output.split(QLatin1Char('\n'));
+    for (int i = qMax(0, int(lines.size()) - 10); i < lines.size(); ++i) {
+        const QString &line = lines[i];
+        if (line.contains(QStringLiteral("rate limit"), Qt::CaseInsensitive) || line.contains(QStringLiteral("rate_limit"), Qt::CaseInsensitive)
+            || line.contains(QStringLiteral("overloaded"), Qt::CaseInsensitive) || line.contains(QStringLiteral("too many requests"), Qt::CaseInsensitive)
+            || line.contains(QStringLiteral("529")) || line.contains(QStringLiteral("429"))) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+void ScreenPatternEngineTest::testDefaultRules()
+{
+    ScreenPatternEngine engine;
+    QCOMPARE(engine.scan(QStringLiteral("  ❯ Yes")), ScreenPatternEngine::Signals());
+
+    QSignalSpy reloaded(&engine, &ScreenPatternEngine::rulesReloaded);
+    QVERIFY(engine.loadDefaultRules());
+    QCOMPARE(reloaded.count(), 1);
+    QVERIFY(engine.keywordCount() > 0);
+    QVERIFY(engine.keywordCount() <= ScreenPatternEngine::MaxKeywords);
+
+    // The rules shipped and the ones in the source tree are the same
+    QFile source(QFINDTESTDATA(QStringLiteral("../../data/claude/screen-patterns.json")));
+    QFile resource(QString::fromLatin1(ScreenPatternEngine::DefaultRulesResource));
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    QVERIFY(resource.open(QIODevice::ReadOnly));
+    QCOMPARE(resource.readAll(), source.readAll());
+}
+
+void ScreenPatternEngineTest::testCorpus_data()
+{
+    QTest::addColumn<QString>("screen");
+    QTest::addColumn<QStringList>("expected");
+
+    QFile file(QFINDTESTDATA(QStringLiteral("data/screens/expected.json")));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonArray screens = QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("screens")).toArray();
+    QVERIFY(!screens.isEmpty());
+
+    for (const QJsonValue &value : screens) {
+        const QJsonObject object = value.toObject();
+        const QString name = object.value(QStringLiteral("file")).toString();
+        QStringList expected;
+        for (const QJsonValue &signal : object.value(QStringLiteral("signals")).toArray()) {
+            expected.append(signal.toString());
+        }
+        QTest::newRow(qPrintable(name)) << readScreen(name) << expected;
+    }
+}
+
+void ScreenPatternEngineTest::testCorpus()
+{
+    QFETCH(QString, screen);
+    QFETCH(QStringList, expected);
+    QVERIFY(!screen.isEmpty());
+
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadDefaultRules());
+    const ScreenPatternEngine::Signals found = engine.scan(screen);
+
+    QCOMPARE(found.testFlag(ScreenPatternEngine::PermissionPrompt), expected.contains(QStringLiteral("permissionPrompt")));
+    QCOMPARE(found.testFlag(ScreenPatternEngine::IdlePrompt), expected.contains(QStringLiteral("idlePrompt")));
+    QCOMPARE(found.testFlag(ScreenPatternEngine::RateLimit), expected.contains(QStringLiteral("rateLimit")));
+
+    // Same verdicts as the hand-coded scans had
+    QCOMPARE(found.testFlag(ScreenPatternEngine::PermissionPrompt), handCodedPermission(screen));
+    QCOMPARE(found.testFlag(ScreenPatternEngine::IdlePrompt), handCodedIdle(screen));
+    QCOMPARE(found.testFlag(ScreenPatternEngine::RateLimit), handCodedRateLimit(screen));
+
+    // The session's detectors go through the shared engine
+    QCOMPARE(ClaudeSession::detectPermissionPrompt(screen), found.testFlag(ScreenPatternEngine::PermissionPrompt));
+    QCOMPARE(ClaudeSession::detectIdlePrompt(screen), found.testFlag(ScreenPatternEngine::IdlePrompt));
+}
+
+void ScreenPatternEngineTest::testCaseInsensitiveKeywords()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadRules(singleRule(R"({ "tailLines": 5, "lines": [ { "all": ["Always ALLOW"] } ] })")));
+
+    QVERIFY(engine.matches(QStringLiteral("  always allow"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(engine.matches(QStringLiteral("  ALWAYS Allow"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("  always  allow"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::testOverlappingKeywords()
+{
+    // Keywords which are prefixes, suffixes and infixes of each other are
+    // all found by the one automaton
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadRules(singleRule(R"({ "tailLines": 5, "lines": [ { "all": ["rate", "ate l", "limit", "rate limit"] } ] })")));
+    QCOMPARE(engine.keywordCount(), 4);
+
+    QVERIFY(engine.matches(QStringLiteral("API error: rate limit"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("API error: rate-limit"), ScreenPatternEngine::PermissionPrompt));
+
+    // Matches don't run across lines
+    QVERIFY(!engine.matches(QStringLiteral("rate\nlimit"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::testNotAdjacent()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadRules(singleRule(R"({ "tailLines": 3, "lines": [ { "all": ["❯"], "notAdjacent": ["rule"] } ] })")));
+
+    const QString rule(40, QChar(0x2500));
+    QVERIFY(engine.matches(QStringLiteral("text\n❯ input\ntext"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("text\n❯ input\n") + rule, ScreenPatternEngine::PermissionPrompt));
+
+    // The line above the window still counts as a neighbour
+    QVERIFY(!engine.matches(rule + QStringLiteral("\n❯ input\nfooter\nfooter"), ScreenPatternEngine::PermissionPrompt));
+
+    // Too short, or too little of the character, to be a rule
+    QVERIFY(engine.matches(QStringLiteral("──────\n❯ input"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(engine.matches(QString(20, QChar(0x2500)) + QStringLiteral(" a label \n❯ input"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::testTailLines()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadRules(singleRule(R"({ "tailLines": 2, "lines": [ { "any": ["429"] } ] })")));
+
+    QVERIFY(engine.matches(QStringLiteral("one\nError 429\nthree"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("Error 429\ntwo\nthree"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::testTrailingBlankLines()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadDefaultRules());
+
+    // Blank rows below the prompt are not counted against the window
+    QVERIFY(engine.matches(QStringLiteral("output\n>\n\n\n   \n\n"), ScreenPatternEngine::IdlePrompt));
+    QCOMPARE(engine.scan(QStringLiteral("\n \n\t\n")), ScreenPatternEngine::Signals());
+}
+
+void ScreenPatternEngineTest::testInvalidRulesKeepPrevious()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadDefaultRules());
+    QSignalSpy reloaded(&engine, &ScreenPatternEngine::rulesReloaded);
+
+    QString error;
+    QVERIFY(!engine.loadRules("{ not json", &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!engine.loadRules(singleRule(R"({ "lines": [ { "any": ["x"] } ] })"), &error));
+    QVERIFY(error.contains(QStringLiteral("tailLines")));
+    QVERIFY(!engine.loadRules(singleRule(R"({ "tailLines": 3, "lines": [ { "notAdjacent": ["nosuchclass"] } ] })"), &error));
+    QVERIFY(error.contains(QStringLiteral("nosuchclass")));
+    QVERIFY(!engine.loadRules(singleRule(R"({ "tailLines": 3, "lines": [ { "any": [""] } ] })"), &error));
+
+    QCOMPARE(reloaded.count(), 0);
+    QVERIFY(engine.matches(QStringLiteral("  ❯ Yes\n    No"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::testTooManyKeywords()
+{
+    QStringList keywords;
+    for (int i = 0; i <= ScreenPatternEngine::MaxKeywords; ++i) {
+        keywords.append(QStringLiteral("\"keyword%1\"").arg(i));
+    }
+    const QByteArray rule = R"({ "tailLines": 3, "lines": [ { "any": [)" + keywords.join(QLatin1Char(',')).toUtf8() + "] } ] }";
+
+    ScreenPatternEngine engine;
+    QString error;
+    QVERIFY(!engine.loadRules(singleRule(rule), &error));
+    QVERIFY(error.contains(QString::number(ScreenPatternEngine::MaxKeywords)));
+}
+
+void ScreenPatternEngineTest::testUnknownSignalIgnored()
+{
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadRules(R"({ "signals": {
+        "somethingNew": { "tailLines": 3, "lines": [ { "any": ["new"] } ] },
+        "rateLimit": { "tailLines": 3, "lines": [ { "any": ["overloaded"] } ] } } })"));
+
+    QCOMPARE(engine.scan(QStringLiteral("new\noverloaded")), ScreenPatternEngine::Signals(ScreenPatternEngine::RateLimit));
+}
+
+void ScreenPatternEngineTest::testHotReload()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("screen-patterns.json"));
+
+    ScreenPatternEngine engine;
+    QSignalSpy reloaded(&engine, &ScreenPatternEngine::rulesReloaded);
+
+    // No file yet: the built-in rules
+    engine.watchFile(path);
+    QVERIFY(engine.matches(QStringLiteral("  ❯ Yes"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("  ❯ Proceed"), ScreenPatternEngine::PermissionPrompt));
+
+    // A UI change is followed by changing the rules file only
+    reloaded.clear();
+    QVERIFY(writeFile(path, singleRule(R"({ "tailLines": 5, "lines": [ { "all": ["❯"], "any": ["proceed"] } ] })")));
+    QTRY_VERIFY(reloaded.count() > 0);
+    QVERIFY(engine.matches(QStringLiteral("  ❯ Proceed"), ScreenPatternEngine::PermissionPrompt));
+    QVERIFY(!engine.matches(QStringLiteral("  ❯ Yes"), ScreenPatternEngine::PermissionPrompt));
+
+    // A broken edit keeps the rules in use
+    reloaded.clear();
+    QVERIFY(writeFile(path, "{ \"signals\": "));
+    QTest::qWait(300);
+    QCOMPARE(reloaded.count(), 0);
+    QVERIFY(engine.matches(QStringLiteral("  ❯ Proceed"), ScreenPatternEngine::PermissionPrompt));
+
+    // Removing the file goes back to the built-in rules
+    QVERIFY(QFile::remove(path));
+    QTRY_VERIFY(reloaded.count() > 0);
+    QVERIFY(engine.matches(QStringLiteral("  ❯ Yes"), ScreenPatternEngine::PermissionPrompt));
+}
+
+void ScreenPatternEngineTest::benchmarkScan_data()
+{
+    QTest::addColumn<bool>("handCoded");
+
+    QTest::newRow("pattern engine") << false;
+    QTest::newRow("hand-coded scans") << true;
+}
+
+void ScreenPatternEngineTest::benchmarkScan()
+{
+    QFETCH(bool, handCoded);
+
+    // Every screen of the corpus below a full screen of scrollback, as
+    // capture-pane returns it
+    QString scrollback;
+    for (int i = 0; i < 50; ++i) {
+        scrollback += QStringLiteral("     %1 | some source line of a file Claude read earlier\n").arg(i);
+    }
+    QStringList screens;
+    const QStringList names = QDir(QFileInfo(QFINDTESTDATA(QStringLiteral("data/screens/expected.json"))).absolutePath())
+                                  .entryList({QStringLiteral("*.txt")}, QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        screens.append(scrollback + readScreen(name));
+    }
+    QVERIFY(!screens.isEmpty());
+
+    ScreenPatternEngine engine;
+    QVERIFY(engine.loadDefaultRules());
+
+    int found = 0;
+    QBENCHMARK {
+        for (const QString &screen : screens) {
+            if (handCoded) {
+                found += handCodedPermission(screen) + handCodedIdle(screen) + handCodedRateLimit(screen);
+            } else {
+                const ScreenPatternEngine::Signals result = engine.scan(screen);
+                found += result.testFlag(ScreenPatternEngine::PermissionPrompt) + result.testFlag(ScreenPatternEngine::IdlePrompt)
+                    + result.testFlag(ScreenPatternEngine::RateLimit);
+            }
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_GUILESS_MAIN(Konsolai::ScreenPatternEngineTest)
+
+#include "ScreenPatternEngineTest.moc"
@@ -0,0 +1,38 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SCREENPATTERNENGINETEST_H
+#define SCREENPATTERNENGINETEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class ScreenPatternEngineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDefaultRules();
+    void testCorpus_data();
+    void testCorpus();
+    void testCaseInsensitiveKeywords();
+    void testOverlappingKeywords();
+    void testNotAdjacent();
+    void testTailLines();
+    void testTrailingBlankLines();
+    void testInvalidRulesKeepPrevious();
+    void testTooManyKeywords();
+    void testUnknownSignalIgnored();
+    void testHotReload();
+
+    void benchmarkScan_data();
+    void benchmarkScan();
+};
+
+}
+
+#endif // SCREENPATTERNENGINETEST_H
@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "SearchTabsContentSearchTest.h"
+
+#include "searchtabs/SearchTabsContentSearch.h"
+#include "searchtabs/SearchTabsModel.h"
+
+#include <QTest>
+
+using namespace Konsole;
+
+QTEST_GUILESS_MAIN(SearchTabsContentSearchTest)
+
+static ContentChunk makeChunk(const QStringList &lines, int startLine = 0)
+{
+    ContentChunk chunk;
+    chunk.view = 7;
+    chunk.tabName = QStringLiteral("claude-tab");
+    chunk.startLine = startLine;
+    chunk.lines = lines;
+    return chunk;
+}
+
+void SearchTabsContentSearchTest::testMatchChunkFindsLines()
+{
+    const ContentChunk chunk = makeChunk({QStringLiteral("$ make"),
+                                          QStringLiteral("Traceback (most recent call last):"),
+                                          QStringLiteral("  File \"main.py\", line 3"),
+                                          QStringLiteral("done")},
+                                         100);
+
+    const QVector<ContentHit> hits = SearchTabsContentSearch::matchChunk(chunk, QStringLiteral("line"));
+    QCOMPARE(hits.size(), 1);
+    QCOMPARE(hits.at(0).view, 7);
+    QCOMPARE(hits.at(0).tabName, QStringLiteral("claude-tab"));
+    QCOMPARE(hits.at(0).line, 102);
+    QCOMPARE(hits.at(0).snippet, QStringLiteral("File \"main.py\", line 3"));
+
+    // Newest lines are reported first
+    const QVector<ContentHit> all = SearchTabsContentSearch::matchChunk(chunk, QStringLiteral("a"));
+    QVERIFY(all.size() >= 2);
+    QVERIFY(all.at(0).line > all.at(1).line);
+}
+
+void SearchTabsContentSearchTest::testMatchChunkIsCaseInsensitive()
+{
+    const ContentChunk chunk = makeChunk({QStringLiteral("ERROR: connection refused"), QStringLiteral("no problem here")});
+
+    const QVector<ContentHit> hits = SearchTabsContentSearch::matchChunk(chunk, QStringLiteral("error"));
+    QCOMPARE(hits.size(), 1);
+    QCOMPARE(hits.at(0).line, 0);
+
+    QVERIFY(SearchTabsContentSearch::matchChunk(chunk, QString()).isEmpty());
+}
+
+void SearchTabsContentSearchTest::testMatchChunkStopsWhenCancelled()
+{
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        lines << QStringLiteral("match %1").arg(i);
+    }
+    const ContentChunk chunk = makeChunk(lines);
+
+    std::atomic<quint64> generation(1);
+    QCOMPARE(SearchTabsContentSearch::matchChunk(chunk, QStringLiteral("match"), &generation, 1).size(), 1000);
+
+    // A newer search was started, the stale chunk bails out early
+    QVERIFY(SearchTabsContentSearch::matchChunk(chunk, QStringLiteral("match"), &generation, 0).size() < 1000);
+}
+
+void SearchTabsContentSearchTest::testScoreMatchPrefersExactWords()
+{
+    const QString exactWord = QStringLiteral("a Segfault here");
+    const QString otherCase = QStringLiteral("a SEGFAULT here");
+    const QString substring = QStringLiteral("aSegfaults here");
+    const QString pattern = QStringLiteral("Segfault");
+
+    const int exactScore = SearchTabsContentSearch::scoreMatch(exactWord, pattern, exactWord.indexOf(pattern, 0, Qt::CaseInsensitive));
+    const int caseScore = SearchTabsContentSearch::scoreMatch(otherCase, pattern, otherCase.indexOf(pattern, 0, Qt::CaseInsensitive));
+    const int substringScore = SearchTabsContentSearch::scoreMatch(substring, pattern, substring.indexOf(pattern, 0, Qt::CaseInsensitive));
+
+    QVERIFY(exactScore > caseScore);
+    QVERIFY(exactScore > substringScore);
+    QVERIFY(caseScore > SearchTabsContentSearch::scoreMatch(QStringLiteral("aSEGFAULTs"), pattern, 1));
+}
+
+void SearchTabsContentSearchTest::testSnippetIsShortened()
+{
+    const QString line = QString(300, QLatin1Char('x')) + QStringLiteral("needle") + QString(300, QLatin1Char('y'));
+    const QVector<ContentHit> hits = SearchTabsContentSearch::matchChunk(makeChunk({line}), QStringLiteral("needle"));
+
+    QCOMPARE(hits.size(), 1);
+    QVERIFY(hits.at(0).snippet.size() < 130);
+    QVERIFY(hits.at(0).snippet.contains(QStringLiteral("needle")));
+}
+
+void SearchTabsContentSearchTest::testModelOrdersHitsByScore()
+{
+    SearchTabsModel model;
+    QCOMPARE(model.rowCount(), 0);
+
+    ContentHit low;
+    low.tabName = QStringLiteral("a");
+    low.line = 50;
+    low.score = 10;
+    ContentHit high = low;
+    high.line = 10;
+    high.score = 50;
+    ContentHit recent = low;
+    recent.line = 90;
+
+    model.addContentHits({low, high, recent});
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.index(0, 0).data(SearchTabsModel::Line).toInt(), 10);
+    QCOMPARE(model.index(1, 0).data(SearchTabsModel::Line).toInt(), 90);
+    QCOMPARE(model.index(2, 0).data(SearchTabsModel::Line).toInt(), 50);
+    QVERIFY(model.isContentHit(0));
+
+    model.clearContentHits();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+#include "moc_SearchTabsContentSearchTest.cpp"
@@ -0,0 +1,24 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SEARCHTABSCONTENTSEARCHTEST_H
+#define SEARCHTABSCONTENTSEARCHTEST_H
+
+#include <QObject>
+
+class SearchTabsContentSearchTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMatchChunkFindsLines();
+    void testMatchChunkIsCaseInsensitive();
+    void testMatchChunkStopsWhenCancelled();
+    void testScoreMatchPrefersExactWords();
+    void testSnippetIsShortened();
+    void testModelOrdersHitsByScore();
+};
+
+#endif // SEARCHTABSCONTENTSEARCHTEST_H
@@ -0,0 +1,291 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SelectionExportTest.h"
+
+// Qt
+#include <QBuffer>
+#include <QSignalSpy>
+#include <QTest>
+
+// Konsole
+#include "../ScreenWindow.h"
+#include "../SelectionExport.h"
+#include "../history/compact/CompactHistoryType.h"
+
+using namespace Konsole;
+
+namespace
+{
+constexpr int Columns = 40;
+
+// "line <n>" on each line of @p screen, the cursor left on the last one
+void fillLines(Screen &screen, int count, int first = 0)
+{
+    for (int i = 0; i < count; ++i) {
+        const QByteArray line = "line " + QByteArray::number(first + i);
+        for (const char c : line) {
+            screen.displayCharacter(uint(c));
+        }
+        if (i < count - 1) {
+            screen.nextLine();
+        }
+    }
+}
+
+void selectAll(Screen &screen)
+{
+    screen.setSelectionStart(0, 0, false);
+    screen.setSelectionEnd(Columns, screen.getLines() - 1, false);
+}
+
+QByteArray exported(SelectionExport &selection, SelectionExport::Format format = SelectionExport::PlainText)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, format);
+    selection.finish();
+    return data;
+}
+}
+
+void SelectionExportTest::testMatchesSelectedText()
+{
+    Screen screen(300, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 300);
+    screen.setSelectionStart(3, 10, false);
+    screen.setSelectionEnd(4, 250, false);
+
+    const Screen::DecodingOptions options = Screen::PreserveLineBreaks | Screen::TrimTrailingWhitespace;
+    SelectionExport selection(&window, options);
+    QCOMPARE(selection.lineCount(), 241);
+    QSignalSpy finished(&selection, &SelectionExport::finished);
+
+    QCOMPARE(QString::fromUtf8(exported(selection)), screen.selectedText(options));
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.first().first().toBool(), true);
+    QCOMPARE(selection.linesWritten(), 241);
+}
+
+void SelectionExportTest::testHtml()
+{
+    Screen screen(50, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 50);
+    selectAll(screen);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    QCOMPARE(QString::fromUtf8(exported(selection, SelectionExport::Html)), screen.selectedText(Screen::PreserveLineBreaks | Screen::ConvertToHtml));
+}
+
+void SelectionExportTest::testBlockSelection()
+{
+    Screen screen(20, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 20);
+    screen.setSelectionStart(2, 3, true);
+    screen.setSelectionEnd(5, 12, false);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    const QByteArray data = exported(selection);
+    QCOMPARE(QString::fromUtf8(data), screen.selectedText(Screen::PreserveLineBreaks));
+    QVERIFY(data.startsWith("ne 3\n"));
+
+    // Selecting again doesn't change what was taken
+    screen.clearSelection();
+    QCOMPARE(selection.lineCount(), 10);
+}
+
+void SelectionExportTest::testInEventLoop()
+{
+    Screen screen(20000, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 20000);
+    selectAll(screen);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, SelectionExport::PlainText);
+
+    QSignalSpy progress(&selection, &SelectionExport::progress);
+    QSignalSpy finished(&selection, &SelectionExport::finished);
+    selection.start();
+    QVERIFY(!selection.isFinished());
+    QVERIFY(finished.wait());
+
+    QCOMPARE(finished.first().first().toBool(), true);
+    QVERIFY(progress.count() >= 1);
+    QCOMPARE(progress.last().at(0).toInt(), 20000);
+    QCOMPARE(QString::fromUtf8(data), screen.selectedText(Screen::PreserveLineBreaks));
+}
+
+void SelectionExportTest::testLinesDropped()
+{
+    // The history keeps 20 lines, so the top ones drop off as more arrive
+    Screen screen(10, Columns);
+    screen.setScroll(CompactHistoryType(20));
+    ScreenWindow window(&screen);
+    fillLines(screen, 30);
+    screen.setSelectionStart(0, 0, false);
+    screen.setSelectionEnd(Columns, 29, false);
+    const QString expected = screen.selectedText(Screen::PreserveLineBreaks);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, SelectionExport::PlainText);
+    QSignalSpy finished(&selection, &SelectionExport::finished);
+
+    // The lines are copied as they drop off, and written later on
+    screen.nextLine();
+    fillLines(screen, 5, 30);
+    QCOMPARE(screen.totalDroppedLines(), qint64(5));
+    QVERIFY(!selection.isFinished());
+    QCOMPARE(selection.linesWritten(), 0);
+
+    selection.finish();
+    QCOMPARE(selection.linesLost(), 0);
+    QCOMPARE(selection.linesWritten(), 30);
+    QCOMPARE(finished.first().first().toBool(), true);
+    QCOMPARE(QString::fromUtf8(data), expected);
+}
+
+void SelectionExportTest::testScreenRedrawn()
+{
+    // Without history the lines on the screen are all there is
+    Screen screen(30, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 30);
+    selectAll(screen);
+    const QString expected = screen.selectedText(Screen::PreserveLineBreaks);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, SelectionExport::PlainText);
+    QSignalSpy finished(&selection, &SelectionExport::finished);
+
+    // What was on the screen when copying is copied
+    screen.clearEntireScreen();
+    screen.setCursorYX(1, 1);
+    fillLines(screen, 30, 100);
+    selection.finish();
+    QCOMPARE(finished.first().first().toBool(), true);
+    QCOMPARE(QString::fromUtf8(data), expected);
+}
+
+void SelectionExportTest::testResize()
+{
+    Screen screen(10, Columns);
+    screen.setScroll(CompactHistoryType(100));
+    ScreenWindow window(&screen);
+    fillLines(screen, 30);
+    screen.setSelectionStart(0, 0, false);
+    screen.setSelectionEnd(Columns, 29, false);
+    const QString expected = screen.selectedText(Screen::PreserveLineBreaks);
+
+    SelectionExport selection(&window, Screen::PreserveLineBreaks);
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, SelectionExport::PlainText);
+    QSignalSpy finished(&selection, &SelectionExport::finished);
+
+    // The lines are copied before they are reflowed, and written later on
+    screen.resizeImage(10, Columns / 2);
+    QVERIFY(!selection.isFinished());
+    QCOMPARE(selection.linesWritten(), 0);
+
+    selection.finish();
+    QCOMPARE(selection.linesLost(), 0);
+    QCOMPARE(selection.linesWritten(), 30);
+    QCOMPARE(finished.first().first().toBool(), true);
+    QCOMPARE(QString::fromUtf8(data), expected);
+}
+
+void SelectionExportTest::testScreenDestroyed()
+{
+    auto *screen = new Screen(30, Columns);
+    auto *window = new ScreenWindow(screen);
+    fillLines(*screen, 30);
+    selectAll(*screen);
+    const QString expected = screen->selectedText(Screen::PreserveLineBreaks);
+
+    SelectionExport selection(window, Screen::PreserveLineBreaks);
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    selection.addOutput(&buffer, SelectionExport::PlainText);
+
+    delete window;
+    delete screen;
+    QVERIFY(selection.isFinished());
+    QCOMPARE(QString::fromUtf8(data), expected);
+}
+
+void SelectionExportTest::testMimeData()
+{
+    Screen screen(8000, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 8000);
+    selectAll(screen);
+
+    auto *selection = new SelectionExport(&window, Screen::PreserveLineBreaks);
+    QPointer<SelectionExport> guard(selection);
+    SelectionMimeData *mimeData = new SelectionMimeData(selection, true);
+    QVERIFY(mimeData->hasText());
+    QVERIFY(mimeData->hasHtml());
+    QVERIFY(!mimeData->hasUrls());
+
+    // Pasting before the copy is done finishes it
+    QVERIFY(!selection->isFinished());
+    QCOMPARE(mimeData->text(), screen.selectedText(Screen::PreserveLineBreaks));
+    QVERIFY(selection->isFinished());
+    QCOMPARE(mimeData->data(QStringLiteral("text/plain;charset=utf-8")), screen.selectedText(Screen::PreserveLineBreaks).toUtf8());
+    QCOMPARE(mimeData->html(), screen.selectedText(Screen::PreserveLineBreaks | Screen::ConvertToHtml));
+
+    delete mimeData;
+    QVERIFY(guard.isNull());
+}
+
+void SelectionExportTest::testMimeDataCopiesAgain()
+{
+    Screen screen(8000, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 8000);
+    selectAll(screen);
+
+    auto *selection = new SelectionExport(&window, Screen::PreserveLineBreaks);
+    SelectionMimeData mimeData(selection, false);
+
+    // An export ending early leaves the whole selection all the same
+    selection->cancel();
+    QCOMPARE(mimeData.text(), screen.selectedText(Screen::PreserveLineBreaks));
+}
+
+void SelectionExportTest::benchmarkLargeSelection()
+{
+    Screen screen(50000, Columns);
+    ScreenWindow window(&screen);
+    fillLines(screen, 50000);
+    selectAll(screen);
+
+    QBENCHMARK {
+        SelectionExport selection(&window, Screen::PreserveLineBreaks);
+        exported(selection);
+    }
+}
+
+QTEST_GUILESS_MAIN(SelectionExportTest)
+
+#include "SelectionExportTest.moc"
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SELECTIONEXPORTTEST_H
+#define SELECTIONEXPORTTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class SelectionExportTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMatchesSelectedText();
+    void testHtml();
+    void testBlockSelection();
+    void testInEventLoop();
+    void testLinesDropped();
+    void testScreenRedrawn();
+    void testResize();
+    void testScreenDestroyed();
+    void testMimeData();
+    void testMimeDataCopiesAgain();
+    void benchmarkLargeSelection();
+};
+
+}
+
+#endif // SELECTIONEXPORTTEST_H
@@ -0,0 +1,240 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SemanticBlockIndexTest.h"
+
+// Qt
+#include <QTest>
+
+// std
+#include <vector>
+
+// Konsole
+#include "../SemanticBlockIndex.h"
+
+using namespace Konsole;
+
+namespace
+{
+// Commands of 10 lines each: prompt and command line, then output, the
+// last one still waiting at its prompt
+void addCommands(SemanticBlockIndex &index, int count, int firstLine = 0)
+{
+    for (int i = 0; i < count; ++i) {
+        const int prompt = firstLine + i * 10;
+        index.markPrompt(prompt);
+        index.markInput(prompt, quint16(i + 1));
+        index.markOutput(prompt + 1);
+        index.markFinished(prompt + 8);
+        index.setExitCode(i % 2);
+    }
+    index.markPrompt(firstLine + count * 10);
+}
+
+std::vector<LineProperty> linePropertiesOf(int commands)
+{
+    std::vector<LineProperty> properties(commands * 10 + 1);
+    for (int i = 0; i < commands; ++i) {
+        LineProperty &prompt = properties[i * 10];
+        prompt.flags.all |= LINE_PROMPT_START | LINE_INPUT_START;
+        prompt.counter = quint16(i + 1);
+        properties[i * 10 + 1].flags.all |= LINE_OUTPUT_START;
+    }
+    properties.back().flags.all |= LINE_PROMPT_START;
+    return properties;
+}
+}
+
+void SemanticBlockIndexTest::testBlocks()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+
+    QCOMPARE(index.count(), 4);
+    const SemanticBlockIndex::Block second = index.block(1);
+    QCOMPARE(second.promptLine, 10);
+    QCOMPARE(second.inputLine, 10);
+    QCOMPARE(second.outputLine, 11);
+    QCOMPARE(second.endLine, 18);
+    QCOMPARE(second.counter, quint16(2));
+    QCOMPARE(second.exitCode, 1);
+    QVERIFY(second.promptTime > 0);
+    QVERIFY(second.finishTime >= second.commandTime);
+
+    const SemanticBlockIndex::Block last = index.block(3);
+    QCOMPARE(last.promptLine, 30);
+    QCOMPARE(last.outputLine, -1);
+    QCOMPARE(last.endLine, -1);
+    QCOMPARE(index.lastOutputBlock(), 2);
+
+    // A redrawn prompt is the same block
+    index.markPrompt(30);
+    QCOMPARE(index.count(), 4);
+}
+
+void SemanticBlockIndexTest::testNavigation()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+
+    QCOMPARE(index.previousPrompt(25), 20);
+    QCOMPARE(index.previousPrompt(20), 10);
+    QCOMPARE(index.previousPrompt(0), -1);
+    QCOMPARE(index.nextPrompt(0), 10);
+    QCOMPARE(index.nextPrompt(21), 30);
+    QCOMPARE(index.nextPrompt(30), -1);
+
+    QCOMPARE(index.blockAt(5), 0);
+    // Between the end of a command and the next prompt
+    QCOMPARE(index.blockAt(9), -1);
+    QCOMPARE(index.blockAt(1000), 3);
+}
+
+void SemanticBlockIndexTest::testLinesDropped()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+
+    index.linesDropped(12);
+    // The first command is gone, the second lost its prompt
+    QCOMPARE(index.count(), 3);
+    QCOMPARE(index.block(0).promptLine, 0);
+    QCOMPARE(index.block(0).endLine, 6);
+    QCOMPARE(index.block(1).promptLine, 8);
+    QCOMPARE(index.previousPrompt(8), -1);
+    QCOMPARE(index.previousPrompt(100), 18);
+
+    // New marks are relative to the remaining lines
+    index.markInput(18, 4);
+    index.markOutput(19);
+    QCOMPARE(index.block(2).outputLine, 19);
+    QCOMPARE(index.lastOutputBlock(), 2);
+}
+
+void SemanticBlockIndexTest::testRebuild()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+    const std::vector<LineProperty> properties = linePropertiesOf(3);
+
+    index.invalidate();
+    QVERIFY(!index.isValid());
+    index.rebuild(
+        int(properties.size()),
+        [&properties](int line) {
+            return properties[line];
+        },
+        -1);
+
+    QVERIFY(index.isValid());
+    QCOMPARE(index.count(), 4);
+    QCOMPARE(index.block(1).endLine, 20);
+    QCOMPARE(index.block(3).endLine, -1);
+    // Kept from before
+    QCOMPARE(index.block(1).exitCode, 1);
+    QVERIFY(index.block(1).commandTime > 0);
+
+    // Without the first command, e.g. after reflowing
+    index.rebuild(
+        int(properties.size()) - 10,
+        [&properties](int line) {
+            return properties[line + 10];
+        },
+        -1);
+    QCOMPARE(index.count(), 3);
+    QCOMPARE(index.block(0).counter, quint16(2));
+    QCOMPARE(index.block(0).exitCode, 1);
+    QCOMPARE(index.block(1).exitCode, 0);
+}
+
+void SemanticBlockIndexTest::testRebuildFrom()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+    std::vector<LineProperty> properties = linePropertiesOf(3);
+
+    // The last command's output was cleared off the screen
+    properties[21] = LineProperty();
+    index.invalidateFrom(21);
+    QCOMPARE(index.dirtyLine(), 21);
+
+    int looked = 0;
+    index.rebuild(
+        int(properties.size()),
+        [&properties, &looked](int line) {
+            ++looked;
+            return properties[line];
+        },
+        -1,
+        index.dirtyLine());
+
+    QVERIFY(index.isValid());
+    QCOMPARE(looked, 10);
+    QCOMPARE(index.count(), 4);
+    QCOMPARE(index.block(2).outputLine, -1);
+    QCOMPARE(index.block(2).endLine, 30);
+    QCOMPARE(index.block(2).exitCode, 0);
+    QCOMPARE(index.block(1).exitCode, 1);
+    QVERIFY(index.block(1).commandTime > 0);
+    QCOMPARE(index.block(3).promptLine, 30);
+}
+
+void SemanticBlockIndexTest::testRemap()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 3);
+
+    // Reflowed narrower: the line of output at 5 now takes three lines
+    index.remap([](int line) {
+        return line > 5 ? line + 2 : line;
+    });
+    QVERIFY(index.isValid());
+    QCOMPARE(index.count(), 4);
+    QCOMPARE(index.block(0).outputLine, 1);
+    QCOMPARE(index.block(0).endLine, 10);
+    QCOMPARE(index.block(1).promptLine, 12);
+    QCOMPARE(index.block(1).outputLine, 13);
+    QCOMPARE(index.block(1).endLine, 20);
+    QCOMPARE(index.block(1).exitCode, 1);
+    QVERIFY(index.block(1).commandTime > 0);
+    QCOMPARE(index.block(3).promptLine, 32);
+    QCOMPARE(index.previousPrompt(20), 12);
+
+    // The history was full, the lines pushed out of it drop off
+    index.linesDropped(5);
+    QCOMPARE(index.count(), 4);
+    QCOMPARE(index.block(1).promptLine, 7);
+    QCOMPARE(index.block(3).promptLine, 27);
+}
+
+void SemanticBlockIndexTest::testPromptAboveLastInvalidates()
+{
+    SemanticBlockIndex index;
+    addCommands(index, 2);
+
+    index.markPrompt(5);
+    QVERIFY(!index.isValid());
+    QCOMPARE(index.dirtyLine(), 5);
+}
+
+void SemanticBlockIndexTest::benchmarkNavigation()
+{
+    // A million commands in 10 million lines of history
+    SemanticBlockIndex index;
+    addCommands(index, 1000000);
+
+    int line = 0;
+    QBENCHMARK {
+        line = index.previousPrompt(5000005);
+        line = index.nextPrompt(line);
+    }
+    QCOMPARE(line, 5000010);
+}
+
+QTEST_GUILESS_MAIN(SemanticBlockIndexTest)
+
+#include "moc_SemanticBlockIndexTest.cpp"
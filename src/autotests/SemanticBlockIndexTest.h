@@ -0,0 +1,31 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SEMANTICBLOCKINDEXTEST_H
+#define SEMANTICBLOCKINDEXTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class SemanticBlockIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testBlocks();
+    void testNavigation();
+    void testLinesDropped();
+    void testRebuild();
+    void testRebuildFrom();
+    void testRemap();
+    void testPromptAboveLastInvalidates();
+    void benchmarkNavigation();
+};
+
+}
+
+#endif // SEMANTICBLOCKINDEXTEST_H
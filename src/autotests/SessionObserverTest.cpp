@@ -145,6 +145,42 @@ private Q_SLOTS:
         QVERIFY(costSpiralFound);
     }
 
+    void testCostSpiralFromVelocity()
+    {
+        SessionObserver observer;
+        ObserverConfig cfg;
+        cfg.costSpiralTokenThreshold = 100000;
+        cfg.costSpiralCostThreshold = 1.0;
+        cfg.costSpiralWindowSeconds = 300;
+        cfg.interventionCooldownSecs = 0;
+        cfg.idleLoopEnabled = false;
+        cfg.errorLoopEnabled = false;
+        cfg.contextRotEnabled = false;
+        cfg.permissionStormEnabled = false;
+        cfg.subagentChurnEnabled = false;
+        observer.setConfig(cfg);
+
+        QSignalSpy detectedSpy(&observer, &SessionObserver::stuckDetected);
+        QSignalSpy clearedSpy(&observer, &SessionObserver::stuckCleared);
+
+        observer.onTokenUsageChanged(0, 0, 0, 0.0);
+
+        // Well under the thresholds over five minutes
+        observer.onTokenVelocityChanged(5000.0, 0.05);
+        QCOMPARE(detectedSpy.count(), 0);
+
+        // 30K tokens ($0.40) a minute spends 150K ($2.00) over the window;
+        // detected long before the window has seen it
+        observer.onTokenVelocityChanged(30000.0, 0.40);
+        QCOMPARE(detectedSpy.count(), 1);
+        QCOMPARE(detectedSpy.at(0).at(0).toInt(), static_cast<int>(StuckPattern::CostSpiral));
+
+        // Cleared once the rates came down
+        observer.onTokenVelocityChanged(1000.0, 0.01);
+        QCOMPARE(clearedSpy.count(), 1);
+        QCOMPARE(clearedSpy.at(0).at(0).toInt(), static_cast<int>(StuckPattern::CostSpiral));
+    }
+
     void testContextRotDetection()
     {
         SessionObserver observer;
@@ -0,0 +1,242 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SessionRestoreSchedulerTest.h"
+
+// Qt
+#include <QSignalSpy>
+#include <QTest>
+#include <QTimer>
+
+// std
+#include <algorithm>
+
+// Konsolai
+#include "../claude/SessionRestoreScheduler.h"
+
+using namespace Konsolai;
+
+namespace
+{
+QList<ClaudeSessionState> makeFleet(int size)
+{
+    const QDateTime base = QDateTime::currentDateTime();
+    QList<ClaudeSessionState> states;
+    for (int i = 0; i < size; ++i) {
+        ClaudeSessionState state;
+        state.sessionName = QStringLiteral("konsolai-default-%1").arg(i, 8, 10, QLatin1Char('0'));
+        state.sessionId = QStringLiteral("%1").arg(i, 8, 10, QLatin1Char('0'));
+        // session 0 was accessed last
+        state.lastAccessed = base.addSecs(-i);
+        states.append(state);
+    }
+    return states;
+}
+
+// Stands in for creating a session and attaching its tmux client, which
+// takes roughly the same time however many other attaches are running
+struct FakeAttach {
+    int latencyMs = 10;
+    int inFlight = 0;
+    int maxInFlight = 0;
+    QStringList started;
+    QStringList foreground;
+    QStringList startedBeforeFirstDone;
+    bool firstDone = false;
+
+    SessionRestoreScheduler::Attach attach(QObject *context)
+    {
+        return [this, context](const ClaudeSessionState &state, bool isForeground, SessionRestoreScheduler::Done done) {
+            started << state.sessionName;
+            if (isForeground) {
+                foreground << state.sessionName;
+            } else if (!firstDone) {
+                startedBeforeFirstDone << state.sessionName;
+            }
+            maxInFlight = std::max(maxInFlight, ++inFlight);
+            QTimer::singleShot(latencyMs, context, [this, isForeground, done]() {
+                --inFlight;
+                if (isForeground) {
+                    firstDone = true;
+                }
+                done(true);
+            });
+        };
+    }
+};
+}
+
+void SessionRestoreSchedulerTest::testEmpty()
+{
+    SessionRestoreScheduler scheduler([](const ClaudeSessionState &, bool, SessionRestoreScheduler::Done) {
+        QFAIL("nothing to attach");
+    });
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+    scheduler.start({});
+
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(scheduler.isFinished());
+    QCOMPARE(scheduler.restoredCount(), 0);
+}
+
+void SessionRestoreSchedulerTest::testMostRecentFirst()
+{
+    QList<ClaudeSessionState> states = makeFleet(5);
+    std::reverse(states.begin(), states.end());
+
+    const QList<ClaudeSessionState> ordered = SessionRestoreScheduler::prioritized(states);
+    QCOMPARE(ordered.size(), 5);
+    for (int i = 0; i < ordered.size(); ++i) {
+        QCOMPARE(ordered.at(i).sessionId, QStringLiteral("%1").arg(i, 8, 10, QLatin1Char('0')));
+    }
+}
+
+void SessionRestoreSchedulerTest::testForegroundAloneFirst()
+{
+    QObject context;
+    FakeAttach fake;
+    SessionRestoreScheduler scheduler(fake.attach(&context));
+    QSignalSpy first(&scheduler, &SessionRestoreScheduler::firstTabRestored);
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+
+    QList<ClaudeSessionState> states = makeFleet(10);
+    std::reverse(states.begin(), states.end());
+    scheduler.start(states);
+
+    // Only the tab accessed last is attached before it is up
+    QCOMPARE(fake.started.size(), 1);
+    QCOMPARE(fake.foreground, QStringList{QStringLiteral("konsolai-default-00000000")});
+
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(first.count(), 1);
+    QVERIFY(fake.startedBeforeFirstDone.isEmpty());
+    QCOMPARE(fake.foreground.size(), 1);
+    QCOMPARE(fake.started.size(), 10);
+    QCOMPARE(scheduler.restoredCount(), 10);
+    QVERIFY(scheduler.timeToFirstTab() >= 0);
+    QVERIFY(scheduler.timeToAllRestored() >= scheduler.timeToFirstTab());
+}
+
+void SessionRestoreSchedulerTest::testBatchLimit()
+{
+    QObject context;
+    FakeAttach fake;
+    SessionRestoreScheduler scheduler(fake.attach(&context));
+    scheduler.setBatchSize(3);
+    QSignalSpy restored(&scheduler, &SessionRestoreScheduler::sessionRestored);
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+
+    scheduler.start(makeFleet(20));
+    QVERIFY(finished.wait(5000));
+
+    QCOMPARE(restored.count(), 20);
+    QCOMPARE(fake.maxInFlight, 3);
+    QCOMPARE(scheduler.inFlightCount(), 0);
+    QCOMPARE(scheduler.pendingCount(), 0);
+}
+
+void SessionRestoreSchedulerTest::testFailuresCounted()
+{
+    SessionRestoreScheduler scheduler([](const ClaudeSessionState &state, bool, SessionRestoreScheduler::Done done) {
+        const bool ok = state.sessionId.toInt() % 2 == 0;
+        QTimer::singleShot(0, [done, ok]() {
+            done(ok);
+            // later calls are ignored
+            done(!ok);
+        });
+    });
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+
+    scheduler.start(makeFleet(7));
+    QVERIFY(finished.wait(5000));
+
+    QCOMPARE(scheduler.restoredCount(), 4);
+    QCOMPARE(scheduler.failedCount(), 3);
+    QCOMPARE(finished.at(0).at(0).toInt(), 4);
+    QCOMPARE(finished.at(0).at(1).toInt(), 3);
+}
+
+void SessionRestoreSchedulerTest::testSynchronousAttach()
+{
+    QStringList order;
+    SessionRestoreScheduler scheduler([&order](const ClaudeSessionState &state, bool, SessionRestoreScheduler::Done done) {
+        order << state.sessionName;
+        done(true);
+    });
+    QSignalSpy first(&scheduler, &SessionRestoreScheduler::firstTabRestored);
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+
+    scheduler.start(makeFleet(6));
+    // the foreground tab is up before start() returns, the rest follow
+    // from the event loop
+    QCOMPARE(first.count(), 1);
+    QCOMPARE(order.size(), 1);
+
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(order.size(), 6);
+    QCOMPARE(order.first(), QStringLiteral("konsolai-default-00000000"));
+}
+
+void SessionRestoreSchedulerTest::testFirstTabIndependentOfFleetSize_data()
+{
+    QTest::addColumn<int>("fleetSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("40") << 40;
+}
+
+void SessionRestoreSchedulerTest::testFirstTabIndependentOfFleetSize()
+{
+    QFETCH(int, fleetSize);
+
+    QObject context;
+    FakeAttach fake;
+    fake.latencyMs = 20;
+    SessionRestoreScheduler scheduler(fake.attach(&context));
+    QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+
+    scheduler.start(makeFleet(fleetSize));
+    QVERIFY(finished.wait(10000));
+
+    // One attach, however large the fleet; generous bound for loaded machines
+    QVERIFY(scheduler.timeToFirstTab() < fake.latencyMs * 10);
+    QVERIFY(fake.startedBeforeFirstDone.isEmpty());
+    QCOMPARE(scheduler.restoredCount(), fleetSize);
+}
+
+void SessionRestoreSchedulerTest::benchmarkRestore_data()
+{
+    QTest::addColumn<int>("fleetSize");
+
+    QTest::newRow("10 sessions") << 10;
+    QTest::newRow("40 sessions") << 40;
+}
+
+void SessionRestoreSchedulerTest::benchmarkRestore()
+{
+    QFETCH(int, fleetSize);
+    const QList<ClaudeSessionState> fleet = makeFleet(fleetSize);
+
+    qint64 firstTab = 0;
+    qint64 allRestored = 0;
+    QBENCHMARK {
+        QObject context;
+        FakeAttach fake;
+        SessionRestoreScheduler scheduler(fake.attach(&context));
+        QSignalSpy finished(&scheduler, &SessionRestoreScheduler::finished);
+        scheduler.start(fleet);
+        QVERIFY(finished.wait(30000));
+        firstTab = scheduler.timeToFirstTab();
+        allRestored = scheduler.timeToAllRestored();
+    }
+
+    qInfo("%d sessions: first tab after %lld ms, all restored after %lld ms", fleetSize, firstTab, allRestored);
+}
+
+QTEST_GUILESS_MAIN(Konsolai::SessionRestoreSchedulerTest)
+
+#include "SessionRestoreSchedulerTest.moc"
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SESSIONRESTORESCHEDULERTEST_H
+#define SESSIONRESTORESCHEDULERTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class SessionRestoreSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmpty();
+    void testMostRecentFirst();
+    void testForegroundAloneFirst();
+    void testBatchLimit();
+    void testFailuresCounted();
+    void testSynchronousAttach();
+    void testFirstTabIndependentOfFleetSize_data();
+    void testFirstTabIndependentOfFleetSize();
+
+    void benchmarkRestore_data();
+    void benchmarkRestore();
+};
+
+}
+
+#endif // SESSIONRESTORESCHEDULERTEST_H
@@ -0,0 +1,218 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "TerminalTextLayerTest.h"
+
+// Qt
+#include <QFontDatabase>
+#include <QPainter>
+#include <QTemporaryDir>
+#include <QTest>
+
+// Konsole
+#include "../colorscheme/ColorSchemeWallpaper.h"
+#include "../terminalDisplay/TerminalTextLayer.h"
+
+using namespace Konsole;
+
+namespace
+{
+const QSize ViewSize(960, 640);
+constexpr int LineHeight = 16;
+const QRect ScrollRect(0, 0, 960, 640);
+
+// A display's lines, each a color so moved pixels can be told apart
+void drawLines(QImage &image, const QRegion &region, int firstLine)
+{
+    QPainter painter(&image);
+    painter.setClipRegion(region);
+    for (int y = 0; y < ViewSize.height(); y += LineHeight) {
+        painter.fillRect(QRect(0, y, 100, LineHeight), QColor::fromRgb(qRgb((firstLine + y / LineHeight) % 256, 0, 0)));
+    }
+}
+
+int lineAt(const QImage &image, int y)
+{
+    return qRed(image.pixel(10, y));
+}
+
+QString wallpaperFile(const QTemporaryDir &dir)
+{
+    QImage picture(1920, 1080, QImage::Format_RGB32);
+    for (int y = 0; y < picture.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(picture.scanLine(y));
+        for (int x = 0; x < picture.width(); ++x) {
+            line[x] = qRgb(x / 8, y / 5, 128);
+        }
+    }
+    const QString path = dir.filePath(QStringLiteral("wallpaper.png"));
+    picture.save(path);
+    return path;
+}
+}
+
+void TerminalTextLayerTest::testFirstPaintDrawsAll()
+{
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+
+    const QRegion region(ScrollRect);
+    QCOMPARE(layer.beginPaint(region), region);
+    QCOMPARE(layer.image().pixel(5, 5), qRgba(0, 0, 0, 0));
+}
+
+void TerminalTextLayerTest::testScrollMovesPixels()
+{
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+    drawLines(layer.image(), layer.beginPaint(QRegion(ScrollRect)), 0);
+    QCOMPARE(lineAt(layer.image(), 2 * LineHeight), 2);
+
+    // Output moving up by three lines
+    layer.scroll(-3 * LineHeight, ScrollRect);
+    QCOMPARE(lineAt(layer.image(), 0), 3);
+    QCOMPARE(lineAt(layer.image(), 2 * LineHeight + 1), 5);
+
+    // And back down
+    layer.scroll(LineHeight, ScrollRect);
+    QCOMPARE(lineAt(layer.image(), LineHeight), 3);
+}
+
+void TerminalTextLayerTest::testScrollRedrawsExposedAndChanged()
+{
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+    drawLines(layer.image(), layer.beginPaint(QRegion(ScrollRect)), 0);
+
+    layer.scroll(-LineHeight, ScrollRect);
+    const QRect changed(0, 5 * LineHeight, 200, LineHeight);
+    layer.invalidate(changed);
+
+    const QRect exposed(0, ScrollRect.bottom() + 1 - LineHeight, ScrollRect.width(), LineHeight);
+    const QRegion stale = layer.beginPaint(QRegion(ScrollRect));
+    QCOMPARE(stale, QRegion(exposed) | changed);
+    QCOMPARE(layer.image().pixel(10, exposed.top()), qRgba(0, 0, 0, 0));
+
+    // Nothing moved since: a paint for other reasons draws again
+    QCOMPARE(layer.beginPaint(QRegion(changed)), QRegion(changed));
+}
+
+void TerminalTextLayerTest::testKeep()
+{
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+    drawLines(layer.image(), layer.beginPaint(QRegion(ScrollRect)), 0);
+
+    // A new wallpaper frame
+    layer.keep(ScrollRect);
+    QVERIFY(layer.beginPaint(QRegion(ScrollRect)).isEmpty());
+    QCOMPARE(lineAt(layer.image(), 0), 0);
+
+    // Kept, but the cursor blinked meanwhile
+    layer.keep(ScrollRect);
+    layer.invalidate(QRect(0, 0, 8, LineHeight));
+    QCOMPARE(layer.beginPaint(QRegion(ScrollRect)), QRegion(0, 0, 8, LineHeight));
+}
+
+void TerminalTextLayerTest::testResizeDropsContent()
+{
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+    layer.beginPaint(QRegion(ScrollRect));
+    layer.resize(ViewSize, 2.0);
+    QCOMPARE(layer.image().size(), ViewSize * 2);
+
+    layer.keep(ScrollRect);
+    QCOMPARE(layer.beginPaint(QRegion(ScrollRect)), QRegion(ScrollRect));
+}
+
+void TerminalTextLayerTest::testWallpaperLayerCached()
+{
+    QTemporaryDir dir;
+    ColorSchemeWallpaper wallpaper(wallpaperFile(dir), ColorSchemeWallpaper::Crop, QPointF(0.5, 0.5), 0.5, ColorSchemeWallpaper::NoFlip);
+    wallpaper.load();
+
+    QImage whole(ViewSize, QImage::Format_ARGB32_Premultiplied);
+    whole.fill(Qt::transparent);
+    QImage parts(ViewSize, QImage::Format_ARGB32_Premultiplied);
+    parts.fill(Qt::transparent);
+    {
+        QPainter painter(&whole);
+        QVERIFY(wallpaper.draw(painter, ScrollRect, 1.0, Qt::black));
+    }
+    {
+        // Drawn line by line, as after scrolling, it is the same picture
+        QPainter painter(&parts);
+        for (int y = 0; y < ViewSize.height(); y += LineHeight) {
+            QVERIFY(wallpaper.draw(painter, QRect(0, y, ViewSize.width(), LineHeight), 1.0, Qt::black));
+        }
+    }
+    QCOMPARE(parts, whole);
+}
+
+void TerminalTextLayerTest::benchmarkScroll_data()
+{
+    QTest::addColumn<bool>("wallpaper");
+    QTest::addColumn<bool>("textLayer");
+
+    QTest::newRow("background, text layer") << false << true;
+    QTest::newRow("wallpaper, text layer") << true << true;
+    QTest::newRow("wallpaper, redrawing text") << true << false;
+}
+
+void TerminalTextLayerTest::benchmarkScroll()
+{
+    QFETCH(bool, wallpaper);
+    QFETCH(bool, textLayer);
+
+    QTemporaryDir dir;
+    ColorSchemeWallpaper picture(wallpaper ? wallpaperFile(dir) : QString(), ColorSchemeWallpaper::Crop, QPointF(0.5, 0.5), 0.8, ColorSchemeWallpaper::NoFlip);
+    picture.load();
+
+    const QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    const QString text = QStringLiteral("drwxr-xr-x  2 user user  4096 Oct 16 12:00 some-directory-name-%1 and more output text");
+    auto drawText = [&font, &text](QPainter &painter, const QRegion &region, int firstLine) {
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+        const QRect bounds = region.boundingRect();
+        for (int y = bounds.top() / LineHeight * LineHeight; y <= bounds.bottom(); y += LineHeight) {
+            painter.drawText(QPoint(0, y + LineHeight - 4), text.arg(firstLine + y / LineHeight));
+        }
+    };
+
+    QImage widget(ViewSize, QImage::Format_ARGB32_Premultiplied);
+    TerminalTextLayer layer;
+    layer.resize(ViewSize, 1.0);
+    int firstLine = 0;
+
+    // A frame of output scrolling by one line
+    QBENCHMARK {
+        ++firstLine;
+        QRegion textRegion(ScrollRect);
+        if (textLayer) {
+            layer.scroll(-LineHeight, ScrollRect);
+            textRegion = layer.beginPaint(QRegion(ScrollRect));
+            QPainter layerPainter(&layer.image());
+            layerPainter.setClipRegion(textRegion);
+            drawText(layerPainter, textRegion, firstLine);
+        }
+
+        QPainter painter(&widget);
+        if (!picture.draw(painter, ScrollRect, 1.0, Qt::black)) {
+            painter.fillRect(ScrollRect, Qt::black);
+        }
+        if (textLayer) {
+            layer.composite(painter, QRegion(ScrollRect));
+        } else {
+            drawText(painter, textRegion, firstLine);
+        }
+    }
+}
+
+QTEST_MAIN(TerminalTextLayerTest)
+
+#include "moc_TerminalTextLayerTest.cpp"
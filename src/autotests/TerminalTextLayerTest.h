@@ -0,0 +1,32 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TERMINALTEXTLAYERTEST_H
+#define TERMINALTEXTLAYERTEST_H
+
+#include <QObject>
+
+namespace Konsole
+{
+class TerminalTextLayerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFirstPaintDrawsAll();
+    void testScrollMovesPixels();
+    void testScrollRedrawsExposedAndChanged();
+    void testKeep();
+    void testResizeDropsContent();
+    void testWallpaperLayerCached();
+
+    void benchmarkScroll_data();
+    void benchmarkScroll();
+};
+
+}
+
+#endif // TERMINALTEXTLAYERTEST_H
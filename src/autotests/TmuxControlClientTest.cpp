@@ -0,0 +1,179 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "TmuxControlClientTest.h"
+
+// Qt
+#include <QSignalSpy>
+#include <QTest>
+
+// Konsolai
+#include "../claude/TmuxControlClient.h"
+
+using namespace Konsolai;
+
+namespace
+{
+void feed(TmuxControlClient &client, const QByteArray &data)
+{
+    client.feed(data.constData(), data.size());
+}
+
+// Completes the command tmux was started with, which starts mirroring
+void finishAttach(TmuxControlClient &client)
+{
+    feed(client, QByteArrayLiteral("\033P1000p%begin 1700000000 100 0\r\n%end 1700000000 100 0\r\n"));
+}
+}
+
+void TmuxControlClientTest::testUnescapeOutput()
+{
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("hello")), QByteArrayLiteral("hello"));
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("a\\015\\012b")), QByteArrayLiteral("a\r\nb"));
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("\\033[1m")), QByteArrayLiteral("\033[1m"));
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("back\\134slash")), QByteArrayLiteral("back\\slash"));
+    // not an escape: too short or not octal
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("x\\01")), QByteArrayLiteral("x\\01"));
+    QCOMPARE(TmuxControlClient::unescapeOutput(QByteArrayLiteral("x\\089")), QByteArrayLiteral("x\\089"));
+}
+
+void TmuxControlClientTest::testBuildSendKeysCommands()
+{
+    QList<QByteArray> commands = TmuxControlClient::buildSendKeysCommands(QStringLiteral("%3"), QByteArrayLiteral("ls\r"));
+    QCOMPARE(commands.size(), 1);
+    QCOMPARE(commands.first(), QByteArrayLiteral("send-keys -H -t %3 6c 73 0d"));
+
+    commands = TmuxControlClient::buildSendKeysCommands(QString(), QByteArrayLiteral("\033"));
+    QCOMPARE(commands.first(), QByteArrayLiteral("send-keys -H 1b"));
+
+    const QByteArray paste(TmuxControlClient::MaxKeysPerCommand * 2 + 1, 'x');
+    commands = TmuxControlClient::buildSendKeysCommands(QStringLiteral("%0"), paste);
+    QCOMPARE(commands.size(), 3);
+    QCOMPARE(commands.last(), QByteArrayLiteral("send-keys -H -t %0 78"));
+
+    QVERIFY(TmuxControlClient::buildSendKeysCommands(QStringLiteral("%0"), QByteArray()).isEmpty());
+}
+
+void TmuxControlClientTest::testCommandReplies()
+{
+    QList<QByteArray> written;
+    TmuxControlClient client([&written](const QByteArray &data) {
+        written.append(data);
+    });
+
+    bool called = false;
+    bool success = false;
+    QList<QByteArray> replyLines;
+    client.sendCommand(QByteArrayLiteral("list-windows"), [&](bool ok, const QList<QByteArray> &lines) {
+        called = true;
+        success = ok;
+        replyLines = lines;
+    });
+    QCOMPARE(written.last(), QByteArrayLiteral("list-windows\n"));
+
+    // empty commands would detach the client and are never written
+    const int writes = written.size();
+    client.sendCommand(QByteArrayLiteral("  "));
+    QCOMPARE(written.size(), writes);
+
+    // a line which merely looks like the end of a block belongs to the reply
+    feed(client, QByteArrayLiteral("%begin 1700000000 7 1\r\n0: zsh\r\n%end 1 2 1\r\n1: claude\r\n"));
+    QVERIFY(!called);
+    feed(client, QByteArrayLiteral("%end 1700000000 7 1\r\n"));
+    QVERIFY(called);
+    QVERIFY(success);
+    const QList<QByteArray> expected{QByteArrayLiteral("0: zsh"), QByteArrayLiteral("%end 1 2 1"), QByteArrayLiteral("1: claude")};
+    QCOMPARE(replyLines, expected);
+
+    called = false;
+    client.sendCommand(QByteArrayLiteral("bogus"), [&](bool ok, const QList<QByteArray> &) {
+        called = true;
+        success = ok;
+    });
+    // split across reads
+    feed(client, QByteArrayLiteral("%begin 1700000001 8 1\r\nunknown com"));
+    feed(client, QByteArrayLiteral("mand: bogus\r\n%error 1700000001 8 1\r\n"));
+    QVERIFY(called);
+    QVERIFY(!success);
+}
+
+void TmuxControlClientTest::testMirrorSeedsFromCapture()
+{
+    QList<QByteArray> written;
+    TmuxControlClient client([&written](const QByteArray &data) {
+        written.append(data);
+    });
+    QSignalSpy output(&client, &TmuxControlClient::paneOutput);
+
+    client.setClientSize(120, 40);
+    QVERIFY(written.isEmpty());
+
+    finishAttach(client);
+    const QList<QByteArray> expectedCommands{QByteArrayLiteral("refresh-client -C 120,40\n"),
+                                             QByteArrayLiteral("capture-pane -p -e -S -\n"),
+                                             QByteArrayLiteral("display-message -p '#{pane_id} #{cursor_x} #{cursor_y}'\n")};
+    QCOMPARE(written, expectedCommands);
+    QVERIFY(client.isSeeding());
+
+    // already part of the capture
+    feed(client, QByteArrayLiteral("%output %1 old\r\n"));
+
+    feed(client, QByteArrayLiteral("%begin 1700000000 101 1\r\n%end 1700000000 101 1\r\n"));
+    feed(client, QByteArrayLiteral("%begin 1700000000 102 1\r\n\033[1mfirst\033[0m\r\nsecond\r\n%end 1700000000 102 1\r\n"));
+    // arrived after the capture, must be replayed after the seed
+    feed(client, QByteArrayLiteral("%output %1 new\\015\\012\r\n%output %2 other pane\r\n"));
+    QCOMPARE(output.count(), 0);
+
+    feed(client, QByteArrayLiteral("%begin 1700000000 103 1\r\n%1 6 1\r\n%end 1700000000 103 1\r\n"));
+    QVERIFY(!client.isSeeding());
+    QCOMPARE(client.paneId(), QStringLiteral("%1"));
+
+    QCOMPARE(output.count(), 2);
+    QCOMPARE(output.at(0).at(0).toByteArray(), QByteArrayLiteral("\033[1mfirst\033[0m\r\nsecond\033[0m\033[2;7H"));
+    QCOMPARE(output.at(1).at(0).toByteArray(), QByteArrayLiteral("new\r\n"));
+
+    // live output of the mirrored pane only
+    feed(client, QByteArrayLiteral("%output %2 ignored\r\n%output %1 live\r\n"));
+    QCOMPARE(output.count(), 3);
+    QCOMPARE(output.at(2).at(0).toByteArray(), QByteArrayLiteral("live"));
+
+    written.clear();
+    client.sendInput(QByteArrayLiteral("y"));
+    QCOMPARE(written, QList<QByteArray>{QByteArrayLiteral("send-keys -H -t %1 79\n")});
+}
+
+void TmuxControlClientTest::testInputHeldUntilAttached()
+{
+    QList<QByteArray> written;
+    TmuxControlClient client([&written](const QByteArray &data) {
+        written.append(data);
+    });
+
+    client.sendInput(QByteArrayLiteral("hi"));
+    QVERIFY(written.isEmpty());
+
+    finishAttach(client);
+    QCOMPARE(written.last(), QByteArrayLiteral("send-keys -H 68 69\n"));
+}
+
+void TmuxControlClientTest::testNotifications()
+{
+    TmuxControlClient client([](const QByteArray &) { });
+    QSignalSpy notification(&client, &TmuxControlClient::notification);
+    QSignalSpy exited(&client, &TmuxControlClient::exited);
+
+    feed(client, QByteArrayLiteral("%layout-change @0 b25d,80x24,0,0,0\r\n%exit detached\r\n"));
+
+    QCOMPARE(notification.count(), 1);
+    QCOMPARE(notification.at(0).at(0).toByteArray(), QByteArrayLiteral("layout-change"));
+    QCOMPARE(notification.at(0).at(1).toByteArray(), QByteArrayLiteral("@0 b25d,80x24,0,0,0"));
+    QCOMPARE(exited.count(), 1);
+    QCOMPARE(exited.at(0).at(0).toString(), QStringLiteral("detached"));
+}
+
+QTEST_GUILESS_MAIN(Konsolai::TmuxControlClientTest)
+
+#include "TmuxControlClientTest.moc"
@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TMUXCONTROLCLIENTTEST_H
+#define TMUXCONTROLCLIENTTEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class TmuxControlClientTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testUnescapeOutput();
+    void testBuildSendKeysCommands();
+    void testCommandReplies();
+    void testMirrorSeedsFromCapture();
+    void testInputHeldUntilAttached();
+    void testNotifications();
+};
+
+}
+
+#endif // TMUXCONTROLCLIENTTEST_H
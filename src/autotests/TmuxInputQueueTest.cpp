@@ -0,0 +1,239 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "TmuxInputQueueTest.h"
+
+// Qt
+#include <QSignalSpy>
+#include <QTest>
+
+// Konsolai
+#include "../claude/TmuxInputQueue.h"
+
+using namespace Konsolai;
+
+namespace
+{
+// Records every tmux invocation and lets the test decide when it finishes
+struct FakeTmux {
+    struct Call {
+        QStringList args;
+        QByteArray input;
+        TmuxInputQueue::Done done;
+    };
+    QList<Call> calls;
+
+    TmuxInputQueue::Runner runner()
+    {
+        return [this](const QStringList &args, const QByteArray &input, TmuxInputQueue::Done done) {
+            calls.append({args, input, std::move(done)});
+        };
+    }
+
+    void finish(int index, bool ok = true)
+    {
+        // the callback starts the next step, which appends to calls
+        const TmuxInputQueue::Done done = calls.at(index).done;
+        done(ok);
+    }
+};
+}
+
+void TmuxInputQueueTest::testStepsWaitForAcknowledgement()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("konsolai-test"), tmux.runner());
+
+    queue.sendKey(QStringLiteral("Down"));
+    queue.sendKey(QStringLiteral("Down"));
+    queue.sendText(QStringLiteral("\n"));
+
+    // only the first step runs until tmux reports back
+    QCOMPARE(tmux.calls.size(), 1);
+    QVERIFY(queue.isBusy());
+    QCOMPARE(queue.pendingCount(), 2);
+    QCOMPARE(tmux.calls.at(0).args, QStringList({QStringLiteral("send-keys"), QStringLiteral("-t"), QStringLiteral("konsolai-test"), QStringLiteral("Down")}));
+
+    QSignalSpy drainedSpy(&queue, &TmuxInputQueue::drained);
+    tmux.finish(0);
+    QCOMPARE(tmux.calls.size(), 2);
+    tmux.finish(1);
+    QCOMPARE(tmux.calls.size(), 3);
+    QCOMPARE(tmux.calls.at(2).args.last(), QStringLiteral("\r"));
+    QCOMPARE(drainedSpy.count(), 0);
+
+    tmux.finish(2);
+    QVERIFY(!queue.isBusy());
+    QCOMPARE(drainedSpy.count(), 1);
+}
+
+void TmuxInputQueueTest::testShortTextIsTyped()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("s"), tmux.runner());
+
+    queue.sendText(QStringLiteral("n\n"));
+    QCOMPARE(tmux.calls.size(), 1);
+    QCOMPARE(tmux.calls.at(0).args, QStringList({QStringLiteral("send-keys"), QStringLiteral("-t"), QStringLiteral("s"), QStringLiteral("-l"), QStringLiteral("n\r")}));
+    QVERIFY(tmux.calls.at(0).input.isEmpty());
+
+    // empty text finishes without running tmux
+    tmux.finish(0);
+    bool called = false;
+    queue.sendText(QString(), [&called](bool ok) {
+        called = ok;
+    });
+    QVERIFY(called);
+    QCOMPARE(tmux.calls.size(), 1);
+}
+
+void TmuxInputQueueTest::testLongTextIsPasted()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("s"), tmux.runner());
+
+    const QString text(TmuxInputQueue::PasteThreshold + 1, QLatin1Char('x'));
+    queue.sendText(text + QLatin1Char('\n'));
+
+    QCOMPARE(tmux.calls.size(), 1);
+    const QStringList &args = tmux.calls.at(0).args;
+    QCOMPARE(args.at(0), QStringLiteral("load-buffer"));
+    QCOMPARE(args.at(3), QStringLiteral("-"));
+    QVERIFY(args.contains(QStringLiteral("paste-buffer")));
+    QVERIFY(!args.contains(text));
+    QCOMPARE(tmux.calls.at(0).input, text.toUtf8());
+
+    // the trailing newline becomes an Enter after the paste
+    tmux.finish(0);
+    QCOMPARE(tmux.calls.size(), 2);
+    QCOMPARE(tmux.calls.at(1).args.last(), QStringLiteral("Enter"));
+}
+
+void TmuxInputQueueTest::testPromptPastesThenSubmits()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("s"), tmux.runner());
+
+    bool result = false;
+    int doneCount = 0;
+    const QString prompt = QStringLiteral("Fix the bug\nand add a test ✓");
+    queue.sendPrompt(prompt, [&](bool ok) {
+        result = ok;
+        ++doneCount;
+    });
+
+    QCOMPARE(tmux.calls.size(), 1);
+    const QStringList &args = tmux.calls.at(0).args;
+    const QString buffer = args.at(2);
+    QCOMPARE(args,
+             QStringList({QStringLiteral("load-buffer"),
+                          QStringLiteral("-b"),
+                          buffer,
+                          QStringLiteral("-"),
+                          QStringLiteral(";"),
+                          QStringLiteral("paste-buffer"),
+                          QStringLiteral("-p"),
+                          QStringLiteral("-d"),
+                          QStringLiteral("-b"),
+                          buffer,
+                          QStringLiteral("-t"),
+                          QStringLiteral("s")}));
+    QCOMPARE(tmux.calls.at(0).input, prompt.toUtf8());
+
+    tmux.finish(0);
+    QCOMPARE(doneCount, 0);
+    QCOMPARE(tmux.calls.size(), 2);
+    QCOMPARE(tmux.calls.at(1).args, QStringList({QStringLiteral("send-keys"), QStringLiteral("-t"), QStringLiteral("s"), QStringLiteral("Enter")}));
+
+    tmux.finish(1);
+    QCOMPARE(doneCount, 1);
+    QVERIFY(result);
+
+    // buffer names are never reused
+    queue.sendPrompt(prompt);
+    QVERIFY(tmux.calls.at(2).args.at(2) != buffer);
+}
+
+void TmuxInputQueueTest::testFailedStepDoesNotStall()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("s"), tmux.runner());
+
+    bool result = true;
+    queue.sendPrompt(QStringLiteral("hello"), [&result](bool ok) {
+        result = ok;
+    });
+    queue.sendKey(QStringLiteral("C-c"));
+
+    // without the text, Enter would submit whatever the input field held;
+    // the buffer is deleted as paste-buffer -d never ran
+    const QString buffer = tmux.calls.at(0).args.at(2);
+    tmux.finish(0, false);
+    QVERIFY(!result);
+    QCOMPARE(tmux.calls.size(), 3);
+    QCOMPARE(tmux.calls.at(1).args, QStringList({QStringLiteral("delete-buffer"), QStringLiteral("-b"), buffer}));
+    QCOMPARE(tmux.calls.at(2).args.last(), QStringLiteral("C-c"));
+    QVERIFY(!queue.pendingCount());
+}
+
+void TmuxInputQueueTest::testClear()
+{
+    FakeTmux tmux;
+    TmuxInputQueue queue(QStringLiteral("s"), tmux.runner());
+
+    queue.sendKey(QStringLiteral("Tab"));
+    queue.sendKey(QStringLiteral("Enter"));
+    queue.clear();
+    QCOMPARE(queue.pendingCount(), 0);
+
+    tmux.finish(0);
+    QCOMPARE(tmux.calls.size(), 1);
+    QVERIFY(!queue.isBusy());
+}
+
+void TmuxInputQueueTest::testBroadcastPrompt()
+{
+    FakeTmux tmux;
+    TmuxInputQueue a(QStringLiteral("a"), tmux.runner());
+    TmuxInputQueue b(QStringLiteral("b"), tmux.runner());
+    TmuxInputQueue c(QStringLiteral("c"), tmux.runner());
+
+    // the prompt waits for input already queued on a session
+    a.sendKey(QStringLiteral("Escape"));
+
+    bool called = false;
+    bool result = true;
+    TmuxInputQueue::broadcastPrompt({&a, &b, &c}, QStringLiteral("continue"), [&](bool ok) {
+        called = true;
+        result = ok;
+    });
+    QCOMPARE(tmux.calls.size(), 3);
+    QCOMPARE(tmux.calls.at(0).args.last(), QStringLiteral("Escape"));
+    QCOMPARE(tmux.calls.at(1).args.last(), QStringLiteral("b"));
+    QCOMPARE(tmux.calls.at(1).input, QByteArray("continue"));
+    QCOMPARE(tmux.calls.at(2).args.last(), QStringLiteral("c"));
+
+    // a paste failing in one session keeps Enter from it, not from the others
+    tmux.finish(1, false);
+    tmux.finish(2);
+    QCOMPARE(tmux.calls.size(), 5);
+    QCOMPARE(tmux.calls.at(3).args.first(), QStringLiteral("delete-buffer"));
+    QCOMPARE(tmux.calls.at(4).args, TmuxInputQueue::buildKeyArgs(QStringLiteral("c"), QStringLiteral("Enter")));
+
+    tmux.finish(0);
+    QCOMPARE(tmux.calls.size(), 6);
+    QCOMPARE(tmux.calls.at(5).args.first(), QStringLiteral("load-buffer"));
+    tmux.finish(5);
+    tmux.finish(6);
+    QVERIFY(!called);
+    tmux.finish(4);
+    QVERIFY(called);
+    QVERIFY(!result);
+}
+
+QTEST_GUILESS_MAIN(Konsolai::TmuxInputQueueTest)
+
+#include "TmuxInputQueueTest.moc"
@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TMUXINPUTQUEUETEST_H
+#define TMUXINPUTQUEUETEST_H
+
+#include <QObject>
+
+namespace Konsolai
+{
+
+class TmuxInputQueueTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testStepsWaitForAcknowledgement();
+    void testShortTextIsTyped();
+    void testLongTextIsPasted();
+    void testPromptPastesThenSubmits();
+    void testFailedStepDoesNotStall();
+    void testClear();
+    void testBroadcastPrompt();
+};
+
+}
+
+#endif // TMUXINPUTQUEUETEST_H
@@ -8,9 +8,12 @@
 #include "TmuxManagerTest.h"
 
 // Qt
+#include <QFile>
+#include <QProcess>
 #include <QRegularExpression>
 #include <QSignalSpy>
 #include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QTest>
 
 // Konsolai
@@ -435,6 +438,29 @@ void TmuxManagerTest::testGetPanePidAsyncNonexistent()
     QCOMPARE(pid, qint64(0));
 }
 
+void TmuxManagerTest::testExecuteCommandAsyncFailedToStart()
+{
+    // Without tmux on the PATH the process never starts, and never finishes
+    QTemporaryDir emptyDir;
+    QVERIFY(emptyDir.isValid());
+    const QByteArray path = qgetenv("PATH");
+    qputenv("PATH", QFile::encodeName(emptyDir.path()));
+
+    TmuxManager manager;
+    int callbackCount = 0;
+    bool ok = true;
+    manager.executeCommandAsync({QStringLiteral("list-sessions")}, QByteArray("input"), [&](bool success, const QString &) {
+        ++callbackCount;
+        ok = success;
+    });
+    qputenv("PATH", path);
+
+    QTRY_COMPARE_WITH_TIMEOUT(callbackCount, 1, 5000);
+    QVERIFY(!ok);
+    QTRY_VERIFY(manager.findChildren<QProcess *>().isEmpty());
+    QCOMPARE(callbackCount, 1);
+}
+
 // ============================================================
 // Async kill tests
 // ============================================================
@@ -538,6 +564,22 @@ void TmuxManagerTest::testBuildAttachCommandPassthrough()
     QVERIFY(cmd.contains(QStringLiteral("set-option")));
 }
 
+void TmuxManagerTest::testBuildControlModeCommands()
+{
+    TmuxManager manager;
+
+    // Control mode is opt-in
+    QVERIFY(!manager.buildNewSessionCommand(QStringLiteral("konsolai-test-12345678"), QStringLiteral("claude")).contains(QStringLiteral("-CC")));
+    QVERIFY(!manager.buildAttachCommand(QStringLiteral("konsolai-test-12345678")).contains(QStringLiteral("-CC")));
+
+    QString cmd = manager.buildNewSessionCommand(QStringLiteral("konsolai-test-12345678"), QStringLiteral("claude"), true, QString(), true);
+    QVERIFY(cmd.startsWith(QStringLiteral("tmux -CC new-session -A")));
+    QVERIFY(cmd.contains(QStringLiteral("allow-passthrough")));
+
+    cmd = manager.buildAttachCommand(QStringLiteral("konsolai-test-12345678"), true);
+    QVERIFY(cmd.startsWith(QStringLiteral("tmux -CC attach-session -t konsolai-test-12345678")));
+}
+
 // ============================================================
 // Build new session command with all options combined
 // ============================================================
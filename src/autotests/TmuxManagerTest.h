@@ -62,6 +62,7 @@ private Q_SLOTS:
     void testCapturePaneAsyncNonexistent();
     void testListKonsolaiSessionsAsync();
     void testGetPanePidAsyncNonexistent();
+    void testExecuteCommandAsyncFailedToStart();
 
     // Async kill tests
     void testKillSessionAsyncNonexistent();
@@ -71,6 +72,7 @@ private Q_SLOTS:
 
     // Attach command passthrough
     void testBuildAttachCommandPassthrough();
+    void testBuildControlModeCommands();
 
     // Build new session command with all options
     void testBuildNewSessionCommandAllOptions();
@@ -10,6 +10,7 @@
 // Qt
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSignalSpy>
@@ -20,6 +21,7 @@
 
 // Konsolai
 #include "../claude/ClaudeSession.h"
+#include "../claude/TranscriptTailer.h"
 
 using namespace Konsolai;
 
@@ -590,8 +592,8 @@ void TokenTrackingTest::testFileWatcherTriggersRefresh()
 
 void TokenTrackingTest::testFileWatcherDebounces()
 {
-    // Adding multiple files rapidly should only trigger ONE refresh after the
-    // 500ms debounce settles, not one refresh per file addition.
+    // Adding multiple files rapidly should only trigger ONE refresh once the
+    // 250ms coalescing timer fires, not one refresh per file addition.
     QTemporaryDir tmpDir;
     QVERIFY(tmpDir.isValid());
     QString workDir = tmpDir.path();
@@ -608,10 +610,10 @@ void TokenTrackingTest::testFileWatcherDebounces()
     for (int i = 1; i <= 5; ++i) {
         QString fname = QStringLiteral("conversation_%1.jsonl").arg(i);
         setupProjectDir(workDir, makeAssistantLine(10 * i, 5 * i) + "\n", fname);
-        QTest::qWait(40); // 40ms between files — well under 500ms debounce
+        QTest::qWait(40); // 40ms between files — well under the 250ms coalescing
     }
 
-    // Wait for debounce to fire (500ms + margin)
+    // Wait for the coalesced refresh to fire (250ms + margin)
     QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 1, 1500);
 
     // Give it another 200ms to ensure no extra signals arrive
@@ -624,6 +626,232 @@ void TokenTrackingTest::testFileWatcherDebounces()
     cleanupProjectDir(workDir);
 }
 
+void TokenTrackingTest::testFileWatcherCoalescesSteadyWrites()
+{
+    // Streaming appends keep coming faster than the coalescing interval; the
+    // refresh must still happen while they do, not once they settle.
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QString workDir = tmpDir.path();
+
+    QString filePath = setupProjectDir(workDir, makeAssistantLine(10, 5) + "\n");
+
+    ClaudeSession session(QStringLiteral("test"), workDir);
+    session.startTokenTracking();
+    QSignalSpy spy(&session, &ClaudeSession::tokenUsageChanged);
+
+    for (int i = 0; i < 15 && spy.isEmpty(); ++i) {
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write(makeAssistantLine(10, 5) + "\n");
+        file.close();
+        QTest::qWait(100);
+    }
+    QVERIFY(spy.count() >= 1);
+
+    cleanupProjectDir(workDir);
+}
+
+void TokenTrackingTest::testAppendedRecordsFeedVelocity()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QString workDir = tmpDir.path();
+
+    // History of a resumed conversation
+    QString filePath = setupProjectDir(workDir, makeAssistantLine(50000, 10000) + "\n");
+
+    ClaudeSession session(QStringLiteral("test"), workDir);
+    SessionBudget budget;
+    budget.tokenCeiling = 80000;
+    session.budgetController()->setBudget(budget);
+    QSignalSpy exceededSpy(session.budgetController(), &BudgetController::budgetExceeded);
+
+    session.refreshTokenUsage();
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(60000));
+    // Read at once, but not spent right now
+    QCOMPARE(session.budgetController()->velocity().tokensPerMinute(), 0.0);
+    QCOMPARE(exceededSpy.count(), 0);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(makeAssistantLine(10000, 5000) + "\n");
+    file.write(makeAssistantLine(10000, 5000) + "\n");
+    file.close();
+
+    session.refreshTokenUsage();
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(90000));
+    QVERIFY(session.budgetController()->velocity().tokensPerMinute() > 0.0);
+    QVERIFY(session.tokensPerMinute(15) > session.tokensPerMinute(300));
+    // Tripped once, by the record crossing the ceiling
+    QCOMPARE(exceededSpy.count(), 1);
+    QVERIFY(session.budgetController()->budget().tokenExceeded);
+
+    cleanupProjectDir(workDir);
+}
+
+// ============================================================
+// Subagent transcript tailing
+// ============================================================
+
+static void appendTo(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Append));
+    f.write(data);
+}
+
+static QString toJson(const QJsonObject &obj)
+{
+    return QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+// Starts subagent @p agentId of @p session and returns the path of its transcript
+static QString startSubagent(ClaudeSession &session, const QString &parentTranscript, const QString &agentId)
+{
+    QJsonObject data;
+    data[QStringLiteral("agent_id")] = agentId;
+    data[QStringLiteral("agent_type")] = QStringLiteral("general-purpose");
+    data[QStringLiteral("transcript_path")] = parentTranscript;
+    session.claudeProcess()->handleHookEvent(QStringLiteral("SubagentStart"), toJson(data));
+    return session.subagents().value(agentId).transcriptPath;
+}
+
+static void stopSubagent(ClaudeSession &session, const QString &agentId)
+{
+    QJsonObject data;
+    data[QStringLiteral("agent_id")] = agentId;
+    data[QStringLiteral("agent_type")] = QStringLiteral("general-purpose");
+    session.claudeProcess()->handleHookEvent(QStringLiteral("SubagentStop"), toJson(data));
+}
+
+void TokenTrackingTest::testTailerReadsCompleteLinesOnly()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("agent-a.jsonl"));
+
+    TranscriptTailer tailer;
+    tailer.follow(QStringLiteral("a"), path);
+
+    // Not created yet
+    QVERIFY(tailer.poll().isEmpty());
+
+    const QByteArray line = makeAssistantLine(100, 50);
+    appendTo(path, makeAssistantLine(10, 5) + "\n" + line.left(line.size() / 2));
+    auto added = tailer.poll();
+    QCOMPARE(added.value(QStringLiteral("a")).totalTokens(), quint64(15));
+
+    // The rest of the line arrives
+    appendTo(path, line.mid(line.size() / 2) + "\n");
+    added = tailer.poll();
+    QCOMPARE(added.value(QStringLiteral("a")).totalTokens(), quint64(150));
+
+    // Nothing new
+    QVERIFY(tailer.poll().isEmpty());
+}
+
+void TokenTrackingTest::testTailerRetiredTranscriptNotReread()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString path = tmpDir.filePath(QStringLiteral("agent-b.jsonl"));
+    appendTo(path, makeAssistantLine(10, 5) + "\n");
+
+    TranscriptTailer tailer;
+    tailer.follow(QStringLiteral("b"), path);
+    QCOMPARE(tailer.poll().value(QStringLiteral("b")).totalTokens(), quint64(15));
+
+    // Lines written before retiring are still read once
+    appendTo(path, makeAssistantLine(20, 10) + "\n");
+    tailer.retire(QStringLiteral("b"));
+    QCOMPARE(tailer.poll().value(QStringLiteral("b")).totalTokens(), quint64(30));
+    QVERIFY(!tailer.isFollowing(QStringLiteral("b")));
+
+    appendTo(path, makeAssistantLine(1000, 1000) + "\n");
+    QVERIFY(tailer.poll().isEmpty());
+}
+
+void TokenTrackingTest::testSubagentTokensRolledUp()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QString workDir = tmpDir.path();
+
+    const QString parent = setupProjectDir(workDir, makeAssistantLine(1000, 500) + "\n");
+
+    ClaudeSession session(QStringLiteral("test"), workDir);
+    session.refreshTokenUsage();
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(1500));
+
+    const QString transcript = startSubagent(session, parent, QStringLiteral("sub1"));
+    QVERIFY(transcript.endsWith(QStringLiteral("/subagents/agent-sub1.jsonl")));
+    appendTo(transcript, makeAssistantLine(200, 100, 0, 0, QStringLiteral("claude-haiku-4-5")) + "\n");
+
+    QSignalSpy spy(&session, &ClaudeSession::tokenUsageChanged);
+    session.refreshTokenUsage();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(1800));
+    QCOMPARE(session.subagentTokenUsage().totalTokens(), quint64(300));
+
+    const SubagentInfo info = session.subagents().value(QStringLiteral("sub1"));
+    QCOMPARE(info.tokenUsage.totalTokens(), quint64(300));
+    QCOMPARE(info.tokenUsage.detectedModel, QStringLiteral("claude-haiku-4-5"));
+    QVERIFY(info.tokenUsage.estimatedCostUSD() > 0.0);
+
+    // The context window shown is the top-level conversation's
+    QCOMPARE(session.tokenUsage().lastContextTokens, quint64(1000));
+
+    // Written just before the agent stopped: read once, then never again
+    appendTo(transcript, makeAssistantLine(50, 50) + "\n");
+    stopSubagent(session, QStringLiteral("sub1"));
+    session.refreshTokenUsage();
+    QCOMPARE(session.subagentTokenUsage().totalTokens(), quint64(400));
+
+    appendTo(transcript, makeAssistantLine(5000, 5000) + "\n");
+    session.refreshTokenUsage();
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(1900));
+
+    cleanupProjectDir(workDir);
+}
+
+void TokenTrackingTest::testTeamTokenAttribution()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QString workDir = tmpDir.path();
+
+    const QString parent = setupProjectDir(workDir, makeAssistantLine(10, 10) + "\n");
+
+    ClaudeSession session(QStringLiteral("test"), workDir);
+    const QString teammate = startSubagent(session, parent, QStringLiteral("mate"));
+    appendTo(teammate, makeAssistantLine(100, 100) + "\n");
+    session.refreshTokenUsage();
+    QVERIFY(session.teamTokenUsage().isEmpty());
+
+    // Named as a teammate later on; what it spent so far counts for the team
+    QJsonObject idle;
+    idle[QStringLiteral("teammate_name")] = QStringLiteral("researcher");
+    idle[QStringLiteral("team_name")] = QStringLiteral("alpha");
+    session.claudeProcess()->handleHookEvent(QStringLiteral("TeammateIdle"), toJson(idle));
+    QCOMPARE(session.teamTokenUsage().value(QStringLiteral("alpha")).totalTokens(), quint64(200));
+
+    appendTo(teammate, makeAssistantLine(30, 20) + "\n");
+    session.refreshTokenUsage();
+    QCOMPARE(session.teamTokenUsage().value(QStringLiteral("alpha")).totalTokens(), quint64(250));
+
+    // A plain Task subagent counts for the session only
+    const QString helper = startSubagent(session, parent, QStringLiteral("helper"));
+    appendTo(helper, makeAssistantLine(7, 3) + "\n");
+    session.refreshTokenUsage();
+    QCOMPARE(session.teamTokenUsage().value(QStringLiteral("alpha")).totalTokens(), quint64(250));
+    QCOMPARE(session.subagentTokenUsage().totalTokens(), quint64(260));
+    QCOMPARE(session.tokenUsage().totalTokens(), quint64(280));
+
+    cleanupProjectDir(workDir);
+}
+
 QTEST_GUILESS_MAIN(TokenTrackingTest)
 
 #include "moc_TokenTrackingTest.cpp"
@@ -42,6 +42,14 @@ private Q_SLOTS:
     void testTokenRefreshTimerStarted();
     void testFileWatcherTriggersRefresh();
     void testFileWatcherDebounces();
+    void testFileWatcherCoalescesSteadyWrites();
+    void testAppendedRecordsFeedVelocity();
+
+    // Subagent transcript tailing
+    void testTailerReadsCompleteLinesOnly();
+    void testTailerRetiredTranscriptNotReread();
+    void testSubagentTokensRolledUp();
+    void testTeamTokenAttribution();
 };
 
 }
@@ -7,8 +7,14 @@
 // Own
 #include "Vt102EmulationTest.h"
 
+#include <QElapsedTimer>
+#include <QSignalSpy>
 #include <QTest>
 
+#include <memory>
+
+#include "ScreenWindow.h"
+
 // The below is to verify the old #defines match the new constexprs
 // Just copy/paste for now from Vt102Emulation.cpp
 /* clang-format off */
@@ -432,6 +438,132 @@ void Vt102EmulationTest::testTokenFunctions()
     QCOMPARE(token_vt52('>'), TY_VT52('>'));
 }
 
+namespace
+{
+// A line of typical agent output: colors, an emoji and plain text
+const QByteArray StreamingLine = QByteArrayLiteral("\033[32m\xe2\x9c\x93\033[0m Reading src/Emulation.cpp (42 lines) \xf0\x9f\x93\x84 done\r\n");
+}
+
+void Vt102EmulationTest::testBackgroundModeThrottlesUpdates()
+{
+    Vt102Emulation em;
+    em.reset();
+    em.setCodec(Vt102Emulation::Utf8Codec);
+    em.setBackgroundMode(true);
+    QVERIFY(em.isInBackgroundMode());
+
+    QSignalSpy outputChanged(&em, &Emulation::outputChanged);
+
+    // stream for a bit over a second, much faster than the foreground bulk timers
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (elapsed.elapsed() < 1100) {
+        em.receiveData(StreamingLine.constData(), StreamingLine.size());
+        QTest::qWait(5);
+    }
+
+    // activity is still reported, but only every BackgroundUpdateInterval
+    QVERIFY(outputChanged.count() >= 1);
+    QVERIFY(outputChanged.count() <= 1100 / Emulation::BackgroundUpdateInterval + 1);
+
+    // coming back to the foreground delivers pending output immediately
+    em.receiveData(StreamingLine.constData(), StreamingLine.size());
+    const int before = outputChanged.count();
+    em.setBackgroundMode(false);
+    QCOMPARE(outputChanged.count(), before + 1);
+}
+
+void Vt102EmulationTest::testSuspendedWindowCatchUp()
+{
+    Vt102Emulation em;
+    em.reset();
+    em.setCodec(Vt102Emulation::Utf8Codec);
+    // owned by the emulation
+    ScreenWindow *window = em.createWindow();
+
+    QSignalSpy emulationChanged(&em, &Emulation::outputChanged);
+    QSignalSpy windowChanged(window, &ScreenWindow::outputChanged);
+
+    window->setUpdatesSuspended(true);
+    for (int i = 0; i < 3; ++i) {
+        em.receiveData(StreamingLine.constData(), StreamingLine.size());
+        QVERIFY(emulationChanged.wait(1000));
+    }
+    QCOMPARE(windowChanged.count(), 0);
+
+    // a single catch-up notification, however much output arrived
+    window->setUpdatesSuspended(false);
+    QCOMPARE(windowChanged.count(), 1);
+
+    // nothing pending, nothing emitted
+    window->setUpdatesSuspended(true);
+    window->setUpdatesSuspended(false);
+    QCOMPARE(windowChanged.count(), 1);
+}
+
+void Vt102EmulationTest::benchmarkBackgroundStreaming_data()
+{
+    QTest::addColumn<bool>("hidden");
+
+    QTest::newRow("visible") << false;
+    QTest::newRow("hidden") << true;
+}
+
+void Vt102EmulationTest::benchmarkBackgroundStreaming()
+{
+    // 30 tabs streaming output for a second.  The result is the time spent
+    // on all of them together: parsing, plus fetching the image each time a
+    // view would redraw.  Idle time between the chunks is not counted.
+    QFETCH(bool, hidden);
+    constexpr int TabCount = 30;
+
+    std::vector<std::unique_ptr<Vt102Emulation>> emulations;
+    qint64 busyNs = 0;
+    int renders = 0;
+    for (int i = 0; i < TabCount; ++i) {
+        auto em = std::make_unique<Vt102Emulation>();
+        em->reset();
+        em->setCodec(Vt102Emulation::Utf8Codec);
+        em->setBackgroundMode(hidden);
+        ScreenWindow *window = em->createWindow();
+        window->setUpdatesSuspended(hidden);
+        connect(window, &ScreenWindow::outputChanged, this, [window, &busyNs, &renders]() {
+            QElapsedTimer render;
+            render.start();
+            // what TerminalDisplay::updateImage() starts with
+            window->getImage();
+            ++renders;
+            busyNs += render.nsecsElapsed();
+        });
+        emulations.push_back(std::move(em));
+    }
+
+    QByteArray chunk;
+    for (int i = 0; i < 5; ++i) {
+        chunk += StreamingLine;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QElapsedTimer parse;
+    while (elapsed.elapsed() < 1000) {
+        parse.start();
+        for (const auto &em : emulations) {
+            em->receiveData(chunk.constData(), chunk.size());
+        }
+        busyNs += parse.nsecsElapsed();
+        QTest::qWait(5);
+    }
+    QTest::setBenchmarkResult(busyNs / 1e6, QTest::WalltimeMilliseconds);
+
+    // hidden tabs are parsed, but none of their windows asks for a redraw
+    if (hidden) {
+        QCOMPARE(renders, 0);
+    } else {
+        QVERIFY(renders > 0);
+    }
+}
+
 QTEST_GUILESS_MAIN(Vt102EmulationTest)
 
 #include "moc_Vt102EmulationTest.cpp"
@@ -32,6 +32,11 @@ private Q_SLOTS:
     void testTokenizingVT52_data();
     void testTokenizingVT52();
 
+    void testBackgroundModeThrottlesUpdates();
+    void testSuspendedWindowCatchUp();
+    void benchmarkBackgroundStreaming_data();
+    void benchmarkBackgroundStreaming();
+
 private:
     static void sendAndCompare(TestEmulation *em, const char *input, size_t inputLen, const QString &expectedPrint, const QByteArray &expectedSent);
 };
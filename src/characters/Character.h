@@ -358,6 +358,16 @@ public:
         return stringWidth(ucs4Str.data(), ucs4Str.size(), ignoreWcWidth);
     }
 
+    /** Adds the extended char keys of the @p count @p cells to @p keys. */
+    static void collectExtendedChars(const Character *cells, int count, QSet<uint> &keys)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (cells[i].rendition.f.extended) {
+                keys << cells[i].character;
+            }
+        }
+    }
+
     inline uint baseCodePoint() const
     {
         if (rendition.f.extended) {
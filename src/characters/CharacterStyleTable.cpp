@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "CharacterStyleTable.h"
+
+using namespace Konsole;
+
+size_t CharacterStyleTable::memoryUsage() const
+{
+    // QHash keeps an offset byte per bucket and a node per entry
+    return _styles.capacity() * sizeof(Style) + size_t(_index.size()) * (sizeof(Style) + sizeof(quint32)) + size_t(_index.capacity());
+}
+
+void CharacterStyleTable::clear()
+{
+    _styles.clear();
+    _index.clear();
+    _lastStyle = 0;
+}
@@ -0,0 +1,188 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef CHARACTERSTYLETABLE_H
+#define CHARACTERSTYLETABLE_H
+
+// Konsole
+#include "Character.h"
+
+// Qt
+#include <QHash>
+
+// std
+#include <cstring>
+#include <vector>
+
+namespace Konsole
+{
+/**
+ * A cell whose colors and flags are stored once in a CharacterStyleTable.
+ *
+ * Half the size of a Character.  Two cells interned in the same table are
+ * equal exactly when their characters, colors, rendition and extra flags
+ * are, so comparing them is a single 64-bit compare.
+ */
+struct PackedCharacter {
+    /** As Character::character */
+    char32_t character;
+    /** Index into the style table */
+    quint32 style;
+
+    quint64 key() const
+    {
+        return quint64(style) << 32 | character;
+    }
+
+    friend bool operator==(const PackedCharacter &a, const PackedCharacter &b)
+    {
+        return a.key() == b.key();
+    }
+
+    friend bool operator!=(const PackedCharacter &a, const PackedCharacter &b)
+    {
+        return a.key() != b.key();
+    }
+};
+static_assert(sizeof(PackedCharacter) == 8, "PackedCharacter is meant to be 8 bytes");
+
+/**
+ * Interns the styles (colors, rendition and extra flags) of characters.
+ *
+ * Terminal content uses few distinct styles, so storing each once and
+ * keeping only its index per cell halves the memory of a cell.  Each
+ * store of cells has its own table; a PackedCharacter only means something
+ * together with the table it was packed with.  character() and unpack()
+ * give back the full Character for code which works with those.
+ *
+ * Styles are never removed individually.  A store whose cells come and go
+ * calls compact() with its live cells now and then, so styles no longer
+ * used don't pile up, e.g. with programs drawing 24-bit color gradients.
+ */
+class CharacterStyleTable
+{
+public:
+    CharacterStyleTable() = default;
+
+    /** Returns the style index of @p c, adding its style if new. */
+    quint32 intern(const Character &c)
+    {
+        const Style style = styleOf(c);
+        // Neighbouring cells mostly share their style
+        if (!_styles.empty() && style == _styles[_lastStyle]) {
+            return _lastStyle;
+        }
+        auto it = _index.constFind(style);
+        if (it != _index.constEnd()) {
+            _lastStyle = it.value();
+            return _lastStyle;
+        }
+        _lastStyle = quint32(_styles.size());
+        _styles.push_back(style);
+        _index.insert(style, _lastStyle);
+        return _lastStyle;
+    }
+
+    PackedCharacter pack(const Character &c)
+    {
+        return PackedCharacter{c.character, intern(c)};
+    }
+
+    void pack(const Character *characters, int count, PackedCharacter *out)
+    {
+        for (int i = 0; i < count; ++i) {
+            out[i] = pack(characters[i]);
+        }
+    }
+
+    /** The full character of a cell packed with this table. */
+    Character character(PackedCharacter packed) const
+    {
+        const Style &style = _styles[packed.style];
+        return Character(packed.character, style.foregroundColor, style.backgroundColor, style.rendition, style.flags);
+    }
+
+    template<typename Iterator>
+    void unpack(Iterator first, Iterator last, Character *out) const
+    {
+        for (; first != last; ++first, ++out) {
+            *out = character(*first);
+        }
+    }
+
+    /** Number of distinct styles stored. */
+    int size() const
+    {
+        return int(_styles.size());
+    }
+
+    /** Approximate number of bytes used by the table. */
+    size_t memoryUsage() const;
+
+    void clear();
+
+    /**
+     * Drops the styles not used by the cells in [@p first, @p last), which
+     * are renumbered accordingly.  Cells packed with this table elsewhere
+     * become invalid.
+     */
+    template<typename Iterator>
+    void compact(Iterator first, Iterator last)
+    {
+        constexpr quint32 unused = ~quint32(0);
+        std::vector<quint32> renumbered(_styles.size(), unused);
+        CharacterStyleTable compacted;
+        for (; first != last; ++first) {
+            quint32 &style = renumbered[first->style];
+            if (style == unused) {
+                style = compacted.add(_styles[first->style]);
+            }
+            first->style = style;
+        }
+        *this = std::move(compacted);
+    }
+
+private:
+    // 12 bytes without padding, so the bytes make the key
+    struct Style {
+        CharacterColor foregroundColor;
+        CharacterColor backgroundColor;
+        RenditionFlags rendition;
+        ExtraFlags flags;
+
+        friend bool operator==(const Style &a, const Style &b)
+        {
+            return std::memcmp(&a, &b, sizeof(Style)) == 0;
+        }
+
+        friend size_t qHash(const Style &style, size_t seed = 0)
+        {
+            return qHashBits(&style, sizeof(Style), seed);
+        }
+    };
+    static_assert(sizeof(Style) == 12, "Style is hashed and compared by its bytes");
+
+    static Style styleOf(const Character &c)
+    {
+        return Style{c.foregroundColor, c.backgroundColor, c.rendition.all, c.flags};
+    }
+
+    quint32 add(const Style &style)
+    {
+        const quint32 id = quint32(_styles.size());
+        _styles.push_back(style);
+        _index.insert(style, id);
+        return id;
+    }
+
+    std::vector<Style> _styles;
+    QHash<Style, quint32> _index;
+    quint32 _lastStyle = 0;
+};
+
+}
+
+#endif // CHARACTERSTYLETABLE_H
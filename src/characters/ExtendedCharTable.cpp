@@ -9,113 +9,227 @@
 
 #include "charactersdebug.h"
 
+// std
+#include <algorithm>
+
 using namespace Konsole;
 
-ExtendedCharTable::ExtendedCharTable() = default;
+ExtendedCharTable::ExtendedCharTable(uint maxEntries)
+    : _maxEntries(qMin(maxEntries, MaxEntries))
+    , _index(1024, 0)
+{
+    for (auto &page : _pages) {
+        page.store(nullptr, std::memory_order_relaxed);
+    }
+}
 
 ExtendedCharTable::~ExtendedCharTable()
 {
-    // free all allocated character buffers
-    QHashIterator<uint, char32_t *> iter(_extendedCharTable);
-    while (iter.hasNext()) {
-        iter.next();
-        delete[] iter.value();
+    for (auto &page : _pages) {
+        delete[] page.load(std::memory_order_relaxed);
     }
 }
 
 // global instance
 ExtendedCharTable ExtendedCharTable::instance;
 
-char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, ushort length, const pExtendedChars extendedChars)
+char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, ushort length)
 {
-    // look for this sequence of points in the table
-    uint hash = extendedCharHash(unicodePoints, length);
-    const uint initialHash = hash;
-    bool triedCleaningSolution = false;
+    const uint hash = extendedCharHash(unicodePoints, length);
+
+    QMutexLocker locker(&_writeMutex);
 
-    // check existing entry for match
-    while (_extendedCharTable.contains(hash) && hash != 0) { // 0 has a special meaning for chars so we don't use it
-        if (extendedCharMatch(hash, unicodePoints, length)) {
+    // look for this sequence of points in the table
+    const size_t mask = _index.size() - 1;
+    for (size_t slot = hash & mask; _index[slot] != 0; slot = (slot + 1) & mask) {
+        const char32_t *record = recordAt(_index[slot]);
+        if (record[0] == hash && record[1] == length && std::equal(unicodePoints, unicodePoints + length, record + RecordHeader)) {
             // this sequence already has an entry in the table,
-            // return its hash
-            return hash;
+            // return its key
+            return _index[slot];
         }
-        // if hash is already used by another, different sequence of unicode character
-        // points then try next hash
-        hash++;
-
-        if (hash == initialHash) {
-            if (!triedCleaningSolution) {
-                triedCleaningSolution = true;
-                // All the hashes are full, go to all Screens and try to free any
-                // This is slow but should happen very rarely
-                QSet<uint> usedExtendedChars = extendedChars();
-
-                QHash<uint, char32_t *>::iterator it = _extendedCharTable.begin();
-                QHash<uint, char32_t *>::iterator itEnd = _extendedCharTable.end();
-                while (it != itEnd) {
-                    if (usedExtendedChars.contains(it.key())) {
-                        ++it;
-                    } else {
-                        it = _extendedCharTable.erase(it);
-                    }
-                }
-            } else {
-                qCDebug(CharactersDebug) << "Using all the extended char hashes, going to miss this extended character";
-                return 0;
-            }
+    }
+
+    uint key;
+    if (!_freeKeys.empty()) {
+        key = _freeKeys.back();
+        _freeKeys.pop_back();
+    } else {
+        const uint count = _count.load(std::memory_order_relaxed);
+        if (count + 1 >= _maxEntries) {
+            qCDebug(CharactersDebug) << "Using all the extended char keys, going to miss this extended character";
+            return 0;
+        }
+        key = count + 1;
+        const uint page = (key - 1) >> PageBits;
+        if (_pages[page].load(std::memory_order_relaxed) == nullptr) {
+            _pages[page].store(new std::atomic<const char32_t *>[PageSize](), std::memory_order_release);
         }
     }
 
-    // add the new sequence to the table and
-    // return that index
-    auto buffer = new char32_t[length + 1];
-    buffer[0] = length;
-    std::copy_n(unicodePoints, length, &buffer[1]);
+    // publish the record; readers which see the key also see its contents
+    setRecord(key, storeRecord(unicodePoints, length, hash));
+    if (key > _count.load(std::memory_order_relaxed)) {
+        _count.store(key, std::memory_order_release);
+    }
+    const uint live = _live.load(std::memory_order_relaxed) + 1;
+    _live.store(live, std::memory_order_release);
 
-    _extendedCharTable.insert(hash, buffer);
+    insertIntoIndex(key, hash);
+    // keep the load factor under 3/4 so probe sequences stay short
+    if (size_t(live) * 4 > _index.size() * 3) {
+        rebuildIndex(_index.size() * 2);
+    }
 
-    return hash;
+    return key;
 }
 
-char32_t *ExtendedCharTable::lookupExtendedChar(uint hash, ushort &length) const
+const char32_t *ExtendedCharTable::lookupExtendedChar(uint key, ushort &length) const
 {
-    // look up index in table and if found, set the length
+    // look up the entry and if found, set the length
     // argument and return a pointer to the character sequence
+    const char32_t *record = key == 0 || key > _count.load(std::memory_order_acquire) ? nullptr : recordAt(key);
+    if (record == nullptr) {
+        length = 0;
+        return nullptr;
+    }
+
+    length = ushort(record[1]);
+    return record + RecordHeader;
+}
+
+void ExtendedCharTable::addKeySource(const void *owner, KeySource source)
+{
+    QMutexLocker locker(&_sourcesMutex);
+    _sources.emplace_back(owner, std::move(source));
+}
+
+void ExtendedCharTable::removeKeySource(const void *owner)
+{
+    QMutexLocker locker(&_sourcesMutex);
+    _sources.erase(std::remove_if(_sources.begin(),
+                                  _sources.end(),
+                                  [owner](const auto &source) {
+                                      return source.first == owner;
+                                  }),
+                   _sources.end());
+}
+
+uint ExtendedCharTable::reclaimUnused()
+{
+    QMutexLocker locker(&_writeMutex);
+    const uint count = _count.load(std::memory_order_relaxed);
+    if (!_freeKeys.empty() || count + 1 < _maxEntries) {
+        return 0;
+    }
+
+    // All the keys are handed out, go to all the sources and free the ones
+    // they don't use.  This is slow but should happen very rarely.
+    QSet<uint> usedKeys;
+    {
+        QMutexLocker sourcesLocker(&_sourcesMutex);
+        for (const auto &source : _sources) {
+            source.second(usedKeys);
+        }
+    }
 
-    char32_t *buffer = _extendedCharTable[hash];
-    if (buffer != nullptr) {
-        length = ushort(buffer[0]);
-        return buffer + 1;
+    // The whole key space was handed out since the records retired last
+    // time were freed, nobody is reading those any more
+    if (_freeRecords.size() < _retiredRecords.size()) {
+        _freeRecords.resize(_retiredRecords.size());
     }
-    length = 0;
-    return nullptr;
+    for (size_t length = 0; length < _retiredRecords.size(); ++length) {
+        _freeRecords[length].insert(_freeRecords[length].end(), _retiredRecords[length].begin(), _retiredRecords[length].end());
+        _retiredRecords[length].clear();
+    }
+
+    for (uint key = 1; key <= count; ++key) {
+        const char32_t *record = recordAt(key);
+        if (record == nullptr || usedKeys.contains(key)) {
+            continue;
+        }
+        setRecord(key, nullptr);
+        _freeKeys.push_back(key);
+        const ushort length = ushort(record[1]);
+        if (length <= MaxReusedLength) {
+            if (_retiredRecords.size() <= length) {
+                _retiredRecords.resize(length + 1);
+            }
+            _retiredRecords[length].push_back(const_cast<char32_t *>(record));
+        }
+    }
+    // hand out the lowest keys first
+    std::sort(_freeKeys.begin(), _freeKeys.end(), std::greater<uint>());
+
+    const uint freed = uint(_freeKeys.size());
+    _live.store(_live.load(std::memory_order_relaxed) - freed, std::memory_order_release);
+    rebuildIndex(_index.size());
+
+    qCDebug(CharactersDebug) << "Reclaimed" << freed << "unused extended char keys";
+    return freed;
 }
 
-uint ExtendedCharTable::extendedCharHash(const char32_t *unicodePoints, ushort length) const
+uint ExtendedCharTable::extendedCharHash(const char32_t *unicodePoints, ushort length)
 {
     uint hash = 0;
     for (ushort i = 0; i < length; i++) {
         hash = 31 * hash + unicodePoints[i];
     }
+    // spread the low bits, which pick the index slot
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bu;
+    hash ^= hash >> 16;
     return hash;
 }
 
-bool ExtendedCharTable::extendedCharMatch(uint hash, const char32_t *unicodePoints, ushort length) const
+void ExtendedCharTable::setRecord(uint key, const char32_t *record)
+{
+    std::atomic<const char32_t *> *page = _pages[(key - 1) >> PageBits].load(std::memory_order_relaxed);
+    page[(key - 1) & (PageSize - 1)].store(record, std::memory_order_release);
+}
+
+const char32_t *ExtendedCharTable::storeRecord(const char32_t *unicodePoints, ushort length, uint hash)
+{
+    char32_t *record = nullptr;
+    if (length < _freeRecords.size() && !_freeRecords[length].empty()) {
+        record = _freeRecords[length].back();
+        _freeRecords[length].pop_back();
+    } else {
+        const size_t size = RecordHeader + length;
+        if (_blockLeft < size) {
+            const size_t blockSize = std::max(BlockSize, size);
+            _blocks.push_back(std::make_unique<char32_t[]>(blockSize));
+            _blockPos = _blocks.back().get();
+            _blockLeft = blockSize;
+        }
+        record = _blockPos;
+        _blockPos += size;
+        _blockLeft -= size;
+    }
+
+    record[0] = hash;
+    record[1] = length;
+    std::copy_n(unicodePoints, length, record + RecordHeader);
+    return record;
+}
+
+void ExtendedCharTable::insertIntoIndex(uint key, uint hash)
+{
+    const size_t mask = _index.size() - 1;
+    size_t slot = hash & mask;
+    while (_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    _index[slot] = key;
+}
+
+void ExtendedCharTable::rebuildIndex(size_t size)
 {
-    char32_t *entry = _extendedCharTable[hash];
-
-    // compare given length with stored sequence length ( given as the first ushort in the
-    // stored buffer )
-    if (entry == nullptr || entry[0] != length) {
-        return false;
-    }
-    // if the lengths match, each character must be checked.  the stored buffer starts at
-    // entry[1]
-    for (int i = 0; i < length; i++) {
-        if (entry[i + 1] != unicodePoints[i]) {
-            return false;
+    _index.assign(size, 0);
+    const uint count = _count.load(std::memory_order_relaxed);
+    for (uint key = 1; key <= count; ++key) {
+        if (const char32_t *record = recordAt(key)) {
+            insertIntoIndex(key, record[0]);
         }
     }
-    return true;
 }
@@ -8,65 +8,165 @@
 #define EXTENDEDCHARTABLE_H
 
 // Qt
-#include <QHash>
+#include <QMutex>
 #include <QSet>
 
+// std
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace Konsole
 {
 /**
  * A table which stores sequences of unicode characters, referenced
- * by hash keys.  The hash key itself is the same size as a unicode
+ * by keys.  The key itself is the same size as a unicode
  * character ( char32_t ) so that it can occupy the same space in
  * a structure.
+ *
+ * Each distinct sequence is interned exactly once and keeps its key as
+ * long as a cell uses it.  Sequences live in large blocks instead of one
+ * heap allocation each.
+ *
+ * Cells are plain values copied around freely, by memcpy as often as not,
+ * so keys are not reference counted.  Once all keys are handed out,
+ * reclaimUnused() asks the key sources, everything keeping copies of cells
+ * such as the screens with their history and the views, which keys are
+ * still in use and frees the others for reuse.
+ *
+ * lookupExtendedChar() does not take a lock and may be called from any
+ * thread; createExtendedChar() serializes writers.
  */
 class ExtendedCharTable
 {
 public:
-    typedef std::function<QSet<uint>()> pExtendedChars;
-
-    /** Constructs a new character table. */
-    ExtendedCharTable();
+    /**
+     * Constructs a new character table which hands out at most
+     * @p maxEntries - 1 keys at a time.
+     */
+    explicit ExtendedCharTable(uint maxEntries = MaxEntries);
     ~ExtendedCharTable();
 
+    ExtendedCharTable(const ExtendedCharTable &) = delete;
+    ExtendedCharTable &operator=(const ExtendedCharTable &) = delete;
+
     /**
      * Adds a sequences of unicode characters to the table and returns
-     * a hash code which can be used later to look up the sequence
+     * a key which can be used later to look up the sequence
      * using lookupExtendedChar()
      *
-     * If the same sequence already exists in the table, the hash
-     * of the existing sequence will be returned.
+     * If the same sequence already exists in the table, the key
+     * of the existing sequence will be returned.  Returns 0 if the
+     * table is full, see reclaimUnused().
      *
      * @param unicodePoints An array of unicode character points
      * @param length Length of @p unicodePoints
      */
-    char32_t createExtendedChar(const char32_t *unicodePoints, ushort length, const pExtendedChars extendedChars);
+    char32_t createExtendedChar(const char32_t *unicodePoints, ushort length);
     /**
      * Looks up and returns a pointer to a sequence of unicode characters
      * which was added to the table using createExtendedChar().
      *
-     * @param hash The hash key returned by createExtendedChar()
+     * @param key The key returned by createExtendedChar()
      * @param length This variable is set to the length of the
      * character sequence.
      *
      * @return A unicode character sequence of size @p length.
      */
-    char32_t *lookupExtendedChar(uint hash, ushort &length) const;
+    const char32_t *lookupExtendedChar(uint key, ushort &length) const;
+
+    /** Number of distinct sequences stored. */
+    uint size() const
+    {
+        return _live.load(std::memory_order_acquire);
+    }
+
+    /** Adds the keys used by the cells of a key source to the set. */
+    using KeySource = std::function<void(QSet<uint> &usedKeys)>;
+
+    /**
+     * Registers @p source, owned by @p owner, to be asked for the keys in
+     * use by reclaimUnused().  Everything which keeps cells beyond a
+     * moment registers one.
+     */
+    void addKeySource(const void *owner, KeySource source);
+    void removeKeySource(const void *owner);
+
+    /**
+     * If all keys are handed out, frees the ones no key source uses any
+     * more so that createExtendedChar() can hand them out again.  Returns
+     * the number of keys freed.
+     *
+     * This reads the cells of every source, including history kept in
+     * files, so it must not run while any of them is written to, and it is
+     * slow; it only happens when the table is full.
+     */
+    uint reclaimUnused();
 
     /** The global ExtendedCharTable instance. */
     static ExtendedCharTable instance;
 
+    /** Upper bound on the number of distinct sequences. */
+    static constexpr uint MaxEntries = 1u << 22;
+
 private:
-    // calculates the hash key of a sequence of unicode points of size 'length'
-    uint extendedCharHash(const char32_t *unicodePoints, ushort length) const;
-    // tests whether the entry in the table specified by 'hash' matches the
-    // character sequence 'unicodePoints' of size 'length'
-    bool extendedCharMatch(uint hash, const char32_t *unicodePoints, ushort length) const;
-    // internal, maps hash keys to character sequence buffers.  The first uint
-    // in each value is the length of the buffer, followed by the uints in the buffer
-    // themselves.
-    QHash<uint, char32_t *> _extendedCharTable;
+    // A sequence as stored in the blocks: its hash, its length and then its
+    // code points.  Freed records are reused for sequences of the same length,
+    // but only from the reclaim after the one freeing them: a reader which
+    // looked up the key just before may still be reading the record.
+    static constexpr size_t RecordHeader = 2;
+    // longer sequences are rare and their records are not reused
+    static constexpr ushort MaxReusedLength = 32;
+
+    static constexpr uint PageBits = 12;
+    static constexpr uint PageSize = 1u << PageBits;
+    static constexpr uint MaxPages = MaxEntries / PageSize;
+    // code points per arena block
+    static constexpr size_t BlockSize = 16384;
+
+    // calculates the hash of a sequence of unicode points of size 'length'
+    static uint extendedCharHash(const char32_t *unicodePoints, ushort length);
+    // record for a key handed out, null once freed
+    const char32_t *recordAt(uint key) const
+    {
+        const std::atomic<const char32_t *> *page = _pages[(key - 1) >> PageBits].load(std::memory_order_acquire);
+        return page[(key - 1) & (PageSize - 1)].load(std::memory_order_acquire);
+    }
+    void setRecord(uint key, const char32_t *record);
+    // copies the sequence into a record; writer only
+    const char32_t *storeRecord(const char32_t *unicodePoints, ushort length, uint hash);
+    // inserts 'key' into the open-addressed index; writer only
+    void insertIntoIndex(uint key, uint hash);
+    void rebuildIndex(size_t size);
+
+    // Pages never move once published, so a key maps to its record with
+    // three loads and no lock.  Key n lives at slot n - 1; key 0 is never
+    // handed out because it has a special meaning for characters.
+    // Records are never deallocated, only reused, so a reader racing with
+    // the reuse of a key nobody references any more still reads valid memory.
+    std::atomic<std::atomic<const char32_t *> *> _pages[MaxPages];
+    // keys handed out so far are 1 to _count
+    std::atomic<uint> _count{0};
+    std::atomic<uint> _live{0};
+    const uint _maxEntries;
+
+    // Everything below is only touched with _writeMutex held.
+    QMutex _writeMutex;
+    // open addressing with linear probing, 0 marks an empty slot
+    std::vector<uint> _index;
+    std::vector<uint> _freeKeys;
+    // freed records by length
+    std::vector<std::vector<char32_t *>> _freeRecords;
+    // records freed by the last reclaim, by length
+    std::vector<std::vector<char32_t *>> _retiredRecords;
+    std::vector<std::unique_ptr<char32_t[]>> _blocks;
+    char32_t *_blockPos = nullptr;
+    size_t _blockLeft = 0;
+
+    QMutex _sourcesMutex;
+    std::vector<std::pair<const void *, KeySource>> _sources;
 };
 
 }
@@ -12,8 +12,14 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QProcess>
+#include <QSet>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QTime>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
 
 namespace Konsolai
 {
@@ -24,34 +30,46 @@ AgentFleetProvider::AgentFleetProvider(const QString &fleetPath, QObject *parent
 {
     // File system watcher for real-time updates
     m_watcher = new QFileSystemWatcher(this);
-
-    // Watch sessions directory for state changes
-    QString sessDir = sessionsDir();
-    if (QDir(sessDir).exists()) {
-        m_watcher->addPath(sessDir);
-    }
-
-    // Watch goals directory for agent additions/removals
-    QString gDir = goalsDir();
-    if (QDir(gDir).exists()) {
-        m_watcher->addPath(gDir);
-    }
+    watchDirectories();
 
     connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &AgentFleetProvider::onFileChanged);
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &AgentFleetProvider::onDirectoryChanged);
 
+    // Today's spend moves to a new directory at midnight
+    m_dayChangeTimer = new QTimer(this);
+    m_dayChangeTimer->setSingleShot(true);
+    connect(m_dayChangeTimer, &QTimer::timeout, this, [this]() {
+        watchDirectories();
+        reloadAgents();
+        scheduleDayChange();
+    });
+    scheduleDayChange();
+
     // 30s fallback timer
     m_fallbackTimer = new QTimer(this);
     m_fallbackTimer->setInterval(30000);
     connect(m_fallbackTimer, &QTimer::timeout, this, &AgentFleetProvider::reloadAgents);
     m_fallbackTimer->start();
+
+    // Writers usually touch several files at once; scan once they are done
+    m_refreshDebounce = new QTimer(this);
+    m_refreshDebounce->setSingleShot(true);
+    m_refreshDebounce->setInterval(100);
+    connect(m_refreshDebounce, &QTimer::timeout, this, &AgentFleetProvider::refreshSnapshot);
+
+    m_scanWatcher = new QFutureWatcher<FleetScan>(this);
+    connect(m_scanWatcher, &QFutureWatcher<FleetScan>::finished, this, &AgentFleetProvider::onScanFinished);
 }
 
-AgentFleetProvider::~AgentFleetProvider() = default;
+AgentFleetProvider::~AgentFleetProvider()
+{
+    // the scan reads this provider's paths
+    m_scanWatcher->waitForFinished();
+}
 
 int AgentFleetProvider::interfaceVersion() const
 {
-    return 1;
+    return 2;
 }
 
 QString AgentFleetProvider::name() const
@@ -90,6 +108,41 @@ QString AgentFleetProvider::fleetPath() const
 void AgentFleetProvider::setConfigDir(const QString &dir)
 {
     m_configDirOverride = dir;
+    watchDirectories();
+}
+
+void AgentFleetProvider::watchDirectories()
+{
+    // Sessions and goals for state changes and agent additions/removals,
+    // briefs and today's spend for snapshots.  Today's budget directory is
+    // only created with the first spend of the day; the budgets directory
+    // tells when that happens.
+    const QString today = budgetsDir() + QLatin1Char('/') + QDate::currentDate().toString(QStringLiteral("yyyy-MM-dd"));
+    const QStringList wanted = {sessionsDir(), goalsDir(), briefsDir(), budgetsDir(), today};
+
+    const QStringList watched = m_watcher->directories();
+    QStringList stale;
+    for (const QString &dir : watched) {
+        if (!wanted.contains(dir)) {
+            stale.append(dir);
+        }
+    }
+    if (!stale.isEmpty()) {
+        m_watcher->removePaths(stale);
+    }
+    for (const QString &dir : wanted) {
+        if (!watched.contains(dir) && QDir(dir).exists()) {
+            m_watcher->addPath(dir);
+        }
+    }
+}
+
+void AgentFleetProvider::scheduleDayChange()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+    // A second late, so the new date is seen
+    m_dayChangeTimer->start(int(std::min<qint64>(now.msecsTo(midnight) + 1000, std::numeric_limits<int>::max())));
 }
 
 QString AgentFleetProvider::configDir() const
@@ -279,12 +332,14 @@ AgentBrief AgentFleetProvider::parseBrief(const QString &agentId) const
     return brief;
 }
 
-double AgentFleetProvider::parseDailyBudgetSpend(const QString &agentId) const
+QString AgentFleetProvider::budgetFilePath(const QString &agentId, const QDate &date) const
 {
-    QString date = QDate::currentDate().toString(QStringLiteral("yyyy-MM-dd"));
-    QString path = budgetsDir() + QLatin1Char('/') + date + QLatin1Char('/') + agentId + QStringLiteral(".json");
+    return budgetsDir() + QLatin1Char('/') + date.toString(QStringLiteral("yyyy-MM-dd")) + QLatin1Char('/') + agentId + QStringLiteral(".json");
+}
 
-    QFile file(path);
+double AgentFleetProvider::parseDailyBudgetSpend(const QString &agentId) const
+{
+    QFile file(budgetFilePath(agentId, QDate::currentDate()));
     if (!file.open(QIODevice::ReadOnly)) {
         return 0.0;
     }
@@ -454,8 +509,18 @@ AgentAttachInfo AgentFleetProvider::attachInfo(const QString &id) const
 bool AgentFleetProvider::createAgent(const AgentConfig &config)
 {
     // Write a new YAML goal file
-    QString path = goalsDir() + QLatin1Char('/') + config.name + QStringLiteral(".yaml");
+    if (!writeGoalYaml(goalsDir() + QLatin1Char('/') + config.name + QStringLiteral(".yaml"), config)) {
+        return false;
+    }
 
+    m_cacheValid = false;
+    Q_EMIT agentsReloaded();
+    scheduleRefresh();
+    return true;
+}
+
+bool AgentFleetProvider::writeGoalYaml(const QString &path, const AgentConfig &config)
+{
     QFile file(path);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         return false;
@@ -483,8 +548,6 @@ bool AgentFleetProvider::createAgent(const AgentConfig &config)
     }
 
     file.close();
-    m_cacheValid = false;
-    Q_EMIT agentsReloaded();
     return true;
 }
 
@@ -505,6 +568,7 @@ bool AgentFleetProvider::deleteAgent(const QString &id)
     if (ok) {
         m_cacheValid = false;
         Q_EMIT agentsReloaded();
+        scheduleRefresh();
     }
     return ok;
 }
@@ -527,6 +591,7 @@ bool AgentFleetProvider::pauseSchedule(const QString &id)
         return false;
     }
     file.write(QJsonDocument(obj).toJson());
+    scheduleRefresh();
     return true;
 }
 
@@ -547,6 +612,7 @@ bool AgentFleetProvider::resumeSchedule(const QString &id)
         return false;
     }
     file.write(QJsonDocument(obj).toJson());
+    scheduleRefresh();
     return true;
 }
 
@@ -567,11 +633,16 @@ bool AgentFleetProvider::resetSession(const QString &id)
         return false;
     }
     file.write(QJsonDocument(obj).toJson());
+    scheduleRefresh();
     return true;
 }
 
 double AgentFleetProvider::totalDailySpendUSD() const
 {
+    if (m_scan.snapshot) {
+        return m_scan.snapshot->totalDailySpendUSD;
+    }
+
     double total = 0.0;
     const QList<AgentInfo> allAgents = agents();
     for (const AgentInfo &info : allAgents) {
@@ -582,6 +653,10 @@ double AgentFleetProvider::totalDailySpendUSD() const
 
 double AgentFleetProvider::totalDailyBudgetUSD() const
 {
+    if (m_scan.snapshot) {
+        return m_scan.snapshot->totalDailyBudgetUSD;
+    }
+
     double total = 0.0;
     const QList<AgentInfo> allAgents = agents();
     for (const AgentInfo &info : allAgents) {
@@ -590,15 +665,20 @@ double AgentFleetProvider::totalDailyBudgetUSD() const
     return total;
 }
 
-bool AgentFleetProvider::runFleetCommand(const QStringList &args, int timeoutMs) const
+static QString findFleetBinary(const QString &fleetPath)
 {
-    QString binary = m_fleetPath + QStringLiteral("/agent-fleet");
+    QString binary = fleetPath + QStringLiteral("/agent-fleet");
     if (!QFile::exists(binary)) {
         // Try PATH
         binary = QStandardPaths::findExecutable(QStringLiteral("agent-fleet"));
-        if (binary.isEmpty()) {
-            return false;
-        }
+    }
+    return binary;
+}
+
+static bool runFleetBinary(const QString &binary, const QStringList &args, int timeoutMs)
+{
+    if (binary.isEmpty()) {
+        return false;
     }
 
     QProcess proc;
@@ -609,6 +689,165 @@ bool AgentFleetProvider::runFleetCommand(const QStringList &args, int timeoutMs)
     return proc.exitCode() == 0;
 }
 
+bool AgentFleetProvider::runFleetCommand(const QStringList &args, int timeoutMs) const
+{
+    return runFleetBinary(findFleetBinary(m_fleetPath), args, timeoutMs);
+}
+
+QFuture<bool> AgentFleetProvider::runFleetCommandAsync(const QStringList &args)
+{
+    const QString fleetPath = m_fleetPath;
+    return QtConcurrent::run([fleetPath, args]() {
+               return runFleetBinary(findFleetBinary(fleetPath), args, 30000);
+           })
+        .then(this, [this](bool ok) {
+            // the command changed state files; don't wait for the watcher
+            scheduleRefresh();
+            return ok;
+        });
+}
+
+QFuture<bool> AgentFleetProvider::triggerRunAsync(const QString &id, const QString &task)
+{
+    QStringList args = {QStringLiteral("trigger"), id};
+    if (!task.isEmpty()) {
+        args << task;
+    }
+    return runFleetCommandAsync(args);
+}
+
+QFuture<bool> AgentFleetProvider::setBriefAsync(const QString &id, const QString &direction)
+{
+    return runFleetCommandAsync({QStringLiteral("brief"), id, direction});
+}
+
+QFuture<bool> AgentFleetProvider::createAgentAsync(const AgentConfig &config)
+{
+    const QString path = goalsDir() + QLatin1Char('/') + config.name + QStringLiteral(".yaml");
+    return QtConcurrent::run([path, config]() {
+               return writeGoalYaml(path, config);
+           })
+        .then(this, [this](bool ok) {
+            if (ok) {
+                m_cacheValid = false;
+                Q_EMIT agentsReloaded();
+                refreshSnapshot();
+            }
+            return ok;
+        });
+}
+
+AgentFleetSnapshotPtr AgentFleetProvider::snapshot() const
+{
+    return m_scan.snapshot;
+}
+
+void AgentFleetProvider::refreshSnapshot()
+{
+    if (m_scanWatcher->isRunning()) {
+        m_rescanPending = true;
+        return;
+    }
+
+    const FleetScan previous = m_scan;
+    m_scanWatcher->setFuture(QtConcurrent::run([this, previous]() {
+        return scanFleet(previous);
+    }));
+}
+
+void AgentFleetProvider::scheduleRefresh()
+{
+    m_refreshDebounce->start();
+}
+
+void AgentFleetProvider::onScanFinished()
+{
+    FleetScan result = m_scanWatcher->result();
+
+    // an unchanged fleet keeps its snapshot, so consumers can compare pointers
+    if (m_scan.snapshot && result.delta.isEmpty()) {
+        m_scan.stamps = std::move(result.stamps);
+    } else {
+        m_scan = std::move(result);
+        Q_EMIT snapshotUpdated(m_scan.delta);
+    }
+
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        refreshSnapshot();
+    }
+}
+
+AgentFleetProvider::FileStamp AgentFleetProvider::stampOf(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return {};
+    }
+    return {info.lastModified().toMSecsSinceEpoch(), info.size()};
+}
+
+AgentFleetProvider::FleetScan AgentFleetProvider::scanFleet(const FleetScan &previous) const
+{
+    // Runs on a worker thread: only reads files and this provider's paths
+    FleetScan scan;
+    auto snap = std::make_shared<AgentFleetSnapshot>();
+    snap->generation = previous.snapshot ? previous.snapshot->generation + 1 : 1;
+
+    const QDate today = QDate::currentDate();
+    const QDir dir(goalsDir());
+    const QStringList yamlFiles = dir.exists() ? dir.entryList({QStringLiteral("*.yaml"), QStringLiteral("*.yml")}, QDir::Files, QDir::Name) : QStringList();
+    snap->entries.reserve(yamlFiles.size());
+
+    for (const QString &file : yamlFiles) {
+        const QString goalPath = dir.absoluteFilePath(file);
+        const QString id = QFileInfo(goalPath).baseName();
+        if (scan.stamps.contains(id)) {
+            continue; // both id.yaml and id.yml
+        }
+
+        AgentStamps stamps;
+        stamps.goal = stampOf(goalPath);
+        stamps.state = stampOf(sessionsDir() + QLatin1Char('/') + id + QStringLiteral(".json"));
+        stamps.brief = stampOf(briefsDir() + QLatin1Char('/') + id + QStringLiteral(".json"));
+        stamps.budgetDate = today;
+        stamps.budget = stampOf(budgetFilePath(id, today));
+
+        const AgentSnapshotEntry *old = previous.snapshot ? previous.snapshot->find(id) : nullptr;
+        const auto oldStamps = previous.stamps.constFind(id);
+        const bool known = old && oldStamps != previous.stamps.constEnd();
+
+        if (known && *oldStamps == stamps) {
+            snap->entries.append(*old);
+        } else {
+            AgentSnapshotEntry entry;
+            entry.info = (known && oldStamps->goal == stamps.goal) ? old->info : parseGoalYaml(goalPath);
+            if (entry.info.id.isEmpty()) {
+                continue;
+            }
+            entry.status = parseSessionState(id);
+            entry.status.brief = parseBrief(id);
+            entry.status.dailySpentUSD = parseDailyBudgetSpend(id);
+            snap->entries.append(entry);
+            (known ? scan.delta.changed : scan.delta.added).append(id);
+        }
+        scan.stamps.insert(id, stamps);
+    }
+
+    snap->finalize();
+
+    if (previous.snapshot) {
+        for (const AgentSnapshotEntry &entry : previous.snapshot->entries) {
+            if (!snap->find(entry.info.id)) {
+                scan.delta.removed.append(entry.info.id);
+            }
+        }
+    }
+
+    scan.snapshot = snap;
+    return scan;
+}
+
 void AgentFleetProvider::onFileChanged(const QString &path)
 {
     Q_UNUSED(path);
@@ -617,11 +856,16 @@ void AgentFleetProvider::onFileChanged(const QString &path)
     // Determine which agent changed from filename
     QString baseName = QFileInfo(path).baseName();
     Q_EMIT agentChanged(baseName);
+    scheduleRefresh();
 }
 
 void AgentFleetProvider::onDirectoryChanged(const QString &path)
 {
-    Q_UNUSED(path);
+    // Today's budget directory may have been created, or a watched one
+    // removed and created again
+    if (path == budgetsDir() || !QDir(path).exists()) {
+        watchDirectories();
+    }
     reloadAgents();
 }
 
@@ -629,6 +873,7 @@ void AgentFleetProvider::reloadAgents()
 {
     m_cacheValid = false;
     Q_EMIT agentsReloaded();
+    scheduleRefresh();
 }
 
 } // namespace Konsolai
@@ -9,6 +9,7 @@
 #include "AgentProvider.h"
 
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QTimer>
 
 namespace Konsolai
@@ -29,6 +30,13 @@ namespace Konsolai
  *   - agent-fleet brief <agent> <direction>
  *   - agent-fleet steer <agent> <note>
  *   - agent-fleet done <agent>
+ *
+ * Snapshots (interface version 2) are built on a worker thread.  Each scan
+ * compares the modification time and size of every agent's goal, state,
+ * brief and budget file with the previous scan and parses only the files
+ * that changed, so a refresh of an unchanged fleet costs a few stat calls
+ * per agent.  Scans are started by the file system watcher, debounced, and
+ * by the 30s fallback timer.
  */
 class KONSOLEPRIVATE_EXPORT AgentFleetProvider : public AgentProvider
 {
@@ -63,13 +71,20 @@ public:
     bool resumeSchedule(const QString &id) override;
     bool resetSession(const QString &id) override;
 
+    AgentFleetSnapshotPtr snapshot() const override;
+    void refreshSnapshot() override;
+
+    QFuture<bool> triggerRunAsync(const QString &id, const QString &task = QString()) override;
+    QFuture<bool> setBriefAsync(const QString &id, const QString &direction) override;
+    QFuture<bool> createAgentAsync(const AgentConfig &config) override;
+
     /** Path to the agent-fleet installation. */
     QString fleetPath() const;
 
     /** Auto-detect fleet path from common locations. */
     static QString detectFleetPath();
 
-    /** Override config directory (for testing). */
+    /** Override config directory (for testing). Must not be called while a snapshot is being built. */
     void setConfigDir(const QString &dir);
 
     /** Aggregate daily spend across all agents. */
@@ -86,6 +101,44 @@ private Q_SLOTS:
     void onDirectoryChanged(const QString &path);
 
 private:
+    // Identifies one version of a file; mtime -1 if the file does not exist
+    struct FileStamp {
+        qint64 mtime = -1;
+        qint64 size = -1;
+        bool operator==(const FileStamp &other) const
+        {
+            return mtime == other.mtime && size == other.size;
+        }
+    };
+
+    struct AgentStamps {
+        FileStamp goal;
+        FileStamp state;
+        FileStamp brief;
+        FileStamp budget;
+        QDate budgetDate;
+        bool operator==(const AgentStamps &other) const
+        {
+            return goal == other.goal && state == other.state && brief == other.brief && budget == other.budget && budgetDate == other.budgetDate;
+        }
+    };
+
+    struct FleetScan {
+        AgentFleetSnapshotPtr snapshot;
+        QHash<QString, AgentStamps> stamps;
+        AgentFleetDelta delta;
+    };
+
+    static FileStamp stampOf(const QString &path);
+    FleetScan scanFleet(const FleetScan &previous) const;
+    void onScanFinished();
+    void scheduleRefresh();
+    void watchDirectories();
+    void scheduleDayChange();
+    QString budgetFilePath(const QString &agentId, const QDate &date) const;
+    static bool writeGoalYaml(const QString &path, const AgentConfig &config);
+    QFuture<bool> runFleetCommandAsync(const QStringList &args);
+
     AgentInfo parseGoalYaml(const QString &filePath) const;
     AgentStatus parseSessionState(const QString &agentId) const;
     AgentBrief parseBrief(const QString &agentId) const;
@@ -104,8 +157,14 @@ private:
     QString m_configDirOverride;
     QFileSystemWatcher *m_watcher = nullptr;
     QTimer *m_fallbackTimer = nullptr;
+    QTimer *m_dayChangeTimer = nullptr;
     mutable QList<AgentInfo> m_cachedAgents;
     mutable bool m_cacheValid = false;
+
+    FleetScan m_scan;
+    QFutureWatcher<FleetScan> *m_scanWatcher = nullptr;
+    QTimer *m_refreshDebounce = nullptr;
+    bool m_rescanPending = false;
 };
 
 } // namespace Konsolai
@@ -85,8 +85,15 @@ void AgentManagerPanel::addProvider(AgentProvider *provider)
     provider->setParent(this);
     m_providers.append(provider);
 
-    connect(provider, &AgentProvider::agentChanged, this, &AgentManagerPanel::onAgentChanged);
-    connect(provider, &AgentProvider::agentsReloaded, this, &AgentManagerPanel::onAgentsReloaded);
+    if (provider->interfaceVersion() >= 2) {
+        connect(provider, &AgentProvider::snapshotUpdated, this, [this, provider](const AgentFleetDelta &delta) {
+            onSnapshotUpdated(provider, delta);
+        });
+        provider->refreshSnapshot();
+    } else {
+        connect(provider, &AgentProvider::agentChanged, this, &AgentManagerPanel::onAgentChanged);
+        connect(provider, &AgentProvider::agentsReloaded, this, &AgentManagerPanel::onAgentsReloaded);
+    }
 
     rebuildTree();
 }
@@ -125,10 +132,8 @@ double AgentManagerPanel::totalDailySpendUSD() const
 {
     double total = 0.0;
     for (auto *p : m_providers) {
-        const QList<AgentInfo> agentList = p->agents();
-        for (const AgentInfo &info : agentList) {
-            AgentStatus status = p->agentStatus(info.id);
-            total += status.dailySpentUSD;
+        if (const AgentFleetSnapshotPtr snap = p->snapshot()) {
+            total += snap->totalDailySpendUSD;
         }
     }
     return total;
@@ -138,9 +143,8 @@ double AgentManagerPanel::totalDailyBudgetUSD() const
 {
     double total = 0.0;
     for (auto *p : m_providers) {
-        const QList<AgentInfo> agentList = p->agents();
-        for (const AgentInfo &info : agentList) {
-            total += info.budget.dailyUSD;
+        if (const AgentFleetSnapshotPtr snap = p->snapshot()) {
+            total += snap->totalDailyBudgetUSD;
         }
     }
     return total;
@@ -148,6 +152,11 @@ double AgentManagerPanel::totalDailyBudgetUSD() const
 
 void AgentManagerPanel::refresh()
 {
+    for (auto *p : m_providers) {
+        if (p->interfaceVersion() >= 2) {
+            p->refreshSnapshot();
+        }
+    }
     rebuildTree();
 }
 
@@ -200,6 +209,38 @@ void AgentManagerPanel::onAgentsReloaded()
     m_updateDebounce->start();
 }
 
+void AgentManagerPanel::onSnapshotUpdated(AgentProvider *provider, const AgentFleetDelta &delta)
+{
+    if (delta.isStructural()) {
+        onAgentsReloaded();
+        return;
+    }
+
+    const AgentFleetSnapshotPtr snap = provider->snapshot();
+    if (!snap) {
+        return;
+    }
+
+    for (const QString &id : delta.changed) {
+        QTreeWidgetItem *item = findAgentItem(provider->name(), id);
+        const AgentSnapshotEntry *entry = snap->find(id);
+        if (item && entry) {
+            populateAgentItem(item, entry->info, entry->status);
+        }
+    }
+    updateFooter();
+}
+
+AgentStatus AgentManagerPanel::statusOf(AgentProvider *provider, const QString &agentId) const
+{
+    if (provider->interfaceVersion() >= 2) {
+        const AgentFleetSnapshotPtr snap = provider->snapshot();
+        const AgentSnapshotEntry *entry = snap ? snap->find(agentId) : nullptr;
+        return entry ? entry->status : AgentStatus();
+    }
+    return provider->agentStatus(agentId);
+}
+
 void AgentManagerPanel::rebuildTree()
 {
     m_tree->clear();
@@ -209,77 +250,18 @@ void AgentManagerPanel::rebuildTree()
             continue;
         }
 
-        const QList<AgentInfo> agentList = prov->agents();
-        for (const AgentInfo &info : agentList) {
+        const AgentFleetSnapshotPtr snap = prov->snapshot();
+        if (!snap) {
+            continue;
+        }
+
+        for (const AgentSnapshotEntry &entry : snap->entries) {
             auto *item = new QTreeWidgetItem(m_tree);
             item->setData(0, ProviderNameRole, prov->name());
-            item->setData(0, AgentIdRole, info.id);
+            item->setData(0, AgentIdRole, entry.info.id);
             item->setData(0, IsAgentItemRole, true);
 
-            updateAgentItem(item, prov, info);
-
-            // Add child items for details
-            AgentStatus status = prov->agentStatus(info.id);
-
-            // Schedule line
-            if (!info.schedule.isEmpty()) {
-                auto *schedItem = new QTreeWidgetItem(item);
-                schedItem->setText(0, QStringLiteral("\u23F0 ") + info.schedule);
-                schedItem->setFlags(schedItem->flags() & ~Qt::ItemIsSelectable);
-            }
-
-            // Budget line
-            if (info.budget.dailyUSD > 0.0) {
-                auto *budgetItem = new QTreeWidgetItem(item);
-                budgetItem->setText(0, QStringLiteral("$%1 / $%2 today").arg(status.dailySpentUSD, 0, 'f', 2).arg(info.budget.dailyUSD, 0, 'f', 2));
-                budgetItem->setFlags(budgetItem->flags() & ~Qt::ItemIsSelectable);
-            }
-
-            // Last result
-            if (!status.lastSummary.isEmpty()) {
-                auto *resultItem = new QTreeWidgetItem(item);
-                QString prefix = (status.state == AgentStatus::Error) ? QStringLiteral("\u26A0 ") : QStringLiteral("\u2713 ");
-                resultItem->setText(0, prefix + status.lastSummary);
-                resultItem->setFlags(resultItem->flags() & ~Qt::ItemIsSelectable);
-            }
-
-            // Brief
-            if (!status.brief.direction.isEmpty() && !status.brief.isDone) {
-                auto *briefItem = new QTreeWidgetItem(item);
-                briefItem->setText(0, i18n("Brief: \"%1\"", status.brief.direction));
-                briefItem->setFlags(briefItem->flags() & ~Qt::ItemIsSelectable);
-
-                for (const QString &note : status.brief.steeringNotes) {
-                    auto *noteItem = new QTreeWidgetItem(briefItem);
-                    noteItem->setText(0, i18n("Steer: \"%1\"", note));
-                    noteItem->setFlags(noteItem->flags() & ~Qt::ItemIsSelectable);
-                }
-            }
-
-            // Session linkage child node (when linker is connected)
-            if (m_linker) {
-                auto *sessionItem = new QTreeWidgetItem(item);
-                sessionItem->setData(0, Qt::UserRole + 10, QStringLiteral("session-link"));
-                sessionItem->setData(0, AgentIdRole, info.id);
-
-                if (m_linker->hasActiveTab(info.id)) {
-                    sessionItem->setText(0, QStringLiteral("\U0001F4CB Active session"));
-                    QFont f = sessionItem->font(0);
-                    f.setBold(true);
-                    sessionItem->setFont(0, f);
-                    // Add [Tab] badge to the agent node itself
-                    item->setText(0, info.name + QStringLiteral(" [Tab]"));
-                } else if (m_linker->hasDetachedSession(info.id)) {
-                    sessionItem->setText(0, QStringLiteral("\U0001F4CB Detached session"));
-                    sessionItem->setForeground(0, QBrush(QColor(140, 140, 140)));
-                } else {
-                    sessionItem->setText(0, i18n("(no session)"));
-                    QFont f = sessionItem->font(0);
-                    f.setItalic(true);
-                    sessionItem->setFont(0, f);
-                    sessionItem->setForeground(0, QBrush(QColor(120, 120, 120)));
-                }
-            }
+            populateAgentItem(item, entry.info, entry.status);
         }
     }
 
@@ -293,8 +275,11 @@ void AgentManagerPanel::rebuildTree()
 
 void AgentManagerPanel::updateAgentItem(QTreeWidgetItem *item, AgentProvider *provider, const AgentInfo &info)
 {
-    AgentStatus status = provider->agentStatus(info.id);
+    populateAgentItem(item, info, provider->agentStatus(info.id));
+}
 
+void AgentManagerPanel::populateAgentItem(QTreeWidgetItem *item, const AgentInfo &info, const AgentStatus &status)
+{
     // Col 0: name + truncated goal
     QString goalPreview = info.goal;
     if (goalPreview.length() > 40) {
@@ -319,6 +304,69 @@ void AgentManagerPanel::updateAgentItem(QTreeWidgetItem *item, AgentProvider *pr
         statusText += QStringLiteral("  ") + timing;
     }
     item->setText(1, statusText);
+
+    // Child items for details
+    qDeleteAll(item->takeChildren());
+
+    // Schedule line
+    if (!info.schedule.isEmpty()) {
+        auto *schedItem = new QTreeWidgetItem(item);
+        schedItem->setText(0, QStringLiteral("\u23F0 ") + info.schedule);
+        schedItem->setFlags(schedItem->flags() & ~Qt::ItemIsSelectable);
+    }
+
+    // Budget line
+    if (info.budget.dailyUSD > 0.0) {
+        auto *budgetItem = new QTreeWidgetItem(item);
+        budgetItem->setText(0, QStringLiteral("$%1 / $%2 today").arg(status.dailySpentUSD, 0, 'f', 2).arg(info.budget.dailyUSD, 0, 'f', 2));
+        budgetItem->setFlags(budgetItem->flags() & ~Qt::ItemIsSelectable);
+    }
+
+    // Last result
+    if (!status.lastSummary.isEmpty()) {
+        auto *resultItem = new QTreeWidgetItem(item);
+        QString prefix = (status.state == AgentStatus::Error) ? QStringLiteral("\u26A0 ") : QStringLiteral("\u2713 ");
+        resultItem->setText(0, prefix + status.lastSummary);
+        resultItem->setFlags(resultItem->flags() & ~Qt::ItemIsSelectable);
+    }
+
+    // Brief
+    if (!status.brief.direction.isEmpty() && !status.brief.isDone) {
+        auto *briefItem = new QTreeWidgetItem(item);
+        briefItem->setText(0, i18n("Brief: \"%1\"", status.brief.direction));
+        briefItem->setFlags(briefItem->flags() & ~Qt::ItemIsSelectable);
+
+        for (const QString &note : status.brief.steeringNotes) {
+            auto *noteItem = new QTreeWidgetItem(briefItem);
+            noteItem->setText(0, i18n("Steer: \"%1\"", note));
+            noteItem->setFlags(noteItem->flags() & ~Qt::ItemIsSelectable);
+        }
+    }
+
+    // Session linkage child node (when linker is connected)
+    if (m_linker) {
+        auto *sessionItem = new QTreeWidgetItem(item);
+        sessionItem->setData(0, Qt::UserRole + 10, QStringLiteral("session-link"));
+        sessionItem->setData(0, AgentIdRole, info.id);
+
+        if (m_linker->hasActiveTab(info.id)) {
+            sessionItem->setText(0, QStringLiteral("\U0001F4CB Active session"));
+            QFont f = sessionItem->font(0);
+            f.setBold(true);
+            sessionItem->setFont(0, f);
+            // Add [Tab] badge to the agent node itself
+            item->setText(0, info.name + QStringLiteral(" [Tab]"));
+        } else if (m_linker->hasDetachedSession(info.id)) {
+            sessionItem->setText(0, QStringLiteral("\U0001F4CB Detached session"));
+            sessionItem->setForeground(0, QBrush(QColor(140, 140, 140)));
+        } else {
+            sessionItem->setText(0, i18n("(no session)"));
+            QFont f = sessionItem->font(0);
+            f.setItalic(true);
+            sessionItem->setFont(0, f);
+            sessionItem->setForeground(0, QBrush(QColor(120, 120, 120)));
+        }
+    }
 }
 
 QTreeWidgetItem *AgentManagerPanel::findAgentItem(const QString &providerId, const QString &agentId) const
@@ -412,7 +460,7 @@ void AgentManagerPanel::showContextMenu(const QPoint &pos)
         return;
     }
 
-    AgentStatus status = prov->agentStatus(agentId);
+    AgentStatus status = statusOf(prov, agentId);
     AgentAttachInfo attach = prov->attachInfo(agentId);
 
     QMenu menu(this);
@@ -488,7 +536,7 @@ void AgentManagerPanel::actionTriggerRun(AgentProvider *provider, const QString
     bool ok;
     QString task = QInputDialog::getText(this, i18n("Trigger Run"), i18n("Task override (optional):"), QLineEdit::Normal, QString(), &ok);
     if (ok) {
-        provider->triggerRun(agentId, task);
+        provider->triggerRunAsync(agentId, task);
     }
 }
 
@@ -497,7 +545,7 @@ void AgentManagerPanel::actionSetBrief(AgentProvider *provider, const QString &a
     bool ok;
     QString direction = QInputDialog::getMultiLineText(this, i18n("Set Brief"), i18n("Creative direction:"), QString(), &ok);
     if (ok && !direction.isEmpty()) {
-        provider->setBrief(agentId, direction);
+        provider->setBriefAsync(agentId, direction);
     }
 }
 
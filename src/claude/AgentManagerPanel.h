@@ -26,6 +26,10 @@ namespace Konsolai
  * Shows a tree of agents grouped by provider, with status badges,
  * budget info, and context menu actions for triggering runs,
  * setting briefs, viewing reports, and attaching interactively.
+ *
+ * Providers with interfaceVersion() >= 2 are only read through their
+ * snapshots; the tree is rebuilt when agents are added or removed and
+ * otherwise updated item by item from the snapshot delta.
  */
 class KONSOLEPRIVATE_EXPORT AgentManagerPanel : public QWidget
 {
@@ -81,8 +85,11 @@ private Q_SLOTS:
 private:
     void setupUi();
     void rebuildTree();
+    void onSnapshotUpdated(AgentProvider *provider, const AgentFleetDelta &delta);
     void applyFilter(const QString &text);
     void updateAgentItem(QTreeWidgetItem *item, AgentProvider *provider, const AgentInfo &info);
+    void populateAgentItem(QTreeWidgetItem *item, const AgentInfo &info, const AgentStatus &status);
+    AgentStatus statusOf(AgentProvider *provider, const QString &agentId) const;
     QTreeWidgetItem *findAgentItem(const QString &providerId, const QString &agentId) const;
     QString formatTimeSince(const QDateTime &dt) const;
     QString stateIcon(AgentStatus::State state) const;
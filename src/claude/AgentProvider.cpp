@@ -5,5 +5,68 @@
 
 #include "AgentProvider.h"
 
+#include <QPromise>
+
+namespace Konsolai
+{
+
+const AgentSnapshotEntry *AgentFleetSnapshot::find(const QString &id) const
+{
+    const auto it = indexById.constFind(id);
+    return it == indexById.constEnd() ? nullptr : &entries.at(it.value());
+}
+
+void AgentFleetSnapshot::finalize()
+{
+    indexById.clear();
+    indexById.reserve(entries.size());
+    totalDailySpendUSD = 0.0;
+    totalDailyBudgetUSD = 0.0;
+    for (qsizetype i = 0; i < entries.size(); ++i) {
+        const AgentSnapshotEntry &entry = entries.at(i);
+        indexById.insert(entry.info.id, i);
+        totalDailySpendUSD += entry.status.dailySpentUSD;
+        totalDailyBudgetUSD += entry.info.budget.dailyUSD;
+    }
+}
+
+AgentFleetSnapshotPtr AgentProvider::snapshot() const
+{
+    auto snap = std::make_shared<AgentFleetSnapshot>();
+    const QList<AgentInfo> agentList = agents();
+    snap->entries.reserve(agentList.size());
+    for (const AgentInfo &info : agentList) {
+        snap->entries.append({info, agentStatus(info.id)});
+    }
+    snap->finalize();
+    return snap;
+}
+
+QFuture<bool> AgentProvider::triggerRunAsync(const QString &id, const QString &task)
+{
+    return readyFuture(triggerRun(id, task));
+}
+
+QFuture<bool> AgentProvider::setBriefAsync(const QString &id, const QString &direction)
+{
+    return readyFuture(setBrief(id, direction));
+}
+
+QFuture<bool> AgentProvider::createAgentAsync(const AgentConfig &config)
+{
+    return readyFuture(createAgent(config));
+}
+
+QFuture<bool> AgentProvider::readyFuture(bool value)
+{
+    QPromise<bool> promise;
+    promise.start();
+    promise.addResult(value);
+    promise.finish();
+    return promise.future();
+}
+
+} // namespace Konsolai
+
 // MOC-generated code for Q_OBJECT in the abstract base class
 #include "moc_AgentProvider.cpp"
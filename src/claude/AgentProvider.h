@@ -9,10 +9,14 @@
 #include "konsoleprivate_export.h"
 
 #include <QDateTime>
+#include <QFuture>
+#include <QHash>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 
+#include <memory>
+
 namespace Konsolai
 {
 
@@ -108,6 +112,51 @@ struct AgentConfig {
     bool schedulePaused = false;
 };
 
+struct AgentSnapshotEntry {
+    AgentInfo info;
+    AgentStatus status;
+};
+
+/**
+ * Immutable view of all agents of a provider at one point in time.
+ *
+ * Snapshots are shared between threads and never modified once published;
+ * a provider publishes a new snapshot instead of changing the old one.
+ */
+struct KONSOLEPRIVATE_EXPORT AgentFleetSnapshot {
+    QList<AgentSnapshotEntry> entries; // ordered by agent id
+    QHash<QString, qsizetype> indexById;
+    double totalDailySpendUSD = 0.0;
+    double totalDailyBudgetUSD = 0.0;
+    quint64 generation = 0;
+
+    /** Entry of agent @p id, or nullptr. */
+    const AgentSnapshotEntry *find(const QString &id) const;
+
+    /** Recomputes the index and totals after entries changed. */
+    void finalize();
+};
+
+using AgentFleetSnapshotPtr = std::shared_ptr<const AgentFleetSnapshot>;
+
+/** Agents which differ between two consecutive snapshots. */
+struct AgentFleetDelta {
+    QStringList added;
+    QStringList removed;
+    QStringList changed;
+
+    bool isEmpty() const
+    {
+        return added.isEmpty() && removed.isEmpty() && changed.isEmpty();
+    }
+
+    /** True if agents were added or removed, not just changed. */
+    bool isStructural() const
+    {
+        return !added.isEmpty() || !removed.isEmpty();
+    }
+};
+
 /**
  * Abstract interface for agent management backends.
  *
@@ -115,6 +164,12 @@ struct AgentConfig {
  * agent management panel. The interface is versioned: interfaceVersion()
  * returns 1 for the initial release. When new optional methods are added,
  * the panel checks provider->interfaceVersion() >= N before calling them.
+ *
+ * Version 2 adds snapshots: snapshot() returns the last published
+ * AgentFleetSnapshot without doing any I/O, refreshSnapshot() asks for a
+ * new one to be built in the background, and snapshotUpdated() reports
+ * which agents differ from the previous snapshot.  The *Async() methods
+ * return futures instead of blocking until the backend answered.
  */
 class KONSOLEPRIVATE_EXPORT AgentProvider : public QObject
 {
@@ -192,12 +247,40 @@ public:
     /** Clear session ID for fresh context. */
     virtual bool resetSession(const QString &id) = 0;
 
+    /**
+     * Last published snapshot, or nullptr if none has been built yet.
+     * v2+ providers return a cached snapshot.  The default builds one
+     * synchronously from agents() and agentStatus().
+     */
+    virtual AgentFleetSnapshotPtr snapshot() const;
+
+    /** Builds a new snapshot in the background. v2+ — check interfaceVersion() >= 2. */
+    virtual void refreshSnapshot()
+    {
+    }
+
+    /** Kicks off an immediate run without blocking. */
+    virtual QFuture<bool> triggerRunAsync(const QString &id, const QString &task = QString());
+
+    /** Sets the creative brief without blocking. */
+    virtual QFuture<bool> setBriefAsync(const QString &id, const QString &direction);
+
+    /** Creates a new agent without blocking. */
+    virtual QFuture<bool> createAgentAsync(const AgentConfig &config);
+
+protected:
+    /** Returns a future which already holds @p value. */
+    static QFuture<bool> readyFuture(bool value);
+
 Q_SIGNALS:
     /** Emitted when a specific agent's status changes. */
     void agentChanged(const QString &id);
 
     /** Emitted when the agent list changes (agent added/removed). */
     void agentsReloaded();
+
+    /** Emitted when a new snapshot was published.  v2+ only. */
+    void snapshotUpdated(const AgentFleetDelta &delta);
 };
 
 } // namespace Konsolai
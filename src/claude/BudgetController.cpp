@@ -13,15 +13,26 @@ namespace Konsolai
 BudgetController::BudgetController(QObject *parent)
     : QObject(parent)
     , m_checkTimer(new QTimer(this))
+    , m_velocityTimer(new QTimer(this))
 {
-    m_checkTimer->setInterval(60000); // 60 seconds
+    // Set for the moment a threshold is crossed rather than polling
+    m_checkTimer->setSingleShot(true);
+    m_checkTimer->setTimerType(Qt::PreciseTimer);
     connect(m_checkTimer, &QTimer::timeout, this, &BudgetController::checkTimeBudget);
-    m_checkTimer->start();
+
+    m_velocityTimer->setInterval(5000);
+    connect(m_velocityTimer, &QTimer::timeout, this, [this]() {
+        if (!m_velocity.isActive()) {
+            m_velocityTimer->stop();
+        }
+        Q_EMIT velocityUpdated();
+    });
 }
 
 BudgetController::~BudgetController()
 {
     m_checkTimer->stop();
+    m_velocityTimer->stop();
 }
 
 void BudgetController::setBudget(const SessionBudget &b)
@@ -37,17 +48,30 @@ void BudgetController::setBudget(const SessionBudget &b)
     m_timeExceededEmitted = false;
     m_costExceededEmitted = false;
     m_tokenExceededEmitted = false;
+    scheduleTimeCheck();
 }
 
 void BudgetController::onTokenUsageChanged(const TokenUsage &usage)
 {
-    // Update velocity ring buffer
-    m_velocity.addSample(usage.totalTokens(), usage.estimatedCostUSD());
+    // The velocity is fed per record by onUsageRecord()
+    checkCeilings(usage.totalTokens(), usage.estimatedCostUSD());
+    Q_EMIT velocityUpdated();
+}
+
+void BudgetController::onUsageRecord(const TokenUsage &record, const TokenUsage &total, qint64 atMs)
+{
+    m_velocity.addDelta(record.totalTokens(), record.estimatedCostUSD(), atMs);
+    if (!m_velocityTimer->isActive()) {
+        m_velocityTimer->start();
+    }
+    checkCeilings(total.totalTokens(), total.estimatedCostUSD());
     Q_EMIT velocityUpdated();
+}
 
+void BudgetController::checkCeilings(quint64 tokens, double cost)
+{
     // Check cost ceiling
     if (m_budget.costCeilingUSD > 0.0) {
-        double cost = usage.estimatedCostUSD();
         double percent = (cost / m_budget.costCeilingUSD) * 100.0;
 
         if (cost >= m_budget.costCeilingUSD) {
@@ -68,7 +92,6 @@ void BudgetController::onTokenUsageChanged(const TokenUsage &usage)
 
     // Check token ceiling
     if (m_budget.tokenCeiling > 0) {
-        quint64 tokens = usage.totalTokens();
         double percent = (static_cast<double>(tokens) / static_cast<double>(m_budget.tokenCeiling)) * 100.0;
 
         if (tokens >= m_budget.tokenCeiling) {
@@ -138,15 +161,15 @@ void BudgetController::onResourceUsageChanged(const ResourceUsage &usage)
 void BudgetController::checkTimeBudget()
 {
     if (m_budget.timeLimitMinutes > 0 && m_budget.startedAt.isValid()) {
-        int elapsed = m_budget.elapsedMinutes();
-        double percent = (static_cast<double>(elapsed) / static_cast<double>(m_budget.timeLimitMinutes)) * 100.0;
+        qint64 elapsed = m_budget.elapsedMs();
+        double percent = (static_cast<double>(elapsed) / static_cast<double>(m_budget.timeLimitMs())) * 100.0;
 
-        if (elapsed >= m_budget.timeLimitMinutes) {
+        if (elapsed >= m_budget.timeLimitMs()) {
             if (!m_budget.timeExceeded) {
                 m_budget.timeExceeded = true;
                 if (!m_timeExceededEmitted) {
                     m_timeExceededEmitted = true;
-                    qCDebug(KonsolaiLog) << "BudgetController: Time budget exceeded -" << elapsed << ">=" << m_budget.timeLimitMinutes << "minutes";
+                    qCDebug(KonsolaiLog) << "BudgetController: Time budget exceeded -" << elapsed / 60000.0 << ">=" << m_budget.timeLimitMinutes << "minutes";
                     Q_EMIT budgetExceeded(QStringLiteral("time"));
                 }
             }
@@ -157,9 +180,25 @@ void BudgetController::checkTimeBudget()
         }
     }
 
+    scheduleTimeCheck();
     Q_EMIT velocityUpdated();
 }
 
+void BudgetController::scheduleTimeCheck()
+{
+    m_checkTimer->stop();
+    if (m_budget.timeLimitMinutes <= 0 || !m_budget.startedAt.isValid() || m_budget.timeExceeded) {
+        return;
+    }
+
+    const qint64 limit = m_budget.timeLimitMs();
+    const qint64 warningAt = static_cast<qint64>(static_cast<double>(limit) * m_budget.warningThresholdPercent / 100.0);
+    const qint64 next = m_timeWarningEmitted ? limit : qMin(warningAt, limit);
+    // Long limits are looked at again every hour, QTimer takes an int
+    const qint64 wait = qBound<qint64>(0, next - m_budget.elapsedMs(), 3600000);
+    m_checkTimer->start(static_cast<int>(wait));
+}
+
 bool BudgetController::shouldBlockYolo() const
 {
     return m_budget.timeExceeded || m_budget.costExceeded || m_budget.tokenExceeded || m_gate.gateTriggered;
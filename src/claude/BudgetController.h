@@ -16,6 +16,9 @@
 #include <QTimer>
 #include <QVector>
 
+#include <chrono>
+#include <cmath>
+
 #ifdef Q_OS_LINUX
 #include <unistd.h>
 #endif
@@ -72,17 +75,27 @@ struct KONSOLEPRIVATE_EXPORT SessionBudget {
             maxPct = qMax(maxPct, static_cast<double>(currentTokens) / static_cast<double>(tokenCeiling) * 100.0);
         }
         if (timeLimitMinutes > 0) {
-            maxPct = qMax(maxPct, static_cast<double>(elapsedMinutes()) / static_cast<double>(timeLimitMinutes) * 100.0);
+            maxPct = qMax(maxPct, static_cast<double>(elapsedMs()) / static_cast<double>(timeLimitMs()) * 100.0);
         }
         return maxPct;
     }
 
     int elapsedMinutes() const
+    {
+        return static_cast<int>(elapsedMs() / 60000);
+    }
+
+    qint64 elapsedMs() const
     {
         if (!startedAt.isValid()) {
             return 0;
         }
-        return static_cast<int>(startedAt.secsTo(QDateTime::currentDateTime()) / 60);
+        return startedAt.msecsTo(QDateTime::currentDateTime());
+    }
+
+    qint64 timeLimitMs() const
+    {
+        return static_cast<qint64>(timeLimitMinutes) * 60000;
     }
 
     QJsonObject toJson() const
@@ -126,78 +139,75 @@ struct KONSOLEPRIVATE_EXPORT SessionBudget {
 };
 
 /**
- * Ring-buffer velocity tracker: one sample per minute, 2-hour history.
+ * Token and cost rates, decayed exponentially over several windows.
+ *
+ * Every usage record is added as it is parsed, stamped with a monotonic
+ * clock (see now()).  Each window keeps its own rate, which decays with
+ * the window as time constant: the short window follows a burst within
+ * seconds while the long one shows the sustained burn.  Nothing has to be
+ * sampled periodically to keep the rates current.
  */
 struct KONSOLEPRIVATE_EXPORT TokenVelocity {
-    struct VelocitySample {
-        QDateTime timestamp;
-        quint64 totalTokens = 0;
-        double costUSD = 0.0;
+    enum Window {
+        ShortWindow, // 15 seconds
+        MinuteWindow,
+        LongWindow, // 5 minutes
+        WindowCount
     };
 
-    static constexpr int kMaxSamples = 120;
+    static constexpr qint64 kWindowMs[WindowCount] = {15000, 60000, 300000};
 
-    QVector<VelocitySample> samples;
-    int head = 0;
-    int count = 0;
+    // Per millisecond, as of lastEventMs
+    double tokenRate[WindowCount] = {};
+    double costRate[WindowCount] = {};
+    qint64 lastEventMs = -1;
 
-    TokenVelocity()
+    /** Milliseconds on a monotonic clock; wall clock changes don't skew the rates. */
+    static qint64 now()
     {
-        samples.resize(kMaxSamples);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     }
 
-    void addSample(quint64 totalTokens, double costUSD)
+    /** The shortest window covering @p seconds, or the longest one. */
+    static Window windowFor(int seconds)
     {
-        VelocitySample s;
-        s.timestamp = QDateTime::currentDateTime();
-        s.totalTokens = totalTokens;
-        s.costUSD = costUSD;
-        samples[head] = s;
-        head = (head + 1) % kMaxSamples;
-        if (count < kMaxSamples) {
-            ++count;
+        for (int w = 0; w < WindowCount; ++w) {
+            if (static_cast<qint64>(seconds) * 1000 <= kWindowMs[w]) {
+                return static_cast<Window>(w);
+            }
         }
+        return LongWindow;
     }
 
-    /**
-     * 5-minute rolling average of tokens per minute.
-     */
-    double tokensPerMinute() const
+    void addDelta(quint64 tokens, double costUSD, qint64 atMs = now())
     {
-        if (count < 2) {
-            return 0.0;
-        }
-        // Look back up to 5 samples (5 minutes)
-        int lookback = qMin(count, 5);
-        int newest = (head - 1 + kMaxSamples) % kMaxSamples;
-        int oldest = (head - lookback + kMaxSamples) % kMaxSamples;
-        const auto &s0 = samples[oldest];
-        const auto &s1 = samples[newest];
-        double minutes = s0.timestamp.secsTo(s1.timestamp) / 60.0;
-        if (minutes <= 0.0) {
-            return 0.0;
+        // Records stamped out of order count as simultaneous
+        const qint64 at = qMax(atMs, lastEventMs);
+        for (int w = 0; w < WindowCount; ++w) {
+            const double decay = decayFactor(static_cast<Window>(w), at);
+            tokenRate[w] = tokenRate[w] * decay + static_cast<double>(tokens) / static_cast<double>(kWindowMs[w]);
+            costRate[w] = costRate[w] * decay + costUSD / static_cast<double>(kWindowMs[w]);
         }
-        return static_cast<double>(s1.totalTokens - s0.totalTokens) / minutes;
+        lastEventMs = at;
+    }
+
+    double tokensPerMinute(Window window = MinuteWindow, qint64 atMs = now()) const
+    {
+        return tokenRate[window] * decayFactor(window, atMs) * 60000.0;
+    }
+
+    double costPerMinute(Window window = MinuteWindow, qint64 atMs = now()) const
+    {
+        return costRate[window] * decayFactor(window, atMs) * 60000.0;
     }
 
     /**
-     * 5-minute rolling average of cost per minute.
+     * True while the long window still shows at least a token per minute,
+     * i.e. while the rates are worth showing and updating.
      */
-    double costPerMinute() const
+    bool isActive(qint64 atMs = now()) const
     {
-        if (count < 2) {
-            return 0.0;
-        }
-        int lookback = qMin(count, 5);
-        int newest = (head - 1 + kMaxSamples) % kMaxSamples;
-        int oldest = (head - lookback + kMaxSamples) % kMaxSamples;
-        const auto &s0 = samples[oldest];
-        const auto &s1 = samples[newest];
-        double minutes = s0.timestamp.secsTo(s1.timestamp) / 60.0;
-        if (minutes <= 0.0) {
-            return 0.0;
-        }
-        return (s1.costUSD - s0.costUSD) / minutes;
+        return tokensPerMinute(LongWindow, atMs) >= 1.0;
     }
 
     /**
@@ -218,10 +228,10 @@ struct KONSOLEPRIVATE_EXPORT TokenVelocity {
     /**
      * Format as "2.3K/m $0.04/m"
      */
-    QString formatVelocity() const
+    QString formatVelocity(Window window = MinuteWindow) const
     {
-        double tpm = tokensPerMinute();
-        double cpm = costPerMinute();
+        double tpm = tokensPerMinute(window);
+        double cpm = costPerMinute(window);
         QString tokenStr;
         if (tpm >= 1000.0) {
             tokenStr = QStringLiteral("%1K/m").arg(tpm / 1000.0, 0, 'f', 1);
@@ -230,6 +240,15 @@ struct KONSOLEPRIVATE_EXPORT TokenVelocity {
         }
         return QStringLiteral("%1 $%2/m").arg(tokenStr).arg(cpm, 0, 'f', 2);
     }
+
+    /** How much of the rate of @p window is left at @p atMs. */
+    double decayFactor(Window window, qint64 atMs) const
+    {
+        if (lastEventMs < 0 || atMs <= lastEventMs) {
+            return 1.0;
+        }
+        return std::exp(-static_cast<double>(atMs - lastEventMs) / static_cast<double>(kWindowMs[window]));
+    }
 };
 
 /**
@@ -310,6 +329,12 @@ public:
     }
 
     void onTokenUsageChanged(const TokenUsage &usage);
+
+    /**
+     * Adds the usage record @p record, parsed at @p atMs, to the velocity
+     * and checks the ceilings against @p total, which includes it.
+     */
+    void onUsageRecord(const TokenUsage &record, const TokenUsage &total, qint64 atMs = TokenVelocity::now());
     void onResourceUsageChanged(const ResourceUsage &usage);
     void checkTimeBudget();
 
@@ -323,7 +348,11 @@ Q_SIGNALS:
     void velocityUpdated();
 
 private:
-    QTimer *m_checkTimer = nullptr;
+    void checkCeilings(quint64 tokens, double costUSD);
+    void scheduleTimeCheck();
+
+    QTimer *m_checkTimer = nullptr; // fires when the time budget next crosses a threshold
+    QTimer *m_velocityTimer = nullptr; // refreshes the decaying rates while they are active
     SessionBudget m_budget;
     TokenVelocity m_velocity;
     ResourceGate m_gate;
@@ -0,0 +1,315 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ClaudeFleetService.h"
+#include "ClaudeSession.h"
+#include "ClaudeSessionRegistry.h"
+#include "KonsolaiLogging.h"
+#include "OutputStream.h"
+
+#if HAVE_DBUS
+#include "claudefleetserviceadaptor.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusServiceWatcher>
+#endif
+
+namespace Konsolai
+{
+
+static ClaudeFleetService *s_fleetServiceInstance = nullptr;
+
+ClaudeFleetService::ClaudeFleetService(ClaudeSessionRegistry *registry, QObject *parent)
+    : QObject(parent)
+    , m_registry(registry)
+{
+    if (!s_fleetServiceInstance) {
+        s_fleetServiceInstance = this;
+    }
+
+    m_batchTimer.setInterval(BatchInterval);
+    connect(&m_batchTimer, &QTimer::timeout, this, &ClaudeFleetService::flush);
+
+    if (m_registry) {
+        const QList<ClaudeSession *> active = m_registry->activeSessions();
+        for (ClaudeSession *session : active) {
+            watchSession(session);
+        }
+        connect(m_registry, &ClaudeSessionRegistry::sessionRegistered, this, [this](ClaudeSession *session) {
+            watchSession(session);
+            if (isStreamed(session->sessionName())) {
+                session->setOutputStreaming(true);
+            }
+        });
+        connect(m_registry, &ClaudeSessionRegistry::sessionUnregistered, this, [this](const QString &sessionName) {
+            m_announced.remove(sessionName);
+            m_dirtyStates.remove(sessionName);
+        });
+    }
+
+#if HAVE_DBUS
+    new ClaudeFleetServiceAdaptor(this);
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/Fleet"), this);
+
+    m_clientWatcher = new QDBusServiceWatcher(this);
+    m_clientWatcher->setConnection(QDBusConnection::sessionBus());
+    m_clientWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_clientWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &ClaudeFleetService::removeSubscriptionsOf);
+#endif
+}
+
+ClaudeFleetService::~ClaudeFleetService()
+{
+    if (s_fleetServiceInstance == this) {
+        s_fleetServiceInstance = nullptr;
+    }
+}
+
+ClaudeFleetService *ClaudeFleetService::instance()
+{
+    return s_fleetServiceInstance;
+}
+
+QList<ClaudeSession *> ClaudeFleetService::resolve(const QStringList &sessionNames) const
+{
+    QList<ClaudeSession *> result;
+    if (!m_registry) {
+        return result;
+    }
+    for (const QString &name : sessionNames) {
+        if (ClaudeSession *session = m_registry->findSession(name)) {
+            result.append(session);
+        }
+    }
+    return result;
+}
+
+void ClaudeFleetService::watchSession(ClaudeSession *session)
+{
+    const QString name = session->sessionName();
+    connect(session, &ClaudeSession::stateChanged, this, [this, name]() {
+        if (isStreamed(name)) {
+            m_dirtyStates.insert(name);
+        }
+    });
+}
+
+QStringList ClaudeFleetService::sessions() const
+{
+    QStringList names;
+    if (m_registry) {
+        const QList<ClaudeSession *> active = m_registry->activeSessions();
+        for (ClaudeSession *session : active) {
+            names.append(session->sessionName());
+        }
+    }
+    names.sort();
+    return names;
+}
+
+QVariantMap ClaudeFleetService::describe(ClaudeSession *session) const
+{
+    const TokenUsage &usage = session->tokenUsage();
+    QVariantMap state;
+    state[QStringLiteral("state")] = session->stateString();
+    state[QStringLiteral("currentTask")] = session->currentTask();
+    state[QStringLiteral("sessionId")] = session->sessionId();
+    state[QStringLiteral("profileName")] = session->profileName();
+    state[QStringLiteral("workingDirectory")] = session->workingDirectory();
+    state[QStringLiteral("totalTokens")] = usage.totalTokens();
+    state[QStringLiteral("estimatedCostUSD")] = usage.estimatedCostUSD();
+    state[QStringLiteral("yoloMode")] = session->yoloMode();
+    if (const OutputStream *stream = session->outputStream()) {
+        state[QStringLiteral("cursor")] = stream->cursor();
+    }
+    return state;
+}
+
+QVariantMap ClaudeFleetService::sessionStates(const QStringList &sessionNames) const
+{
+    QVariantMap states;
+    const QList<ClaudeSession *> targets = sessionNames.isEmpty() && m_registry ? m_registry->activeSessions() : resolve(sessionNames);
+    for (ClaudeSession *session : targets) {
+        states[session->sessionName()] = describe(session);
+    }
+    return states;
+}
+
+int ClaudeFleetService::sendPrompts(const QStringList &sessionNames, const QString &prompt)
+{
+    const QList<ClaudeSession *> targets = resolve(sessionNames);
+    ClaudeSession::broadcastPrompt(targets, prompt);
+    return targets.size();
+}
+
+int ClaudeFleetService::approvePermissions(const QStringList &sessionNames)
+{
+    const QList<ClaudeSession *> targets = resolve(sessionNames);
+    for (ClaudeSession *session : targets) {
+        session->approvePermission();
+    }
+    return targets.size();
+}
+
+int ClaudeFleetService::denyPermissions(const QStringList &sessionNames)
+{
+    const QList<ClaudeSession *> targets = resolve(sessionNames);
+    for (ClaudeSession *session : targets) {
+        session->denyPermission();
+    }
+    return targets.size();
+}
+
+int ClaudeFleetService::stopSessions(const QStringList &sessionNames)
+{
+    const QList<ClaudeSession *> targets = resolve(sessionNames);
+    for (ClaudeSession *session : targets) {
+        session->stop();
+    }
+    return targets.size();
+}
+
+uint ClaudeFleetService::subscribe(const QStringList &sessionNames)
+{
+    Subscription subscription;
+    subscription.all = sessionNames.isEmpty();
+    subscription.sessions = QSet<QString>(sessionNames.cbegin(), sessionNames.cend());
+
+#if HAVE_DBUS
+    if (calledFromDBus()) {
+        subscription.owner = message().service();
+        m_clientWatcher->addWatchedService(subscription.owner);
+    }
+#endif
+
+    const uint id = m_nextSubscription++;
+    m_subscriptions.insert(id, subscription);
+    updateStreaming();
+
+    qCDebug(KonsolaiLog) << "ClaudeFleetService: subscription" << id << "for" << (subscription.all ? QStringLiteral("all sessions") : sessionNames.join(QLatin1Char(' ')));
+    return id;
+}
+
+void ClaudeFleetService::unsubscribe(uint subscription)
+{
+    if (m_subscriptions.remove(subscription) > 0) {
+        updateStreaming();
+    }
+}
+
+void ClaudeFleetService::removeSubscriptionsOf(const QString &owner)
+{
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
+        if (it->owner == owner) {
+            it = m_subscriptions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+#if HAVE_DBUS
+    m_clientWatcher->removeWatchedService(owner);
+#endif
+    updateStreaming();
+}
+
+bool ClaudeFleetService::isStreamed(const QString &sessionName) const
+{
+    for (const Subscription &subscription : m_subscriptions) {
+        if (subscription.all || subscription.sessions.contains(sessionName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClaudeFleetService::updateStreaming()
+{
+    if (m_registry) {
+        const QList<ClaudeSession *> active = m_registry->activeSessions();
+        for (ClaudeSession *session : active) {
+            const bool streamed = isStreamed(session->sessionName());
+            session->setOutputStreaming(streamed);
+            if (!streamed) {
+                m_announced.remove(session->sessionName());
+                m_dirtyStates.remove(session->sessionName());
+            }
+        }
+    }
+
+    if (m_subscriptions.isEmpty()) {
+        m_batchTimer.stop();
+    } else if (!m_batchTimer.isActive()) {
+        m_batchTimer.start();
+    }
+}
+
+void ClaudeFleetService::flush()
+{
+    if (!m_registry) {
+        return;
+    }
+
+    QVariantMap cursors;
+    QVariantMap states;
+    const QList<ClaudeSession *> active = m_registry->activeSessions();
+    for (ClaudeSession *session : active) {
+        const QString name = session->sessionName();
+        if (const OutputStream *stream = session->outputStream()) {
+            const quint64 cursor = stream->cursor();
+            auto announced = m_announced.find(name);
+            if (announced == m_announced.end() || announced.value() != cursor) {
+                // Nothing was streamed yet
+                if (announced == m_announced.end() && cursor == stream->firstCursor()) {
+                    continue;
+                }
+                m_announced.insert(name, cursor);
+                cursors[name] = cursor;
+            }
+        }
+        if (m_dirtyStates.contains(name)) {
+            states[name] = describe(session);
+        }
+    }
+    m_dirtyStates.clear();
+
+    if (!cursors.isEmpty()) {
+        Q_EMIT outputAvailable(cursors);
+    }
+    if (!states.isEmpty()) {
+        Q_EMIT statesChanged(states);
+    }
+}
+
+QVariantMap ClaudeFleetService::readOutput(const QVariantMap &cursors, int maxBytesPerSession)
+{
+    const int limit = maxBytesPerSession > 0 ? maxBytesPerSession : DefaultReadLimit;
+
+    QVariantMap result;
+    for (auto it = cursors.constBegin(); it != cursors.constEnd(); ++it) {
+        QVariantMap entry;
+        ClaudeSession *session = m_registry ? m_registry->findSession(it.key()) : nullptr;
+        const OutputStream *stream = session ? session->outputStream() : nullptr;
+        if (!stream) {
+            entry[QStringLiteral("data")] = QByteArray();
+            entry[QStringLiteral("cursor")] = it.value().toULongLong();
+            entry[QStringLiteral("truncated")] = false;
+            entry[QStringLiteral("streaming")] = false;
+        } else {
+            quint64 next = 0;
+            bool truncated = false;
+            entry[QStringLiteral("data")] = stream->readSince(it.value().toULongLong(), limit, &next, &truncated);
+            entry[QStringLiteral("cursor")] = next;
+            entry[QStringLiteral("truncated")] = truncated;
+            entry[QStringLiteral("streaming")] = true;
+        }
+        result[it.key()] = entry;
+    }
+    return result;
+}
+
+} // namespace Konsolai
+
+#include "moc_ClaudeFleetService.cpp"
@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef CLAUDEFLEETSERVICE_H
+#define CLAUDEFLEETSERVICE_H
+
+#include "konsoleprivate_export.h"
+
+#include "config-konsole.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
+
+#if HAVE_DBUS
+#include <QDBusContext>
+class QDBusServiceWatcher;
+#endif
+
+namespace Konsolai
+{
+
+class ClaudeSession;
+class ClaudeSessionRegistry;
+
+/**
+ * Fleet-wide D-Bus interface (org.kde.konsolai.Fleet at /Fleet) for
+ * automation which watches or drives many Claude sessions at once.
+ *
+ * Output: a client subscribes to a set of sessions (or all of them), which
+ * makes those sessions keep their recent output in an OutputStream.  Every
+ * BatchInterval ms, a single outputAvailable() signal lists the sessions
+ * with new output and their current cursors.  The client then fetches
+ * everything after the cursors it last saw with one readOutput() call.
+ * State changes of subscribed sessions are batched the same way into
+ * statesChanged().  Subscriptions of a D-Bus client end when it leaves the bus.
+ *
+ * Batch methods act on a list of session names in one call; they return
+ * how many of the named sessions were found.
+ *
+ * Sessions are identified by their tmux session name.
+ */
+class KONSOLEPRIVATE_EXPORT ClaudeFleetService : public QObject
+#if HAVE_DBUS
+    , protected QDBusContext
+#endif
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.konsolai.Fleet")
+
+public:
+    explicit ClaudeFleetService(ClaudeSessionRegistry *registry, QObject *parent = nullptr);
+    ~ClaudeFleetService() override;
+
+    static ClaudeFleetService *instance();
+
+    /** Whether any subscription covers @p sessionName. */
+    bool isStreamed(const QString &sessionName) const;
+
+    /** Emits pending outputAvailable()/statesChanged() right away. */
+    void flush();
+
+    static constexpr int BatchInterval = 100;
+    static constexpr int DefaultReadLimit = 256 * 1024;
+
+public Q_SLOTS:
+    /** Names of all active sessions. */
+    QStringList sessions() const;
+
+    /** State of each named session (all sessions if empty), keyed by name. */
+    QVariantMap sessionStates(const QStringList &sessionNames) const;
+
+    /** Sends @p prompt to every named session in one batch. */
+    int sendPrompts(const QStringList &sessionNames, const QString &prompt);
+
+    int approvePermissions(const QStringList &sessionNames);
+    int denyPermissions(const QStringList &sessionNames);
+    int stopSessions(const QStringList &sessionNames);
+
+    /**
+     * Starts streaming the named sessions (all sessions, including future
+     * ones, if empty).  Returns an id for unsubscribe().
+     */
+    uint subscribe(const QStringList &sessionNames);
+    void unsubscribe(uint subscription);
+
+    /**
+     * For each session name in @p cursors, returns the output after the
+     * given cursor as a map with "data" (bytes), "cursor" (pass it back
+     * next time) and "truncated" (output was dropped before it was read).
+     */
+    QVariantMap readOutput(const QVariantMap &cursors, int maxBytesPerSession);
+
+Q_SIGNALS:
+    /** Sessions with new output, mapped to their current cursor. */
+    void outputAvailable(const QVariantMap &cursors);
+
+    /** Subscribed sessions whose state changed, mapped to their new state. */
+    void statesChanged(const QVariantMap &states);
+
+private:
+    struct Subscription {
+        QSet<QString> sessions;
+        bool all = false;
+        QString owner; // D-Bus service which subscribed, if any
+    };
+
+    QList<ClaudeSession *> resolve(const QStringList &sessionNames) const;
+    QVariantMap describe(ClaudeSession *session) const;
+    void watchSession(ClaudeSession *session);
+    void updateStreaming();
+    void removeSubscriptionsOf(const QString &owner);
+
+    ClaudeSessionRegistry *m_registry;
+    QHash<uint, Subscription> m_subscriptions;
+    uint m_nextSubscription = 1;
+    QHash<QString, quint64> m_announced; // last cursor announced per session
+    QSet<QString> m_dirtyStates;
+    QTimer m_batchTimer;
+#if HAVE_DBUS
+    QDBusServiceWatcher *m_clientWatcher = nullptr;
+#endif
+};
+
+} // namespace Konsolai
+
+#endif // CLAUDEFLEETSERVICE_H
@@ -6,6 +6,7 @@
 */
 
 #include "ClaudeHookHandler.h"
+#include "RemoteHookChannel.h"
 
 #include <QCoreApplication>
 #include <QDir>
@@ -79,10 +80,12 @@ void ClaudeHookHandler::ensureDirectoryExists()
 bool ClaudeHookHandler::start()
 {
     qDebug() << "ClaudeHookHandler::start() called for session:" << m_sessionId;
-    qDebug() << "  Mode:" << (m_mode == TCP ? "TCP" : "UnixSocket");
+    qDebug() << "  Mode:" << (m_mode == TCP ? "TCP" : m_mode == Relay ? "Relay" : "UnixSocket");
 
     if (m_mode == TCP) {
         return startTcp();
+    } else if (m_mode == Relay) {
+        return startRelay();
     } else {
         return startUnixSocket();
     }
@@ -150,10 +153,36 @@ bool ClaudeHookHandler::startTcp()
     return true;
 }
 
+bool ClaudeHookHandler::startRelay()
+{
+    qDebug() << "ClaudeHookHandler::startRelay() - host:" << m_relayHost;
+
+    if (m_channel) {
+        return true;
+    }
+    if (m_relayHost.isEmpty()) {
+        Q_EMIT errorOccurred(QStringLiteral("No remote host for the hook relay"));
+        return false;
+    }
+
+    // One channel per host, events of the other sessions there are filtered out
+    m_channel = RemoteHookChannel::forHost(m_relayUser, m_relayHost, m_relayPort);
+    connect(m_channel, &RemoteHookChannel::hookEventReceived, this, [this](const QString &sessionId, const QString &eventType, const QString &eventData) {
+        if (sessionId == m_sessionId) {
+            qDebug() << "ClaudeHookHandler: Received relayed hook event:" << eventType;
+            Q_EMIT hookEventReceived(eventType, eventData);
+        }
+    });
+    m_channel->addSession(m_sessionId);
+    return true;
+}
+
 bool ClaudeHookHandler::isRunning() const
 {
     if (m_mode == TCP) {
         return m_tcpServer && m_tcpServer->isListening();
+    } else if (m_mode == Relay) {
+        return !m_channel.isNull();
     } else {
         return m_server && m_server->isListening();
     }
@@ -163,6 +192,8 @@ QString ClaudeHookHandler::connectionString() const
 {
     if (m_mode == TCP) {
         return QStringLiteral("localhost:%1").arg(m_tcpPort);
+    } else if (m_mode == Relay) {
+        return m_channel ? m_channel->target() : QString();
     } else {
         return m_socketPath;
     }
@@ -207,6 +238,13 @@ void ClaudeHookHandler::stop()
         m_tcpServer = nullptr;
     }
     m_tcpPort = 0;
+
+    // Leave the relay channel, it disconnects after its last session
+    if (m_channel) {
+        disconnect(m_channel, nullptr, this, nullptr);
+        m_channel->removeSession(m_sessionId);
+        m_channel = nullptr;
+    }
 }
 
 void ClaudeHookHandler::onNewConnection()
@@ -343,17 +381,23 @@ QString ClaudeHookHandler::generateHooksConfig() const
     qDebug() << "ClaudeHookHandler: Generating hooks config with handler:" << handlerPath;
     qDebug() << "  Socket path:" << m_socketPath;
 
+    // Quote paths in case they contain spaces
+    return buildHooksConfig([&](const QString &eventType) {
+        return QStringLiteral("'%1' --socket '%2' --event '%3'").arg(handlerPath, m_socketPath, eventType);
+    });
+}
+
+QString ClaudeHookHandler::buildHooksConfig(const std::function<QString(const QString &eventType)> &command)
+{
     QJsonObject hooks;
 
     // Build command string for each hook type
     // Claude Code expects: "command": "string" (not an array)
     // and "matcher": {} (empty object for match-all, not a string)
     auto makeHookEntry = [&](const QString &eventType) -> QJsonArray {
-        // Quote paths in case they contain spaces
-        QString cmdStr = QStringLiteral("'%1' --socket '%2' --event '%3'").arg(handlerPath, m_socketPath, eventType);
         QJsonObject hookDef;
         hookDef[QStringLiteral("type")] = QStringLiteral("command");
-        hookDef[QStringLiteral("command")] = cmdStr;
+        hookDef[QStringLiteral("command")] = command(eventType);
 
         QJsonObject entry;
         entry[QStringLiteral("matcher")] = QStringLiteral("*"); // string = match all
@@ -440,36 +484,19 @@ QString ClaudeHookHandler::generateRemoteHooksConfig(quint16 tunnelPort, const Q
     qDebug() << "ClaudeHookHandler: Generating remote hooks config";
     qDebug() << "  Script path:" << scriptPath;
 
-    QJsonObject hooks;
-
-    // Build command string for each hook type
-    auto makeHookEntry = [&](const QString &eventType) -> QJsonArray {
-        QString cmdStr = QStringLiteral("'%1' --event '%2'").arg(scriptPath, eventType);
-        QJsonObject hookDef;
-        hookDef[QStringLiteral("type")] = QStringLiteral("command");
-        hookDef[QStringLiteral("command")] = cmdStr;
-
-        QJsonObject entry;
-        entry[QStringLiteral("matcher")] = QStringLiteral("*");
-        entry[QStringLiteral("hooks")] = QJsonArray{hookDef};
-        return QJsonArray{entry};
-    };
-
-    hooks[QStringLiteral("Notification")] = makeHookEntry(QStringLiteral("Notification"));
-    hooks[QStringLiteral("Stop")] = makeHookEntry(QStringLiteral("Stop"));
-    hooks[QStringLiteral("PreToolUse")] = makeHookEntry(QStringLiteral("PreToolUse"));
-    hooks[QStringLiteral("PostToolUse")] = makeHookEntry(QStringLiteral("PostToolUse"));
-    hooks[QStringLiteral("PermissionRequest")] = makeHookEntry(QStringLiteral("PermissionRequest"));
-    hooks[QStringLiteral("SubagentStart")] = makeHookEntry(QStringLiteral("SubagentStart"));
-    hooks[QStringLiteral("SubagentStop")] = makeHookEntry(QStringLiteral("SubagentStop"));
-    hooks[QStringLiteral("TeammateIdle")] = makeHookEntry(QStringLiteral("TeammateIdle"));
-    hooks[QStringLiteral("TaskCompleted")] = makeHookEntry(QStringLiteral("TaskCompleted"));
+    return buildHooksConfig([&](const QString &eventType) {
+        return QStringLiteral("'%1' --event '%2'").arg(scriptPath, eventType);
+    });
+}
 
-    QJsonObject root;
-    root[QStringLiteral("hooks")] = hooks;
+QString ClaudeHookHandler::generateRelayHooksConfig() const
+{
+    qDebug() << "ClaudeHookHandler: Generating relay hooks config for session" << m_sessionId;
 
-    QJsonDocument doc(root);
-    return QString::fromUtf8(doc.toJson(QJsonDocument::Indented));
+    // The script path is left to the remote shell to expand
+    return buildHooksConfig([&](const QString &eventType) {
+        return QStringLiteral("\"%1\" --session '%2' --event '%3'").arg(RemoteHookChannel::hookScriptPath(), m_sessionId, eventType);
+    });
 }
 
 // ============================================================================
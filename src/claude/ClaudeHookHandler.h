@@ -14,25 +14,30 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QObject>
+#include <QPointer>
 #include <QSet>
 #include <QString>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTimer>
 
+#include <functional>
+
 namespace Konsolai
 {
 
 class ClaudeSession;
+class RemoteHookChannel;
 
 /**
  * ClaudeHookHandler manages a server for receiving Claude hook events.
  *
- * Supports two modes:
+ * Supports three modes:
  * - UnixSocket: Uses QLocalServer at ~/.konsolai/sessions/{session-id}.sock
  *   Best for local sessions.
  * - TCP: Uses QTcpServer on a dynamic port, accessible via SSH reverse tunnel
- *   Required for remote SSH sessions.
+ * - Relay: Receives the events through the RemoteHookChannel of the remote
+ *   host, shared with the other sessions there.  Used for remote SSH sessions.
  *
  * Claude hooks are configured to call the konsolai-hook-handler binary,
  * which connects to this server and sends JSON-encoded events.
@@ -53,7 +58,8 @@ public:
      */
     enum Mode {
         UnixSocket, ///< Local Unix socket at ~/.konsolai/sessions/{id}.sock
-        TCP ///< TCP server on dynamic port, tunneled via SSH -R
+        TCP, ///< TCP server on dynamic port, tunneled via SSH -R
+        Relay ///< Events spooled on the remote host, see RemoteHookChannel
     };
 
     /**
@@ -81,6 +87,17 @@ public:
         return m_mode;
     }
 
+    /**
+     * Set the remote host whose channel delivers the events (Relay mode,
+     * must be called before start())
+     */
+    void setRelayTarget(const QString &user, const QString &host, int sshPort = 22)
+    {
+        m_relayUser = user;
+        m_relayHost = host;
+        m_relayPort = sshPort;
+    }
+
     /**
      * Get the socket path for this handler (UnixSocket mode)
      */
@@ -114,6 +131,7 @@ public:
     /**
      * Get connection string for remote hooks config
      * In TCP mode: "localhost:PORT"
+     * In Relay mode: the ssh target of the channel
      * In UnixSocket mode: the socket path
      */
     QString connectionString() const;
@@ -152,6 +170,14 @@ public:
      */
     QString generateRemoteHooksConfig(quint16 tunnelPort, const QString &scriptPath) const;
 
+    /**
+     * Generate remote hooks configuration for Relay mode
+     *
+     * Returns hooks.json content that calls the spooling hook script
+     * installed by RemoteHookChannel::installHookScriptCommand().
+     */
+    QString generateRelayHooksConfig() const;
+
     /**
      * Get the base directory for Konsolai session data
      */
@@ -195,6 +221,10 @@ private:
     void ensureDirectoryExists();
     bool startUnixSocket();
     bool startTcp();
+    bool startRelay();
+
+    /** Hooks config running @p command (given the event type) for every event type */
+    static QString buildHooksConfig(const std::function<QString(const QString &eventType)> &command);
 
     Mode m_mode = UnixSocket;
     QString m_sessionId;
@@ -208,6 +238,12 @@ private:
     // TCP mode
     QTcpServer *m_tcpServer = nullptr;
     QSet<QTcpSocket *> m_tcpClients;
+
+    // Relay mode
+    QString m_relayUser;
+    QString m_relayHost;
+    int m_relayPort = 22;
+    QPointer<RemoteHookChannel> m_channel;
 };
 
 /**
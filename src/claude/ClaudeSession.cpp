@@ -7,6 +7,15 @@
 #include "ClaudeHookHandler.h"
 #include "ClaudeSessionRegistry.h"
 #include "KonsolaiSettings.h"
+#include "OutputStream.h"
+#include "RateLimitCoordinator.h"
+#include "RemoteHookChannel.h"
+#include "ScreenPatternEngine.h"
+#include "TmuxControlClient.h"
+#include "TmuxInputQueue.h"
+#include "TranscriptTailer.h"
+
+#include "Emulation.h"
 
 #include <QDir>
 #include <QDirIterator>
@@ -92,9 +101,8 @@ ClaudeSession::~ClaudeSession()
     if (m_resourceTimer) {
         m_resourceTimer->stop();
     }
-    if (m_rateLimitRetryTimer) {
-        m_rateLimitRetryTimer->stop();
-    }
+    RateLimitCoordinator::instance()->cancel(m_rateLimitRetryTicket);
+    RateLimitCoordinator::instance()->cancel(m_suggestionTicket);
 
     // BudgetController and SessionObserver own timers — delete early to stop them
     delete m_budgetController;
@@ -128,6 +136,7 @@ void ClaudeSession::initializeNew(const QString &profileName, const QString &wor
 
     // Create managers
     m_tmuxManager = new TmuxManager(this);
+    m_inputQueue = new TmuxInputQueue(m_sessionName, TmuxInputQueue::runnerFor(m_tmuxManager), this);
     m_claudeProcess = new ClaudeProcess(this);
 
     // Create hook handler for receiving Claude hook events
@@ -198,6 +207,7 @@ void ClaudeSession::initializeReattach(const QString &existingSessionName)
 
     // Create managers
     m_tmuxManager = new TmuxManager(this);
+    m_inputQueue = new TmuxInputQueue(m_sessionName, TmuxInputQueue::runnerFor(m_tmuxManager), this);
     m_claudeProcess = new ClaudeProcess(this);
 
     // Create hook handler for receiving Claude hook events
@@ -264,6 +274,9 @@ void ClaudeSession::setSessionId(const QString &id)
 
     m_sessionId = id;
     m_sessionName = TmuxManager::buildSessionName(m_profileName, m_sessionId);
+    if (m_inputQueue) {
+        m_inputQueue->setTarget(m_sessionName);
+    }
 
     // Recreate hook handler with the new ID (so the socket name matches)
     if (m_hookHandler) {
@@ -410,13 +423,15 @@ void ClaudeSession::run()
     // Start the hook handler to receive Claude events
     if (m_hookHandler) {
         if (m_isRemote) {
-            // Remote sessions: use TCP mode with SSH reverse tunnel
-            m_hookHandler->setMode(ClaudeHookHandler::TCP);
+            // Remote sessions: events are spooled on the host and relayed over
+            // one channel shared by all sessions there
+            m_hookHandler->setMode(ClaudeHookHandler::Relay);
+            m_hookHandler->setRelayTarget(m_sshUsername, m_sshHost, m_sshPort > 0 ? m_sshPort : 22);
             if (m_hookHandler->start()) {
-                qDebug() << "ClaudeSession::run() - Hook handler started in TCP mode on port:" << m_hookHandler->tcpPort();
+                qDebug() << "ClaudeSession::run() - Hook handler relaying through:" << m_hookHandler->connectionString();
                 // Note: Remote hooks config is injected via SSH in buildRemoteSshArgs()
             } else {
-                qWarning() << "ClaudeSession::run() - Failed to start TCP hook handler for remote session";
+                qWarning() << "ClaudeSession::run() - Failed to start hook relay for remote session";
             }
         } else {
             // Local sessions: use Unix socket mode
@@ -526,6 +541,10 @@ void ClaudeSession::run()
         setArguments(sshArgs);
     } else {
         // Local sessions: use sh -c with the tmux command string
+        auto *settings = KonsolaiSettings::instance();
+        if (settings && settings->tmuxControlMode()) {
+            setupControlMode();
+        }
         QString tmuxCommand = shellCommand();
         qDebug() << "ClaudeSession::run() - tmux command:" << tmuxCommand;
         qDebug() << "  Working dir:" << m_workingDir;
@@ -618,6 +637,8 @@ void ClaudeSession::connectSignals()
                 m_suggestionTimer->stop();
                 qDebug() << "ClaudeSession: Cancelled suggestion timer (state changed)";
             }
+            RateLimitCoordinator::instance()->cancel(m_suggestionTicket);
+            m_suggestionTicket = 0;
             // Reset idle detection since hooks are delivering events
             m_idlePromptDetected = false;
             m_hookDeliveredIdle = false;
@@ -652,7 +673,7 @@ void ClaudeSession::connectSignals()
                 if (rlGuard->detectRateLimit(output)) {
                     rlGuard->scheduleRateLimitRetry();
                 } else {
-                    rlGuard->m_rateLimitRetryCount = 0;
+                    rlGuard->rateLimitCleared();
                 }
             });
         }
@@ -755,6 +776,14 @@ void ClaudeSession::connectSignals()
                     qDebug() << "ClaudeSession: Derived subagent transcript:" << info.transcriptPath;
                 }
 
+                if (!info.transcriptPath.isEmpty()) {
+                    if (!m_subagentTranscripts) {
+                        m_subagentTranscripts = std::make_unique<TranscriptTailer>();
+                    }
+                    m_subagentTranscripts->follow(agentId, info.transcriptPath);
+                    watchSubagentTranscripts();
+                }
+
                 m_subagents.insert(agentId, info);
                 qDebug() << "ClaudeSession: Subagent started -" << agentId << agentType << "total:" << m_subagents.size();
                 Q_EMIT subagentStarted(agentId);
@@ -770,6 +799,16 @@ void ClaudeSession::connectSignals()
                 m_subagents[agentId].transcriptPath = transcriptPath;
             }
         }
+        // Read what the agent wrote last, then let go of its transcript
+        const QString finalPath = m_subagents.contains(agentId) ? m_subagents[agentId].transcriptPath : transcriptPath;
+        if (!finalPath.isEmpty()) {
+            if (!m_subagentTranscripts) {
+                m_subagentTranscripts = std::make_unique<TranscriptTailer>();
+            }
+            m_subagentTranscripts->follow(agentId, finalPath);
+            m_subagentTranscripts->retire(agentId);
+            onTokenDirChanged();
+        }
         qDebug() << "ClaudeSession: Subagent stopped -" << agentId << "remaining active:" << (hasActiveTeam() ? "yes" : "no");
         Q_EMIT subagentStopped(agentId);
     });
@@ -784,6 +823,7 @@ void ClaudeSession::connectSignals()
                 it->teammateName = teammateName;
                 it->state = ClaudeProcess::State::Idle;
                 it->lastUpdated = QDateTime::currentDateTime();
+                assignTeam(*it, tName);
                 break;
             }
         }
@@ -802,6 +842,7 @@ void ClaudeSession::connectSignals()
                 for (auto it = m_subagents.begin(); it != m_subagents.end(); ++it) {
                     if (it->teammateName == teammateName) {
                         it->currentTaskSubject = taskSubject;
+                        assignTeam(*it, tName);
                         break;
                     }
                 }
@@ -962,6 +1003,13 @@ SessionObserver *ClaudeSession::sessionObserver()
                                                    m_tokenUsage.estimatedCostUSD());
         });
 
+        // Wire token rates, over the window the cost spiral check looks at
+        connect(budgetController(), &BudgetController::velocityUpdated, m_sessionObserver, [this]() {
+            const auto window = TokenVelocity::windowFor(m_sessionObserver->config().costSpiralWindowSeconds);
+            const TokenVelocity &velocity = m_budgetController->velocity();
+            m_sessionObserver->onTokenVelocityChanged(velocity.tokensPerMinute(window), velocity.costPerMinute(window));
+        });
+
         // Wire approval logging
         connect(this, &ClaudeSession::approvalLogged, m_sessionObserver, [this](const ApprovalLogEntry &entry) {
             m_sessionObserver->onApprovalLogged(entry.toolName, entry.yoloLevel, entry.timestamp);
@@ -979,7 +1027,7 @@ QString ClaudeSession::shellCommand() const
     // Remote sessions use buildRemoteSshArgs() directly in run()
     if (m_isReattach) {
         // Attach to existing session
-        return m_tmuxManager->buildAttachCommand(m_sessionName);
+        return m_tmuxManager->buildAttachCommand(m_sessionName, isControlMode());
     }
 
     // Create new session or attach if exists
@@ -994,10 +1042,78 @@ QString ClaudeSession::shellCommand() const
         m_sessionName,
         claudeCmd,
         true,  // attachExisting
-        m_workingDir
+        m_workingDir,
+        isControlMode()
     );
 }
 
+void ClaudeSession::setupControlMode()
+{
+    if (m_controlClient) {
+        return;
+    }
+
+    m_controlClient = new TmuxControlClient(
+        [this](const QByteArray &data) {
+            writeToPty(data);
+        },
+        this);
+
+    // The pane's output goes straight into our screen: no nested tmux
+    // client redraws it and no second scrollback holds a copy
+    connect(m_controlClient, &TmuxControlClient::paneOutput, this, [this](const QByteArray &data) {
+        if (m_outputStream) {
+            m_outputStream->append(data.constData(), data.size());
+        }
+        emulation()->receiveData(data.constData(), data.size());
+    });
+
+    // Keep the pane the size of the view
+    connect(emulation(), &Konsole::Emulation::imageSizeChanged, m_controlClient, [this](int lines, int columns) {
+        m_controlClient->setClientSize(columns, lines);
+    });
+    const QSize size = emulation()->imageSize();
+    m_controlClient->setClientSize(size.width(), size.height());
+
+    qDebug() << "ClaudeSession: using tmux control mode for" << m_sessionName;
+}
+
+void ClaudeSession::receivePtyData(const char *buf, int len)
+{
+    if (m_controlClient) {
+        m_controlClient->feed(buf, len);
+        return;
+    }
+    if (m_outputStream) {
+        m_outputStream->append(buf, len);
+    }
+    Session::receivePtyData(buf, len);
+}
+
+bool ClaudeSession::canParseOnWorkerThread() const
+{
+    return !m_controlClient && !m_outputStream && Session::canParseOnWorkerThread();
+}
+
+void ClaudeSession::setOutputStreaming(bool enabled)
+{
+    if (enabled && !m_outputStream) {
+        m_outputStream = std::make_unique<OutputStream>(OutputStream::DefaultCapacity, m_outputStreamEnd);
+    } else if (!enabled && m_outputStream) {
+        m_outputStreamEnd = m_outputStream->cursor();
+        m_outputStream.reset();
+    }
+}
+
+void ClaudeSession::sendEmulationData(const QByteArray &data)
+{
+    if (m_controlClient) {
+        m_controlClient->sendInput(data);
+        return;
+    }
+    Session::sendEmulationData(data);
+}
+
 QStringList ClaudeSession::buildRemoteSshArgs() const
 {
     // Build argv list for ssh: [-t] [-R port:localhost:port] [-p port] user@host <remote-cmd>
@@ -1066,6 +1182,31 @@ QStringList ClaudeSession::buildRemoteSshArgs() const
     if (!m_existingRemoteTmuxSession.isEmpty()) {
         remoteCmd = QStringLiteral("%1tmux attach-session -t %2")
                         .arg(profileSetup, m_existingRemoteTmuxSession);
+    } else if (m_hookHandler && m_hookHandler->mode() == ClaudeHookHandler::Relay) {
+        // Install the spooling hook script shared by the sessions on this host
+        // and point this session's hooks at it; the events travel back over the
+        // host's RemoteHookChannel, so no tunnel is needed
+        QString hooksConfig = m_hookHandler->generateRelayHooksConfig();
+        QString escapedConfig = hooksConfig;
+        escapedConfig.replace(QStringLiteral("'"), QStringLiteral("'\\''"));
+
+        remoteCmd = QStringLiteral(
+                        "%1 && "
+                        "%6"
+                        "mkdir -p '%2/.claude' && "
+                        "python3 -c \""
+                        "import json,sys,os; "
+                        "p='%2/.claude/settings.local.json'; "
+                        "e={}; "
+                        "r=open(p) if os.path.exists(p) else None; "
+                        "e=json.load(r) if r else {}; "
+                        "r and r.close(); "
+                        "n=json.loads(sys.argv[1]); "
+                        "e['hooks']=n.get('hooks',{}); "
+                        "f=open(p,'w'); json.dump(e,f,indent=2); f.close()"
+                        "\" '%3' && "
+                        "tmux new-session -A -s %4 -c %2 -- %5 \\; set-option -p allow-passthrough off")
+                        .arg(RemoteHookChannel::installHookScriptCommand(), remoteWorkDir, escapedConfig, m_sessionName, claudeCmd, profileSetup);
     } else if (tunnelPort > 0 && m_hookHandler) {
         // Generate the hook script and config
         QString hookScript = m_hookHandler->generateRemoteHookScript(tunnelPort);
@@ -1142,8 +1283,8 @@ void ClaudeSession::kill()
 
 void ClaudeSession::sendText(const QString &text)
 {
-    if (m_tmuxManager) {
-        m_tmuxManager->sendKeysAsync(m_sessionName, text);
+    if (m_inputQueue) {
+        m_inputQueue->sendText(text);
     }
 }
 
@@ -1190,30 +1331,42 @@ void ClaudeSession::sendPrompt(const QString &prompt)
 {
     // Send text and Enter separately. Claude Code's Ink UI interprets a
     // literal \r inside a -l send-keys as a newline within the text field,
-    // not as form submission. Sending Enter via sendKeySequence (without -l)
-    // correctly triggers the submit action.
-    if (m_tmuxManager) {
-        // Capture prompt prefix as the label for the current prompt round
-        if (!prompt.trimmed().isEmpty()) {
-            const QString prefix = prompt.trimmed().left(80);
-            m_promptGroupLabels[m_currentPromptRound] = prefix;
-        }
+    // not as form submission. The input queue pastes the prompt (bracketed)
+    // and presses Enter only after the paste has been delivered.
+    if (m_inputQueue) {
+        recordPromptLabel(prompt);
+        m_inputQueue->sendPrompt(prompt);
+    }
+}
 
-        m_tmuxManager->sendKeysAsync(m_sessionName, prompt);
-        QTimer::singleShot(150, this, [this]() {
-            if (m_tmuxManager) {
-                m_tmuxManager->sendKeySequenceAsync(m_sessionName, QStringLiteral("Enter"));
-            }
-        });
+void ClaudeSession::recordPromptLabel(const QString &prompt)
+{
+    // Capture prompt prefix as the label for the current prompt round
+    if (!prompt.trimmed().isEmpty()) {
+        const QString prefix = prompt.trimmed().left(80);
+        m_promptGroupLabels[m_currentPromptRound] = prefix;
     }
 }
 
+void ClaudeSession::broadcastPrompt(const QList<ClaudeSession *> &sessions, const QString &prompt)
+{
+    QList<TmuxInputQueue *> queues;
+    for (ClaudeSession *session : sessions) {
+        if (!session || !session->m_inputQueue) {
+            continue;
+        }
+        session->recordPromptLabel(prompt);
+        queues.append(session->m_inputQueue);
+    }
+    TmuxInputQueue::broadcastPrompt(queues, prompt);
+}
+
 void ClaudeSession::approvePermission()
 {
     // Claude Code uses a selection UI where option 1 (Yes) is pre-selected
     // Just send Enter to confirm the selection
-    if (m_tmuxManager) {
-        m_tmuxManager->sendKeysAsync(m_sessionName, QStringLiteral("\n"));
+    if (m_inputQueue) {
+        m_inputQueue->sendText(QStringLiteral("\n"));
     }
 }
 
@@ -1227,7 +1380,7 @@ void ClaudeSession::approvePermissionAlways()
     // "Always allow" option is, then navigate precisely.
     QPointer<ClaudeSession> guard(this);
     m_tmuxManager->capturePaneAsync(m_sessionName, [this, guard](bool ok, const QString &output) {
-        if (!guard || !ok || !m_tmuxManager) {
+        if (!guard || !ok || !m_inputQueue) {
             return;
         }
 
@@ -1265,24 +1418,20 @@ void ClaudeSession::approvePermissionAlways()
             QString key = delta > 0 ? QStringLiteral("Down") : QStringLiteral("Up");
             int steps = qAbs(delta);
             for (int i = 0; i < steps; ++i) {
-                m_tmuxManager->sendKeySequenceAsync(m_sessionName, key);
+                m_inputQueue->sendKey(key);
             }
         }
 
-        // Confirm selection
-        QTimer::singleShot(50, this, [this]() {
-            if (m_tmuxManager) {
-                m_tmuxManager->sendKeysAsync(m_sessionName, QStringLiteral("\n"));
-            }
-        });
+        // Confirm selection; queued behind the navigation keys
+        m_inputQueue->sendText(QStringLiteral("\n"));
     });
 }
 
 void ClaudeSession::denyPermission()
 {
     // Send 'n' followed by Enter to deny
-    if (m_tmuxManager) {
-        m_tmuxManager->sendKeysAsync(m_sessionName, QStringLiteral("n\n"));
+    if (m_inputQueue) {
+        m_inputQueue->sendText(QStringLiteral("n\n"));
     }
 }
 
@@ -1290,8 +1439,8 @@ void ClaudeSession::stop()
 {
     // Send Ctrl+C to stop Claude (use sendKeySequence, not sendKeys,
     // because sendKeys uses -l which would type literal "C-c")
-    if (m_tmuxManager) {
-        m_tmuxManager->sendKeySequenceAsync(m_sessionName, QStringLiteral("C-c"));
+    if (m_inputQueue) {
+        m_inputQueue->sendKey(QStringLiteral("C-c"));
     }
 }
 
@@ -1374,6 +1523,16 @@ QString ClaudeSession::getTranscript(int lines)
     return transcript(lines);
 }
 
+double ClaudeSession::tokensPerMinute(int windowSeconds)
+{
+    return budgetController()->velocity().tokensPerMinute(TokenVelocity::windowFor(windowSeconds));
+}
+
+double ClaudeSession::costPerMinute(int windowSeconds)
+{
+    return budgetController()->velocity().costPerMinute(TokenVelocity::windowFor(windowSeconds));
+}
+
 void ClaudeSession::setYoloMode(bool enabled)
 {
     bool changed = (m_yoloMode != enabled);
@@ -1426,6 +1585,10 @@ void ClaudeSession::setYoloMode(bool enabled)
 
 void ClaudeSession::startPermissionPolling()
 {
+    if (m_pollingDeferred) {
+        return;
+    }
+
     if (!m_permissionPollTimer) {
         m_permissionPollTimer = new QTimer(this);
         connect(m_permissionPollTimer, &QTimer::timeout, this, &ClaudeSession::pollForPermissionPrompt);
@@ -1494,20 +1657,8 @@ void ClaudeSession::pollForPermissionPrompt()
             return;
         }
 
-        // Extract last 5 lines from the full capture without splitting entire string.
-        // Walk backwards from end to find the 5th-from-last newline.
-        const int bottomCount = 5;
-        int pos = output.size();
-        for (int i = 0; i < bottomCount && pos > 0; ++i) {
-            pos = output.lastIndexOf(QLatin1Char('\n'), pos - 1);
-            if (pos < 0) {
-                pos = 0;
-                break;
-            }
-        }
-        const QString bottomLines = (pos > 0) ? output.mid(pos + 1) : output;
-
-        if (detectPermissionPrompt(bottomLines)) {
+        // The engine only looks at the bottom lines, where the permission UI appears
+        if (ScreenPatternEngine::instance()->matches(output, ScreenPatternEngine::PermissionPrompt)) {
             if (!m_permissionPromptDetected) {
                 // Check shared approval cooldown to prevent double-approve with hook path
                 if (m_lastApprovalTime.isValid() && m_lastApprovalTime.elapsed() < 2000) {
@@ -1538,59 +1689,21 @@ void ClaudeSession::pollForPermissionPrompt()
 
 bool ClaudeSession::detectPermissionPrompt(const QString &terminalOutput)
 {
-    // Match the Claude Code interactive permission selection UI that appears
-    // at the bottom of the terminal.  We check individual LINES so that the
-    // selector arrow (❯) must be on the SAME line as the approval keyword —
-    // not just somewhere in the same 5-line window.
-    //
-    // Claude Code formats vary across versions:
-    //   ❯ Yes                        (compact form)
-    //   ❯ Yes, allow once            (verbose form)
-    //   ❯ Allow once                 (alternate wording)
-    //   ❯ Always allow               (second option, when pre-selected differently)
-    //
-    // Critical: Claude Code's INPUT prompt also uses ❯ as a marker:
-    //   ─────────────  (border, all U+2500)
-    //   ❯ user typing here
-    //   ─────────────  (border, all U+2500)
-    // If the user types "yes"/"allow", we must NOT match that as a permission
-    // prompt.  Distinguishing feature: the input prompt's ❯ line is sandwiched
-    // between full-width horizontal-rule borders (lines that are almost
-    // entirely U+2500).  Permission UI uses boxed corners (╭╮╰╯) or plain
-    // text — never pure U+2500-only lines adjacent to ❯.
-
-    auto isInputBoxBorder = [](const QString &line) {
-        const QString trimmed = line.trimmed();
-        if (trimmed.size() < 20) {
-            return false;
-        }
-        int dashCount = trimmed.count(QChar(0x2500));
-        return dashCount > trimmed.size() * 9 / 10;
-    };
-
-    const auto lines = terminalOutput.split(QLatin1Char('\n'));
-    for (int i = 0; i < lines.size(); ++i) {
-        const QString &line = lines[i];
-        if (!line.contains(QStringLiteral("❯"))) {
-            continue;
-        }
-        if (!line.contains(QStringLiteral("Yes"), Qt::CaseInsensitive) && !line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive)) {
-            continue;
-        }
-        // Skip if this is the input prompt (sandwiched between border lines).
-        bool prevIsBorder = (i > 0) && isInputBoxBorder(lines[i - 1]);
-        bool nextIsBorder = (i + 1 < lines.size()) && isInputBoxBorder(lines[i + 1]);
-        if (prevIsBorder || nextIsBorder) {
-            continue;
-        }
-        return true;
-    }
-
-    return false;
+    // Claude Code's permission selection UI at the bottom of the terminal:
+    // the selector arrow (❯) on the same line as an approval option such as
+    // "Yes", "Yes, allow once" or "Always allow".  The input field also
+    // marks its line with ❯, but sits between full-width horizontal rules,
+    // so what the user types there is not taken for a prompt.  The patterns
+    // live in the screen pattern rules, see ScreenPatternEngine.
+    return ScreenPatternEngine::instance()->matches(terminalOutput, ScreenPatternEngine::PermissionPrompt);
 }
 
 void ClaudeSession::startIdlePolling()
 {
+    if (m_pollingDeferred) {
+        return;
+    }
+
     if (!m_idlePollTimer) {
         m_idlePollTimer = new QTimer(this);
         connect(m_idlePollTimer, &QTimer::timeout, this, &ClaudeSession::pollForIdlePrompt);
@@ -1672,21 +1785,14 @@ void ClaudeSession::pollForIdlePrompt()
             return;
         }
 
-        // Extract last 3 lines from the full capture without splitting entire string.
-        const int bottomCount = 3;
-        int pos = output.size();
-        for (int i = 0; i < bottomCount && pos > 0; ++i) {
-            pos = output.lastIndexOf(QLatin1Char('\n'), pos - 1);
-            if (pos < 0) {
-                pos = 0;
-                break;
-            }
-        }
-        const QString bottomLines = (pos > 0) ? output.mid(pos + 1) : output;
+        // One pass over the bottom of the screen for both the idle prompt
+        // and rate limit errors
+        const auto found = ScreenPatternEngine::instance()->scan(output);
+        const bool idle = found.testFlag(ScreenPatternEngine::IdlePrompt);
 
         // Check for rate limit BEFORE idle prompt — if Claude hit a rate limit
         // and is now idle, auto-retry with exponential backoff.
-        if (detectIdlePrompt(bottomLines) && detectRateLimit(output)) {
+        if (idle && found.testFlag(ScreenPatternEngine::RateLimit)) {
             if (!m_idlePromptDetected) {
                 m_idlePromptDetected = true;
                 scheduleRateLimitRetry();
@@ -1694,9 +1800,9 @@ void ClaudeSession::pollForIdlePrompt()
                     m_idlePromptDetected = false;
                 });
             }
-        } else if (detectIdlePrompt(bottomLines)) {
+        } else if (idle) {
             // Reset rate limit retry count on successful idle (no rate limit)
-            m_rateLimitRetryCount = 0;
+            rateLimitCleared();
 
             if (!m_idlePromptDetected) {
                 m_idlePromptDetected = true;
@@ -1724,64 +1830,17 @@ void ClaudeSession::pollForIdlePrompt()
 
 bool ClaudeSession::detectIdlePrompt(const QString &terminalOutput)
 {
-    // Claude Code's Ink UI shows a prompt like ">" or "❯" on the last line
-    // when idle and waiting for user input.  We look for this WITHOUT any
-    // permission prompt or selection UI present.
-    //
-    // Single-pass: scan lines using QStringView to avoid allocations.
-    const auto lines = QStringView(terminalOutput).split(QLatin1Char('\n'));
-
-    QStringView lastNonEmpty;
-    for (const auto &line : lines) {
-        // Skip if this looks like a permission prompt
-        if (line.contains(QStringLiteral("❯"))
-            && (line.contains(QStringLiteral("Yes"), Qt::CaseInsensitive) || line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive))) {
-            return false;
-        }
-        if (line.contains(QStringLiteral("Allow"), Qt::CaseInsensitive) || line.contains(QStringLiteral("Deny"), Qt::CaseInsensitive)) {
-            return false;
-        }
-        // Track last non-empty line as we go (avoids second pass)
-        auto trimmed = line.trimmed();
-        if (!trimmed.isEmpty()) {
-            lastNonEmpty = trimmed;
-        }
-    }
-
-    // Check last non-empty line for the Claude Code input prompt indicator.
-    // After trimming, the idle prompt is ">" or "project-name >" (project-prefixed).
-    // Match: bare ">", or lines ending with " >" (space before >).
-    // Reject: HTML like "</div>", git branches "main>develop", markdown "> quote".
-    if (!lastNonEmpty.isEmpty()) {
-        if (lastNonEmpty == QStringLiteral(">") || lastNonEmpty.endsWith(QStringLiteral(" >"))) {
-            return true;
-        }
-    }
-
-    return false;
+    // Claude Code's Ink UI shows ">" or "project-name >" on the last line
+    // when idle and waiting for user input, without any permission prompt
+    // or selection UI on screen.
+    return ScreenPatternEngine::instance()->matches(terminalOutput, ScreenPatternEngine::IdlePrompt);
 }
 
 bool ClaudeSession::detectRateLimit(const QString &terminalOutput)
 {
-    // Claude Code shows rate limit errors in the terminal when the API returns
-    // 429 (rate limit) or 529 (overloaded). Common patterns:
-    //   "rate limit" / "Rate limit"
-    //   "overloaded" / "Overloaded"
-    //   "too many requests" / "Too many requests"
-    //   "429" / "529" (HTTP status codes in error messages)
-    //   "retry" in context of errors
-    // Check the last 10 lines for these patterns.
-    const auto lines = terminalOutput.split(QLatin1Char('\n'));
-    int start = qMax(0, lines.size() - 10);
-    for (int i = start; i < lines.size(); ++i) {
-        const QString &line = lines[i];
-        if (line.contains(QStringLiteral("rate limit"), Qt::CaseInsensitive) || line.contains(QStringLiteral("rate_limit"), Qt::CaseInsensitive)
-            || line.contains(QStringLiteral("overloaded"), Qt::CaseInsensitive) || line.contains(QStringLiteral("too many requests"), Qt::CaseInsensitive)
-            || line.contains(QStringLiteral("529")) || line.contains(QStringLiteral("429"))) {
-            return true;
-        }
-    }
-    return false;
+    // Rate limit (429) and overload (529) errors of the API near the bottom
+    // of the terminal
+    return ScreenPatternEngine::instance()->matches(terminalOutput, ScreenPatternEngine::RateLimit);
 }
 
 void ClaudeSession::scheduleRateLimitRetry()
@@ -1791,27 +1850,45 @@ void ClaudeSession::scheduleRateLimitRetry()
         m_rateLimitRetryCount = 0;
         return;
     }
-
-    // Exponential backoff: 2s, 4s, 8s, 16s, 32s, 64s, 128s, 256s
-    int delaySecs = 2 << m_rateLimitRetryCount;
     m_rateLimitRetryCount++;
 
+    // The backoff is shared with every session of the same account and
+    // model: 2s, 4s, 8s... up to 256s, and the retries of all of them are
+    // paced and spread once it has run out
+    auto *coordinator = RateLimitCoordinator::instance();
+    const QString key = rateLimitKey();
+    coordinator->reportRateLimit(key, m_sessionName);
+    const int delaySecs = int((coordinator->backoffRemaining(key) + 999) / 1000);
+
     qDebug() << "ClaudeSession: Rate limit detected, retry" << m_rateLimitRetryCount << "in" << delaySecs << "seconds";
 
     Q_EMIT rateLimitDetected(m_rateLimitRetryCount, delaySecs);
 
-    if (!m_rateLimitRetryTimer) {
-        m_rateLimitRetryTimer = new QTimer(this);
-        m_rateLimitRetryTimer->setSingleShot(true);
-        connect(m_rateLimitRetryTimer, &QTimer::timeout, this, [this]() {
-            if (!m_tmuxManager) {
-                return;
-            }
-            qDebug() << "ClaudeSession: Rate limit retry - sending 'continue'";
-            sendPrompt(QStringLiteral("continue"));
-        });
+    // A single retry pending per session
+    coordinator->cancel(m_rateLimitRetryTicket);
+    m_rateLimitRetryTicket = coordinator->admit(key, this, [this]() {
+        m_rateLimitRetryTicket = 0;
+        if (!m_tmuxManager) {
+            return;
+        }
+        qDebug() << "ClaudeSession: Rate limit retry - sending 'continue'";
+        sendPrompt(QStringLiteral("continue"));
+    });
+}
+
+void ClaudeSession::rateLimitCleared()
+{
+    // Only a session which was retrying knows its request went through now
+    if (m_rateLimitRetryCount > 0) {
+        RateLimitCoordinator::instance()->reportSuccess(rateLimitKey());
     }
-    m_rateLimitRetryTimer->start(delaySecs * 1000);
+    m_rateLimitRetryCount = 0;
+}
+
+QString ClaudeSession::rateLimitKey() const
+{
+    const QString account = m_isRemote ? m_sshUsername + QLatin1Char('@') + m_sshHost : QStringLiteral("local");
+    return RateLimitCoordinator::keyFor(account, ClaudeProcess::modelName(m_claudeModel));
 }
 
 void ClaudeSession::startTokenTracking()
@@ -1828,9 +1905,13 @@ void ClaudeSession::startTokenTracking()
         m_tokenFileWatcher = new QFileSystemWatcher(this);
         m_tokenWatcherDebounce = new QTimer(this);
         m_tokenWatcherDebounce->setSingleShot(true);
-        m_tokenWatcherDebounce->setInterval(500); // debounce rapid-fire during streaming
+        m_tokenWatcherDebounce->setInterval(250); // coalesce rapid-fire during streaming
         connect(m_tokenWatcherDebounce, &QTimer::timeout, this, &ClaudeSession::refreshTokenUsage);
         connect(m_tokenFileWatcher, &QFileSystemWatcher::directoryChanged, this, &ClaudeSession::onTokenDirChanged);
+        connect(m_tokenFileWatcher, &QFileSystemWatcher::fileChanged, this, &ClaudeSession::onTokenDirChanged);
+        if (!m_lastTokenFile.isEmpty()) {
+            m_tokenFileWatcher->addPath(m_lastTokenFile);
+        }
     }
 
     // Watch the project dir if we have a working directory
@@ -1854,14 +1935,30 @@ void ClaudeSession::startTokenTracking()
 
 void ClaudeSession::onTokenDirChanged()
 {
-    // Debounce: during streaming, the JSONL file is updated rapidly.
-    // Restart the 500ms timer so we only refresh once after writes settle.
-    if (m_tokenWatcherDebounce) {
+    // Coalesce: during streaming, the JSONL file is updated rapidly.
+    // Don't restart a pending refresh, or steady writes would hold it off
+    // (and the budget checks with it) until they settle.
+    if (m_tokenWatcherDebounce && !m_tokenWatcherDebounce->isActive()) {
         m_tokenWatcherDebounce->start();
     }
 }
 
 void ClaudeSession::refreshTokenUsage()
+{
+    const quint64 previousTotal = m_tokenUsage.totalTokens();
+    refreshConversationTokens();
+    pollSubagentTranscripts();
+
+    TokenUsage usage = m_conversationTokenUsage;
+    usage.add(m_subagentTokenUsage);
+    const bool changed = usage.totalTokens() != previousTotal;
+    m_tokenUsage = usage;
+    if (changed) {
+        Q_EMIT tokenUsageChanged();
+    }
+}
+
+void ClaudeSession::refreshConversationTokens()
 {
     if (m_workingDir.isEmpty()) {
         return;
@@ -1894,99 +1991,149 @@ void ClaudeSession::refreshTokenUsage()
         return;
     }
 
+    // The first transcript found may be a resumed conversation: its
+    // history counts, but isn't spent right now
+    const bool catchingUp = m_lastTokenFile.isEmpty();
+
     // If the file changed, reset incremental state
     if (newestFile != m_lastTokenFile) {
+        // Watch the transcript itself, appends don't touch the directory
+        if (m_tokenFileWatcher) {
+            if (!m_lastTokenFile.isEmpty()) {
+                m_tokenFileWatcher->removePath(m_lastTokenFile);
+            }
+            m_tokenFileWatcher->addPath(newestFile);
+        }
         m_lastTokenFile = newestFile;
         m_lastTokenFilePos = 0;
-        m_tokenUsage = TokenUsage();
+        m_conversationTokenUsage = TokenUsage();
+        // The running total the records are checked against starts over too
+        m_tokenUsage = m_subagentTokenUsage;
     }
 
-    TokenUsage usage = parseConversationTokens(newestFile);
-    if (usage.totalTokens() != m_tokenUsage.totalTokens()) {
-        m_tokenUsage = usage;
-        Q_EMIT tokenUsageChanged();
-    }
+    m_conversationTokenUsage = parseConversationTokens(newestFile, catchingUp);
 }
 
-TokenUsage ClaudeSession::parseConversationTokens(const QString &jsonlPath)
+TokenUsage ClaudeSession::parseConversationTokens(const QString &jsonlPath, bool catchingUp)
 {
     // Incremental parsing: start from where we left off last time.
-    // m_tokenUsage holds the accumulated total; we add new lines to it.
-    TokenUsage usage = m_tokenUsage;
+    // m_conversationTokenUsage holds the accumulated total; we add new lines to it.
+    TokenUsage usage = m_conversationTokenUsage;
 
-    QFile file(jsonlPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return usage;
+    TranscriptTailer::RecordCallback onRecord;
+    if (!catchingUp) {
+        onRecord = [this](const TokenUsage &record) {
+            recordTokenUsage(record);
+        };
     }
-
-    // Seek to last known position to avoid re-parsing the entire file
-    if (m_lastTokenFilePos > 0 && m_lastTokenFilePos <= file.size()) {
-        file.seek(m_lastTokenFilePos);
-    } else if (m_lastTokenFilePos > file.size()) {
+    qint64 pos = TranscriptTailer::readLines(jsonlPath, m_lastTokenFilePos, usage, onRecord);
+    if (pos < 0) {
         // File was truncated/replaced — re-parse from scratch
-        m_lastTokenFilePos = 0;
         usage = TokenUsage();
+        pos = TranscriptTailer::readLines(jsonlPath, 0, usage);
     }
 
-    auto safeU64 = [](qint64 v) -> quint64 {
-        return v > 0 ? static_cast<quint64>(v) : 0;
-    };
-
-    while (!file.atEnd()) {
-        QByteArray line = file.readLine().trimmed();
-        if (line.isEmpty()) {
-            continue;
-        }
+    // Save position for next incremental parse
+    if (pos >= 0) {
+        m_lastTokenFilePos = pos;
+    }
 
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
-        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
-            continue;
-        }
+    return usage;
+}
 
-        QJsonObject obj = doc.object();
-        if (obj.value(QStringLiteral("type")).toString() != QStringLiteral("assistant")) {
-            continue;
-        }
+void ClaudeSession::pollSubagentTranscripts()
+{
+    if (!m_subagentTranscripts || m_subagentTranscripts->count() == 0) {
+        return;
+    }
 
-        // Token data is in message.usage
-        QJsonObject message = obj.value(QStringLiteral("message")).toObject();
-        QJsonObject usageObj = message.value(QStringLiteral("usage")).toObject();
+    const QHash<QString, TokenUsage> added = m_subagentTranscripts->poll([this](const QString &, const TokenUsage &record) {
+        recordTokenUsage(record);
+    });
+    for (auto it = added.cbegin(); it != added.cend(); ++it) {
+        const TokenUsage &delta = it.value();
+        m_subagentTokenUsage.add(delta);
 
-        if (usageObj.isEmpty()) {
+        auto agent = m_subagents.find(it.key());
+        if (agent == m_subagents.end()) {
             continue;
         }
+        agent->tokenUsage.add(delta);
+        agent->tokenUsage.lastContextTokens = delta.lastContextTokens;
+        if (!delta.detectedModel.isEmpty()) {
+            agent->tokenUsage.detectedModel = delta.detectedModel;
+        }
+        // plain Task subagents are not part of a team
+        if (!agent->teamName.isEmpty()) {
+            m_teamTokenUsage[agent->teamName].add(delta);
+        }
+    }
 
-        quint64 inp = safeU64(usageObj.value(QStringLiteral("input_tokens")).toInteger());
-        quint64 out = safeU64(usageObj.value(QStringLiteral("output_tokens")).toInteger());
-        quint64 cr = safeU64(usageObj.value(QStringLiteral("cache_read_input_tokens")).toInteger());
-        quint64 cc = safeU64(usageObj.value(QStringLiteral("cache_creation_input_tokens")).toInteger());
+    watchSubagentTranscripts();
+    if (!added.isEmpty()) {
+        Q_EMIT teamInfoChanged();
+    }
+}
 
-        usage.inputTokens += inp;
-        usage.outputTokens += out;
-        usage.cacheReadTokens += cr;
-        usage.cacheCreationTokens += cc;
+void ClaudeSession::recordTokenUsage(const TokenUsage &record)
+{
+    // Limits are checked per record; one refresh can read several turns
+    m_tokenUsage.add(record);
+    budgetController()->onUsageRecord(record, m_tokenUsage);
+}
 
-        // Track the last message's context window usage (not cumulative — this is
-        // how many tokens were in the prompt sent to the API for this turn)
-        usage.lastContextTokens = inp + cr + cc;
+void ClaudeSession::assignTeam(SubagentInfo &info, const QString &teamName)
+{
+    if (teamName.isEmpty() || !info.teamName.isEmpty()) {
+        return;
+    }
+    // Teammates are named after they started; bring along what they spent so far
+    info.teamName = teamName;
+    m_teamTokenUsage[teamName].add(info.tokenUsage);
+}
 
-        // Detect model from JSONL
-        QString model = message.value(QStringLiteral("model")).toString();
-        if (!model.isEmpty()) {
-            usage.detectedModel = model;
-        }
+void ClaudeSession::watchSubagentTranscripts()
+{
+    if (!m_tokenFileWatcher) {
+        return;
     }
 
-    // Save position for next incremental parse
-    m_lastTokenFilePos = file.pos();
+    // Watch the transcripts for appends, or their directory until they exist
+    QStringList wanted;
+    const QStringList paths = m_subagentTranscripts ? m_subagentTranscripts->paths() : QStringList();
+    for (const QString &path : paths) {
+        if (QFile::exists(path)) {
+            wanted.append(path);
+        } else {
+            const QString dir = QFileInfo(path).absolutePath();
+            if (QDir(dir).exists() && !wanted.contains(dir)) {
+                wanted.append(dir);
+            }
+        }
+    }
 
-    return usage;
+    const QStringList files = m_tokenFileWatcher->files();
+    for (const QString &file : files) {
+        if (file != m_lastTokenFile && !wanted.contains(file)) {
+            m_tokenFileWatcher->removePath(file);
+        }
+    }
+    const QStringList directories = m_tokenFileWatcher->directories();
+    for (const QString &dir : directories) {
+        if (dir != m_watchedProjectDir && !wanted.contains(dir)) {
+            m_tokenFileWatcher->removePath(dir);
+        }
+    }
+    for (const QString &path : std::as_const(wanted)) {
+        if (!files.contains(path) && !directories.contains(path)) {
+            m_tokenFileWatcher->addPath(path);
+        }
+    }
 }
 
 void ClaudeSession::autoAcceptSuggestion()
 {
-    if (!m_tmuxManager || !m_doubleYoloMode) {
+    if (!m_inputQueue || !m_doubleYoloMode) {
         return;
     }
 
@@ -2001,21 +2148,35 @@ void ClaudeSession::autoAcceptSuggestion()
         return;
     }
 
-    // Press Tab to accept any visible suggestion in Claude's input,
-    // then Enter to submit it.  If there is no suggestion, Tab is a
-    // no-op in Claude Code's Ink UI and Enter on an empty prompt is
-    // ignored, so this is safe to fire speculatively.
-    m_tmuxManager->sendKeySequenceAsync(m_sessionName, QStringLiteral("Tab"));
-    QTimer::singleShot(100, this, [this]() {
-        approvePermission(); // sends Enter (async)
-
-        // Defer approval counter: wait 1.5s then check if Claude left Idle.
-        // Only count it as a real approval if the suggestion was actually
-        // accepted (i.e., Claude started working on it).
-        QTimer::singleShot(1500, this, [this]() {
-            if (claudeState() != ClaudeProcess::State::Idle && claudeState() != ClaudeProcess::State::NotRunning) {
-                logApproval(QStringLiteral("suggestion"), QStringLiteral("auto-accepted"), 2);
+    // Submitting the suggestion sends a request, which waits while the
+    // account and model are rate limited
+    auto *coordinator = RateLimitCoordinator::instance();
+    coordinator->cancel(m_suggestionTicket);
+    m_suggestionTicket = coordinator->admit(rateLimitKey(), this, [this]() {
+        m_suggestionTicket = 0;
+        if (!m_inputQueue || !m_doubleYoloMode) {
+            return;
+        }
+
+        // Press Tab to accept any visible suggestion in Claude's input,
+        // then Enter to submit it.  If there is no suggestion, Tab is a
+        // no-op in Claude Code's Ink UI and Enter on an empty prompt is
+        // ignored, so this is safe to fire speculatively.
+        m_inputQueue->sendKey(QStringLiteral("Tab"));
+        QPointer<ClaudeSession> guard(this);
+        m_inputQueue->sendText(QStringLiteral("\n"), [this, guard](bool ok) {
+            if (!guard || !ok) {
+                return;
             }
+
+            // Defer approval counter: wait 1.5s then check if Claude left Idle.
+            // Only count it as a real approval if the suggestion was actually
+            // accepted (i.e., Claude started working on it).
+            QTimer::singleShot(1500, this, [this]() {
+                if (claudeState() != ClaudeProcess::State::Idle && claudeState() != ClaudeProcess::State::NotRunning) {
+                    logApproval(QStringLiteral("suggestion"), QStringLiteral("auto-accepted"), 2);
+                }
+            });
         });
     });
 }
@@ -2088,6 +2249,35 @@ void ClaudeSession::resumeDisplayTimers()
     }
 }
 
+void ClaudeSession::setPollingDeferred(bool deferred)
+{
+    if (m_pollingDeferred == deferred) {
+        return;
+    }
+    m_pollingDeferred = deferred;
+
+    if (deferred) {
+        if (m_permissionPollTimer) {
+            m_permissionPollTimer->stop();
+        }
+        if (m_idlePollTimer) {
+            m_idlePollTimer->stop();
+        }
+        return;
+    }
+
+    // Same conditions as after a team dissolves
+    if (hasActiveTeam()) {
+        return;
+    }
+    if (m_yoloMode) {
+        startPermissionPolling();
+    }
+    if (m_doubleYoloMode) {
+        startIdlePolling();
+    }
+}
+
 void ClaudeSession::startResourceTracking()
 {
 #ifndef Q_OS_LINUX
@@ -19,6 +19,7 @@
 #include <QDateTime>
 #include <QElapsedTimer>
 #include <QFileSystemWatcher>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QMap>
@@ -30,12 +31,19 @@
 #include <QUuid>
 #include <QVector>
 
+#include <memory>
+
 // Konsole includes
 #include "../session/Session.h"
 
 namespace Konsolai
 {
 
+class OutputStream;
+class TmuxControlClient;
+class TmuxInputQueue;
+class TranscriptTailer;
+
 /**
  * Per-session token usage counters
  */
@@ -54,6 +62,15 @@ struct KONSOLEPRIVATE_EXPORT TokenUsage {
         return inputTokens + outputTokens + cacheReadTokens + cacheCreationTokens;
     }
 
+    /** Adds the counters of @p other; context and model stay those of this usage. */
+    void add(const TokenUsage &other)
+    {
+        inputTokens += other.inputTokens;
+        outputTokens += other.outputTokens;
+        cacheReadTokens += other.cacheReadTokens;
+        cacheCreationTokens += other.cacheCreationTokens;
+    }
+
     double estimatedCostUSD() const
     {
         // Anthropic pricing per million tokens (Claude Opus 4.5)
@@ -148,7 +165,9 @@ struct KONSOLEPRIVATE_EXPORT SubagentInfo {
     QString transcriptPath; // from SubagentStop
     QString currentTaskSubject; // from TaskCompleted
     QString taskDescription; // from PreToolUse(Task) — short label for tree grouping
+    QString teamName; // from TeammateIdle/TaskCompleted, empty for plain Task subagents
     int promptGroupId = 0; // which prompt round spawned this agent
+    TokenUsage tokenUsage; // read from the agent's transcript
 
     QJsonObject toJson() const
     {
@@ -168,7 +187,19 @@ struct KONSOLEPRIVATE_EXPORT SubagentInfo {
             obj[QStringLiteral("currentTaskSubject")] = currentTaskSubject;
         if (!taskDescription.isEmpty())
             obj[QStringLiteral("taskDescription")] = taskDescription;
+        if (!teamName.isEmpty())
+            obj[QStringLiteral("teamName")] = teamName;
         obj[QStringLiteral("promptGroupId")] = promptGroupId;
+        if (tokenUsage.totalTokens() > 0) {
+            QJsonObject tokens;
+            tokens[QStringLiteral("input")] = static_cast<qint64>(tokenUsage.inputTokens);
+            tokens[QStringLiteral("output")] = static_cast<qint64>(tokenUsage.outputTokens);
+            tokens[QStringLiteral("cacheRead")] = static_cast<qint64>(tokenUsage.cacheReadTokens);
+            tokens[QStringLiteral("cacheCreation")] = static_cast<qint64>(tokenUsage.cacheCreationTokens);
+            if (!tokenUsage.detectedModel.isEmpty())
+                tokens[QStringLiteral("model")] = tokenUsage.detectedModel;
+            obj[QStringLiteral("tokens")] = tokens;
+        }
         return obj;
     }
 
@@ -184,7 +215,14 @@ struct KONSOLEPRIVATE_EXPORT SubagentInfo {
         info.transcriptPath = obj[QStringLiteral("transcriptPath")].toString();
         info.currentTaskSubject = obj[QStringLiteral("currentTaskSubject")].toString();
         info.taskDescription = obj[QStringLiteral("taskDescription")].toString();
+        info.teamName = obj[QStringLiteral("teamName")].toString();
         info.promptGroupId = obj[QStringLiteral("promptGroupId")].toInt(0);
+        const QJsonObject tokens = obj[QStringLiteral("tokens")].toObject();
+        info.tokenUsage.inputTokens = static_cast<quint64>(qMax<qint64>(0, tokens[QStringLiteral("input")].toInteger()));
+        info.tokenUsage.outputTokens = static_cast<quint64>(qMax<qint64>(0, tokens[QStringLiteral("output")].toInteger()));
+        info.tokenUsage.cacheReadTokens = static_cast<quint64>(qMax<qint64>(0, tokens[QStringLiteral("cacheRead")].toInteger()));
+        info.tokenUsage.cacheCreationTokens = static_cast<quint64>(qMax<qint64>(0, tokens[QStringLiteral("cacheCreation")].toInteger()));
+        info.tokenUsage.detectedModel = tokens[QStringLiteral("model")].toString();
         return info;
     }
 };
@@ -574,7 +612,7 @@ public:
         logApproval(QStringLiteral("unknown"), QStringLiteral("auto-accepted"), 2);
     }
     /**
-     * Get current token usage for this session
+     * Get current token usage for this session, including its subagents
      */
     const TokenUsage &tokenUsage() const
     {
@@ -582,7 +620,25 @@ public:
     }
 
     /**
-     * Refresh token usage by parsing Claude CLI conversation files
+     * Token usage of all subagents of this session so far, including those
+     * no longer listed in subagents()
+     */
+    const TokenUsage &subagentTokenUsage() const
+    {
+        return m_subagentTokenUsage;
+    }
+
+    /**
+     * Token usage of the subagents of each agent team, keyed by team name
+     */
+    const QHash<QString, TokenUsage> &teamTokenUsage() const
+    {
+        return m_teamTokenUsage;
+    }
+
+    /**
+     * Refresh token usage by parsing Claude CLI conversation files and
+     * the transcripts of running subagents
      */
     void refreshTokenUsage();
 
@@ -738,6 +794,28 @@ public:
      */
     void run() override;
 
+    /**
+     * Whether this session drives tmux through control mode, see
+     * KonsolaiSettings::tmuxControlMode().  Decided when the session starts.
+     */
+    bool isControlMode() const { return m_controlClient != nullptr; }
+
+    /**
+     * Keep the session's recent output in outputStream() for incremental
+     * readers such as ClaudeFleetService.  Off by default.  Turned on again,
+     * the stream continues at the cursor it stopped at.
+     */
+    void setOutputStreaming(bool enabled);
+
+    /** Recent output, or nullptr while streaming is off. */
+    const OutputStream *outputStream() const { return m_outputStream.get(); }
+
+    /**
+     * Sends @p prompt to all @p sessions, each after the input already
+     * queued on it.
+     */
+    static void broadcastPrompt(const QList<ClaudeSession *> &sessions, const QString &prompt);
+
     /**
      * Get the ClaudeProcess instance for state tracking
      */
@@ -821,6 +899,13 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE QString getTranscript(int lines = 1000);
 
+    /**
+     * Tokens and estimated cost spent per minute, decayed over the shortest
+     * window covering @p windowSeconds (15s, 1m or 5m)
+     */
+    Q_SCRIPTABLE double tokensPerMinute(int windowSeconds = 60);
+    Q_SCRIPTABLE double costPerMinute(int windowSeconds = 60);
+
     /**
      * Pause display-only timers (token refresh, resource usage).
      * Yolo-critical timers (permission poll, idle poll, suggestion) keep running.
@@ -832,6 +917,18 @@ public Q_SLOTS:
      */
     void resumeDisplayTimers();
 
+    /**
+     * Hold back the yolo permission and idle pollers.  Used for sessions
+     * restored as background tabs, so dozens of pollers running tmux
+     * capture-pane do not compete with the restore itself.  Yolo modes are
+     * still applied; their pollers start once polling is no longer deferred.
+     */
+    void setPollingDeferred(bool deferred);
+    bool isPollingDeferred() const
+    {
+        return m_pollingDeferred;
+    }
+
 Q_SIGNALS:
     /**
      * Emitted when Claude state changes
@@ -953,9 +1050,19 @@ Q_SIGNALS:
      */
     void subprocessChanged(const QString &id);
 
+protected:
+    // In control mode the pty carries the tmux protocol, not the pane itself
+    void receivePtyData(const char *buf, int len) override;
+    void sendEmulationData(const QByteArray &data) override;
+    // The control client and the output stream live on the GUI thread
+    bool canParseOnWorkerThread() const override;
+
 private:
     ClaudeSession(QObject *parent);  // Private constructor for reattach
 
+    void setupControlMode();
+    void recordPromptLabel(const QString &prompt);
+
     void initializeNew(const QString &profileName, const QString &workingDir);
     void initializeReattach(const QString &existingSessionName);
     void connectSignals();
@@ -977,6 +1084,11 @@ private:
     QString m_existingRemoteTmuxSession; // attach to existing remote tmux session
 
     TmuxManager *m_tmuxManager = nullptr;
+    TmuxControlClient *m_controlClient = nullptr;
+    TmuxInputQueue *m_inputQueue = nullptr;
+    std::unique_ptr<OutputStream> m_outputStream;
+    // Where the stream left off, so cursors keep growing across toggles
+    quint64 m_outputStreamEnd = 0;
     ClaudeProcess *m_claudeProcess = nullptr;
     ClaudeHookHandler *m_hookHandler = nullptr;
     BudgetController *m_budgetController = nullptr;
@@ -1019,7 +1131,18 @@ private:
     QString m_watchedProjectDir; // currently watched directory
     qint64 m_lastTokenFilePos = 0; // byte offset for incremental parsing
     void onTokenDirChanged();
-    TokenUsage parseConversationTokens(const QString &jsonlPath);
+    TokenUsage parseConversationTokens(const QString &jsonlPath, bool catchingUp = false);
+    void refreshConversationTokens();
+
+    // Subagent transcripts, followed from SubagentStart until SubagentStop
+    std::unique_ptr<TranscriptTailer> m_subagentTranscripts;
+    TokenUsage m_conversationTokenUsage; // the top-level conversation only
+    TokenUsage m_subagentTokenUsage;
+    QHash<QString, TokenUsage> m_teamTokenUsage;
+    void pollSubagentTranscripts();
+    void recordTokenUsage(const TokenUsage &record);
+    void watchSubagentTranscripts();
+    void assignTeam(SubagentInfo &info, const QString &teamName);
 
     // Resource usage tracking (CPU%, RSS via /proc)
     ResourceUsage m_resourceUsage;
@@ -1055,16 +1178,21 @@ private:
     bool m_idlePollInFlight = false; // true while async capturePane is running (legacy, kept for compat)
     bool m_anyCaptureInFlight = false; // shared flag: suppresses overlapping tmux captures from both pollers
     bool m_hookDeliveredIdle = false; // true when hook-based idle triggered yolo (suppresses polling)
+    bool m_pollingDeferred = false; // restored as background tab, see setPollingDeferred()
     void startIdlePolling();
     void stopIdlePolling();
     void pollForIdlePrompt();
 
-    // Rate limit detection and auto-retry with exponential backoff
-    QTimer *m_rateLimitRetryTimer = nullptr;
+    // Rate limit detection and auto-retry, paced by the RateLimitCoordinator
+    // shared with the other sessions of the same account and model
+    quint64 m_rateLimitRetryTicket = 0; // queued 'continue', see RateLimitCoordinator::admit()
+    quint64 m_suggestionTicket = 0; // queued suggestion acceptance
     int m_rateLimitRetryCount = 0;
     static constexpr int MAX_RATE_LIMIT_RETRIES = 8; // max ~4 min backoff
     bool detectRateLimit(const QString &terminalOutput);
     void scheduleRateLimitRetry();
+    void rateLimitCleared();
+    QString rateLimitKey() const;
 
     // Hook cleanup: remove konsolai hooks from project's .claude/settings.local.json
     void removeHooksFromProjectSettings();
@@ -5,6 +5,8 @@
 
 #include "ClaudeSessionRegistry.h"
 #include "ClaudeSession.h"
+#include "IdleTaskScheduler.h"
+#include "StartupTrace.h"
 
 #include <QDir>
 #include <QFile>
@@ -90,10 +92,16 @@ ClaudeSessionRegistry::ClaudeSessionRegistry(QObject *parent)
     }
 
     // Load persisted state
-    loadState();
+    {
+        Konsole::StartupTrace::Span span("ClaudeSessionRegistry::loadState");
+        loadState();
+    }
 
-    // Initial refresh of orphaned sessions (async to avoid blocking GUI)
-    refreshOrphanedSessionsAsync();
+    // Initial refresh of orphaned sessions (async, and only once the first
+    // terminal is interactive since it forks tmux)
+    IdleTaskScheduler::post(this, "ClaudeSessionRegistry::refreshOrphanedSessions", IdleTaskScheduler::Normal, [this]() {
+        refreshOrphanedSessionsAsync();
+    });
 
     // Setup periodic refresh
     connect(m_refreshTimer, &QTimer::timeout, this, &ClaudeSessionRegistry::onPeriodicRefresh);
@@ -7,7 +7,9 @@
 #include "ClaudeSessionWizard.h"
 #include "ClaudeConversationPicker.h"
 #include "ClaudeSessionRegistry.h"
+#include "GitJob.h"
 #include "KonsolaiSettings.h"
+#include "ProjectIndex.h"
 #include "TmuxManager.h"
 
 #include <QButtonGroup>
@@ -89,7 +91,9 @@ ClaudeSessionWizard::ClaudeSessionWizard(QWidget *parent)
         }
     }
 
-    // Populate folder completer from workspace root
+    // Populate folder completer from workspace root; the index may still
+    // be walking it and fills the completer in once done
+    connect(ProjectIndex::instance(), &ProjectIndex::updated, this, &ClaudeSessionWizard::updateFolderCompleter);
     updateFolderCompleter();
 
     // Load SSH config hosts
@@ -617,12 +621,12 @@ void ClaudeSessionWizard::setupUi()
     mainLayout->addStretch();
 
     // --- Buttons ---
-    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, this);
-    auto *createButton = buttons->addButton(i18n("Create Session"), QDialogButtonBox::AcceptRole);
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, this);
+    auto *createButton = m_buttons->addButton(i18n("Create Session"), QDialogButtonBox::AcceptRole);
     createButton->setDefault(true);
-    connect(buttons, &QDialogButtonBox::accepted, this, &ClaudeSessionWizard::onCreatePressed);
-    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
-    mainLayout->addWidget(buttons);
+    connect(m_buttons, &QDialogButtonBox::accepted, this, &ClaudeSessionWizard::onCreatePressed);
+    connect(m_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(m_buttons);
 
     // --- Tab order: prompt -> folder name -> git options -> model ---
     setTabOrder(m_promptEdit, m_folderNameEdit);
@@ -638,16 +642,14 @@ void ClaudeSessionWizard::setupUi()
 void ClaudeSessionWizard::updateFolderCompleter()
 {
     QString root = m_projectRootEdit->text();
-    if (root.isEmpty() || !QDir(root).exists()) {
+    if (root.isEmpty()) {
         return;
     }
 
-    QStringList dirs;
-    QDir rootDir(root);
-    const auto entries = rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
-    for (const QString &entry : entries) {
-        dirs << entry;
-    }
+    // Projects under the root, most used first, then the other folders in it
+    auto *index = ProjectIndex::instance();
+    index->addRoot(root);
+    const QStringList dirs = index->completions(root);
 
     auto *completer = m_folderNameEdit->completer();
     if (completer) {
@@ -805,30 +807,6 @@ void ClaudeSessionWizard::onCreatePressed()
         }
     }
 
-    // Init git if requested
-    if (gitMode == GitInit) {
-        QProcess git;
-        git.setWorkingDirectory(dir);
-        git.start(QStringLiteral("git"), {QStringLiteral("init")});
-        git.waitForFinished(5000);
-
-        if (git.exitCode() == 0) {
-            qDebug() << "ClaudeSessionWizard: Initialized git repo in:" << dir;
-
-            // Set up remote if configured
-            QString remoteRoot = m_gitRemoteEdit->text();
-            if (!remoteRoot.isEmpty()) {
-                QString repoName = QDir(dir).dirName();
-                QString remoteUrl = remoteRoot + repoName + QStringLiteral(".git");
-
-                QProcess gitRemote;
-                gitRemote.setWorkingDirectory(dir);
-                gitRemote.start(QStringLiteral("git"), {QStringLiteral("remote"), QStringLiteral("add"), QStringLiteral("origin"), remoteUrl});
-                gitRemote.waitForFinished(5000);
-            }
-        }
-    }
-
     // Save settings
     if (KonsolaiSettings *settings = KonsolaiSettings::instance()) {
         settings->setProjectRoot(m_projectRootEdit->text());
@@ -840,9 +818,50 @@ void ClaudeSessionWizard::onCreatePressed()
     }
 
     m_selectedDirectory = dir;
+
+    // Init git or create the worktree if requested, then accept
+    if (gitMode == GitInit) {
+        QString remoteUrl;
+        QString remoteRoot = m_gitRemoteEdit->text();
+        if (!remoteRoot.isEmpty()) {
+            remoteUrl = remoteRoot + QDir(dir).dirName() + QStringLiteral(".git");
+        }
+        runGitJob(GitJob::initRepository(dir, remoteUrl, this), false);
+        return;
+    }
+    if (!worktreeBranch().isEmpty()) {
+        runGitJob(GitJob::addWorktree(repoRoot(), dir, worktreeBranch(), this), true);
+        return;
+    }
     accept();
 }
 
+void ClaudeSessionWizard::runGitJob(GitJob *job, bool required)
+{
+    // The dialog stays responsive while git runs, but can't be submitted twice
+    m_buttons->setEnabled(false);
+    connect(job, &GitJob::progress, this, [this](int index, int count, const QString &description) {
+        m_previewLabel->setText(i18n("%1 (%2/%3)...", description, index + 1, count));
+    });
+    connect(job, &GitJob::finished, this, [this, job, required](bool ok, const QString &error) {
+        job->deleteLater();
+        m_buttons->setEnabled(true);
+        ProjectIndex::instance()->rescan();
+        if (!ok && required) {
+            updatePreview();
+            QMessageBox::warning(this,
+                                 i18n("Worktree Error"),
+                                 i18n("Failed to create git worktree. Check if the branch name is valid and the path doesn't already exist.\n\n%1", error));
+            return;
+        }
+        if (!ok) {
+            qWarning() << "ClaudeSessionWizard: git failed in" << m_selectedDirectory << error;
+        }
+        accept();
+    });
+    job->start();
+}
+
 QString ClaudeSessionWizard::generateFolderName(const QString &prompt) const
 {
     if (prompt.isEmpty()) {
@@ -922,6 +941,15 @@ void ClaudeSessionWizard::detectGitState(const QString &path)
         return;
     }
 
+    // Indexed projects are known without asking git
+    const IndexedProject project = ProjectIndex::instance()->projectAt(path);
+    if (!project.path.isEmpty()) {
+        m_isGitRepo = true;
+        m_repoRoot = project.path;
+        onGitStateDetected();
+        return;
+    }
+
     auto *git = new QProcess(this);
     git->setWorkingDirectory(path);
     connect(git, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, git](int exitCode, QProcess::ExitStatus) {
@@ -958,41 +986,10 @@ void ClaudeSessionWizard::onGitStateDetected()
 QStringList ClaudeSessionWizard::getWorktrees(const QString &repoRoot)
 {
     QStringList result;
-
-    QProcess git;
-    git.setWorkingDirectory(repoRoot);
-    git.start(QStringLiteral("git"), {QStringLiteral("worktree"), QStringLiteral("list"), QStringLiteral("--porcelain")});
-    git.waitForFinished(3000);
-
-    if (git.exitCode() != 0) {
-        return result;
+    const auto worktrees = ProjectIndex::instance()->worktreesOf(repoRoot);
+    for (const IndexedProject &worktree : worktrees) {
+        result << QStringLiteral("%1\t%2").arg(worktree.path, worktree.branch);
     }
-
-    QString output = QString::fromUtf8(git.readAllStandardOutput());
-    QStringList lines = output.split(QLatin1Char('\n'));
-
-    QString currentPath;
-    QString currentBranch;
-
-    for (const QString &line : lines) {
-        if (line.startsWith(QLatin1String("worktree "))) {
-            if (!currentPath.isEmpty()) {
-                result << QStringLiteral("%1\t%2").arg(currentPath, currentBranch);
-            }
-            currentPath = line.mid(9);
-            currentBranch.clear();
-        } else if (line.startsWith(QLatin1String("branch "))) {
-            currentBranch = line.mid(7);
-            if (currentBranch.startsWith(QLatin1String("refs/heads/"))) {
-                currentBranch = currentBranch.mid(11);
-            }
-        }
-    }
-
-    if (!currentPath.isEmpty()) {
-        result << QStringLiteral("%1\t%2").arg(currentPath, currentBranch);
-    }
-
     return result;
 }
 
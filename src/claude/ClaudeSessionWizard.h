@@ -15,6 +15,7 @@
 
 #include "profile/Profile.h"
 
+class QDialogButtonBox;
 class QLineEdit;
 class QPushButton;
 class QComboBox;
@@ -31,6 +32,7 @@ namespace Konsolai
 {
 
 struct ClaudeConversation;
+class GitJob;
 
 /**
  * Single-screen dialog for creating new Claude sessions.
@@ -126,6 +128,9 @@ private:
 
     void updateGitSubFields();
 
+    /** Runs @p job, then accepts; if @p required, a failure keeps the dialog open. */
+    void runGitJob(GitJob *job, bool required);
+
     // Widgets
     QButtonGroup *m_locationGroup = nullptr;
     QRadioButton *m_localRadio = nullptr;
@@ -162,6 +167,7 @@ private:
     QComboBox *m_modelCombo = nullptr;
     QCheckBox *m_autoApproveReadCheck = nullptr;
     QLabel *m_previewLabel = nullptr;
+    QDialogButtonBox *m_buttons = nullptr;
 
     // Resume session widgets
     QPushButton *m_resumeButton = nullptr;
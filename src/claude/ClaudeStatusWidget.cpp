@@ -51,6 +51,7 @@ void ClaudeStatusWidget::setSession(ClaudeSession *session)
     // Disconnect old session
     if (m_session) {
         disconnect(m_session, nullptr, this, nullptr);
+        disconnect(m_session->budgetController(), nullptr, this, nullptr);
     }
 
     m_session = session;
@@ -66,6 +67,7 @@ void ClaudeStatusWidget::setSession(ClaudeSession *session)
         connect(m_session, &ClaudeSession::approvalCountChanged, this, &ClaudeStatusWidget::updateDisplay);
         connect(m_session, &ClaudeSession::tokenUsageChanged, this, &ClaudeStatusWidget::updateDisplay);
         connect(m_session, &ClaudeSession::resourceUsageChanged, this, &ClaudeStatusWidget::updateDisplay);
+        connect(m_session->budgetController(), &BudgetController::velocityUpdated, this, &ClaudeStatusWidget::updateDisplay);
         connect(m_session, &QObject::destroyed,
                 this, &ClaudeStatusWidget::onSessionDestroyed);
 
@@ -88,6 +90,7 @@ void ClaudeStatusWidget::clearSession()
 {
     if (m_session) {
         disconnect(m_session, nullptr, this, nullptr);
+        disconnect(m_session->budgetController(), nullptr, this, nullptr);
         m_session = nullptr;
     }
 
@@ -207,6 +210,14 @@ void ClaudeStatusWidget::updateDisplay()
         statusText += QStringLiteral(" │ %1 ($%2)").arg(usage.formatCompact(), QString::number(usage.estimatedCostUSD(), 'f', 2));
     }
 
+    // Burn rate over the last minute, while tokens are being spent
+    if (session) {
+        const TokenVelocity &velocity = session->budgetController()->velocity();
+        if (velocity.isActive()) {
+            statusText += QStringLiteral(" │ %1").arg(velocity.formatVelocity());
+        }
+    }
+
     // Context window percent
     if (session) {
         double ctxPct = session->tokenUsage().contextPercent();
@@ -0,0 +1,159 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "GitJob.h"
+#include "KonsolaiLogging.h"
+
+namespace Konsolai
+{
+
+GitJob::GitJob(const QString &workingDirectory, QObject *parent)
+    : QObject(parent)
+    , m_workingDirectory(workingDirectory)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(DefaultStepTimeoutMs);
+    connect(&m_timeout, &QTimer::timeout, this, [this]() {
+        qCWarning(KonsolaiLog) << "GitJob: step" << m_current << "timed out";
+        cancel();
+    });
+}
+
+GitJob::~GitJob()
+{
+    if (m_process) {
+        m_process->disconnect(this);
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+void GitJob::addStep(const QString &description, const QStringList &args)
+{
+    addStep(description, [args]() {
+        return args;
+    });
+}
+
+void GitJob::addStep(const QString &description, Arguments args)
+{
+    Step step;
+    step.description = description;
+    step.args = std::move(args);
+    m_steps.append(step);
+}
+
+void GitJob::addCheck(const QString &description, const QStringList &args)
+{
+    addStep(description, args);
+    m_steps.last().check = true;
+}
+
+void GitJob::setStepTimeout(int ms)
+{
+    m_timeout.setInterval(ms);
+}
+
+int GitJob::exitCodeOf(int index) const
+{
+    return index >= 0 && index < m_steps.size() ? m_steps[index].exitCode : -1;
+}
+
+void GitJob::start()
+{
+    if (m_current >= 0) {
+        return;
+    }
+    runNext();
+}
+
+void GitJob::cancel()
+{
+    if (m_process) {
+        m_process->kill();
+    }
+}
+
+void GitJob::runNext()
+{
+    ++m_current;
+    if (m_current >= m_steps.size()) {
+        finish(true, QString());
+        return;
+    }
+
+    Q_EMIT progress(m_current, m_steps.size(), m_steps[m_current].description);
+
+    m_process = new QProcess(this);
+    m_process->setWorkingDirectory(m_workingDirectory);
+    connect(m_process, &QProcess::finished, this, &GitJob::stepFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // Crashes and kills also report finished()
+        if (error == QProcess::FailedToStart) {
+            m_process->deleteLater();
+            m_process = nullptr;
+            m_timeout.stop();
+            finish(false, QStringLiteral("git could not be started"));
+        }
+    });
+    m_timeout.start();
+    m_process->start(QStringLiteral("git"), m_steps[m_current].args());
+}
+
+void GitJob::stepFinished(int exitCode, QProcess::ExitStatus status)
+{
+    m_timeout.stop();
+    const QString error = QString::fromUtf8(m_process->readAllStandardError()).trimmed();
+    m_process->deleteLater();
+    m_process = nullptr;
+
+    Step &step = m_steps[m_current];
+    step.exitCode = status == QProcess::NormalExit ? exitCode : -1;
+    if (step.exitCode != 0 && !step.check) {
+        qCWarning(KonsolaiLog) << "GitJob:" << step.description << "failed with" << step.exitCode << error;
+        finish(false, error.isEmpty() ? QStringLiteral("%1 failed").arg(step.description) : error);
+        return;
+    }
+    runNext();
+}
+
+void GitJob::finish(bool ok, const QString &error)
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    Q_EMIT finished(ok, error);
+}
+
+GitJob *GitJob::initRepository(const QString &dir, const QString &remoteUrl, QObject *parent)
+{
+    auto *job = new GitJob(dir, parent);
+    job->addStep(QStringLiteral("Initializing repository"), {QStringLiteral("init")});
+    if (!remoteUrl.isEmpty()) {
+        job->addStep(QStringLiteral("Adding remote"), {QStringLiteral("remote"), QStringLiteral("add"), QStringLiteral("origin"), remoteUrl});
+    }
+    return job;
+}
+
+GitJob *GitJob::addWorktree(const QString &repoRoot, const QString &path, const QString &branch, QObject *parent)
+{
+    auto *job = new GitJob(repoRoot, parent);
+    job->addCheck(QStringLiteral("Checking branch"), {QStringLiteral("rev-parse"), QStringLiteral("--verify"), QStringLiteral("refs/heads/") + branch});
+    job->addStep(QStringLiteral("Creating worktree"), [job, path, branch]() {
+        QStringList args = {QStringLiteral("worktree"), QStringLiteral("add")};
+        if (job->exitCodeOf(0) == 0) {
+            args << path << branch;
+        } else {
+            args << QStringLiteral("-b") << branch << path;
+        }
+        return args;
+    });
+    return job;
+}
+
+} // namespace Konsolai
+
+#include "moc_GitJob.cpp"
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef GITJOB_H
+#define GITJOB_H
+
+#include "konsoleprivate_export.h"
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Runs a sequence of git commands without blocking the GUI thread.
+ *
+ * Each step is one git invocation; the next starts when the previous one
+ * has exited.  A failing step ends the job unless it was added as a check,
+ * whose exit code later steps can look at with exitCodeOf() to pick their
+ * arguments.  progress() is emitted as each step starts, finished() once,
+ * at the end.
+ */
+class KONSOLEPRIVATE_EXPORT GitJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Arguments = std::function<QStringList()>;
+
+    explicit GitJob(const QString &workingDirectory, QObject *parent = nullptr);
+    ~GitJob() override;
+
+    /** Adds a step running git with @p args. */
+    void addStep(const QString &description, const QStringList &args);
+    /** Adds a step whose arguments are computed when it starts. */
+    void addStep(const QString &description, Arguments args);
+    /** Adds a step which may fail without ending the job. */
+    void addCheck(const QString &description, const QStringList &args);
+
+    void start();
+    /** Kills the running step; finished() reports the job as failed. */
+    void cancel();
+
+    bool isRunning() const
+    {
+        return m_process != nullptr;
+    }
+
+    int stepCount() const
+    {
+        return m_steps.size();
+    }
+
+    /** Exit code of step @p index, -1 if it didn't run or crashed. */
+    int exitCodeOf(int index) const;
+
+    /** Milliseconds a step may take before it is killed. */
+    void setStepTimeout(int ms);
+
+    /** `git init`, then `git remote add origin` if @p remoteUrl is set. */
+    static GitJob *initRepository(const QString &dir, const QString &remoteUrl, QObject *parent = nullptr);
+
+    /** `git worktree add` of @p branch at @p path, creating the branch if it doesn't exist. */
+    static GitJob *addWorktree(const QString &repoRoot, const QString &path, const QString &branch, QObject *parent = nullptr);
+
+    static constexpr int DefaultStepTimeoutMs = 60000;
+
+Q_SIGNALS:
+    /** Step @p index of @p count, described by @p description, started. */
+    void progress(int index, int count, const QString &description);
+    /** The job ended; @p error is git's message if it failed. */
+    void finished(bool ok, const QString &error);
+
+private:
+    struct Step {
+        QString description;
+        Arguments args;
+        bool check = false;
+        int exitCode = -1;
+    };
+
+    void runNext();
+    void stepFinished(int exitCode, QProcess::ExitStatus status);
+    void finish(bool ok, const QString &error);
+
+    QString m_workingDirectory;
+    QList<Step> m_steps;
+    int m_current = -1;
+    QPointer<QProcess> m_process;
+    QTimer m_timeout;
+    bool m_finished = false;
+};
+
+} // namespace Konsolai
+
+#endif // GITJOB_H
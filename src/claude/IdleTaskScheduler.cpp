@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "IdleTaskScheduler.h"
+#include "KonsolaiLogging.h"
+
+#include "StartupTrace.h"
+
+#include <algorithm>
+
+namespace Konsolai
+{
+
+static IdleTaskScheduler *s_idleTaskSchedulerInstance = nullptr;
+
+IdleTaskScheduler::IdleTaskScheduler(QObject *parent)
+    : QObject(parent)
+{
+    if (!s_idleTaskSchedulerInstance) {
+        s_idleTaskSchedulerInstance = this;
+    }
+
+    m_runTimer.setSingleShot(true);
+    m_runTimer.setInterval(0);
+    connect(&m_runTimer, &QTimer::timeout, this, &IdleTaskScheduler::runNext);
+
+    // Safety net in case nobody signals that the first terminal is up
+    m_releaseTimer.setSingleShot(true);
+    m_releaseTimer.setInterval(kReleaseTimeoutMs);
+    connect(&m_releaseTimer, &QTimer::timeout, this, &IdleTaskScheduler::release);
+    m_releaseTimer.start();
+}
+
+IdleTaskScheduler::~IdleTaskScheduler()
+{
+    if (s_idleTaskSchedulerInstance == this) {
+        s_idleTaskSchedulerInstance = nullptr;
+    }
+}
+
+IdleTaskScheduler *IdleTaskScheduler::instance()
+{
+    return s_idleTaskSchedulerInstance;
+}
+
+void IdleTaskScheduler::post(QObject *context, const char *name, Priority priority, std::function<void()> task)
+{
+    if (auto *scheduler = instance()) {
+        scheduler->enqueue(Task{context, context != nullptr, name, priority, std::move(task)});
+        return;
+    }
+
+    if (context) {
+        QTimer::singleShot(0, context, std::move(task));
+    } else {
+        QTimer::singleShot(0, std::move(task));
+    }
+}
+
+void IdleTaskScheduler::enqueue(Task task)
+{
+    // Insert after the last task of the same or higher priority (stable FIFO)
+    auto it = std::find_if(m_tasks.begin(), m_tasks.end(), [&task](const Task &queued) {
+        return queued.priority < task.priority;
+    });
+    m_tasks.insert(it, std::move(task));
+
+    if (m_released && !m_runTimer.isActive()) {
+        m_runTimer.start();
+    }
+}
+
+void IdleTaskScheduler::release()
+{
+    if (m_released) {
+        return;
+    }
+    m_released = true;
+    m_releaseTimer.stop();
+
+    qCDebug(KonsolaiLog) << "IdleTaskScheduler: released with" << m_tasks.size() << "deferred tasks";
+    Konsole::StartupTrace::instance()->mark("idle-tasks-released");
+
+    if (m_tasks.isEmpty()) {
+        Q_EMIT drained();
+    } else {
+        m_runTimer.start();
+    }
+}
+
+void IdleTaskScheduler::runNext()
+{
+    if (m_tasks.isEmpty()) {
+        return;
+    }
+
+    Task task = m_tasks.takeFirst();
+    if (task.context || !task.hasContext) {
+        Konsole::StartupTrace::Span span(task.name, "idle");
+        task.run();
+    }
+
+    if (m_tasks.isEmpty()) {
+        Q_EMIT drained();
+    } else {
+        m_runTimer.start();
+    }
+}
+
+} // namespace Konsolai
+
+#include "moc_IdleTaskScheduler.cpp"
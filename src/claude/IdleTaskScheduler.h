@@ -0,0 +1,99 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef IDLETASKSCHEDULER_H
+#define IDLETASKSCHEDULER_H
+
+#include "konsoleprivate_export.h"
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Runs non-critical startup work once the first terminal is interactive.
+ *
+ * Tasks posted before release() are held back; afterwards they run one per
+ * event loop iteration, highest priority first and in posting order within
+ * a priority, so input and painting are never blocked by a burst of
+ * registry, remote or agent scans.  A task is dropped if its context object
+ * was destroyed before it ran; a task posted without one always runs.
+ *
+ * If no scheduler exists (tests, KPart hosts) post() falls back to a plain
+ * zero-timer so callers never need to check.
+ */
+class KONSOLEPRIVATE_EXPORT IdleTaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Low,
+        Normal,
+        High,
+    };
+    Q_ENUM(Priority)
+
+    explicit IdleTaskScheduler(QObject *parent = nullptr);
+    ~IdleTaskScheduler() override;
+
+    static IdleTaskScheduler *instance();
+
+    /**
+     * Queues @p task to run in idle time.  @p name is used for the startup
+     * trace and must be a string literal.
+     */
+    static void post(QObject *context, const char *name, Priority priority, std::function<void()> task);
+
+    /**
+     * Lets queued tasks run.  Called once the first terminal is interactive;
+     * if nobody calls it, the scheduler releases itself after kReleaseTimeoutMs.
+     */
+    void release();
+
+    bool isReleased() const
+    {
+        return m_released;
+    }
+
+    int pendingCount() const
+    {
+        return m_tasks.size();
+    }
+
+    static constexpr int kReleaseTimeoutMs = 3000;
+
+Q_SIGNALS:
+    /** Emitted each time the queue runs empty after release(). */
+    void drained();
+
+private:
+    struct Task {
+        QPointer<QObject> context;
+        // a destroyed context reads as null as well
+        bool hasContext = false;
+        const char *name = nullptr;
+        Priority priority = Normal;
+        std::function<void()> run;
+    };
+
+    void enqueue(Task task);
+    void runNext();
+
+    QList<Task> m_tasks;
+    QTimer m_runTimer;
+    QTimer m_releaseTimer;
+    bool m_released = false;
+};
+
+} // namespace Konsolai
+
+#endif // IDLETASKSCHEDULER_H
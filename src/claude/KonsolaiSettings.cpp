@@ -177,6 +177,19 @@ void KonsolaiSettings::setTrySuggestionsFirst(bool enabled)
     Q_EMIT settingsChanged();
 }
 
+bool KonsolaiSettings::tmuxControlMode() const
+{
+    KConfigGroup group(m_config, QStringLiteral("Tmux"));
+    return group.readEntry("ControlMode", false);
+}
+
+void KonsolaiSettings::setTmuxControlMode(bool enabled)
+{
+    KConfigGroup group(m_config, QStringLiteral("Tmux"));
+    group.writeEntry("ControlMode", enabled);
+    Q_EMIT settingsChanged();
+}
+
 // ========== Budget Defaults ==========
 
 int KonsolaiSettings::defaultTimeLimitMinutes() const
@@ -95,6 +95,13 @@ public:
     bool trySuggestionsFirst() const;
     void setTrySuggestionsFirst(bool enabled);
 
+    /**
+     * Drive local tmux sessions through control mode (tmux -CC) and render
+     * the pane directly, instead of attaching a nested tmux client
+     */
+    bool tmuxControlMode() const;
+    void setTmuxControlMode(bool enabled);
+
     // ========== Budget Defaults ==========
 
     /**
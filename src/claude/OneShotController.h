@@ -75,6 +75,12 @@ public:
      */
     void attachToSession(ClaudeSession *session);
 
+    /** The attached session, null once it is gone. */
+    ClaudeSession *session() const
+    {
+        return m_session;
+    }
+
     /**
      * Begin monitoring; sends prompt on first Idle.
      */
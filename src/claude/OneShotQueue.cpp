@@ -0,0 +1,679 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "OneShotQueue.h"
+#include "KonsolaiLogging.h"
+
+#include "BudgetController.h"
+#include "ClaudeSession.h"
+#include "GitJob.h"
+#include "PromptQualityGate.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QUuid>
+
+#include <algorithm>
+#include <limits>
+
+namespace Konsolai
+{
+
+namespace
+{
+QJsonObject configToJson(const OneShotConfig &config)
+{
+    QJsonObject obj;
+    obj[QStringLiteral("prompt")] = config.prompt;
+    obj[QStringLiteral("workingDir")] = config.workingDir;
+    obj[QStringLiteral("model")] = config.model;
+    obj[QStringLiteral("timeLimitMinutes")] = config.timeLimitMinutes;
+    obj[QStringLiteral("costCeilingUSD")] = config.costCeilingUSD;
+    obj[QStringLiteral("tokenCeiling")] = static_cast<qint64>(config.tokenCeiling);
+    obj[QStringLiteral("yoloLevel")] = config.yoloLevel;
+    obj[QStringLiteral("useGsd")] = config.useGsd;
+    obj[QStringLiteral("qualityScore")] = config.qualityScore;
+    return obj;
+}
+
+OneShotConfig configFromJson(const QJsonObject &obj)
+{
+    OneShotConfig config;
+    config.prompt = obj[QStringLiteral("prompt")].toString();
+    config.workingDir = obj[QStringLiteral("workingDir")].toString();
+    config.model = obj[QStringLiteral("model")].toString();
+    config.timeLimitMinutes = obj[QStringLiteral("timeLimitMinutes")].toInt(0);
+    config.costCeilingUSD = obj[QStringLiteral("costCeilingUSD")].toDouble(0.0);
+    config.tokenCeiling = static_cast<quint64>(obj[QStringLiteral("tokenCeiling")].toInteger(0));
+    config.yoloLevel = obj[QStringLiteral("yoloLevel")].toInt(3);
+    config.useGsd = obj[QStringLiteral("useGsd")].toBool(false);
+    config.qualityScore = obj[QStringLiteral("qualityScore")].toInt(0);
+    return config;
+}
+
+QJsonObject resultToJson(const OneShotResult &result)
+{
+    QJsonObject obj;
+    obj[QStringLiteral("success")] = result.success;
+    obj[QStringLiteral("summary")] = result.summary;
+    obj[QStringLiteral("costUSD")] = result.costUSD;
+    obj[QStringLiteral("durationSeconds")] = result.durationSeconds;
+    obj[QStringLiteral("totalTokens")] = static_cast<qint64>(result.totalTokens);
+    obj[QStringLiteral("filesModified")] = result.filesModified;
+    obj[QStringLiteral("commits")] = result.commits;
+    obj[QStringLiteral("errors")] = QJsonArray::fromStringList(result.errors);
+    return obj;
+}
+
+OneShotResult resultFromJson(const QJsonObject &obj)
+{
+    OneShotResult result;
+    result.success = obj[QStringLiteral("success")].toBool(false);
+    result.summary = obj[QStringLiteral("summary")].toString();
+    result.costUSD = obj[QStringLiteral("costUSD")].toDouble(0.0);
+    result.durationSeconds = obj[QStringLiteral("durationSeconds")].toInt(0);
+    result.totalTokens = static_cast<quint64>(obj[QStringLiteral("totalTokens")].toInteger(0));
+    result.filesModified = obj[QStringLiteral("filesModified")].toInt(0);
+    result.commits = obj[QStringLiteral("commits")].toInt(0);
+    for (const QJsonValue &error : obj[QStringLiteral("errors")].toArray()) {
+        result.errors.append(error.toString());
+    }
+    return result;
+}
+
+QString dateToJson(const QDateTime &date)
+{
+    return date.isValid() ? date.toString(Qt::ISODateWithMs) : QString();
+}
+
+QDateTime dateFromJson(const QJsonValue &value)
+{
+    const QString text = value.toString();
+    return text.isEmpty() ? QDateTime() : QDateTime::fromString(text, Qt::ISODateWithMs);
+}
+
+// Order in which pending tasks are admitted
+bool admittedBefore(const OneShotTask &a, const OneShotTask &b)
+{
+    if (a.qualityScore != b.qualityScore) {
+        return a.qualityScore > b.qualityScore;
+    }
+    if (a.estimatedCostUSD != b.estimatedCostUSD) {
+        return a.estimatedCostUSD < b.estimatedCostUSD;
+    }
+    return a.sequence < b.sequence;
+}
+
+// The top of the repository holding @p dir, found without running git
+QString repositoryRoot(const QString &dir)
+{
+    QDir current(dir);
+    if (!current.exists()) {
+        return QString();
+    }
+    do {
+        // A directory, or a file in worktrees and submodules
+        if (current.exists(QStringLiteral(".git"))) {
+            return current.absolutePath();
+        }
+    } while (current.cdUp());
+    return QString();
+}
+}
+
+QJsonObject OneShotTask::toJson() const
+{
+    QJsonObject obj;
+    obj[QStringLiteral("id")] = id;
+    obj[QStringLiteral("config")] = configToJson(config);
+    obj[QStringLiteral("state")] = static_cast<int>(state);
+    obj[QStringLiteral("qualityScore")] = qualityScore;
+    obj[QStringLiteral("estimatedCostUSD")] = estimatedCostUSD;
+    obj[QStringLiteral("sequence")] = static_cast<qint64>(sequence);
+    obj[QStringLiteral("worktreePath")] = worktreePath;
+    obj[QStringLiteral("branch")] = branch;
+    obj[QStringLiteral("result")] = resultToJson(result);
+    obj[QStringLiteral("enqueuedAt")] = dateToJson(enqueuedAt);
+    obj[QStringLiteral("startedAt")] = dateToJson(startedAt);
+    obj[QStringLiteral("finishedAt")] = dateToJson(finishedAt);
+    obj[QStringLiteral("attempts")] = attempts;
+    return obj;
+}
+
+OneShotTask OneShotTask::fromJson(const QJsonObject &obj)
+{
+    OneShotTask task;
+    task.id = obj[QStringLiteral("id")].toString();
+    task.config = configFromJson(obj[QStringLiteral("config")].toObject());
+    task.state = static_cast<State>(std::clamp(obj[QStringLiteral("state")].toInt(0), int(Pending), int(Cancelled)));
+    task.qualityScore = obj[QStringLiteral("qualityScore")].toInt(0);
+    task.estimatedCostUSD = obj[QStringLiteral("estimatedCostUSD")].toDouble(0.0);
+    task.sequence = static_cast<quint64>(obj[QStringLiteral("sequence")].toInteger(0));
+    task.worktreePath = obj[QStringLiteral("worktreePath")].toString();
+    task.branch = obj[QStringLiteral("branch")].toString();
+    task.result = resultFromJson(obj[QStringLiteral("result")].toObject());
+    task.enqueuedAt = dateFromJson(obj[QStringLiteral("enqueuedAt")]);
+    task.startedAt = dateFromJson(obj[QStringLiteral("startedAt")]);
+    task.finishedAt = dateFromJson(obj[QStringLiteral("finishedAt")]);
+    task.attempts = obj[QStringLiteral("attempts")].toInt(0);
+    return task;
+}
+
+OneShotQueue::OneShotQueue(Launch launch, QObject *parent)
+    : QObject(parent)
+    , m_launch(std::move(launch))
+    , m_prepareWorktree(&OneShotQueue::createWorktree)
+    , m_stateFilePath(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/konsolai/oneshot-queue.json"))
+{
+    // Tasks are admitted from the event loop, never from inside the
+    // signal handlers of a finishing task
+    m_admitTimer.setSingleShot(true);
+    m_admitTimer.setInterval(0);
+    connect(&m_admitTimer, &QTimer::timeout, this, &OneShotQueue::admit);
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(500);
+    connect(&m_saveTimer, &QTimer::timeout, this, &OneShotQueue::saveState);
+}
+
+OneShotQueue::~OneShotQueue()
+{
+    if (m_saveTimer.isActive()) {
+        saveState();
+    }
+}
+
+QString OneShotQueue::enqueue(const OneShotConfig &config)
+{
+    OneShotTask task;
+    task.id = QUuid::createUuid().toString(QUuid::Id128).left(12);
+    task.config = config;
+    task.sequence = m_nextSequence++;
+    task.enqueuedAt = QDateTime::currentDateTime();
+
+    const Assessment assessment = PromptQualityGate::assess(config.prompt, config.workingDir);
+    task.qualityScore = config.qualityScore > 0 ? config.qualityScore : assessment.score;
+    // The task's own ceiling caps what it can cost
+    task.estimatedCostUSD = assessment.estimatedCostUSD;
+    if (config.costCeilingUSD > 0.0) {
+        task.estimatedCostUSD = std::min(task.estimatedCostUSD, config.costCeilingUSD);
+    }
+
+    m_tasks.append(task);
+    m_exhaustedReported = false;
+    qCDebug(KonsolaiLog) << "OneShotQueue: enqueued" << task.id << "score:" << task.qualityScore << "estimate: $" << task.estimatedCostUSD;
+
+    scheduleSave();
+    scheduleAdmit();
+    return task.id;
+}
+
+bool OneShotQueue::cancel(const QString &id)
+{
+    const int index = indexOf(id);
+    if (index < 0 || m_tasks[index].state != OneShotTask::Pending) {
+        return false;
+    }
+    m_tasks[index].state = OneShotTask::Cancelled;
+    m_tasks[index].finishedAt = QDateTime::currentDateTime();
+    scheduleSave();
+    scheduleAdmit();
+    return true;
+}
+
+void OneShotQueue::start()
+{
+    m_started = true;
+    m_exhaustedReported = false;
+    scheduleAdmit();
+}
+
+void OneShotQueue::stop()
+{
+    m_started = false;
+    m_admitTimer.stop();
+}
+
+void OneShotQueue::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = std::max(1, count);
+    scheduleAdmit();
+}
+
+void OneShotQueue::setBudgetController(BudgetController *budget)
+{
+    if (m_budget) {
+        disconnect(m_budget, nullptr, this, nullptr);
+    }
+    m_budget = budget;
+    if (m_budget) {
+        // A limit reached shows up as the queue stalling
+        connect(m_budget, &BudgetController::budgetExceeded, this, &OneShotQueue::scheduleAdmit);
+    }
+    m_exhaustedReported = false;
+    scheduleAdmit();
+}
+
+void OneShotQueue::setPrepareWorktree(PrepareWorktree prepare)
+{
+    m_prepareWorktree = std::move(prepare);
+}
+
+GitJob *OneShotQueue::createWorktree(OneShotTask &task, QString *error)
+{
+    const QString repoRoot = repositoryRoot(task.config.workingDir);
+    if (repoRoot.isEmpty()) {
+        if (error) {
+            *error = QStringLiteral("Not a git repository: %1").arg(task.config.workingDir);
+        }
+        return nullptr;
+    }
+
+    if (task.branch.isEmpty()) {
+        task.branch = QStringLiteral("oneshot/") + task.id;
+    }
+    if (task.worktreePath.isEmpty()) {
+        // Next to the repository, so the worktrees don't show up in it
+        const QFileInfo repo(repoRoot);
+        task.worktreePath = repo.dir().absoluteFilePath(repo.fileName() + QStringLiteral("-oneshot/") + task.id);
+    }
+    // Left from before a restart
+    if (QFileInfo::exists(task.worktreePath + QStringLiteral("/.git"))) {
+        return nullptr;
+    }
+
+    QDir().mkpath(QFileInfo(task.worktreePath).absolutePath());
+    return GitJob::addWorktree(repoRoot, task.worktreePath, task.branch);
+}
+
+QList<OneShotTask> OneShotQueue::tasks() const
+{
+    QList<OneShotTask> sorted = m_tasks;
+    auto rank = [](const OneShotTask &task) {
+        return task.state == OneShotTask::Running ? 0 : task.state == OneShotTask::Pending ? 1 : 2;
+    };
+    std::stable_sort(sorted.begin(), sorted.end(), [&rank](const OneShotTask &a, const OneShotTask &b) {
+        if (rank(a) != rank(b)) {
+            return rank(a) < rank(b);
+        }
+        if (a.state == OneShotTask::Pending) {
+            return admittedBefore(a, b);
+        }
+        return a.startedAt < b.startedAt;
+    });
+    return sorted;
+}
+
+OneShotTask OneShotQueue::task(const QString &id) const
+{
+    const int index = indexOf(id);
+    return index >= 0 ? m_tasks[index] : OneShotTask();
+}
+
+int OneShotQueue::pendingCount() const
+{
+    return static_cast<int>(std::count_if(m_tasks.cbegin(), m_tasks.cend(), [](const OneShotTask &task) {
+        return task.state == OneShotTask::Pending;
+    }));
+}
+
+int OneShotQueue::finishedCount() const
+{
+    return static_cast<int>(std::count_if(m_tasks.cbegin(), m_tasks.cend(), [](const OneShotTask &task) {
+        return task.isFinished();
+    }));
+}
+
+double OneShotQueue::spentCostUSD() const
+{
+    double spent = 0.0;
+    for (const OneShotTask &task : m_tasks) {
+        if (task.isFinished()) {
+            spent += task.result.costUSD;
+        }
+    }
+    for (const Running &running : m_controllers) {
+        if (ClaudeSession *session = running.controller ? running.controller->session() : nullptr) {
+            spent += session->tokenUsage().estimatedCostUSD();
+        }
+    }
+    return spent;
+}
+
+quint64 OneShotQueue::spentTokens() const
+{
+    quint64 spent = 0;
+    for (const OneShotTask &task : m_tasks) {
+        if (task.isFinished()) {
+            spent += task.result.totalTokens;
+        }
+    }
+    for (const Running &running : m_controllers) {
+        if (ClaudeSession *session = running.controller ? running.controller->session() : nullptr) {
+            spent += session->tokenUsage().totalTokens();
+        }
+    }
+    return spent;
+}
+
+double OneShotQueue::tasksPerHour() const
+{
+    QDateTime first;
+    QDateTime last;
+    int finished = 0;
+    for (const OneShotTask &task : m_tasks) {
+        if (task.state != OneShotTask::Succeeded && task.state != OneShotTask::Failed) {
+            continue;
+        }
+        ++finished;
+        if (task.startedAt.isValid() && (!first.isValid() || task.startedAt < first)) {
+            first = task.startedAt;
+        }
+        if (!last.isValid() || task.finishedAt > last) {
+            last = task.finishedAt;
+        }
+    }
+    if (m_controllers.size() > 0) {
+        last = QDateTime::currentDateTime();
+    }
+    const qint64 ms = first.isValid() && last.isValid() ? first.msecsTo(last) : 0;
+    if (finished == 0 || ms <= 0) {
+        return 0.0;
+    }
+    return finished * 3600000.0 / ms;
+}
+
+double OneShotQueue::remainingBudgetUSD() const
+{
+    if (!m_budget || m_budget->budget().costCeilingUSD <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double committed = spentCostUSD();
+    // Running tasks may still spend up to their estimate
+    for (auto it = m_controllers.cbegin(); it != m_controllers.cend(); ++it) {
+        double current = 0.0;
+        if (ClaudeSession *session = it->controller ? it->controller->session() : nullptr) {
+            current = session->tokenUsage().estimatedCostUSD();
+        }
+        committed += std::max(0.0, it->reservedUSD - current);
+    }
+    return m_budget->budget().costCeilingUSD - committed;
+}
+
+quint64 OneShotQueue::remainingTokens() const
+{
+    if (!m_budget || m_budget->budget().tokenCeiling == 0) {
+        return std::numeric_limits<quint64>::max();
+    }
+    const quint64 spent = spentTokens();
+    const quint64 ceiling = m_budget->budget().tokenCeiling;
+    return spent < ceiling ? ceiling - spent : 0;
+}
+
+bool OneShotQueue::budgetExceeded() const
+{
+    if (!m_budget) {
+        return false;
+    }
+    const SessionBudget &budget = m_budget->budget();
+    return budget.timeExceeded || budget.costExceeded || budget.tokenExceeded || remainingTokens() == 0;
+}
+
+int OneShotQueue::pickNext() const
+{
+    const double remaining = remainingBudgetUSD();
+    int best = -1;
+    for (int i = 0; i < m_tasks.size(); ++i) {
+        const OneShotTask &task = m_tasks[i];
+        if (task.state != OneShotTask::Pending || task.estimatedCostUSD > remaining) {
+            continue;
+        }
+        if (best < 0 || admittedBefore(task, m_tasks[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void OneShotQueue::scheduleAdmit()
+{
+    if (m_started) {
+        m_admitTimer.start();
+    }
+}
+
+void OneShotQueue::admit()
+{
+    if (!m_started) {
+        return;
+    }
+    while (m_controllers.size() < m_maxConcurrent && !budgetExceeded()) {
+        const int index = pickNext();
+        if (index < 0) {
+            break;
+        }
+        runTask(index);
+    }
+
+    const int pending = pendingCount();
+    if (pending > 0 && m_controllers.isEmpty()) {
+        if (!m_exhaustedReported) {
+            m_exhaustedReported = true;
+            qCWarning(KonsolaiLog) << "OneShotQueue:" << pending << "tasks don't fit in the remaining budget";
+            Q_EMIT budgetExhausted(pending);
+        }
+    }
+}
+
+void OneShotQueue::runTask(int index)
+{
+    OneShotTask &task = m_tasks[index];
+    const QString id = task.id;
+    task.state = OneShotTask::Running;
+    task.startedAt = QDateTime::currentDateTime();
+    task.attempts++;
+
+    // Running, and holding its share of the budget, from now on
+    Running running;
+    running.reservedUSD = task.estimatedCostUSD;
+    m_controllers.insert(id, running);
+    scheduleSave();
+
+    QString error;
+    GitJob *job = nullptr;
+    if (!QFileInfo::exists(task.worktreePath) && m_prepareWorktree) {
+        job = m_prepareWorktree(task, &error);
+    }
+    if (job == nullptr) {
+        if (error.isEmpty()) {
+            launchTask(id);
+        } else {
+            failTask(id, error);
+        }
+        return;
+    }
+
+    // The session starts once git is done
+    job->setParent(this);
+    m_controllers[id].worktreeJob = job;
+    connect(job, &GitJob::finished, this, [this, id, job](bool ok, const QString &error) {
+        job->deleteLater();
+        auto it = m_controllers.find(id);
+        if (it == m_controllers.end() || it->worktreeJob != job) {
+            return;
+        }
+        it->worktreeJob = nullptr;
+        if (ok) {
+            launchTask(id);
+        } else {
+            failTask(id, QStringLiteral("git worktree add failed: %1").arg(error));
+        }
+    });
+    job->start();
+}
+
+void OneShotQueue::launchTask(const QString &id)
+{
+    const int index = indexOf(id);
+    auto it = m_controllers.find(id);
+    if (index < 0 || it == m_controllers.end()) {
+        return;
+    }
+    const OneShotTask &task = m_tasks[index];
+
+    auto *controller = new OneShotController(this);
+    OneShotConfig config = task.config;
+    if (!task.worktreePath.isEmpty()) {
+        config.workingDir = task.worktreePath;
+    }
+    controller->setConfig(config);
+    connect(controller, &OneShotController::completed, this, [this, id](const OneShotResult &result) {
+        taskCompleted(id, result);
+    });
+    it->controller = controller;
+
+    qCDebug(KonsolaiLog) << "OneShotQueue: starting" << id << "in" << config.workingDir << "-" << m_controllers.size() << "running";
+
+    // The task list may change while the session starts
+    const OneShotTask snapshot = task;
+    if (!m_launch || !m_launch(snapshot, controller)) {
+        failTask(id, QStringLiteral("Could not start a session"));
+        return;
+    }
+    if (ClaudeSession *session = controller->session()) {
+        // A session closed by hand never completes on its own
+        connect(session, &QObject::destroyed, controller, [this, id]() {
+            OneShotResult result;
+            result.errors.append(QStringLiteral("Session closed before completion"));
+            taskCompleted(id, result);
+        });
+    }
+    controller->start();
+    Q_EMIT taskStarted(id);
+}
+
+void OneShotQueue::failTask(const QString &id, const QString &error)
+{
+    OneShotResult result;
+    result.errors.append(error);
+    taskCompleted(id, result);
+}
+
+void OneShotQueue::taskCompleted(const QString &id, const OneShotResult &result)
+{
+    auto it = m_controllers.find(id);
+    const int index = indexOf(id);
+    if (it == m_controllers.end() || index < 0) {
+        return;
+    }
+    if (it->controller) {
+        it->controller->disconnect(this);
+        it->controller->deleteLater();
+    }
+    m_controllers.erase(it);
+
+    OneShotTask &task = m_tasks[index];
+    task.result = result;
+    task.finishedAt = QDateTime::currentDateTime();
+    if (task.result.durationSeconds <= 0 && task.startedAt.isValid()) {
+        task.result.durationSeconds = static_cast<int>(task.startedAt.secsTo(task.finishedAt));
+    }
+    task.state = result.success ? OneShotTask::Succeeded : OneShotTask::Failed;
+
+    qCDebug(KonsolaiLog) << "OneShotQueue:" << id << (result.success ? "succeeded" : "failed") << "cost: $" << task.result.costUSD
+                         << "tokens:" << task.result.totalTokens << "duration:" << task.result.durationSeconds << "s"
+                         << "tokens/min:" << task.tokensPerMinute();
+
+    const OneShotResult recorded = task.result;
+    scheduleSave();
+    scheduleAdmit();
+    Q_EMIT taskFinished(id, recorded);
+
+    if (m_controllers.isEmpty() && finishedCount() == m_tasks.size()) {
+        Q_EMIT drained();
+    }
+}
+
+int OneShotQueue::indexOf(const QString &id) const
+{
+    for (int i = 0; i < m_tasks.size(); ++i) {
+        if (m_tasks[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void OneShotQueue::setStateFilePath(const QString &path)
+{
+    m_stateFilePath = path;
+}
+
+void OneShotQueue::loadState()
+{
+    QFile file(m_stateFilePath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qCWarning(KonsolaiLog) << "OneShotQueue: ignoring unreadable state" << m_stateFilePath << error.errorString();
+        return;
+    }
+
+    int resumed = 0;
+    for (const QJsonValue &value : doc.object().value(QStringLiteral("tasks")).toArray()) {
+        OneShotTask task = OneShotTask::fromJson(value.toObject());
+        if (task.id.isEmpty() || indexOf(task.id) >= 0) {
+            continue;
+        }
+        // Its session went away with the previous run
+        if (task.state == OneShotTask::Running) {
+            task.state = OneShotTask::Pending;
+            ++resumed;
+        }
+        m_nextSequence = std::max(m_nextSequence, task.sequence + 1);
+        m_tasks.append(task);
+    }
+
+    qCDebug(KonsolaiLog) << "OneShotQueue: loaded" << m_tasks.size() << "tasks," << resumed << "interrupted";
+    m_exhaustedReported = false;
+    scheduleAdmit();
+}
+
+void OneShotQueue::saveState() const
+{
+    QDir().mkpath(QFileInfo(m_stateFilePath).absolutePath());
+    QFile file(m_stateFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KonsolaiLog) << "OneShotQueue: failed to write" << m_stateFilePath;
+        return;
+    }
+
+    QJsonArray tasks;
+    for (const OneShotTask &task : m_tasks) {
+        tasks.append(task.toJson());
+    }
+
+    QJsonObject root;
+    root[QStringLiteral("version")] = 1;
+    root[QStringLiteral("tasks")] = tasks;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
+
+void OneShotQueue::scheduleSave()
+{
+    m_saveTimer.start();
+}
+
+} // namespace Konsolai
+
+#include "moc_OneShotQueue.cpp"
@@ -0,0 +1,236 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef ONESHOTQUEUE_H
+#define ONESHOTQUEUE_H
+
+#include "konsoleprivate_export.h"
+
+#include "OneShotController.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+class BudgetController;
+class GitJob;
+
+/**
+ * One task of a OneShotQueue.
+ */
+struct KONSOLEPRIVATE_EXPORT OneShotTask {
+    enum State {
+        Pending,
+        Running,
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    QString id;
+    OneShotConfig config;
+    State state = Pending;
+
+    // Ordering: higher quality first, then cheaper, then older
+    int qualityScore = 0;
+    double estimatedCostUSD = 0.0;
+    quint64 sequence = 0;
+
+    // The worktree the task runs in; config.workingDir is the repository
+    QString worktreePath;
+    QString branch;
+
+    OneShotResult result;
+    QDateTime enqueuedAt;
+    QDateTime startedAt;
+    QDateTime finishedAt;
+    int attempts = 0;
+
+    bool isFinished() const
+    {
+        return state == Succeeded || state == Failed || state == Cancelled;
+    }
+
+    /** Tokens per minute of the finished task, 0 if unknown. */
+    double tokensPerMinute() const
+    {
+        if (result.durationSeconds <= 0) {
+            return 0.0;
+        }
+        return static_cast<double>(result.totalTokens) * 60.0 / result.durationSeconds;
+    }
+
+    QJsonObject toJson() const;
+    static OneShotTask fromJson(const QJsonObject &obj);
+};
+
+/**
+ * Runs many one-shot tasks, each in its own git worktree.
+ *
+ * Tasks are admitted in order of their PromptQualityGate score, then of
+ * their estimated cost, while fewer than maxConcurrent() run and their
+ * estimated cost fits in what is left of the shared budget.  A task which
+ * doesn't fit is passed over for cheaper ones; it waits until the budget
+ * is raised.  Once the shared BudgetController reports a limit exceeded
+ * nothing more is admitted.
+ *
+ * An admitted task first has its worktree created by a GitJob, without
+ * blocking the event loop, and counts as running meanwhile.  Starting the
+ * session is then up to the Launch function given by the owner of the
+ * queue, which creates a ClaudeSession in the task's worktree and attaches
+ * it to the controller.  Like OneShotController, the queue is not wired
+ * into the user interface yet; nothing in the application constructs one.
+ * The queue measures cost, tokens and duration of every task
+ * and saves its state, so after a restart the tasks which had not finished
+ * are run again, in the worktrees they had.
+ */
+class KONSOLEPRIVATE_EXPORT OneShotQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Starts a session for @p task in task.worktreePath and attaches it to
+     * @p controller, which reports its result.  Returns false if no session
+     * could be started.
+     */
+    using Launch = std::function<bool(const OneShotTask &task, OneShotController *controller)>;
+
+    /**
+     * Returns the job creating the worktree of @p task, not started yet,
+     * setting its path and branch if empty.  Returns nullptr if there is
+     * nothing to create, or if it can't be, setting @p error then.
+     */
+    using PrepareWorktree = std::function<GitJob *(OneShotTask &task, QString *error)>;
+
+    explicit OneShotQueue(Launch launch, QObject *parent = nullptr);
+    ~OneShotQueue() override;
+
+    /** Adds a task for @p config; returns its id. */
+    QString enqueue(const OneShotConfig &config);
+
+    /** Drops a pending task.  Running tasks are left to their budget. */
+    bool cancel(const QString &id);
+
+    /** Starts admitting tasks. */
+    void start();
+    /** Stops admitting tasks; running ones go on. */
+    void stop();
+    bool isStarted() const
+    {
+        return m_started;
+    }
+
+    void setMaxConcurrent(int count);
+    int maxConcurrent() const
+    {
+        return m_maxConcurrent;
+    }
+
+    /**
+     * The budget shared by all tasks; its ceilings limit what is admitted.
+     * Not owned.  Without one only the per-task ceilings apply.
+     */
+    void setBudgetController(BudgetController *budget);
+    BudgetController *budgetController() const
+    {
+        return m_budget;
+    }
+
+    void setPrepareWorktree(PrepareWorktree prepare);
+
+    /** A PrepareWorktree running `git worktree add` for @p task, on a new branch next to the repository. */
+    static GitJob *createWorktree(OneShotTask &task, QString *error);
+
+    /** Tasks in the order they are admitted: running first, then pending, then finished. */
+    QList<OneShotTask> tasks() const;
+    OneShotTask task(const QString &id) const;
+
+    int pendingCount() const;
+    int runningCount() const
+    {
+        return m_controllers.size();
+    }
+    int finishedCount() const;
+
+    /** Cost of the finished tasks plus what the running ones have spent so far. */
+    double spentCostUSD() const;
+    quint64 spentTokens() const;
+
+    /** Finished tasks per hour of wall time since the first one started, 0 before. */
+    double tasksPerHour() const;
+
+    /** Where the state is saved; defaults to the konsolai data directory. */
+    void setStateFilePath(const QString &path);
+    QString stateFilePath() const
+    {
+        return m_stateFilePath;
+    }
+
+    /** Loads saved tasks; interrupted ones are made pending again. */
+    void loadState();
+    void saveState() const;
+
+    static constexpr int DefaultMaxConcurrent = 3;
+
+Q_SIGNALS:
+    void taskStarted(const QString &id);
+    void taskFinished(const QString &id, const OneShotResult &result);
+    /** Tasks are pending, none runs and none fits in the remaining budget. */
+    void budgetExhausted(int pending);
+    /** Every task has finished. */
+    void drained();
+
+private:
+    struct Running {
+        OneShotController *controller = nullptr;
+        // Creating the worktree, before there is a controller
+        GitJob *worktreeJob = nullptr;
+        // Reserved for the task until its cost is known
+        double reservedUSD = 0.0;
+    };
+
+    int pickNext() const;
+    double remainingBudgetUSD() const;
+    quint64 remainingTokens() const;
+    bool budgetExceeded() const;
+    void admit();
+    void scheduleAdmit();
+    void runTask(int index);
+    void launchTask(const QString &id);
+    void failTask(const QString &id, const QString &error);
+    void taskCompleted(const QString &id, const OneShotResult &result);
+    void scheduleSave();
+    int indexOf(const QString &id) const;
+
+    Launch m_launch;
+    PrepareWorktree m_prepareWorktree;
+    QPointer<BudgetController> m_budget;
+    int m_maxConcurrent = DefaultMaxConcurrent;
+    bool m_started = false;
+    bool m_exhaustedReported = false;
+
+    QList<OneShotTask> m_tasks;
+    QHash<QString, Running> m_controllers;
+    quint64 m_nextSequence = 0;
+
+    QString m_stateFilePath;
+    QTimer m_admitTimer;
+    QTimer m_saveTimer;
+};
+
+} // namespace Konsolai
+
+#endif // ONESHOTQUEUE_H
@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "OutputStream.h"
+
+#include <cstring>
+
+namespace Konsolai
+{
+
+OutputStream::OutputStream(int capacity, quint64 start)
+    : m_buffer(qMax(1, capacity), Qt::Uninitialized)
+    , m_end(start)
+{
+}
+
+void OutputStream::append(const char *data, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+
+    m_end += static_cast<quint64>(length);
+
+    const int capacity = m_buffer.size();
+    if (length >= capacity) {
+        // only the tail fits
+        std::memcpy(m_buffer.data(), data + (length - capacity), capacity);
+        m_head = 0;
+        m_size = capacity;
+        return;
+    }
+
+    int tail = (m_head + m_size) % capacity;
+    const int first = qMin(length, capacity - tail);
+    std::memcpy(m_buffer.data() + tail, data, first);
+    std::memcpy(m_buffer.data(), data + first, length - first);
+
+    const int overflow = m_size + length - capacity;
+    if (overflow > 0) {
+        m_head = (m_head + overflow) % capacity;
+        m_size = capacity;
+    } else {
+        m_size += length;
+    }
+}
+
+QByteArray OutputStream::readSince(quint64 since, int maxBytes, quint64 *next, bool *truncated) const
+{
+    const quint64 first = firstCursor();
+    if (truncated) {
+        *truncated = since < first;
+    }
+    if (since < first) {
+        since = first;
+    }
+    if (since >= m_end) {
+        *next = m_end;
+        return QByteArray();
+    }
+    if (maxBytes <= 0) {
+        *next = since;
+        return QByteArray();
+    }
+
+    const int capacity = m_buffer.size();
+    const int length = static_cast<int>(qMin<quint64>(m_end - since, static_cast<quint64>(maxBytes)));
+    const int start = (m_head + static_cast<int>(since - first)) % capacity;
+
+    QByteArray result(length, Qt::Uninitialized);
+    const int firstPart = qMin(length, capacity - start);
+    std::memcpy(result.data(), m_buffer.constData() + start, firstPart);
+    std::memcpy(result.data() + firstPart, m_buffer.constData(), length - firstPart);
+
+    *next = since + static_cast<quint64>(length);
+    return result;
+}
+
+void OutputStream::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+} // namespace Konsolai
@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef OUTPUTSTREAM_H
+#define OUTPUTSTREAM_H
+
+#include "konsoleprivate_export.h"
+
+#include <QByteArray>
+#include <QtGlobal>
+
+namespace Konsolai
+{
+
+/**
+ * Keeps the most recent output of a session for incremental readers.
+ *
+ * Every byte appended gets a position, its cursor, which grows forever; a
+ * reader remembers the cursor it has read up to and asks for everything
+ * after it.  Only the last capacity() bytes are kept.  A reader that fell
+ * further behind gets what is left and is told that it missed output.
+ */
+class KONSOLEPRIVATE_EXPORT OutputStream
+{
+public:
+    /**
+     * @p start is the cursor of the first byte appended, for a stream taking
+     * over from an earlier one; readers behind it are told they missed output.
+     */
+    explicit OutputStream(int capacity = DefaultCapacity, quint64 start = 0);
+
+    void append(const char *data, int length);
+
+    /** Cursor after the last byte appended. */
+    quint64 cursor() const
+    {
+        return m_end;
+    }
+
+    /** Cursor of the oldest byte still held. */
+    quint64 firstCursor() const
+    {
+        return m_end - static_cast<quint64>(m_size);
+    }
+
+    int capacity() const
+    {
+        return m_buffer.size();
+    }
+
+    /**
+     * Returns up to @p maxBytes bytes following @p since.  @p next receives
+     * the cursor to pass on the following call; @p truncated is set if
+     * bytes after @p since have already been dropped.
+     */
+    QByteArray readSince(quint64 since, int maxBytes, quint64 *next, bool *truncated = nullptr) const;
+
+    void clear();
+
+    static constexpr int DefaultCapacity = 1024 * 1024;
+
+private:
+    QByteArray m_buffer;
+    int m_head = 0; // index of the oldest byte
+    int m_size = 0;
+    quint64 m_end = 0;
+};
+
+} // namespace Konsolai
+
+#endif // OUTPUTSTREAM_H
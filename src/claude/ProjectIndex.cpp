@@ -0,0 +1,393 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ProjectIndex.h"
+#include "KonsolaiLogging.h"
+
+#include "KonsolaiSettings.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace Konsolai
+{
+
+namespace
+{
+// inotify watches are a limited resource shared with the rest of the session
+constexpr int MaxWatchedDirs = 512;
+
+QString normalized(const QString &path)
+{
+    if (path.isEmpty()) {
+        return QString();
+    }
+    return QDir::cleanPath(QDir(path).absolutePath());
+}
+
+QString readFirstLine(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readLine()).trimmed();
+}
+
+QString branchOf(const QString &gitDir)
+{
+    const QString head = readFirstLine(gitDir + QStringLiteral("/HEAD"));
+    static const QLatin1String prefix("ref: refs/heads/");
+    return head.startsWith(prefix) ? head.mid(prefix.size()) : QString();
+}
+
+// Fills @p project from the .git entry of @p dir, false if there is none
+bool readProject(const QString &dir, IndexedProject &project)
+{
+    const QFileInfo git(dir + QStringLiteral("/.git"));
+    if (git.isDir()) {
+        project.path = dir;
+        project.repoRoot = dir;
+        project.branch = branchOf(git.filePath());
+        project.lastModified = git.lastModified();
+        return true;
+    }
+    if (!git.isFile()) {
+        return false;
+    }
+
+    // A linked worktree (or a submodule): "gitdir: <repo>/.git/worktrees/<name>"
+    const QString line = readFirstLine(git.filePath());
+    if (!line.startsWith(QLatin1String("gitdir:"))) {
+        return false;
+    }
+    const QString gitDir = QDir::cleanPath(QDir(dir).absoluteFilePath(line.mid(7).trimmed()));
+    project.path = dir;
+    project.branch = branchOf(gitDir);
+    project.lastModified = git.lastModified();
+    const int worktrees = gitDir.lastIndexOf(QLatin1String("/.git/worktrees/"));
+    if (worktrees > 0) {
+        project.repoRoot = gitDir.left(worktrees);
+        project.isWorktree = true;
+    } else {
+        project.repoRoot = dir;
+    }
+    return true;
+}
+}
+
+ProjectIndex::ProjectIndex(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_scanWatcher, &QFutureWatcher<Scan>::finished, this, &ProjectIndex::onScanFinished);
+
+    // Checking out or creating a project touches its parent several times
+    m_rescanDebounce.setSingleShot(true);
+    m_rescanDebounce.setInterval(1000);
+    connect(&m_rescanDebounce, &QTimer::timeout, this, &ProjectIndex::rescan);
+    connect(&m_fsWatcher, &QFileSystemWatcher::directoryChanged, &m_rescanDebounce, qOverload<>(&QTimer::start));
+}
+
+ProjectIndex::~ProjectIndex()
+{
+    m_scanWatcher.waitForFinished();
+}
+
+ProjectIndex *ProjectIndex::instance()
+{
+    static ProjectIndex *index = [] {
+        auto *created = new ProjectIndex(qApp);
+        if (KonsolaiSettings *settings = KonsolaiSettings::instance()) {
+            created->addRoot(settings->projectRoot());
+        }
+        return created;
+    }();
+    return index;
+}
+
+void ProjectIndex::setRoots(const QStringList &roots)
+{
+    QStringList cleaned;
+    for (const QString &root : roots) {
+        const QString path = normalized(root);
+        if (!path.isEmpty() && !cleaned.contains(path)) {
+            cleaned.append(path);
+        }
+    }
+    if (cleaned == m_roots) {
+        return;
+    }
+    m_roots = cleaned;
+    m_ready = false;
+    rescan();
+}
+
+void ProjectIndex::addRoot(const QString &root)
+{
+    const QString path = normalized(root);
+    if (path.isEmpty() || m_roots.contains(path) || !QFileInfo(path).isDir()) {
+        return;
+    }
+    setRoots(m_roots + QStringList{path});
+}
+
+void ProjectIndex::setMaxDepth(int depth)
+{
+    m_maxDepth = std::max(0, depth);
+    rescan();
+}
+
+void ProjectIndex::setVisits(const QList<Visit> &visits)
+{
+    m_visits = visits;
+    rank();
+    Q_EMIT updated();
+}
+
+void ProjectIndex::rescan()
+{
+    if (m_scanWatcher.isRunning()) {
+        m_rescanPending = true;
+        return;
+    }
+    m_rescanPending = false;
+    m_scanRoots = m_roots;
+    m_scanWatcher.setFuture(QtConcurrent::run(&ProjectIndex::walk, m_roots, m_maxDepth));
+}
+
+QList<IndexedProject> ProjectIndex::scan(const QStringList &roots, int maxDepth)
+{
+    return walk(roots, maxDepth).projects;
+}
+
+ProjectIndex::Scan ProjectIndex::walk(const QStringList &roots, int maxDepth)
+{
+    Scan result;
+    QSet<QString> seen;
+
+    struct Pending {
+        QString path;
+        int depth;
+    };
+    QList<Pending> stack;
+    for (const QString &root : roots) {
+        stack.append({root, 0});
+    }
+
+    while (!stack.isEmpty()) {
+        const Pending dir = stack.takeLast();
+        if (seen.contains(dir.path)) {
+            continue;
+        }
+        seen.insert(dir.path);
+
+        IndexedProject project;
+        const bool isProject = readProject(dir.path, project);
+        if (isProject) {
+            result.projects.append(project);
+        }
+        // The wizard offers the directories right below a root as well
+        if (dir.depth == 0) {
+            result.rootEntries.insert(dir.path, QDir(dir.path).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name));
+        }
+        // Nested repositories are rare and walking checkouts is what is slow
+        if (isProject || dir.depth >= maxDepth) {
+            continue;
+        }
+
+        // Hidden directories are skipped, and symlinks could loop
+        const QStringList entries = QDir(dir.path).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        for (const QString &entry : entries) {
+            if (entry == QLatin1String("node_modules")) {
+                continue;
+            }
+            stack.append({dir.path + QLatin1Char('/') + entry, dir.depth + 1});
+        }
+    }
+    return result;
+}
+
+double ProjectIndex::visitWeight(const QDateTime &lastAccessed, const QDateTime &now)
+{
+    if (!lastAccessed.isValid()) {
+        return 0.0;
+    }
+    const double days = lastAccessed.secsTo(now) / 86400.0;
+    if (days <= 4) {
+        return 100.0;
+    }
+    if (days <= 14) {
+        return 70.0;
+    }
+    if (days <= 31) {
+        return 50.0;
+    }
+    if (days <= 90) {
+        return 30.0;
+    }
+    return 10.0;
+}
+
+void ProjectIndex::onScanFinished()
+{
+    Scan walked = m_scanWatcher.result();
+    m_projects = std::move(walked.projects);
+    m_rootEntries = std::move(walked.rootEntries);
+    m_byPath.clear();
+    for (int i = 0; i < m_projects.size(); ++i) {
+        m_byPath.insert(m_projects[i].path, i);
+    }
+    // Roots added while walking are only covered by the next walk
+    m_ready = m_scanRoots == m_roots;
+    qCDebug(KonsolaiLog) << "ProjectIndex: found" << m_projects.size() << "projects under" << m_roots;
+
+    rank();
+    watch();
+    Q_EMIT updated();
+
+    if (m_rescanPending) {
+        rescan();
+    }
+}
+
+void ProjectIndex::rank()
+{
+    for (IndexedProject &project : m_projects) {
+        project.frecency = 0.0;
+    }
+    const QDateTime now = QDateTime::currentDateTime();
+    for (const Visit &visit : std::as_const(m_visits)) {
+        const IndexedProject owner = projectAt(visit.path);
+        if (!owner.path.isEmpty()) {
+            m_projects[m_byPath.value(owner.path)].frecency += visitWeight(visit.lastAccessed, now);
+        }
+    }
+}
+
+void ProjectIndex::watch()
+{
+    // The roots, the directories between them and the projects, where new
+    // checkouts show up, and where git registers new worktrees
+    QStringList dirs = m_roots;
+    QSet<QString> added(m_roots.cbegin(), m_roots.cend());
+    auto add = [&dirs, &added](const QString &dir) {
+        if (!added.contains(dir)) {
+            added.insert(dir);
+            dirs.append(dir);
+        }
+    };
+    for (const IndexedProject &project : std::as_const(m_projects)) {
+        if (dirs.size() >= MaxWatchedDirs) {
+            break;
+        }
+        add(QFileInfo(project.path).path());
+        if (!project.isWorktree) {
+            const QString worktrees = project.path + QStringLiteral("/.git/worktrees");
+            if (QFileInfo(worktrees).isDir()) {
+                add(worktrees);
+            }
+        }
+    }
+
+    const QStringList watched = m_fsWatcher.directories();
+    if (!watched.isEmpty()) {
+        m_fsWatcher.removePaths(watched);
+    }
+    if (!dirs.isEmpty()) {
+        m_fsWatcher.addPaths(dirs.mid(0, MaxWatchedDirs));
+    }
+}
+
+QList<IndexedProject> ProjectIndex::ranked(QList<IndexedProject> projects) const
+{
+    std::stable_sort(projects.begin(), projects.end(), [](const IndexedProject &a, const IndexedProject &b) {
+        if (a.frecency != b.frecency) {
+            return a.frecency > b.frecency;
+        }
+        return a.path < b.path;
+    });
+    return projects;
+}
+
+QList<IndexedProject> ProjectIndex::projects() const
+{
+    return ranked(m_projects);
+}
+
+QList<IndexedProject> ProjectIndex::projectsUnder(const QString &dir) const
+{
+    const QString prefix = normalized(dir) + QLatin1Char('/');
+    QList<IndexedProject> inside;
+    for (const IndexedProject &project : m_projects) {
+        if (project.path.startsWith(prefix)) {
+            inside.append(project);
+        }
+    }
+    return ranked(inside);
+}
+
+QStringList ProjectIndex::completions(const QString &dir) const
+{
+    const QDir base(normalized(dir));
+    QStringList relative;
+    for (const IndexedProject &project : projectsUnder(dir)) {
+        relative.append(base.relativeFilePath(project.path));
+    }
+    const QSet<QString> listed(relative.cbegin(), relative.cend());
+    for (const QString &entry : m_rootEntries.value(base.path())) {
+        if (!listed.contains(entry)) {
+            relative.append(entry);
+        }
+    }
+    return relative;
+}
+
+IndexedProject ProjectIndex::projectAt(const QString &path) const
+{
+    QString dir = normalized(path);
+    while (!dir.isEmpty()) {
+        auto it = m_byPath.constFind(dir);
+        if (it != m_byPath.constEnd()) {
+            return m_projects[it.value()];
+        }
+        const QString parent = QFileInfo(dir).path();
+        if (parent == dir) {
+            break;
+        }
+        dir = parent;
+    }
+    return IndexedProject();
+}
+
+QString ProjectIndex::repoRootOf(const QString &path) const
+{
+    return projectAt(path).repoRoot;
+}
+
+QList<IndexedProject> ProjectIndex::worktreesOf(const QString &repoRoot) const
+{
+    const QString root = normalized(repoRoot);
+    QList<IndexedProject> worktrees;
+    for (const IndexedProject &project : m_projects) {
+        if (project.repoRoot == root) {
+            worktrees.append(project);
+        }
+    }
+    // The main repository first
+    std::stable_sort(worktrees.begin(), worktrees.end(), [](const IndexedProject &a, const IndexedProject &b) {
+        return !a.isWorktree && b.isWorktree;
+    });
+    return worktrees;
+}
+
+} // namespace Konsolai
+
+#include "moc_ProjectIndex.cpp"
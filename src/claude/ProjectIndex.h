@@ -0,0 +1,163 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PROJECTINDEX_H
+#define PROJECTINDEX_H
+
+#include "konsoleprivate_export.h"
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+namespace Konsolai
+{
+
+/**
+ * A git repository or worktree found by ProjectIndex.
+ */
+struct KONSOLEPRIVATE_EXPORT IndexedProject {
+    QString path;
+    /** The main repository; path itself unless this is a linked worktree. */
+    QString repoRoot;
+    /** Checked out branch, empty when detached. */
+    QString branch;
+    bool isWorktree = false;
+    QDateTime lastModified;
+    /** Weighted recency of the sessions run in the project. */
+    double frecency = 0.0;
+};
+
+/**
+ * Knows the git repositories and worktrees under the project roots.
+ *
+ * The session wizard used to list the workspace root and ask git about
+ * the chosen folder while the user typed, which hangs on a home directory
+ * with thousands of checkouts.  The index walks the roots on a worker
+ * thread instead, telling repositories and worktrees apart by their .git
+ * entry without running git, and answers from memory.  It watches the
+ * roots and the directories holding projects, and walks them again when
+ * they change.
+ *
+ * Projects are ranked by frecency: each session run in a project counts
+ * more the more recently it was used.  SessionManagerPanel reports its
+ * session history with setVisits().
+ *
+ * Must be used from the GUI thread.
+ */
+class KONSOLEPRIVATE_EXPORT ProjectIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** A session which ran in @p path, last used at @p lastAccessed. */
+    struct Visit {
+        QString path;
+        QDateTime lastAccessed;
+    };
+
+    explicit ProjectIndex(QObject *parent = nullptr);
+    ~ProjectIndex() override;
+
+    /** The index of the application, rooted at the configured project root. */
+    static ProjectIndex *instance();
+
+    void setRoots(const QStringList &roots);
+    /** Adds @p root unless already indexed, e.g. a workspace root typed in the wizard. */
+    void addRoot(const QString &root);
+    QStringList roots() const
+    {
+        return m_roots;
+    }
+
+    /** How deep below a root projects are looked for. */
+    void setMaxDepth(int depth);
+    int maxDepth() const
+    {
+        return m_maxDepth;
+    }
+
+    void setVisits(const QList<Visit> &visits);
+
+    /** Walks the roots again in the background. */
+    void rescan();
+
+    /** True once the first walk of the current roots has finished. */
+    bool isReady() const
+    {
+        return m_ready;
+    }
+    bool isScanning() const
+    {
+        return m_scanWatcher.isRunning();
+    }
+
+    /** All projects, best ranked first. */
+    QList<IndexedProject> projects() const;
+    /** Projects inside @p dir, best ranked first. */
+    QList<IndexedProject> projectsUnder(const QString &dir) const;
+    /**
+     * Paths of the projects inside @p dir relative to it, best ranked first,
+     * followed by the other directories right below @p dir if it is a root.
+     */
+    QStringList completions(const QString &dir) const;
+
+    /** The project containing @p path; its path is empty if there is none. */
+    IndexedProject projectAt(const QString &path) const;
+    /** The main repository of the project containing @p path, or an empty string. */
+    QString repoRootOf(const QString &path) const;
+    /** The repository at @p repoRoot and its linked worktrees. */
+    QList<IndexedProject> worktreesOf(const QString &repoRoot) const;
+
+    /** Walks @p roots up to @p maxDepth levels deep.  Runs on any thread. */
+    static QList<IndexedProject> scan(const QStringList &roots, int maxDepth);
+
+    /** The weight of a session last used at @p lastAccessed, seen at @p now. */
+    static double visitWeight(const QDateTime &lastAccessed, const QDateTime &now);
+
+    static constexpr int DefaultMaxDepth = 3;
+
+Q_SIGNALS:
+    /** The projects or their ranking changed. */
+    void updated();
+
+private:
+    struct Scan {
+        QList<IndexedProject> projects;
+        // Directories right below each root, by name
+        QHash<QString, QStringList> rootEntries;
+    };
+    static Scan walk(const QStringList &roots, int maxDepth);
+
+    void onScanFinished();
+    void rank();
+    void watch();
+    QList<IndexedProject> ranked(QList<IndexedProject> projects) const;
+
+    QStringList m_roots;
+    int m_maxDepth = DefaultMaxDepth;
+    QList<Visit> m_visits;
+
+    QList<IndexedProject> m_projects;
+    QHash<QString, int> m_byPath;
+    QHash<QString, QStringList> m_rootEntries;
+    bool m_ready = false;
+
+    QFutureWatcher<Scan> m_scanWatcher;
+    QStringList m_scanRoots;
+    bool m_rescanPending = false;
+    QFileSystemWatcher m_fsWatcher;
+    QTimer m_rescanDebounce;
+};
+
+} // namespace Konsolai
+
+#endif // PROJECTINDEX_H
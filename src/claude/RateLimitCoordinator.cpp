@@ -0,0 +1,303 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "RateLimitCoordinator.h"
+#include "KonsolaiLogging.h"
+
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Konsolai
+{
+
+namespace
+{
+// Doubling stops well before the shift could overflow; MaxBackoffMs caps it anyway
+constexpr int MaxLevel = 16;
+}
+
+RateLimitCoordinator::RateLimitCoordinator(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_dispatchTimer.setSingleShot(true);
+    connect(&m_dispatchTimer, &QTimer::timeout, this, &RateLimitCoordinator::dispatch);
+}
+
+RateLimitCoordinator::~RateLimitCoordinator() = default;
+
+RateLimitCoordinator *RateLimitCoordinator::instance()
+{
+    static RateLimitCoordinator coordinator;
+    return &coordinator;
+}
+
+QString RateLimitCoordinator::keyFor(const QString &account, const QString &model)
+{
+    return account + QLatin1Char('/') + (model.isEmpty() ? QStringLiteral("default") : model);
+}
+
+void RateLimitCoordinator::reportRateLimit(const QString &key, const QString &source)
+{
+    const qint64 t = now();
+    if (decay(key, m_buckets[key], t)) {
+        Q_EMIT recovered(key);
+    }
+    Bucket &bucket = m_buckets[key];
+
+    if (bucket.level > 0 && t < bucket.blockedUntil) {
+        // Another session running into the same episode
+        ++bucket.reports;
+        qCDebug(KonsolaiLog) << "RateLimitCoordinator:" << source << "hit the rate limit of" << key << "during its backoff, report" << bucket.reports;
+        return;
+    }
+
+    if (bucket.level == 0) {
+        bucket.reports = 0;
+    }
+    ++bucket.reports;
+    bucket.level = std::min(bucket.level + 1, MaxLevel);
+
+    const qint64 delay = backoffFor(bucket.level);
+    bucket.blockedUntil = t + delay;
+    bucket.decayAt = bucket.blockedUntil + quietPeriod(bucket.level);
+    // One request may go out right after the backoff, the rest are paced
+    bucket.tokens = 1;
+    bucket.lastRefill = bucket.blockedUntil;
+
+    qCDebug(KonsolaiLog) << "RateLimitCoordinator:" << source << "hit the rate limit of" << key << "- holding requests back for" << delay << "ms, level"
+                         << bucket.level;
+    Q_EMIT backoffStarted(key, bucket.level, delay);
+    scheduleDispatch();
+}
+
+void RateLimitCoordinator::reportSuccess(const QString &key)
+{
+    auto it = m_buckets.find(key);
+    if (it == m_buckets.end() || it->level == 0) {
+        return;
+    }
+    if (decay(key, *it, now())) {
+        Q_EMIT recovered(key);
+        dispatch();
+        return;
+    }
+    // Requests sent before the backoff don't tell anything about the limit now
+    if (now() < it->blockedUntil) {
+        return;
+    }
+
+    --it->level;
+    if (it->level == 0) {
+        qCDebug(KonsolaiLog) << "RateLimitCoordinator:" << key << "recovered after" << it->reports << "rate limit reports";
+        it->reports = 0;
+        Q_EMIT recovered(key);
+    }
+    dispatch();
+}
+
+quint64 RateLimitCoordinator::admit(const QString &key, QObject *context, Action action)
+{
+    auto it = m_buckets.find(key);
+    if (it == m_buckets.end() || (it->level == 0 && it->waiters.isEmpty())) {
+        action();
+        return 0;
+    }
+
+    Waiter waiter;
+    waiter.ticket = m_nextTicket++;
+    waiter.context = context;
+    waiter.action = std::move(action);
+    it->waiters.append(waiter);
+    scheduleDispatch();
+    return waiter.ticket;
+}
+
+void RateLimitCoordinator::cancel(quint64 ticket)
+{
+    if (ticket == 0) {
+        return;
+    }
+    for (Bucket &bucket : m_buckets) {
+        if (bucket.waiters.removeIf([ticket](const Waiter &waiter) {
+                return waiter.ticket == ticket;
+            })) {
+            break;
+        }
+    }
+    scheduleDispatch();
+}
+
+bool RateLimitCoordinator::isLimited(const QString &key) const
+{
+    return level(key) > 0;
+}
+
+int RateLimitCoordinator::level(const QString &key) const
+{
+    auto it = m_buckets.constFind(key);
+    return it == m_buckets.constEnd() ? 0 : it->level;
+}
+
+qint64 RateLimitCoordinator::backoffRemaining(const QString &key) const
+{
+    auto it = m_buckets.constFind(key);
+    return it == m_buckets.constEnd() ? 0 : std::max<qint64>(0, it->blockedUntil - now());
+}
+
+int RateLimitCoordinator::waitingCount(const QString &key) const
+{
+    auto it = m_buckets.constFind(key);
+    return it == m_buckets.constEnd() ? 0 : int(it->waiters.size());
+}
+
+int RateLimitCoordinator::reportCount(const QString &key) const
+{
+    auto it = m_buckets.constFind(key);
+    return it == m_buckets.constEnd() ? 0 : it->reports;
+}
+
+qint64 RateLimitCoordinator::backoffFor(int level) const
+{
+    return std::min(qint64(m_baseBackoffMs) << (level - 1), MaxBackoffMs);
+}
+
+qint64 RateLimitCoordinator::quietPeriod(int level) const
+{
+    return std::max(qint64(m_quietPeriodMs), backoffFor(level));
+}
+
+bool RateLimitCoordinator::decay(const QString &key, Bucket &bucket, qint64 t)
+{
+    if (bucket.level == 0 || t < bucket.decayAt) {
+        return false;
+    }
+    while (bucket.level > 0 && t >= bucket.decayAt) {
+        bucket.level /= 2;
+        if (bucket.level > 0) {
+            bucket.decayAt += quietPeriod(bucket.level);
+        }
+    }
+    if (bucket.level > 0) {
+        return false;
+    }
+    qCDebug(KonsolaiLog) << "RateLimitCoordinator:" << key << "recovered after a quiet period," << bucket.reports << "rate limit reports";
+    bucket.reports = 0;
+    return true;
+}
+
+qint64 RateLimitCoordinator::refillInterval(const Bucket &bucket) const
+{
+    // The longer the episode, the slower the pace
+    return std::max<qint64>(1, qint64(m_refillIntervalMs) * std::max(1, bucket.level));
+}
+
+bool RateLimitCoordinator::tryAcquire(Bucket &bucket, qint64 t)
+{
+    if (bucket.level == 0) {
+        return true;
+    }
+    if (t < bucket.blockedUntil) {
+        return false;
+    }
+    if (t > bucket.lastRefill) {
+        bucket.tokens = std::min(BucketCapacity, bucket.tokens + double(t - bucket.lastRefill) / refillInterval(bucket));
+        bucket.lastRefill = t;
+    }
+    if (bucket.tokens >= 1) {
+        bucket.tokens -= 1;
+        return true;
+    }
+    return false;
+}
+
+qint64 RateLimitCoordinator::nextAdmission(const Bucket &bucket, qint64 t) const
+{
+    if (bucket.level == 0) {
+        return t;
+    }
+    if (t < bucket.blockedUntil) {
+        return bucket.blockedUntil;
+    }
+    const qint64 interval = refillInterval(bucket);
+    const double tokens = std::min(BucketCapacity, bucket.tokens + double(std::max<qint64>(0, t - bucket.lastRefill)) / interval);
+    if (tokens >= 1) {
+        return t;
+    }
+    return t + qint64(std::ceil((1 - tokens) * interval));
+}
+
+void RateLimitCoordinator::run(const Waiter &waiter, bool jitter)
+{
+    if (!waiter.context) {
+        return;
+    }
+    const int delay = (jitter && m_jitterMs > 0) ? int(QRandomGenerator::global()->bounded(m_jitterMs)) : 0;
+    if (delay == 0) {
+        waiter.action();
+    } else {
+        QTimer::singleShot(delay, waiter.context.data(), waiter.action);
+    }
+}
+
+void RateLimitCoordinator::dispatch()
+{
+    const qint64 t = now();
+
+    // Collected first, the actions may call back into the coordinator
+    QList<std::pair<Waiter, bool>> admitted;
+    QStringList recoveredKeys;
+    for (auto it = m_buckets.begin(); it != m_buckets.end();) {
+        Bucket &bucket = it.value();
+        if (decay(it.key(), bucket, t)) {
+            recoveredKeys.append(it.key());
+        }
+        bucket.waiters.removeIf([](const Waiter &waiter) {
+            return !waiter.context;
+        });
+        while (!bucket.waiters.isEmpty() && tryAcquire(bucket, t)) {
+            admitted.append({bucket.waiters.takeFirst(), bucket.level > 0});
+        }
+        if (bucket.level == 0 && bucket.waiters.isEmpty()) {
+            it = m_buckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    scheduleDispatch();
+    for (const QString &key : std::as_const(recoveredKeys)) {
+        Q_EMIT recovered(key);
+    }
+    for (const auto &[waiter, jitter] : std::as_const(admitted)) {
+        run(waiter, jitter);
+    }
+}
+
+void RateLimitCoordinator::scheduleDispatch()
+{
+    const qint64 t = now();
+    qint64 next = std::numeric_limits<qint64>::max();
+    for (const Bucket &bucket : std::as_const(m_buckets)) {
+        if (!bucket.waiters.isEmpty()) {
+            next = std::min(next, nextAdmission(bucket, t));
+        }
+        if (bucket.level > 0) {
+            next = std::min(next, bucket.decayAt);
+        }
+    }
+    if (next == std::numeric_limits<qint64>::max()) {
+        m_dispatchTimer.stop();
+        return;
+    }
+    m_dispatchTimer.start(int(std::clamp<qint64>(next - t, 0, MaxBackoffMs)));
+}
+
+} // namespace Konsolai
+
+#include "moc_RateLimitCoordinator.cpp"
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef RATELIMITCOORDINATOR_H
+#define RATELIMITCOORDINATOR_H
+
+#include "konsoleprivate_export.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Shares what the sessions learn about API rate limits.
+ *
+ * All sessions of one account using one model run into the same limits, so
+ * a 429 or 529 seen by one of them applies to all.  Sessions report the
+ * errors they see, and every request the application sends on its own
+ * (retries after a rate limit, auto-accepted suggestions) is admitted
+ * through the coordinator instead of on a private timer.
+ *
+ * Each account and model has one backoff.  Reports arriving while it runs
+ * belong to the same episode and don't extend it; a report after it ended
+ * doubles it.  Once it has run out, requests are let through a token
+ * bucket, which refills more slowly the longer the episode has gone on, and
+ * each admitted request is delayed by a random jitter so the sessions don't
+ * hit the API in lockstep.  Reported successes shorten the backoff again,
+ * and so does time: the level is halved after each quiet period without a
+ * report, so keys whose sessions stopped sending don't stay limited.  Once
+ * it is down to 0 the account and model are back to unlimited admission.
+ *
+ * Must be used from the GUI thread.
+ */
+class KONSOLEPRIVATE_EXPORT RateLimitCoordinator : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Action = std::function<void()>;
+
+    explicit RateLimitCoordinator(QObject *parent = nullptr);
+    ~RateLimitCoordinator() override;
+
+    static RateLimitCoordinator *instance();
+
+    /** The key of the limits shared by @p account using @p model. */
+    static QString keyFor(const QString &account, const QString &model);
+
+    /** Reports a rate limit or overload error seen by @p source. */
+    void reportRateLimit(const QString &key, const QString &source = QString());
+
+    /** Reports a request which went through, see the class description. */
+    void reportSuccess(const QString &key);
+
+    /**
+     * Runs @p action once a request may be sent for @p key.  Without a
+     * rate limit it runs right away and 0 is returned; otherwise it is
+     * queued and the returned ticket can be passed to cancel().  Queued
+     * actions are dropped if @p context is deleted.
+     */
+    quint64 admit(const QString &key, QObject *context, Action action);
+
+    /** Drops the queued action of @p ticket.  Does nothing for 0 or a ticket already run. */
+    void cancel(quint64 ticket);
+
+    /** True while requests for @p key are held back or paced. */
+    bool isLimited(const QString &key) const;
+
+    /** How often the backoff of @p key was doubled; 0 when not limited. */
+    int level(const QString &key) const;
+
+    /** Milliseconds left of the backoff of @p key. */
+    qint64 backoffRemaining(const QString &key) const;
+
+    /** Actions queued for @p key. */
+    int waitingCount(const QString &key) const;
+
+    /** Rate limit reports for @p key in its current episode. */
+    int reportCount(const QString &key) const;
+
+    void setBaseBackoff(int ms)
+    {
+        m_baseBackoffMs = ms;
+    }
+
+    void setRefillInterval(int ms)
+    {
+        m_refillIntervalMs = ms;
+    }
+
+    /** The level halves after @p ms without a report, or the backoff of the level if longer. */
+    void setQuietPeriod(int ms)
+    {
+        m_quietPeriodMs = ms;
+    }
+
+    /** Admitted actions are delayed by up to @p ms; 0 runs them as soon as admitted. */
+    void setJitter(int ms)
+    {
+        m_jitterMs = ms;
+    }
+
+    static constexpr int DefaultBaseBackoffMs = 2000;
+    static constexpr qint64 MaxBackoffMs = 256 * 1000;
+    static constexpr int DefaultRefillIntervalMs = 2000;
+    static constexpr int DefaultJitterMs = 1500;
+    static constexpr int DefaultQuietPeriodMs = 60 * 1000;
+    static constexpr double BucketCapacity = 2;
+
+Q_SIGNALS:
+    /** Emitted when requests for @p key are held back for @p delayMs. */
+    void backoffStarted(const QString &key, int level, qint64 delayMs);
+
+    /** Emitted when @p key is back to unlimited admission. */
+    void recovered(const QString &key);
+
+private:
+    struct Waiter {
+        quint64 ticket = 0;
+        QPointer<QObject> context;
+        Action action;
+    };
+
+    struct Bucket {
+        int level = 0;
+        int reports = 0;
+        qint64 blockedUntil = 0;
+        // When the level is halved next, unless a report comes first
+        qint64 decayAt = 0;
+        double tokens = 0;
+        qint64 lastRefill = 0;
+        QList<Waiter> waiters;
+    };
+
+    qint64 now() const
+    {
+        return m_clock.elapsed();
+    }
+
+    qint64 backoffFor(int level) const;
+    qint64 quietPeriod(int level) const;
+    // Halves the level for every quiet period passed; true if it reached 0
+    bool decay(const QString &key, Bucket &bucket, qint64 now);
+    bool tryAcquire(Bucket &bucket, qint64 now);
+    qint64 nextAdmission(const Bucket &bucket, qint64 now) const;
+    qint64 refillInterval(const Bucket &bucket) const;
+    void run(const Waiter &waiter, bool jitter);
+    void dispatch();
+    void scheduleDispatch();
+
+    QHash<QString, Bucket> m_buckets;
+    QElapsedTimer m_clock;
+    QTimer m_dispatchTimer;
+    quint64 m_nextTicket = 1;
+    int m_baseBackoffMs = DefaultBaseBackoffMs;
+    int m_refillIntervalMs = DefaultRefillIntervalMs;
+    int m_jitterMs = DefaultJitterMs;
+    int m_quietPeriodMs = DefaultQuietPeriodMs;
+};
+
+} // namespace Konsolai
+
+#endif // RATELIMITCOORDINATOR_H
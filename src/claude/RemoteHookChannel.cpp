@@ -0,0 +1,484 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "RemoteHookChannel.h"
+#include "KonsolaiLogging.h"
+
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <utility>
+
+namespace Konsolai
+{
+
+namespace
+{
+// Spool epochs are echoed into the relay command, so only harmless characters
+QString sanitizeEpoch(const QString &epoch)
+{
+    QString result;
+    for (const QChar c : epoch) {
+        if ((c >= QLatin1Char('0') && c <= QLatin1Char('9')) || (c >= QLatin1Char('a') && c <= QLatin1Char('z'))
+            || (c >= QLatin1Char('A') && c <= QLatin1Char('Z')) || c == QLatin1Char('-')) {
+            result.append(c);
+        }
+    }
+    return result;
+}
+}
+
+RemoteHookChannel::RemoteHookChannel(const QString &target, int sshPort, QObject *parent)
+    : QObject(parent)
+    , m_target(target)
+    , m_sshPort(sshPort)
+{
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &RemoteHookChannel::start);
+    m_clock.start();
+}
+
+RemoteHookChannel::~RemoteHookChannel()
+{
+    stop();
+    // Relays still shutting down would otherwise be destroyed while running
+    const auto processes = findChildren<QProcess *>(Qt::FindDirectChildrenOnly);
+    for (QProcess *process : processes) {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished(500);
+        }
+    }
+}
+
+RemoteHookChannel *RemoteHookChannel::forHost(const QString &user, const QString &host, int sshPort)
+{
+    static QHash<QString, QPointer<RemoteHookChannel>> channels;
+
+    const QString target = user.isEmpty() ? host : user + QLatin1Char('@') + host;
+    const QString key = target + QLatin1Char(':') + QString::number(sshPort);
+    QPointer<RemoteHookChannel> &channel = channels[key];
+    if (!channel) {
+        channel = new RemoteHookChannel(target, sshPort);
+        channel->m_shared = true;
+    }
+    return channel;
+}
+
+void RemoteHookChannel::addSession(const QString &sessionId)
+{
+    m_sessions.insert(sessionId);
+    m_removedSessions.remove(sessionId);
+
+    // Events which arrived before the session was restored
+    const QList<HeldEvent> held = std::exchange(m_heldEvents, {});
+    for (const HeldEvent &event : held) {
+        if (event.sessionId == sessionId) {
+            Q_EMIT hookEventReceived(event.sessionId, event.eventType, event.eventData);
+        } else {
+            m_heldEvents.append(event);
+        }
+    }
+    acknowledge();
+
+    if (!m_process && !m_reconnectTimer.isActive()) {
+        start();
+    }
+}
+
+void RemoteHookChannel::removeSession(const QString &sessionId)
+{
+    if (!m_sessions.remove(sessionId)) {
+        return;
+    }
+    m_removedSessions.insert(sessionId);
+    if (!m_sessions.isEmpty()) {
+        return;
+    }
+    stop();
+    if (m_shared) {
+        deleteLater();
+    }
+}
+
+QStringList RemoteHookChannel::sessions() const
+{
+    QStringList result(m_sessions.cbegin(), m_sessions.cend());
+    result.sort();
+    return result;
+}
+
+void RemoteHookChannel::setTransport(const QString &program, const QStringList &arguments)
+{
+    m_program = program;
+    m_arguments = arguments;
+}
+
+void RemoteHookChannel::start()
+{
+    m_stopped = false;
+    m_reconnectTimer.stop();
+    if (m_process) {
+        return;
+    }
+
+    QString program = m_program;
+    QStringList arguments = m_arguments;
+    if (program.isEmpty()) {
+        // No prompts, the channel runs in the background; dead connections are noticed within a minute
+        program = QStringLiteral("ssh");
+        arguments = {QStringLiteral("-T"),
+                     QStringLiteral("-o"),
+                     QStringLiteral("BatchMode=yes"),
+                     QStringLiteral("-o"),
+                     QStringLiteral("ServerAliveInterval=15"),
+                     QStringLiteral("-o"),
+                     QStringLiteral("ServerAliveCountMax=3")};
+        if (m_sshPort != 22 && m_sshPort > 0) {
+            arguments << QStringLiteral("-p") << QString::number(m_sshPort);
+        }
+        arguments << m_target;
+    }
+    arguments << relayCommand();
+
+    m_process = new QProcess(this);
+    m_buffer.clear();
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &RemoteHookChannel::onReadyRead);
+    connect(m_process, &QProcess::readyReadStandardError, this, [this]() {
+        qCDebug(KonsolaiLog) << "RemoteHookChannel:" << m_target << m_process->readAllStandardError().trimmed();
+    });
+    connect(m_process, &QProcess::finished, this, &RemoteHookChannel::onFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // finished() doesn't follow a failed start
+        if (error == QProcess::FailedToStart) {
+            onFinished();
+        }
+    });
+
+    qCDebug(KonsolaiLog) << "RemoteHookChannel: connecting to" << m_target << "after event" << m_lastSequence << "of epoch" << m_epoch;
+    m_process->start(program, arguments);
+}
+
+void RemoteHookChannel::stop()
+{
+    m_stopped = true;
+    m_reconnectTimer.stop();
+    m_reconnectDelayMs = MinReconnectDelayMs;
+    shutDownProcess();
+}
+
+void RemoteHookChannel::shutDownProcess()
+{
+    if (!m_process) {
+        return;
+    }
+
+    QProcess *process = m_process;
+    m_process = nullptr;
+    process->disconnect(this);
+    connect(process, &QProcess::finished, process, &QObject::deleteLater);
+    if (process->state() == QProcess::NotRunning) {
+        process->deleteLater();
+    } else {
+        // Closing stdin ends the relay, the rest is for a stuck ssh
+        process->closeWriteChannel();
+        process->terminate();
+        QTimer::singleShot(3000, process, &QProcess::kill);
+    }
+
+    if (m_connected) {
+        m_connected = false;
+        Q_EMIT disconnected();
+    }
+}
+
+void RemoteHookChannel::onReadyRead()
+{
+    QProcess *process = m_process;
+    m_buffer.append(process->readAllStandardOutput());
+
+    qsizetype start = 0;
+    qsizetype end;
+    while ((end = m_buffer.indexOf('\n', start)) >= 0) {
+        const QByteArray line = m_buffer.mid(start, end - start);
+        start = end + 1;
+        handleLine(line);
+        // A receiver may have removed the last session
+        if (m_process != process) {
+            return;
+        }
+    }
+    m_buffer.remove(0, start);
+
+    // One acknowledgement per batch lets the relay drop everything received
+    acknowledge();
+}
+
+void RemoteHookChannel::acknowledge()
+{
+    // Sessions which don't turn up in time aren't waited for forever
+    const qint64 now = m_clock.elapsed();
+    while (!m_heldEvents.isEmpty() && now - m_heldEvents.first().receivedMs > HoldEventsMs) {
+        qCDebug(KonsolaiLog) << "RemoteHookChannel: dropping a" << m_heldEvents.first().eventType << "event of unknown session" << m_heldEvents.first().sessionId
+                             << "from" << m_target;
+        m_heldEvents.removeFirst();
+    }
+
+    quint64 sequence = m_lastSequence;
+    for (const HeldEvent &event : std::as_const(m_heldEvents)) {
+        if (event.sequence > 0) {
+            sequence = std::min(sequence, event.sequence - 1);
+            break;
+        }
+    }
+    if (m_process && sequence > m_acknowledged) {
+        m_acknowledged = sequence;
+        m_process->write("ack " + QByteArray::number(m_acknowledged) + '\n');
+    }
+}
+
+void RemoteHookChannel::handleLine(const QByteArray &line)
+{
+    QJsonParseError error;
+    const QJsonObject obj = QJsonDocument::fromJson(line, &error).object();
+
+    if (error.error == QJsonParseError::NoError && obj.contains(QStringLiteral("hello"))) {
+        const QString epoch = sanitizeEpoch(obj.value(QStringLiteral("epoch")).toString());
+        if (epoch != m_epoch) {
+            if (!m_epoch.isEmpty()) {
+                qCDebug(KonsolaiLog) << "RemoteHookChannel: spool on" << m_target << "was recreated, epoch" << epoch;
+            }
+            m_epoch = epoch;
+            m_lastSequence = 0;
+            m_acknowledged = 0;
+            for (HeldEvent &event : m_heldEvents) {
+                event.sequence = 0;
+            }
+        }
+        m_reconnectDelayMs = MinReconnectDelayMs;
+        m_connected = true;
+        qCDebug(KonsolaiLog) << "RemoteHookChannel: connected to" << m_target;
+        Q_EMIT connected();
+        return;
+    }
+
+    quint64 sequence = 0;
+    if (error.error == QJsonParseError::NoError) {
+        sequence = quint64(obj.value(QStringLiteral("seq")).toInteger());
+    } else {
+        // Hook data which isn't JSON still takes up its sequence number
+        static const QRegularExpression sequenceRx(QStringLiteral("^\\{\"seq\":(\\d+),"));
+        const QRegularExpressionMatch match = sequenceRx.match(QString::fromUtf8(line));
+        if (match.hasMatch()) {
+            sequence = match.captured(1).toULongLong();
+        }
+        qCDebug(KonsolaiLog) << "RemoteHookChannel: malformed event from" << m_target << error.errorString();
+    }
+
+    // Already received before the connection dropped
+    if (sequence == 0 || sequence <= m_lastSequence) {
+        return;
+    }
+    if (m_lastSequence > 0 && sequence > m_lastSequence + 1) {
+        const quint64 lost = sequence - m_lastSequence - 1;
+        qCWarning(KonsolaiLog) << "RemoteHookChannel: the spool on" << m_target << "overflowed," << lost << "hook events lost";
+        Q_EMIT eventsLost(lost);
+    }
+    m_lastSequence = sequence;
+
+    if (error.error != QJsonParseError::NoError) {
+        return;
+    }
+    const QString sessionId = obj.value(QStringLiteral("session")).toString();
+    if (m_removedSessions.contains(sessionId)) {
+        return;
+    }
+    const QString eventType = obj.value(QStringLiteral("event_type")).toString();
+    const QJsonValue data = obj.value(QStringLiteral("data"));
+    const QString eventData = data.isObject() ? QString::fromUtf8(QJsonDocument(data.toObject()).toJson(QJsonDocument::Compact)) : QString();
+    if (!m_sessions.contains(sessionId)) {
+        // Its session may not be restored yet
+        m_heldEvents.append({sequence, sessionId, eventType, eventData, m_clock.elapsed()});
+        if (m_heldEvents.size() > MaxSpoolEvents) {
+            m_heldEvents.removeFirst();
+        }
+        return;
+    }
+    Q_EMIT hookEventReceived(sessionId, eventType, eventData);
+}
+
+void RemoteHookChannel::onFinished()
+{
+    if (!m_process) {
+        return;
+    }
+    qCDebug(KonsolaiLog) << "RemoteHookChannel: connection to" << m_target << "closed:" << m_process->exitCode();
+    m_process->disconnect(this);
+    m_process->deleteLater();
+    m_process = nullptr;
+    m_buffer.clear();
+
+    if (m_connected) {
+        m_connected = false;
+        Q_EMIT disconnected();
+    }
+    if (!m_stopped && !m_sessions.isEmpty()) {
+        scheduleReconnect();
+    }
+}
+
+void RemoteHookChannel::scheduleReconnect()
+{
+    m_reconnectTimer.start(m_reconnectDelayMs);
+    m_reconnectDelayMs = std::min(m_reconnectDelayMs * 2, MaxReconnectDelayMs);
+}
+
+QString RemoteHookChannel::hookScriptPath()
+{
+    return QStringLiteral("$HOME/.konsolai/hooks/hook.sh");
+}
+
+QString RemoteHookChannel::hookScript(int maxSpoolEvents)
+{
+    return QStringLiteral(R"(#!/bin/bash
+# Konsolai hook spool - queues hook events for the Konsolai relay
+# Usage: hook.sh --session <id> --event <event_type>, hook data on stdin
+
+DIR="${KONSOLAI_HOOK_DIR:-$HOME/.konsolai/hooks}"
+MAX_EVENTS=%1
+SESSION=""
+EVENT_TYPE=""
+
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --session)
+            SESSION="$2"
+            shift 2
+            ;;
+        --event)
+            EVENT_TYPE="$2"
+            shift 2
+            ;;
+        *)
+            shift
+            ;;
+    esac
+done
+
+# Quoted into the JSON line below, so only harmless characters
+SESSION=$(printf '%s' "$SESSION" | tr -cd 'A-Za-z0-9_.-')
+EVENT_TYPE=$(printf '%s' "$EVENT_TYPE" | tr -cd 'A-Za-z0-9_.-')
+if [[ -z "$SESSION" || -z "$EVENT_TYPE" ]]; then
+    exit 0  # Always exit 0 to not break Claude
+fi
+
+# One event per line
+HOOK_DATA=$(tr -d '\r\n')
+[[ -z "$HOOK_DATA" ]] && HOOK_DATA='{}'
+
+mkdir -p "$DIR" 2>/dev/null || exit 0
+{
+    command -v flock &>/dev/null && flock 9
+    [[ -s "$DIR/epoch" ]] || echo "$(date +%s)-$$" > "$DIR/epoch"
+    SEQ=$(cat "$DIR/seq" 2>/dev/null)
+    SEQ=$(( ${SEQ:-0} + 1 ))
+    echo "$SEQ" > "$DIR/seq"
+    printf '{"seq":%s,"session":"%s","event_type":"%s","data":%s}\n' "$SEQ" "$SESSION" "$EVENT_TYPE" "$HOOK_DATA" >> "$DIR/spool"
+    # Bounded while nobody drains it, the relay reports what was dropped
+    if (( $(wc -l < "$DIR/spool") > MAX_EVENTS )); then
+        tail -n "$MAX_EVENTS" "$DIR/spool" > "$DIR/spool.tmp" && mv -f "$DIR/spool.tmp" "$DIR/spool"
+    fi
+} 9>>"$DIR/lock" 2>/dev/null
+
+# Always exit 0 to not break Claude
+exit 0
+)").arg(maxSpoolEvents);
+}
+
+QString RemoteHookChannel::relayScript()
+{
+    return QStringLiteral(R"(#!/bin/bash
+# Konsolai hook relay - streams spooled hook events to Konsolai
+# Usage: relay.sh <epoch> <last sequence received>
+# Writes the events after the last one received to stdout and drops the
+# ones acknowledged with "ack <sequence>" lines on stdin.
+
+DIR="${KONSOLAI_HOOK_DIR:-$HOME/.konsolai/hooks}"
+LAST="$2"
+[[ "$LAST" =~ ^[0-9]+$ ]] || LAST=0
+
+locked() {
+    command -v flock &>/dev/null && flock "$1" 9
+    return 0
+}
+
+mkdir -p "$DIR" || exit 1
+{
+    locked -x
+    [[ -s "$DIR/epoch" ]] || echo "$(date +%s)-$$" > "$DIR/epoch"
+    touch "$DIR/spool"
+} 9>>"$DIR/lock"
+
+EPOCH=$(tr -cd '0-9A-Za-z-' < "$DIR/epoch")
+# A new spool starts counting again
+[[ "$EPOCH" == "$1" ]] || LAST=0
+printf '{"hello":1,"epoch":"%s"}\n' "$EPOCH"
+
+(
+    while read -r COMMAND SEQ; do
+        [[ "$COMMAND" == ack && "$SEQ" =~ ^[0-9]+$ ]] || continue
+        {
+            locked -x
+            awk -v n="$SEQ" 'match($0, /^[{]"seq":[0-9]+/) && substr($0, 8, RLENGTH - 7) + 0 <= n { next } { print }' "$DIR/spool" > "$DIR/spool.ack" \
+                && mv -f "$DIR/spool.ack" "$DIR/spool"
+        } 9>>"$DIR/lock"
+    done
+    # Konsolai went away
+    kill $$ 2>/dev/null
+) <&0 &
+
+while true; do
+    BATCH=$({
+        locked -s
+        awk -v n="$LAST" 'match($0, /^[{]"seq":[0-9]+/) && substr($0, 8, RLENGTH - 7) + 0 > n' "$DIR/spool"
+    } 9>>"$DIR/lock")
+    if [[ -n "$BATCH" ]]; then
+        printf '%s\n' "$BATCH" || exit 0
+        LAST=$(printf '%s\n' "$BATCH" | tail -n 1 | sed 's/^{"seq":\([0-9]*\).*/\1/')
+    elif command -v inotifywait &>/dev/null; then
+        inotifywait -qq -t 1 -e close_write,moved_to "$DIR" &>/dev/null
+    else
+        sleep 0.25
+    fi
+done
+)");
+}
+
+QString RemoteHookChannel::installHookScriptCommand()
+{
+    // Written next to the old one and moved over it, hooks may run meanwhile
+    return QStringLiteral(
+               "mkdir -p \"$HOME/.konsolai/hooks\" && "
+               "cat > \"$HOME/.konsolai/hooks/hook.sh.$$\" << 'KONSOLAI_HOOK_EOF'\n%1KONSOLAI_HOOK_EOF\n"
+               "chmod +x \"$HOME/.konsolai/hooks/hook.sh.$$\" && mv -f \"$HOME/.konsolai/hooks/hook.sh.$$\" \"%2\"")
+        .arg(hookScript(), hookScriptPath());
+}
+
+QString RemoteHookChannel::relayCommand() const
+{
+    return QStringLiteral(
+               "D=\"${KONSOLAI_HOOK_DIR:-$HOME/.konsolai/hooks}\"; mkdir -p \"$D\" && "
+               "cat > \"$D/relay.sh.$$\" << 'KONSOLAI_RELAY_EOF'\n%1KONSOLAI_RELAY_EOF\n"
+               "mv -f \"$D/relay.sh.$$\" \"$D/relay.sh\" && exec bash \"$D/relay.sh\" '%2' %3")
+        .arg(relayScript(), m_epoch, QString::number(m_lastSequence));
+}
+
+} // namespace Konsolai
+
+#include "moc_RemoteHookChannel.cpp"
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef REMOTEHOOKCHANNEL_H
+#define REMOTEHOOKCHANNEL_H
+
+#include "konsoleprivate_export.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+namespace Konsolai
+{
+
+/**
+ * Carries the hook events of all Claude sessions on one remote host.
+ *
+ * On the remote host, the hook script of every session appends its events
+ * to one spool file, each with a sequence number, and keeps the spool to
+ * at most MaxSpoolEvents events.  The channel runs a single ssh connection
+ * per host to a relay script, which streams the spooled events after the
+ * last one received, in batches of whatever accumulated, and drops the
+ * events the channel acknowledges.
+ *
+ * When the connection drops, events keep being spooled.  The channel
+ * reconnects with backoff and the relay continues after the last event
+ * received, so nothing is lost or delivered twice unless the spool
+ * overflowed meanwhile, which eventsLost() reports.  The spool carries an
+ * epoch, so a spool recreated on the remote restarts the count instead of
+ * being mistaken for events already seen.
+ *
+ * Sessions register with addSession() and get their events through
+ * hookEventReceived(); ClaudeHookHandler does so in Relay mode.  Events of
+ * sessions which aren't registered yet, as while sessions are restored one
+ * after the other, are held back and delivered once they are.  Held events
+ * are not acknowledged, so they stay in the spool, for at most
+ * HoldEventsMs; events of sessions removed meanwhile are dropped.
+ */
+class KONSOLEPRIVATE_EXPORT RemoteHookChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @p target is "host" or "user@host" as passed to ssh. */
+    explicit RemoteHookChannel(const QString &target, int sshPort = 22, QObject *parent = nullptr);
+    ~RemoteHookChannel() override;
+
+    /**
+     * The channel shared by all sessions of @p user on @p host.  It is
+     * deleted once its last session has been removed.
+     */
+    static RemoteHookChannel *forHost(const QString &user, const QString &host, int sshPort = 22);
+
+    QString target() const
+    {
+        return m_target;
+    }
+
+    /** Delivers the events of @p sessionId from now on, connecting if needed. */
+    void addSession(const QString &sessionId);
+
+    /** Stops delivering the events of @p sessionId; disconnects after the last one. */
+    void removeSession(const QString &sessionId);
+
+    QStringList sessions() const;
+
+    /**
+     * Runs @p program with @p arguments and the relay command appended
+     * instead of ssh.  For tests.
+     */
+    void setTransport(const QString &program, const QStringList &arguments);
+
+    /** Connects to the relay unless connected. */
+    void start();
+
+    /** Disconnects and stops reconnecting. */
+    void stop();
+
+    bool isConnected() const
+    {
+        return m_connected;
+    }
+
+    /** Sequence number of the last event received. */
+    quint64 lastSequence() const
+    {
+        return m_lastSequence;
+    }
+
+    /** The remote spool's epoch, empty before the first connection. */
+    QString epoch() const
+    {
+        return m_epoch;
+    }
+
+    /** The script sessions call from their hooks, see hookScriptPath(). */
+    static QString hookScript(int maxSpoolEvents = MaxSpoolEvents);
+
+    /** The script the channel connects to. */
+    static QString relayScript();
+
+    /** Where the hook script is installed on the remote host, for hook commands. */
+    static QString hookScriptPath();
+
+    /** Shell command installing the hook script on the remote host. */
+    static QString installHookScriptCommand();
+
+    /** Shell command installing and starting the relay, continuing after the last event received. */
+    QString relayCommand() const;
+
+    static constexpr int MaxSpoolEvents = 10000;
+    static constexpr int MinReconnectDelayMs = 1000;
+    static constexpr int MaxReconnectDelayMs = 30000;
+    static constexpr int HoldEventsMs = 10 * 60 * 1000;
+
+Q_SIGNALS:
+    void hookEventReceived(const QString &sessionId, const QString &eventType, const QString &eventData);
+
+    void connected();
+    void disconnected();
+
+    /** Emitted when the spool overflowed while disconnected and @p count events were dropped. */
+    void eventsLost(quint64 count);
+
+private:
+    struct HeldEvent {
+        // 0 once the spool it came from was recreated
+        quint64 sequence = 0;
+        QString sessionId;
+        QString eventType;
+        QString eventData;
+        qint64 receivedMs = 0;
+    };
+
+    void onReadyRead();
+    // Acknowledges the events received up to the first one held back
+    void acknowledge();
+    void onFinished();
+    void handleLine(const QByteArray &line);
+    void scheduleReconnect();
+    void shutDownProcess();
+
+    QString m_target;
+    int m_sshPort = 22;
+    QString m_program;
+    QStringList m_arguments;
+    QProcess *m_process = nullptr;
+    QByteArray m_buffer;
+    QSet<QString> m_sessions;
+    QSet<QString> m_removedSessions;
+    QList<HeldEvent> m_heldEvents;
+    QElapsedTimer m_clock;
+    QString m_epoch;
+    quint64 m_lastSequence = 0;
+    quint64 m_acknowledged = 0;
+    bool m_connected = false;
+    bool m_stopped = true;
+    bool m_shared = false;
+    QTimer m_reconnectTimer;
+    int m_reconnectDelayMs = MinReconnectDelayMs;
+};
+
+} // namespace Konsolai
+
+#endif // REMOTEHOOKCHANNEL_H
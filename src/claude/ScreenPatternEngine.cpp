@@ -0,0 +1,593 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ScreenPatternEngine.h"
+#include "KonsolaiLogging.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace Konsolai
+{
+
+namespace
+{
+// Keywords match case-insensitively; ASCII, by far the most common, is
+// folded without a table lookup
+inline char16_t fold(char16_t c)
+{
+    if (c < 0x80) {
+        return (c >= u'A' && c <= u'Z') ? char16_t(c + 0x20) : c;
+    }
+    return QChar(c).toCaseFolded().unicode();
+}
+
+inline bool isBlank(char16_t c)
+{
+    return c == u' ' || c == u'\t' || c == u'\r' || (c >= 0x80 && QChar::isSpace(c));
+}
+
+struct LinePattern {
+    quint64 all = 0; // every keyword must be on the line
+    quint64 any = 0; // at least one of these, if there are any
+    quint64 none = 0; // none of these
+    quint32 is = 0; // the line must be of all these classes
+    quint32 notAdjacent = 0; // neither neighbour may be of any of these classes
+
+    bool matchesLine(quint64 keywords, quint32 classes) const
+    {
+        return (keywords & all) == all && (!any || (keywords & any)) && !(keywords & none) && (classes & is) == is;
+    }
+};
+
+struct LineClass {
+    char16_t character = 0;
+    int minLength = 0;
+    double minRatio = 0;
+};
+
+struct SignalRule {
+    ScreenPatternEngine::Signal signal = ScreenPatternEngine::NoSignal;
+    int tailLines = 1;
+    std::vector<LinePattern> lines;
+    std::vector<LinePattern> vetoes;
+    bool anchored = false;
+    QStringList lastEquals;
+    QStringList lastStartsWith;
+    QStringList lastEndsWith;
+};
+
+// What the scan found out about one line
+struct LineInfo {
+    quint64 keywords = 0;
+    quint32 classes = 0;
+    QStringView trimmed;
+};
+
+const QHash<QString, ScreenPatternEngine::Signal> &signalNames()
+{
+    static const QHash<QString, ScreenPatternEngine::Signal> names = {
+        {QStringLiteral("permissionPrompt"), ScreenPatternEngine::PermissionPrompt},
+        {QStringLiteral("idlePrompt"), ScreenPatternEngine::IdlePrompt},
+        {QStringLiteral("rateLimit"), ScreenPatternEngine::RateLimit},
+    };
+    return names;
+}
+}
+
+struct ScreenPatternEngine::Rules {
+    // Aho-Corasick automaton over case folded UTF-16
+    struct Node {
+        std::vector<std::pair<char16_t, int>> edges; // sorted by character
+        int fail = 0;
+        quint64 output = 0; // keywords ending here, including through fail links
+    };
+
+    std::vector<Node> nodes{Node()};
+    QHash<QString, int> keywords; // folded keyword -> bit
+    std::vector<LineClass> classes;
+    QHash<QString, int> classNames;
+    std::vector<SignalRule> signalRules;
+    int window = 0;
+
+    int child(int node, char16_t c) const
+    {
+        const auto &edges = nodes[node].edges;
+        auto it = std::lower_bound(edges.begin(), edges.end(), c, [](const std::pair<char16_t, int> &edge, char16_t ch) {
+            return edge.first < ch;
+        });
+        return (it != edges.end() && it->first == c) ? it->second : -1;
+    }
+
+    int step(int node, char16_t c) const
+    {
+        for (;;) {
+            const int next = child(node, c);
+            if (next >= 0) {
+                return next;
+            }
+            if (node == 0) {
+                return 0;
+            }
+            node = nodes[node].fail;
+        }
+    }
+
+    int addKeyword(const QString &keyword, QString *error);
+    bool parsePattern(const QJsonValue &value, LinePattern &pattern, QString *error);
+    void link();
+};
+
+int ScreenPatternEngine::Rules::addKeyword(const QString &keyword, QString *error)
+{
+    QString folded;
+    folded.reserve(keyword.size());
+    for (QChar c : keyword) {
+        folded.append(QChar(fold(c.unicode())));
+    }
+    if (folded.isEmpty()) {
+        *error = QStringLiteral("empty keyword");
+        return -1;
+    }
+    auto it = keywords.constFind(folded);
+    if (it != keywords.constEnd()) {
+        return it.value();
+    }
+    if (keywords.size() >= MaxKeywords) {
+        *error = QStringLiteral("more than %1 keywords").arg(MaxKeywords);
+        return -1;
+    }
+
+    const int bit = int(keywords.size());
+    keywords.insert(folded, bit);
+
+    int node = 0;
+    for (QChar c : folded) {
+        int next = child(node, c.unicode());
+        if (next < 0) {
+            next = int(nodes.size());
+            nodes.emplace_back();
+            auto &edges = nodes[node].edges;
+            const std::pair<char16_t, int> edge(c.unicode(), next);
+            edges.insert(std::upper_bound(edges.begin(), edges.end(), edge), edge);
+        }
+        node = next;
+    }
+    nodes[node].output |= quint64(1) << bit;
+    return bit;
+}
+
+void ScreenPatternEngine::Rules::link()
+{
+    std::queue<int> queue;
+    for (const auto &edge : nodes[0].edges) {
+        nodes[edge.second].fail = 0;
+        queue.push(edge.second);
+    }
+    while (!queue.empty()) {
+        const int node = queue.front();
+        queue.pop();
+        for (const auto &edge : nodes[node].edges) {
+            const int next = edge.second;
+            int fail = nodes[node].fail;
+            int target = child(fail, edge.first);
+            while (target < 0 && fail != 0) {
+                fail = nodes[fail].fail;
+                target = child(fail, edge.first);
+            }
+            nodes[next].fail = target >= 0 ? target : 0;
+            nodes[next].output |= nodes[nodes[next].fail].output;
+            queue.push(next);
+        }
+    }
+}
+
+bool ScreenPatternEngine::Rules::parsePattern(const QJsonValue &value, LinePattern &pattern, QString *error)
+{
+    if (!value.isObject()) {
+        *error = QStringLiteral("a line pattern must be an object");
+        return false;
+    }
+    const QJsonObject object = value.toObject();
+
+    auto keywordMask = [this, &object, error](const QString &key, quint64 &mask) {
+        const QJsonArray array = object.value(key).toArray();
+        for (const QJsonValue &keyword : array) {
+            const int bit = addKeyword(keyword.toString(), error);
+            if (bit < 0) {
+                return false;
+            }
+            mask |= quint64(1) << bit;
+        }
+        return true;
+    };
+    auto classMask = [this, &object, error](const QString &key, quint32 &mask) {
+        const QJsonArray array = object.value(key).toArray();
+        for (const QJsonValue &name : array) {
+            auto it = classNames.constFind(name.toString());
+            if (it == classNames.constEnd()) {
+                *error = QStringLiteral("unknown line class \"%1\"").arg(name.toString());
+                return false;
+            }
+            mask |= quint32(1) << it.value();
+        }
+        return true;
+    };
+
+    return keywordMask(QStringLiteral("all"), pattern.all) && keywordMask(QStringLiteral("any"), pattern.any)
+        && keywordMask(QStringLiteral("none"), pattern.none) && classMask(QStringLiteral("is"), pattern.is)
+        && classMask(QStringLiteral("notAdjacent"), pattern.notAdjacent);
+}
+
+ScreenPatternEngine::ScreenPatternEngine(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &ScreenPatternEngine::reloadWatched);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ScreenPatternEngine::reloadWatched);
+}
+
+ScreenPatternEngine::~ScreenPatternEngine() = default;
+
+ScreenPatternEngine *ScreenPatternEngine::instance()
+{
+    static ScreenPatternEngine *engine = [] {
+        auto *e = new ScreenPatternEngine();
+        e->watchFile(userRulesPath());
+        return e;
+    }();
+    return engine;
+}
+
+QString ScreenPatternEngine::userRulesPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/konsolai/screen-patterns.json");
+}
+
+bool ScreenPatternEngine::loadRules(const QByteArray &json, QString *error)
+{
+    QString message;
+    if (!error) {
+        error = &message;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        *error = parseError.error != QJsonParseError::NoError ? parseError.errorString() : QStringLiteral("not a JSON object");
+        return false;
+    }
+    const QJsonObject root = document.object();
+
+    auto rules = std::make_shared<Rules>();
+
+    const QJsonObject classes = root.value(QStringLiteral("lineClasses")).toObject();
+    for (auto it = classes.constBegin(); it != classes.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        const QString character = object.value(QStringLiteral("char")).toString();
+        if (character.size() != 1) {
+            *error = QStringLiteral("line class \"%1\" needs a single \"char\"").arg(it.key());
+            return false;
+        }
+        if (rules->classes.size() >= 32) {
+            *error = QStringLiteral("more than 32 line classes");
+            return false;
+        }
+        LineClass lineClass;
+        lineClass.character = character.at(0).unicode();
+        lineClass.minLength = object.value(QStringLiteral("minLength")).toInt(1);
+        lineClass.minRatio = object.value(QStringLiteral("minRatio")).toDouble(1.0);
+        rules->classNames.insert(it.key(), int(rules->classes.size()));
+        rules->classes.push_back(lineClass);
+    }
+
+    const QJsonObject signalObjects = root.value(QStringLiteral("signals")).toObject();
+    for (auto it = signalObjects.constBegin(); it != signalObjects.constEnd(); ++it) {
+        const auto name = signalNames().constFind(it.key());
+        if (name == signalNames().constEnd()) {
+            // Rules written for a newer version may know more signals
+            qCDebug(KonsolaiLog) << "ScreenPatternEngine: ignoring unknown signal" << it.key();
+            continue;
+        }
+        const QJsonObject object = it.value().toObject();
+
+        SignalRule rule;
+        rule.signal = name.value();
+        rule.tailLines = object.value(QStringLiteral("tailLines")).toInt(0);
+        if (rule.tailLines < 1) {
+            *error = QStringLiteral("signal \"%1\" needs a positive \"tailLines\"").arg(it.key());
+            return false;
+        }
+        for (const QJsonValue &value : object.value(QStringLiteral("lines")).toArray()) {
+            LinePattern pattern;
+            if (!rules->parsePattern(value, pattern, error)) {
+                return false;
+            }
+            rule.lines.push_back(pattern);
+        }
+        for (const QJsonValue &value : object.value(QStringLiteral("veto")).toArray()) {
+            LinePattern pattern;
+            if (!rules->parsePattern(value, pattern, error)) {
+                return false;
+            }
+            rule.vetoes.push_back(pattern);
+        }
+        if (object.contains(QStringLiteral("lastLine"))) {
+            const QJsonObject anchor = object.value(QStringLiteral("lastLine")).toObject();
+            rule.anchored = true;
+            for (const QJsonValue &value : anchor.value(QStringLiteral("equals")).toArray()) {
+                rule.lastEquals.append(value.toString());
+            }
+            for (const QJsonValue &value : anchor.value(QStringLiteral("startsWith")).toArray()) {
+                rule.lastStartsWith.append(value.toString());
+            }
+            for (const QJsonValue &value : anchor.value(QStringLiteral("endsWith")).toArray()) {
+                rule.lastEndsWith.append(value.toString());
+            }
+        }
+        if (rule.lines.empty() && !rule.anchored) {
+            *error = QStringLiteral("signal \"%1\" has neither \"lines\" nor \"lastLine\"").arg(it.key());
+            return false;
+        }
+
+        // One line above the window, for the adjacency constraints of its first line
+        rules->window = std::max(rules->window, rule.tailLines + 1);
+        rules->signalRules.push_back(std::move(rule));
+    }
+
+    rules->link();
+    m_rules = std::move(rules);
+
+    qCDebug(KonsolaiLog) << "ScreenPatternEngine: compiled" << m_rules->signalRules.size() << "signals," << m_rules->keywords.size() << "keywords into"
+                         << m_rules->nodes.size() << "states";
+    Q_EMIT rulesReloaded();
+    return true;
+}
+
+bool ScreenPatternEngine::loadFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return loadRules(file.readAll(), error);
+}
+
+bool ScreenPatternEngine::loadDefaultRules()
+{
+    QString error;
+    if (!loadFile(QString::fromLatin1(DefaultRulesResource), &error)) {
+        qCWarning(KonsolaiLog) << "ScreenPatternEngine: failed to load the built-in rules:" << error;
+        return false;
+    }
+    return true;
+}
+
+void ScreenPatternEngine::watchFile(const QString &path)
+{
+    if (!m_watcher.files().isEmpty()) {
+        m_watcher.removePaths(m_watcher.files());
+    }
+    if (!m_watcher.directories().isEmpty()) {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+    m_watchedPath = path;
+    m_watchedContent.clear();
+
+    // Editors tend to replace the file rather than write it, which ends a
+    // watch on the file; the directory tells when it is back
+    const QString directory = QFileInfo(path).absolutePath();
+    if (QFileInfo::exists(directory)) {
+        m_watcher.addPath(directory);
+    }
+
+    if (!m_rules || !QFileInfo::exists(path)) {
+        loadDefaultRules();
+    }
+    reloadWatched();
+}
+
+void ScreenPatternEngine::reloadWatched()
+{
+    if (m_watchedPath.isEmpty()) {
+        return;
+    }
+
+    QFile file(m_watchedPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Removed: back to the built-in rules
+        if (!m_watchedContent.isEmpty()) {
+            m_watchedContent.clear();
+            qCDebug(KonsolaiLog) << "ScreenPatternEngine:" << m_watchedPath << "is gone, using the built-in rules";
+            loadDefaultRules();
+        }
+        return;
+    }
+    if (!m_watcher.files().contains(m_watchedPath)) {
+        m_watcher.addPath(m_watchedPath);
+    }
+
+    // The directory also changes for every other file in it
+    const QByteArray content = file.readAll();
+    if (content == m_watchedContent) {
+        return;
+    }
+    m_watchedContent = content;
+
+    QString error;
+    if (!loadRules(content, &error)) {
+        qCWarning(KonsolaiLog) << "ScreenPatternEngine: keeping the previous rules," << m_watchedPath << "is invalid:" << error;
+    }
+}
+
+int ScreenPatternEngine::keywordCount() const
+{
+    return m_rules ? int(m_rules->keywords.size()) : 0;
+}
+
+int ScreenPatternEngine::windowLines() const
+{
+    return m_rules ? m_rules->window : 0;
+}
+
+ScreenPatternEngine::Signals ScreenPatternEngine::scan(QStringView screen) const
+{
+    const Rules *rules = m_rules.get();
+    if (!rules || rules->signalRules.empty()) {
+        return NoSignal;
+    }
+
+    // Blank rows below the last output are not part of the UI
+    const char16_t *data = screen.utf16();
+    qsizetype end = screen.size();
+    while (end > 0 && (data[end - 1] == u'\n' || isBlank(data[end - 1]))) {
+        --end;
+    }
+    if (end == 0) {
+        return NoSignal;
+    }
+
+    // Start of the bottom window lines, like split('\n') would count them
+    qsizetype start = 0;
+    qsizetype pos = end;
+    for (int i = 0; i < rules->window; ++i) {
+        const qsizetype newline = pos > 0 ? screen.lastIndexOf(u'\n', pos - 1) : -1;
+        if (newline < 0) {
+            start = 0;
+            break;
+        }
+        start = newline + 1;
+        pos = newline;
+    }
+
+    // The single pass: keywords, line classes and trimmed text of every line
+    const qsizetype size = end;
+    const size_t classCount = rules->classes.size();
+    QVarLengthArray<LineInfo, 16> lines;
+    QVarLengthArray<int, 4> classHits(qsizetype(classCount));
+    std::fill(classHits.begin(), classHits.end(), 0);
+
+    qsizetype first = -1;
+    qsizetype last = -1;
+    int state = 0;
+    LineInfo info;
+    for (qsizetype i = start; i <= size; ++i) {
+        if (i == size || data[i] == u'\n') {
+            if (first >= 0) {
+                info.trimmed = screen.sliced(first, last - first + 1);
+                const qsizetype length = info.trimmed.size();
+                for (size_t c = 0; c < classCount; ++c) {
+                    const LineClass &lineClass = rules->classes[c];
+                    if (length >= lineClass.minLength && classHits[c] > length * lineClass.minRatio) {
+                        info.classes |= quint32(1) << c;
+                    }
+                }
+            }
+            lines.append(info);
+
+            info = LineInfo();
+            std::fill(classHits.begin(), classHits.end(), 0);
+            first = last = -1;
+            state = 0;
+            continue;
+        }
+
+        const char16_t c = data[i];
+        state = rules->step(state, fold(c));
+        info.keywords |= rules->nodes[state].output;
+        if (!isBlank(c)) {
+            if (first < 0) {
+                first = i;
+            }
+            last = i;
+            for (size_t k = 0; k < classCount; ++k) {
+                if (rules->classes[k].character == c) {
+                    ++classHits[k];
+                }
+            }
+        }
+    }
+
+    const int lineCount = int(lines.size());
+    auto matches = [&lines, lineCount](const LinePattern &pattern, int i) {
+        const LineInfo &line = lines[i];
+        if (!pattern.matchesLine(line.keywords, line.classes)) {
+            return false;
+        }
+        if (pattern.notAdjacent) {
+            if ((i > 0 && (lines[i - 1].classes & pattern.notAdjacent)) || (i + 1 < lineCount && (lines[i + 1].classes & pattern.notAdjacent))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Signals found;
+    for (const SignalRule &rule : rules->signalRules) {
+        const int from = std::max(0, lineCount - rule.tailLines);
+
+        bool vetoed = false;
+        bool matched = rule.lines.empty();
+        QStringView lastNonEmpty;
+        for (int i = from; i < lineCount && !vetoed; ++i) {
+            for (const LinePattern &veto : rule.vetoes) {
+                if (matches(veto, i)) {
+                    vetoed = true;
+                    break;
+                }
+            }
+            for (size_t p = 0; !matched && p < rule.lines.size(); ++p) {
+                matched = matches(rule.lines[p], i);
+            }
+            if (!lines[i].trimmed.isEmpty()) {
+                lastNonEmpty = lines[i].trimmed;
+            }
+        }
+        if (vetoed || !matched) {
+            continue;
+        }
+
+        if (rule.anchored) {
+            if (lastNonEmpty.isEmpty()) {
+                continue;
+            }
+            const bool anchorMatches = std::any_of(rule.lastEquals.cbegin(),
+                                                   rule.lastEquals.cend(),
+                                                   [lastNonEmpty](const QString &text) {
+                                                       return lastNonEmpty == text;
+                                                   })
+                || std::any_of(rule.lastStartsWith.cbegin(),
+                               rule.lastStartsWith.cend(),
+                               [lastNonEmpty](const QString &text) {
+                                   return lastNonEmpty.startsWith(text);
+                               })
+                || std::any_of(rule.lastEndsWith.cbegin(), rule.lastEndsWith.cend(), [lastNonEmpty](const QString &text) {
+                       return lastNonEmpty.endsWith(text);
+                   });
+            if (!anchorMatches) {
+                continue;
+            }
+        }
+        found |= rule.signal;
+    }
+    return found;
+}
+
+} // namespace Konsolai
+
+#include "moc_ScreenPatternEngine.cpp"
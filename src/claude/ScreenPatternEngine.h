@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SCREENPATTERNENGINE_H
+#define SCREENPATTERNENGINE_H
+
+#include "konsoleprivate_export.h"
+
+#include <QByteArray>
+#include <QFileSystemWatcher>
+#include <QFlags>
+#include <QObject>
+#include <QString>
+#include <QStringView>
+
+#include <memory>
+
+namespace Konsolai
+{
+
+/**
+ * Recognizes what Claude Code's terminal UI is showing from a capture of
+ * the screen: a permission prompt, the idle input prompt or a rate limit
+ * error.
+ *
+ * The patterns are not hard-coded but read from a rules file, so a change
+ * of Claude Code's UI only needs a change of the rules.  The built-in rules
+ * ship as a resource; a file at userRulesPath() replaces them and is
+ * reloaded whenever it changes.  A file which does not parse is reported
+ * and the rules in use are kept.
+ *
+ * Every signal is made of line patterns over case-insensitive keywords,
+ * constraints on the lines next to a match (e.g. not between the
+ * horizontal rules of the input box), vetoes and anchors on the last
+ * non-empty line, each looking at some number of lines at the bottom of
+ * the screen.  All keywords of all signals are compiled into one
+ * Aho-Corasick automaton, and scan() classifies the screen with a single
+ * pass over its bottom lines.
+ */
+class KONSOLEPRIVATE_EXPORT ScreenPatternEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Signal {
+        NoSignal = 0,
+        PermissionPrompt = 1 << 0,
+        IdlePrompt = 1 << 1,
+        RateLimit = 1 << 2,
+    };
+    Q_DECLARE_FLAGS(Signals, Signal)
+    Q_FLAG(Signals)
+
+    /** An engine without rules; scan() finds nothing until rules are loaded. */
+    explicit ScreenPatternEngine(QObject *parent = nullptr);
+    ~ScreenPatternEngine() override;
+
+    /**
+     * The engine used by the sessions.  It starts with the built-in rules,
+     * or the user's if they exist, and follows changes of the user's file.
+     */
+    static ScreenPatternEngine *instance();
+
+    /**
+     * Compiles the rules in @p json and uses them from now on.  On error
+     * the rules in use are kept, false is returned and @p error (if given)
+     * describes the problem.
+     */
+    bool loadRules(const QByteArray &json, QString *error = nullptr);
+
+    /** Loads the rules file at @p path, see loadRules(). */
+    bool loadFile(const QString &path, QString *error = nullptr);
+
+    /** Loads the built-in rules. */
+    bool loadDefaultRules();
+
+    /**
+     * Loads the rules at @p path now and again whenever the file changes,
+     * falling back to the built-in rules while it does not exist.
+     */
+    void watchFile(const QString &path);
+
+    /**
+     * The signals @p screen shows.  Only its bottom lines are looked at,
+     * not counting blank lines at the very bottom.
+     */
+    Signals scan(QStringView screen) const;
+
+    bool matches(QStringView screen, Signal signal) const
+    {
+        return scan(screen).testFlag(signal);
+    }
+
+    /** Number of distinct keywords in the automaton. */
+    int keywordCount() const;
+
+    /** Number of bottom lines the rules look at, including context lines. */
+    int windowLines() const;
+
+    /** Where the user's rules are looked for. */
+    static QString userRulesPath();
+
+    static constexpr const char *DefaultRulesResource = ":/konsole/claude/screen-patterns.json";
+
+    /** Upper bound of distinct keywords, so a line's matches fit in a 64-bit mask. */
+    static constexpr int MaxKeywords = 64;
+
+Q_SIGNALS:
+    /** Emitted whenever new rules were compiled and are in use. */
+    void rulesReloaded();
+
+private:
+    struct Rules;
+
+    void reloadWatched();
+
+    std::shared_ptr<const Rules> m_rules;
+    QFileSystemWatcher m_watcher;
+    QString m_watchedPath;
+    QByteArray m_watchedContent; // last content read from m_watchedPath
+};
+
+} // namespace Konsolai
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Konsolai::ScreenPatternEngine::Signals)
+
+#endif // SCREENPATTERNENGINE_H
@@ -7,8 +7,11 @@
 #include "ClaudeConversationPicker.h"
 #include "ClaudeSession.h"
 #include "ClaudeSessionRegistry.h"
+#include "IdleTaskScheduler.h"
 #include "KonsolaiSettings.h"
 #include "NotificationManager.h"
+#include "ProjectIndex.h"
+#include "StartupTrace.h"
 #include "TmuxManager.h"
 
 #include <limits>
@@ -102,10 +105,22 @@ SessionManagerPanel::SessionManagerPanel(QWidget *parent)
 
 void SessionManagerPanel::deferredInit()
 {
-    loadMetadata();
-    cleanupStaleSockets(); // async — returns immediately
-    refreshRemoteTmuxSessions(); // async SSH query for remote session liveness
-    refresh(); // async — returns immediately
+    {
+        Konsole::StartupTrace::Span span("SessionManagerPanel::loadMetadata");
+        loadMetadata();
+    }
+
+    // Everything below spawns processes or walks directories; none of it is
+    // needed for the first terminal, so it runs once the UI is interactive.
+    IdleTaskScheduler::post(this, "SessionManagerPanel::refresh", IdleTaskScheduler::High, [this]() {
+        refresh(); // async — returns immediately
+    });
+    IdleTaskScheduler::post(this, "SessionManagerPanel::cleanupStaleSockets", IdleTaskScheduler::Low, [this]() {
+        cleanupStaleSockets(); // async — returns immediately
+    });
+    IdleTaskScheduler::post(this, "SessionManagerPanel::refreshRemoteTmuxSessions", IdleTaskScheduler::Low, [this]() {
+        refreshRemoteTmuxSessions(); // async SSH query for remote session liveness
+    });
 
     // Periodically refresh remote tmux session liveness (every 60s)
     m_remoteTmuxTimer = new QTimer(this);
@@ -130,7 +145,9 @@ void SessionManagerPanel::deferredInit()
     m_convCacheTimer->start();
 
     // Pre-populate caches on startup
-    refreshCachesAsync();
+    IdleTaskScheduler::post(this, "SessionManagerPanel::refreshCachesAsync", IdleTaskScheduler::Normal, [this]() {
+        refreshCachesAsync();
+    });
 
     // Auto-archive closed sessions every 5 minutes
     m_autoArchiveTimer = new QTimer(this);
@@ -3658,6 +3675,9 @@ void SessionManagerPanel::addSessionToTree(const SessionMetadata &meta, QTreeWid
                 if (info.startedAt.isValid()) {
                     childTooltip += QStringLiteral("\nElapsed: %1").arg(formatElapsed(info.startedAt));
                 }
+                if (info.tokenUsage.totalTokens() > 0) {
+                    childTooltip += QStringLiteral("\nTokens: %1 ($%2)").arg(info.tokenUsage.formatCompact(), QString::number(info.tokenUsage.estimatedCostUSD(), 'f', 2));
+                }
                 if (!info.transcriptPath.isEmpty()) {
                     childTooltip += QStringLiteral("\nTranscript: %1").arg(info.transcriptPath);
                 }
@@ -4077,6 +4097,21 @@ void SessionManagerPanel::loadMetadata()
             m_metadata[meta.sessionId] = meta;
         }
     }
+
+    publishProjectVisits();
+}
+
+void SessionManagerPanel::publishProjectVisits()
+{
+    // The session history ranks the projects offered by the wizard
+    QList<ProjectIndex::Visit> visits;
+    for (const SessionMetadata &meta : std::as_const(m_metadata)) {
+        if (meta.isRemote || meta.workingDirectory.isEmpty()) {
+            continue;
+        }
+        visits.append({meta.workingDirectory, meta.lastAccessed.isValid() ? meta.lastAccessed : meta.createdAt});
+    }
+    ProjectIndex::instance()->setVisits(visits);
 }
 
 void SessionManagerPanel::saveMetadata(bool sync)
@@ -4236,6 +4271,7 @@ void SessionManagerPanel::saveMetadata(bool sync)
         (void)QtConcurrent::run(writeFile);
     }
 
+    publishProjectVisits();
     Q_EMIT usageAggregateChanged();
 }
 
@@ -4807,6 +4843,12 @@ void SessionManagerPanel::showSubagentDetails(const SubagentInfo &info)
     if (!info.currentTaskSubject.isEmpty()) {
         details += QStringLiteral("<b>Task:</b> %1<br>").arg(info.currentTaskSubject.toHtmlEscaped());
     }
+    if (!info.teamName.isEmpty()) {
+        details += QStringLiteral("<b>Team:</b> %1<br>").arg(info.teamName.toHtmlEscaped());
+    }
+    if (info.tokenUsage.totalTokens() > 0) {
+        details += QStringLiteral("<b>Tokens:</b> %1 ($%2)<br>").arg(info.tokenUsage.formatCompact(), QString::number(info.tokenUsage.estimatedCostUSD(), 'f', 2));
+    }
     if (!info.transcriptPath.isEmpty()) {
         details += QStringLiteral("<b>Transcript:</b> %1<br>").arg(info.transcriptPath.toHtmlEscaped());
     }
@@ -333,6 +333,7 @@ private:
     void showReadyState();
     void loadMetadata();
     void saveMetadata(bool sync = false);
+    void publishProjectVisits();
     void scheduleTreeUpdate(); // debounced — coalesces rapid-fire calls
     void scheduleMetadataSave(); // debounced — coalesces rapid-fire saves
     void updateTreeWidget();
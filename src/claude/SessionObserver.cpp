@@ -68,6 +68,8 @@ void SessionObserver::reset()
     m_costWindowStart = QDateTime();
     m_costWindowStartTokens = 0;
     m_costWindowStartCost = 0.0;
+    m_tokensPerMinute = 0.0;
+    m_costPerMinute = 0.0;
 
     m_initialOutputRatio = -1.0;
     m_outputRatioSamples = 0;
@@ -165,6 +167,13 @@ void SessionObserver::onTokenUsageChanged(quint64 inputTokens, quint64 outputTok
     checkContextRot();
 }
 
+void SessionObserver::onTokenVelocityChanged(double tokensPerMinute, double costPerMinute)
+{
+    m_tokensPerMinute = tokensPerMinute;
+    m_costPerMinute = costPerMinute;
+    checkCostSpiral();
+}
+
 void SessionObserver::onApprovalLogged(const QString &toolName, int yoloLevel, const QDateTime &timestamp)
 {
     Q_UNUSED(yoloLevel)
@@ -256,19 +265,22 @@ void SessionObserver::checkCostSpiral()
     const auto now = QDateTime::currentDateTime();
 
     // Initialize or reset window if expired
+    quint64 tokenDelta = 0;
+    double costDelta = 0.0;
     if (!m_costWindowStart.isValid() || m_costWindowStart.secsTo(now) > m_config.costSpiralWindowSeconds) {
         m_costWindowStart = now;
         m_costWindowStartTokens = m_currentTotalTokens;
         m_costWindowStartCost = m_currentCostUSD;
-
-        if (isPatternActive(StuckPattern::CostSpiral)) {
-            clearPattern(StuckPattern::CostSpiral);
-        }
-        return;
+    } else {
+        tokenDelta = m_currentTotalTokens - m_costWindowStartTokens;
+        costDelta = m_currentCostUSD - m_costWindowStartCost;
     }
 
-    quint64 tokenDelta = m_currentTotalTokens - m_costWindowStartTokens;
-    double costDelta = m_currentCostUSD - m_costWindowStartCost;
+    // The rates project a runaway over the window long before the window
+    // has added it up
+    const double windowMinutes = m_config.costSpiralWindowSeconds / 60.0;
+    const double projectedTokens = m_tokensPerMinute * windowMinutes;
+    const double projectedCost = m_costPerMinute * windowMinutes;
 
     if (tokenDelta >= m_config.costSpiralTokenThreshold && costDelta >= m_config.costSpiralCostThreshold) {
         activatePattern(StuckPattern::CostSpiral,
@@ -277,6 +289,14 @@ void SessionObserver::checkCostSpiral()
                             .arg(tokenDelta)
                             .arg(costDelta, 0, 'f', 2)
                             .arg(static_cast<int>(m_costWindowStart.secsTo(now))));
+    } else if (projectedTokens >= static_cast<double>(m_config.costSpiralTokenThreshold) && projectedCost >= m_config.costSpiralCostThreshold) {
+        activatePattern(StuckPattern::CostSpiral,
+                        2,
+                        QStringLiteral("Burning %1 tokens/min ($%2/min), %3 tokens in %4 seconds at this rate")
+                            .arg(m_tokensPerMinute, 0, 'f', 0)
+                            .arg(m_costPerMinute, 0, 'f', 2)
+                            .arg(projectedTokens, 0, 'f', 0)
+                            .arg(m_config.costSpiralWindowSeconds));
     } else if (isPatternActive(StuckPattern::CostSpiral)) {
         clearPattern(StuckPattern::CostSpiral);
     }
@@ -137,6 +137,7 @@ public:
 public Q_SLOTS:
     void onStateChanged(int state);
     void onTokenUsageChanged(quint64 inputTokens, quint64 outputTokens, quint64 totalTokens, double costUSD);
+    void onTokenVelocityChanged(double tokensPerMinute, double costPerMinute);
     void onApprovalLogged(const QString &toolName, int yoloLevel, const QDateTime &timestamp);
     void onSubagentStarted(const QString &agentId);
     void onSubagentStopped(const QString &agentId);
@@ -198,6 +199,8 @@ private:
     QDateTime m_costWindowStart;
     quint64 m_costWindowStartTokens = 0;
     double m_costWindowStartCost = 0.0;
+    double m_tokensPerMinute = 0.0; // decayed over about the window
+    double m_costPerMinute = 0.0;
 
     // ContextRot tracking
     double m_initialOutputRatio = -1.0;
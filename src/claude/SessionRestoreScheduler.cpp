@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "SessionRestoreScheduler.h"
+#include "KonsolaiLogging.h"
+
+#include "StartupTrace.h"
+
+#include <QPointer>
+
+#include <algorithm>
+#include <memory>
+
+namespace Konsolai
+{
+
+SessionRestoreScheduler::SessionRestoreScheduler(Attach attach, QObject *parent)
+    : QObject(parent)
+    , m_attach(std::move(attach))
+{
+    // One attach per event loop iteration
+    m_pumpTimer.setSingleShot(true);
+    m_pumpTimer.setInterval(0);
+    connect(&m_pumpTimer, &QTimer::timeout, this, &SessionRestoreScheduler::startNext);
+}
+
+SessionRestoreScheduler::~SessionRestoreScheduler() = default;
+
+void SessionRestoreScheduler::setBatchSize(int size)
+{
+    m_batchSize = std::max(1, size);
+}
+
+QList<ClaudeSessionState> SessionRestoreScheduler::prioritized(QList<ClaudeSessionState> states)
+{
+    std::stable_sort(states.begin(), states.end(), [](const ClaudeSessionState &a, const ClaudeSessionState &b) {
+        return a.lastAccessed > b.lastAccessed;
+    });
+    return states;
+}
+
+void SessionRestoreScheduler::start(const QList<ClaudeSessionState> &states)
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    m_elapsed.start();
+
+    for (const ClaudeSessionState &state : prioritized(states)) {
+        m_pending.enqueue(state);
+    }
+
+    qCDebug(KonsolaiLog) << "SessionRestoreScheduler: restoring" << m_pending.size() << "sessions";
+
+    if (m_pending.isEmpty()) {
+        m_timeToFirstTab = 0;
+        finish();
+        return;
+    }
+
+    // The rest of the fleet waits until the foreground tab is up
+    attachOne(m_pending.dequeue(), true);
+}
+
+void SessionRestoreScheduler::attachOne(const ClaudeSessionState &state, bool foreground)
+{
+    ++m_inFlight;
+
+    // done may be called synchronously, or never again after a failure path
+    // already called it; only the first call counts
+    QPointer<SessionRestoreScheduler> guard(this);
+    auto called = std::make_shared<bool>(false);
+    const QString sessionName = state.sessionName;
+    m_attach(state, foreground, [guard, called, sessionName, foreground](bool ok) {
+        if (*called) {
+            return;
+        }
+        *called = true;
+        if (guard) {
+            guard->attachDone(sessionName, foreground, ok);
+        }
+    });
+}
+
+void SessionRestoreScheduler::attachDone(const QString &sessionName, bool foreground, bool ok)
+{
+    --m_inFlight;
+    if (ok) {
+        ++m_restored;
+    } else {
+        ++m_failed;
+        qCDebug(KonsolaiLog) << "SessionRestoreScheduler: failed to restore" << sessionName;
+    }
+    Q_EMIT sessionRestored(sessionName, ok);
+
+    if (foreground) {
+        m_backgroundReleased = true;
+        m_timeToFirstTab = m_elapsed.elapsed();
+        Konsole::StartupTrace::instance()->mark("restore-first-tab", "restore");
+        Q_EMIT firstTabRestored(m_timeToFirstTab);
+    }
+
+    if (m_pending.isEmpty() && m_inFlight == 0) {
+        finish();
+        return;
+    }
+    scheduleNext();
+}
+
+void SessionRestoreScheduler::scheduleNext()
+{
+    if (m_backgroundReleased && !m_pending.isEmpty() && m_inFlight < m_batchSize && !m_pumpTimer.isActive()) {
+        m_pumpTimer.start();
+    }
+}
+
+void SessionRestoreScheduler::startNext()
+{
+    if (m_pending.isEmpty() || m_inFlight >= m_batchSize) {
+        return;
+    }
+    attachOne(m_pending.dequeue(), false);
+    scheduleNext();
+}
+
+void SessionRestoreScheduler::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_timeToAllRestored = m_elapsed.elapsed();
+    Konsole::StartupTrace::instance()->mark("restore-all-sessions", "restore");
+
+    qCDebug(KonsolaiLog) << "SessionRestoreScheduler: restored" << m_restored << "sessions," << m_failed << "failed; first tab after" << m_timeToFirstTab
+                         << "ms, all after" << m_timeToAllRestored << "ms";
+    Q_EMIT finished(m_restored, m_failed, m_timeToAllRestored);
+}
+
+} // namespace Konsolai
+
+#include "moc_SessionRestoreScheduler.cpp"
@@ -0,0 +1,144 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SESSIONRESTORESCHEDULER_H
+#define SESSIONRESTORESCHEDULER_H
+
+#include "konsoleprivate_export.h"
+
+#include "ClaudeSessionState.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Reattaches the detached tmux sessions found after a restart.
+ *
+ * The session accessed last, the tab the user is going to look at, is
+ * attached on its own first, so the first interactive tab never waits for
+ * the rest of the fleet.  The others follow with up to batchSize()
+ * attaches in flight at once.  Every attach is started from its own event
+ * loop iteration, so the tabs already restored keep handling input and
+ * painting while the rest come up.
+ *
+ * What attaching involves is up to the Attach function; MainWindow creates
+ * the session with its tab and starts the tmux client, and reports done
+ * once the client has produced its first output.  The scheduler orders and
+ * paces the attaches and measures how long the restore took.
+ */
+class KONSOLEPRIVATE_EXPORT SessionRestoreScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Done = std::function<void(bool ok)>;
+
+    /**
+     * Attaches the session described by @p state and calls @p done once it
+     * is up.  @p foreground is true for the session restored first, whose
+     * tab should be shown; the others are restored as background tabs.
+     */
+    using Attach = std::function<void(const ClaudeSessionState &state, bool foreground, Done done)>;
+
+    explicit SessionRestoreScheduler(Attach attach, QObject *parent = nullptr);
+    ~SessionRestoreScheduler() override;
+
+    /** Maximum number of background attaches in flight at once. */
+    void setBatchSize(int size);
+    int batchSize() const
+    {
+        return m_batchSize;
+    }
+
+    /** Restores @p states, most recently accessed first.  Can only be called once. */
+    void start(const QList<ClaudeSessionState> &states);
+
+    /** @p states ordered by the time they were last accessed, newest first. */
+    static QList<ClaudeSessionState> prioritized(QList<ClaudeSessionState> states);
+
+    bool isFinished() const
+    {
+        return m_finished;
+    }
+
+    int restoredCount() const
+    {
+        return m_restored;
+    }
+
+    int failedCount() const
+    {
+        return m_failed;
+    }
+
+    /** Attaches started but not done yet. */
+    int inFlightCount() const
+    {
+        return m_inFlight;
+    }
+
+    /** Attaches not started yet. */
+    int pendingCount() const
+    {
+        return m_pending.size();
+    }
+
+    /** Milliseconds from start() until the first session was up, -1 before. */
+    qint64 timeToFirstTab() const
+    {
+        return m_timeToFirstTab;
+    }
+
+    /** Milliseconds from start() until every session was attached, -1 before. */
+    qint64 timeToAllRestored() const
+    {
+        return m_timeToAllRestored;
+    }
+
+    static constexpr int DefaultBatchSize = 4;
+
+Q_SIGNALS:
+    /** Emitted when the attach of @p sessionName has finished. */
+    void sessionRestored(const QString &sessionName, bool ok);
+
+    /** Emitted once the foreground session is up. */
+    void firstTabRestored(qint64 elapsedMs);
+
+    /** Emitted when every session has been attached, or has failed to. */
+    void finished(int restored, int failed, qint64 elapsedMs);
+
+private:
+    void attachOne(const ClaudeSessionState &state, bool foreground);
+    void attachDone(const QString &sessionName, bool foreground, bool ok);
+    void startNext();
+    void scheduleNext();
+    void finish();
+
+    Attach m_attach;
+    int m_batchSize = DefaultBatchSize;
+    QQueue<ClaudeSessionState> m_pending;
+    QTimer m_pumpTimer;
+    QElapsedTimer m_elapsed;
+    int m_inFlight = 0;
+    int m_restored = 0;
+    int m_failed = 0;
+    bool m_started = false;
+    bool m_backgroundReleased = false; // the foreground session is up
+    bool m_finished = false;
+    qint64 m_timeToFirstTab = -1;
+    qint64 m_timeToAllRestored = -1;
+};
+
+} // namespace Konsolai
+
+#endif // SESSIONRESTORESCHEDULER_H
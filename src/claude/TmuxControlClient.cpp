@@ -0,0 +1,297 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "TmuxControlClient.h"
+#include "KonsolaiLogging.h"
+
+#include <memory>
+#include <utility>
+
+namespace Konsolai
+{
+
+// tmux -CC wraps the whole conversation in a DCS sequence
+static const QByteArray s_controlModeIntroducer = QByteArrayLiteral("\033P1000p");
+
+TmuxControlClient::TmuxControlClient(Writer writer, QObject *parent)
+    : QObject(parent)
+    , m_writer(std::move(writer))
+{
+}
+
+TmuxControlClient::~TmuxControlClient() = default;
+
+void TmuxControlClient::feed(const char *data, int length)
+{
+    m_lineBuffer.append(data, length);
+
+    qsizetype start = 0;
+    qsizetype end;
+    while ((end = m_lineBuffer.indexOf('\n', start)) >= 0) {
+        QByteArray line = m_lineBuffer.mid(start, end - start);
+        start = end + 1;
+
+        // the pty turns \n into \r\n
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (line.startsWith(s_controlModeIntroducer)) {
+            line.remove(0, s_controlModeIntroducer.size());
+        }
+        processLine(line);
+    }
+    m_lineBuffer.remove(0, start);
+}
+
+void TmuxControlClient::sendCommand(const QByteArray &command, Callback callback)
+{
+    enqueueCommand(command, std::move(callback), false);
+}
+
+void TmuxControlClient::enqueueCommand(const QByteArray &command, Callback callback, bool isCapture)
+{
+    // An empty line detaches the control client, and a newline would split
+    // the command in two
+    QByteArray line = command.trimmed();
+    line.replace('\n', ' ');
+    if (line.isEmpty()) {
+        return;
+    }
+
+    m_commands.enqueue(PendingCommand{std::move(callback), isCapture});
+    line.append('\n');
+    m_writer(line);
+}
+
+void TmuxControlClient::sendInput(const QByteArray &bytes)
+{
+    if (!m_mirroring) {
+        m_pendingInput.append(bytes);
+        return;
+    }
+
+    const QList<QByteArray> commands = buildSendKeysCommands(m_paneId, bytes);
+    for (const QByteArray &command : commands) {
+        sendCommand(command);
+    }
+}
+
+void TmuxControlClient::setClientSize(int columns, int lines)
+{
+    if (columns < 1 || lines < 1) {
+        return;
+    }
+    if (!m_mirroring) {
+        m_pendingColumns = columns;
+        m_pendingLines = lines;
+        return;
+    }
+    sendCommand(QByteArrayLiteral("refresh-client -C ") + QByteArray::number(columns) + ',' + QByteArray::number(lines));
+}
+
+void TmuxControlClient::processLine(const QByteArray &line)
+{
+    if (m_inReply) {
+        const bool isEnd = line.startsWith("%end ");
+        const bool isError = line.startsWith("%error ");
+        // a captured line may itself start with %end, so the tag has to match too
+        const QByteArray tag = line.mid(line.indexOf(' ') + 1);
+        if ((isEnd || isError) && (tag == m_replyTag || tag.startsWith(m_replyTag + ' '))) {
+            m_inReply = false;
+            const QList<QByteArray> lines = std::exchange(m_replyLines, {});
+            if (m_replyIsOurs) {
+                const PendingCommand command = m_commands.dequeue();
+                if (command.callback) {
+                    command.callback(isEnd, lines);
+                }
+            } else {
+                // the command tmux was started with (new-session/attach) is done
+                startMirroring();
+            }
+        } else {
+            m_replyLines.append(line);
+        }
+        return;
+    }
+
+    if (line.startsWith("%begin ")) {
+        // %begin <time> <number> <flags>
+        const QList<QByteArray> fields = line.split(' ');
+        m_replyTag = fields.value(1) + ' ' + fields.value(2);
+        // tmux older than 3.0 does not send flags; assume the block is ours
+        // whenever we are waiting for a reply
+        const bool fromClient = fields.size() > 3 ? (fields.at(3).toInt() & 1) : !m_commands.isEmpty();
+        m_replyIsOurs = fromClient && !m_commands.isEmpty();
+        m_inReply = true;
+
+        if (m_replyIsOurs && m_commands.head().isCapture) {
+            // everything reported so far is contained in the capture
+            m_pendingOutput.clear();
+        }
+        return;
+    }
+
+    if (line.startsWith("%output ")) {
+        // %output %<pane> <escaped data>
+        const QByteArray rest = line.mid(8);
+        const qsizetype space = rest.indexOf(' ');
+        if (space > 0) {
+            handleOutput(rest.left(space), unescapeOutput(rest.mid(space + 1)));
+        }
+        return;
+    }
+
+    if (line.startsWith("%extended-output ")) {
+        // %extended-output %<pane> <age> ... : <escaped data>
+        const QByteArray rest = line.mid(17);
+        const qsizetype space = rest.indexOf(' ');
+        const qsizetype separator = rest.indexOf(" : ");
+        if (space > 0 && separator > space) {
+            handleOutput(rest.left(space), unescapeOutput(rest.mid(separator + 3)));
+        }
+        return;
+    }
+
+    if (line.startsWith("%exit")) {
+        const QString reason = QString::fromUtf8(line.mid(5).trimmed());
+        qCDebug(KonsolaiLog) << "TmuxControlClient: tmux exited" << reason;
+        Q_EMIT exited(reason);
+        return;
+    }
+
+    if (line.startsWith('%')) {
+        const qsizetype space = line.indexOf(' ');
+        const QByteArray name = line.mid(1, space < 0 ? -1 : space - 1);
+        const QByteArray arguments = space < 0 ? QByteArray() : line.mid(space + 1);
+
+        // Attaching without a command of our own may skip the initial block
+        if (name == "session-changed") {
+            startMirroring();
+        }
+        Q_EMIT notification(name, arguments);
+    }
+}
+
+void TmuxControlClient::handleOutput(const QByteArray &paneId, const QByteArray &data)
+{
+    if (m_seeding) {
+        m_pendingOutput.append({paneId, data});
+        return;
+    }
+    if (paneId == m_paneId.toUtf8()) {
+        Q_EMIT paneOutput(data);
+    }
+}
+
+void TmuxControlClient::startMirroring()
+{
+    if (m_mirroring) {
+        return;
+    }
+    m_mirroring = true;
+
+    // Resize before capturing so the capture is already reflowed to our size
+    if (m_pendingColumns > 0) {
+        setClientSize(m_pendingColumns, m_pendingLines);
+    }
+
+    // Capture first and ask for the cursor right after, so both describe
+    // (nearly) the same moment.  Neither names a target: both apply to the
+    // active pane of the attached session.
+    auto captured = std::make_shared<QList<QByteArray>>();
+    enqueueCommand(
+        QByteArrayLiteral("capture-pane -p -e -S -"),
+        [captured](bool success, const QList<QByteArray> &lines) {
+            if (success) {
+                *captured = lines;
+            }
+        },
+        true);
+    sendCommand(QByteArrayLiteral("display-message -p '#{pane_id} #{cursor_x} #{cursor_y}'"), [this, captured](bool success, const QList<QByteArray> &lines) {
+        int cursorX = 0;
+        int cursorY = 0;
+        if (success && !lines.isEmpty()) {
+            const QList<QByteArray> fields = lines.first().split(' ');
+            m_paneId = QString::fromUtf8(fields.value(0));
+            cursorX = fields.value(1).toInt();
+            cursorY = fields.value(2).toInt();
+        }
+        seedFromCapture(*captured, cursorX, cursorY);
+    });
+
+    if (!m_pendingInput.isEmpty()) {
+        sendInput(std::exchange(m_pendingInput, {}));
+    }
+}
+
+void TmuxControlClient::seedFromCapture(const QList<QByteArray> &lines, int cursorX, int cursorY)
+{
+    qCDebug(KonsolaiLog) << "TmuxControlClient: seeding pane" << m_paneId << "with" << lines.size() << "lines";
+
+    if (!lines.isEmpty()) {
+        QByteArray seed = lines.join("\r\n");
+        // capture-pane -e leaves the last attributes set; reset them and put
+        // the cursor back where the application left it
+        seed += QByteArrayLiteral("\033[0m\033[") + QByteArray::number(cursorY + 1) + ';' + QByteArray::number(cursorX + 1) + 'H';
+        Q_EMIT paneOutput(seed);
+    }
+
+    m_seeding = false;
+
+    const QByteArray paneId = m_paneId.toUtf8();
+    const auto pending = std::exchange(m_pendingOutput, {});
+    for (const auto &output : pending) {
+        if (output.first == paneId) {
+            Q_EMIT paneOutput(output.second);
+        }
+    }
+}
+
+QByteArray TmuxControlClient::unescapeOutput(const QByteArray &escaped)
+{
+    // tmux writes bytes below 0x20 and the backslash itself as \ooo
+    QByteArray result;
+    result.reserve(escaped.size());
+
+    const auto isOctal = [](char c) {
+        return c >= '0' && c <= '7';
+    };
+
+    for (qsizetype i = 0; i < escaped.size(); ++i) {
+        const char c = escaped.at(i);
+        if (c == '\\' && i + 3 < escaped.size() && isOctal(escaped.at(i + 1)) && isOctal(escaped.at(i + 2)) && isOctal(escaped.at(i + 3))) {
+            result.append(char(((escaped.at(i + 1) - '0') << 6) | ((escaped.at(i + 2) - '0') << 3) | (escaped.at(i + 3) - '0')));
+            i += 3;
+        } else {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
+QList<QByteArray> TmuxControlClient::buildSendKeysCommands(const QString &paneId, const QByteArray &bytes)
+{
+    QByteArray prefix = QByteArrayLiteral("send-keys -H");
+    if (!paneId.isEmpty()) {
+        prefix += QByteArrayLiteral(" -t ") + paneId.toUtf8();
+    }
+
+    QList<QByteArray> commands;
+    for (qsizetype offset = 0; offset < bytes.size(); offset += MaxKeysPerCommand) {
+        const QByteArray chunk = bytes.mid(offset, MaxKeysPerCommand);
+        QByteArray command = prefix;
+        command.reserve(prefix.size() + chunk.size() * 3);
+        for (const char byte : chunk) {
+            command += ' ';
+            command += QByteArray::number(uchar(byte), 16).rightJustified(2, '0');
+        }
+        commands.append(command);
+    }
+    return commands;
+}
+
+} // namespace Konsolai
+
+#include "moc_TmuxControlClient.cpp"
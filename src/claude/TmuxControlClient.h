@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TMUXCONTROLCLIENT_H
+#define TMUXCONTROLCLIENT_H
+
+#include "konsoleprivate_export.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QQueue>
+#include <QString>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Speaks tmux control mode (tmux -CC) for a Claude session.
+ *
+ * In control mode tmux does not draw anything itself.  It reports the raw
+ * output of each pane as %output notifications and accepts commands, one
+ * per line, answered by %begin ... %end (or %error) blocks.  This client
+ * parses that protocol from bytes read off the session's pty and mirrors
+ * the session's active pane: its visible screen and history are seeded
+ * once from capture-pane -e, after which the pane's output is emitted
+ * unchanged through paneOutput() for the Konsole emulation to parse.
+ *
+ * Key presses are forwarded with send-keys -H, and the terminal size with
+ * refresh-client -C, so the pane always matches the view.
+ *
+ * The client does not own the pty; everything it needs to send goes
+ * through the writer passed to the constructor.
+ */
+class KONSOLEPRIVATE_EXPORT TmuxControlClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Writer = std::function<void(const QByteArray &)>;
+    using Callback = std::function<void(bool success, const QList<QByteArray> &lines)>;
+
+    explicit TmuxControlClient(Writer writer, QObject *parent = nullptr);
+    ~TmuxControlClient() override;
+
+    /** Feeds bytes read from the control client's pty. */
+    void feed(const char *data, int length);
+
+    /**
+     * Sends one tmux command.  @p callback, if set, receives the reply lines
+     * once tmux has run the command.  Commands are answered in order.
+     */
+    void sendCommand(const QByteArray &command, Callback callback = nullptr);
+
+    /** Types @p bytes into the mirrored pane, exactly as given. */
+    void sendInput(const QByteArray &bytes);
+
+    /** Resizes the control client, and with it the pane, to @p columns x @p lines. */
+    void setClientSize(int columns, int lines);
+
+    /** Id of the mirrored pane (e.g. "%3"), empty until the first reply arrived. */
+    QString paneId() const
+    {
+        return m_paneId;
+    }
+
+    /** True until the pane's history has been captured and replayed. */
+    bool isSeeding() const
+    {
+        return m_seeding;
+    }
+
+    /** Undoes the octal escaping of a %output payload. */
+    static QByteArray unescapeOutput(const QByteArray &escaped);
+
+    /**
+     * Splits @p bytes into send-keys -H commands for @p paneId, each short
+     * enough to stay well within tmux's command line limits.
+     */
+    static QList<QByteArray> buildSendKeysCommands(const QString &paneId, const QByteArray &bytes);
+
+    /** Longest payload, in bytes, of one generated send-keys command. */
+    static constexpr int MaxKeysPerCommand = 256;
+
+Q_SIGNALS:
+    /** Output of the mirrored pane, ready to be handed to the emulation. */
+    void paneOutput(const QByteArray &data);
+
+    /** Any other notification, e.g. "layout-change" or "session-changed". */
+    void notification(const QByteArray &name, const QByteArray &arguments);
+
+    /** tmux sent %exit; the control client is about to terminate. */
+    void exited(const QString &reason);
+
+private:
+    struct PendingCommand {
+        Callback callback;
+        // output reported before this reply starts is part of the capture
+        bool isCapture = false;
+    };
+
+    void enqueueCommand(const QByteArray &command, Callback callback, bool isCapture);
+    void processLine(const QByteArray &line);
+    void handleOutput(const QByteArray &paneId, const QByteArray &data);
+    void startMirroring();
+    void seedFromCapture(const QList<QByteArray> &lines, int cursorX, int cursorY);
+
+    Writer m_writer;
+    QByteArray m_lineBuffer;
+
+    // Replies to our own commands arrive in order.  Blocks for commands tmux
+    // runs on its own (the one it was started with) have flags 0.
+    QQueue<PendingCommand> m_commands;
+    bool m_inReply = false;
+    bool m_replyIsOurs = false;
+    QByteArray m_replyTag; // "<time> <number>" of the open block
+    QList<QByteArray> m_replyLines;
+
+    // size and keys requested before the attach completed
+    int m_pendingColumns = 0;
+    int m_pendingLines = 0;
+    QByteArray m_pendingInput;
+
+    QString m_paneId;
+    bool m_mirroring = false;
+    bool m_seeding = true;
+    // pane output reported while the pane is being seeded
+    QList<QPair<QByteArray, QByteArray>> m_pendingOutput;
+};
+
+} // namespace Konsolai
+
+#endif // TMUXCONTROLCLIENT_H
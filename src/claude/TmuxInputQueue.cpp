@@ -0,0 +1,216 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "TmuxInputQueue.h"
+#include "KonsolaiLogging.h"
+#include "TmuxManager.h"
+
+#include <QCoreApplication>
+#include <QPointer>
+
+#include <atomic>
+#include <memory>
+
+namespace Konsolai
+{
+
+TmuxInputQueue::TmuxInputQueue(const QString &target, Runner runner, QObject *parent)
+    : QObject(parent)
+    , m_target(target)
+    , m_runner(std::move(runner))
+{
+}
+
+TmuxInputQueue::~TmuxInputQueue() = default;
+
+TmuxInputQueue::Runner TmuxInputQueue::runnerFor(TmuxManager *manager)
+{
+    QPointer<TmuxManager> guard(manager);
+    return [guard](const QStringList &args, const QByteArray &input, Done done) {
+        if (!guard) {
+            if (done) {
+                done(false);
+            }
+            return;
+        }
+        guard->executeCommandAsync(args, input, [done](bool ok, const QString &) {
+            if (done) {
+                done(ok);
+            }
+        });
+    };
+}
+
+void TmuxInputQueue::sendText(const QString &text, Done done)
+{
+    QString body = text;
+    bool submit = false;
+    if (body.endsWith(QLatin1Char('\n'))) {
+        body.chop(1);
+        submit = true;
+    }
+
+    const QByteArray utf8 = body.toUtf8();
+    if (utf8.size() > PasteThreshold) {
+        auto pasted = std::make_shared<bool>(false);
+        enqueuePaste(utf8, pasted, submit ? nullptr : done);
+        if (submit) {
+            enqueue({buildKeyArgs(m_target, QStringLiteral("Enter")), QByteArray(), done, pasted});
+        }
+        return;
+    }
+
+    if (submit) {
+        body.append(QLatin1Char('\r'));
+    }
+    if (body.isEmpty()) {
+        if (done) {
+            done(true);
+        }
+        return;
+    }
+    enqueue({{QStringLiteral("send-keys"), QStringLiteral("-t"), m_target, QStringLiteral("-l"), body}, QByteArray(), done});
+}
+
+void TmuxInputQueue::sendKey(const QString &keyName, Done done)
+{
+    enqueue({buildKeyArgs(m_target, keyName), QByteArray(), done, nullptr});
+}
+
+void TmuxInputQueue::sendPrompt(const QString &prompt, Done done)
+{
+    if (prompt.isEmpty()) {
+        sendKey(QStringLiteral("Enter"), done);
+        return;
+    }
+
+    // Enter must be a separate step: only once the paste has been written
+    // to the pane is it guaranteed to follow the text.  Without the text
+    // it would submit whatever the input field held before
+    auto pasted = std::make_shared<bool>(false);
+    enqueuePaste(prompt.toUtf8(), pasted);
+    enqueue({buildKeyArgs(m_target, QStringLiteral("Enter")), QByteArray(), done, pasted});
+}
+
+void TmuxInputQueue::enqueuePaste(const QByteArray &text, const std::shared_ptr<bool> &pasted, Done done)
+{
+    const QString buffer = nextBufferName();
+    const Runner runner = m_runner;
+    enqueue({buildPasteArgs(buffer, m_target),
+             text,
+             [pasted, done, buffer, runner](bool ok) {
+                 *pasted = ok;
+                 if (!ok) {
+                     // tmux stops at the failing command, before paste-buffer -d
+                     runner({QStringLiteral("delete-buffer"), QStringLiteral("-b"), buffer}, QByteArray(), nullptr);
+                 }
+                 if (done) {
+                     done(ok);
+                 }
+             },
+             nullptr});
+}
+
+void TmuxInputQueue::clear()
+{
+    m_steps.clear();
+}
+
+void TmuxInputQueue::enqueue(Step step)
+{
+    m_steps.enqueue(std::move(step));
+    if (!m_running) {
+        runNext();
+    }
+}
+
+void TmuxInputQueue::runNext()
+{
+    if (m_steps.isEmpty()) {
+        m_running = false;
+        Q_EMIT drained();
+        return;
+    }
+
+    m_running = true;
+    Step step = m_steps.dequeue();
+    QPointer<TmuxInputQueue> guard(this);
+    Done done = std::move(step.done);
+    if (step.condition && !*step.condition) {
+        if (done) {
+            done(false);
+        }
+        if (guard) {
+            guard->runNext();
+        }
+        return;
+    }
+    m_runner(step.args, step.input, [guard, done](bool ok) {
+        if (!ok) {
+            qCDebug(KonsolaiLog) << "TmuxInputQueue: step failed";
+        }
+        if (done) {
+            done(ok);
+        }
+        if (guard) {
+            guard->runNext();
+        }
+    });
+}
+
+void TmuxInputQueue::broadcastPrompt(const QList<TmuxInputQueue *> &queues, const QString &prompt, Done done)
+{
+    if (queues.isEmpty()) {
+        if (done) {
+            done(true);
+        }
+        return;
+    }
+
+    auto remaining = std::make_shared<int>(queues.size());
+    auto allOk = std::make_shared<bool>(true);
+    for (TmuxInputQueue *queue : queues) {
+        queue->sendPrompt(prompt, [remaining, allOk, done](bool ok) {
+            *allOk = *allOk && ok;
+            if (--*remaining == 0 && done) {
+                done(*allOk);
+            }
+        });
+    }
+}
+
+QStringList TmuxInputQueue::buildPasteArgs(const QString &buffer, const QString &target)
+{
+    // -p pastes with bracketed paste markers if the application enabled
+    // them, -d deletes the buffer afterwards
+    return {QStringLiteral("load-buffer"),
+            QStringLiteral("-b"),
+            buffer,
+            QStringLiteral("-"),
+            QStringLiteral(";"),
+            QStringLiteral("paste-buffer"),
+            QStringLiteral("-p"),
+            QStringLiteral("-d"),
+            QStringLiteral("-b"),
+            buffer,
+            QStringLiteral("-t"),
+            target};
+}
+
+QStringList TmuxInputQueue::buildKeyArgs(const QString &target, const QString &keyName)
+{
+    return {QStringLiteral("send-keys"), QStringLiteral("-t"), target, keyName};
+}
+
+QString TmuxInputQueue::nextBufferName()
+{
+    // the tmux server is shared with other Konsolai instances
+    static std::atomic<quint64> serial{0};
+    return QStringLiteral("konsolai-input-%1-%2").arg(QCoreApplication::applicationPid()).arg(++serial);
+}
+
+} // namespace Konsolai
+
+#include "moc_TmuxInputQueue.cpp"
@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TMUXINPUTQUEUE_H
+#define TMUXINPUTQUEUE_H
+
+#include "konsoleprivate_export.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+
+namespace Konsolai
+{
+
+class TmuxManager;
+
+/**
+ * Delivers input to one tmux session in order.
+ *
+ * Every piece of input becomes one tmux invocation (a "step").  A step is
+ * started only after the previous one has finished, so keystrokes arrive in
+ * the order they were queued without relying on timers.
+ *
+ * Prompts, and text too long to pass comfortably on a command line, are
+ * written to a tmux buffer through load-buffer's stdin and pasted with
+ * paste-buffer -p.  When the application asked for bracketed paste, as
+ * Claude Code's input field does, the pasted text is delimited and a
+ * following Enter is always taken as a submit, however the bytes were
+ * split into reads.
+ *
+ * broadcastPrompt() sends one prompt to many sessions through their own
+ * queues, so it is ordered with the input already queued on each of them.
+ */
+class KONSOLEPRIVATE_EXPORT TmuxInputQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Done = std::function<void(bool ok)>;
+
+    /**
+     * Runs tmux with @p args, writing @p input to its stdin, and calls
+     * @p done once tmux has exited.
+     */
+    using Runner = std::function<void(const QStringList &args, const QByteArray &input, Done done)>;
+
+    TmuxInputQueue(const QString &target, Runner runner, QObject *parent = nullptr);
+    ~TmuxInputQueue() override;
+
+    /** Returns a runner executing the steps through @p manager. */
+    static Runner runnerFor(TmuxManager *manager);
+
+    /**
+     * Types @p text literally.  A trailing newline is sent as Enter, like
+     * TmuxManager::sendKeysAsync() does.
+     */
+    void sendText(const QString &text, Done done = nullptr);
+
+    /** Presses the key named @p keyName (e.g. "Enter", "C-c", "Down"). */
+    void sendKey(const QString &keyName, Done done = nullptr);
+
+    /** Pastes @p prompt and presses Enter once the paste has been delivered. */
+    void sendPrompt(const QString &prompt, Done done = nullptr);
+
+    /** Drops all steps which have not been started yet. */
+    void clear();
+
+    /** Number of steps waiting, not counting the one running. */
+    int pendingCount() const
+    {
+        return m_steps.size();
+    }
+
+    bool isBusy() const
+    {
+        return m_running;
+    }
+
+    QString target() const
+    {
+        return m_target;
+    }
+
+    /** Changes the session input is sent to.  Steps already queued are kept. */
+    void setTarget(const QString &target)
+    {
+        m_target = target;
+    }
+
+    /**
+     * Sends @p prompt with sendPrompt() on each of @p queues.  @p done
+     * receives whether it was submitted in all of them, once every queue
+     * has reported back.
+     */
+    static void broadcastPrompt(const QList<TmuxInputQueue *> &queues, const QString &prompt, Done done = nullptr);
+
+    /**
+     * Arguments loading stdin into @p buffer and pasting it into
+     * @p target, deleting the buffer afterwards.
+     */
+    static QStringList buildPasteArgs(const QString &buffer, const QString &target);
+
+    /** Arguments pressing @p keyName in @p target. */
+    static QStringList buildKeyArgs(const QString &target, const QString &keyName);
+
+    /** Returns a buffer name no other queue in this process uses. */
+    static QString nextBufferName();
+
+    /** Text longer than this many bytes is pasted instead of typed. */
+    static constexpr int PasteThreshold = 256;
+
+Q_SIGNALS:
+    /** Emitted when the last queued step has finished. */
+    void drained();
+
+private:
+    struct Step {
+        QStringList args;
+        QByteArray input;
+        Done done;
+        // When set, the step fails without running unless it is true by then
+        std::shared_ptr<const bool> condition;
+    };
+
+    /** Queues pasting @p text; @p pasted is set once that succeeded. */
+    void enqueuePaste(const QByteArray &text, const std::shared_ptr<bool> &pasted, Done done = nullptr);
+
+    void enqueue(Step step);
+    void runNext();
+
+    QString m_target;
+    Runner m_runner;
+    QQueue<Step> m_steps;
+    bool m_running = false;
+};
+
+} // namespace Konsolai
+
+#endif // TMUXINPUTQUEUE_H
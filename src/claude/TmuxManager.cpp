@@ -130,13 +130,19 @@ QString TmuxManager::buildSessionName(const QString &profileName,
 QString TmuxManager::buildNewSessionCommand(const QString &sessionName,
                                              const QString &command,
                                              bool attachExisting,
-                                             const QString &workingDir) const
+                                             const QString &workingDir,
+                                             bool controlMode) const
 {
-    // tmux new-session -A -s <session-name> [-c <dir>] -- <command>
+    // tmux [-CC] new-session -A -s <session-name> [-c <dir>] -- <command>
     // -A: attach if exists, create if not
+    // -CC: control mode without echo
 
     QStringList args;
-    args << QStringLiteral("tmux") << QStringLiteral("new-session");
+    args << QStringLiteral("tmux");
+    if (controlMode) {
+        args << QStringLiteral("-CC");
+    }
+    args << QStringLiteral("new-session");
 
     if (attachExisting) {
         args << QStringLiteral("-A");
@@ -158,11 +164,12 @@ QString TmuxManager::buildNewSessionCommand(const QString &sessionName,
     return args.join(QLatin1Char(' '));
 }
 
-QString TmuxManager::buildAttachCommand(const QString &sessionName) const
+QString TmuxManager::buildAttachCommand(const QString &sessionName, bool controlMode) const
 {
-    // tmux attach-session -t <session-name>
+    // tmux [-CC] attach-session -t <session-name>
     // Also suppress DCS passthrough to prevent XTVERSION response leaking
-    return QStringLiteral("tmux attach-session -t %1 \\; set-option -p allow-passthrough off").arg(sessionName);
+    return QStringLiteral("tmux %1attach-session -t %2 \\; set-option -p allow-passthrough off")
+        .arg(controlMode ? QStringLiteral("-CC ") : QString(), sessionName);
 }
 
 QString TmuxManager::buildKillCommand(const QString &sessionName) const
@@ -363,6 +370,11 @@ QString TmuxManager::executeCommand(const QStringList &args, bool *ok) const
 }
 
 void TmuxManager::executeCommandAsync(const QStringList &args, std::function<void(bool, const QString &)> callback)
+{
+    executeCommandAsync(args, QByteArray(), std::move(callback));
+}
+
+void TmuxManager::executeCommandAsync(const QStringList &args, const QByteArray &input, std::function<void(bool, const QString &)> callback)
 {
     auto *process = new QProcess(this);
     connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process, callback](int exitCode, QProcess::ExitStatus) {
@@ -379,6 +391,17 @@ void TmuxManager::executeCommandAsync(const QStringList &args, std::function<voi
         }
         process->deleteLater();
     });
+    // finished() is never emitted for a tmux which could not be started
+    connect(process, &QProcess::errorOccurred, this, [process, callback](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+        qWarning() << "TmuxManager: Failed to start tmux:" << process->errorString();
+        if (callback) {
+            callback(false, QString());
+        }
+        process->deleteLater();
+    });
 
     // Kill the process after 10s to prevent indefinite hangs
     QTimer::singleShot(10000, process, [process, callback]() {
@@ -390,6 +413,10 @@ void TmuxManager::executeCommandAsync(const QStringList &args, std::function<voi
     });
 
     process->start(QStringLiteral("tmux"), args);
+    if (!input.isEmpty() && process->state() != QProcess::NotRunning) {
+        process->write(input);
+    }
+    process->closeWriteChannel();
 }
 
 void TmuxManager::capturePaneAsync(const QString &sessionName, int startLine, int endLine, std::function<void(bool, const QString &)> callback)
@@ -95,16 +95,19 @@ public:
      * @param command Command to run inside the session (e.g., "claude")
      * @param attachExisting If true, attach to existing session with same name
      * @param workingDir Working directory for the session
+     * @param controlMode If true, start the client in control mode (-CC),
+     *        see TmuxControlClient
      */
     QString buildNewSessionCommand(const QString &sessionName,
                                    const QString &command,
                                    bool attachExisting = true,
-                                   const QString &workingDir = QString()) const;
+                                   const QString &workingDir = QString(),
+                                   bool controlMode = false) const;
 
     /**
      * Build command to attach to an existing tmux session
      */
-    QString buildAttachCommand(const QString &sessionName) const;
+    QString buildAttachCommand(const QString &sessionName, bool controlMode = false) const;
 
     /**
      * Build command to kill a tmux session
@@ -200,6 +203,13 @@ public:
      */
     void sendKeySequenceAsync(const QString &sessionName, const QString &keyName);
 
+    /**
+     * Execute a tmux command asynchronously, writing @p input to its stdin.
+     * Used for commands reading from "-", such as load-buffer.
+     * The callback receives (bool ok, QString stdout).
+     */
+    void executeCommandAsync(const QStringList &args, const QByteArray &input, std::function<void(bool, const QString &)> callback);
+
     /**
      * Get the current working directory of a tmux session's pane
      */
@@ -0,0 +1,180 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "TranscriptTailer.h"
+#include "KonsolaiLogging.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+namespace Konsolai
+{
+
+void TranscriptTailer::follow(const QString &key, const QString &path)
+{
+    if (path.isEmpty()) {
+        return;
+    }
+    auto it = m_transcripts.find(key);
+    if (it != m_transcripts.end()) {
+        if (it->path != path) {
+            it->path = path;
+            it->offset = 0;
+        }
+        it->retired = false;
+        return;
+    }
+    m_transcripts.insert(key, Transcript{path, 0, false});
+}
+
+void TranscriptTailer::retire(const QString &key)
+{
+    auto it = m_transcripts.find(key);
+    if (it != m_transcripts.end()) {
+        it->retired = true;
+    }
+}
+
+QHash<QString, TokenUsage> TranscriptTailer::poll(const std::function<void(const QString &key, const TokenUsage &record)> &onRecord)
+{
+    QHash<QString, TokenUsage> added;
+
+    for (auto it = m_transcripts.begin(); it != m_transcripts.end();) {
+        TokenUsage usage;
+        RecordCallback keyOnRecord;
+        if (onRecord) {
+            keyOnRecord = [&onRecord, key = it.key()](const TokenUsage &record) {
+                onRecord(key, record);
+            };
+        }
+        qint64 offset = readLines(it->path, it->offset, usage, keyOnRecord);
+        if (offset < 0 && QFile::exists(it->path)) {
+            qCDebug(KonsolaiLog) << "TranscriptTailer: transcript shrank, reading again:" << it->path;
+            usage = TokenUsage();
+            offset = readLines(it->path, 0, usage);
+        }
+        if (offset >= 0) {
+            it->offset = offset;
+        }
+        if (usage.totalTokens() > 0) {
+            added.insert(it.key(), usage);
+        }
+
+        if (it->retired) {
+            it = m_transcripts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return added;
+}
+
+QStringList TranscriptTailer::paths() const
+{
+    QStringList result;
+    result.reserve(m_transcripts.size());
+    for (const Transcript &transcript : m_transcripts) {
+        result.append(transcript.path);
+    }
+    return result;
+}
+
+void TranscriptTailer::clear()
+{
+    m_transcripts.clear();
+}
+
+bool TranscriptTailer::accumulateLine(const QByteArray &line, TokenUsage &usage)
+{
+    // Cheap rejection of user, system and tool lines before parsing them
+    if (line.isEmpty() || !line.contains("\"usage\"")) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        return false;
+    }
+
+    const QJsonObject obj = doc.object();
+    if (obj.value(QStringLiteral("type")).toString() != QStringLiteral("assistant")) {
+        return false;
+    }
+
+    // Token data is in message.usage
+    const QJsonObject message = obj.value(QStringLiteral("message")).toObject();
+    const QJsonObject usageObj = message.value(QStringLiteral("usage")).toObject();
+    if (usageObj.isEmpty()) {
+        return false;
+    }
+
+    auto safeU64 = [](qint64 v) -> quint64 {
+        return v > 0 ? static_cast<quint64>(v) : 0;
+    };
+
+    const quint64 inp = safeU64(usageObj.value(QStringLiteral("input_tokens")).toInteger());
+    const quint64 out = safeU64(usageObj.value(QStringLiteral("output_tokens")).toInteger());
+    const quint64 cr = safeU64(usageObj.value(QStringLiteral("cache_read_input_tokens")).toInteger());
+    const quint64 cc = safeU64(usageObj.value(QStringLiteral("cache_creation_input_tokens")).toInteger());
+
+    usage.inputTokens += inp;
+    usage.outputTokens += out;
+    usage.cacheReadTokens += cr;
+    usage.cacheCreationTokens += cc;
+
+    // Track the last message's context window usage (not cumulative — this is
+    // how many tokens were in the prompt sent to the API for this turn)
+    usage.lastContextTokens = inp + cr + cc;
+
+    const QString model = message.value(QStringLiteral("model")).toString();
+    if (!model.isEmpty()) {
+        usage.detectedModel = model;
+    }
+    return true;
+}
+
+qint64 TranscriptTailer::readLines(const QString &path, qint64 offset, TokenUsage &usage, const RecordCallback &onRecord)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // not created yet, e.g. a subagent that has not answered
+        return QFile::exists(path) ? -1 : offset;
+    }
+    if (offset > file.size()) {
+        return -1;
+    }
+    if (offset > 0 && !file.seek(offset)) {
+        return -1;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) {
+            // still being written
+            break;
+        }
+        offset += line.size();
+        if (!onRecord) {
+            accumulateLine(line.trimmed(), usage);
+            continue;
+        }
+        TokenUsage record;
+        if (accumulateLine(line.trimmed(), record)) {
+            usage.add(record);
+            usage.lastContextTokens = record.lastContextTokens;
+            if (!record.detectedModel.isEmpty()) {
+                usage.detectedModel = record.detectedModel;
+            }
+            onRecord(record);
+        }
+    }
+    return offset;
+}
+
+} // namespace Konsolai
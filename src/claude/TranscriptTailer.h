@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TRANSCRIPTTAILER_H
+#define TRANSCRIPTTAILER_H
+
+#include "konsoleprivate_export.h"
+
+#include "ClaudeSession.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace Konsolai
+{
+
+/**
+ * Follows Claude Code transcripts (JSONL) as they grow and adds up the
+ * token usage reported in them.
+ *
+ * Each transcript is read on from the offset reached by the previous
+ * poll(), and only whole lines are consumed: a line still being written is
+ * picked up complete by a later poll.  A retired transcript is read a last
+ * time and then dropped, so finished transcripts are never read again.
+ *
+ * Transcripts are append-only; one that shrank is read again from the
+ * start.
+ */
+class KONSOLEPRIVATE_EXPORT TranscriptTailer
+{
+public:
+    /** Called with each usage record as it is read, see readLines(). */
+    using RecordCallback = std::function<void(const TokenUsage &record)>;
+
+    /**
+     * Starts following the transcript at @p path under @p key.  Following
+     * an already known key under a different path starts over on the new
+     * file.
+     */
+    void follow(const QString &key, const QString &path);
+
+    /** Stops following @p key once its remaining lines have been read. */
+    void retire(const QString &key);
+
+    /**
+     * Reads the lines added since the last call and returns, per key, the
+     * usage found in them.  Keys without new usage are left out.
+     *
+     * @p onRecord gets each new record on its own; records read again from
+     * a transcript that shrank are not passed to it.
+     */
+    QHash<QString, TokenUsage> poll(const std::function<void(const QString &key, const TokenUsage &record)> &onRecord = {});
+
+    bool isFollowing(const QString &key) const
+    {
+        return m_transcripts.contains(key);
+    }
+
+    int count() const
+    {
+        return m_transcripts.size();
+    }
+
+    /** Paths of the transcripts still followed. */
+    QStringList paths() const;
+
+    void clear();
+
+    /**
+     * Adds the usage of the assistant message in @p line to @p usage.
+     * Returns false if the line carries no usage.
+     */
+    static bool accumulateLine(const QByteArray &line, TokenUsage &usage);
+
+    /**
+     * Adds the usage of the complete lines of @p path after @p offset to
+     * @p usage and returns the offset after the last complete line.
+     * Returns -1 if the file shrank below @p offset or can't be read.
+     *
+     * @p onRecord, if set, is called with the usage of each line as it is
+     * added, so rates and limits can follow single records.
+     */
+    static qint64 readLines(const QString &path, qint64 offset, TokenUsage &usage, const RecordCallback &onRecord = {});
+
+private:
+    struct Transcript {
+        QString path;
+        qint64 offset = 0;
+        bool retired = false;
+    };
+
+    QHash<QString, Transcript> m_transcripts;
+};
+
+} // namespace Konsolai
+
+#endif // TRANSCRIPTTAILER_H
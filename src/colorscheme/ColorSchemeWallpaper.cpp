@@ -18,6 +18,9 @@
 #include <QMovie>
 #include <QPainter>
 
+// STD
+#include <algorithm>
+
 using namespace Konsole;
 
 ColorSchemeWallpaper::ColorSchemeWallpaper(const QString &path,
@@ -104,40 +107,73 @@ bool ColorSchemeWallpaper::draw(QPainter &painter, const QRect& rect, qreal bgCo
         return false;
     }
 
-    painter.save();
-    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    painter.setOpacity(bgColorOpacity);
-    painter.fillRect(rect, backgroundColor);
-    painter.setOpacity(_opacity);
-
     if (_isAnimated) {
         if (_movie->state() == QMovie::NotRunning) {
             _movie->start();
         }
-        if (_picture != nullptr) {
-            _picture.reset();
-        }
-        if (_picture == nullptr) {
-            _picture = std::make_unique<QPixmap>();
-        }
-        if (_picture->isNull()) {
-            QImage currentImage = _movie->currentImage();
-            const QImage transformed = FlipImage(currentImage, _flipType);
+        if (_pictureFrame != _movie->currentFrameNumber()) {
+            _pictureFrame = _movie->currentFrameNumber();
+            const QImage transformed = FlipImage(_movie->currentImage(), _flipType);
             _picture->convertFromImage(transformed);
         }
     }
-    if (_style == Tile) {
-        painter.drawTiledPixmap(rect, *_picture, rect.topLeft());
-    } else {
-        QRectF srcRect = ScaledRect(painter.viewport().size(), _picture->size(), rect);
-        painter.drawPixmap(rect, *_picture, srcRect);
-    }
 
+    const qreal dpr = painter.device()->devicePixelRatio();
+    const QPixmap &pixmap = layer(painter.viewport().size(), dpr, bgColorOpacity, backgroundColor);
+
+    painter.save();
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.drawPixmap(QRectF(rect), pixmap, QRectF(rect.x() * dpr, rect.y() * dpr, rect.width() * dpr, rect.height() * dpr));
     painter.restore();
 
     return true;
 }
 
+const QPixmap &ColorSchemeWallpaper::layer(const QSize &viewportSize, qreal devicePixelRatio, qreal bgColorOpacity, const QColor &backgroundColor)
+{
+    const int frame = _isAnimated ? _pictureFrame : 0;
+    for (auto it = _layers.begin(); it != _layers.end(); ++it) {
+        if (it->size == viewportSize && it->devicePixelRatio == devicePixelRatio && it->bgColorOpacity == bgColorOpacity
+            && it->backgroundColor == backgroundColor.rgba()) {
+            if (it->frame != frame) {
+                break;
+            }
+            // Most recently used first
+            std::rotate(_layers.begin(), it, it + 1);
+            return _layers.front().pixmap;
+        }
+    }
+
+    // Over the background color, so drawing the layer is drawing both
+    QPixmap pixmap((QSizeF(viewportSize) * devicePixelRatio).toSize());
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        const QRect rect(QPoint(0, 0), viewportSize);
+        QPainter painter(&pixmap);
+        painter.setOpacity(bgColorOpacity);
+        painter.fillRect(rect, backgroundColor);
+        painter.setOpacity(_opacity);
+        if (_style == Tile) {
+            painter.drawTiledPixmap(rect, *_picture, QPoint(0, 0));
+        } else {
+            painter.drawPixmap(rect, *_picture, ScaledRect(viewportSize, _picture->size(), rect));
+        }
+    }
+
+    _layers.erase(std::remove_if(_layers.begin(),
+                                 _layers.end(),
+                                 [&viewportSize, devicePixelRatio](const Layer &layer) {
+                                     return layer.size == viewportSize && layer.devicePixelRatio == devicePixelRatio;
+                                 }),
+                  _layers.end());
+    if (_layers.size() >= MaxLayers) {
+        _layers.pop_back();
+    }
+    _layers.insert(_layers.begin(), Layer{viewportSize, devicePixelRatio, bgColorOpacity, backgroundColor.rgba(), frame, std::move(pixmap)});
+    return _layers.front().pixmap;
+}
+
 QString ColorSchemeWallpaper::path() const
 {
     return _path;
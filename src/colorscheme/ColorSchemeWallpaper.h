@@ -10,17 +10,18 @@
 #define COLORSCHEMEWALLPAPER_H
 // STD
 #include <memory>
+#include <vector>
 
 // Qt
 #include <QMetaType>
 #include <QMovie>
+#include <QPixmap>
 #include <QPointF>
 #include <QSharedData>
 
 // Konsole
 #include "../characters/CharacterColor.h"
 
-class QPixmap;
 class QPainter;
 
 namespace Konsole
@@ -60,7 +61,13 @@ public:
 
     void load();
 
-    /** Returns true if wallpaper available and drawn */
+    /**
+     * Returns true if wallpaper available and drawn
+     *
+     * The wallpaper is scaled or tiled over the background color once per
+     * viewport size, device pixel ratio and frame; drawing a part of it is a
+     * copy of that part.
+     */
     bool draw(QPainter &painter, const QRect& rect, qreal bgColorOpacity, const QColor &backgroundColor);
 
     bool isNull() const;
@@ -92,6 +99,22 @@ private:
     FlipType _flipType;
     bool _isAnimated;
     int _frameDelay;
+    int _pictureFrame = -1;
+
+    // The wallpaper as drawn into a viewport.  The wallpaper is shared by
+    // the terminal displays of a color scheme, so a few sizes are kept.
+    struct Layer {
+        QSize size;
+        qreal devicePixelRatio;
+        qreal bgColorOpacity;
+        QRgb backgroundColor;
+        int frame;
+        QPixmap pixmap;
+    };
+    static constexpr size_t MaxLayers = 4;
+    std::vector<Layer> _layers;
+
+    const QPixmap &layer(const QSize &viewportSize, qreal devicePixelRatio, qreal bgColorOpacity, const QColor &backgroundColor);
 
     QRectF ScaledRect(const QSize &viewportSize, const QSize &pictureSize, const QRect &rect);
     Qt::AspectRatioMode RatioMode();
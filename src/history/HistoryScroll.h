@@ -58,6 +58,13 @@ public:
     virtual void removeCells() = 0;
     virtual int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) = 0;
 
+    // Approximate number of bytes of RAM used to store the lines.
+    // Stores which keep their lines on disk report 0.
+    virtual size_t memoryUsage() const
+    {
+        return 0;
+    }
+
     //
     // FIXME:  Passing around constant references to HistoryType instances
     // is very unsafe, because those references will no longer
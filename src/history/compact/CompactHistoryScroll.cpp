@@ -9,6 +9,9 @@
 #include "CompactHistoryScroll.h"
 #include "CompactHistoryType.h"
 
+// std
+#include <algorithm>
+
 using namespace Konsole;
 
 CompactHistoryScroll::CompactHistoryScroll(const unsigned int maxLineCount)
@@ -29,12 +32,15 @@ void CompactHistoryScroll::removeLinesFromTop(size_t lines)
     } else {
         _lineDatas.clear();
         _cells.clear();
+        _styles.clear();
     }
 }
 
-void CompactHistoryScroll::addCells(const Character a[], const int count)
+void CompactHistoryScroll::appendCells(const Character a[], const int count)
 {
-    _cells.insert(_cells.end(), a, a + count);
+    for (int i = 0; i < count; ++i) {
+        _cells.push_back(_styles.pack(a[i]));
+    }
 
     // store the (biased) start of next line + default flag
     // the flag is later updated when addLine is called
@@ -43,19 +49,23 @@ void CompactHistoryScroll::addCells(const Character a[], const int count)
     if (_lineDatas.size() > _maxLineCount + 1) {
         removeLinesFromTop(1);
     }
+
+    // drop the styles only used by lines which scrolled out
+    if (_styles.size() > _styleCompactThreshold) {
+        _styles.compact(_cells.begin(), _cells.end());
+        _styleCompactThreshold = std::max(MinStyleCompactThreshold, 2 * _styles.size());
+    }
 }
 
-void CompactHistoryScroll::addCellsMove(Character characters[], const int count)
+void CompactHistoryScroll::addCells(const Character a[], const int count)
 {
-    std::move(characters, characters + count, std::back_inserter(_cells));
-
-    // store the (biased) start of next line + default flag
-    // the flag is later updated when addLine is called
-    _lineDatas.push_back({static_cast<unsigned int>(_cells.size() + _indexBias), LineProperty()});
+    appendCells(a, count);
+}
 
-    if (_lineDatas.size() > _maxLineCount + 1) {
-        removeLinesFromTop(1);
-    }
+void CompactHistoryScroll::addCellsMove(Character characters[], const int count)
+{
+    // the cells are packed, nothing to gain from moving
+    appendCells(characters, count);
 }
 
 void CompactHistoryScroll::addLine(const LineProperty lineProperty)
@@ -95,7 +105,7 @@ void CompactHistoryScroll::getCells(const int lineNumber, const int startColumn,
 
     auto startCopy = _cells.begin() + startOfLine(lineNumber) + startColumn;
     auto endCopy = startCopy + count;
-    std::copy(startCopy, endCopy, buffer);
+    _styles.unpack(startCopy, endCopy, buffer);
 }
 
 void CompactHistoryScroll::setMaxNbLines(const int lineCount)
@@ -125,6 +135,7 @@ void CompactHistoryScroll::removeCells()
     } else {
         _cells.clear();
         _lineDatas.clear();
+        _styles.clear();
     }
 }
 
@@ -199,3 +210,8 @@ int CompactHistoryScroll::reflowLines(const int columns, std::map<int, int> *del
 
     return deletedLines;
 }
+
+size_t CompactHistoryScroll::memoryUsage() const
+{
+    return _cells.size() * sizeof(PackedCharacter) + _lineDatas.capacity() * sizeof(LineData) + _styles.memoryUsage();
+}
@@ -8,6 +8,7 @@
 #ifndef COMPACTHISTORYSCROLL_H
 #define COMPACTHISTORYSCROLL_H
 
+#include "characters/CharacterStyleTable.h"
 #include "history/HistoryScroll.h"
 #include "konsoleprivate_export.h"
 #include <deque>
@@ -40,11 +41,22 @@ public:
 
     int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) override;
 
+    size_t memoryUsage() const override;
+
 private:
     /**
-     * This is the actual buffer that contains the cells
+     * This is the actual buffer that contains the cells, each referring to
+     * its colors and rendition in _styles
+     */
+    std::deque<PackedCharacter> _cells;
+
+    /**
+     * The distinct styles of the cells, compacted once it has grown past
+     * _styleCompactThreshold
      */
-    std::deque<Character> _cells;
+    CharacterStyleTable _styles;
+    int _styleCompactThreshold = MinStyleCompactThreshold;
+    static constexpr int MinStyleCompactThreshold = 16384;
 
     /**
      * Each entry contains the start of the next line and the current line's
@@ -60,7 +72,7 @@ private:
      * characters, but CompactHistoryScroll is limited by the UI to 1_000_000
      * lines (see historyLineSpinner in src/widgets/HistorySizeWidget.ui), so
      * enough for 1_000_000 lines of an average ~4295 length (and each
-     * Character takes 16 bytes, so that's 64Gb!).
+     * cell takes 8 bytes, so that's 32Gb!).
      */
     struct LineData {
         unsigned int index;
@@ -83,6 +95,11 @@ private:
      */
     void removeLinesFromTop(size_t lines);
 
+    /**
+     * Append @p count cells and the start of the next line
+     */
+    void appendCells(const Character a[], const int count);
+
     inline int lineLen(const int line) const
     {
         return line == 0 ? _lineDatas.at(0).index - _indexBias : _lineDatas.at(line).index - _lineDatas.at(line - 1).index;
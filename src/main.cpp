@@ -12,7 +12,9 @@
 #include "Application.h"
 #include "KonsoleSettings.h"
 #include "MainWindow.h"
+#include "StartupTrace.h"
 #include "ViewManager.h"
+#include "claude/IdleTaskScheduler.h"
 #include "config-konsole.h"
 #include "widgets/ViewContainer.h"
 
@@ -22,8 +24,12 @@
 #include <QDir>
 #include <QProxyStyle>
 #include <QStandardPaths>
+#include <QTimer>
 #include <qplatformdefs.h>
 
+// std
+#include <optional>
+
 #ifdef Q_OS_LINUX
 #include <QFile>
 #include <QTextStream>
@@ -312,6 +318,8 @@ int main(int argc, char *argv[])
     QElapsedTimer timer;
     timer.start();
 #endif
+    // Starts the trace clock; set KONSOLAI_STARTUP_TRACE=<file> to record
+    std::optional<StartupTrace::Span> preAppSpan(std::in_place, "main: before QApplication");
 
     /**
      * trigger initialisation of proper icon theme
@@ -330,6 +338,8 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    preAppSpan.reset();
+    std::optional<StartupTrace::Span> appSetupSpan(std::in_place, "main: QApplication setup");
     auto app = new QApplication(argc, argv);
 
 #if HAVE_STYLE_MANAGER
@@ -430,9 +440,13 @@ int main(int argc, char *argv[])
     needToDeleteQApplication = false;
 #endif
 
+    appSetupSpan.reset();
+
     // If we reach this location, there was no existing copy of Konsole
     // running, so create a new instance.
+    std::optional<StartupTrace::Span> appSpan(std::in_place, "Application");
     Application konsoleApp(parser, customCommand);
+    appSpan.reset();
 
 #if HAVE_DBUS
     // The activateRequested() signal is emitted when a second instance
@@ -446,13 +460,33 @@ int main(int argc, char *argv[])
         // Do not finish starting Konsole due to:
         // 1. An argument was given to just printed info
         // 2. An invalid situation occurred
+        std::optional<StartupTrace::Span> newInstanceSpan(std::in_place, "Application::newInstance");
         const bool continueStarting = (konsoleApp.newInstance() != 0);
+        newInstanceSpan.reset();
         if (!continueStarting) {
             delete app;
             return 0;
         }
     }
 
+    // The first event loop iteration shows and paints the first terminal;
+    // only then let the deferred Claude work (registry, remote, agent scans) run.
+    QTimer::singleShot(0, app, []() {
+        StartupTrace::instance()->mark("first-terminal-interactive");
+        StartupTrace::instance()->finish();
+        if (auto *scheduler = Konsolai::IdleTaskScheduler::instance()) {
+            QObject::connect(
+                scheduler,
+                &Konsolai::IdleTaskScheduler::drained,
+                scheduler,
+                []() {
+                    StartupTrace::instance()->end();
+                },
+                Qt::SingleShotConnection);
+            scheduler->release();
+        }
+    });
+
 #ifdef PROFILE_STARTUP
     qDebug() << "Construction completed in" << timer.elapsed() << "ms";
     QTimer::singleShot(0, [&timer]() {
@@ -9,6 +9,7 @@
 // Own
 #include "ProfileManager.h"
 #include "PopStackOnExit.h"
+#include "StartupTrace.h"
 
 // Qt
 #include <QDir>
@@ -70,7 +71,10 @@ ProfileManager::ProfileManager()
         defaultProfileFileName = group.readEntry("DefaultProfile", "");
     }
 
-    loadAllProfiles(defaultProfileFileName);
+    {
+        StartupTrace::Span span("ProfileManager::loadAllProfiles");
+        loadAllProfiles(defaultProfileFileName);
+    }
     loadShortcuts();
 
     Q_ASSERT(_profiles.size() > 0);
@@ -20,9 +20,17 @@
 
 // Konsole
 #include "KonsoleSettings.h"
+#include "ScreenWindow.h"
+#include "session/SessionController.h"
+#include "terminalDisplay/TerminalDisplay.h"
 
 using namespace Konsole;
 
+// shortest input that triggers a search through the output of the tabs
+static constexpr int MinContentSearchLength = 3;
+// time to wait for more keystrokes before searching the output
+static constexpr int ContentSearchDelay = 200;
+
 /* ------------------------------------------------------------------------- */
 /*                                                                           */
 /*                            Fuzzy Search Model                             */
@@ -60,6 +68,11 @@ protected:
             return false;
         }
 
+        // content hits were already matched against this pattern
+        if (sm->isContentHit(sourceRow)) {
+            return true;
+        }
+
         QStringView tabNameMatchPattern = pattern;
 
         const QString &name = sm->idxToName(sourceRow);
@@ -125,7 +138,7 @@ SearchTabs::SearchTabs(ViewManager *viewManager)
     m_inputLine->addAction(QIcon::fromTheme(QStringLiteral("search")), QLineEdit::LeadingPosition);
     m_inputLine->setTextMargins(QMargins() + style()->pixelMetric(QStyle::PM_ButtonMargin));
     m_inputLine->setPlaceholderText(i18nc("@label:textbox", "Search..."));
-    m_inputLine->setToolTip(i18nc("@info:tooltip", "Enter a tab name to search for here"));
+    m_inputLine->setToolTip(i18nc("@info:tooltip", "Enter a tab name or text from the output of a tab to search for here"));
     m_inputLine->setCursor(Qt::IBeamCursor);
     m_inputLine->setFont(QApplication::font());
     m_inputLine->setFrame(false);
@@ -172,6 +185,29 @@ SearchTabs::SearchTabs(ViewManager *viewManager)
             m_listView->viewport()->update();
             reselectFirst();
         }
+
+        // search the output of all tabs once the user pauses typing
+        m_contentSearch->cancel();
+        m_model->clearContentHits();
+        if (text.size() >= MinContentSearchLength) {
+            m_contentSearchTimer.start();
+        } else {
+            m_contentSearchTimer.stop();
+        }
+    });
+
+    // content search streams its hits in as each block of output is matched
+    m_contentSearch = new SearchTabsContentSearch(this);
+    m_contentSearchTimer.setSingleShot(true);
+    m_contentSearchTimer.setInterval(ContentSearchDelay);
+    connect(&m_contentSearchTimer, &QTimer::timeout, this, [this]() {
+        m_contentSearch->start(m_viewManager, m_inputLine->text());
+    });
+    connect(m_contentSearch, &SearchTabsContentSearch::hitsFound, this, [this](const QVector<ContentHit> &hits) {
+        m_model->addContentHits(hits);
+        if (!m_listView->currentIndex().isValid()) {
+            reselectFirst();
+        }
     });
 
     setHidden(true);
@@ -255,14 +291,46 @@ void SearchTabs::slotReturnPressed()
     // switch to tab using the unique ViewProperties identifier
     // (the view identifier is off by 1)
     const QModelIndex index = m_listView->currentIndex();
-    m_viewManager->setCurrentView(index.data(SearchTabsModel::View).toInt() - 1);
+    const int view = index.data(SearchTabsModel::View).toInt();
+    m_viewManager->setCurrentView(view - 1);
 
+    // content hit, scroll to the matching line
+    const int line = index.data(SearchTabsModel::Line).toInt();
+    if (line >= 0) {
+        jumpToLine(view, line);
+    }
+
+    m_contentSearch->cancel();
     hide();
     deleteLater();
 
     window()->setFocus();
 }
 
+void SearchTabs::jumpToLine(int view, int line)
+{
+    auto *controller = qobject_cast<SessionController *>(ViewProperties::propertiesById(view));
+    if (controller == nullptr || controller->view().isNull()) {
+        return;
+    }
+
+    QPointer<ScreenWindow> window = controller->view()->screenWindow();
+    if (window.isNull()) {
+        return;
+    }
+
+    // the output may have been trimmed since the search ran
+    line = qMin(line, window->lineCount() - 1);
+
+    if ((line < window->currentLine()) || (line >= (window->currentLine() + window->windowLines()))) {
+        window->scrollTo(qMax(0, line - window->windowLines() / 2));
+    }
+
+    window->setTrackOutput(false);
+    window->notifyOutputChanged();
+    window->setCurrentResultLine(line);
+}
+
 void SearchTabs::updateViewGeometry()
 {
     // find MainWindow rectangle
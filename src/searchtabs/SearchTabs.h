@@ -13,6 +13,7 @@
 #include <QEvent>
 #include <QFrame>
 #include <QLineEdit>
+#include <QTimer>
 #include <QTreeView>
 
 // Konsole
@@ -48,6 +49,12 @@ private:
      */
     void slotReturnPressed();
 
+    /**
+     * Scroll the terminal of the tab @p view so that @p line
+     * is visible and mark it as the current search result
+     */
+    void jumpToLine(int view, int line);
+
 private:
     ViewManager *m_viewManager;
 
@@ -63,6 +70,12 @@ private:
      * fuzzy filter model
      */
     SearchTabsFilterProxyModel *m_proxyModel = nullptr;
+
+    /**
+     * searches the output of all tabs, restarted while typing
+     */
+    SearchTabsContentSearch *m_contentSearch = nullptr;
+    QTimer m_contentSearchTimer;
 };
 
 }
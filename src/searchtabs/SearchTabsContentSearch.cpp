@@ -0,0 +1,264 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SearchTabsContentSearch.h"
+
+// Qt
+#include <QFutureWatcher>
+#include <QTextStream>
+#include <QTimer>
+#include <QtConcurrent>
+
+// Konsole
+#include "Emulation.h"
+#include "ViewManager.h"
+#include "decoders/PlainTextDecoder.h"
+#include "session/Session.h"
+#include "session/SessionController.h"
+
+using namespace Konsole;
+
+namespace
+{
+// Longest snippet shown for a hit; the match is kept roughly centered.
+constexpr int MaxSnippetLength = 120;
+
+bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+QString makeSnippet(const QString &line, qsizetype pos, qsizetype length)
+{
+    const QString trimmed = line.trimmed();
+    if (trimmed.size() <= MaxSnippetLength) {
+        return trimmed;
+    }
+
+    const qsizetype start = qBound<qsizetype>(0, pos - (MaxSnippetLength - length) / 2, line.size() - MaxSnippetLength);
+    QString snippet = line.mid(start, MaxSnippetLength).trimmed();
+    if (start > 0) {
+        snippet.prepend(QChar(0x2026));
+    }
+    if (start + MaxSnippetLength < line.size()) {
+        snippet.append(QChar(0x2026));
+    }
+    return snippet;
+}
+}
+
+SearchTabsContentSearch::SearchTabsContentSearch(QObject *parent)
+    : QObject(parent)
+    , m_generation(std::make_shared<std::atomic<quint64>>(0))
+{
+}
+
+SearchTabsContentSearch::~SearchTabsContentSearch()
+{
+    // Let blocks still running on the pool bail out early.
+    cancel();
+}
+
+void SearchTabsContentSearch::start(ViewManager *viewManager, const QString &pattern)
+{
+    cancel();
+
+    m_pattern = pattern;
+    if (m_pattern.isEmpty() || viewManager == nullptr) {
+        return;
+    }
+
+    const QList<ViewProperties *> viewProperties = viewManager->viewProperties();
+    for (ViewProperties *properties : viewProperties) {
+        auto *controller = qobject_cast<SessionController *>(properties);
+        if (controller == nullptr || controller->session().isNull()) {
+            continue;
+        }
+
+        PendingSession pending;
+        pending.controller = controller;
+        pending.view = controller->identifier();
+        pending.tabName = controller->title();
+        // Search from the bottom up so the most recent output is reported first
+        pending.nextLine = controller->session()->emulation()->lineCount();
+        m_queue.enqueue(pending);
+    }
+
+    scheduleNextChunk();
+}
+
+void SearchTabsContentSearch::cancel()
+{
+    m_generation->fetch_add(1);
+    m_queue.clear();
+    m_hitCounts.clear();
+    m_pendingChunks = 0;
+}
+
+void SearchTabsContentSearch::scheduleNextChunk()
+{
+    if (m_chunkScheduled) {
+        return;
+    }
+    m_chunkScheduled = true;
+    // Decode one block per event loop iteration so input and painting stay responsive
+    QTimer::singleShot(0, this, &SearchTabsContentSearch::processNextChunk);
+}
+
+void SearchTabsContentSearch::processNextChunk()
+{
+    m_chunkScheduled = false;
+
+    if (m_queue.isEmpty()) {
+        if (m_pendingChunks == 0) {
+            Q_EMIT finished();
+        }
+        return;
+    }
+
+    PendingSession &pending = m_queue.head();
+    if (pending.controller.isNull() || pending.controller->session().isNull() || pending.nextLine <= 0
+        || m_hitCounts.value(pending.view) >= MaxHitsPerTab) {
+        m_queue.dequeue();
+        scheduleNextChunk();
+        return;
+    }
+
+    Emulation *emulation = pending.controller->session()->emulation();
+    const int endLine = qMin(pending.nextLine, emulation->lineCount());
+    const int startLine = qMax(0, endLine - ChunkLines);
+    pending.nextLine = startLine;
+
+    ContentChunk chunk;
+    chunk.view = pending.view;
+    chunk.tabName = pending.tabName;
+    chunk.startLine = startLine;
+
+    if (endLine > startLine) {
+        QString text;
+        QTextStream stream(&text);
+        PlainTextDecoder decoder;
+        decoder.setRecordLinePositions(true);
+        decoder.begin(&stream);
+        emulation->writeToStream(&decoder, startLine, endLine - 1);
+        decoder.end();
+
+        const QList<int> positions = decoder.linePositions();
+        chunk.lines.reserve(positions.size());
+        for (int i = 0; i < positions.size(); ++i) {
+            const int from = positions[i];
+            const int to = (i + 1 < positions.size()) ? positions[i + 1] : text.size();
+            QString line = text.mid(from, to - from);
+            if (line.endsWith(QLatin1Char('\n'))) {
+                line.chop(1);
+            }
+            chunk.lines.append(line);
+        }
+    }
+
+    if (pending.nextLine <= 0) {
+        m_queue.dequeue();
+    }
+
+    if (!chunk.lines.isEmpty()) {
+        const quint64 generation = m_generation->load();
+        const std::shared_ptr<std::atomic<quint64>> generationRef = m_generation;
+        const QString pattern = m_pattern;
+        const int view = chunk.view;
+
+        ++m_pendingChunks;
+        auto future = QtConcurrent::run([chunk = std::move(chunk), pattern, generationRef, generation]() {
+            return matchChunk(chunk, pattern, generationRef.get(), generation);
+        });
+
+        auto *watcher = new QFutureWatcher<QVector<ContentHit>>(this);
+        connect(watcher, &QFutureWatcher<QVector<ContentHit>>::finished, this, [this, watcher, generation, view]() {
+            chunkFinished(generation, view, watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(future);
+    }
+
+    scheduleNextChunk();
+}
+
+void SearchTabsContentSearch::chunkFinished(quint64 generation, int view, const QVector<ContentHit> &hits)
+{
+    if (generation != m_generation->load()) {
+        return;
+    }
+
+    --m_pendingChunks;
+
+    if (!hits.isEmpty()) {
+        int &count = m_hitCounts[view];
+        const int room = MaxHitsPerTab - count;
+        if (room > 0) {
+            const QVector<ContentHit> accepted = hits.size() > room ? hits.mid(0, room) : hits;
+            count += accepted.size();
+            Q_EMIT hitsFound(accepted);
+        }
+    }
+
+    if (m_pendingChunks == 0 && m_queue.isEmpty()) {
+        Q_EMIT finished();
+    }
+}
+
+QVector<ContentHit>
+SearchTabsContentSearch::matchChunk(const ContentChunk &chunk, const QString &pattern, const std::atomic<quint64> *generation, quint64 expectedGeneration)
+{
+    QVector<ContentHit> hits;
+    if (pattern.isEmpty()) {
+        return hits;
+    }
+
+    // Walk bottom-up so the newest lines come first, matching the chunk order
+    for (int i = chunk.lines.size() - 1; i >= 0; --i) {
+        if (generation != nullptr && (i % 256) == 0 && generation->load(std::memory_order_relaxed) != expectedGeneration) {
+            break;
+        }
+
+        const QString &line = chunk.lines.at(i);
+        const qsizetype pos = line.indexOf(pattern, 0, Qt::CaseInsensitive);
+        if (pos < 0) {
+            continue;
+        }
+
+        ContentHit hit;
+        hit.view = chunk.view;
+        hit.tabName = chunk.tabName;
+        hit.line = chunk.startLine + i;
+        hit.snippet = makeSnippet(line, pos, pattern.size());
+        hit.score = scoreMatch(line, pattern, pos);
+        hits.append(hit);
+    }
+
+    return hits;
+}
+
+int SearchTabsContentSearch::scoreMatch(QStringView line, QStringView pattern, qsizetype pos)
+{
+    int score = 10;
+
+    // Exact case beats case-insensitive
+    if (line.mid(pos, pattern.size()) == pattern) {
+        score += 20;
+    }
+
+    // Whole word matches beat substrings
+    if (pos == 0 || !isWordChar(line.at(pos - 1))) {
+        score += 10;
+    }
+    const qsizetype end = pos + pattern.size();
+    if (end >= line.size() || !isWordChar(line.at(end))) {
+        score += 10;
+    }
+
+    return score;
+}
+
+#include "moc_SearchTabsContentSearch.cpp"
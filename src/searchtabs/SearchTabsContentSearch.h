@@ -0,0 +1,133 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// std
+#include <atomic>
+#include <memory>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+
+class SessionController;
+class ViewManager;
+
+/**
+ * A single match of the content search: a line of a tab's screen or history
+ * which contains the search pattern.
+ */
+struct ContentHit {
+    int view = 0;
+    QString tabName;
+    int line = -1;
+    QString snippet;
+    int score = 0;
+};
+
+/**
+ * A block of consecutive decoded lines taken from one session's output.
+ * Chunks are produced on the GUI thread and matched on the thread pool.
+ */
+struct ContentChunk {
+    int view = 0;
+    QString tabName;
+    int startLine = 0;
+    QStringList lines;
+};
+
+/**
+ * Searches the screen and scrollback of every open tab for a text pattern.
+ *
+ * Screen and history are only ever read on the GUI thread, a block of lines
+ * at a time, so that the terminal keeps processing output while a search is
+ * running.  Matching the decoded blocks happens on the global thread pool and
+ * hits are reported through hitsFound() as soon as each block is done.
+ *
+ * Calling start() or cancel() invalidates every block still queued or running
+ * for the previous search; their results are silently dropped.
+ */
+class KONSOLEPRIVATE_EXPORT SearchTabsContentSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchTabsContentSearch(QObject *parent = nullptr);
+    ~SearchTabsContentSearch() override;
+
+    /** Number of lines decoded per block handed to the thread pool. */
+    static constexpr int ChunkLines = 4000;
+
+    /** Upper bound of hits reported per tab, to keep the list usable. */
+    static constexpr int MaxHitsPerTab = 200;
+
+    /**
+     * Starts searching all tabs of @p viewManager for @p pattern
+     * (case-insensitive).  Any search in progress is cancelled first.
+     */
+    void start(ViewManager *viewManager, const QString &pattern);
+
+    /** Cancels the current search, if any. */
+    void cancel();
+
+    bool isRunning() const
+    {
+        return m_pendingChunks > 0 || !m_queue.isEmpty();
+    }
+
+    /**
+     * Matches @p pattern against every line of @p chunk and returns the
+     * ranked hits.  Stops early and returns what it has when @p generation
+     * no longer equals @p expectedGeneration.
+     */
+    static QVector<ContentHit>
+    matchChunk(const ContentChunk &chunk, const QString &pattern, const std::atomic<quint64> *generation = nullptr, quint64 expectedGeneration = 0);
+
+    /** Ranks a line containing @p pattern at @p pos; higher is better. */
+    static int scoreMatch(QStringView line, QStringView pattern, qsizetype pos);
+
+Q_SIGNALS:
+    /** Emitted on the GUI thread for each block of lines that produced hits. */
+    void hitsFound(const QVector<ContentHit> &hits);
+
+    /** Emitted once every tab has been searched completely. */
+    void finished();
+
+private:
+    struct PendingSession {
+        QPointer<SessionController> controller;
+        int view = 0;
+        QString tabName;
+        int nextLine = 0;
+    };
+
+    void scheduleNextChunk();
+    void processNextChunk();
+    void chunkFinished(quint64 generation, int view, const QVector<ContentHit> &hits);
+
+    QQueue<PendingSession> m_queue;
+    QHash<int, int> m_hitCounts;
+    QString m_pattern;
+    std::shared_ptr<std::atomic<quint64>> m_generation;
+    int m_pendingChunks = 0;
+    bool m_chunkScheduled = false;
+};
+
+}
+
+Q_DECLARE_METATYPE(Konsole::ContentHit)
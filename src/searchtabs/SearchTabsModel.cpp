@@ -7,6 +7,9 @@
 // Own
 #include "SearchTabsModel.h"
 
+// std
+#include <algorithm>
+
 // Konsole
 #include "ViewProperties.h"
 
@@ -40,12 +43,23 @@ QVariant SearchTabsModel::data(const QModelIndex &idx, int role) const
     const TabEntry &tab = m_tabEntries.at(idx.row());
     switch (role) {
     case Qt::DisplayRole:
+        if (tab.isContentHit()) {
+            return QStringLiteral("%1:%2  %3").arg(tab.name).arg(tab.line + 1).arg(tab.snippet);
+        }
+        return tab.name;
+    case Qt::ToolTipRole:
+        if (tab.isContentHit()) {
+            return tab.snippet;
+        }
+        return {};
     case Role::Name:
         return tab.name;
     case Role::Score:
         return tab.score;
     case Role::View:
         return tab.view;
+    case Role::Line:
+        return tab.line;
     default:
         return {};
     }
@@ -64,6 +78,37 @@ void SearchTabsModel::refresh(ViewManager *viewManager)
     }
 
     beginResetModel();
+    m_tabCount = tabs.size();
     m_tabEntries = std::move(tabs);
     endResetModel();
 }
+
+void SearchTabsModel::addContentHits(const QVector<ContentHit> &hits)
+{
+    for (const ContentHit &hit : hits) {
+        // Binary search the hit section for the insert position
+        auto first = m_tabEntries.begin() + m_tabCount;
+        auto it = std::upper_bound(first, m_tabEntries.end(), hit, [](const ContentHit &h, const TabEntry &entry) {
+            if (h.score != entry.score) {
+                return h.score > entry.score;
+            }
+            return h.line > entry.line;
+        });
+        const int row = static_cast<int>(it - m_tabEntries.begin());
+
+        beginInsertRows(QModelIndex(), row, row);
+        m_tabEntries.insert(row, TabEntry{hit.tabName, hit.view, hit.score, hit.line, hit.snippet});
+        endInsertRows();
+    }
+}
+
+void SearchTabsModel::clearContentHits()
+{
+    if (m_tabEntries.size() == m_tabCount) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), m_tabCount, m_tabEntries.size() - 1);
+    m_tabEntries.resize(m_tabCount);
+    endRemoveRows();
+}
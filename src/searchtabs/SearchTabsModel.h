@@ -13,6 +13,7 @@
 
 // Konsole
 #include "ViewManager.h"
+#include "SearchTabsContentSearch.h"
 
 namespace Konsole
 {
@@ -21,15 +22,24 @@ struct TabEntry {
     QString name;
     int view;
     int score = -1;
+    // Content search hits only: line in the tab's output and its text
+    int line = -1;
+    QString snippet;
+
+    bool isContentHit() const
+    {
+        return line >= 0;
+    }
 };
 
-class SearchTabsModel : public QAbstractTableModel
+class KONSOLEPRIVATE_EXPORT SearchTabsModel : public QAbstractTableModel
 {
 public:
     enum Role {
         Name = Qt::UserRole + 1,
         View,
         Score,
+        Line,
     };
     explicit SearchTabsModel(QObject *parent = nullptr);
 
@@ -38,6 +48,13 @@ public:
     QVariant data(const QModelIndex &idx, int role) const override;
     void refresh(ViewManager *viewManager);
 
+    /**
+     * Inserts content search hits below the tab entries, keeping them
+     * ordered by descending score and then by most recent line.
+     */
+    void addContentHits(const QVector<ContentHit> &hits);
+    void clearContentHits();
+
     bool isValid(int row) const
     {
         return row >= 0 && row < m_tabEntries.size();
@@ -53,6 +70,11 @@ public:
         return m_tabEntries.at(row).name;
     }
 
+    bool isContentHit(int row) const
+    {
+        return m_tabEntries.at(row).isContentHit();
+    }
+
     int idxScore(const QModelIndex &idx) const
     {
         if (!idx.isValid()) {
@@ -63,6 +85,8 @@ public:
 
 private:
     QVector<TabEntry> m_tabEntries;
+    // Rows [0, m_tabCount) are tabs, the remaining rows are content hits
+    int m_tabCount = 0;
 };
 
 }
@@ -0,0 +1,154 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "EmulationScheduler.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
+
+// std
+#include <utility>
+#include <vector>
+
+// Konsole
+#include "Session.h"
+
+using namespace Konsole;
+
+namespace
+{
+// Calls to make on the GUI thread after the turn, set while parsing for the scheduler
+thread_local std::vector<std::function<void()>> *deferredCalls = nullptr;
+
+struct Job {
+    QPointer<Session> session;
+    qsizetype parsed = 0;
+    std::vector<std::function<void()>> deferred;
+};
+}
+
+EmulationScheduler::EmulationScheduler()
+{
+    // the GUI thread takes part while it waits
+    _pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    _pool.setObjectName(QStringLiteral("EmulationScheduler"));
+}
+
+EmulationScheduler::~EmulationScheduler()
+{
+    _pool.waitForDone();
+}
+
+Q_GLOBAL_STATIC(EmulationScheduler, theEmulationScheduler)
+EmulationScheduler *EmulationScheduler::instance()
+{
+    return theEmulationScheduler;
+}
+
+void EmulationScheduler::schedule(Session *session)
+{
+    if (session == nullptr) {
+        return;
+    }
+    if (!_sessions.contains(session)) {
+        _sessions.append(session);
+    }
+    if (!_turnScheduled) {
+        _turnScheduled = true;
+        QMetaObject::invokeMethod(this, &EmulationScheduler::runTurn, Qt::QueuedConnection);
+    }
+}
+
+int EmulationScheduler::maxThreadCount() const
+{
+    return _pool.maxThreadCount();
+}
+
+void EmulationScheduler::setMaxThreadCount(int count)
+{
+    _pool.setMaxThreadCount(qMax(1, count));
+}
+
+void EmulationScheduler::runOnGuiThread(std::function<void()> call)
+{
+    if (deferredCalls != nullptr) {
+        deferredCalls->push_back(std::move(call));
+    } else {
+        call();
+    }
+}
+
+bool EmulationScheduler::isParsing()
+{
+    return deferredCalls != nullptr;
+}
+
+void EmulationScheduler::runTurn()
+{
+    _turnScheduled = false;
+
+    std::vector<Job> workerJobs;
+    std::vector<Job> guiJobs;
+    for (const QPointer<Session> &session : std::exchange(_sessions, {})) {
+        if (session && session->hasPendingOutput()) {
+            (session->canParseOnWorkerThread() ? workerJobs : guiJobs).push_back(Job{session});
+        }
+    }
+    if (workerJobs.empty() && guiJobs.empty()) {
+        return;
+    }
+
+    QElapsedTimer turn;
+    turn.start();
+    // Every session gets at least one piece per turn, however busy the others are
+    const auto parse = [&turn](Job &job, qint64 deadline) {
+        do {
+            const qsizetype parsed = job.session->parsePendingOutput(MaxParseLength);
+            if (parsed == 0) {
+                break;
+            }
+            job.parsed += parsed;
+        } while (turn.elapsed() < deadline);
+    };
+
+    if (!workerJobs.empty()) {
+        QtConcurrent::blockingMap(&_pool, workerJobs, [&parse](Job &job) {
+            deferredCalls = &job.deferred;
+            parse(job, TurnBudgetMs);
+            deferredCalls = nullptr;
+        });
+        for (Job &job : workerJobs) {
+            for (const auto &call : job.deferred) {
+                call();
+            }
+        }
+    }
+
+    const qint64 guiDeadline = turn.elapsed() + TurnBudgetMs;
+    for (Job &job : guiJobs) {
+        if (job.session) {
+            parse(job, guiDeadline);
+        }
+    }
+
+    for (std::vector<Job> *jobs : {&workerJobs, &guiJobs}) {
+        for (Job &job : *jobs) {
+            if (!job.session || job.parsed == 0) {
+                continue;
+            }
+            job.session->handleActivity();
+            // The pty doesn't tell again before everything was taken
+            if (job.session && job.session->hasPendingOutput()) {
+                schedule(job.session);
+            }
+        }
+    }
+}
+
+#include "moc_EmulationScheduler.cpp"
@@ -0,0 +1,95 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef EMULATIONSCHEDULER_H
+#define EMULATIONSCHEDULER_H
+
+// Qt
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+
+// std
+#include <functional>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class Session;
+
+/**
+ * Parses the output of many terminals at once, on a pool of worker
+ * threads, for sessions with the ThreadedEmulation setting.
+ *
+ * Normally each terminal parses its output on the GUI thread as it
+ * arrives, so with many busy terminals the parsing adds up and input
+ * waits for all of it.  Sessions whose output is parsed here instead
+ * leave it in their pty, see Pty::setPullMode(), and are scheduled with
+ * schedule().  Once per turn of the event loop the scheduler parses the
+ * pending output of all of them in parallel, for up to TurnBudgetMs, and
+ * joins the workers before returning.
+ *
+ * The GUI thread waits while the workers parse, so the screens are never
+ * read and written at the same time: painting copies the lines it shows
+ * through ScreenWindow::getImage() between turns, and input and resizes
+ * are handled between turns too.  The GUI thread is blocked for about as
+ * long as the busiest terminal takes rather than for all of them.
+ *
+ * Parsing may want to do things which belong to the GUI thread, such as
+ * starting timers, updating views or showing notifications.  Such code
+ * goes through runOnGuiThread(), which runs it once the workers are done.
+ *
+ * Sessions which can't be parsed on a worker at the moment (see
+ * Session::canParseOnWorkerThread()) are parsed on the GUI thread in the
+ * same turn.
+ */
+class KONSOLEPRIVATE_EXPORT EmulationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    EmulationScheduler();
+    ~EmulationScheduler() override;
+
+    /** Returns the scheduler shared by all sessions. */
+    static EmulationScheduler *instance();
+
+    /** @p session has output to parse; it is parsed in the next turn. */
+    void schedule(Session *session);
+
+    /** Parses the output of the scheduled sessions now. */
+    void runTurn();
+
+    /** The number of worker threads. */
+    int maxThreadCount() const;
+    void setMaxThreadCount(int count);
+
+    /**
+     * Runs @p call right away, unless the calling thread parses for the
+     * scheduler; then it runs on the GUI thread when the turn is over.
+     */
+    static void runOnGuiThread(std::function<void()> call);
+
+    /** True while the calling thread parses for the scheduler. */
+    static bool isParsing();
+
+    // The time spent parsing in one turn, before the event loop continues
+    static constexpr int TurnBudgetMs = 8;
+    // Output parsed in one go
+    static constexpr qsizetype MaxParseLength = 64 * 1024;
+
+private:
+    QList<QPointer<Session>> _sessions;
+    QThreadPool _pool;
+    bool _turnScheduled = false;
+};
+
+}
+
+#endif // EMULATIONSCHEDULER_H
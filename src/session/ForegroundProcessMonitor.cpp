@@ -0,0 +1,266 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ForegroundProcessMonitor.h"
+
+// Qt
+#include <QFile>
+#include <QSocketNotifier>
+
+// std
+#include <algorithm>
+
+// Konsole
+#include "Pty.h"
+#include "konsoledebug.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Konsole;
+
+ForegroundProcessMonitor::ForegroundProcessMonitor()
+{
+    _clock.start();
+
+    _checkTimer.setSingleShot(true);
+    connect(&_checkTimer, &QTimer::timeout, this, &ForegroundProcessMonitor::checkDue);
+
+    _pollTimer.setInterval(FallbackPollMs);
+    connect(&_pollTimer, &QTimer::timeout, this, &ForegroundProcessMonitor::pollJobs);
+}
+
+ForegroundProcessMonitor::~ForegroundProcessMonitor()
+{
+    for (Entry &entry : _entries) {
+        closeExitWatch(entry);
+    }
+}
+
+Q_GLOBAL_STATIC(ForegroundProcessMonitor, theForegroundProcessMonitor)
+ForegroundProcessMonitor *ForegroundProcessMonitor::instance()
+{
+    return theForegroundProcessMonitor;
+}
+
+void ForegroundProcessMonitor::watch(Pty *pty)
+{
+    if (pty == nullptr || _entries.contains(pty)) {
+        return;
+    }
+    _entries.insert(pty, Entry());
+    connect(pty, &QObject::destroyed, this, [this, pty]() {
+        unwatch(pty);
+    });
+    poke(pty);
+
+    if (!_pollTimer.isActive()) {
+        _pollTimer.start();
+    }
+}
+
+void ForegroundProcessMonitor::unwatch(Pty *pty)
+{
+    auto it = _entries.find(pty);
+    if (it == _entries.end()) {
+        return;
+    }
+    closeExitWatch(*it);
+    _entries.erase(it);
+    disconnect(pty, &QObject::destroyed, this, nullptr);
+
+    if (_entries.isEmpty()) {
+        _pollTimer.stop();
+        _checkTimer.stop();
+    }
+}
+
+void ForegroundProcessMonitor::poke(Pty *pty)
+{
+    auto it = _entries.find(pty);
+    if (it == _entries.end()) {
+        return;
+    }
+    const qint64 now = _clock.elapsed();
+    qint64 dueAt = now + CheckDelayMs;
+    if (it->lastCheck >= 0) {
+        dueAt = std::max(dueAt, it->lastCheck + MinCheckIntervalMs);
+    }
+    schedule(*it, dueAt);
+}
+
+void ForegroundProcessMonitor::check(Pty *pty)
+{
+    auto it = _entries.find(pty);
+    if (it != _entries.end()) {
+        check(pty, *it);
+    }
+}
+
+quint64 ForegroundProcessMonitor::generation(Pty *pty) const
+{
+    auto it = _entries.constFind(pty);
+    return it != _entries.constEnd() ? it->generation : 0;
+}
+
+int ForegroundProcessMonitor::foregroundProcessGroup(Pty *pty) const
+{
+    auto it = _entries.constFind(pty);
+    return it != _entries.constEnd() ? it->foregroundProcessGroup : -1;
+}
+
+QString ForegroundProcessMonitor::currentDir(Pty *pty) const
+{
+    auto it = _entries.constFind(pty);
+    return it != _entries.constEnd() ? it->currentDir : QString();
+}
+
+void ForegroundProcessMonitor::schedule(Entry &entry, qint64 dueAt)
+{
+    // An earlier check covers a later one
+    if (entry.dueAt >= 0 && entry.dueAt <= dueAt) {
+        return;
+    }
+    entry.dueAt = dueAt;
+
+    const qint64 wait = std::max<qint64>(0, dueAt - _clock.elapsed());
+    if (!_checkTimer.isActive() || _checkTimer.remainingTime() > wait) {
+        _checkTimer.start(static_cast<int>(wait));
+    }
+}
+
+void ForegroundProcessMonitor::checkDue()
+{
+    const qint64 now = _clock.elapsed();
+    const QList<Pty *> ptys = _entries.keys();
+    for (Pty *pty : ptys) {
+        // changed() may unwatch any of them
+        auto it = _entries.find(pty);
+        if (it != _entries.end() && it->dueAt >= 0 && it->dueAt <= now) {
+            check(pty, *it);
+        }
+    }
+
+    qint64 next = -1;
+    for (const Entry &entry : std::as_const(_entries)) {
+        if (entry.dueAt >= 0 && (next < 0 || entry.dueAt < next)) {
+            next = entry.dueAt;
+        }
+    }
+    if (next >= 0) {
+        _checkTimer.start(static_cast<int>(std::max<qint64>(0, next - _clock.elapsed())));
+    }
+}
+
+void ForegroundProcessMonitor::pollJobs()
+{
+    // Jobs whose end is watched through a pidfd need no polling; the
+    // shell itself only changes directory when something is typed
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        const int shellPid = it.key()->shellProcessId();
+        if (it->exitNotifier == nullptr && it->foregroundProcessGroup > 0 && it->foregroundProcessGroup != shellPid) {
+            schedule(*it, _clock.elapsed());
+        }
+    }
+}
+
+void ForegroundProcessMonitor::check(Pty *pty, Entry &entry)
+{
+    entry.dueAt = -1;
+    entry.lastCheck = _clock.elapsed();
+
+    const int foregroundProcessGroup = pty->foregroundProcessGroup();
+    bool changed = foregroundProcessGroup != entry.foregroundProcessGroup;
+
+#ifdef Q_OS_LINUX
+    QString currentDir;
+    if (foregroundProcessGroup > 0) {
+        currentDir = QFile::symLinkTarget(QStringLiteral("/proc/%1/cwd").arg(foregroundProcessGroup));
+    }
+    changed = changed || currentDir != entry.currentDir;
+    entry.currentDir = currentDir;
+#else
+    // Nothing cheap tells what else changed, let the session look
+    changed = true;
+#endif
+
+    const bool wasSettling = entry.settling;
+    entry.settling = false;
+    if (foregroundProcessGroup != entry.foregroundProcessGroup) {
+        entry.foregroundProcessGroup = foregroundProcessGroup;
+        watchExit(pty, entry);
+        if (!wasSettling) {
+            // Look again once the new job has its own name
+            entry.settling = true;
+            schedule(entry, _clock.elapsed() + SettleDelayMs);
+        }
+    } else if (wasSettling) {
+        // The name may have changed without anything else doing so
+        changed = true;
+    }
+
+    if (changed) {
+        ++entry.generation;
+        Q_EMIT this->changed(pty);
+    }
+}
+
+void ForegroundProcessMonitor::watchExit(Pty *pty, Entry &entry)
+{
+    closeExitWatch(entry);
+
+    const int job = entry.foregroundProcessGroup;
+    if (job <= 0 || job == pty->shellProcessId()) {
+        return;
+    }
+
+#if defined(Q_OS_LINUX) && defined(SYS_pidfd_open)
+    const int pidfd = static_cast<int>(syscall(SYS_pidfd_open, job, 0));
+    if (pidfd < 0) {
+        qCDebug(KonsoleDebug) << "pidfd_open failed for" << job << ", polling instead";
+        return;
+    }
+    entry.pidfd = pidfd;
+    entry.exitNotifier = new QSocketNotifier(pidfd, QSocketNotifier::Read);
+    connect(entry.exitNotifier, &QSocketNotifier::activated, this, [this, pty]() {
+        auto it = _entries.find(pty);
+        if (it == _entries.end()) {
+            return;
+        }
+        // The job is gone; the shell may take a moment to get the
+        // terminal back, polling covers that
+        closeExitWatch(*it);
+        const int job = it->foregroundProcessGroup;
+        check(pty, *it);
+        it = _entries.find(pty);
+        if (it != _entries.end() && it->foregroundProcessGroup == job) {
+            schedule(*it, _clock.elapsed() + CheckDelayMs);
+        }
+    });
+#else
+    Q_UNUSED(pty)
+#endif
+}
+
+void ForegroundProcessMonitor::closeExitWatch(Entry &entry)
+{
+    if (entry.exitNotifier != nullptr) {
+        entry.exitNotifier->setEnabled(false);
+        entry.exitNotifier->deleteLater();
+        entry.exitNotifier = nullptr;
+    }
+#ifdef Q_OS_LINUX
+    if (entry.pidfd >= 0) {
+        ::close(entry.pidfd);
+        entry.pidfd = -1;
+    }
+#endif
+}
+
+#include "moc_ForegroundProcessMonitor.cpp"
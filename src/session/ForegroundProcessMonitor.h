@@ -0,0 +1,121 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef FOREGROUNDPROCESSMONITOR_H
+#define FOREGROUNDPROCESSMONITOR_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QSocketNotifier;
+
+namespace Konsole
+{
+class Pty;
+
+/**
+ * Notices when the foreground process or the working directory of a
+ * terminal changes, for all sessions at once.
+ *
+ * Session titles are made from ProcessInfo, which reads several files in
+ * /proc each time it is updated.  Updating it a while after every key
+ * press or output, as titles used to be, keeps every busy tab reading
+ * /proc although nothing changed.  The monitor checks only the foreground
+ * process group of the pty, a single ioctl, and the link to the working
+ * directory of that process, and lets the session know when either
+ * changed.  Sessions update their ProcessInfo only then.
+ *
+ * Checks are requested with poke() on terminal activity; pokes are
+ * coalesced and a terminal is checked at most once per MinCheckIntervalMs.
+ * On Linux the monitor also holds a pidfd for the foreground job, which
+ * becomes readable when the job exits, so its end is seen at once.  Where
+ * that isn't available, terminals running a job are polled every
+ * FallbackPollMs.  The process connector would report every fork and
+ * exec, but it needs CAP_NET_ADMIN.
+ *
+ * The results are kept in one table shared by all sessions.
+ */
+class KONSOLEPRIVATE_EXPORT ForegroundProcessMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    ForegroundProcessMonitor();
+    ~ForegroundProcessMonitor() override;
+
+    /** Returns the monitor shared by all sessions. */
+    static ForegroundProcessMonitor *instance();
+
+    /** Starts monitoring the running @p pty, until it is destroyed or unwatched. */
+    void watch(Pty *pty);
+    void unwatch(Pty *pty);
+    bool isWatching(Pty *pty) const
+    {
+        return _entries.contains(pty);
+    }
+
+    /** Terminal activity on @p pty; it is checked soon. */
+    void poke(Pty *pty);
+    /** Checks @p pty right away. */
+    void check(Pty *pty);
+
+    /**
+     * Incremented whenever the foreground process group or the working
+     * directory of @p pty changed; 0 if @p pty isn't watched.
+     */
+    quint64 generation(Pty *pty) const;
+
+    /** The foreground process group at the last check. */
+    int foregroundProcessGroup(Pty *pty) const;
+    /** The working directory of the foreground process at the last check. */
+    QString currentDir(Pty *pty) const;
+
+    static constexpr int CheckDelayMs = 250;
+    static constexpr int MinCheckIntervalMs = 1000;
+    static constexpr int FallbackPollMs = 5000;
+    // A new job has the shell's name until it calls exec()
+    static constexpr int SettleDelayMs = 300;
+
+Q_SIGNALS:
+    /** The foreground process group or its working directory changed. */
+    void changed(Konsole::Pty *pty);
+
+private:
+    struct Entry {
+        int foregroundProcessGroup = -1;
+        QString currentDir;
+        quint64 generation = 1;
+        qint64 lastCheck = -1;
+        // When the next check is due, -1 if none is
+        qint64 dueAt = -1;
+        bool settling = false;
+        int pidfd = -1;
+        QSocketNotifier *exitNotifier = nullptr;
+    };
+
+    void schedule(Entry &entry, qint64 dueAt);
+    void checkDue();
+    void pollJobs();
+    void check(Pty *pty, Entry &entry);
+    void watchExit(Pty *pty, Entry &entry);
+    static void closeExitWatch(Entry &entry);
+
+    QHash<Pty *, Entry> _entries;
+    QElapsedTimer _clock;
+    QTimer _checkTimer;
+    QTimer _pollTimer;
+};
+
+}
+
+#endif // FOREGROUNDPROCESSMONITOR_H
@@ -0,0 +1,207 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ScrollbackBudget.h"
+
+// Qt
+#include <QDateTime>
+
+// std
+#include <algorithm>
+
+// Konsole
+#include "Emulation.h"
+#include "KonsoleSettings.h"
+#include "Session.h"
+#include "SessionManager.h"
+#include "history/HistoryTypeFile.h"
+#include "history/compact/CompactHistoryType.h"
+#include "konsoledebug.h"
+#include "terminalDisplay/TerminalDisplay.h"
+
+using namespace Konsole;
+
+// Histories grow in bursts, there is no need to react faster than this
+static constexpr int CheckInterval = 5000;
+
+ScrollbackBudget::ScrollbackBudget()
+{
+    _checkTimer.setInterval(CheckInterval);
+    connect(&_checkTimer, &QTimer::timeout, this, &ScrollbackBudget::check);
+}
+
+ScrollbackBudget::~ScrollbackBudget() = default;
+
+Q_GLOBAL_STATIC(ScrollbackBudget, theScrollbackBudget)
+ScrollbackBudget *ScrollbackBudget::instance()
+{
+    return theScrollbackBudget;
+}
+
+void ScrollbackBudget::start()
+{
+    if (!_checkTimer.isActive()) {
+        _checkTimer.start();
+    }
+}
+
+size_t ScrollbackBudget::budget() const
+{
+    if (!KonsoleSettings::scrollbackBudgetEnabled()) {
+        return 0;
+    }
+    return static_cast<size_t>(KonsoleSettings::scrollbackBudgetValue()) * 1024 * 1024;
+}
+
+size_t ScrollbackBudget::currentUsage() const
+{
+    size_t total = 0;
+    const QList<Session *> sessions = SessionManager::instance()->sessions();
+    for (Session *session : sessions) {
+        total += session->emulation()->historyMemoryUsage();
+    }
+    return total;
+}
+
+void ScrollbackBudget::check()
+{
+    const QList<Session *> sessions = SessionManager::instance()->sessions();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<Entry> entries;
+    entries.reserve(sessions.size());
+    QHash<Session *, qint64> lastViewed;
+    size_t total = 0;
+
+    for (Session *session : sessions) {
+        Entry entry;
+        entry.bytes = session->emulation()->historyMemoryUsage();
+
+        const QList<TerminalDisplay *> views = session->views();
+        if (views.isEmpty()) {
+            entry.tier = Detached;
+        } else if (std::any_of(views.cbegin(), views.cend(), [](TerminalDisplay *view) {
+                       return view->isVisible();
+                   })) {
+            entry.tier = Visible;
+        } else {
+            entry.tier = Background;
+        }
+
+        entry.lastViewed = entry.tier == Visible ? now : _lastViewed.value(session, 0);
+        lastViewed.insert(session, entry.lastViewed);
+
+        total += entry.bytes;
+        entries.append(entry);
+    }
+
+    // drops sessions which were closed since the last check
+    _lastViewed = std::move(lastViewed);
+    for (auto it = _trimmed.begin(); it != _trimmed.end();) {
+        it = _lastViewed.contains(it.key()) ? std::next(it) : _trimmed.erase(it);
+    }
+
+    const size_t limit = budget();
+    if (limit > 0 && total > limit) {
+        const QVector<int> victims = planReclaim(entries, total, limit);
+        for (int index : victims) {
+            Session *session = sessions.at(index);
+            reclaim(session);
+            total -= entries.at(index).bytes;
+            total += session->emulation()->historyMemoryUsage();
+        }
+    } else if (!_trimmed.isEmpty() && (limit == 0 || total <= limit / 100 * RestorePercent)) {
+        restoreTrimmed();
+    }
+
+    _usage = total;
+    Q_EMIT usageChanged(_usage, limit);
+}
+
+QVector<int> ScrollbackBudget::planReclaim(const QVector<Entry> &entries, size_t total, size_t budget)
+{
+    QVector<int> candidates;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.at(i).tier != Visible && entries.at(i).bytes > 0) {
+            candidates.append(i);
+        }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [&entries](int a, int b) {
+        const Entry &left = entries.at(a);
+        const Entry &right = entries.at(b);
+        if (left.tier != right.tier) {
+            return left.tier < right.tier;
+        }
+        return left.lastViewed < right.lastViewed;
+    });
+
+    QVector<int> plan;
+    for (int index : std::as_const(candidates)) {
+        if (total <= budget) {
+            break;
+        }
+        plan.append(index);
+        total -= qMin(total, entries.at(index).bytes);
+    }
+
+    return plan;
+}
+
+int ScrollbackBudget::trimmedLineCount(int historyLines, int limit)
+{
+    const int keep = qMax(MinimumTrimLines, historyLines / 2);
+    // Limits below the minimum are never raised
+    if (limit >= 0 && keep >= limit) {
+        return -1;
+    }
+    return keep;
+}
+
+void ScrollbackBudget::reclaim(Session *session)
+{
+    Emulation *emulation = session->emulation();
+
+    if (KonsoleSettings::scrollbackBudgetAction() == KonsoleSettings::EnumScrollbackBudgetAction::TrimHistory) {
+        const int historyLines = emulation->lineCount() - emulation->imageSize().height();
+        const int limit = session->historyType().maximumLineCount();
+        const int keep = trimmedLineCount(historyLines, limit);
+        if (keep < 0) {
+            return;
+        }
+        qCDebug(KonsoleDebug) << "Scrollback budget: trimming history of session" << session->sessionId() << "to" << keep << "lines";
+        // Trimmed again, the limit to restore is still the configured one
+        auto trimmed = _trimmed.find(session);
+        if (trimmed == _trimmed.end()) {
+            trimmed = _trimmed.insert(session, Trimmed{limit, keep});
+        }
+        trimmed->trimmedLines = keep;
+        session->setHistoryType(CompactHistoryType(keep));
+    } else {
+        qCDebug(KonsoleDebug) << "Scrollback budget: moving history of session" << session->sessionId() << "to disk";
+        session->setHistoryType(HistoryTypeFile());
+    }
+}
+
+void ScrollbackBudget::restoreTrimmed()
+{
+    for (auto it = _trimmed.cbegin(); it != _trimmed.cend(); ++it) {
+        Session *session = it.key();
+        // The limit was changed since, e.g. by editing the profile
+        if (session->historyType().maximumLineCount() != it->trimmedLines) {
+            continue;
+        }
+        qCDebug(KonsoleDebug) << "Scrollback budget: restoring history limit of session" << session->sessionId() << "to" << it->configuredLines << "lines";
+        if (it->configuredLines < 0) {
+            session->setHistoryType(HistoryTypeFile());
+        } else {
+            session->setHistoryType(CompactHistoryType(it->configuredLines));
+        }
+    }
+    _trimmed.clear();
+}
+
+#include "moc_ScrollbackBudget.cpp"
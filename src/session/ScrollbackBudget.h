@@ -0,0 +1,120 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SCROLLBACKBUDGET_H
+#define SCROLLBACKBUDGET_H
+
+// Qt
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class Session;
+
+/**
+ * Keeps the combined in-memory scrollback of all sessions below a
+ * process-wide ceiling.
+ *
+ * Every check interval the RAM used by each session's history is summed.
+ * When the total exceeds the configured budget, histories are reclaimed
+ * until the total fits again: detached sessions (no views) first, then
+ * sessions whose views are all hidden, least recently viewed first.
+ * Sessions with a visible view are never touched.
+ *
+ * A history is reclaimed either by moving it into a file on disk, which
+ * keeps every line, or by trimming it to half of its current length,
+ * depending on KonsoleSettings::scrollbackBudgetAction().  Trimmed
+ * histories get their configured limit back once the total has dropped to
+ * RestorePercent of the budget.
+ */
+class KONSOLEPRIVATE_EXPORT ScrollbackBudget : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScrollbackBudget();
+    ~ScrollbackBudget() override;
+
+    /** Returns the process-wide budget instance. */
+    static ScrollbackBudget *instance();
+
+    /** Starts the periodic checks.  Does nothing if already started. */
+    void start();
+
+    /** Total bytes of scrollback held in RAM at the last check. */
+    size_t usage() const
+    {
+        return _usage;
+    }
+
+    /** Total bytes of scrollback held in RAM right now; nothing is reclaimed. */
+    size_t currentUsage() const;
+
+    /** Configured ceiling in bytes, or 0 when the budget is disabled. */
+    size_t budget() const;
+
+    /** Sums up the history usage of all sessions and reclaims memory if needed. */
+    void check();
+
+    /** Histories are never trimmed below this many lines. */
+    static constexpr int MinimumTrimLines = 1000;
+
+    /** Trimmed histories are restored when the total is at most this share of the budget. */
+    static constexpr int RestorePercent = 50;
+
+    /**
+     * Returns the number of lines to trim a history of @p historyLines
+     * lines to, given its limit of @p limit lines (-1 if unlimited), or -1
+     * if trimming would not lower the limit.
+     */
+    static int trimmedLineCount(int historyLines, int limit);
+
+    enum Tier {
+        Detached = 0, // no view at all
+        Background = 1, // views exist, none visible
+        Visible = 2, // never reclaimed
+    };
+
+    struct Entry {
+        size_t bytes = 0;
+        Tier tier = Visible;
+        qint64 lastViewed = 0;
+    };
+
+    /**
+     * Returns the indexes into @p entries which must be reclaimed, in order,
+     * for @p total to drop to @p budget or below.  Entries are taken
+     * detached before background and least recently viewed first.
+     */
+    static QVector<int> planReclaim(const QVector<Entry> &entries, size_t total, size_t budget);
+
+Q_SIGNALS:
+    /** Emitted after each check with the current usage and budget in bytes. */
+    void usageChanged(size_t usage, size_t budget);
+
+private:
+    void reclaim(Session *session);
+    void restoreTrimmed();
+
+    struct Trimmed {
+        int configuredLines = 0;
+        int trimmedLines = 0;
+    };
+
+    QTimer _checkTimer;
+    QHash<Session *, qint64> _lastViewed;
+    QHash<Session *, Trimmed> _trimmed;
+    size_t _usage = 0;
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "Session.h"
 
 // Standard
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
 
@@ -54,6 +55,8 @@
 #include <sessionadaptor.h>
 #endif
 
+#include "EmulationScheduler.h"
+#include "ForegroundProcessMonitor.h"
 #include "KonsoleSettings.h"
 #include "Pty.h"
 #include "SSHProcessInfo.h"
@@ -149,6 +152,12 @@ Session::Session(QObject *parent)
     _activityTimer = new QTimer(this);
     _activityTimer->setSingleShot(true);
     connect(_activityTimer, &QTimer::timeout, this, &Konsole::Session::activityTimerDone);
+
+    connect(ForegroundProcessMonitor::instance(), &ForegroundProcessMonitor::changed, this, [this](Pty *pty) {
+        if (pty == _shellProcess) {
+            Q_EMIT processStateChanged();
+        }
+    });
 }
 
 Session::~Session()
@@ -180,7 +189,17 @@ void Session::openTeletype(int fd, bool runShell)
 
     // connect the I/O between emulator and pty process
     connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
-    connect(_emulation, &Konsole::Emulation::sendData, _shellProcess, &Konsole::Pty::sendData);
+#ifndef Q_OS_WIN
+    _threadedEmulation = KonsoleSettings::threadedEmulation();
+    if (_threadedEmulation) {
+        // The output is parsed in turns, together with that of other sessions
+        _shellProcess->setPullMode(true);
+        connect(_shellProcess, &Konsole::Pty::outputAvailable, this, [this]() {
+            EmulationScheduler::instance()->schedule(this);
+        });
+    }
+#endif
+    connect(_emulation, &Konsole::Emulation::sendData, this, &Konsole::Session::sendEmulationData, Qt::UniqueConnection);
 
     // UTF8 mode
     connect(_emulation, &Konsole::Emulation::useUtf8Request, _shellProcess, &Konsole::Pty::setUtf8Mode);
@@ -355,6 +374,8 @@ void Session::addView(TerminalDisplay *widget)
     connect(_emulation, &Konsole::Emulation::resetCursorStyleRequest, widget, &Konsole::TerminalDisplay::resetCursorStyle);
 
     connect(widget, &Konsole::TerminalDisplay::keyPressedSignal, this, &Konsole::Session::resetNotifications);
+
+    updateBackgroundMode();
 }
 
 void Session::viewDestroyed(QObject *view)
@@ -383,6 +404,8 @@ void Session::removeView(TerminalDisplay *widget)
     // disconnect state change signals emitted by emulation
     disconnect(_emulation, nullptr, widget, nullptr);
 
+    updateBackgroundMode();
+
     // close the session automatically when the last view is removed
     if (_views.count() == 0) {
         close();
@@ -616,6 +639,8 @@ void Session::run()
 
     _shellProcess->setWriteable(false); // We are reachable via kwrited.
 
+    ForegroundProcessMonitor::instance()->watch(_shellProcess);
+
     Q_EMIT started();
 }
 
@@ -683,6 +708,7 @@ void Session::setSessionAttribute(int what, const QString &caption)
     if (what == CurrentDirectory) {
         _reportedWorkingUrl = QUrl::fromUserInput(caption);
         Q_EMIT currentDirectoryChanged(currentWorkingDirectory());
+        Q_EMIT processStateChanged();
         modified = true;
     }
 
@@ -846,9 +872,20 @@ void Session::sessionAttributeRequest(int id, uint terminator)
 
 void Session::onViewSizeChange(int /* height */, int /* width */)
 {
+    // also emitted when a view is shown or hidden
+    updateBackgroundMode();
     updateTerminalSize();
 }
 
+void Session::updateBackgroundMode()
+{
+    // sessions without views (e.g. still being set up) are left alone
+    const bool background = !_views.isEmpty() && std::none_of(_views.cbegin(), _views.cend(), [](TerminalDisplay *view) {
+        return view->isVisible();
+    });
+    _emulation->setBackgroundMode(background);
+}
+
 void Session::updateTerminalSize()
 {
     int minLines = -1;
@@ -1229,8 +1266,11 @@ void Session::updateSessionProcessInfo()
 #endif
 
         _sessionProcessInfo->setUserHomeDir();
+        _sessionProcessInfoGeneration = 0;
+    }
+    if (processInfoStale(_sessionProcessInfoGeneration)) {
+        _sessionProcessInfo->update();
     }
-    _sessionProcessInfo->update();
 }
 
 bool Session::updateForegroundProcessInfo()
@@ -1246,16 +1286,35 @@ bool Session::updateForegroundProcessInfo()
         _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid, processId());
 #endif
         _foregroundPid = foregroundPid;
+        _foregroundProcessInfoGeneration = 0;
     }
 
     if (_foregroundProcessInfo != nullptr) {
-        _foregroundProcessInfo->update();
+        if (processInfoStale(_foregroundProcessInfoGeneration)) {
+            _foregroundProcessInfo->update();
+        }
         return _foregroundProcessInfo->isValid();
     } else {
         return false;
     }
 }
 
+bool Session::processInfoStale(quint64 &seen) const
+{
+    // Without the monitor, e.g. before the session runs, always look
+    const quint64 generation = ForegroundProcessMonitor::instance()->generation(_shellProcess);
+    if (generation != 0 && generation == seen) {
+        return false;
+    }
+    seen = generation;
+    return true;
+}
+
+void Session::checkForegroundProcess()
+{
+    ForegroundProcessMonitor::instance()->poke(_shellProcess);
+}
+
 bool Session::isRemote()
 {
     ProcessInfo *process = getProcessInfo();
@@ -1646,6 +1705,10 @@ void Session::startZModem(const QString &zmodem, const QString &dir, const QStri
 
     _zmodemProc->start();
 
+#ifndef Q_OS_WIN
+    // The transfer needs every block as it arrives
+    _shellProcess->setPullMode(false);
+#endif
     disconnect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
     connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::zmodemReceiveBlock);
 
@@ -1719,6 +1782,9 @@ void Session::zmodemFinished()
 
         disconnect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::zmodemReceiveBlock);
         connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
+#ifndef Q_OS_WIN
+        _shellProcess->setPullMode(_threadedEmulation);
+#endif
 
         _shellProcess->sendData(QByteArrayLiteral("\030\030\030\030")); // Abort
         _shellProcess->sendData(QByteArrayLiteral("\001\013\n")); // Try to get prompt back
@@ -1729,9 +1795,58 @@ void Session::zmodemFinished()
 void Session::onReceiveBlock(const char *buf, int len)
 {
     handleActivity();
+    receivePtyData(buf, len);
+}
+
+void Session::receivePtyData(const char *buf, int len)
+{
     _emulation->receiveData(buf, len);
 }
 
+void Session::sendEmulationData(const QByteArray &data)
+{
+    writeToPty(data);
+}
+
+void Session::writeToPty(const QByteArray &data)
+{
+    if (_shellProcess != nullptr) {
+        _shellProcess->sendData(data);
+    }
+}
+
+bool Session::hasPendingOutput() const
+{
+#ifndef Q_OS_WIN
+    return _shellProcess != nullptr && _shellProcess->pullMode() && _shellProcess->hasReceivedData();
+#else
+    return false;
+#endif
+}
+
+qsizetype Session::parsePendingOutput(qsizetype maxLength)
+{
+#ifndef Q_OS_WIN
+    if (!hasPendingOutput()) {
+        return 0;
+    }
+    return _shellProcess->readReceivedData(
+        [this](const char *buf, int len) {
+            receivePtyData(buf, len);
+        },
+        maxLength);
+#else
+    Q_UNUSED(maxLength)
+    return 0;
+#endif
+}
+
+bool Session::canParseOnWorkerThread() const
+{
+    // The transfer takes the output over
+    return !_zmodemBusy;
+}
+
 QSize Session::size()
 {
     return _emulation->imageSize();
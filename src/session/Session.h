@@ -291,6 +291,13 @@ public:
     /** Returns a title generated from tab format and process information. */
     QString getDynamicTitle();
 
+    /**
+     * Asks for the foreground process and its working directory to be
+     * looked at soon, after the user or the program did something.
+     * processStateChanged() is emitted if either changed.
+     */
+    void checkForegroundProcess();
+
     /** Sets the name of the icon associated with this session. */
     void setIconName(const QString &iconName);
     /** Returns the name of the icon associated with this session. */
@@ -775,6 +782,12 @@ Q_SIGNALS:
      */
     void currentDirectoryChanged(const QString &dir);
 
+    /**
+     * Emitted when the foreground process or its working directory may
+     * have changed, and with them the dynamic title.
+     */
+    void processStateChanged();
+
     /**
      * Emitted when the session text encoding changes.
      */
@@ -865,6 +878,43 @@ Q_SIGNALS:
      */
     void hostnameChanged(const QString &hostname);
 
+protected:
+    /**
+     * Hands a block of data read from the pty to the emulation.
+     * Sessions which speak a protocol with the process on the pty,
+     * such as tmux control mode, reimplement this to unwrap it.
+     */
+    virtual void receivePtyData(const char *buf, int len);
+
+    /**
+     * Writes data produced by the emulation (key presses, terminal
+     * replies) to the pty.  See receivePtyData().
+     */
+    virtual void sendEmulationData(const QByteArray &data);
+
+    /** Writes @p data to the pty as is. */
+    void writeToPty(const QByteArray &data);
+
+    /**
+     * True if output read from the pty waits for the EmulationScheduler
+     * to parse it, see the ThreadedEmulation setting.
+     */
+    virtual bool hasPendingOutput() const;
+
+    /**
+     * Parses at most @p maxLength bytes of the pending output.  Called by
+     * the EmulationScheduler, on one of its worker threads if
+     * canParseOnWorkerThread() allows.  Returns the number of bytes parsed.
+     */
+    virtual qsizetype parsePendingOutput(qsizetype maxLength);
+
+    /**
+     * Whether the pending output may be parsed off the GUI thread right
+     * now.  Sessions which do more with the output than parsing it, as
+     * receivePtyData() allows, return false while they do.
+     */
+    virtual bool canParseOnWorkerThread() const;
+
 private Q_SLOTS:
     void done(int, QProcess::ExitStatus);
 
@@ -895,11 +945,15 @@ private Q_SLOTS:
     void sessionAttributeRequest(int id, uint terminator);
 
 private:
+    friend class EmulationScheduler;
+
     bool isCalledViaDbusAndForbidden() const;
 
     Q_DISABLE_COPY(Session)
 
     void updateTerminalSize();
+    // throttles the emulation while none of the views can be seen
+    void updateBackgroundMode();
     WId windowId() const;
     bool kill(int signal);
     // print a warning message in the terminal.  This is used
@@ -908,6 +962,8 @@ private:
     void terminalWarning(const QString &message);
     void updateSessionProcessInfo();
     bool updateForegroundProcessInfo();
+    // True if the process info seen at generation @p seen is out of date
+    bool processInfoStale(quint64 &seen) const;
     void updateWorkingDirectory();
     SessionController *controller();
 
@@ -966,6 +1022,12 @@ private:
     ProcessInfo *_sessionProcessInfo = nullptr;
     ProcessInfo *_foregroundProcessInfo = nullptr;
     int _foregroundPid = 0;
+    // ForegroundProcessMonitor generations the process infos were updated at
+    quint64 _sessionProcessInfoGeneration = 0;
+    quint64 _foregroundProcessInfoGeneration = 0;
+
+    // Output parsed by the EmulationScheduler
+    bool _threadedEmulation = false;
 
     // ZModem
     bool _zmodemBusy = false;
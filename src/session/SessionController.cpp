@@ -19,9 +19,12 @@
 
 #include <QFileDialog>
 #include <QIcon>
+#include <QInputDialog>
 #include <QKeyEvent>
 #include <QList>
 #include <QMenu>
+#include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QUrl>
 
@@ -60,6 +63,7 @@
 #include "SaveHistoryTask.h"
 #include "ScreenWindow.h"
 #include "SearchHistoryTask.h"
+#include "SelectionExport.h"
 #include "konsoledebug.h"
 
 #include "filterHotSpots/ColorFilter.h"
@@ -115,7 +119,6 @@ SessionController::SessionController(Session *sessionParam, TerminalDisplay *vie
     , _findAction(nullptr)
     , _findNextAction(nullptr)
     , _findPreviousAction(nullptr)
-    , _interactionTimer(nullptr)
     , _searchStartLine(0)
     , _prevSearchResultLine(0)
     , _codecAction(nullptr)
@@ -211,15 +214,9 @@ SessionController::SessionController(Session *sessionParam, TerminalDisplay *vie
     connect(session(), &Konsole::Session::flowControlEnabledChanged, view(), &Konsole::TerminalDisplay::setFlowControlWarningEnabled);
     view()->setFlowControlWarningEnabled(session()->flowControlEnabled());
 
-    // take a snapshot of the session state every so often when
-    // user activity occurs
-    //
-    // the timer is owned by the session so that it will be destroyed along
-    // with the session
-    _interactionTimer = new QTimer(session());
-    _interactionTimer->setSingleShot(true);
-    _interactionTimer->setInterval(2000);
-    connect(_interactionTimer, &QTimer::timeout, this, &Konsole::SessionController::snapshot);
+    // take a snapshot of the session state when the foreground process or
+    // its directory changed; activity only asks for them to be checked
+    connect(session(), &Konsole::Session::processStateChanged, this, &Konsole::SessionController::snapshot);
     connect(view(), &Konsole::TerminalDisplay::compositeFocusChanged, this, [this](bool focused) {
         if (focused) {
             interactionHandler();
@@ -315,9 +312,7 @@ void SessionController::viewFocusChangeHandler(bool focused)
 
 void SessionController::interactionHandler()
 {
-    if (!_interactionTimer->isActive()) {
-        _interactionTimer->start();
-    }
+    session()->checkForegroundProcess();
 }
 
 void SessionController::snapshot()
@@ -479,6 +474,8 @@ void SessionController::updateCopyAction(const bool selectionEmpty)
     // copy action is meaningful only when some text is selected.
     bool hasRepl = view() && view()->screenWindow() && view()->screenWindow()->screen() && view()->screenWindow()->screen()->hasRepl();
     copyAction->setEnabled(!selectionEmpty);
+    actionCollection()->action(QStringLiteral("save-selection"))->setEnabled(!selectionEmpty);
+    actionCollection()->action(QStringLiteral("pipe-selection"))->setEnabled(!selectionEmpty);
     copyContextMenu->setVisible(!selectionEmpty || hasRepl);
     QAction *Action = actionCollection()->action(QStringLiteral("edit_copy_contextmenu_in"));
     Action->setVisible(!selectionEmpty && hasRepl);
@@ -746,6 +743,15 @@ void SessionController::setupCommonActions()
     action->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_S));
 #endif
 
+    action = collection->addAction(QStringLiteral("save-selection"), this, &SessionController::saveSelection);
+    action->setText(i18n("Save Selection As..."));
+    action->setIcon(QIcon::fromTheme(QStringLiteral("document-save-as")));
+    action->setEnabled(false);
+
+    action = collection->addAction(QStringLiteral("pipe-selection"), this, &SessionController::pipeSelection);
+    action->setText(i18n("Pipe Selection to Command..."));
+    action->setEnabled(false);
+
     _startAutoSaveAction = collection->addAction(QStringLiteral("file-autosave"), this, &SessionController::autoSaveHistory);
     _startAutoSaveAction->setText(i18n("Auto Save Output As..."));
     _startAutoSaveAction->setVisible(true);
@@ -1844,9 +1850,12 @@ void SessionController::autoSaveHistory()
             _startAutoSaveAction->setVisible(true);
             _stopAutoSaveAction->setVisible(false);
         });
+        // Drop " (autosaving)" from the title once the task is gone
+        connect(_autoSaveTask, &QObject::destroyed, this, &Konsole::SessionController::snapshot);
 
         _startAutoSaveAction->setVisible(false);
         _stopAutoSaveAction->setVisible(true);
+        snapshot();
     } else {
         // Reset to avoid snapshot changing title.
         _autoSaveTask->stop();
@@ -1866,6 +1875,85 @@ void SessionController::saveHistory()
     task->execute();
 }
 
+void SessionController::saveSelection()
+{
+    // Written a slice at a time, so a selection of the whole history
+    // doesn't freeze the window, and replacing the file only at the end
+    SelectionExport *selection = view()->exportSelection();
+    selection->setParent(this);
+    if (selection->isEmpty()) {
+        delete selection;
+        return;
+    }
+
+    const QString fileName = QFileDialog::getSaveFileName(view(),
+                                                          i18n("Save Selection As"),
+                                                          session()->currentWorkingDirectory(),
+                                                          i18n("Text Files (*.txt);;HTML Files (*.html *.htm);;All Files (*)"));
+    if (fileName.isEmpty()) {
+        delete selection;
+        return;
+    }
+
+    auto *file = new QSaveFile(fileName, selection);
+    if (!file->open(QIODevice::WriteOnly)) {
+        KMessageBox::error(view(), i18n("%1 could not be opened for writing.\n%2", fileName, file->errorString()));
+        delete selection;
+        return;
+    }
+
+    const bool html = fileName.endsWith(QLatin1String(".html"), Qt::CaseInsensitive) || fileName.endsWith(QLatin1String(".htm"), Qt::CaseInsensitive);
+    selection->addOutput(file, html ? SelectionExport::Html : SelectionExport::PlainText);
+    connect(selection, &SelectionExport::finished, this, [this, selection, file, fileName](bool complete) {
+        if (!complete) {
+            file->cancelWriting();
+            KMessageBox::error(view(), i18n("The terminal was resized or cleared while the selection was saved, %1 was not written.", fileName));
+        } else if (!file->commit()) {
+            KMessageBox::error(view(), i18n("A problem occurred when saving the selection.\n%1", file->errorString()));
+        }
+        selection->deleteLater();
+    });
+    selection->start();
+}
+
+void SessionController::pipeSelection()
+{
+    SelectionExport *selection = view()->exportSelection();
+    selection->setParent(this);
+    if (selection->isEmpty()) {
+        delete selection;
+        return;
+    }
+
+    bool ok = false;
+    const QString command =
+        QInputDialog::getText(view(), i18n("Pipe Selection to Command"), i18n("Command to read the selected text from its input:"), QLineEdit::Normal, QString(), &ok);
+    if (!ok || command.trimmed().isEmpty()) {
+        delete selection;
+        return;
+    }
+
+    auto *process = new QProcess(selection);
+    process->setWorkingDirectory(session()->currentWorkingDirectory());
+    process->setStandardOutputFile(QProcess::nullDevice());
+    process->setStandardErrorFile(QProcess::nullDevice());
+
+    // Writes wait for the command to read what it was given so far
+    connect(selection, &SelectionExport::finished, process, &QProcess::closeWriteChannel);
+    connect(process, &QProcess::finished, selection, &QObject::deleteLater);
+    connect(process, &QProcess::errorOccurred, this, [this, selection, command](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            KMessageBox::error(view(), i18n("Could not run %1.", command));
+            selection->cancel();
+            selection->deleteLater();
+        }
+    });
+
+    process->start(QStringLiteral("/bin/sh"), {QStringLiteral("-c"), command});
+    selection->addOutput(process, SelectionExport::PlainText);
+    selection->start();
+}
+
 void SessionController::clearHistory()
 {
     session()->clearHistory();
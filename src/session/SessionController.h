@@ -29,7 +29,6 @@
 class QAction;
 class QTextCodec;
 class QKeyEvent;
-class QTimer;
 class QUrl;
 
 class KCodecAction;
@@ -282,6 +281,8 @@ private Q_SLOTS:
     void autoSaveHistory();
     void stopAutoSaveHistory();
     void saveHistory();
+    void saveSelection();
+    void pipeSelection();
     void showHistoryOptions();
     void clearHistory();
     void clearHistoryAndReset();
@@ -320,7 +321,7 @@ private Q_SLOTS:
 
     void viewFocusChangeHandler(bool focused);
     void interactionHandler();
-    void snapshot(); // called periodically as the user types
+    void snapshot(); // called when the foreground process changed
     // to take a snapshot of the state of the
     // foreground process in the terminal
 
@@ -383,8 +384,6 @@ private:
     QAction *_findNextAction;
     QAction *_findPreviousAction;
 
-    QTimer *_interactionTimer;
-
     int _searchStartLine;
     int _prevSearchResultLine;
 
@@ -10,6 +10,10 @@
 // Qt
 #include <QCheckBox>
 #include <QLabel>
+#include <QLocale>
+
+// Konsole
+#include "session/ScrollbackBudget.h"
 
 using namespace Konsole;
 
@@ -17,8 +21,23 @@ MemorySettings::MemorySettings(QWidget *parent)
     : QWidget(parent)
 {
     setupUi(this);
+
+    connect(kcfg_ScrollbackBudgetEnabled, &QCheckBox::toggled, kcfg_ScrollbackBudgetValue, &QWidget::setEnabled);
+    connect(kcfg_ScrollbackBudgetEnabled, &QCheckBox::toggled, kcfg_ScrollbackBudgetAction, &QWidget::setEnabled);
+    kcfg_ScrollbackBudgetValue->setEnabled(kcfg_ScrollbackBudgetEnabled->isChecked());
+    kcfg_ScrollbackBudgetAction->setEnabled(kcfg_ScrollbackBudgetEnabled->isChecked());
+
+    // show a fresh figure right away, then follow the periodic checks;
+    // opening the settings must not reclaim anything
+    showScrollbackUsage(ScrollbackBudget::instance()->currentUsage());
+    connect(ScrollbackBudget::instance(), &ScrollbackBudget::usageChanged, this, &MemorySettings::showScrollbackUsage);
 }
 
 MemorySettings::~MemorySettings() = default;
 
+void MemorySettings::showScrollbackUsage(size_t usage)
+{
+    scrollbackUsageLabel->setText(QLocale().formattedDataSize(static_cast<qint64>(usage)));
+}
+
 #include "moc_MemorySettings.cpp"
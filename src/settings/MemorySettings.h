@@ -18,6 +18,9 @@ class MemorySettings : public QWidget, private Ui::MemorySettings
 public:
     explicit MemorySettings(QWidget *parent = nullptr);
     ~MemorySettings() override;
+
+private:
+    void showScrollbackUsage(size_t usage);
 };
 }
 
@@ -61,6 +61,7 @@
 #include "EscapeSequenceUrlExtractor.h"
 #include "PrintOptions.h"
 #include "Screen.h"
+#include "SelectionExport.h"
 #include "ViewManager.h" // for colorSchemeForProfile. // TODO: Rewrite this.
 #include "WindowSystemInfo.h"
 #include "profile/Profile.h"
@@ -143,6 +144,8 @@ void TerminalDisplay::setScreenWindow(ScreenWindow *window)
         if (_wallpaper->isAnimated()) {
             QTimer *frameTimer = new QTimer(this);
             connect(frameTimer, &QTimer::timeout, this, [this]() -> void {
+                // Only the wallpaper changed
+                _textLayer.keep(contentsRect());
                 update();
             });
             frameTimer->start(_wallpaper->getFrameDelay());
@@ -326,6 +329,10 @@ TerminalDisplay::TerminalDisplay(QWidget *parent)
 
     _printManager.reset(new KonsolePrintManager(ldrawBackground, ldrawContents, lgetBackgroundColor));
     ubidi = ubidi_open();
+
+    ExtendedCharTable::instance.addKeySource(this, [this](QSet<uint> &keys) {
+        Character::collectExtendedChars(_image, _imageSize, keys);
+    });
 }
 
 TerminalDisplay::~TerminalDisplay()
@@ -333,6 +340,7 @@ TerminalDisplay::~TerminalDisplay()
     disconnect(_blinkTextTimer);
     disconnect(_blinkCursorTimer);
 
+    ExtendedCharTable::instance.removeKeySource(this);
     delete[] _image;
     delete _filterChain;
 
@@ -467,8 +475,9 @@ void TerminalDisplay::updateImage()
     // optimization - scroll the existing image where possible and
     // avoid expensive text drawing for parts of the image that
     // can simply be moved up or down
-    // disable this shortcut for transparent konsole with scaled pixels, otherwise we get rendering artifacts, see BUG 350651
-    if (!(WindowSystemInfo::HAVE_TRANSPARENCY && (qApp->devicePixelRatio() > 1.0)) && _wallpaper->isNull() && !_searchBar->isVisible()) {
+    // disable this shortcut for transparent konsole with scaled pixels, otherwise we get rendering artifacts, see BUG 350651;
+    // the text layer used with a wallpaper or the search bar doesn't scroll the widget itself
+    if (usesTextLayer() || !(WindowSystemInfo::HAVE_TRANSPARENCY && (qApp->devicePixelRatio() > 1.0))) {
         // if the flow control warning is enabled this will interfere with the
         // scrolling optimizations and cause artifacts.  the simple solution here
         // is to just disable the optimization whilst it is visible
@@ -645,8 +654,10 @@ void TerminalDisplay::updateImage()
 
     // update the parts of the display which have changed
     if (_screenWindow->screen()->hasGraphics()) {
+        _textLayer.invalidateAll();
         update();
     } else {
+        _textLayer.invalidate(dirtyRegion);
         update(dirtyRegion);
     }
 
@@ -730,8 +741,20 @@ void TerminalDisplay::paintEvent(QPaintEvent *pe)
     QRegion dirtyImageRegion;
     const QRegion region = pe->region() & contentsRect();
 
-    for (const QRect &rect : region) {
+    // With the text layer, only the text which isn't there already is drawn
+    const bool textLayer = usesTextLayer();
+    QRegion textRegion = region;
+    if (textLayer) {
+        _textLayer.resize(size(), devicePixelRatioF());
+        textRegion = _textLayer.beginPaint(region);
+    } else if (!_textLayer.isNull()) {
+        _textLayer.release();
+    }
+    for (const QRect &rect : std::as_const(textRegion)) {
         dirtyImageRegion += widgetToImage(rect);
+    }
+
+    for (const QRect &rect : region) {
         // We can use the opacity settings only if we are in a top level window which actually supports opacity.
         // Many apps that use a konsole part such as kate or dolphin don't for performance reasons.
         // This will result in repaint glitches iin wayland due to missing damage information
@@ -752,8 +775,21 @@ void TerminalDisplay::paintEvent(QPaintEvent *pe)
     // set https://bugreports.qt.io/browse/QTBUG-66036
     paint.setRenderHint(QPainter::TextAntialiasing, _terminalFont->antialiasText());
 
-    for (const QRect &rect : std::as_const(dirtyImageRegion)) {
-        _terminalPainter->drawContents(_image, paint, rect, false, _imageSize, _bidiEnabled, _lineProperties, _screenWindow->screen()->ulColorTable());
+    if (textLayer) {
+        if (!dirtyImageRegion.isEmpty()) {
+            QPainter layerPaint(&_textLayer.image());
+            layerPaint.setClipRegion(textRegion);
+            layerPaint.setRenderHint(QPainter::TextAntialiasing, _terminalFont->antialiasText());
+            for (const QRect &rect : std::as_const(dirtyImageRegion)) {
+                _terminalPainter
+                    ->drawContents(_image, layerPaint, rect, false, _imageSize, _bidiEnabled, _lineProperties, _screenWindow->screen()->ulColorTable());
+            }
+        }
+        _textLayer.composite(paint, region);
+    } else {
+        for (const QRect &rect : std::as_const(dirtyImageRegion)) {
+            _terminalPainter->drawContents(_image, paint, rect, false, _imageSize, _bidiEnabled, _lineProperties, _screenWindow->screen()->ulColorTable());
+        }
     }
 
     if (screenWindow()->currentResultLine() != -1) {
@@ -946,6 +982,7 @@ void TerminalDisplay::blinkTextEvent()
 
     // TODO: Optimize to only repaint the areas of the widget where there is
     // blinking text rather than repainting the whole widget.
+    _textLayer.invalidateAll();
     update();
 }
 
@@ -968,9 +1005,28 @@ void TerminalDisplay::updateCursor()
 
     int charWidth = _image[cursorLocation].width();
     QRect cursorRect = imageToWidget(highdpi_adjust_rect(QRect(_visualCursorPosition, QSize(charWidth, 1))));
+    _textLayer.invalidate(cursorRect);
     update(cursorRect);
 }
 
+bool TerminalDisplay::usesTextLayer() const
+{
+    // Scrolling the widget would move these along with the text
+    return !_wallpaper->isNull() || _searchBar->isVisible();
+}
+
+void TerminalDisplay::scrollPixels(int dy, const QRect &rect)
+{
+    if (!usesTextLayer()) {
+        scroll(0, dy, rect);
+        return;
+    }
+    // Whatever is below the text stays put, so the whole area is composited
+    // again, but only the exposed lines are drawn
+    _textLayer.scroll(dy, rect);
+    update(rect);
+}
+
 /* ------------------------------------------------------------------------- */
 /*                                                                           */
 /*                          Geometry & Resizing                              */
@@ -1136,10 +1192,20 @@ QSize TerminalDisplay::sizeHint() const
 void TerminalDisplay::showEvent(QShowEvent *)
 {
     propagateSize();
+    // the session leaves background mode here, delivering the output held
+    // back to the still suspended window
     Q_EMIT changedContentSizeSignal(_contentRect.height(), _contentRect.width());
+    // catch up with everything that was received while hidden in one go
+    if (!_screenWindow.isNull()) {
+        _screenWindow->setUpdatesSuspended(false);
+    }
 }
 void TerminalDisplay::hideEvent(QHideEvent *)
 {
+    // no point in decoding images and running filters nobody can see
+    if (!_screenWindow.isNull()) {
+        _screenWindow->setUpdatesSuspended(true);
+    }
     Q_EMIT changedContentSizeSignal(_contentRect.height(), _contentRect.width());
 }
 
@@ -2449,6 +2515,18 @@ void TerminalDisplay::copyToX11Selection(bool useSavedText)
     if (useSavedText) {
         text = _doubleClickSelectedText;
         html = _doubleClickSelectedHtml;
+    } else if (QMimeData *mimeData = largeSelectionMimeData(Screen::PlainText)) {
+        _doubleClickSelectedText.clear();
+        _doubleClickSelectedHtml.clear();
+        if (QApplication::clipboard()->supportsSelection()) {
+            QApplication::clipboard()->setMimeData(mimeData, QClipboard::Selection);
+        }
+        if (_autoCopySelectedText) {
+            QApplication::clipboard()->setMimeData(mimeData, QClipboard::Clipboard);
+        } else if (!QApplication::clipboard()->supportsSelection()) {
+            delete mimeData;
+        }
+        return;
     } else {
         text = _screenWindow->selectedText(currentDecodingOptions());
         if (!text.isEmpty() && _copyTextAsHTML) {
@@ -2487,6 +2565,11 @@ void TerminalDisplay::copyToClipboard(Screen::DecodingOptions options)
         return;
     }
 
+    if (QMimeData *mimeData = largeSelectionMimeData(options)) {
+        QApplication::clipboard()->setMimeData(mimeData, QClipboard::Clipboard);
+        return;
+    }
+
     const QString &text = _screenWindow->selectedText(currentDecodingOptions() | options);
     if (text.isEmpty()) {
         return;
@@ -2502,6 +2585,22 @@ void TerminalDisplay::copyToClipboard(Screen::DecodingOptions options)
     QApplication::clipboard()->setMimeData(mimeData, QClipboard::Clipboard);
 }
 
+SelectionExport *TerminalDisplay::exportSelection(Screen::DecodingOptions options)
+{
+    return new SelectionExport(_screenWindow, currentDecodingOptions() | options);
+}
+
+QMimeData *TerminalDisplay::largeSelectionMimeData(Screen::DecodingOptions options)
+{
+    // Small selections are quicker to copy right away than to set up
+    auto *selection = exportSelection(options);
+    if (selection->lineCount() <= SelectionExport::BackgroundLines) {
+        delete selection;
+        return nullptr;
+    }
+    return new SelectionMimeData(selection, _copyTextAsHTML);
+}
+
 void TerminalDisplay::pasteFromClipboard(bool appendEnter)
 {
     QString text;
@@ -25,6 +25,7 @@
 #include "widgets/TerminalHeaderBar.h"
 
 #include "TerminalBell.h"
+#include "TerminalTextLayer.h"
 
 class QDrag;
 class QDragEnterEvent;
@@ -57,6 +58,7 @@ class KonsolePrintManager;
 class FilterChain;
 class TerminalImageFilterChain;
 class SessionController;
+class SelectionExport;
 class IncrementalSearchBar;
 class HotSpot;
 class Profile;
@@ -364,6 +366,9 @@ public:
     // returns true if the cursor's position is on display.
     bool isCursorOnDisplay() const;
 
+    // moves the pixels inside rect by dy, to follow the scrolled image
+    void scrollPixels(int dy, const QRect &rect);
+
     // returns the position of the cursor in columns and lines
     QPoint cursorPosition() const;
 
@@ -445,6 +450,12 @@ public Q_SLOTS:
     /** Copies the selected text to the system clipboard. */
     void copyToClipboard(Screen::DecodingOptions options = Screen::PlainText);
 
+    /**
+     * Returns an export of the selected text with the current decoding
+     * options, to be given outputs and started by the caller.
+     */
+    SelectionExport *exportSelection(Screen::DecodingOptions options = Screen::PlainText);
+
     /**
      * Pastes the content of the clipboard into the display.
      *
@@ -628,6 +639,9 @@ private:
     // redraws the cursor
     void updateCursor();
 
+    // whether the text is drawn into _textLayer rather than the widget
+    bool usesTextLayer() const;
+
     bool handleShortcutOverrideEvent(QKeyEvent *keyEvent);
 
     void doPaste(QString text, bool appendReturn);
@@ -648,6 +662,10 @@ private:
     // Uses the current settings for trimming whitespace and preserving linebreaks to create a proper flag value for Screen
     Screen::DecodingOptions currentDecodingOptions();
 
+    // Clipboard contents copied in the background if the selection is
+    // large, otherwise nullptr
+    QMimeData *largeSelectionMimeData(Screen::DecodingOptions options);
+
     // Boilerplate setup for MessageWidget
     KMessageWidget *createMessageWidget(const QString &text);
 
@@ -817,6 +835,7 @@ private:
     QKeySequence _peekPrimaryShortcut;
 
     TerminalPainter *_terminalPainter = nullptr;
+    TerminalTextLayer _textLayer;
     TerminalScrollBar *_scrollBar = nullptr;
     TerminalColor *_terminalColor = nullptr;
     std::unique_ptr<TerminalFont> _terminalFont;
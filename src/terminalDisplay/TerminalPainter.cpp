@@ -195,6 +195,7 @@ void TerminalPainter::drawContents(Character *image,
 
     QVector<uint> univec;
     univec.reserve(m_parentDisplay->usedColumns());
+    QVector<TerminalGraphicsPlacement_t *> placements;
     int placementIdx = 0;
 
     const int leftPadding = m_parentDisplay->contentRect().left() + m_parentDisplay->contentsRect().left();
@@ -205,7 +206,7 @@ void TerminalPainter::drawContents(Character *image,
                          QSize(rect.width() * fontWidth, rect.height() * fontHeight));
     QRegion sixelRegion = QRegion();
     if (!printerFriendly) {
-        drawImagesBelowText(paint, textArea, fontWidth, fontHeight, placementIdx, sixelRegion);
+        drawImagesBelowText(paint, textArea, fontWidth, fontHeight, placements, placementIdx, sixelRegion);
     }
 
     static const QFont::Weight FontWeights[] = {
@@ -488,7 +489,7 @@ void TerminalPainter::drawContents(Character *image,
         }
     }
     if (!printerFriendly) {
-        drawImagesAboveText(paint, textArea, fontWidth, fontHeight, placementIdx);
+        drawImagesAboveText(paint, textArea, fontWidth, fontHeight, placements, placementIdx);
     }
 }
 
@@ -992,7 +993,13 @@ void TerminalPainter::drawAboveText(QPainter &painter,
     }
 }
 
-void TerminalPainter::drawImagesBelowText(QPainter &painter, const QRect &rect, int fontWidth, int fontHeight, int &placementIdx, QRegion &sixelRegion)
+void TerminalPainter::drawImagesBelowText(QPainter &painter,
+                                          const QRect &rect,
+                                          int fontWidth,
+                                          int fontHeight,
+                                          QVector<TerminalGraphicsPlacement_t *> &placements,
+                                          int &placementIdx,
+                                          QRegion &sixelRegion)
 {
     if (m_parentDisplay->screenWindow().isNull()) {
         return;
@@ -1002,26 +1009,38 @@ void TerminalPainter::drawImagesBelowText(QPainter &painter, const QRect &rect,
 
     placementIdx = 0;
     qreal opacity = painter.opacity();
-    int scrollDelta = m_parentDisplay->terminalFont()->fontHeight() * (m_parentDisplay->screenWindow()->currentLine() - screen->getHistLines());
+    const int firstVisibleRow = m_parentDisplay->screenWindow()->currentLine() - screen->getHistLines();
+    int scrollDelta = m_parentDisplay->terminalFont()->fontHeight() * firstVisibleRow;
     const bool origClipping = painter.hasClipping();
     const auto origClipRegion = painter.clipRegion();
     if (screen->hasGraphics()) {
+        // only placements near the rows being painted; one row of slack
+        // for images shifted by a pixel offset
+        const int top = rect.top() - m_parentDisplay->contentRect().top();
+        const int bottom = rect.bottom() - m_parentDisplay->contentRect().top();
+        screen->graphicsPlacementsInRows(firstVisibleRow + top / fontHeight - 1, firstVisibleRow + bottom / fontHeight + 1, placements);
+
         painter.setClipRect(rect);
-        while (1) {
-            TerminalGraphicsPlacement_t *p = screen->getGraphicsPlacement(placementIdx);
-            if (!p || p->z >= 0) {
+        while (placementIdx < placements.size()) {
+            TerminalGraphicsPlacement_t *p = placements.at(placementIdx);
+            if (p->z >= 0) {
                 break;
             }
-            int x = p->col * fontWidth + p->X + m_parentDisplay->contentRect().left();
-            int y = p->row * fontHeight + p->Y + m_parentDisplay->contentRect().top();
-            QRectF srcRect(0, 0, p->pixmap.width(), p->pixmap.height());
-            QRectF dstRect(x, y - scrollDelta, p->pixmap.width(), p->pixmap.height());
-            painter.setOpacity(p->opacity);
-            painter.drawPixmap(dstRect, p->pixmap, srcRect);
             if (p->source == TerminalGraphicsPlacement_t::Sixel) {
                 sixelRegion = sixelRegion.united(QRect(p->col, p->row, p->cols, p->rows));
             }
             placementIdx++;
+            // still being decoded
+            const QImage image = p->image.image();
+            if (image.isNull()) {
+                continue;
+            }
+            int x = p->col * fontWidth + p->X + m_parentDisplay->contentRect().left();
+            int y = p->row * fontHeight + p->Y + m_parentDisplay->contentRect().top();
+            QRectF srcRect(0, 0, image.width(), image.height());
+            QRectF dstRect(x, y - scrollDelta, image.width(), image.height());
+            painter.setOpacity(p->opacity);
+            painter.drawImage(dstRect, image, srcRect);
         }
         painter.setOpacity(opacity);
         painter.setClipRegion(origClipRegion);
@@ -1029,7 +1048,12 @@ void TerminalPainter::drawImagesBelowText(QPainter &painter, const QRect &rect,
     }
 }
 
-void TerminalPainter::drawImagesAboveText(QPainter &painter, const QRect &rect, int fontWidth, int fontHeight, int &placementIdx)
+void TerminalPainter::drawImagesAboveText(QPainter &painter,
+                                          const QRect &rect,
+                                          int fontWidth,
+                                          int fontHeight,
+                                          const QVector<TerminalGraphicsPlacement_t *> &placements,
+                                          int &placementIdx)
 {
     if (m_parentDisplay->screenWindow().isNull()) {
         return;
@@ -1045,19 +1069,19 @@ void TerminalPainter::drawImagesAboveText(QPainter &painter, const QRect &rect,
 
     if (screen->hasGraphics()) {
         painter.setClipRect(rect);
-        while (1) {
-            TerminalGraphicsPlacement_t *p = screen->getGraphicsPlacement(placementIdx);
-            if (!p) {
-                break;
+        while (placementIdx < placements.size()) {
+            TerminalGraphicsPlacement_t *p = placements.at(placementIdx);
+            placementIdx++;
+            const QImage image = p->image.image();
+            if (image.isNull()) {
+                continue;
             }
-            QPixmap image = p->pixmap;
             int x = p->col * fontWidth + p->X + m_parentDisplay->contentRect().left();
             int y = p->row * fontHeight + p->Y + m_parentDisplay->contentRect().top();
             QRectF srcRect(0, 0, image.width(), image.height());
             QRectF dstRect(x, y - scrollDelta, image.width(), image.height());
             painter.setOpacity(p->opacity);
-            painter.drawPixmap(dstRect, image, srcRect);
-            placementIdx++;
+            painter.drawImage(dstRect, image, srcRect);
         }
         painter.setOpacity(opacity);
         painter.setClipRegion(origClipRegion);
@@ -117,8 +117,19 @@ private:
                        bool bidiEnabled,
                        int lastNonSpace,
                        CharacterColor const *ulColorTable);
-    void drawImagesBelowText(QPainter &painter, const QRect &rect, int fontWidth, int fontHeight, int &placementIdx, QRegion &sixelRegion);
-    void drawImagesAboveText(QPainter &painter, const QRect &rect, int fontWidth, int fontHeight, int &placementIdx);
+    void drawImagesBelowText(QPainter &painter,
+                             const QRect &rect,
+                             int fontWidth,
+                             int fontHeight,
+                             QVector<TerminalGraphicsPlacement_t *> &placements,
+                             int &placementIdx,
+                             QRegion &sixelRegion);
+    void drawImagesAboveText(QPainter &painter,
+                             const QRect &rect,
+                             int fontWidth,
+                             int fontHeight,
+                             const QVector<TerminalGraphicsPlacement_t *> &placements,
+                             int &placementIdx);
 
     void drawTextCharacters(QPainter &painter,
                             const QRect &rect,
@@ -0,0 +1,116 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "TerminalTextLayer.h"
+
+// Qt
+#include <QPainter>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Konsole;
+
+void TerminalTextLayer::resize(const QSize &size, qreal devicePixelRatio)
+{
+    const QSize pixels = (QSizeF(size) * devicePixelRatio).toSize();
+    if (!_image.isNull() && _image.size() == pixels && _image.devicePixelRatio() == devicePixelRatio) {
+        return;
+    }
+    _image = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+    _image.setDevicePixelRatio(devicePixelRatio);
+    _valid = QRegion();
+    _reusable = QRegion();
+}
+
+void TerminalTextLayer::release()
+{
+    _image = QImage();
+    _valid = QRegion();
+    _reusable = QRegion();
+}
+
+QRect TerminalTextLayer::toImage(const QRect &rect) const
+{
+    // Rounded the same way for source and destination, so rows line up
+    const qreal dpr = _image.devicePixelRatio();
+    const int left = int(std::floor(rect.left() * dpr));
+    const int top = int(std::lround(rect.top() * dpr));
+    const int right = int(std::ceil((rect.left() + rect.width()) * dpr));
+    const int height = int(std::lround(rect.height() * dpr));
+    return QRect(left, top, right - left, height) & _image.rect();
+}
+
+void TerminalTextLayer::scroll(int dy, const QRect &rect)
+{
+    if (_image.isNull() || dy == 0) {
+        return;
+    }
+    const QRect moved = rect & rect.translated(0, dy);
+    if (moved.isEmpty()) {
+        _valid -= rect;
+        return;
+    }
+
+    const QRect destination = toImage(moved);
+    const QRect source = toImage(moved.translated(0, -dy));
+    const int rows = std::min(destination.height(), source.height());
+    const int bytes = std::min(destination.width(), source.width()) * 4;
+    // Overlapping rows: copy away from the direction of the move
+    for (int i = 0; i < rows; ++i) {
+        const int row = dy < 0 ? i : rows - 1 - i;
+        std::memmove(_image.scanLine(destination.top() + row) + destination.left() * 4, _image.constScanLine(source.top() + row) + source.left() * 4, bytes);
+    }
+
+    const QRegion validMoved = (_valid & rect).translated(0, dy) & moved;
+    _valid = (_valid - rect) | validMoved;
+    _reusable |= moved;
+}
+
+void TerminalTextLayer::invalidate(const QRegion &region)
+{
+    _valid -= region;
+}
+
+void TerminalTextLayer::invalidateAll()
+{
+    _valid = QRegion();
+}
+
+void TerminalTextLayer::keep(const QRegion &region)
+{
+    _reusable |= region;
+}
+
+QRegion TerminalTextLayer::beginPaint(const QRegion &region)
+{
+    const QRegion stale = region - (_valid & _reusable);
+    _reusable = QRegion();
+    _valid |= region;
+    if (stale.isEmpty() || _image.isNull()) {
+        return stale;
+    }
+
+    QPainter painter(&_image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const QRect &rect : stale) {
+        painter.fillRect(rect, Qt::transparent);
+    }
+    return stale;
+}
+
+void TerminalTextLayer::composite(QPainter &painter, const QRegion &region) const
+{
+    if (_image.isNull()) {
+        return;
+    }
+    for (const QRect &rect : region) {
+        painter.drawImage(QRectF(rect), _image, QRectF(toImage(rect)));
+    }
+}
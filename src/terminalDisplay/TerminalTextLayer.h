@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2026 Struktured Labs
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TERMINALTEXTLAYER_H
+#define TERMINALTEXTLAYER_H
+
+#include <QImage>
+#include <QRegion>
+
+#include "konsoleprivate_export.h"
+
+class QPainter;
+
+namespace Konsole
+{
+/**
+ * The text of a terminal display, drawn on transparency so it can be
+ * composited over a background which doesn't move with it.
+ *
+ * Scrolling the widget itself moves the wallpaper and the search bar along
+ * with the text, so TerminalDisplay draws into this layer instead when
+ * either is shown.  Scrolling then moves the pixels of the layer, and a
+ * paint only draws the text of the lines which were exposed or changed;
+ * the rest is a copy of the layer over the background.
+ *
+ * The layer only knows which parts were moved by scroll() or kept with
+ * keep() since the last paint; everything else painted is drawn again, so
+ * callers need not report every change.  Changes to moved or kept parts
+ * must be reported with invalidate().
+ */
+class KONSOLEPRIVATE_EXPORT TerminalTextLayer
+{
+public:
+    TerminalTextLayer() = default;
+
+    /** Sets the size of the layer in logical pixels, dropping its content if that changes it. */
+    void resize(const QSize &size, qreal devicePixelRatio);
+
+    /** Drops the layer, e.g. when it is no longer used. */
+    void release();
+
+    bool isNull() const
+    {
+        return _image.isNull();
+    }
+
+    /** Moves the pixels inside @p rect by @p dy, as QWidget::scroll() would. */
+    void scroll(int dy, const QRect &rect);
+
+    /** The text in @p region changed. */
+    void invalidate(const QRegion &region);
+    void invalidateAll();
+
+    /** Reuses @p region in the next paint, when only what is below the text changed there. */
+    void keep(const QRegion &region);
+
+    /**
+     * Prepares painting @p region: returns the part whose text needs to be
+     * drawn into image(), which has been cleared to transparency.
+     */
+    QRegion beginPaint(const QRegion &region);
+
+    QImage &image()
+    {
+        return _image;
+    }
+
+    /** Draws the layer's @p region with @p painter. */
+    void composite(QPainter &painter, const QRegion &region) const;
+
+private:
+    QRect toImage(const QRect &rect) const;
+
+    QImage _image;
+    // Parts which show the current text
+    QRegion _valid;
+    // Parts moved or kept since the last paint
+    QRegion _reusable;
+};
+
+}
+
+#endif // TERMINALTEXTLAYER_H
@@ -25,6 +25,7 @@
 // Konsolai (Claude integration)
 #include "claude/ClaudeSession.h"
 #include "claude/ClaudeTabIndicator.h"
+#include "claude/IdleTaskScheduler.h"
 
 // Konsole
 #include "DetachableTabBar.h"
@@ -408,14 +409,37 @@ void TabbedViewContainer::setupClaudeIndicator(int tabIndex, QWidget *splitterWi
     _claudeIndicators[splitterWidget] = indicator;
 }
 
-void TabbedViewContainer::addView(TerminalDisplay *view)
+void TabbedViewContainer::setupDeferredClaudeIndicator(QWidget *splitterWidget)
+{
+    if (!_deferredClaudeIndicators.remove(splitterWidget)) {
+        return;
+    }
+    const int index = indexOf(splitterWidget);
+    if (index != -1) {
+        setupClaudeIndicator(index, splitterWidget);
+    }
+}
+
+void TabbedViewContainer::addView(TerminalDisplay *view, bool activate, int index)
 {
     auto viewSplitter = new ViewSplitter();
     viewSplitter->addTerminalDisplay(view, Qt::Horizontal);
     auto item = view->sessionController();
-    int index = _newTabBehavior == PutNewTabAfterCurrentTab ? currentIndex() + 1 : -1;
+    if (index == -1 && activate && _newTabBehavior == PutNewTabAfterCurrentTab) {
+        index = currentIndex() + 1;
+    }
     index = insertTab(index, viewSplitter, item->icon(), item->title());
-    setupClaudeIndicator(index, viewSplitter);
+    if (activate) {
+        setupClaudeIndicator(index, viewSplitter);
+    } else {
+        _deferredClaudeIndicators.insert(viewSplitter);
+        QPointer<ViewSplitter> splitter(viewSplitter);
+        Konsolai::IdleTaskScheduler::post(this, "ClaudeTabIndicator", Konsolai::IdleTaskScheduler::Low, [this, splitter]() {
+            if (splitter) {
+                setupDeferredClaudeIndicator(splitter);
+            }
+        });
+    }
 
     connectTerminalDisplay(view);
     connect(viewSplitter, &ViewSplitter::destroyed, this, &TabbedViewContainer::viewDestroyed);
@@ -424,7 +448,9 @@ void TabbedViewContainer::addView(TerminalDisplay *view)
     // Put this view on the foreground if it requests so, eg. on bell activity
     connect(view, &TerminalDisplay::activationRequest, this, &Konsole::TabbedViewContainer::activateView);
 
-    setCurrentIndex(index);
+    if (activate) {
+        setCurrentIndex(index);
+    }
     Q_EMIT viewAdded(view);
 }
 
@@ -475,6 +501,7 @@ void TabbedViewContainer::viewDestroyed(QObject *view)
         // Already removed (e.g. tab was closed before deferred destruction)
         _tabIconState.remove(widget);
         _claudeIndicators.remove(widget);
+        _deferredClaudeIndicators.remove(widget);
         return;
     }
 
@@ -482,6 +509,7 @@ void TabbedViewContainer::viewDestroyed(QObject *view)
     forgetView();
     _tabIconState.remove(widget);
     _claudeIndicators.remove(widget);
+    _deferredClaudeIndicators.remove(widget);
 
     Q_EMIT viewRemoved();
 }
@@ -690,6 +718,7 @@ void TabbedViewContainer::currentTabChanged(int index)
             return;
         }
         auto view = splitview->activeTerminalDisplay();
+        setupDeferredClaudeIndicator(splitview);
         setTabActivity(index, false);
         _tabIconState[splitview].notification = Session::NoNotification;
         if (view != nullptr) {
@@ -9,6 +9,7 @@
 
 // Qt
 #include <QObject>
+#include <QSet>
 #include <QTabWidget>
 
 // Konsole
@@ -62,8 +63,13 @@ public:
      */
     ~TabbedViewContainer() override;
 
-    /** Adds a new view to the container widget */
-    void addView(TerminalDisplay *view);
+    /**
+     * Adds a new view to the container widget, at @p index unless that is
+     * -1.  Unless @p activate is set the view is appended as a background
+     * tab, and a Claude session's tab indicator is only created once the
+     * tab is first shown or the event loop is idle.
+     */
+    void addView(TerminalDisplay *view, bool activate = true, int index = -1);
     void addSplitter(ViewSplitter *viewSplitter, int index = -1);
 
     /** splits the currently focused Splitter */
@@ -252,11 +258,13 @@ private:
     bool _stylesheetSet = false;
 
     void setupClaudeIndicator(int tabIndex, QWidget *splitterWidget);
+    void setupDeferredClaudeIndicator(QWidget *splitterWidget);
     Konsolai::ClaudeSession *getClaudeSessionForTab(int index);
     void editClaudeTabDescription(int index, Konsolai::ClaudeSession *session);
 
     QHash<const QWidget *, TabIconState> _tabIconState;
     QHash<const QWidget *, Konsolai::ClaudeTabIndicator *> _claudeIndicators;
+    QSet<const QWidget *> _deferredClaudeIndicators; // background tabs, see addView()
     ViewManager *_connectedViewManager;
     QMenu *_contextPopupMenu;
     QToolButton *_newTabButton;